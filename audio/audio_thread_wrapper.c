@@ -21,6 +21,7 @@
 #include <rthreads/rthreads.h>
 
 #include "audio_thread_wrapper.h"
+#include "../performance_counters.h"
 #include "../verbosity.h"
 
 typedef struct audio_thread
@@ -57,6 +58,8 @@ static void audio_thread_loop(void *data)
    if (!thr)
       return;
 
+   RARCH_TRACE_NAME_THREAD("audio thread");
+
    thr->driver_data   = thr->driver->init(
          thr->device, thr->out_rate, thr->latency,
          thr->block_frames, thr->new_rate);
@@ -106,7 +109,10 @@ static void audio_thread_loop(void *data)
       }
 
       slock_unlock(thr->lock);
+
+      RARCH_TRACE_BEGIN("audio callback");
       audio_driver_callback();
+      RARCH_TRACE_END();
    }
 
    thr->driver->free(thr->driver_data);
@@ -303,7 +309,8 @@ bool audio_init_thread(const audio_driver_t **out_driver,
    thr->alive          = true;
    thr->stopped        = true;
 
-   if (!(thr->thread   = sthread_create(audio_thread_loop, thr)))
+   if (!(thr->thread   = sthread_create_with_class(audio_thread_loop,
+               thr, "retroarch-audio", STHREAD_CLASS_AUDIO)))
       goto error;
 
    /* Wait until thread has initialized (or failed) the driver. */
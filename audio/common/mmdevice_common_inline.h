@@ -36,6 +36,7 @@
 
 #ifdef _MSC_VER
 DEFINE_GUID(IID_IAudioClient, 0x1CB9AD4C, 0xDBFA, 0x4C32, 0xB1, 0x78, 0xC2, 0xF5, 0x68, 0xA7, 0x03, 0xB2);
+DEFINE_GUID(IID_IAudioClock, 0xCD63314F, 0x3FBA, 0x4A1B, 0x81, 0x2C, 0xEF, 0x96, 0x35, 0x87, 0x28, 0xE7);
 DEFINE_GUID(IID_IAudioRenderClient, 0xF294ACFC, 0x3146, 0x4483, 0xA7, 0xBF, 0xAD, 0xDC, 0xA7, 0xC2, 0x60, 0xE2);
 DEFINE_GUID(IID_IMMDeviceEnumerator, 0xA95664D2, 0x9614, 0x4F35, 0xA7, 0x46, 0xDE, 0x8D, 0xB6, 0x36, 0x17, 0xE6);
 DEFINE_GUID(CLSID_MMDeviceEnumerator, 0xBCDE0395, 0xE52F, 0x467C, 0x8E, 0x3D, 0xC4, 0x57, 0x92, 0x91, 0x69, 0x2E);
@@ -67,6 +68,12 @@ DEFINE_PROPERTYKEY(PKEY_Device_FriendlyName, 0xa45c254e, 0xdf1c, 0x4efd, 0x80, 0
 #define _IMMDevice_GetId(This,ppstrId) ((This)->GetId(ppstrId))
 #define _IPropertyStore_GetValue(This,key,pv) ( (This)->GetValue(key,pv) )
 #define _IMMDeviceCollection_GetCount(This,cProps) ( (This)->GetCount(cProps) )
+#define _IAudioClock_GetFrequency(This,pu64Frequency) ( (This)->GetFrequency(pu64Frequency) )
+#define _IAudioClock_GetPosition(This,pu64Position,pu64QPCPosition) ( (This)->GetPosition(pu64Position,pu64QPCPosition) )
+#ifdef __IAudioClient3_INTERFACE_DEFINED__
+#define _IAudioClient3_GetSharedModeEnginePeriod(This,pFormat,pDefault,pFundamental,pMin,pMax) ( (This)->GetSharedModeEnginePeriod(pFormat,pDefault,pFundamental,pMin,pMax) )
+#define _IAudioClient3_InitializeSharedAudioStream(This,StreamFlags,PeriodInFrames,pFormat,AudioSessionGuid) ( (This)->InitializeSharedAudioStream(StreamFlags,PeriodInFrames,pFormat,AudioSessionGuid) )
+#endif
 #else
 #define _IMMDeviceCollection_Item(This,nDevice,ppdevice) (This)->lpVtbl->Item(This,nDevice,ppdevice)
 #define _IAudioClient_Start(This)	( (This)->lpVtbl -> Start(This) )
@@ -89,6 +96,12 @@ DEFINE_PROPERTYKEY(PKEY_Device_FriendlyName, 0xa45c254e, 0xdf1c, 0x4efd, 0x80, 0
 #define _IMMDevice_GetId(This,ppstrId) (This)->lpVtbl->GetId(This,ppstrId)
 #define _IPropertyStore_GetValue(This,key,pv) ( (This)->lpVtbl -> GetValue(This,&(key),pv) )
 #define _IMMDeviceCollection_GetCount(This,cProps) ( (This)->lpVtbl -> GetCount(This,cProps) )
+#define _IAudioClock_GetFrequency(This,pu64Frequency) ( (This)->lpVtbl -> GetFrequency(This,pu64Frequency) )
+#define _IAudioClock_GetPosition(This,pu64Position,pu64QPCPosition) ( (This)->lpVtbl -> GetPosition(This,pu64Position,pu64QPCPosition) )
+#ifdef __IAudioClient3_INTERFACE_DEFINED__
+#define _IAudioClient3_GetSharedModeEnginePeriod(This,pFormat,pDefault,pFundamental,pMin,pMax) ( (This)->lpVtbl -> GetSharedModeEnginePeriod(This,pFormat,pDefault,pFundamental,pMin,pMax) )
+#define _IAudioClient3_InitializeSharedAudioStream(This,StreamFlags,PeriodInFrames,pFormat,AudioSessionGuid) ( (This)->lpVtbl -> InitializeSharedAudioStream(This,StreamFlags,PeriodInFrames,pFormat,AudioSessionGuid) )
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -21,7 +21,7 @@
 
 #include <boolean.h>
 #include <rthreads/rthreads.h>
-#include <queues/fifo_queue.h>
+#include <queues/fifo_queue_spsc.h>
 #include <retro_inline.h>
 #include <retro_math.h>
 
@@ -37,7 +37,7 @@ typedef struct sdl_audio
    slock_t *lock;
    scond_t *cond;
 #endif
-   fifo_buffer_t *buffer;
+   fifo_buffer_spsc_t *buffer;
    bool nonblock;
    bool is_paused;
 } sdl_audio_t;
@@ -45,10 +45,13 @@ typedef struct sdl_audio
 static void sdl_audio_cb(void *data, Uint8 *stream, int len)
 {
    sdl_audio_t  *sdl = (sdl_audio_t*)data;
-   size_t      avail = FIFO_READ_AVAIL(sdl->buffer);
+   size_t      avail = fifo_spsc_read_avail(sdl->buffer);
    size_t write_size = len > (int)avail ? avail : len;
 
-   fifo_read(sdl->buffer, stream, write_size);
+   /* Lock-free single-consumer read - the callback
+    * never contends with the submitting thread, so it
+    * cannot be stalled by a priority-inverted mutex. */
+   fifo_spsc_read(sdl->buffer, stream, write_size);
 #ifdef HAVE_THREADS
    scond_signal(sdl->cond);
 #endif
@@ -124,11 +127,11 @@ static void *sdl_audio_init(const char *device,
    /* Create a buffer twice as big as needed and prefill the buffer. */
    bufsize     = out.samples * 4 * sizeof(int16_t);
    tmp         = calloc(1, bufsize);
-   sdl->buffer = fifo_new(bufsize);
+   sdl->buffer = fifo_spsc_new(bufsize);
 
    if (tmp)
    {
-      fifo_write(sdl->buffer, tmp, bufsize);
+      fifo_spsc_write(sdl->buffer, tmp, bufsize);
       free(tmp);
    }
 
@@ -147,13 +150,10 @@ static ssize_t sdl_audio_write(void *data, const void *buf, size_t size)
 
    if (sdl->nonblock)
    {
-      size_t avail, write_amt;
+      size_t avail     = fifo_spsc_write_avail(sdl->buffer);
+      size_t write_amt = avail > size ? size : avail;
 
-      SDL_LockAudio();
-      avail = FIFO_WRITE_AVAIL(sdl->buffer);
-      write_amt = avail > size ? size : avail;
-      fifo_write(sdl->buffer, buf, write_amt);
-      SDL_UnlockAudio();
+      fifo_spsc_write(sdl->buffer, buf, write_amt);
       ret = write_amt;
    }
    else
@@ -162,25 +162,23 @@ static ssize_t sdl_audio_write(void *data, const void *buf, size_t size)
 
       while (written < size)
       {
-         size_t avail;
-
-         SDL_LockAudio();
-         avail = FIFO_WRITE_AVAIL(sdl->buffer);
+         size_t avail = fifo_spsc_write_avail(sdl->buffer);
 
          if (avail == 0)
          {
-            SDL_UnlockAudio();
 #ifdef HAVE_THREADS
+            /* The callback signals the condition without
+             * holding the lock, so a wakeup can slip by -
+             * wait with a timeout instead of indefinitely. */
             slock_lock(sdl->lock);
-            scond_wait(sdl->cond, sdl->lock);
+            scond_wait_timeout(sdl->cond, sdl->lock, 1000);
             slock_unlock(sdl->lock);
 #endif
          }
          else
          {
             size_t write_amt = size - written > avail ? avail : size - written;
-            fifo_write(sdl->buffer, (const char*)buf + written, write_amt);
-            SDL_UnlockAudio();
+            fifo_spsc_write(sdl->buffer, (const char*)buf + written, write_amt);
             written += write_amt;
          }
       }
@@ -231,7 +229,7 @@ static void sdl_audio_free(void *data)
 
    if (sdl)
    {
-      fifo_free(sdl->buffer);
+      fifo_spsc_free(sdl->buffer);
 #ifdef HAVE_THREADS
       slock_free(sdl->lock);
       scond_free(sdl->cond);
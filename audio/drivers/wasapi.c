@@ -26,15 +26,25 @@
 #include "../../verbosity.h"
 #include "../../configuration.h"
 
+#ifdef __IAudioClient3_INTERFACE_DEFINED__
+/* Not in older SDK uuid libs - define locally instead of relying
+ * on the toolchain to ship IID_IAudioClient3 */
+DEFINE_GUID(wasapi_IID_IAudioClient3, 0x7ED4EE07, 0x8E67, 0x4CD4, 0x8C, 0x1A, 0x2B, 0x7A, 0x59, 0x87, 0xAD, 0x42);
+#endif
+
 typedef struct
 {
+   UINT64 frames_written;      /* frames handed to the render client */
+   UINT64 clock_freq;          /* IAudioClock frequency, 0 if no clock */
    HANDLE write_event;
    IMMDevice          *device;
    IAudioClient       *client;
    IAudioRenderClient *renderer;
+   IAudioClock        *clock;  /* NULL if the service is unavailable */
    fifo_buffer_t      *buffer; /* NULL in unbuffered shared mode */
    size_t frame_size;          /* 4 or 8 only */
    size_t engine_buffer_size;
+   unsigned rate;
    bool exclusive;
    bool nonblock;
    bool running;
@@ -193,6 +203,76 @@ static void wasapi_set_format(WAVEFORMATEXTENSIBLE *wf,
    }
 }
 
+#ifdef __IAudioClient3_INTERFACE_DEFINED__
+/* Shared mode at engine periods below the legacy 10ms default
+ * (IAudioClient3, Windows 10+). Tries only the requested rate -
+ * the small-period path is pointless once the engine has to
+ * resample - and falls back to the classic shared path on any
+ * failure. */
+static IAudioClient *wasapi_init_client_sh3(IMMDevice *device,
+      bool *float_fmt, unsigned *rate, unsigned latency)
+{
+   WAVEFORMATEXTENSIBLE wf;
+   int i;
+   IAudioClient3 *client3    = NULL;
+   bool float_fmt_res        = *float_fmt;
+   UINT32 default_period     = 0;
+   UINT32 fundamental_period = 0;
+   UINT32 minimum_period     = 0;
+   UINT32 maximum_period     = 0;
+   UINT32 period             = 0;
+   HRESULT hr                = _IMMDevice_Activate(device,
+         wasapi_IID_IAudioClient3,
+         CLSCTX_ALL, NULL, (void**)&client3);
+   if (FAILED(hr))
+      return NULL;
+
+   /* once for the requested sample format, once for the other */
+   for (i = 0; i < 2; ++i)
+   {
+      if (i == 1)
+         float_fmt_res = !float_fmt_res;
+
+      wasapi_set_format(&wf, float_fmt_res, *rate);
+
+      hr = _IAudioClient3_GetSharedModeEnginePeriod(client3,
+            (WAVEFORMATEX*)&wf, &default_period, &fundamental_period,
+            &minimum_period, &maximum_period);
+      if (FAILED(hr))
+         continue;
+
+      /* The requested latency picks the period, snapped to the
+       * fundamental grid and clamped to what the engine offers. */
+      period = (UINT32)((double)latency * *rate / 1000.0);
+      if (period <= minimum_period)
+         period = minimum_period;
+      else
+      {
+         if (fundamental_period)
+            period -= period % fundamental_period;
+         if (period > maximum_period)
+            period = maximum_period;
+      }
+
+      RARCH_LOG("[WASAPI]: Initializing client (shared IAudioClient3, %s, %uHz, %u-frame period) ...\n",
+            float_fmt_res ? "float" : "pcm", *rate, period);
+
+      hr = _IAudioClient3_InitializeSharedAudioStream(client3,
+            AUDCLNT_STREAMFLAGS_EVENTCALLBACK, period,
+            (WAVEFORMATEX*)&wf, NULL);
+      if (SUCCEEDED(hr))
+      {
+         *float_fmt = float_fmt_res;
+         return (IAudioClient*)client3;
+      }
+   }
+
+   IFACE_RELEASE(client3);
+
+   return NULL;
+}
+#endif
+
 static IAudioClient *wasapi_init_client_sh(IMMDevice *device,
       bool *float_fmt, unsigned *rate, unsigned latency)
 {
@@ -201,7 +281,15 @@ static IAudioClient *wasapi_init_client_sh(IMMDevice *device,
    IAudioClient *client = NULL;
    bool float_fmt_res   = *float_fmt;
    unsigned rate_res    = *rate;
-   HRESULT hr           = _IMMDevice_Activate(device,
+   HRESULT hr;
+
+#ifdef __IAudioClient3_INTERFACE_DEFINED__
+   client = wasapi_init_client_sh3(device, float_fmt, rate, latency);
+   if (client)
+      return client;
+#endif
+
+   hr = _IMMDevice_Activate(device,
          IID_IAudioClient,
          CLSCTX_ALL, NULL, (void**)&client);
    if (FAILED(hr))
@@ -562,6 +650,19 @@ static void *wasapi_init(const char *dev_id, unsigned rate, unsigned latency,
    if (FAILED(hr))
       goto error;
 
+   /* Optional - only latency measurement is lost without it */
+   hr = _IAudioClient_GetService(w->client,
+         IID_IAudioClock, (void**)&w->clock);
+   if (SUCCEEDED(hr))
+   {
+      if (FAILED(_IAudioClock_GetFrequency(w->clock, &w->clock_freq)))
+         w->clock_freq = 0;
+   }
+   else
+      RARCH_WARN("[WASAPI]: IAudioClock unavailable, no latency reporting.\n");
+
+   w->rate = rate;
+
    hr = _IAudioRenderClient_GetBuffer(w->renderer, frame_count, &dest);
    if (FAILED(hr))
       goto error;
@@ -581,6 +682,7 @@ static void *wasapi_init(const char *dev_id, unsigned rate, unsigned latency,
    return w;
 
 error:
+   IFACE_RELEASE(w->clock);
    IFACE_RELEASE(w->renderer);
    IFACE_RELEASE(w->client);
    IFACE_RELEASE(w->device);
@@ -608,6 +710,8 @@ static bool wasapi_flush(wasapi_t * w, const void * data, size_t size)
                0)))
       return false;
 
+   w->frames_written += frame_count;
+
    return true;
 }
 
@@ -625,6 +729,8 @@ static bool wasapi_flush_buffer(wasapi_t * w, size_t size)
          0)))
       return false;
 
+   w->frames_written += frame_count;
+
    return true;
 }
 
@@ -847,6 +953,7 @@ static void wasapi_free(void *wh)
    wasapi_t *w        = (wasapi_t*)wh;
    HANDLE write_event = w->write_event;
 
+   IFACE_RELEASE(w->clock);
    IFACE_RELEASE(w->renderer);
    if (w->client)
       _IAudioClient_Stop(w->client);
@@ -908,6 +1015,32 @@ static size_t wasapi_buffer_size(void *wh)
    return w->engine_buffer_size;
 }
 
+static size_t wasapi_device_latency(void *wh)
+{
+   wasapi_t *w     = (wasapi_t*)wh;
+   UINT64 position = 0;
+   double played   = 0.0;
+   double queued   = 0.0;
+
+   if (!w->clock || !w->clock_freq || !w->rate)
+      return 0;
+
+   if (FAILED(_IAudioClock_GetPosition(w->clock, &position, NULL)))
+      return 0;
+
+   /* Frames handed to the render client but not yet played
+    * out of the device, plus whatever sits in our own FIFO */
+   played = (double)position / w->clock_freq * w->rate;
+   queued = (double)w->frames_written - played;
+   if (w->buffer)
+      queued += (double)FIFO_READ_AVAIL(w->buffer) / w->frame_size;
+
+   if (queued < 0.0)
+      return 0;
+
+   return (size_t)queued;
+}
+
 audio_driver_t audio_wasapi = {
    wasapi_init,
    wasapi_write,
@@ -921,5 +1054,6 @@ audio_driver_t audio_wasapi = {
    mmdevice_list_new,
    wasapi_device_list_free,
    wasapi_write_avail,
-   wasapi_buffer_size
+   wasapi_buffer_size,
+   wasapi_device_latency
 };
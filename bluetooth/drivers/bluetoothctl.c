@@ -13,6 +13,7 @@
  */
 
 #include <compat/strl.h>
+#include <retro_miscellaneous.h>
 #include <configuration.h>
 
 #include "../bluetooth_driver.h"
@@ -21,7 +22,6 @@
 typedef struct
 {
    bool bluetoothctl_cache[256];
-   unsigned bluetoothctl_counter[256];
    struct string_list* lines;
    char command[256];
 } bluetoothctl_t;
@@ -37,16 +37,57 @@ static void bluetoothctl_free(void *data)
       free(data);
 }
 
+static bool bluetoothctl_query_connected(bluetoothctl_t *btctl,
+      const char *line)
+{
+   /* Asks bluetoothctl once whether the device on this
+    * listing line is connected */
+   char ln[512]                    = {0};
+   char device[18]                 = {0};
+   bool connected                  = false;
+   FILE *command_file              = NULL;
+   static struct string_list* list = NULL;
+
+   list = string_split(line, " ");
+   if (!list)
+      return false;
+
+   if (list->size < 2)
+   {
+      string_list_free(list);
+      return false;
+   }
+
+   strlcpy(device, list->elems[1].data, sizeof(device));
+   string_list_free(list);
+
+   snprintf(btctl->command, sizeof(btctl->command), "\
+         bluetoothctl -- info %s | grep 'Connected: yes'",
+         device);
+
+   command_file = popen(btctl->command, "r");
+
+   while (fgets(ln, 512, command_file))
+   {
+      connected = true;
+      break;
+   }
+   pclose(command_file);
+
+   return connected;
+}
+
 static void bluetoothctl_scan(void *data)
 {
    char line[512];
+   unsigned i;
    union string_list_elem_attr attr;
    FILE *dev_file                   = NULL;
    bluetoothctl_t *btctl            = (bluetoothctl_t*) data;
 
    attr.i = 0;
    if (btctl->lines)
-      free(btctl->lines);
+      string_list_free(btctl->lines);
    btctl->lines = string_list_new();
 
    pclose(popen("bluetoothctl -- power on", "r"));
@@ -69,6 +110,12 @@ static void bluetoothctl_scan(void *data)
    }
 
    pclose(dev_file);
+
+   /* Capture the connection state once per scan; the menu
+    * then reads the cache instead of shelling out on a timer */
+   for (i = 0; i < btctl->lines->size && i < ARRAY_SIZE(btctl->bluetoothctl_cache); i++)
+      btctl->bluetoothctl_cache[i] =
+         bluetoothctl_query_connected(btctl, btctl->lines->elems[i].data);
 }
 
 static void bluetoothctl_get_devices(void *data, struct string_list* devices)
@@ -99,49 +146,14 @@ static void bluetoothctl_get_devices(void *data, struct string_list* devices)
 static bool bluetoothctl_device_is_connected(void *data, unsigned i)
 {
    bluetoothctl_t *btctl = (bluetoothctl_t*) data;
-   char ln[512]          = {0};
-   char device[18]       = {0};
-   const char *line      = btctl->lines->elems[i].data;
-   FILE *command_file    = NULL;
-
-   if (btctl->bluetoothctl_counter[i] == 60)
-   {
-      static struct string_list* list = NULL;
-      btctl->bluetoothctl_counter[i]  = 0;
-      list                            = string_split(line, " ");
-      if (!list)
-         return false;
-
-      if (list->size == 0)
-      {
-         string_list_free(list);
-         return false;
-      }
-
-      strlcpy(device, list->elems[1].data, sizeof(device));
-      string_list_free(list);
-
-      snprintf(btctl->command, sizeof(btctl->command), "\
-            bluetoothctl -- info %s | grep 'Connected: yes'",
-            device);
-
-      command_file = popen(btctl->command, "r");
 
-      while (fgets(ln, 512, command_file))
-      {
-         btctl->bluetoothctl_cache[i] = true;
-         return true;
-      }
-      pclose(command_file);
-      btctl->bluetoothctl_cache[i] = false;
-   }
-   else
-   {
-      btctl->bluetoothctl_counter[i]++;
-      return btctl->bluetoothctl_cache[i];
-   }
+   /* State captured when the device list was fetched and
+    * after connect attempts - nothing is spawned while the
+    * menu merely displays it */
+   if (i >= ARRAY_SIZE(btctl->bluetoothctl_cache))
+      return false;
 
-   return false;
+   return btctl->bluetoothctl_cache[i];
 }
 
 static bool bluetoothctl_connect_device(void *data, unsigned idx)
@@ -187,7 +199,9 @@ static bool bluetoothctl_connect_device(void *data, unsigned idx)
 
    pclose(popen(btctl->command, "r"));
 
-   btctl->bluetoothctl_counter[idx] = 0;
+   if (idx < ARRAY_SIZE(btctl->bluetoothctl_cache))
+      btctl->bluetoothctl_cache[idx] =
+         bluetoothctl_query_connected(btctl, line);
    return true;
 }
 
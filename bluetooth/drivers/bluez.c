@@ -54,8 +54,6 @@ typedef struct
     struct device_info_vector_list *devices;
     char adapter[256];
     DBusConnection* dbus_connection;
-    bool bluez_cache[256];
-    int bluez_cache_counter[256];
 } bluez_t;
 
 static void *bluez_init (void)
@@ -551,27 +549,15 @@ static void bluez_get_devices(void *data,
 
 static bool bluez_device_is_connected(void *data, unsigned i)
 {
-   int value;
    bluez_t *bluez = (bluez_t*)data;
 
-   if (bluez->bluez_cache_counter[i] == 60)
-   {
-      bluez->bluez_cache_counter[i] = 0;
-      bluez_dbus_connect(bluez);
-
-      /* Device disappeared */
-      if (get_bool_property(bluez, bluez->devices->data[i].path,
-            "org.bluez.Device1", "Connected", &value))
-          value = false;
-
-      bluez_dbus_disconnect(bluez);
-
-      bluez->bluez_cache[i] = value;
-      return value;
-   }
+   /* The "Connected" property arrives with the managed-objects
+    * dump at scan time and is updated when we connect, so the
+    * menu reads it without any periodic D-Bus round trips */
+   if (!bluez->devices || i >= bluez->devices->count)
+      return false;
 
-   bluez->bluez_cache_counter[i]++;
-   return bluez->bluez_cache[i];
+   return bluez->devices->data[i].connected;
 }
 
 static void bluez_device_get_sublabel(
@@ -600,7 +586,7 @@ static bool bluez_connect_device(void *data, unsigned i)
       return false;
 
    bluez_dbus_disconnect(bluez);
-   bluez->bluez_cache_counter[i] = 0;
+   bluez->devices->data[i].connected = 1;
    return true;
 }
 
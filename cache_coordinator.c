@@ -0,0 +1,202 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <string/stdstring.h>
+#include <features/features_cpu.h>
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "cache_coordinator.h"
+#include "frontend/frontend_driver.h"
+#include "verbosity.h"
+
+#define CACHE_COORDINATOR_MAX_CLIENTS     8
+
+/* Budget defaults to an eighth of physical memory, clamped to
+ * this range; used verbatim when the frontend cannot report
+ * memory size */
+#define CACHE_COORDINATOR_MIN_BUDGET      (16 * 1024 * 1024)
+#define CACHE_COORDINATOR_MAX_BUDGET      (256 * 1024 * 1024)
+#define CACHE_COORDINATOR_FALLBACK_BUDGET (64 * 1024 * 1024)
+
+/* Shrinking below this just drops the cache - a few KiB of
+ * residue is not worth keeping partial state around for */
+#define CACHE_COORDINATOR_MIN_SHRINK      4096
+
+struct cache_coordinator_client
+{
+   const char *name;
+   cache_coordinator_size_cb_t size_cb;
+   cache_coordinator_shrink_cb_t shrink_cb;
+   retro_time_t used;
+};
+
+/* TODO/FIXME - static globals */
+static struct cache_coordinator_client
+      cache_coordinator_clients[CACHE_COORDINATOR_MAX_CLIENTS];
+static unsigned cache_coordinator_client_count = 0;
+static size_t cache_coordinator_budget_bytes   = 0;
+
+static size_t cache_coordinator_budget(void)
+{
+   if (!cache_coordinator_budget_bytes)
+   {
+      uint64_t total_mem = frontend_driver_get_total_memory();
+
+      if (total_mem)
+      {
+         uint64_t budget = total_mem / 8;
+
+         if (budget < CACHE_COORDINATOR_MIN_BUDGET)
+            budget = CACHE_COORDINATOR_MIN_BUDGET;
+         else if (budget > CACHE_COORDINATOR_MAX_BUDGET)
+            budget = CACHE_COORDINATOR_MAX_BUDGET;
+
+         cache_coordinator_budget_bytes = (size_t)budget;
+      }
+      else
+         cache_coordinator_budget_bytes =
+               CACHE_COORDINATOR_FALLBACK_BUDGET;
+   }
+
+   return cache_coordinator_budget_bytes;
+}
+
+static size_t cache_coordinator_total(void)
+{
+   size_t total = 0;
+   unsigned i;
+
+   for (i = 0; i < cache_coordinator_client_count; i++)
+      total += cache_coordinator_clients[i].size_cb();
+
+   return total;
+}
+
+/* Brings the combined footprint back under budget by halving
+ * the least recently used cache until it fits */
+static void cache_coordinator_enforce(void)
+{
+   size_t budget = cache_coordinator_budget();
+   size_t total  = cache_coordinator_total();
+
+   while (total > budget)
+   {
+      struct cache_coordinator_client *victim = NULL;
+      size_t victim_size                      = 0;
+      size_t target;
+      size_t new_size;
+      unsigned i;
+
+      for (i = 0; i < cache_coordinator_client_count; i++)
+      {
+         struct cache_coordinator_client *client =
+               &cache_coordinator_clients[i];
+
+         if (!client->size_cb())
+            continue;
+
+         if (!victim || client->used < victim->used)
+            victim = client;
+      }
+
+      if (!victim)
+         break;
+
+      victim_size = victim->size_cb();
+      target      = victim_size / 2;
+
+      if (target < CACHE_COORDINATOR_MIN_SHRINK)
+         target = 0;
+
+      victim->shrink_cb(target);
+
+      new_size = victim->size_cb();
+
+      /* A cache that will not shrink must not stall the loop -
+       * stamp it as fresh so the next pass picks someone else */
+      if (new_size >= victim_size)
+         victim->used = cpu_features_get_time_usec();
+
+      total = cache_coordinator_total();
+   }
+}
+
+bool cache_coordinator_register(const char *name,
+      cache_coordinator_size_cb_t size_cb,
+      cache_coordinator_shrink_cb_t shrink_cb)
+{
+   unsigned i;
+
+   if (!name || !size_cb || !shrink_cb)
+      return false;
+
+   for (i = 0; i < cache_coordinator_client_count; i++)
+      if (string_is_equal(cache_coordinator_clients[i].name, name))
+         return true;
+
+   if (cache_coordinator_client_count >= CACHE_COORDINATOR_MAX_CLIENTS)
+      return false;
+
+   cache_coordinator_clients[cache_coordinator_client_count].name      = name;
+   cache_coordinator_clients[cache_coordinator_client_count].size_cb   = size_cb;
+   cache_coordinator_clients[cache_coordinator_client_count].shrink_cb = shrink_cb;
+   cache_coordinator_clients[cache_coordinator_client_count].used      =
+         cpu_features_get_time_usec();
+   cache_coordinator_client_count++;
+
+   return true;
+}
+
+void cache_coordinator_touch(const char *name)
+{
+   unsigned i;
+
+   for (i = 0; i < cache_coordinator_client_count; i++)
+   {
+      if (string_is_equal(cache_coordinator_clients[i].name, name))
+      {
+         cache_coordinator_clients[i].used = cpu_features_get_time_usec();
+         break;
+      }
+   }
+
+   cache_coordinator_enforce();
+}
+
+void cache_coordinator_pressure(enum cache_coordinator_pressure level)
+{
+   unsigned i;
+
+   for (i = 0; i < cache_coordinator_client_count; i++)
+   {
+      struct cache_coordinator_client *client =
+            &cache_coordinator_clients[i];
+      size_t limit = 0;
+
+      if (level == CACHE_PRESSURE_MODERATE)
+         limit = client->size_cb() / 2;
+
+      client->shrink_cb(limit);
+   }
+
+   RARCH_LOG("[Cache]: Memory pressure (%s), caches trimmed to %u KiB.\n",
+         (level == CACHE_PRESSURE_CRITICAL) ? "critical" : "moderate",
+         (unsigned)(cache_coordinator_total() / 1024));
+}
@@ -0,0 +1,68 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2021 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CACHE_COORDINATOR_H
+#define __CACHE_COORDINATOR_H
+
+#include <stddef.h>
+
+#include <boolean.h>
+#include <retro_common_api.h>
+
+RETRO_BEGIN_DECLS
+
+/* Central registrar for the in-memory caches scattered around
+ * the frontend (thumbnails, config contents, directory
+ * listings, ...). Each cache caps itself locally, but on small
+ * devices the independent caps can add up past what the system
+ * will tolerate - the coordinator keeps the combined footprint
+ * under one global budget, shrinking the least recently used
+ * cache first, and flushes everything when the platform reports
+ * memory pressure.
+ *
+ * All entry points are main-thread only, like the caches that
+ * register with them. */
+
+enum cache_coordinator_pressure
+{
+   /* Halve every registered cache */
+   CACHE_PRESSURE_MODERATE = 0,
+   /* Drop every registered cache */
+   CACHE_PRESSURE_CRITICAL
+};
+
+/* Returns the cache's current resident size in bytes */
+typedef size_t (*cache_coordinator_size_cb_t)(void);
+
+/* Shrinks the cache to at most @limit bytes; 0 drops it */
+typedef void (*cache_coordinator_shrink_cb_t)(size_t limit);
+
+/* Registers a cache under @name (a string literal; it is not
+ * copied). Re-registering an existing name is a no-op. Returns
+ * false when the client table is full. */
+bool cache_coordinator_register(const char *name,
+      cache_coordinator_size_cb_t size_cb,
+      cache_coordinator_shrink_cb_t shrink_cb);
+
+/* Stamps @name as recently used and re-checks the global
+ * budget; caches call this when they are hit or grow. */
+void cache_coordinator_touch(const char *name);
+
+/* Platform memory-pressure signal (e.g. Android onLowMemory) */
+void cache_coordinator_pressure(enum cache_coordinator_pressure level);
+
+RETRO_END_DECLS
+
+#endif
@@ -13,7 +13,9 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <compat/strl.h>
 #include <file/file_path.h>
+#include <string/stdstring.h>
 
 #include "../file_path_special.h"
 #include "../configuration.h"
@@ -24,42 +26,91 @@
 #ifdef HAVE_MENU
 
 #define CHEEVOS_MENU_BADGE_LIMIT 256
+
+/* Populating the achievements list only records which badge each entry
+ * wants; the image is decoded and uploaded the first time a menu driver
+ * actually draws that entry, so opening the list for a large set does
+ * not stall on hundreds of texture uploads at once. */
+typedef struct
+{
+   uintptr_t texture;
+   char badge[16];
+   bool locked;
+   bool loaded;
+} cheevos_menu_badge_t;
+
 /* TODO/FIXME - public global variables */
-static uintptr_t cheevos_badge_menu_texture_list[CHEEVOS_MENU_BADGE_LIMIT] = { 0 };
+static cheevos_menu_badge_t cheevos_menu_badge_list[CHEEVOS_MENU_BADGE_LIMIT] = {{ 0 }};
 
 void cheevos_reset_menu_badges(void)
 {
    int index;
    for (index = 0; index < CHEEVOS_MENU_BADGE_LIMIT; ++index)
    {
-      if (cheevos_badge_menu_texture_list[index])
-         video_driver_texture_unload(&cheevos_badge_menu_texture_list[index]);
+      if (cheevos_menu_badge_list[index].texture)
+         video_driver_texture_unload(&cheevos_menu_badge_list[index].texture);
    }
 
-   memset(&cheevos_badge_menu_texture_list, 0,
-         sizeof(cheevos_badge_menu_texture_list));
+   memset(&cheevos_menu_badge_list, 0,
+         sizeof(cheevos_menu_badge_list));
 }
 
 void cheevos_set_menu_badge(int index, const char *badge, bool locked)
 {
-   settings_t *settings = config_get_ptr();
+   cheevos_menu_badge_t *entry = NULL;
+   settings_t *settings        = config_get_ptr();
 
    if (index >= CHEEVOS_MENU_BADGE_LIMIT)
       return;
 
-   if (!settings || !settings->bools.cheevos_badges_enable)
-      cheevos_badge_menu_texture_list[index] = 0;
-   else
-      cheevos_badge_menu_texture_list[index] = 
-         cheevos_get_badge_texture(badge, locked);
+   entry = &cheevos_menu_badge_list[index];
+
+   if (!settings || !settings->bools.cheevos_badges_enable || !badge)
+   {
+      if (entry->texture)
+         video_driver_texture_unload(&entry->texture);
+      entry->badge[0] = '\0';
+      entry->loaded   = false;
+      return;
+   }
+
+   /* Same badge as last time - keep the texture if one was uploaded,
+    * and let a failed load retry (the download may have finished in
+    * the meantime). */
+   if (string_is_equal(entry->badge, badge) && entry->locked == locked)
+   {
+      if (!entry->texture)
+         entry->loaded = false;
+      return;
+   }
+
+   if (entry->texture)
+      video_driver_texture_unload(&entry->texture);
+
+   strlcpy(entry->badge, badge, sizeof(entry->badge));
+   entry->locked = locked;
+   entry->loaded = false;
 }
 
 uintptr_t cheevos_get_menu_badge_texture(int index)
 {
-   if (index < CHEEVOS_MENU_BADGE_LIMIT)
-      return cheevos_badge_menu_texture_list[index];
+   cheevos_menu_badge_t *entry = NULL;
+
+   if (index >= CHEEVOS_MENU_BADGE_LIMIT)
+      return 0;
+
+   entry = &cheevos_menu_badge_list[index];
+
+   /* The loaded flag sticks after the first attempt so an entry with
+    * no badge on disk does not hit the filesystem every frame. */
+   if (!entry->loaded && entry->badge[0])
+   {
+      entry->texture = cheevos_get_badge_texture(
+            entry->badge, entry->locked);
+      entry->loaded  = true;
+   }
 
-   return 0;
+   return entry->texture;
 }
 
 #endif
@@ -116,6 +116,8 @@ typedef struct
    const rcheevos_racheevo_t *info;
    int active;
    int last;
+   /* mode the background evaluation triggered in; awarded next frame */
+   int pending_unlock;
 } rcheevos_cheevo_t;
 
 typedef struct
@@ -124,6 +126,9 @@ typedef struct
    const rcheevos_ralboard_t* info;
    int last_value;
    int format;
+   /* RC_LBOARD_STATE_* event recorded by the background evaluation;
+    * handled next frame */
+   int pending_event;
    bool active;
 } rcheevos_lboard_t;
 
@@ -146,6 +151,16 @@ typedef struct rcheevos_async_io_request
    char hardcore;
 } rcheevos_async_io_request;
 
+/* Memory source plus the invalid-address flag rcheevos_peek reports
+ * through; passed to the rcheevos evaluation functions as their
+ * userdata so the live regions and a snapshot can be peeked with the
+ * same callback */
+typedef struct
+{
+   const rcheevos_memory_regions_t* regions;
+   bool invalid_peek_address;
+} rcheevos_peek_state_t;
+
 typedef struct
 {
    rcheevos_richpresence_t richpresence; /* retro_time_t alignment */
@@ -167,7 +182,25 @@ typedef struct
    bool hardcore_active;
    bool loaded;
    bool core_supports;
-   bool invalid_peek_address;
+
+#ifdef HAVE_THREADS
+   /* Background evaluation: a snapshot of the memory regions is taken
+    * once per frame and the triggers are tested on a worker thread,
+    * with results applied the next frame */
+   struct
+   {
+      sthread_t* thread;
+      slock_t* lock;
+      scond_t* cond;
+      rcheevos_memory_snapshot_t snapshot;
+      rcheevos_peek_state_t peek;
+      bool busy;
+      bool stop;
+      bool failed; /* could not start the worker; stay synchronous */
+      bool test_unofficial;
+      bool test_leaderboards;
+   } worker;
+#endif
 } rcheevos_locals_t;
 
 static rcheevos_locals_t rcheevos_locals =
@@ -188,7 +221,9 @@ static rcheevos_locals_t rcheevos_locals =
    false,/* hardcore_active */
    false,/* loaded */
    true, /* core_supports */
-   false,/* invalid_peek_address */
+#ifdef HAVE_THREADS
+   {0},  /* worker */
+#endif
 };
 
 #ifdef HAVE_THREADS
@@ -386,13 +421,14 @@ uint8_t* rcheevos_patch_address(unsigned address)
 
 static unsigned rcheevos_peek(unsigned address, unsigned num_bytes, void* ud)
 {
-   uint8_t* data = rcheevos_memory_find(&rcheevos_locals.memory, address);
+   rcheevos_peek_state_t* peek = (rcheevos_peek_state_t*)ud;
+   uint8_t* data = rcheevos_memory_find(peek->regions, address);
    if (data)
    {
       switch (num_bytes)
       {
          case 4:
-            return (data[3] << 24) | (data[2] << 16) | 
+            return (data[3] << 24) | (data[2] << 16) |
                    (data[1] <<  8) | (data[0]);
          case 3:
             return (data[2] << 16) | (data[1] << 8) | (data[0]);
@@ -403,7 +439,7 @@ static unsigned rcheevos_peek(unsigned address, unsigned num_bytes, void* ud)
       }
    }
 
-   rcheevos_locals.invalid_peek_address = true;
+   peek->invalid_peek_address = true;
    return 0;
 }
 
@@ -441,9 +477,13 @@ static retro_time_t rcheevos_async_send_rich_presence(
 
    if (cheevos_richpresence_enable && locals->richpresence.richpresence)
    {
+      rcheevos_peek_state_t peek;
+      peek.regions              = &locals->memory;
+      peek.invalid_peek_address = false;
+
       rc_evaluate_richpresence(locals->richpresence.richpresence,
          locals->richpresence.evaluation,
-         sizeof(locals->richpresence.evaluation), rcheevos_peek, NULL, NULL);
+         sizeof(locals->richpresence.evaluation), rcheevos_peek, &peek, NULL);
    }
 
    {
@@ -889,7 +929,9 @@ static int rcheevos_has_indirect_memref(const rc_memref_value_t* memrefs)
 
 static void rcheevos_test_cheevo_set(
       rcheevos_locals_t *locals,
-      bool official)
+      bool official,
+      rcheevos_peek_state_t *peek,
+      bool deferred)
 {
    int mode = RCHEEVOS_ACTIVE_SOFTCORE;
    rcheevos_cheevo_t* cheevo;
@@ -909,25 +951,25 @@ static void rcheevos_test_cheevo_set(
       count  = locals->patchdata.unofficial_count;
    }
 
-   locals->invalid_peek_address = false;
+   peek->invalid_peek_address = false;
 
    for (i = 0; i < count; i++, cheevo++)
    {
       /* Check if the achievement is active for the current mode. */
       if (cheevo->active & mode)
       {
-         int valid = rc_test_trigger(cheevo->trigger, rcheevos_peek, NULL, NULL);
+         int valid = rc_test_trigger(cheevo->trigger, rcheevos_peek, peek, NULL);
 
          /* trigger must be false for at least one frame before it can trigger. if last is true, the trigger hasn't yet been false. */
          if (cheevo->last)
          {
-            /* if the we're still waiting for the 
-             * trigger to stabilize, check to see 
+            /* if the we're still waiting for the
+             * trigger to stabilize, check to see
              * if an error occurred */
-            if (locals->invalid_peek_address)
+            if (peek->invalid_peek_address)
             {
                /* reset the flag for the next achievement */
-               locals->invalid_peek_address = false;
+               peek->invalid_peek_address = false;
 
                if (rcheevos_has_indirect_memref(cheevo->trigger->memrefs))
                {
@@ -952,7 +994,14 @@ static void rcheevos_test_cheevo_set(
             rc_reset_trigger(cheevo->trigger);
          }
          else if (valid)
-            rcheevos_award(locals, cheevo, mode);
+         {
+            /* the worker thread cannot push OSD messages or start
+             * tasks; it queues the unlock for the next frame */
+            if (deferred)
+               cheevo->pending_unlock = mode;
+            else
+               rcheevos_award(locals, cheevo, mode);
+         }
 
          cheevo->last = valid;
       }
@@ -1009,54 +1058,82 @@ static void rcheevos_lboard_submit(rcheevos_locals_t *locals,
    }
 }
 
-static void rcheevos_test_leaderboards(rcheevos_locals_t *locals)
+static void rcheevos_lboard_event(rcheevos_locals_t *locals,
+      rcheevos_lboard_t* lboard, int state)
+{
+   switch (state)
+   {
+      default:
+         break;
+
+      case RC_LBOARD_STATE_TRIGGERED:
+         rcheevos_lboard_submit(locals, lboard);
+         break;
+
+      case RC_LBOARD_STATE_CANCELED:
+         CHEEVOS_LOG(RCHEEVOS_TAG "Cancel leaderboard %s\n", lboard->info->title);
+         lboard->active = 0;
+         runloop_msg_queue_push("Leaderboard attempt cancelled!",
+               0, 2 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+         break;
+
+      case RC_LBOARD_STATE_STARTED:
+         if (!lboard->active)
+         {
+            char buffer[256];
+
+            CHEEVOS_LOG(RCHEEVOS_TAG "Leaderboard started: %s\n", lboard->info->title);
+            lboard->active     = 1;
+
+            snprintf(buffer, sizeof(buffer),
+                  "Leaderboard Active: %s", lboard->info->title);
+            runloop_msg_queue_push(buffer, 0, 2 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+            runloop_msg_queue_push(lboard->info->description, 0, 3 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
+         }
+         break;
+   }
+}
+
+static void rcheevos_test_leaderboards(rcheevos_locals_t *locals,
+      rcheevos_peek_state_t *peek, bool deferred)
 {
    unsigned	 i;
    rcheevos_lboard_t* lboard = locals->lboards;
 
-   locals->invalid_peek_address = false;
+   peek->invalid_peek_address = false;
 
    for (i = 0; i < locals->patchdata.lboard_count; i++, lboard++)
    {
+      int state;
+
       if (!lboard->lboard)
          continue;
 
-      switch (rc_evaluate_lboard(lboard->lboard, &lboard->last_value, rcheevos_peek, NULL, NULL))
-      {
-         default:
-            break;
-
-         case RC_LBOARD_STATE_TRIGGERED:
-            rcheevos_lboard_submit(locals, lboard);
-            break;
-
-         case RC_LBOARD_STATE_CANCELED:
-            CHEEVOS_LOG(RCHEEVOS_TAG "Cancel leaderboard %s\n", lboard->info->title);
-            lboard->active = 0;
-            runloop_msg_queue_push("Leaderboard attempt cancelled!",
-                  0, 2 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
-            break;
-
-         case RC_LBOARD_STATE_STARTED:
-            if (!lboard->active)
-            {
-               char buffer[256];
-
-               CHEEVOS_LOG(RCHEEVOS_TAG "Leaderboard started: %s\n", lboard->info->title);
-               lboard->active     = 1;
+      state = rc_evaluate_lboard(lboard->lboard,
+            &lboard->last_value, rcheevos_peek, peek, NULL);
 
-               snprintf(buffer, sizeof(buffer),
-                     "Leaderboard Active: %s", lboard->info->title);
-               runloop_msg_queue_push(buffer, 0, 2 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
-               runloop_msg_queue_push(lboard->info->description, 0, 3 * 60, false, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
-            }
-            break;
+      /* the worker thread cannot push OSD messages or start tasks;
+       * it records the state change for the next frame */
+      if (deferred)
+      {
+         switch (state)
+         {
+            case RC_LBOARD_STATE_TRIGGERED:
+            case RC_LBOARD_STATE_CANCELED:
+            case RC_LBOARD_STATE_STARTED:
+               lboard->pending_event = state;
+               break;
+            default:
+               break;
+         }
       }
+      else
+         rcheevos_lboard_event(locals, lboard, state);
 
-      if (locals->invalid_peek_address)
+      if (peek->invalid_peek_address)
       {
          /* reset the flag for the next leaderboard */
-         locals->invalid_peek_address = false;
+         peek->invalid_peek_address = false;
 
          if (!rcheevos_has_indirect_memref(lboard->lboard->memrefs))
          {
@@ -1070,6 +1147,191 @@ static void rcheevos_test_leaderboards(rcheevos_locals_t *locals)
    }
 }
 
+#ifdef HAVE_THREADS
+static void rcheevos_test_thread(void* userdata)
+{
+   rcheevos_locals_t* locals = (rcheevos_locals_t*)userdata;
+
+   slock_lock(locals->worker.lock);
+
+   for (;;)
+   {
+      while (!locals->worker.busy && !locals->worker.stop)
+         scond_wait(locals->worker.cond, locals->worker.lock);
+
+      if (locals->worker.stop)
+         break;
+
+      slock_unlock(locals->worker.lock);
+
+      locals->worker.peek.regions              = &locals->worker.snapshot.view;
+      locals->worker.peek.invalid_peek_address = false;
+
+      rcheevos_test_cheevo_set(locals, true, &locals->worker.peek, true);
+
+      if (locals->worker.test_unofficial)
+         rcheevos_test_cheevo_set(locals, false, &locals->worker.peek, true);
+
+      if (locals->worker.test_leaderboards)
+         rcheevos_test_leaderboards(locals, &locals->worker.peek, true);
+
+      slock_lock(locals->worker.lock);
+      locals->worker.busy = false;
+      scond_signal(locals->worker.cond);
+   }
+
+   slock_unlock(locals->worker.lock);
+}
+
+/* Blocks until the worker has finished evaluating the current snapshot.
+ * Must be called before mutating triggers or tearing down state the
+ * worker reads (hardcore toggles, resets, unload). */
+static void rcheevos_test_thread_wait(rcheevos_locals_t* locals)
+{
+   if (!locals->worker.thread)
+      return;
+
+   slock_lock(locals->worker.lock);
+
+   while (locals->worker.busy)
+      scond_wait(locals->worker.cond, locals->worker.lock);
+
+   slock_unlock(locals->worker.lock);
+}
+
+static void rcheevos_test_thread_destroy(rcheevos_locals_t* locals)
+{
+   if (locals->worker.thread)
+   {
+      slock_lock(locals->worker.lock);
+      locals->worker.stop = true;
+      scond_signal(locals->worker.cond);
+      slock_unlock(locals->worker.lock);
+
+      sthread_join(locals->worker.thread);
+      locals->worker.thread = NULL;
+      locals->worker.stop   = false;
+      locals->worker.busy   = false;
+   }
+
+   if (locals->worker.cond)
+   {
+      scond_free(locals->worker.cond);
+      locals->worker.cond = NULL;
+   }
+
+   if (locals->worker.lock)
+   {
+      slock_free(locals->worker.lock);
+      locals->worker.lock = NULL;
+   }
+
+   rcheevos_memory_snapshot_destroy(&locals->worker.snapshot);
+   locals->worker.failed = false;
+}
+
+/* Awards and leaderboard events recorded by the worker during the
+ * previous frame; only called while the worker is idle */
+static void rcheevos_apply_queued_events(rcheevos_locals_t* locals)
+{
+   rcheevos_cheevo_t* cheevo;
+   rcheevos_lboard_t* lboard;
+   unsigned i;
+
+   cheevo = locals->core;
+   for (i = 0; i < locals->patchdata.core_count; i++, cheevo++)
+   {
+      if (cheevo->pending_unlock)
+      {
+         int mode               = cheevo->pending_unlock;
+         cheevo->pending_unlock = 0;
+         rcheevos_award(locals, cheevo, mode);
+      }
+   }
+
+   cheevo = locals->unofficial;
+   for (i = 0; i < locals->patchdata.unofficial_count; i++, cheevo++)
+   {
+      if (cheevo->pending_unlock)
+      {
+         int mode               = cheevo->pending_unlock;
+         cheevo->pending_unlock = 0;
+         rcheevos_award(locals, cheevo, mode);
+      }
+   }
+
+   lboard = locals->lboards;
+   for (i = 0; i < locals->patchdata.lboard_count; i++, lboard++)
+   {
+      if (lboard->pending_event)
+      {
+         int state             = lboard->pending_event;
+         lboard->pending_event = 0;
+         rcheevos_lboard_event(locals, lboard, state);
+      }
+   }
+}
+
+/* Hands this frame's evaluation to the worker thread. Returns false if
+ * the worker is unavailable and the caller has to evaluate
+ * synchronously. */
+static bool rcheevos_test_offload(rcheevos_locals_t* locals,
+      settings_t* settings)
+{
+   if (locals->worker.failed)
+      return false;
+
+   if (!locals->worker.thread)
+   {
+      if (!locals->worker.lock)
+         locals->worker.lock = slock_new();
+      if (!locals->worker.cond)
+         locals->worker.cond = scond_new();
+
+      if (locals->worker.lock && locals->worker.cond)
+         locals->worker.thread = sthread_create(rcheevos_test_thread, locals);
+
+      if (!locals->worker.thread)
+      {
+         CHEEVOS_LOG(RCHEEVOS_TAG "Could not start evaluation thread, testing achievements synchronously\n");
+         locals->worker.failed = true;
+         return false;
+      }
+   }
+
+   slock_lock(locals->worker.lock);
+   if (locals->worker.busy)
+   {
+      /* still evaluating the previous snapshot; drop this frame
+       * instead of stalling the frontend */
+      slock_unlock(locals->worker.lock);
+      return true;
+   }
+   slock_unlock(locals->worker.lock);
+
+   /* the worker is idle, so last frame's results are final and the
+    * achievement state can be touched safely */
+   rcheevos_apply_queued_events(locals);
+
+   if (!rcheevos_memory_snapshot_capture(&locals->worker.snapshot,
+            &locals->memory))
+      return false;
+
+   locals->worker.test_unofficial   = settings
+      && settings->bools.cheevos_test_unofficial;
+   locals->worker.test_leaderboards = settings
+      && locals->hardcore_active
+      && settings->bools.cheevos_leaderboards_enable;
+
+   slock_lock(locals->worker.lock);
+   locals->worker.busy = true;
+   scond_signal(locals->worker.cond);
+   slock_unlock(locals->worker.lock);
+
+   return true;
+}
+#endif
+
 const char* rcheevos_get_richpresence(void)
 {
    if (rcheevos_locals.richpresence.richpresence)
@@ -1081,7 +1343,14 @@ void rcheevos_reset_game(void)
 {
    unsigned i;
    rcheevos_lboard_t* lboard;
-   rcheevos_cheevo_t* cheevo = rcheevos_locals.core;
+   rcheevos_cheevo_t* cheevo;
+
+#ifdef HAVE_THREADS
+   /* the worker evaluates the same triggers */
+   rcheevos_test_thread_wait(&rcheevos_locals);
+#endif
+
+   cheevo = rcheevos_locals.core;
 
    for (i = 0; i < rcheevos_locals.patchdata.core_count; i++, cheevo++)
    {
@@ -1312,6 +1581,11 @@ bool rcheevos_unload(void)
 
    if (rcheevos_locals.loaded)
    {
+#ifdef HAVE_THREADS
+      /* stop the evaluation thread before freeing what it reads */
+      rcheevos_test_thread_destroy(&rcheevos_locals);
+#endif
+
       for (i = 0, count = rcheevos_locals.patchdata.core_count; i < count; i++)
       {
          CHEEVOS_FREE(rcheevos_locals.core[i].trigger);
@@ -1358,6 +1632,11 @@ static void rcheevos_toggle_hardcore_active(rcheevos_locals_t *locals)
    settings_t* settings = config_get_ptr();
    bool rewind_enable = settings->bools.rewind_enable;
 
+#ifdef HAVE_THREADS
+   /* the mode switch resets triggers the worker may be testing */
+   rcheevos_test_thread_wait(locals);
+#endif
+
    if (!locals->hardcore_active)
    {
       /* activate hardcore */
@@ -1440,16 +1719,27 @@ void rcheevos_test(void)
       }
    }
 
-   rcheevos_test_cheevo_set(&rcheevos_locals, true);
+#ifdef HAVE_THREADS
+   if (rcheevos_test_offload(&rcheevos_locals, settings))
+      return;
+#endif
 
-   if (settings)
    {
-      if (settings->bools.cheevos_test_unofficial)
-         rcheevos_test_cheevo_set(&rcheevos_locals, false);
+      rcheevos_peek_state_t peek;
+      peek.regions              = &rcheevos_locals.memory;
+      peek.invalid_peek_address = false;
 
-      if (     rcheevos_locals.hardcore_active 
-            && settings->bools.cheevos_leaderboards_enable)
-         rcheevos_test_leaderboards(&rcheevos_locals);
+      rcheevos_test_cheevo_set(&rcheevos_locals, true, &peek, false);
+
+      if (settings)
+      {
+         if (settings->bools.cheevos_test_unofficial)
+            rcheevos_test_cheevo_set(&rcheevos_locals, false, &peek, false);
+
+         if (     rcheevos_locals.hardcore_active
+               && settings->bools.cheevos_leaderboards_enable)
+            rcheevos_test_leaderboards(&rcheevos_locals, &peek, false);
+      }
    }
 }
 
@@ -1474,6 +1764,11 @@ static void rcheevos_unlock_cb(unsigned id, void* userdata)
    unsigned j = 0, count     = 0;
    rcheevos_cheevo_t* cheevo = NULL;
 
+#ifdef HAVE_THREADS
+   /* deactivation races with the worker reading cheevo->active */
+   rcheevos_test_thread_wait(&rcheevos_locals);
+#endif
+
    for (i = 0; i < 2; i++)
    {
       if (i == 0)
@@ -1825,6 +2120,17 @@ static int rcheevos_iterate(rcheevos_coro_t* coro)
       cheevos_reset_menu_badges();
 #endif
 
+      /* Resolve the badge directory once for the whole batch instead
+       * of once per badge file. */
+      coro->badge_basepath[0] = '\0';
+      fill_pathname_application_special(
+            coro->badge_basepath,
+            sizeof(coro->badge_basepath),
+            APPLICATION_SPECIAL_DIRECTORY_THUMBNAILS_CHEEVOS_BADGES);
+
+      if (!path_is_directory(coro->badge_basepath))
+         path_mkdir(coro->badge_basepath);
+
       for (coro->i = 0; coro->i < 2; coro->i++)
       {
          if (coro->i == 0)
@@ -1845,19 +2151,6 @@ static int rcheevos_iterate(rcheevos_coro_t* coro)
 
             for (coro->j = 0 ; coro->j < 2; coro->j++)
             {
-               coro->badge_fullpath[0] = '\0';
-               fill_pathname_application_special(
-                     coro->badge_fullpath,
-                     sizeof(coro->badge_fullpath),
-                     APPLICATION_SPECIAL_DIRECTORY_THUMBNAILS_CHEEVOS_BADGES);
-
-               if (!path_is_directory(coro->badge_fullpath))
-                  path_mkdir(coro->badge_fullpath);
-               CORO_YIELD();
-
-               if (!coro->cheevo->info->badge || !coro->cheevo->info->badge[0])
-                  continue;
-
                if (coro->j == 0)
                   snprintf(coro->badge_name,
                         sizeof(coro->badge_name),
@@ -1871,7 +2164,7 @@ static int rcheevos_iterate(rcheevos_coro_t* coro)
 
                fill_pathname_join(
                      coro->badge_fullpath,
-                     coro->badge_fullpath,
+                     coro->badge_basepath,
                      coro->badge_name,
                      sizeof(coro->badge_fullpath));
 
@@ -27,23 +27,31 @@
 uint8_t* rcheevos_memory_find(
       const rcheevos_memory_regions_t* regions, unsigned address)
 {
-   unsigned i;
+   unsigned lo, hi;
 
-   for (i = 0; i < regions->count; ++i)
-   {
-      const size_t size = regions->size[i];
-      if (address < size)
-      {
-         if (regions->data[i] == NULL)
-            break;
+   if (regions->count == 0 || address >= regions->total_size)
+      return NULL;
 
-         return &regions->data[i][address];
-      }
+   /* binary search the precomputed region bases - achievement sets
+    * can have thousands of memory references and each one resolves
+    * through here every frame */
+   lo = 0;
+   hi = regions->count - 1;
 
-      address -= size;
+   while (lo < hi)
+   {
+      const unsigned mid = (lo + hi + 1) / 2;
+
+      if (address >= regions->base[mid])
+         lo = mid;
+      else
+         hi = mid - 1;
    }
 
-   return NULL;
+   if (regions->data[lo] == NULL)
+      return NULL;
+
+   return &regions->data[lo][address - regions->base[lo]];
 }
 
 static const char* rcheevos_memory_type(int type)
@@ -91,6 +99,7 @@ static void rcheevos_memory_register_region(rcheevos_memory_regions_t* regions,
       /* create new region */
       regions->data[regions->count] = data;
       regions->size[regions->count] = size;
+      regions->base[regions->count] = regions->total_size;
       ++regions->count;
    }
 
@@ -312,6 +321,63 @@ void rcheevos_memory_destroy(rcheevos_memory_regions_t* regions)
    memset(regions, 0, sizeof(*regions));
 }
 
+bool rcheevos_memory_snapshot_capture(rcheevos_memory_snapshot_t* snapshot,
+      const rcheevos_memory_regions_t* regions)
+{
+   unsigned i;
+   size_t mapped_size = 0;
+   uint8_t* dest;
+
+   for (i = 0; i < regions->count; ++i)
+   {
+      if (regions->data[i])
+         mapped_size += regions->size[i];
+   }
+
+   if (mapped_size > snapshot->buffer_size)
+   {
+      uint8_t* buffer = (uint8_t*)realloc(snapshot->buffer, mapped_size);
+
+      if (!buffer)
+         return false;
+
+      snapshot->buffer      = buffer;
+      snapshot->buffer_size = mapped_size;
+   }
+
+   /* copy the mapped regions back to back; unmapped regions keep their
+    * NULL data pointer so lookups fail the same way they do on the
+    * live regions */
+   dest = snapshot->buffer;
+
+   for (i = 0; i < regions->count; ++i)
+   {
+      if (regions->data[i])
+      {
+         memcpy(dest, regions->data[i], regions->size[i]);
+         snapshot->view.data[i] = dest;
+         dest += regions->size[i];
+      }
+      else
+         snapshot->view.data[i] = NULL;
+
+      snapshot->view.size[i] = regions->size[i];
+      snapshot->view.base[i] = regions->base[i];
+   }
+
+   snapshot->view.count      = regions->count;
+   snapshot->view.total_size = regions->total_size;
+   return true;
+}
+
+void rcheevos_memory_snapshot_destroy(rcheevos_memory_snapshot_t* snapshot)
+{
+   if (snapshot->buffer)
+      free(snapshot->buffer);
+
+   memset(snapshot, 0, sizeof(*snapshot));
+}
+
 bool rcheevos_memory_init(rcheevos_memory_regions_t* regions, int console)
 {
    unsigned i;
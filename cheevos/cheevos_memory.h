@@ -29,16 +29,32 @@ typedef struct
 {
    uint8_t* data[MAX_MEMORY_REGIONS];
    size_t size[MAX_MEMORY_REGIONS];
+   /* start address of each region within the combined space, so
+    * lookups can binary search instead of walking the region list */
+   size_t base[MAX_MEMORY_REGIONS];
    size_t total_size;
    unsigned count;
 } rcheevos_memory_regions_t;
 
+typedef struct
+{
+   /* Mirrors the live regions, but with data[] pointing into buffer,
+    * so rcheevos_memory_find works on a snapshot unchanged */
+   rcheevos_memory_regions_t view;
+   uint8_t* buffer;
+   size_t buffer_size;
+} rcheevos_memory_snapshot_t;
+
 bool rcheevos_memory_init(rcheevos_memory_regions_t* regions, int console);
 void rcheevos_memory_destroy(rcheevos_memory_regions_t* regions);
 
 uint8_t* rcheevos_memory_find(const rcheevos_memory_regions_t* regions,
       unsigned address);
 
+bool rcheevos_memory_snapshot_capture(rcheevos_memory_snapshot_t* snapshot,
+      const rcheevos_memory_regions_t* regions);
+void rcheevos_memory_snapshot_destroy(rcheevos_memory_snapshot_t* snapshot);
+
 RETRO_END_DECLS
 
 #endif
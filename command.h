@@ -164,6 +164,10 @@ enum event_command
    CMD_EVENT_NETPLAY_DISCONNECT,
    /* Reinitializes audio driver. */
    CMD_EVENT_AUDIO_REINIT,
+   /* Re-opens the audio output device in place, keeping the rest
+    * of the audio stack; falls back to CMD_EVENT_AUDIO_REINIT
+    * behaviour if the device cannot be migrated. */
+   CMD_EVENT_AUDIO_DEVICE_MIGRATE,
    /* Resizes windowed scale. Will reinitialize video driver. */
    CMD_EVENT_RESIZE_WINDOWED_SCALE,
    CMD_EVENT_LOG_FILE_DEINIT,
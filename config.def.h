@@ -259,6 +259,12 @@
  */
 #define DEFAULT_FRAME_DELAY 0
 
+/* How many milliseconds of slack the automatic frame delay
+ * calibration keeps between expected core frame time and the
+ * refresh budget. Only used while video_frame_delay is > 0.
+ */
+#define DEFAULT_FRAME_DELAY_HEADROOM 2
+
 /* Inserts a black frame inbetween frames.
  * Useful for 120 Hz monitors who want to play 60 Hz material with eliminated
  * ghosting. video_refresh_rate should still be configured as if it
@@ -266,6 +272,14 @@
  */
 #define DEFAULT_BLACK_FRAME_INSERTION false
 
+/* Re-presents the current frame on the extra refresh of a
+ * high-rate display (e.g. 60 fps content on a 120 Hz panel)
+ * instead of inserting a black frame. Smooths motion without
+ * the brightness loss of black frame insertion. Takes priority
+ * over black frame insertion when both are enabled.
+ */
+#define DEFAULT_FRAME_DUPLICATION false
+
 /* Uses a custom swap interval for VSync.
  * Set this to effectively halve monitor refresh rate.
  */
@@ -496,6 +510,10 @@ static const bool menu_show_load_content       = true;
 #ifdef HAVE_CDROM
 static const bool menu_show_load_disc          = true;
 static const bool menu_show_dump_disc          = true;
+
+/* Size (in MB) of the read-ahead sector cache used when
+ * reading from physical drives; 0 disables caching. */
+#define DEFAULT_CDROM_CACHE_SIZE 16
 #endif
 static const bool menu_show_information        = true;
 static const bool menu_show_configurations     = true;
@@ -716,9 +734,22 @@ static const float message_bgcolor_opacity = 1.0f;
 /* Screenshots named automatically. */
 #define DEFAULT_AUTO_SCREENSHOT_FILENAME true
 
+/* On content close, capture the last frame as a playlist
+ * thumbnail for entries that have no scraped art. */
+#define DEFAULT_AUTO_CAPTURE_THUMBNAILS false
+
 /* Record post-shaded GPU output instead of raw game footage if available. */
 #define DEFAULT_GPU_RECORD false
 
+/* Publish each frame to a named shared-memory region so external
+ * capture tools can read it (see frame_export.h). */
+#define DEFAULT_FRAME_EXPORT false
+
+/* Hash software frames and present unchanged ones as dupes,
+ * skipping conversion/filtering/upload. Spends CPU on the hash
+ * every frame to save GPU work, so it is opt-in. */
+#define DEFAULT_FRAME_DUPE_ELISION false
+
 /* OSD-messages. */
 #define DEFAULT_FONT_ENABLE true
 
@@ -997,6 +1028,13 @@ static const bool savestate_thumbnail_enable = false;
 #define DEFAULT_SAVE_FILE_COMPRESSION false
 #endif
 
+/* When autosave is active, append SRAM deltas to an
+ * on-disk journal instead of rewriting the whole save
+ * file every interval; the full file is materialized
+ * when content is closed. Interrupted writes are
+ * recovered from the journal on the next load */
+#define DEFAULT_SAVE_FILE_JOURNALING false
+
 /* When creating save state files, compress
  * written data */
 #if defined(__WINRT__) || defined(WINAPI_FAMILY) && WINAPI_FAMILY == WINAPI_FAMILY_PHONE_APP
@@ -1021,6 +1059,11 @@ static const bool savestate_thumbnail_enable = false;
 /* When using the Run Ahead feature, use a secondary instance of the core. */
 #define DEFAULT_RUN_AHEAD_SECONDARY_INSTANCE true
 
+/* Run the primary core on a worker thread while the secondary
+ * instance presents. Experimental: requires a core that tolerates
+ * concurrent retro_run in both instances, so it is opt-in. */
+#define DEFAULT_RUN_AHEAD_PIPELINED false
+
 /* Hide warning messages when using the Run Ahead feature. */
 #define DEFAULT_RUN_AHEAD_HIDE_WARNINGS false
 
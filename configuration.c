@@ -27,12 +27,17 @@
 #include <retro_assert.h>
 #include <string/stdstring.h>
 #include <streams/file_stream.h>
+#include <features/features_cpu.h>
+#ifdef HAVE_CDROM
+#include <vfs/vfs_implementation_cdrom.h>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
 
 #include "file_path_special.h"
+#include "cache_coordinator.h"
 #include "configuration.h"
 #include "content.h"
 #include "config.def.h"
@@ -1392,6 +1397,8 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("ui_companion_toggle",           &settings->bools.ui_companion_toggle, false, ui_companion_toggle, false);
    SETTING_BOOL("desktop_menu_enable",           &settings->bools.desktop_menu_enable, true, DEFAULT_DESKTOP_MENU_ENABLE, false);
    SETTING_BOOL("video_gpu_record",              &settings->bools.video_gpu_record, true, DEFAULT_GPU_RECORD, false);
+   SETTING_BOOL("video_frame_export",            &settings->bools.video_frame_export, true, DEFAULT_FRAME_EXPORT, false);
+   SETTING_BOOL("video_frame_dupe_elision",      &settings->bools.video_frame_dupe_elision, true, DEFAULT_FRAME_DUPE_ELISION, false);
    SETTING_BOOL("input_remap_binds_enable",      &settings->bools.input_remap_binds_enable, true, true, false);
    SETTING_BOOL("menu_swap_ok_cancel_buttons",   &settings->bools.input_menu_swap_ok_cancel_buttons, true, DEFAULT_MENU_SWAP_OK_CANCEL_BUTTONS, false);
 #ifdef HAVE_NETWORKING
@@ -1441,6 +1448,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("apply_cheats_after_load",       &settings->bools.apply_cheats_after_load, true, DEFAULT_APPLY_CHEATS_AFTER_LOAD, false);
    SETTING_BOOL("run_ahead_enabled",             &settings->bools.run_ahead_enabled, true, false, false);
    SETTING_BOOL("run_ahead_secondary_instance",  &settings->bools.run_ahead_secondary_instance, true, DEFAULT_RUN_AHEAD_SECONDARY_INSTANCE, false);
+   SETTING_BOOL("run_ahead_pipelined",           &settings->bools.run_ahead_pipelined, true, DEFAULT_RUN_AHEAD_PIPELINED, false);
    SETTING_BOOL("run_ahead_hide_warnings",       &settings->bools.run_ahead_hide_warnings, true, DEFAULT_RUN_AHEAD_HIDE_WARNINGS, false);
    SETTING_BOOL("audio_sync",                    &settings->bools.audio_sync, true, DEFAULT_AUDIO_SYNC, false);
    SETTING_BOOL("video_shader_enable",           &settings->bools.video_shader_enable, true, DEFAULT_SHADER_ENABLE, false);
@@ -1460,6 +1468,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("video_threaded",                video_driver_get_threaded(), true, DEFAULT_VIDEO_THREADED, false);
    SETTING_BOOL("video_shared_context",          &settings->bools.video_shared_context, true, DEFAULT_VIDEO_SHARED_CONTEXT, false);
    SETTING_BOOL("auto_screenshot_filename",      &settings->bools.auto_screenshot_filename, true, DEFAULT_AUTO_SCREENSHOT_FILENAME, false);
+   SETTING_BOOL("auto_capture_thumbnails",       &settings->bools.auto_capture_thumbnails, true, DEFAULT_AUTO_CAPTURE_THUMBNAILS, false);
    SETTING_BOOL("video_force_srgb_disable",      &settings->bools.video_force_srgb_disable, true, false, false);
    SETTING_BOOL("video_fullscreen",              &settings->bools.video_fullscreen, true, DEFAULT_FULLSCREEN, false);
    SETTING_BOOL("bundle_assets_extract_enable",  &settings->bools.bundle_assets_extract_enable, true, DEFAULT_BUNDLE_ASSETS_EXTRACT_ENABLE, false);
@@ -1467,6 +1476,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("video_adaptive_vsync",          &settings->bools.video_adaptive_vsync, true, DEFAULT_ADAPTIVE_VSYNC, false);
    SETTING_BOOL("video_hard_sync",               &settings->bools.video_hard_sync, true, DEFAULT_HARD_SYNC, false);
    SETTING_BOOL("video_black_frame_insertion",   &settings->bools.video_black_frame_insertion, true, DEFAULT_BLACK_FRAME_INSERTION, false);
+   SETTING_BOOL("video_frame_duplication",       &settings->bools.video_frame_duplication, true, DEFAULT_FRAME_DUPLICATION, false);
    SETTING_BOOL("video_disable_composition",     &settings->bools.video_disable_composition, true, DEFAULT_DISABLE_COMPOSITION, false);
    SETTING_BOOL("pause_nonactive",               &settings->bools.pause_nonactive, true, DEFAULT_PAUSE_NONACTIVE, false);
    SETTING_BOOL("video_gpu_screenshot",          &settings->bools.video_gpu_screenshot, true, DEFAULT_GPU_SCREENSHOT, false);
@@ -1690,6 +1700,7 @@ static struct config_bool_setting *populate_settings_bool(
    SETTING_BOOL("savestate_auto_load",          &settings->bools.savestate_auto_load, true, savestate_auto_load, false);
    SETTING_BOOL("savestate_thumbnail_enable",   &settings->bools.savestate_thumbnail_enable, true, savestate_thumbnail_enable, false);
    SETTING_BOOL("save_file_compression",        &settings->bools.save_file_compression, true, DEFAULT_SAVE_FILE_COMPRESSION, false);
+   SETTING_BOOL("save_file_journaling",         &settings->bools.save_file_journaling, true, DEFAULT_SAVE_FILE_JOURNALING, false);
    SETTING_BOOL("savestate_file_compression",   &settings->bools.savestate_file_compression, true, DEFAULT_SAVESTATE_FILE_COMPRESSION, false);
    SETTING_BOOL("history_list_enable",          &settings->bools.history_list_enable, true, DEFAULT_HISTORY_LIST_ENABLE, false);
    SETTING_BOOL("playlist_entry_rename",        &settings->bools.playlist_entry_rename, true, DEFAULT_PLAYLIST_ENTRY_RENAME, false);
@@ -1831,6 +1842,9 @@ static struct config_uint_setting *populate_settings_uint(
    SETTING_UINT("accessibility_narrator_speech_speed",  		         &settings->uints.accessibility_narrator_speech_speed, true, DEFAULT_ACCESSIBILITY_NARRATOR_SPEECH_SPEED, false);
 #ifdef HAVE_NETWORKING
    SETTING_UINT("streaming_mode",  		         &settings->uints.streaming_mode, true, STREAMING_MODE_TWITCH, false);
+#ifdef HAVE_CDROM
+   SETTING_UINT("cdrom_cache_size",             &settings->uints.cdrom_cache_size, true, DEFAULT_CDROM_CACHE_SIZE, false);
+#endif
 #endif
    SETTING_UINT("crt_switch_resolution",  		&settings->uints.crt_switch_resolution, true, DEFAULT_CRT_SWITCH_RESOLUTION, false);
    SETTING_UINT("input_bind_timeout",           &settings->uints.input_bind_timeout,     true, input_bind_timeout, false);
@@ -1938,6 +1952,7 @@ static struct config_uint_setting *populate_settings_uint(
    SETTING_UINT("content_history_size",         &settings->uints.content_history_size,   true, default_content_history_size, false);
    SETTING_UINT("video_hard_sync_frames",       &settings->uints.video_hard_sync_frames, true, DEFAULT_HARD_SYNC_FRAMES, false);
    SETTING_UINT("video_frame_delay",            &settings->uints.video_frame_delay,      true, DEFAULT_FRAME_DELAY, false);
+   SETTING_UINT("video_frame_delay_headroom",   &settings->uints.video_frame_delay_headroom, true, DEFAULT_FRAME_DELAY_HEADROOM, false);
    SETTING_UINT("video_max_swapchain_images",   &settings->uints.video_max_swapchain_images, true, DEFAULT_MAX_SWAPCHAIN_IMAGES, false);
    SETTING_UINT("video_swap_interval",          &settings->uints.video_swap_interval, true, DEFAULT_SWAP_INTERVAL, false);
    SETTING_UINT("video_rotation",               &settings->uints.video_rotation, true, ORIENTATION_NORMAL, false);
@@ -2647,6 +2662,188 @@ static bool check_menu_driver_compatibility(settings_t *settings)
 }
 #endif
 
+/* Raw-contents cache for config files on the content load path.
+ *
+ * Loading content with overrides enabled re-reads the base config
+ * plus the same handful of override/remap files - with frequent
+ * content switches (e.g. playlist cycling) that is the same small
+ * set of files parsed over and over. Keep the raw contents of the
+ * last few files resident so repeated loads parse from memory
+ * instead of hitting the disk.
+ *
+ * Entries are validated by file size and the whole cache is
+ * flushed whenever RetroArch itself writes a config file; a
+ * deleted file simply misses (size query fails). The only way to
+ * get a stale hit is an external edit that keeps the size
+ * identical while RetroArch is running. */
+
+#define CONFIG_CACHE_ENTRIES  8
+/* Don't keep unusually large files resident */
+#define CONFIG_CACHE_MAX_SIZE (512 * 1024)
+
+struct config_cache_entry
+{
+   char *path;
+   char *data;
+   int64_t size;
+};
+
+static struct config_cache_entry config_cache[CONFIG_CACHE_ENTRIES];
+static unsigned config_cache_replace_idx = 0;
+
+static void config_cache_flush(void)
+{
+   unsigned i;
+
+   for (i = 0; i < CONFIG_CACHE_ENTRIES; i++)
+   {
+      if (config_cache[i].path)
+         free(config_cache[i].path);
+      if (config_cache[i].data)
+         free(config_cache[i].data);
+      config_cache[i].path = NULL;
+      config_cache[i].data = NULL;
+      config_cache[i].size = 0;
+   }
+
+   config_cache_replace_idx = 0;
+}
+
+/* Cache coordinator hooks */
+static size_t config_cache_resident_bytes(void)
+{
+   size_t total = 0;
+   unsigned i;
+
+   for (i = 0; i < CONFIG_CACHE_ENTRIES; i++)
+      total += (size_t)config_cache[i].size;
+
+   return total;
+}
+
+static void config_cache_shrink(size_t limit)
+{
+   unsigned i;
+
+   /* Entries are all small and of similar value - free in
+    * replacement order until under the limit */
+   for (i = 0; i < CONFIG_CACHE_ENTRIES; i++)
+   {
+      struct config_cache_entry *entry = &config_cache[
+            (config_cache_replace_idx + i) % CONFIG_CACHE_ENTRIES];
+
+      if (config_cache_resident_bytes() <= limit)
+         return;
+
+      if (entry->path)
+         free(entry->path);
+      if (entry->data)
+         free(entry->data);
+      entry->path = NULL;
+      entry->data = NULL;
+      entry->size = 0;
+   }
+}
+
+/* Returns the cached contents of @path - reading and caching
+ * them first if necessary - as a scratch copy the caller owns
+ * and config parsing may tokenize in place. NULL if the file
+ * cannot be read or is too large to cache. */
+static char *config_cache_get(const char *path, int64_t *size)
+{
+   unsigned i;
+   char *copy                       = NULL;
+   struct config_cache_entry *entry = NULL;
+   int64_t current_size             = path_get_size(path);
+
+   if (current_size <= 0 || current_size > CONFIG_CACHE_MAX_SIZE)
+      return NULL;
+
+   for (i = 0; i < CONFIG_CACHE_ENTRIES; i++)
+   {
+      if (  config_cache[i].path &&
+            string_is_equal(config_cache[i].path, path))
+      {
+         entry = &config_cache[i];
+         break;
+      }
+   }
+
+   if (!entry || entry->size != current_size)
+   {
+      uint8_t *buf = NULL;
+      int64_t len  = 0;
+
+      if (!filestream_read_file(path, (void**)&buf, &len) || (len <= 0))
+      {
+         if (buf)
+            free(buf);
+         return NULL;
+      }
+
+      if (!entry)
+      {
+         entry                    = &config_cache[config_cache_replace_idx];
+         config_cache_replace_idx = (config_cache_replace_idx + 1)
+               % CONFIG_CACHE_ENTRIES;
+      }
+
+      if (entry->path)
+         free(entry->path);
+      if (entry->data)
+         free(entry->data);
+
+      entry->path = strdup(path);
+      entry->data = (char*)buf;
+      entry->size = len;
+
+      cache_coordinator_register("config_contents",
+            config_cache_resident_bytes, config_cache_shrink);
+      cache_coordinator_touch("config_contents");
+   }
+
+   if (!(copy = (char*)malloc((size_t)entry->size + 1)))
+      return NULL;
+
+   memcpy(copy, entry->data, (size_t)entry->size);
+   copy[entry->size] = '\0';
+
+   if (size)
+      *size          = entry->size;
+
+   return copy;
+}
+
+static config_file_t *config_file_new_cached(const char *path)
+{
+   config_file_t *conf = NULL;
+   char *contents      = config_cache_get(path, NULL);
+
+   /* Fall back to the direct path for files the cache
+    * does not handle */
+   if (!contents)
+      return config_file_new_from_path_to_string(path);
+
+   conf = config_file_new_from_string(contents, path);
+   free(contents);
+
+   return conf;
+}
+
+static bool config_append_file_cached(config_file_t *conf, const char *path)
+{
+   bool ret       = false;
+   char *contents = config_cache_get(path, NULL);
+
+   if (!contents)
+      return config_append_file(conf, path);
+
+   ret = config_append_string(conf, contents, path);
+   free(contents);
+
+   return ret;
+}
+
 /**
  * open_default_config_file
  *
@@ -2906,7 +3103,7 @@ static bool config_load_file(global_t *global,
    struct config_size_setting *size_settings       = populate_settings_size  (settings, &size_settings_size);
    struct config_array_setting *array_settings     = populate_settings_array (settings, &array_settings_size);
    struct config_path_setting *path_settings       = populate_settings_path  (settings, &path_settings_size);
-   config_file_t *conf                             = path ? config_file_new_from_path_to_string(path) : open_default_config_file();
+   config_file_t *conf                             = path ? config_file_new_cached(path) : open_default_config_file();
 
    tmp_str[0] = '\0';
 
@@ -2932,7 +3129,7 @@ static bool config_load_file(global_t *global,
 
       while (extra_path)
       {
-         bool result = config_append_file(conf, extra_path);
+         bool result = config_append_file_cached(conf, extra_path);
 
          RARCH_LOG("Config: appending config \"%s\"\n", extra_path);
 
@@ -3118,6 +3315,9 @@ static bool config_load_file(global_t *global,
    if (settings->uints.video_frame_delay > 15)
       settings->uints.video_frame_delay = 15;
 
+   if (settings->uints.video_frame_delay_headroom > 15)
+      settings->uints.video_frame_delay_headroom = 15;
+
    settings->uints.video_swap_interval = MAX(settings->uints.video_swap_interval, 1);
    settings->uints.video_swap_interval = MIN(settings->uints.video_swap_interval, 4);
 
@@ -3350,6 +3550,11 @@ static bool config_load_file(global_t *global,
    frontend_driver_set_sustained_performance_mode(settings->bools.sustained_performance_mode);
    recording_driver_update_streaming_url();
 
+#ifdef HAVE_CDROM
+   retro_vfs_file_set_cdrom_cache_size(
+         (size_t)settings->uints.cdrom_cache_size * 1024 * 1024);
+#endif
+
    if (!config_entry_exists(conf, "user_language"))
       msg_hash_set_uint(MSG_HASH_USER_LANGUAGE, frontend_driver_get_user_language());
 
@@ -3661,7 +3866,7 @@ bool config_load_remap(const char *directory_input_remapping,
 #endif
 
    /* If a game remap file exists, load it. */
-   if ((new_conf = config_file_new_from_path_to_string(game_path)))
+   if ((new_conf = config_file_new_cached(game_path)))
    {
       RARCH_LOG("[Remaps]: game-specific remap found at %s.\n", game_path);
       if (input_remapping_load_file(new_conf, game_path))
@@ -3674,7 +3879,7 @@ bool config_load_remap(const char *directory_input_remapping,
    }
 
    /* If a content-dir remap file exists, load it. */
-   if ((new_conf = config_file_new_from_path_to_string(content_path)))
+   if ((new_conf = config_file_new_cached(content_path)))
    {
       RARCH_LOG("[Remaps]: content-dir-specific remap found at %s.\n", content_path);
       if (input_remapping_load_file(new_conf, content_path))
@@ -3686,7 +3891,7 @@ bool config_load_remap(const char *directory_input_remapping,
    }
 
    /* If a core remap file exists, load it. */
-   if ((new_conf = config_file_new_from_path_to_string(core_path)))
+   if ((new_conf = config_file_new_cached(core_path)))
    {
       RARCH_LOG("[Remaps]: core-specific remap found at %s.\n", core_path);
       if (input_remapping_load_file(new_conf, core_path))
@@ -4108,6 +4313,7 @@ bool config_save_file(const char *path)
 
    ret = config_file_write(conf, path, true);
    config_file_free(conf);
+   config_cache_flush();
 
    return ret;
 }
@@ -4325,6 +4531,7 @@ bool config_save_overrides(enum override_type type, void *data)
       }
 
       config_file_free(conf);
+      config_cache_flush();
    }
 
    if (bool_settings)
@@ -4360,6 +4567,79 @@ bool config_save_overrides(enum override_type type, void *data)
    return ret;
 }
 
+/* Write-coalescing autosave
+ * > Every settings mutation raises settings->modified;
+ *   once the flag has stayed raised through a full
+ *   debounce window, the configuration is serialized
+ *   from the running session - rapid bursts of changes
+ *   collapse into one save
+ * > The config_file layer only touches the disk when a
+ *   key actually changed value (and looks keys up via
+ *   its hash index), so a save that turns out to be a
+ *   no-op costs serialization time but no flash write
+ * > Shutdown then re-serializes only what changed after
+ *   the last autosave, keeping the exit path short */
+#define CONFIG_AUTOSAVE_DEBOUNCE_USEC (3 * 1000000)
+
+/* TODO/FIXME - static global variables */
+static retro_time_t config_autosave_dirty_since = 0;
+static bool config_autosave_armed               = false;
+
+void config_autosave_poll(bool core_running)
+{
+   retro_time_t now;
+   const char *path;
+   settings_t *settings = config_get_ptr();
+
+   if (!settings || !settings->bools.config_save_on_exit)
+      return;
+
+   if (!settings->modified)
+   {
+      config_autosave_armed = false;
+      return;
+   }
+
+   now = cpu_features_get_time_usec();
+
+   if (!config_autosave_armed)
+   {
+      config_autosave_armed       = true;
+      config_autosave_dirty_since = now;
+      return;
+   }
+
+   if (now - config_autosave_dirty_since < CONFIG_AUTOSAVE_DEBOUNCE_USEC)
+      return;
+
+   /* Never risk a frame hitch while a core is running -
+    * whatever is left over lands in the exit-time save. */
+   if (core_running)
+      return;
+
+   /* With overrides active the exit path saves to the
+    * override files instead; leave that logic alone. */
+   if (rarch_ctl(RARCH_CTL_IS_OVERRIDES_ACTIVE, NULL))
+   {
+      config_autosave_armed = false;
+      return;
+   }
+
+   path = path_get(RARCH_PATH_CONFIG);
+   if (string_is_empty(path))
+      return;
+
+   if (config_save_file(path))
+      RARCH_LOG("[config] Autosaved configuration to \"%s\".\n", path);
+
+   /* Clear the flag even on failure (e.g. read-only
+    * filesystem) so the attempt is not repeated every
+    * debounce window; the exit-time save will report
+    * the error. */
+   settings->modified    = false;
+   config_autosave_armed = false;
+}
+
 /* Replaces currently loaded configuration file with
  * another one. Will load a dummy core to flush state
  * properly. */
@@ -4596,6 +4876,7 @@ bool input_remapping_save_file(const char *path)
 
    ret = config_file_write(conf, remap_file, true);
    config_file_free(conf);
+   config_cache_flush();
 
    return ret;
 }
@@ -181,6 +181,7 @@ typedef struct settings
       unsigned video_swap_interval;
       unsigned video_hard_sync_frames;
       unsigned video_frame_delay;
+      unsigned video_frame_delay_headroom;
       unsigned video_viwidth;
       unsigned video_aspect_ratio_idx;
       unsigned video_rotation;
@@ -256,6 +257,10 @@ typedef struct settings
       unsigned midi_volume;
       unsigned streaming_mode;
 
+#ifdef HAVE_CDROM
+      unsigned cdrom_cache_size;
+#endif
+
       unsigned window_position_x;
       unsigned window_position_y;
       unsigned window_position_width;
@@ -447,6 +452,7 @@ typedef struct settings
       bool video_adaptive_vsync;
       bool video_hard_sync;
       bool video_black_frame_insertion;
+      bool video_frame_duplication;
       bool video_vfilter;
       bool video_smooth;
       bool video_ctx_scaling;
@@ -462,6 +468,8 @@ typedef struct settings
       bool video_disable_composition;
       bool video_post_filter_record;
       bool video_gpu_record;
+      bool video_frame_export;
+      bool video_frame_dupe_elision;
       bool video_gpu_screenshot;
       bool video_allow_rotate;
       bool video_shared_context;
@@ -708,6 +716,7 @@ typedef struct settings
       bool threaded_data_runloop_enable;
       bool set_supports_no_game_enable;
       bool auto_screenshot_filename;
+      bool auto_capture_thumbnails;
       bool history_list_enable;
       bool playlist_entry_rename;
       bool rewind_enable;
@@ -716,6 +725,7 @@ typedef struct settings
       bool apply_cheats_after_load;
       bool run_ahead_enabled;
       bool run_ahead_secondary_instance;
+      bool run_ahead_pipelined;
       bool run_ahead_hide_warnings;
       bool pause_nonactive;
       bool block_sram_overwrite;
@@ -724,6 +734,7 @@ typedef struct settings
       bool savestate_auto_load;
       bool savestate_thumbnail_enable;
       bool save_file_compression;
+      bool save_file_journaling;
       bool savestate_file_compression;
       bool network_cmd_enable;
       bool stdin_cmd_enable;
@@ -939,6 +950,19 @@ bool config_save_autoconf_profile(const char *device_name, unsigned user);
  **/
 bool config_save_file(const char *path);
 
+/**
+ * config_autosave_poll:
+ * @core_running     : true while a core is actively
+ *                     producing frames.
+ *
+ * Debounced autosave - call once per frame. When settings
+ * have been modified and stayed quiet for the debounce
+ * window, writes the current configuration so shutdown
+ * has little or nothing left to do. Only active when
+ * config_save_on_exit is enabled.
+ **/
+void config_autosave_poll(bool core_running);
+
 /**
  * config_save_overrides:
  * @path            : Path that shall be written to.
@@ -54,6 +54,9 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave);
 /* Waits for any in-progress save state tasks to finish */
 void content_wait_for_save_state_task(void);
 
+/* Waits for any in-progress save RAM flush tasks to finish */
+void content_wait_for_save_ram_task(void);
+
 /* Copy a save state. */
 bool content_rename_state(const char *origin, const char *dest);
 
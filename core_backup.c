@@ -175,6 +175,49 @@ bool core_backup_get_backup_path(
    return true;
 }
 
+/* Generates path of the shared chunk store directory
+ * associated with the specified core backup file,
+ * creating the directory if requested.
+ * Returns false if 'backup_path' is invalid, or a
+ * filesystem error occurs */
+bool core_backup_get_chunk_dir(
+      const char *backup_path, bool create,
+      char *chunk_dir, size_t len)
+{
+   char backup_dir[PATH_MAX_LENGTH];
+
+   backup_dir[0] = '\0';
+
+   if (string_is_empty(backup_path) || (len < 1))
+      return false;
+
+   /* Chunk store is shared between all backups
+    * of a core - it lives alongside the backup
+    * files themselves */
+   fill_pathname_parent_dir(backup_dir, backup_path, sizeof(backup_dir));
+
+   if (string_is_empty(backup_dir))
+      return false;
+
+   fill_pathname_join(chunk_dir, backup_dir,
+         "chunks", len);
+
+   if (string_is_empty(chunk_dir))
+      return false;
+
+   /* > Create directory, if required */
+   if (create && !path_is_directory(chunk_dir))
+   {
+      if (!path_mkdir(chunk_dir))
+      {
+         RARCH_ERR("[core backup] Failed to create chunk store directory: %s.\n", chunk_dir);
+         return false;
+      }
+   }
+
+   return true;
+}
+
 /* Returns detected type of specified core backup file */
 enum core_backup_type core_backup_get_backup_type(const char *backup_path)
 {
@@ -91,6 +91,15 @@ bool core_backup_get_backup_path(
       const char *core_path, uint32_t crc, enum core_backup_mode backup_mode,
       const char *dir_core_assets, char *backup_path, size_t len);
 
+/* Generates path of the shared chunk store directory
+ * associated with the specified core backup file,
+ * creating the directory if requested.
+ * Returns false if 'backup_path' is invalid, or a
+ * filesystem error occurs */
+bool core_backup_get_chunk_dir(
+      const char *backup_path, bool create,
+      char *chunk_dir, size_t len);
+
 /* Returns detected type of specified core backup file */
 enum core_backup_type core_backup_get_backup_type(const char *backup_path);
 
@@ -22,6 +22,14 @@
 #include <streams/file_stream.h>
 #include <lists/dir_list.h>
 #include <file/archive_file.h>
+#include <queues/task_queue.h>
+#include <features/features_cpu.h>
+
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <memmap.h>
+#endif
 
 #ifdef HAVE_CONFIG_H
 #include "config.h"
@@ -195,17 +203,12 @@ static void core_info_list_free(core_info_list_t *core_info_list)
    free(core_info_list);
 }
 
-static config_file_t *core_info_list_iterate(
+static void core_info_get_info_path(char *s, size_t len,
       const char *current_path,
       const char *path_basedir)
 {
-   char info_path[PATH_MAX_LENGTH];
    char info_path_base[PATH_MAX_LENGTH];
 
-   if (!current_path)
-      return NULL;
-
-   info_path     [0]          = '\0';
    info_path_base[0]          = '\0';
 
    fill_pathname_base_noext(info_path_base,
@@ -222,15 +225,555 @@ static config_file_t *core_info_list_iterate(
 
    strlcat(info_path_base, ".info", sizeof(info_path_base));
 
-   fill_pathname_join(info_path,
+   fill_pathname_join(s,
          path_basedir,
-         info_path_base, sizeof(info_path_base));
+         info_path_base, len);
+}
+
+static config_file_t *core_info_list_iterate(
+      const char *current_path,
+      const char *path_basedir)
+{
+   char info_path[PATH_MAX_LENGTH];
+
+   if (!current_path)
+      return NULL;
+
+   info_path[0]               = '\0';
+
+   core_info_get_info_path(info_path, sizeof(info_path),
+         current_path, path_basedir);
 
    if (path_is_valid(info_path))
       return config_file_new_from_path_to_string(info_path);
    return NULL;
 }
 
+/* Packed core info cache
+ * > Scanning the core directory re-opens and
+ *   re-parses every .info file through the config
+ *   file parser; with a large core collection this
+ *   dominates startup time on slow storage
+ * > The fully resolved list is therefore serialised
+ *   once into a single 'core_info.cache' file in
+ *   the info directory, which subsequent scans can
+ *   map into memory and deserialise without
+ *   touching the individual .info files
+ * > The cache is discarded whenever the core or
+ *   info directory mtime changes, an individual
+ *   .info file mtime changes, or the scan
+ *   parameters (extension filter, hidden files)
+ *   differ from those recorded at write time */
+
+#define CORE_INFO_CACHE_MAGIC   0x43494352 /* 'RCIC' */
+#define CORE_INFO_CACHE_VERSION 1
+
+typedef struct
+{
+   const uint8_t *data;
+   size_t size;
+   size_t ptr;
+   bool error;
+} core_info_cache_reader_t;
+
+static void core_info_cache_write_u32(RFILE *file, uint32_t val)
+{
+   uint8_t buf[4];
+
+   buf[0] = (uint8_t)(val         & 0xFF);
+   buf[1] = (uint8_t)((val >> 8)  & 0xFF);
+   buf[2] = (uint8_t)((val >> 16) & 0xFF);
+   buf[3] = (uint8_t)((val >> 24) & 0xFF);
+
+   filestream_write(file, buf, sizeof(buf));
+}
+
+static void core_info_cache_write_i64(RFILE *file, int64_t val)
+{
+   core_info_cache_write_u32(file, (uint32_t)((uint64_t)val         & 0xFFFFFFFF));
+   core_info_cache_write_u32(file, (uint32_t)(((uint64_t)val >> 32) & 0xFFFFFFFF));
+}
+
+/* NULL strings are encoded as length zero;
+ * non-NULL strings include the terminator */
+static void core_info_cache_write_string(RFILE *file, const char *s)
+{
+   uint32_t len = s ? (uint32_t)(strlen(s) + 1) : 0;
+
+   core_info_cache_write_u32(file, len);
+   if (len > 0)
+      filestream_write(file, s, len);
+}
+
+static uint32_t core_info_cache_read_u32(core_info_cache_reader_t *r)
+{
+   uint32_t val;
+
+   if (r->error || ((r->size - r->ptr) < 4))
+   {
+      r->error = true;
+      return 0;
+   }
+
+   val = ((uint32_t)r->data[r->ptr])            |
+         ((uint32_t)r->data[r->ptr + 1] << 8)   |
+         ((uint32_t)r->data[r->ptr + 2] << 16)  |
+         ((uint32_t)r->data[r->ptr + 3] << 24);
+   r->ptr += 4;
+
+   return val;
+}
+
+static int64_t core_info_cache_read_i64(core_info_cache_reader_t *r)
+{
+   uint64_t lo = core_info_cache_read_u32(r);
+   uint64_t hi = core_info_cache_read_u32(r);
+   return (int64_t)(lo | (hi << 32));
+}
+
+static char *core_info_cache_read_string(core_info_cache_reader_t *r)
+{
+   char *s;
+   uint32_t len = core_info_cache_read_u32(r);
+
+   if (r->error || (len == 0))
+      return NULL;
+
+   if (((r->size - r->ptr) < len) ||
+       (r->data[r->ptr + len - 1] != '\0'))
+   {
+      r->error = true;
+      return NULL;
+   }
+
+   s = (char*)malloc(len);
+   if (!s)
+   {
+      r->error = true;
+      return NULL;
+   }
+
+   memcpy(s, &r->data[r->ptr], len);
+   r->ptr += len;
+
+   return s;
+}
+
+static bool core_info_cache_get_mtime(const char *path, int64_t *mtime)
+{
+   /* path_get_mtime() rather than raw stat(), which
+    * mishandles UTF-8 paths on Windows */
+   int64_t t;
+
+   if (string_is_empty(path))
+      return false;
+
+   t = path_get_mtime(path);
+   if (t < 0)
+      return false;
+
+   *mtime = t;
+   return true;
+}
+
+static void core_info_cache_get_path(char *s, size_t len,
+      const char *path_basedir)
+{
+   fill_pathname_join(s, path_basedir,
+         FILE_PATH_CORE_INFO_CACHE, len);
+}
+
+/* Fills in the fields derived purely from the
+ * core file path (shared between the parse and
+ * cache load paths) */
+static void core_info_resolve_path_data(core_info_t *info,
+      const char *base_path)
+{
+   const char *core_filename = NULL;
+
+   if (string_is_empty(base_path))
+      return;
+
+   core_filename = path_basename(base_path);
+
+   /* Cache core path */
+   if (!info->path)
+      info->path = strdup(base_path);
+
+   /* Cache core file 'id'
+    * > Filename without extension or platform-specific suffix */
+   if (!string_is_empty(core_filename))
+   {
+      char *core_file_id = strdup(core_filename);
+      path_remove_extension(core_file_id);
+
+      if (!string_is_empty(core_file_id))
+      {
+#if defined(RARCH_MOBILE) || (defined(RARCH_CONSOLE) && !defined(PSP) && !defined(_3DS) && !defined(VITA) && !defined(HW_WUP))
+         char *last_underscore = strrchr(core_file_id, '_');
+         if (last_underscore)
+            *last_underscore = '\0';
+#endif
+         info->core_file_id.str = core_file_id;
+         info->core_file_id.len = strlen(core_file_id);
+
+         core_file_id = NULL;
+      }
+
+      if (core_file_id)
+      {
+         free(core_file_id);
+         core_file_id = NULL;
+      }
+
+      /* Get fallback display name, if required */
+      if (!info->display_name)
+         info->display_name = strdup(core_filename);
+   }
+}
+
+static void core_info_cache_write(core_info_list_t *core_info_list,
+      const char *path, const char *path_basedir,
+      const char *exts, bool dir_show_hidden_files)
+{
+   size_t i, j;
+   char cache_path[PATH_MAX_LENGTH];
+   int64_t core_dir_mtime = 0;
+   int64_t info_dir_mtime = 0;
+   RFILE *file            = NULL;
+
+   cache_path[0] = '\0';
+
+   /* If either directory cannot be stat'd, the
+    * cache can never be validated - skip it */
+   if (!core_info_cache_get_mtime(path, &core_dir_mtime) ||
+       !core_info_cache_get_mtime(path_basedir, &info_dir_mtime))
+      return;
+
+   core_info_cache_get_path(cache_path, sizeof(cache_path),
+         path_basedir);
+
+   file = filestream_open(cache_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   /* Info directory may be read-only on some
+    * platforms - not an error */
+   if (!file)
+      return;
+
+   core_info_cache_write_u32(file, CORE_INFO_CACHE_MAGIC);
+   core_info_cache_write_u32(file, CORE_INFO_CACHE_VERSION);
+   core_info_cache_write_i64(file, core_dir_mtime);
+   core_info_cache_write_i64(file, info_dir_mtime);
+   core_info_cache_write_string(file, exts);
+   core_info_cache_write_u32(file, dir_show_hidden_files ? 1 : 0);
+   core_info_cache_write_u32(file, (uint32_t)core_info_list->count);
+
+   for (i = 0; i < core_info_list->count; i++)
+   {
+      const core_info_t *info = &core_info_list->list[i];
+      uint32_t flags          = 0;
+
+      core_info_cache_write_string(file, info->path);
+      core_info_cache_write_u32(file, info->has_info ? 1 : 0);
+
+      if (info->has_info)
+      {
+         char info_path[PATH_MAX_LENGTH];
+         int64_t info_mtime = 0;
+
+         info_path[0] = '\0';
+         core_info_get_info_path(info_path, sizeof(info_path),
+               info->path, path_basedir);
+         core_info_cache_get_mtime(info_path, &info_mtime);
+
+         core_info_cache_write_i64(file, info_mtime);
+      }
+
+      core_info_cache_write_string(file, info->display_name);
+      core_info_cache_write_string(file, info->display_version);
+      core_info_cache_write_string(file, info->core_name);
+      core_info_cache_write_string(file, info->systemname);
+      core_info_cache_write_string(file, info->system_id);
+      core_info_cache_write_string(file, info->system_manufacturer);
+      core_info_cache_write_string(file, info->supported_extensions);
+      core_info_cache_write_string(file, info->authors);
+      core_info_cache_write_string(file, info->permissions);
+      core_info_cache_write_string(file, info->licenses);
+      core_info_cache_write_string(file, info->categories);
+      core_info_cache_write_string(file, info->databases);
+      core_info_cache_write_string(file, info->notes);
+      core_info_cache_write_string(file, info->required_hw_api);
+      core_info_cache_write_string(file, info->description);
+
+      if (info->supports_no_game)
+         flags |= (1 << 0);
+      if (info->database_match_archive_member)
+         flags |= (1 << 1);
+      if (info->is_experimental)
+         flags |= (1 << 2);
+      core_info_cache_write_u32(file, flags);
+
+      core_info_cache_write_u32(file, (uint32_t)info->firmware_count);
+      for (j = 0; j < info->firmware_count; j++)
+      {
+         core_info_cache_write_string(file, info->firmware[j].path);
+         core_info_cache_write_string(file, info->firmware[j].desc);
+         core_info_cache_write_u32(file, info->firmware[j].optional ? 1 : 0);
+      }
+   }
+
+   filestream_close(file);
+}
+
+/* Maps the packed cache file into memory, or falls
+ * back to a regular read where mmap is unavailable
+ * (and on Windows, where filestream handles UTF-8
+ * paths and a raw open() does not).
+ * Returns NULL if the cache is missing, stale or
+ * malformed - the caller then performs a full
+ * directory scan and regenerates it */
+static core_info_list_t *core_info_cache_read(
+      const char *path, const char *path_basedir,
+      const char *exts, bool dir_show_hidden_files)
+{
+   size_t i, j;
+   char cache_path[PATH_MAX_LENGTH];
+   core_info_cache_reader_t r;
+   uint32_t count;
+   char *cached_exts                = NULL;
+   core_info_t *core_info           = NULL;
+   core_info_list_t *core_info_list = NULL;
+   int64_t core_dir_mtime           = 0;
+   int64_t info_dir_mtime           = 0;
+   void *blob                       = NULL;
+   int64_t blob_len                 = 0;
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+   void *map                        = NULL;
+   uint64_t map_size                = 0;
+#endif
+
+   cache_path[0] = '\0';
+
+   if (!core_info_cache_get_mtime(path, &core_dir_mtime) ||
+       !core_info_cache_get_mtime(path_basedir, &info_dir_mtime))
+      return NULL;
+
+   core_info_cache_get_path(cache_path, sizeof(cache_path),
+         path_basedir);
+
+   if (!path_is_valid(cache_path))
+      return NULL;
+
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+   {
+      int32_t cache_size = path_get_size(cache_path);
+      int fd;
+
+      if (cache_size <= 0)
+         return NULL;
+
+      fd = open(cache_path, O_RDONLY);
+
+      if (fd < 0)
+         return NULL;
+
+      map_size = (uint64_t)cache_size;
+      map      = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+
+      if (map == MAP_FAILED)
+         return NULL;
+
+      blob     = map;
+      blob_len = (int64_t)map_size;
+   }
+#else
+   if (!filestream_read_file(cache_path, &blob, &blob_len) ||
+       !blob || (blob_len <= 0))
+   {
+      if (blob)
+         free(blob);
+      return NULL;
+   }
+#endif
+
+   r.data  = (const uint8_t*)blob;
+   r.size  = (size_t)blob_len;
+   r.ptr   = 0;
+   r.error = false;
+
+   /* Validate header against the current state of
+    * the core/info directories and scan parameters */
+   if ((core_info_cache_read_u32(&r) != CORE_INFO_CACHE_MAGIC)   ||
+       (core_info_cache_read_u32(&r) != CORE_INFO_CACHE_VERSION) ||
+       (core_info_cache_read_i64(&r) != core_dir_mtime)          ||
+       (core_info_cache_read_i64(&r) != info_dir_mtime))
+      goto error;
+
+   cached_exts = core_info_cache_read_string(&r);
+
+   if (r.error ||
+       !string_is_equal(cached_exts ? cached_exts : "",
+            exts ? exts : "") ||
+       (core_info_cache_read_u32(&r) != (dir_show_hidden_files ? 1 : 0)))
+      goto error;
+
+   count = core_info_cache_read_u32(&r);
+
+   if (r.error)
+      goto error;
+
+   core_info_list = (core_info_list_t*)malloc(sizeof(*core_info_list));
+   if (!core_info_list)
+      goto error;
+
+   core_info_list->list    = NULL;
+   core_info_list->count   = 0;
+   core_info_list->all_ext = NULL;
+
+   core_info = (core_info_t*)calloc(count, sizeof(*core_info));
+
+   if (!core_info)
+      goto error;
+
+   core_info_list->list  = core_info;
+   core_info_list->count = count;
+
+   for (i = 0; i < count; i++)
+   {
+      uint32_t flags;
+      uint32_t firmware_count;
+      core_info_t *info = &core_info[i];
+
+      info->path     = core_info_cache_read_string(&r);
+      info->has_info = (core_info_cache_read_u32(&r) == 1);
+
+      if (info->has_info)
+      {
+         char info_path[PATH_MAX_LENGTH];
+         int64_t info_mtime        = 0;
+         int64_t cached_info_mtime = core_info_cache_read_i64(&r);
+
+         info_path[0] = '\0';
+
+         if (r.error || string_is_empty(info->path))
+            goto error;
+
+         /* In-place edits of an .info file do not
+          * bump the directory mtime - verify each
+          * cached file individually (a stat per
+          * core, versus an open and full parse) */
+         core_info_get_info_path(info_path, sizeof(info_path),
+               info->path, path_basedir);
+
+         if (!core_info_cache_get_mtime(info_path, &info_mtime) ||
+             (info_mtime != cached_info_mtime))
+            goto error;
+      }
+
+      info->display_name         = core_info_cache_read_string(&r);
+      info->display_version      = core_info_cache_read_string(&r);
+      info->core_name            = core_info_cache_read_string(&r);
+      info->systemname           = core_info_cache_read_string(&r);
+      info->system_id            = core_info_cache_read_string(&r);
+      info->system_manufacturer  = core_info_cache_read_string(&r);
+      info->supported_extensions = core_info_cache_read_string(&r);
+      info->authors              = core_info_cache_read_string(&r);
+      info->permissions          = core_info_cache_read_string(&r);
+      info->licenses             = core_info_cache_read_string(&r);
+      info->categories           = core_info_cache_read_string(&r);
+      info->databases            = core_info_cache_read_string(&r);
+      info->notes                = core_info_cache_read_string(&r);
+      info->required_hw_api      = core_info_cache_read_string(&r);
+      info->description          = core_info_cache_read_string(&r);
+
+      flags                      = core_info_cache_read_u32(&r);
+      info->supports_no_game                = (flags & (1 << 0)) != 0;
+      info->database_match_archive_member   = (flags & (1 << 1)) != 0;
+      info->is_experimental                 = (flags & (1 << 2)) != 0;
+
+      firmware_count             = core_info_cache_read_u32(&r);
+
+      if (r.error)
+         goto error;
+
+      if (firmware_count > 0)
+      {
+         info->firmware = (core_info_firmware_t*)
+            calloc(firmware_count, sizeof(*info->firmware));
+
+         if (!info->firmware)
+            goto error;
+
+         info->firmware_count = firmware_count;
+
+         for (j = 0; j < firmware_count; j++)
+         {
+            info->firmware[j].path     = core_info_cache_read_string(&r);
+            info->firmware[j].desc     = core_info_cache_read_string(&r);
+            info->firmware[j].optional =
+               (core_info_cache_read_u32(&r) == 1);
+         }
+      }
+
+      if (r.error)
+         goto error;
+
+      /* Derived fields */
+      if (info->supported_extensions)
+         info->supported_extensions_list =
+            string_split(info->supported_extensions, "|");
+      if (info->authors)
+         info->authors_list      = string_split(info->authors, "|");
+      if (info->permissions)
+         info->permissions_list  = string_split(info->permissions, "|");
+      if (info->licenses)
+         info->licenses_list     = string_split(info->licenses, "|");
+      if (info->categories)
+         info->categories_list   = string_split(info->categories, "|");
+      if (info->databases)
+         info->databases_list    = string_split(info->databases, "|");
+      if (info->notes)
+         info->note_list         = string_split(info->notes, "|");
+      if (info->required_hw_api)
+         info->required_hw_api_list =
+            string_split(info->required_hw_api, "|");
+
+      core_info_resolve_path_data(info, info->path);
+
+      /* Lock status is mutable - always fetched
+       * live from the filesystem */
+      info->is_locked = core_info_get_core_lock(info->path, false);
+   }
+
+   core_info_list_resolve_all_extensions(core_info_list);
+
+   if (cached_exts)
+      free(cached_exts);
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+   munmap(map, map_size);
+#else
+   free(blob);
+#endif
+
+   return core_info_list;
+
+error:
+   if (cached_exts)
+      free(cached_exts);
+   if (core_info_list)
+      core_info_list_free(core_info_list);
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+   munmap(map, map_size);
+#else
+   free(blob);
+#endif
+
+   return NULL;
+}
+
 static core_info_list_t *core_info_list_new(const char *path,
       const char *libretro_info_dir,
       const char *exts,
@@ -243,6 +786,13 @@ static core_info_list_t *core_info_list_new(const char *path,
    const char       *path_basedir   = libretro_info_dir;
    bool                          ok = false;
 
+   /* Try deserialising the packed cache before
+    * falling back to a full directory scan */
+   if ((core_info_list = core_info_cache_read(path, path_basedir,
+               exts, dir_show_hidden_files)))
+      return core_info_list;
+   core_info_list                   = NULL;
+
    string_list_initialize(&contents);
 
    if (dir_list_append(&contents, path, exts,
@@ -423,46 +973,10 @@ static core_info_list_t *core_info_list_new(const char *path,
             core_info[i].is_experimental = tmp_bool;
 
          core_info[i].config_data = conf;
+         core_info[i].has_info    = true;
       }
 
-      if (!string_is_empty(base_path))
-      {
-         const char *core_filename = path_basename(base_path);
-
-         /* Cache core path */
-         core_info[i].path = strdup(base_path);
-
-         /* Cache core file 'id'
-          * > Filename without extension or platform-specific suffix */
-         if (!string_is_empty(core_filename))
-         {
-            char *core_file_id = strdup(core_filename);
-            path_remove_extension(core_file_id);
-
-            if (!string_is_empty(core_file_id))
-            {
-#if defined(RARCH_MOBILE) || (defined(RARCH_CONSOLE) && !defined(PSP) && !defined(_3DS) && !defined(VITA) && !defined(HW_WUP))
-               char *last_underscore = strrchr(core_file_id, '_');
-               if (last_underscore)
-                  *last_underscore = '\0';
-#endif
-               core_info[i].core_file_id.str = core_file_id;
-               core_info[i].core_file_id.len = strlen(core_file_id);
-
-               core_file_id = NULL;
-            }
-
-            if (core_file_id)
-            {
-               free(core_file_id);
-               core_file_id = NULL;
-            }
-
-            /* Get fallback display name, if required */
-            if (!core_info[i].display_name)
-               core_info[i].display_name = strdup(core_filename);
-         }
-      }
+      core_info_resolve_path_data(&core_info[i], base_path);
 
       /* Get core lock status */
       core_info[i].is_locked = core_info_get_core_lock(core_info[i].path, false);
@@ -471,6 +985,11 @@ static core_info_list_t *core_info_list_new(const char *path,
    core_info_list_resolve_all_extensions(core_info_list);
    core_info_list_resolve_all_firmware(core_info_list);
 
+   /* Serialise the resolved list, so the next scan
+    * can skip the per-file parsing above entirely */
+   core_info_cache_write(core_info_list, path, path_basedir,
+         exts, dir_show_hidden_files);
+
    string_list_deinitialize(&contents);
    return core_info_list;
 
@@ -594,6 +1113,264 @@ static core_info_t *core_info_find_internal(
    return NULL;
 }
 
+/* Firmware presence cache.
+ *
+ * Every entry in a core's firmware list is stat'd each time
+ * missing-firmware status is requested, and the menu requests
+ * it whenever a core information screen is opened. On network
+ * mounts each stat can take tens of milliseconds, so the
+ * results are remembered here and reused. There is no file
+ * watch service in this tree, so instead of invalidating on
+ * directory changes the cache simply expires after a short
+ * TTL, and is flushed outright whenever the system directory
+ * changes or the core info list is rebuilt.
+ *
+ * The cache is only ever read or written on the main thread;
+ * the prefetch task below stats into private storage and
+ * publishes from its main-thread callback.
+ *
+ * TODO/FIXME - static globals */
+#define CORE_INFO_FW_CACHE_TTL_US (10 * 1000000)
+
+struct core_info_fw_stat
+{
+   char *path;
+   bool missing;
+};
+
+static struct core_info_fw_stat *core_info_fw_cache = NULL;
+static size_t core_info_fw_cache_size               = 0;
+static size_t core_info_fw_cache_cap                = 0;
+static char *core_info_fw_cache_dir                 = NULL;
+static retro_time_t core_info_fw_cache_time         = 0;
+
+static void core_info_fw_cache_flush(void)
+{
+   size_t i;
+
+   for (i = 0; i < core_info_fw_cache_size; i++)
+      free(core_info_fw_cache[i].path);
+
+   if (core_info_fw_cache)
+      free(core_info_fw_cache);
+   if (core_info_fw_cache_dir)
+      free(core_info_fw_cache_dir);
+
+   core_info_fw_cache      = NULL;
+   core_info_fw_cache_size = 0;
+   core_info_fw_cache_cap  = 0;
+   core_info_fw_cache_dir  = NULL;
+   core_info_fw_cache_time = 0;
+}
+
+/* Drops stale results and (re)binds the cache to @systemdir.
+ * Must be called before any lookup or insertion. */
+static void core_info_fw_cache_validate(const char *systemdir)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   if (     core_info_fw_cache_dir
+         && string_is_equal(core_info_fw_cache_dir, systemdir)
+         && (now - core_info_fw_cache_time) < CORE_INFO_FW_CACHE_TTL_US)
+      return;
+
+   core_info_fw_cache_flush();
+
+   core_info_fw_cache_dir  = strdup(systemdir);
+   core_info_fw_cache_time = now;
+}
+
+static bool core_info_fw_cache_find(const char *path, bool *missing)
+{
+   /* Linear scan - firmware lists across all installed
+    * cores total at most a few hundred entries */
+   size_t i;
+
+   for (i = 0; i < core_info_fw_cache_size; i++)
+   {
+      if (string_is_equal(core_info_fw_cache[i].path, path))
+      {
+         *missing = core_info_fw_cache[i].missing;
+         return true;
+      }
+   }
+
+   return false;
+}
+
+static void core_info_fw_cache_add(const char *path, bool missing)
+{
+   if (core_info_fw_cache_size >= core_info_fw_cache_cap)
+   {
+      size_t new_cap                  = core_info_fw_cache_cap
+            ? (core_info_fw_cache_cap * 2) : 32;
+      struct core_info_fw_stat *cache = (struct core_info_fw_stat*)
+            realloc(core_info_fw_cache, new_cap * sizeof(*cache));
+
+      if (!cache)
+         return;
+
+      core_info_fw_cache     = cache;
+      core_info_fw_cache_cap = new_cap;
+   }
+
+   core_info_fw_cache[core_info_fw_cache_size].path = strdup(path);
+
+   if (!core_info_fw_cache[core_info_fw_cache_size].path)
+      return;
+
+   core_info_fw_cache[core_info_fw_cache_size].missing = missing;
+   core_info_fw_cache_size++;
+}
+
+/* Background firmware stat batch. The full set of joined
+ * firmware paths is snapshotted at push time, the worker
+ * stats them into the string list's attribute field, and the
+ * main-thread callback publishes the results into the cache
+ * above so the first menu visit finds everything warm. */
+typedef struct
+{
+   struct string_list *paths;
+   char *systemdir;
+   size_t idx;
+} core_info_fw_prefetch_t;
+
+#define CORE_INFO_FW_PREFETCH_BATCH 16
+
+static void task_core_info_fw_prefetch_handler(retro_task_t *task)
+{
+   core_info_fw_prefetch_t *state = (core_info_fw_prefetch_t*)task->state;
+   size_t end                     = state->idx + CORE_INFO_FW_PREFETCH_BATCH;
+
+   if (end > state->paths->size)
+      end = state->paths->size;
+
+   for (; state->idx < end; state->idx++)
+      state->paths->elems[state->idx].attr.i =
+            !path_is_valid(state->paths->elems[state->idx].data);
+
+   if (state->idx >= state->paths->size)
+      task_set_finished(task, true);
+}
+
+static void task_core_info_fw_prefetch_callback(retro_task_t *task,
+      void *task_data, void *user_data, const char *error)
+{
+   core_info_fw_prefetch_t *state = (core_info_fw_prefetch_t*)task->state;
+   size_t i;
+
+   if (!state)
+      return;
+
+   core_info_fw_cache_validate(state->systemdir);
+
+   for (i = 0; i < state->paths->size; i++)
+   {
+      bool missing = false;
+
+      if (!core_info_fw_cache_find(state->paths->elems[i].data, &missing))
+         core_info_fw_cache_add(state->paths->elems[i].data,
+               state->paths->elems[i].attr.i != 0);
+   }
+
+   string_list_free(state->paths);
+   free(state->systemdir);
+   free(state);
+}
+
+static bool task_core_info_fw_prefetch_finder(retro_task_t *task,
+      void *user_data)
+{
+   if (!task)
+      return false;
+   return task->handler == task_core_info_fw_prefetch_handler;
+}
+
+void core_info_update_missing_firmware_prefetch(const char *systemdir)
+{
+   size_t i;
+   unsigned j;
+   task_finder_data_t find_data;
+   union string_list_elem_attr attr;
+   char path[PATH_MAX_LENGTH];
+   core_info_fw_prefetch_t *state = NULL;
+   retro_task_t *task             = NULL;
+   struct string_list *paths      = NULL;
+   core_info_state_t *p_coreinfo  = coreinfo_get_ptr();
+   core_info_list_t *list         = p_coreinfo->curr_list;
+
+   if (!list || (list->count == 0) || string_is_empty(systemdir))
+      return;
+
+   /* An identical batch may still be in flight */
+   find_data.func     = task_core_info_fw_prefetch_finder;
+   find_data.userdata = NULL;
+
+   if (task_queue_find(&find_data))
+      return;
+
+   if (!(paths = string_list_new()))
+      return;
+
+   attr.i  = 0;
+   path[0] = '\0';
+
+   for (i = 0; i < list->count; i++)
+   {
+      core_info_t *info = &list->list[i];
+
+      for (j = 0; j < info->firmware_count; j++)
+      {
+         if (string_is_empty(info->firmware[j].path))
+            continue;
+
+         fill_pathname_join(path, systemdir,
+               info->firmware[j].path, sizeof(path));
+
+         /* Cores share firmware (e.g. console BIOSes) -
+          * stat each path only once */
+         if (string_list_find_elem(paths, path))
+            continue;
+
+         string_list_append(paths, path, attr);
+      }
+   }
+
+   if (paths->size == 0)
+      goto error;
+
+   if (!(state = (core_info_fw_prefetch_t*)calloc(1, sizeof(*state))))
+      goto error;
+
+   state->paths     = paths;
+   state->systemdir = strdup(systemdir);
+   state->idx       = 0;
+
+   if (!state->systemdir)
+      goto error;
+
+   if (!(task = task_init()))
+      goto error;
+
+   task->handler   = task_core_info_fw_prefetch_handler;
+   task->callback  = task_core_info_fw_prefetch_callback;
+   task->state     = state;
+   task->mute      = true;
+
+   task_queue_push(task);
+
+   return;
+
+error:
+   if (state)
+   {
+      if (state->systemdir)
+         free(state->systemdir);
+      free(state);
+   }
+   string_list_free(paths);
+}
+
 static bool core_info_list_update_missing_firmware_internal(
       core_info_list_t *core_info_list,
       const char *core,
@@ -614,15 +1391,26 @@ static bool core_info_list_update_missing_firmware_internal(
 
    path[0]                = '\0';
 
+   core_info_fw_cache_validate(systemdir ? systemdir : "");
+
    for (i = 0; i < info->firmware_count; i++)
    {
+      bool missing = false;
+
       if (string_is_empty(info->firmware[i].path))
          continue;
 
       fill_pathname_join(path, systemdir,
             info->firmware[i].path, sizeof(path));
-      info->firmware[i].missing = !path_is_valid(path);
-      if (info->firmware[i].missing && !info->firmware[i].optional)
+
+      if (!core_info_fw_cache_find(path, &missing))
+      {
+         missing = !path_is_valid(path);
+         core_info_fw_cache_add(path, missing);
+      }
+
+      info->firmware[i].missing = missing;
+      if (missing && !info->firmware[i].optional)
          *set_missing_bios = true;
    }
 
@@ -697,6 +1485,10 @@ void core_info_deinit_list(void)
    if (p_coreinfo->curr_list)
       core_info_list_free(p_coreinfo->curr_list);
    p_coreinfo->curr_list = NULL;
+
+   /* Firmware lists just went away with the core info list,
+    * so the stat results keyed off them are dropped too */
+   core_info_fw_cache_flush();
 }
 
 bool core_info_init_list(const char *path_info, const char *dir_cores,
@@ -944,11 +1736,7 @@ size_t core_info_list_num_info_files(core_info_list_t *core_info_list)
       return 0;
 
    for (i = 0; i < core_info_list->count; i++)
-   {
-      config_file_t *conf = (config_file_t*)
-         core_info_list->list[i].config_data;
-      num += !!conf;
-   }
+      num += !!core_info_list->list[i].has_info;
 
    return num;
 }
@@ -91,6 +91,7 @@ typedef struct
    core_file_id_t core_file_id; /* ptr alignment */
    void *userdata;
    size_t firmware_count;
+   bool has_info;
    bool supports_no_game;
    bool database_match_archive_member;
    bool is_experimental;
@@ -186,6 +187,11 @@ size_t core_info_count(void);
 bool core_info_list_update_missing_firmware(core_info_ctx_firmware_t *info,
       bool *set_missing_bios);
 
+/* Stats every firmware file listed by the installed cores on a
+ * background task and caches the results, so later synchronous
+ * missing-firmware queries avoid blocking on the filesystem. */
+void core_info_update_missing_firmware_prefetch(const char *systemdir);
+
 bool core_info_find(core_info_ctx_find_t *info);
 
 bool core_info_load(
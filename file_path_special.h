@@ -86,6 +86,7 @@ RETRO_BEGIN_DECLS
 #define FILE_PATH_DATABASE_RDB_ZIP "database-rdb.zip"
 #define FILE_PATH_OVERLAYS_ZIP "overlays.zip"
 #define FILE_PATH_CORE_INFO_ZIP "info.zip"
+#define FILE_PATH_CORE_INFO_CACHE "core_info.cache"
 #define FILE_PATH_CHEATS_ZIP "cheats.zip"
 #define FILE_PATH_ASSETS_ZIP "assets.zip"
 #define FILE_PATH_AUTOCONFIG_ZIP "autoconfig.zip"
@@ -105,6 +106,8 @@ RETRO_BEGIN_DECLS
 #define FILE_PATH_DISK_CONTROL_INDEX_EXTENSION ".ldci"
 #define FILE_PATH_CORE_BACKUP_EXTENSION ".lcbk"
 #define FILE_PATH_CORE_BACKUP_EXTENSION_NO_DOT "lcbk"
+#define FILE_PATH_CORE_BACKUP_CHUNK_EXTENSION ".lcbc"
+#define FILE_PATH_CORE_BACKUP_CHUNK_EXTENSION_NO_DOT "lcbc"
 #define FILE_PATH_LOCK_EXTENSION ".lck"
 #define FILE_PATH_BACKUP_EXTENSION ".bak"
 
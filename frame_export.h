@@ -0,0 +1,72 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RETROARCH_FRAME_EXPORT_H
+#define __RETROARCH_FRAME_EXPORT_H
+
+#include <stdint.h>
+
+#include <retro_common_api.h>
+
+/* Shared-memory frame export for external capture tools.
+ *
+ * When 'video_frame_export' is enabled, every frame the core
+ * produces is published to a named shared-memory region that
+ * capture tools can map read-only. The region starts with
+ * frame_export_header_t, immediately followed by two frame
+ * buffers of buffer_size bytes each (double buffering).
+ *
+ * Writer protocol: the frame is copied into the buffer NOT
+ * referenced by buffer_index, then width/height/pitch/format
+ * are updated, buffer_index is flipped, and frame_count is
+ * incremented last.
+ *
+ * Reader protocol: poll frame_count; when it advances, copy
+ * buffer_size bytes at buffer_index and re-read frame_count
+ * afterwards - if it advanced by two or more during the copy,
+ * the writer lapped the reader and the copy must be retried.
+ *
+ * The region is recreated (under the same name) when a frame
+ * outgrows it, so readers must remap when magic/buffer_size
+ * changes or the mapping goes away.
+ */
+
+RETRO_BEGIN_DECLS
+
+#ifdef _WIN32
+#define FRAME_EXPORT_SHM_NAME "Local\\retroarch-frame"
+#else
+#define FRAME_EXPORT_SHM_NAME "/retroarch-frame"
+#endif
+
+#define FRAME_EXPORT_MAGIC    0x58454652 /* "RFEX" */
+#define FRAME_EXPORT_VERSION  1
+
+typedef struct frame_export_header
+{
+   uint32_t magic;        /* FRAME_EXPORT_MAGIC, written last at setup */
+   uint32_t version;      /* FRAME_EXPORT_VERSION */
+   uint32_t buffer_size;  /* bytes per frame buffer */
+   uint32_t format;       /* enum retro_pixel_format of the frames */
+   uint32_t width;        /* frame width in pixels */
+   uint32_t height;       /* frame height in pixels */
+   uint32_t pitch;        /* bytes per scanline */
+   uint32_t buffer_index; /* buffer holding the newest complete frame */
+   uint32_t frame_count;  /* incremented after each publish */
+} frame_export_header_t;
+
+RETRO_END_DECLS
+
+#endif
@@ -2386,6 +2386,8 @@ static void frontend_unix_watch_path_for_changes(struct string_list *list, int f
       inotify_mask |= IN_MOVE_SELF;
    if (flags & PATH_CHANGE_TYPE_FILE_DELETED)
       inotify_mask |= IN_DELETE_SELF;
+   if (flags & PATH_CHANGE_TYPE_DIR_CONTENTS)
+      inotify_mask |= IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
 
    inotify_data->flags = inotify_mask;
 
@@ -64,7 +64,10 @@ enum path_change_type
    PATH_CHANGE_TYPE_MODIFIED = (1 << 0),
    PATH_CHANGE_TYPE_WRITE_FILE_CLOSED = (1 << 1),
    PATH_CHANGE_TYPE_FILE_MOVED = (1 << 2),
-   PATH_CHANGE_TYPE_FILE_DELETED = (1 << 3)
+   PATH_CHANGE_TYPE_FILE_DELETED = (1 << 3),
+   /* For directory watches - an entry was created, removed
+    * or renamed inside the watched directory */
+   PATH_CHANGE_TYPE_DIR_CONTENTS = (1 << 4)
 };
 
 typedef struct path_change_data
@@ -2547,6 +2547,16 @@ typedef struct
       bool           enabled;
    } sprites;
 
+   /* Last bound sprite pipeline state. Blend states and shader bundles
+    * are created once at init, so comparing pointers is enough to skip
+    * the redundant rebinds the menu issues between sprite draws.
+    * Reset at the top of each frame. */
+   struct
+   {
+      d3d11_shader_t *shader;
+      D3D11BlendState blend;
+   } bound;
+
 #ifdef HAVE_OVERLAY
    struct
    {
@@ -2650,6 +2660,22 @@ static INLINE void d3d11_set_shader(D3D11DeviceContext ctx, d3d11_shader_t* shad
    D3D11SetPShader(ctx, shader->ps, NULL, 0);
    D3D11SetGShader(ctx, shader->gs, NULL, 0);
 }
+
+static INLINE void d3d11_set_blend_cached(d3d11_video_t* d3d11, D3D11BlendState blend)
+{
+   if (blend == d3d11->bound.blend)
+      return;
+   d3d11->bound.blend = blend;
+   D3D11SetBlendState(d3d11->context, blend, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+}
+
+static INLINE void d3d11_set_shader_cached(d3d11_video_t* d3d11, d3d11_shader_t* shader)
+{
+   if (shader == d3d11->bound.shader)
+      return;
+   d3d11->bound.shader = shader;
+   d3d11_set_shader(d3d11->context, shader);
+}
 static INLINE void D3D11SetVertexBuffer(
       D3D11DeviceContext device_context,
       UINT               slot,
@@ -259,13 +259,24 @@ bool d3d12_init_queue(d3d12_video_t* d3d12)
             &d3d12->queue.handle);
    }
 
-   D3D12CreateCommandAllocator(
-         d3d12->device,
-         D3D12_COMMAND_LIST_TYPE_DIRECT,
-         &d3d12->queue.allocator);
+   {
+      unsigned i;
+
+      /* One allocator per in-flight frame; an allocator can
+       * only be reset once the GPU has finished consuming
+       * the commands recorded from it */
+      for (i = 0; i < D3D12_NUM_FRAMES; i++)
+      {
+         D3D12CreateCommandAllocator(
+               d3d12->device,
+               D3D12_COMMAND_LIST_TYPE_DIRECT,
+               &d3d12->queue.allocators[i]);
+         d3d12->queue.fenceValues[i] = 0;
+      }
+   }
 
    D3D12CreateGraphicsCommandList(
-         d3d12->device, 0, D3D12_COMMAND_LIST_TYPE_DIRECT, d3d12->queue.allocator,
+         d3d12->device, 0, D3D12_COMMAND_LIST_TYPE_DIRECT, d3d12->queue.allocators[0],
          d3d12->pipes[VIDEO_SHADER_STOCK_BLEND], &d3d12->queue.cmd);
 
    D3D12CloseGraphicsCommandList(d3d12->queue.cmd);
@@ -846,7 +857,117 @@ void d3d12_update_texture(
 
    D3D12Unmap(texture->upload_buffer, 0, NULL);
 
-   texture->dirty = true;
+   texture->staging        = texture->upload_buffer;
+   texture->staging_offset = texture->layout.Offset;
+   texture->dirty          = true;
+}
+
+bool d3d12_init_upload_ring(
+      D3D12Device device, d3d12_upload_ring_t* ring, size_t slice_size)
+{
+   D3D12_RANGE read_range = { 0, 0 };
+
+   /* Texture copy sources must be 512 byte aligned */
+   slice_size = (slice_size + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) &
+         ~((size_t)D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+
+   ring->gpu = d3d12_create_buffer(
+         device, slice_size * D3D12_NUM_FRAMES, &ring->handle);
+
+   if (!ring->handle)
+      return false;
+
+   /* Upload heaps can stay mapped for their lifetime */
+   D3D12Map(ring->handle, 0, &read_range, (void**)&ring->cpu);
+
+   if (!ring->cpu)
+   {
+      Release(ring->handle);
+      ring->handle = NULL;
+      return false;
+   }
+
+   ring->slice  = slice_size;
+   ring->offset = 0;
+   ring->slot   = 0;
+
+   return true;
+}
+
+void d3d12_free_upload_ring(d3d12_upload_ring_t* ring)
+{
+   if (ring->handle)
+   {
+      D3D12Unmap(ring->handle, 0, NULL);
+      Release(ring->handle);
+   }
+
+   ring->handle = NULL;
+   ring->cpu    = NULL;
+   ring->gpu    = 0;
+   ring->slice  = 0;
+   ring->offset = 0;
+   ring->slot   = 0;
+}
+
+void d3d12_upload_ring_begin_frame(d3d12_upload_ring_t* ring, unsigned slot)
+{
+   /* The caller has already waited for this slot's fence,
+    * so its slice can be recycled wholesale */
+   ring->slot   = slot;
+   ring->offset = 0;
+}
+
+void* d3d12_upload_ring_alloc(
+      d3d12_upload_ring_t* ring, size_t size, size_t align, UINT64* offset)
+{
+   size_t start;
+
+   if (!ring->cpu)
+      return NULL;
+
+   start = (ring->offset + align - 1) & ~(align - 1);
+
+   if (start + size > ring->slice)
+      return NULL;
+
+   ring->offset = start + size;
+   *offset      = (UINT64)ring->slot * ring->slice + start;
+
+   return ring->cpu + *offset;
+}
+
+bool d3d12_update_texture_staged(
+      int                  width,
+      int                  height,
+      int                  pitch,
+      DXGI_FORMAT          format,
+      const void*          data,
+      d3d12_texture_t*     texture,
+      d3d12_upload_ring_t* ring)
+{
+   uint8_t* dst;
+   UINT64   offset;
+   size_t   size;
+
+   if (!texture)
+      return false;
+
+   size = (size_t)texture->layout.Footprint.RowPitch * texture->num_rows;
+
+   if (!ring || !(dst = (uint8_t*)d3d12_upload_ring_alloc(ring, size,
+         D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, &offset)))
+      return false;
+
+   dxgi_copy(
+         width, height, format, pitch, data, texture->desc.Format,
+         texture->layout.Footprint.RowPitch, dst);
+
+   texture->staging        = ring->handle;
+   texture->staging_offset = offset;
+   texture->dirty          = true;
+
+   return true;
 }
 void d3d12_upload_texture(D3D12GraphicsCommandList cmd,
       d3d12_texture_t* texture, void *userdata)
@@ -854,10 +975,19 @@ void d3d12_upload_texture(D3D12GraphicsCommandList cmd,
    D3D12_TEXTURE_COPY_LOCATION src = { 0 };
    D3D12_TEXTURE_COPY_LOCATION dst = { 0 };
 
-   src.pResource       = texture->upload_buffer;
+   src.pResource       = texture->staging
+         ? texture->staging : texture->upload_buffer;
    src.Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
    src.PlacedFootprint = texture->layout;
 
+   if (texture->staging)
+   {
+      src.PlacedFootprint.Offset = texture->staging_offset;
+      /* Ring slices are recycled every D3D12_NUM_FRAMES
+       * frames - never source a stale reference */
+      texture->staging           = NULL;
+   }
+
    dst.pResource        = texture->handle;
    dst.Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
    dst.SubresourceIndex = 0;
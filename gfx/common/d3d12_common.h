@@ -1266,6 +1266,12 @@ D3D12GetGPUDescriptorHandleForHeapStart(D3D12DescriptorHeap descriptor_heap)
 
 #define D3D12_MAX_GPU_COUNT 16
 
+/* Number of frames the CPU may record ahead of the GPU;
+ * also the swap chain buffer count. Every per-frame
+ * resource (command allocator, upload ring slice, fence
+ * value) is replicated this many times. */
+#define D3D12_NUM_FRAMES 3
+
 typedef struct d3d12_vertex_t
 {
    float position[2];
@@ -1317,10 +1323,30 @@ typedef struct
    UINT64                             row_size_in_bytes;
    UINT64                             total_bytes;
    d3d12_descriptor_heap_t*           srv_heap;
+   /* where the next d3d12_upload_texture() sources its
+    * copy from - either the texture's own upload_buffer or
+    * a slice of the per-frame upload ring */
+   D3D12Resource                      staging;
+   UINT64                             staging_offset;
    bool                               dirty;
    float4_t                           size_data;
 } d3d12_texture_t;
 
+/* Ring-buffer suballocator over a single persistently
+ * mapped upload heap. The heap is split into
+ * D3D12_NUM_FRAMES slices; each frame linearly allocates
+ * from its own slice, which is safe to reuse once that
+ * frame's fence has completed. */
+typedef struct
+{
+   D3D12Resource             handle;
+   uint8_t*                  cpu; /* persistently mapped */
+   D3D12_GPU_VIRTUAL_ADDRESS gpu;
+   size_t                    slice;
+   size_t                    offset;
+   unsigned                  slot;
+} d3d12_upload_ring_t;
+
 #ifndef ALIGN
 #ifdef _MSC_VER
 #define ALIGN(x) __declspec(align(x))
@@ -1357,11 +1383,12 @@ typedef struct
    struct
    {
       D3D12CommandQueue        handle;
-      D3D12CommandAllocator    allocator;
+      D3D12CommandAllocator    allocators[D3D12_NUM_FRAMES];
       D3D12GraphicsCommandList cmd;
       D3D12Fence               fence;
       HANDLE                   fenceEvent;
       UINT64                   fenceValue;
+      UINT64                   fenceValues[D3D12_NUM_FRAMES];
    } queue;
 
    struct
@@ -1377,8 +1404,8 @@ typedef struct
    struct
    {
       DXGISwapChain               handle;
-      D3D12Resource               renderTargets[2];
-      D3D12_CPU_DESCRIPTOR_HANDLE desc_handles[2];
+      D3D12Resource               renderTargets[D3D12_NUM_FRAMES];
+      D3D12_CPU_DESCRIPTOR_HANDLE desc_handles[D3D12_NUM_FRAMES];
       D3D12_VIEWPORT              viewport;
       D3D12_RECT                  scissorRect;
       float                       clearcolor[4];
@@ -1405,7 +1432,12 @@ typedef struct
       D3D12_VERTEX_BUFFER_VIEW vbo_view;
       d3d12_texture_t          texture;
 
+      /* reusable bundle for the static menu quad */
+      D3D12CommandAllocator    bundle_allocator;
+      D3D12GraphicsCommandList bundle;
+
       float alpha;
+      bool  bundle_dirty;
       bool  enabled;
       bool  fullscreen;
    } menu;
@@ -1454,6 +1486,7 @@ typedef struct
 
    struct video_shader* shader_preset;
    d3d12_texture_t      luts[GFX_MAX_TEXTURES];
+   d3d12_upload_ring_t  upload_ring;
 
    D3D12PipelineState              pipes[GFX_MAX_SHADERS];
    D3D12PipelineState              mipmapgen_pipe;
@@ -1530,6 +1563,22 @@ void d3d12_update_texture(
 void d3d12_upload_texture(D3D12GraphicsCommandList cmd,
       d3d12_texture_t* texture, void *userdata);
 
+bool d3d12_init_upload_ring(
+      D3D12Device device, d3d12_upload_ring_t* ring, size_t slice_size);
+void d3d12_free_upload_ring(d3d12_upload_ring_t* ring);
+void d3d12_upload_ring_begin_frame(d3d12_upload_ring_t* ring, unsigned slot);
+void* d3d12_upload_ring_alloc(
+      d3d12_upload_ring_t* ring, size_t size, size_t align, UINT64* offset);
+
+bool d3d12_update_texture_staged(
+      int                  width,
+      int                  height,
+      int                  pitch,
+      DXGI_FORMAT          format,
+      const void*          data,
+      d3d12_texture_t*     texture,
+      d3d12_upload_ring_t* ring);
+
 void d3d12_create_fullscreen_quad_vbo(
       D3D12Device device, D3D12_VERTEX_BUFFER_VIEW* view, D3D12Resource* vbo);
 
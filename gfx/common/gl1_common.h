@@ -51,6 +51,15 @@
 #define RARCH_GL1_TEXTURE_TYPE32 GL_BGRA_EXT
 #define RARCH_GL1_FORMAT32 GL_UNSIGNED_BYTE
 
+/* Packed pixels are GL 1.2+, so ancient headers
+ * may not carry these. */
+#ifndef GL_RGB5
+#define GL_RGB5 0x8050
+#endif
+#ifndef GL_UNSIGNED_SHORT_5_6_5
+#define GL_UNSIGNED_SHORT_5_6_5 0x8363
+#endif
+
 struct string_list;
 
 typedef struct gl1
@@ -60,6 +69,7 @@ typedef struct gl1
    bool menu_size_changed;
    bool rgb32;
    bool supports_bgra;
+   bool supports_packed_pixels;
    bool keep_aspect;
    bool should_resize;
    bool menu_texture_enable;
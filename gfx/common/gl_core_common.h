@@ -59,7 +59,11 @@ typedef struct gl_core
    float *overlay_tex_coord;
    float *overlay_color_coord;
    GLsync fences[GL_CORE_NUM_FENCES];
+   GLsync pbo_readback_fences[GL_CORE_NUM_PBOS];
+   GLsync pbo_upload_fences[GL_CORE_NUM_PBOS];
    void *readback_buffer_screenshot;
+   uint8_t *pbo_upload_map;
+   size_t pbo_upload_slice;
    struct scaler_ctx pbo_readback_scaler;
 
    video_info_t video_info;
@@ -70,6 +74,7 @@ typedef struct gl_core
    GLuint vao;
    GLuint menu_texture;
    GLuint pbo_readback[GL_CORE_NUM_PBOS];
+   GLuint pbo_upload;
 
    struct
    {
@@ -102,12 +107,17 @@ typedef struct gl_core
    unsigned scratch_vbo_index;
    unsigned fence_count;
    unsigned pbo_readback_index;
+   unsigned pbo_upload_index;
    unsigned hw_render_max_width;
    unsigned hw_render_max_height;
+   unsigned dup_fbo_width;
+   unsigned dup_fbo_height;
    GLuint scratch_vbos[GL_CORE_NUM_VBOS];
    GLuint hw_render_texture;
    GLuint hw_render_fbo;
    GLuint hw_render_rb_ds;
+   GLuint dup_fbo;
+   GLuint dup_texture;
 
    float menu_texture_alpha;
    math_matrix_4x4 mvp;                /* float alignment */
@@ -117,6 +127,7 @@ typedef struct gl_core
 
    bool pbo_readback_valid[GL_CORE_NUM_PBOS];
    bool pbo_readback_enable;
+   bool pbo_upload_enable;
    bool hw_render_bottom_left;
    bool hw_render_enable;
    bool use_shared_context;
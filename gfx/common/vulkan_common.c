@@ -31,6 +31,8 @@
 #include "vulkan_common.h"
 #include <retro_timers.h>
 #include "../../configuration.h"
+#include "../../performance_counters.h"
+#include "../../retroarch.h"
 #include "../include/vulkan/vulkan.h"
 #include <retro_assert.h>
 #include "vksym.h"
@@ -430,6 +432,146 @@ static unsigned vulkan_num_miplevels(unsigned width, unsigned height)
    return levels;
 }
 
+/* Texture memory recycle cache.
+ *
+ * Menu theme switches and shader preset swaps destroy and recreate
+ * large numbers of textures; letting each one go through a full
+ * vkAllocateMemory/vkFreeMemory cycle slowly fragments the driver's
+ * device heap until allocation fails on small cards. Freed texture
+ * memory is parked here instead and handed to the next texture whose
+ * requirements it satisfies, so churny workloads keep reusing the
+ * same blocks. Bound resources cannot be moved in Vulkan, so the
+ * heap cannot be compacted after the fact - not feeding it an
+ * alloc/free stream is what keeps it from fragmenting. */
+#define VULKAN_MEMORY_CACHE_ENTRIES   32
+/* Byte budget for parked blocks; the oldest blocks beyond it are
+ * returned to the driver. */
+#define VULKAN_MEMORY_CACHE_MAX_BYTES (64u * 1024u * 1024u)
+
+struct vulkan_memory_cache_entry
+{
+   VkDeviceMemory memory;
+   VkDeviceSize size;
+   uint32_t type;
+};
+
+static struct
+{
+   struct vulkan_memory_cache_entry entries[VULKAN_MEMORY_CACHE_ENTRIES];
+   VkDevice device;
+   VkDeviceSize cached_bytes;
+   uint64_t device_allocs;
+   uint64_t cache_hits;
+   unsigned count;
+} vulkan_memory_cache;
+
+static void vulkan_memory_cache_evict_oldest(void)
+{
+   vkFreeMemory(vulkan_memory_cache.device,
+         vulkan_memory_cache.entries[0].memory, NULL);
+   vulkan_memory_cache.cached_bytes -= vulkan_memory_cache.entries[0].size;
+   vulkan_memory_cache.count--;
+   memmove(&vulkan_memory_cache.entries[0],
+         &vulkan_memory_cache.entries[1],
+         vulkan_memory_cache.count
+         * sizeof(vulkan_memory_cache.entries[0]));
+}
+
+static void vulkan_memory_cache_purge(VkDevice device)
+{
+   if (vulkan_memory_cache.device != device)
+      return;
+
+   while (vulkan_memory_cache.count)
+      vulkan_memory_cache_evict_oldest();
+
+   if (vulkan_memory_cache.device_allocs || vulkan_memory_cache.cache_hits)
+      RARCH_LOG("[Vulkan]: Texture memory: %u device allocations, %u served from recycle cache.\n",
+            (unsigned)vulkan_memory_cache.device_allocs,
+            (unsigned)vulkan_memory_cache.cache_hits);
+
+   memset(&vulkan_memory_cache, 0, sizeof(vulkan_memory_cache));
+}
+
+static VkDeviceMemory vulkan_memory_alloc(VkDevice device,
+      const VkMemoryAllocateInfo *alloc,
+      VkDeviceSize *size, uint32_t *type)
+{
+   unsigned i;
+   VkDeviceMemory memory = VK_NULL_HANDLE;
+
+   if (vulkan_memory_cache.device == device)
+   {
+      for (i = 0; i < vulkan_memory_cache.count; i++)
+      {
+         struct vulkan_memory_cache_entry *entry =
+            &vulkan_memory_cache.entries[i];
+
+         /* Blocks more than twice the request are rejected so a
+          * few big parked blocks cannot soak up small requests. */
+         if (     entry->type == alloc->memoryTypeIndex
+               && entry->size >= alloc->allocationSize
+               && entry->size <= alloc->allocationSize * 2)
+         {
+            memory = entry->memory;
+            *size  = entry->size;
+            *type  = entry->type;
+
+            vulkan_memory_cache.cached_bytes -= entry->size;
+            vulkan_memory_cache.count--;
+            memmove(entry, entry + 1,
+                  (vulkan_memory_cache.entries
+                   + vulkan_memory_cache.count - entry)
+                  * sizeof(*entry));
+            vulkan_memory_cache.cache_hits++;
+            return memory;
+         }
+      }
+   }
+
+   vkAllocateMemory(device, alloc, NULL, &memory);
+   *size = alloc->allocationSize;
+   *type = alloc->memoryTypeIndex;
+   vulkan_memory_cache.device_allocs++;
+   return memory;
+}
+
+static void vulkan_memory_release(VkDevice device,
+      VkDeviceMemory memory, VkDeviceSize size, uint32_t type)
+{
+   struct vulkan_memory_cache_entry *entry;
+
+   if (memory == VK_NULL_HANDLE)
+      return;
+
+   /* A different device invalidates whatever the cache holds; the
+    * old device's blocks went down with it in context teardown. */
+   if (vulkan_memory_cache.device != device)
+   {
+      memset(&vulkan_memory_cache, 0, sizeof(vulkan_memory_cache));
+      vulkan_memory_cache.device = device;
+   }
+
+   if (!size || size > VULKAN_MEMORY_CACHE_MAX_BYTES)
+   {
+      vkFreeMemory(device, memory, NULL);
+      return;
+   }
+
+   while (  vulkan_memory_cache.count >= VULKAN_MEMORY_CACHE_ENTRIES
+         || (vulkan_memory_cache.count
+            && vulkan_memory_cache.cached_bytes + size
+               > VULKAN_MEMORY_CACHE_MAX_BYTES))
+      vulkan_memory_cache_evict_oldest();
+
+   entry         =
+      &vulkan_memory_cache.entries[vulkan_memory_cache.count++];
+   entry->memory = memory;
+   entry->size   = size;
+   entry->type   = type;
+   vulkan_memory_cache.cached_bytes += size;
+}
+
 struct vk_texture vulkan_create_texture(vk_t *vk,
       struct vk_texture *old,
       unsigned width, unsigned height,
@@ -633,16 +775,14 @@ struct vk_texture vulkan_create_texture(vk_t *vk,
       old->memory     = VK_NULL_HANDLE;
    }
    else
-   {
-      vkAllocateMemory(device, &alloc, NULL, &tex.memory);
-      tex.memory_size = alloc.allocationSize;
-      tex.memory_type = alloc.memoryTypeIndex;
-   }
+      tex.memory = vulkan_memory_alloc(device, &alloc,
+            &tex.memory_size, &tex.memory_type);
 
    if (old)
    {
       if (old->memory != VK_NULL_HANDLE)
-         vkFreeMemory(device, old->memory, NULL);
+         vulkan_memory_release(device, old->memory,
+               old->memory_size, old->memory_type);
       memset(old, 0, sizeof(*old));
    }
 
@@ -862,7 +1002,8 @@ void vulkan_destroy_texture(
    if (tex->buffer)
       vkDestroyBuffer(device, tex->buffer, NULL);
    if (tex->memory)
-      vkFreeMemory(device, tex->memory, NULL);
+      vulkan_memory_release(device, tex->memory,
+            tex->memory_size, tex->memory_type);
 
 #ifdef VULKAN_DEBUG_TEXTURE_ALLOC
    if (tex->image)
@@ -2516,9 +2657,16 @@ static void vulkan_destroy_swapchain(gfx_ctx_vulkan_data_t *vk)
    unsigned i;
 
    vulkan_emulated_mailbox_deinit(&vk->mailbox);
+   if (     vk->swapchain         != VK_NULL_HANDLE
+         || vk->retired_swapchain != VK_NULL_HANDLE)
+      vkDeviceWaitIdle(vk->context.device);
+   if (vk->retired_swapchain != VK_NULL_HANDLE)
+   {
+      vkDestroySwapchainKHR(vk->context.device, vk->retired_swapchain, NULL);
+      vk->retired_swapchain              = VK_NULL_HANDLE;
+   }
    if (vk->swapchain != VK_NULL_HANDLE)
    {
-      vkDeviceWaitIdle(vk->context.device);
       vkDestroySwapchainKHR(vk->context.device, vk->swapchain, NULL);
       memset(vk->context.swapchain_images, 0, sizeof(vk->context.swapchain_images));
       vk->swapchain                      = VK_NULL_HANDLE;
@@ -2635,6 +2783,7 @@ void vulkan_context_destroy(gfx_ctx_vulkan_data_t *vk,
    {
       if (vk->context.device)
       {
+         vulkan_memory_cache_purge(vk->context.device);
          vkDestroyDevice(vk->context.device, NULL);
          vk->context.device = NULL;
       }
@@ -2668,6 +2817,20 @@ static void vulkan_recycle_acquire_semaphore(struct vulkan_context *ctx, VkSemap
    ctx->swapchain_recycled_semaphores[ctx->num_recycled_acquire_semaphores++] = sem;
 }
 
+static void vulkan_wait_frame_fences(gfx_ctx_vulkan_data_t *vk)
+{
+   unsigned i;
+   /* Wait only for the frames we actually have in flight,
+    * rather than draining the whole device. */
+   for (i = 0; i < vk->context.num_swapchain_images; i++)
+   {
+      if (     vk->context.swapchain_fences[i] != VK_NULL_HANDLE
+            && vk->context.swapchain_fences_signalled[i])
+         vkWaitForFences(vk->context.device, 1,
+               &vk->context.swapchain_fences[i], true, UINT64_MAX);
+   }
+}
+
 static void vulkan_acquire_clear_fences(gfx_ctx_vulkan_data_t *vk)
 {
    unsigned i;
@@ -2760,8 +2923,65 @@ static void vulkan_create_wait_fences(gfx_ctx_vulkan_data_t *vk)
    vk->context.current_frame_index = 0;
 }
 
+bool vulkan_context_acquire_latency(const vulkan_context_t *ctx,
+      int64_t *p50, int64_t *p99)
+{
+   unsigned i, j;
+   int64_t sorted[VULKAN_ACQUIRE_LATENCY_FRAMES];
+   unsigned count = ctx->acquire_latency_count;
+
+   /* Percentiles over a handful of frames are noise. */
+   if (count < 8)
+      return false;
+
+   for (i = 0; i < count; i++)
+   {
+      int64_t sample = ctx->acquire_latency[i];
+      for (j = i; j > 0 && sorted[j - 1] > sample; j--)
+         sorted[j] = sorted[j - 1];
+      sorted[j] = sample;
+   }
+
+   *p50 = sorted[count / 2];
+   *p99 = sorted[(count * 99) / 100];
+   return true;
+}
+
+/* Records one swapchain acquire time; once per full sample
+ * window the p50/p99 percentiles are republished through the
+ * frontend performance counters (in microseconds rather than
+ * perf ticks, so they read directly as latency). */
+static void vulkan_context_record_acquire(vulkan_context_t *ctx,
+      retro_time_t latency)
+{
+   ctx->acquire_latency[ctx->acquire_latency_index] = latency;
+   ctx->acquire_latency_index                       =
+      (ctx->acquire_latency_index + 1) % VULKAN_ACQUIRE_LATENCY_FRAMES;
+   if (ctx->acquire_latency_count < VULKAN_ACQUIRE_LATENCY_FRAMES)
+      ctx->acquire_latency_count++;
+
+   if (     ctx->acquire_latency_index == 0
+         && rarch_ctl(RARCH_CTL_IS_PERFCNT_ENABLE, NULL))
+   {
+      int64_t p50, p99;
+      static struct retro_perf_counter perf_acquire_p50;
+      static struct retro_perf_counter perf_acquire_p99;
+
+      if (vulkan_context_acquire_latency(ctx, &p50, &p99))
+      {
+         performance_counter_init(perf_acquire_p50, "vulkan_acquire_p50_us");
+         performance_counter_init(perf_acquire_p99, "vulkan_acquire_p99_us");
+         perf_acquire_p50.call_cnt++;
+         perf_acquire_p50.total += p50;
+         perf_acquire_p99.call_cnt++;
+         perf_acquire_p99.total += p99;
+      }
+   }
+}
+
 void vulkan_acquire_next_image(gfx_ctx_vulkan_data_t *vk)
 {
+   retro_time_t acquire_start;
    unsigned index;
    VkResult err;
    VkFenceCreateInfo fence_info;
@@ -2803,6 +3023,8 @@ retry:
 
    retro_assert(!vk->context.has_acquired_swapchain);
 
+   acquire_start = cpu_features_get_time_usec();
+
    if (vk->emulating_mailbox)
    {
       /* Non-blocking acquire. If we don't get a swapchain frame right away,
@@ -2839,6 +3061,8 @@ retry:
    {
       if (fence != VK_NULL_HANDLE)
          vkWaitForFences(vk->context.device, 1, &fence, true, UINT64_MAX);
+      vulkan_context_record_acquire(&vk->context,
+            cpu_features_get_time_usec() - acquire_start);
       vk->context.has_acquired_swapchain = true;
 
       if (vk->context.swapchain_acquire_semaphore)
@@ -2936,9 +3160,6 @@ bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
    settings_t                    *settings = config_get_ptr();
    VkCompositeAlphaFlagBitsKHR composite   = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 
-   vkDeviceWaitIdle(vk->context.device);
-   vulkan_acquire_clear_fences(vk);
-
    if (swap_interval == 0 && vk->emulate_mailbox)
    {
       swap_interval          = 1;
@@ -3005,6 +3226,15 @@ bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
       }
    }
 
+   /* From here on we are definitely recreating the swapchain.
+    * In-flight frames still reference the old swapchain images and
+    * the per-frame fences, so wait for those specific fences instead
+    * of stalling the whole device with vkDeviceWaitIdle. References
+    * held by the presentation engine are handed over through
+    * oldSwapchain below. */
+   vulkan_wait_frame_fences(vk);
+   vulkan_acquire_clear_fences(vk);
+
    vulkan_emulated_mailbox_deinit(&vk->mailbox);
 
    present_mode_count = 0;
@@ -3117,7 +3347,12 @@ bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
    {
       /* Cannot create swapchain yet, try again later. */
       if (vk->swapchain != VK_NULL_HANDLE)
-         vkDestroySwapchainKHR(vk->context.device, vk->swapchain, NULL);
+      {
+         if (vk->retired_swapchain != VK_NULL_HANDLE)
+            vkDestroySwapchainKHR(vk->context.device,
+                  vk->retired_swapchain, NULL);
+         vk->retired_swapchain         = vk->swapchain;
+      }
       vk->swapchain                    = VK_NULL_HANDLE;
       vk->context.swapchain_width      = width;
       vk->context.swapchain_height     = height;
@@ -3180,10 +3415,16 @@ bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
 
 #ifdef _WIN32
    /* On Windows, do not try to reuse the swapchain.
-    * It causes a lot of issues on nVidia for some reason. */
+    * It causes a lot of issues on nVidia for some reason.
+    * Without oldSwapchain handover the old swapchain must be fully
+    * retired before a new one can be created for the surface,
+    * so this path keeps the conservative full stall. */
    info.oldSwapchain = VK_NULL_HANDLE;
    if (old_swapchain != VK_NULL_HANDLE)
+   {
+      vkDeviceWaitIdle(vk->context.device);
       vkDestroySwapchainKHR(vk->context.device, old_swapchain, NULL);
+   }
 #endif
 
    if (vkCreateSwapchainKHR(vk->context.device,
@@ -3194,8 +3435,14 @@ bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
    }
 
 #ifndef _WIN32
-   if (old_swapchain != VK_NULL_HANDLE)
-      vkDestroySwapchainKHR(vk->context.device, old_swapchain, NULL);
+   /* The old swapchain is retired now, but the presentation engine
+    * may still be scanning out of it. Destroy the swapchain retired
+    * one recreation ago and keep this one around until the next
+    * recreation instead of stalling here. */
+   if (vk->retired_swapchain != VK_NULL_HANDLE)
+      vkDestroySwapchainKHR(vk->context.device,
+            vk->retired_swapchain, NULL);
+   vk->retired_swapchain = old_swapchain;
 #endif
 
    vk->context.swapchain_width  = swapchain_size.width;
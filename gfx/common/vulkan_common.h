@@ -28,6 +28,9 @@
 #define VULKAN_BUFFER_BLOCK_SIZE                (64 * 1024)
 
 #define VULKAN_MAX_SWAPCHAIN_IMAGES             8
+/* Number of recent swapchain acquires sampled for
+ * frame pacing telemetry. */
+#define VULKAN_ACQUIRE_LATENCY_FRAMES           64
 
 #define VULKAN_DIRTY_DYNAMIC_BIT                0x0001
 
@@ -125,6 +128,12 @@ typedef struct vulkan_context
    unsigned swap_interval;
    unsigned num_recycled_acquire_semaphores;
 
+   /* Ring of recent vkAcquireNextImageKHR + fence wait
+    * times in microseconds, for frame pacing telemetry. */
+   int64_t acquire_latency[VULKAN_ACQUIRE_LATENCY_FRAMES];
+   unsigned acquire_latency_index;
+   unsigned acquire_latency_count;
+
    bool swapchain_fences_signalled[VULKAN_MAX_SWAPCHAIN_IMAGES];
    bool invalid_swapchain;
    /* Used by screenshot to get blits with correct colorspace. */
@@ -156,6 +165,10 @@ typedef struct gfx_ctx_vulkan_data
    vulkan_context_t context;
    VkSurfaceKHR vk_surface;      /* ptr alignment */
    VkSwapchainKHR swapchain;     /* ptr alignment */
+   /* Swapchain handed over through oldSwapchain on the last
+    * recreation. The presentation engine can still scan out of it,
+    * so destruction is deferred to the next recreation or teardown. */
+   VkSwapchainKHR retired_swapchain; /* ptr alignment */
 
    struct vulkan_emulated_mailbox mailbox;
 
@@ -324,6 +337,8 @@ typedef struct vk
    video_info_t video;
 
    VkFormat tex_fmt;
+   /* Backbuffer format render_pass was created against. */
+   VkFormat render_pass_format;
    math_matrix_4x4 mvp, mvp_no_rot; /* float alignment */
    VkViewport vk_vp;
    VkRenderPass render_pass;
@@ -390,6 +405,15 @@ typedef struct vk
       VkSampler mipmap_linear;
    } samplers;
 
+   /* Hard GPU sync telemetry - per-frame fence wait
+    * times in microseconds. */
+   struct
+   {
+      retro_time_t fence_wait_last;
+      retro_time_t fence_wait_avg; /* EWMA */
+      bool active;
+   } hard_sync;
+
    struct
    {
       const struct retro_vulkan_image *image;
@@ -675,6 +699,12 @@ void vulkan_present(gfx_ctx_vulkan_data_t *vk, unsigned index);
 
 void vulkan_acquire_next_image(gfx_ctx_vulkan_data_t *vk);
 
+/* Computes p50/p99 swapchain acquire latency in microseconds
+ * over the recent sample window. Returns false until enough
+ * frames have been sampled. */
+bool vulkan_context_acquire_latency(const vulkan_context_t *ctx,
+      int64_t *p50, int64_t *p99);
+
 bool vulkan_create_swapchain(gfx_ctx_vulkan_data_t *vk,
       unsigned width, unsigned height,
       unsigned swap_interval);
@@ -1413,7 +1413,12 @@ static bool d3d11_gfx_frame(
    }
 
    D3D11SetVertexBuffer(context, 0, d3d11->frame.vbo, sizeof(d3d11_vertex_t), 0);
-   D3D11SetBlendState(context, d3d11->blend_disable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+
+   /* Nothing has been bound yet this frame;
+    * start the redundant-bind cache clean. */
+   d3d11->bound.shader = NULL;
+   d3d11->bound.blend  = NULL;
+   d3d11_set_blend_cached(d3d11, d3d11->blend_disable);
 
    texture = d3d11->frame.texture;
 
@@ -1433,7 +1438,7 @@ static bool d3d11_gfx_frame(
       {
          unsigned j;
 
-         d3d11_set_shader(context, &d3d11->pass[i].shader);
+         d3d11_set_shader_cached(d3d11, &d3d11->pass[i].shader);
 
          if (d3d11->shader_preset->pass[i].frame_count_mod)
             d3d11->pass[i].frame_count =
@@ -1520,7 +1525,7 @@ static bool d3d11_gfx_frame(
 
    if (texture)
    {
-      d3d11_set_shader(context, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
+      d3d11_set_shader_cached(d3d11, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
       if (!d3d11->hw.enable || d3d11->shader_preset)
          D3D11SetPShaderResources(context, 0, 1, &texture->view);
       D3D11SetPShaderSamplers(
@@ -1535,7 +1540,7 @@ static bool d3d11_gfx_frame(
 
    D3D11Draw(context, 4, 0);
 
-   D3D11SetBlendState(context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+   d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
 
 #ifdef HAVE_MENU
    if (d3d11->menu.enabled && d3d11->menu.texture.handle)
@@ -1543,7 +1548,7 @@ static bool d3d11_gfx_frame(
       if (d3d11->menu.fullscreen)
          D3D11SetViewports(context, 1, &d3d11->viewport);
 
-      d3d11_set_shader(context, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
+      d3d11_set_shader_cached(d3d11, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
       D3D11SetVertexBuffer(context, 0, d3d11->menu.vbo, sizeof(d3d11_vertex_t), 0);
       D3D11SetVShaderConstantBuffers(context, 0, 1, &d3d11->ubo);
       d3d11_set_texture_and_sampler(context, 0, &d3d11->menu.texture);
@@ -1551,7 +1556,7 @@ static bool d3d11_gfx_frame(
    }
 #endif
 
-   d3d11_set_shader(context, &d3d11->sprites.shader);
+   d3d11_set_shader_cached(d3d11, &d3d11->sprites.shader);
    D3D11SetPrimitiveTopology(context, D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
    D3D11SetVShaderConstantBuffer(context, 0, d3d11->ubo);
    D3D11SetPShaderConstantBuffer(context, 0, d3d11->ubo);
@@ -1579,7 +1584,7 @@ static bool d3d11_gfx_frame(
       if (osd_params)
       {
          D3D11SetViewports(context, 1, &d3d11->viewport);
-         D3D11SetBlendState(d3d11->context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+         d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
          D3D11SetVertexBuffer(context, 0, d3d11->sprites.vbo, sizeof(d3d11_sprite_t), 0);
          font_driver_render_msg(d3d11,
                stat_text,
@@ -1595,7 +1600,7 @@ static bool d3d11_gfx_frame(
       else
          D3D11SetViewports(context, 1, &d3d11->frame.viewport);
 
-      D3D11SetBlendState(d3d11->context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+      d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
       D3D11SetVertexBuffer(context, 0, d3d11->overlays.vbo, sizeof(d3d11_sprite_t), 0);
       D3D11SetPShaderSamplers(
             context, 0, 1, &d3d11->samplers[RARCH_FILTER_UNSPEC][RARCH_WRAP_DEFAULT]);
@@ -1616,7 +1621,7 @@ static bool d3d11_gfx_frame(
    if (msg && *msg)
    {
       D3D11SetViewports(context, 1, &d3d11->viewport);
-      D3D11SetBlendState(d3d11->context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+      d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
       D3D11SetVertexBuffer(context, 0, d3d11->sprites.vbo, sizeof(d3d11_sprite_t), 0);
       font_driver_render_msg(d3d11, msg, NULL, NULL);
 #ifndef __WINRT__
@@ -840,6 +840,10 @@ static void d3d12_gfx_free(void* data)
    Release(d3d12->menu.vbo);
    Release(d3d12->menu.texture.handle);
    Release(d3d12->menu.texture.upload_buffer);
+   Release(d3d12->menu.bundle);
+   Release(d3d12->menu.bundle_allocator);
+
+   d3d12_free_upload_ring(&d3d12->upload_ring);
 
    free(d3d12->desc.sampler_heap.map);
    free(d3d12->desc.srv_heap.map);
@@ -863,12 +867,13 @@ static void d3d12_gfx_free(void* data)
    Release(d3d12->sprites.pipe_font);
 
    Release(d3d12->queue.fence);
-   Release(d3d12->chain.renderTargets[0]);
-   Release(d3d12->chain.renderTargets[1]);
+   for (i = 0; i < countof(d3d12->chain.renderTargets); i++)
+      Release(d3d12->chain.renderTargets[i]);
    Release(d3d12->chain.handle);
 
    Release(d3d12->queue.cmd);
-   Release(d3d12->queue.allocator);
+   for (i = 0; i < D3D12_NUM_FRAMES; i++)
+      Release(d3d12->queue.allocators[i]);
    Release(d3d12->queue.handle);
 
    Release(d3d12->factory);
@@ -963,6 +968,12 @@ static void *d3d12_gfx_init(const video_info_t* video,
       goto error;
 #endif
 
+   /* Per-frame staging memory for core frames and shader
+    * cbuffers; grown on demand if a frame does not fit */
+   if (!d3d12_init_upload_ring(d3d12->device, &d3d12->upload_ring,
+            8 * 1024 * 1024))
+      goto error;
+
    d3d12_init_samplers(d3d12);
    d3d12_set_filtering(d3d12, 0, video->smooth, video->ctx_scaling);
 
@@ -1161,6 +1172,55 @@ error:
 #endif
 }
 
+/* Records the menu quad draw into a reusable bundle -
+ * bundles inherit everything from the parent command list
+ * except the pipeline state and primitive topology, so both
+ * are (re)set here. */
+static void d3d12_record_menu_bundle(d3d12_video_t* d3d12)
+{
+   if (!d3d12->menu.bundle_allocator)
+      D3D12CreateCommandAllocator(
+            d3d12->device, D3D12_COMMAND_LIST_TYPE_BUNDLE,
+            &d3d12->menu.bundle_allocator);
+
+   if (!d3d12->menu.bundle_allocator)
+      return;
+
+   if (!d3d12->menu.bundle)
+      D3D12CreateGraphicsCommandList(
+            d3d12->device, 0, D3D12_COMMAND_LIST_TYPE_BUNDLE,
+            d3d12->menu.bundle_allocator,
+            d3d12->pipes[VIDEO_SHADER_STOCK_BLEND], &d3d12->menu.bundle);
+   else
+   {
+      D3D12ResetCommandAllocator(d3d12->menu.bundle_allocator);
+      D3D12ResetGraphicsCommandList(
+            d3d12->menu.bundle, d3d12->menu.bundle_allocator,
+            d3d12->pipes[VIDEO_SHADER_STOCK_BLEND]);
+   }
+
+   if (!d3d12->menu.bundle)
+      return;
+
+   {
+      D3D12DescriptorHeap desc_heaps[] = { d3d12->desc.srv_heap.handle,
+                                           d3d12->desc.sampler_heap.handle };
+      D3D12SetDescriptorHeaps(d3d12->menu.bundle, countof(desc_heaps), desc_heaps);
+   }
+
+   D3D12SetGraphicsRootSignature(d3d12->menu.bundle, d3d12->desc.rootSignature);
+   D3D12IASetPrimitiveTopology(d3d12->menu.bundle, D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+   D3D12SetGraphicsRootConstantBufferView(
+         d3d12->menu.bundle, ROOT_ID_UBO, d3d12->ubo_view.BufferLocation);
+   d3d12_set_texture_and_sampler(d3d12->menu.bundle, &d3d12->menu.texture);
+   D3D12IASetVertexBuffers(d3d12->menu.bundle, 0, 1, &d3d12->menu.vbo_view);
+   D3D12DrawInstanced(d3d12->menu.bundle, 4, 1, 0, 0);
+
+   D3D12CloseGraphicsCommandList(d3d12->menu.bundle);
+
+   d3d12->menu.bundle_dirty = false;
+}
+
 static bool d3d12_gfx_frame(
       void*               data,
       const void*         frame,
@@ -1185,12 +1245,14 @@ static bool d3d12_gfx_frame(
    bool widgets_active            = video_info->widgets_active;
 #endif
 
-   d3d12_gfx_sync(d3d12);
-
    if (d3d12->resize_chain)
    {
       unsigned i;
 
+      /* The swap chain buffers are recycled below - every
+       * queued frame has to retire first */
+      d3d12_gfx_sync(d3d12);
+
       for (i = 0; i < countof(d3d12->chain.renderTargets); i++)
          Release(d3d12->chain.renderTargets[i]);
 
@@ -1216,10 +1278,29 @@ static bool d3d12_gfx_frame(
       video_driver_set_size(video_width, video_height);
    }
 
-   D3D12ResetCommandAllocator(d3d12->queue.allocator);
+   d3d12->chain.frame_index = DXGIGetCurrentBackBufferIndex(d3d12->chain.handle);
+
+   /* Pipelined frames: only wait for the frame that used
+    * this back buffer slot D3D12_NUM_FRAMES presents ago;
+    * the CPU keeps recording while the GPU works on the
+    * frames in between */
+   if (D3D12GetCompletedValue(d3d12->queue.fence) <
+         d3d12->queue.fenceValues[d3d12->chain.frame_index])
+   {
+      D3D12SetEventOnCompletion(
+            d3d12->queue.fence,
+            d3d12->queue.fenceValues[d3d12->chain.frame_index],
+            d3d12->queue.fenceEvent);
+      WaitForSingleObject(d3d12->queue.fenceEvent, INFINITE);
+   }
+
+   d3d12_upload_ring_begin_frame(&d3d12->upload_ring, d3d12->chain.frame_index);
+
+   D3D12ResetCommandAllocator(d3d12->queue.allocators[d3d12->chain.frame_index]);
 
    D3D12ResetGraphicsCommandList(
-         d3d12->queue.cmd, d3d12->queue.allocator, d3d12->pipes[VIDEO_SHADER_STOCK_BLEND]);
+         d3d12->queue.cmd, d3d12->queue.allocators[d3d12->chain.frame_index],
+         d3d12->pipes[VIDEO_SHADER_STOCK_BLEND]);
 
    {
       D3D12DescriptorHeap desc_heaps[] = { d3d12->desc.srv_heap.handle,
@@ -1289,7 +1370,30 @@ static bool d3d12_gfx_frame(
       if (d3d12->resize_render_targets)
          d3d12_init_render_targets(d3d12, width, height);
 
-      d3d12_update_texture(width, height, pitch, d3d12->format, frame, &d3d12->frame.texture[0]);
+      if (!d3d12_update_texture_staged(width, height, pitch, d3d12->format,
+            frame, &d3d12->frame.texture[0], &d3d12->upload_ring))
+      {
+         /* The frame does not fit the upload ring - drain
+          * the queue (in-flight frames may still read the
+          * old heap) and grow it, with headroom for the
+          * cbuffer allocations later in the frame */
+         size_t required = (size_t)
+               d3d12->frame.texture[0].layout.Footprint.RowPitch *
+               d3d12->frame.texture[0].num_rows + 0x40000;
+
+         d3d12_gfx_sync(d3d12);
+         d3d12_free_upload_ring(&d3d12->upload_ring);
+
+         if (d3d12_init_upload_ring(
+                  d3d12->device, &d3d12->upload_ring, required))
+            d3d12_upload_ring_begin_frame(
+                  &d3d12->upload_ring, d3d12->chain.frame_index);
+
+         if (!d3d12_update_texture_staged(width, height, pitch, d3d12->format,
+               frame, &d3d12->frame.texture[0], &d3d12->upload_ring))
+            d3d12_update_texture(width, height, pitch, d3d12->format,
+                  frame, &d3d12->frame.texture[0]);
+      }
 
       d3d12_upload_texture(d3d12->queue.cmd, &d3d12->frame.texture[0],
             d3d12);
@@ -1336,22 +1440,38 @@ static bool d3d12_gfx_frame(
 
             if (buffer_sem->stage_mask && buffer_sem->uniforms)
             {
+               UINT64         cb_offset   = 0;
                D3D12_RANGE    range       = { 0, 0 };
                uint8_t*       mapped_data = NULL;
                uniform_sem_t* uniform     = buffer_sem->uniforms;
+               D3D12_GPU_VIRTUAL_ADDRESS cb_va =
+                     d3d12->pass[i].buffer_view[j].BufferLocation;
+
+               /* Write the cbuffer into the per-frame upload
+                * ring so frames in flight never share one
+                * buffer; root CBVs want 256 byte alignment */
+               mapped_data = (uint8_t*)d3d12_upload_ring_alloc(
+                     &d3d12->upload_ring, buffer_sem->size,
+                     D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT, &cb_offset);
+
+               if (mapped_data)
+                  cb_va = d3d12->upload_ring.gpu + cb_offset;
+               else
+                  D3D12Map(d3d12->pass[i].buffers[j], 0, &range, (void**)&mapped_data);
 
-               D3D12Map(d3d12->pass[i].buffers[j], 0, &range, (void**)&mapped_data);
                while (uniform->size)
                {
                   if (uniform->data)
                      memcpy(mapped_data + uniform->offset, uniform->data, uniform->size);
                   uniform++;
                }
-               D3D12Unmap(d3d12->pass[i].buffers[j], 0, NULL);
+
+               if (cb_va == d3d12->pass[i].buffer_view[j].BufferLocation)
+                  D3D12Unmap(d3d12->pass[i].buffers[j], 0, NULL);
 
                D3D12SetGraphicsRootConstantBufferView(
                      d3d12->queue.cmd, j == SLANG_CBUFFER_UBO ? ROOT_ID_UBO : ROOT_ID_PC,
-                     d3d12->pass[i].buffer_view[j].BufferLocation);
+                     cb_va);
             }
          }
 #if 0
@@ -1468,7 +1588,6 @@ static bool d3d12_gfx_frame(
             d3d12->queue.cmd, ROOT_ID_UBO, d3d12->frame.ubo_view.BufferLocation);
    }
 
-   d3d12->chain.frame_index = DXGIGetCurrentBackBufferIndex(d3d12->chain.handle);
    d3d12_resource_transition(
          d3d12->queue.cmd, d3d12->chain.renderTargets[d3d12->chain.frame_index],
          D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -1493,18 +1612,20 @@ static bool d3d12_gfx_frame(
          d3d12_upload_texture(d3d12->queue.cmd, &d3d12->menu.texture,
                d3d12);
 
-      D3D12SetGraphicsRootConstantBufferView(
-            d3d12->queue.cmd, ROOT_ID_UBO, d3d12->ubo_view.BufferLocation);
-
       if (d3d12->menu.fullscreen)
       {
          D3D12RSSetViewports(d3d12->queue.cmd, 1, &d3d12->chain.viewport);
          D3D12RSSetScissorRects(d3d12->queue.cmd, 1, &d3d12->chain.scissorRect);
       }
 
-      d3d12_set_texture_and_sampler(d3d12->queue.cmd, &d3d12->menu.texture);
-      D3D12IASetVertexBuffers(d3d12->queue.cmd, 0, 1, &d3d12->menu.vbo_view);
-      D3D12DrawInstanced(d3d12->queue.cmd, 4, 1, 0, 0);
+      /* The static menu quad bindings and draw are replayed
+       * from a pre-recorded bundle; it is only re-recorded
+       * when the menu texture or sampler changes */
+      if (!d3d12->menu.bundle || d3d12->menu.bundle_dirty)
+         d3d12_record_menu_bundle(d3d12);
+
+      if (d3d12->menu.bundle)
+         D3D12ExecuteBundle(d3d12->queue.cmd, d3d12->menu.bundle);
    }
 
    d3d12->sprites.pipe = d3d12->sprites.pipe_noblend;
@@ -1616,6 +1737,7 @@ static bool d3d12_gfx_frame(
 
    D3D12ExecuteGraphicsCommandLists(d3d12->queue.handle, 1, &d3d12->queue.cmd);
    D3D12SignalCommandQueue(d3d12->queue.handle, d3d12->queue.fence, ++d3d12->queue.fenceValue);
+   d3d12->queue.fenceValues[d3d12->chain.frame_index] = d3d12->queue.fenceValue;
 
 #if 1
    DXGIPresent(d3d12->chain.handle, !!d3d12->chain.vsync, 0);
@@ -1716,6 +1838,10 @@ static void d3d12_set_menu_texture_frame(
    d3d12->menu.texture.sampler = settings->bools.menu_linear_filter
       ? d3d12->samplers[RARCH_FILTER_LINEAR][RARCH_WRAP_DEFAULT]
       : d3d12->samplers[RARCH_FILTER_NEAREST][RARCH_WRAP_DEFAULT];
+
+   /* Texture or sampler may have changed - the menu bundle
+    * has both baked in */
+   d3d12->menu.bundle_dirty    = true;
 }
 
 static void d3d12_set_menu_texture_enable(void* data,
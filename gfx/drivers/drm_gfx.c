@@ -37,6 +37,7 @@
 #endif
 
 #include "../font_driver.h"
+#include "../../configuration.h"
 #include "../../retroarch.h"
 #include "../../verbosity.h"
 #include "../common/drm_common.h"
@@ -126,6 +127,12 @@ struct drm_struct
 
    uint32_t plane_id;
    uint32_t plane_fb_prop_id;
+   uint32_t plane_rotation_prop_id;
+
+   /* Scanout rotation in 90 deg counter-clockwise steps,
+    * same encoding the libretro API uses. Applied by the
+    * display hardware, so it costs nothing per frame. */
+   unsigned rotation;
 
    drmModeEncoder *encoder;
    drmModeRes *resources;
@@ -425,6 +432,38 @@ static uint64_t drm_plane_type(drmModePlane *plane)
    return (0);
 }
 
+/* Asks the kernel whether the plane's rotator supports the wanted
+ * angle before committing it. The DRM rotation property uses one bit
+ * per 90 deg counter-clockwise step, same ordering as libretro, so
+ * the wanted bitmask is simply 1 << rotation. */
+static bool drm_plane_apply_rotation(unsigned rotation)
+{
+   int ret;
+   drmModeAtomicReqPtr req = NULL;
+
+   if (!drm.plane_rotation_prop_id)
+      return (rotation == 0);
+
+   req = drmModeAtomicAlloc();
+
+   drmModeAtomicAddProperty(req,
+         drm.plane_id,
+         drm.plane_rotation_prop_id,
+         (uint64_t)1 << rotation);
+
+   /* Probe first: hardware rotators often support only a subset of
+    * the angles, and a failed TEST_ONLY commit leaves the current
+    * plane state untouched. */
+   ret = drmModeAtomicCommit(drm.fd, req,
+         DRM_MODE_ATOMIC_TEST_ONLY, NULL);
+
+   if (ret == 0)
+      ret = drmModeAtomicCommit(drm.fd, req, 0, NULL);
+
+   drmModeAtomicFree(req);
+   return (ret == 0);
+}
+
 /* This configures our only overlay plane to render the given surface. */
 static void drm_plane_setup(struct drm_surface *surface)
 {
@@ -515,18 +554,56 @@ static void drm_plane_setup(struct drm_surface *surface)
       RARCH_LOG("[DRM]: Can't get the FB property ID for plane(%u)\n", drm.plane_id);
    }
 
+   /* The rotation property is optional: without it we simply can't
+    * rotate in scanout, so a requested rotation falls back to none. */
+   drm.plane_rotation_prop_id = get_plane_prop_id(drm.plane_id, "rotation");
+
+   if (drm.rotation && !drm_plane_apply_rotation(drm.rotation))
+   {
+      RARCH_WARN("[DRM]: plane doesn't support %u deg rotation, leaving image unrotated\n",
+            drm.rotation * 90);
+      drm.rotation = 0;
+   }
+
    /* Note src coords (last 4 args) are in Q16 format
     * crtc_w and crtc_h are the final size with applied scale/ratio.
     * crtc_x and crtc_y are the position of the plane
     * pw and ph are the input size: the size of the area we read from the fb. */
+   settings_t *settings = config_get_ptr();
+   float plane_aspect   = surface->aspect;
+
+   /* A quarter-turn in scanout swaps the displayed aspect. */
+   if ((drm.rotation & 1) && plane_aspect > 0.0f)
+      plane_aspect = 1.0f / plane_aspect;
+
    uint32_t plane_flags = 0;
-   uint32_t plane_w = drm.current_mode->vdisplay * surface->aspect;
+   uint32_t plane_w = drm.current_mode->vdisplay * plane_aspect;
    uint32_t plane_h = drm.current_mode->vdisplay;
    /* If we obtain a scaled image width that is bigger than the physical screen width,
     * then we keep the physical screen width as our maximun width. */
    if (plane_w > drm.current_mode->hdisplay)
       plane_w = drm.current_mode->hdisplay;
 
+   /* Integer scaling also happens in scanout: the CRTC rectangle is
+    * the largest whole multiple of the (rotated) source size that
+    * fits the mode, so the scaler never resamples fractionally. */
+   if (settings && settings->bools.video_scale_integer)
+   {
+      uint32_t int_w  = (drm.rotation & 1)
+         ? surface->src_height : surface->src_width;
+      uint32_t int_h  = (drm.rotation & 1)
+         ? surface->src_width  : surface->src_height;
+      uint32_t scale_x = drm.current_mode->hdisplay / int_w;
+      uint32_t scale_y = drm.current_mode->vdisplay / int_h;
+      uint32_t scale   = (scale_x < scale_y) ? scale_x : scale_y;
+
+      if (scale >= 1)
+      {
+         plane_w = int_w * scale;
+         plane_h = int_h * scale;
+      }
+   }
+
    uint32_t plane_x = (drm.current_mode->hdisplay - plane_w) / 2;
    uint32_t plane_y = (drm.current_mode->vdisplay - plane_h) / 2;
 
@@ -916,6 +993,31 @@ static bool drm_gfx_set_shader(void *data,
    return false;
 }
 
+static void drm_gfx_set_rotation(void *data, unsigned rotation)
+{
+   struct drm_video *_drmvars = data;
+
+   rotation &= 3;
+   if (drm.rotation == rotation)
+      return;
+
+   drm.rotation = rotation;
+
+   /* Cores set their rotation before the first frame arrives, and
+    * the plane only exists once the main surface has been set up;
+    * in that case drm_plane_setup will pick the rotation up. */
+   if (!drm.plane_id || !_drmvars || !_drmvars->main_surface)
+      return;
+
+   /* Re-setup the plane: the CRTC rectangle changes shape on
+    * quarter turns, and the rotation is negotiated in there with
+    * fallback to an unrotated image. */
+   if (_drmvars->menu_active && _drmvars->menu_surface)
+      drm_plane_setup(_drmvars->menu_surface);
+   else
+      drm_plane_setup(_drmvars->main_surface);
+}
+
 static void drm_set_aspect_ratio (void *data, unsigned aspect_ratio_idx)
 {
    struct drm_video *_drmvars = data;
@@ -999,7 +1101,7 @@ video_driver_t video_drm = {
    drm_gfx_free,
    "drm",
    NULL, /* set_viewport */
-   NULL, /* set_rotation */
+   drm_gfx_set_rotation,
    drm_gfx_viewport_info,
    NULL, /* read_viewport */
    NULL, /* read_frame_raw */
@@ -3028,6 +3028,12 @@ static bool gl2_frame(void *data, const void *frame,
 #ifdef HAVE_VIDEO_LAYOUT
    gl2_video_layout_render(gl);
 #endif
+   /* From here on, OSD text accumulates into the OSD
+    * font's persistent vertex block and is drawn with a
+    * single flush per atlas below, instead of one draw
+    * (plus viewport/state churn) per message. */
+   font_driver_frame_begin(NULL);
+
 #if defined(HAVE_MENU)
    if (gl->menu_texture_enable)
    {
@@ -3061,6 +3067,8 @@ static bool gl2_frame(void *data, const void *frame,
       font_driver_render_msg(gl, msg, NULL, NULL);
    }
 
+   font_driver_frame_end(width, height, NULL);
+
    if (gl->ctx_driver->update_window_title)
       gl->ctx_driver->update_window_title(gl->ctx_data);
 
@@ -396,6 +396,13 @@ static void *gl1_gfx_init(const video_info_t *video,
    gl1->smooth        = video_smooth;
    gl1->supports_bgra = string_list_find_elem(gl1->extensions, "GL_EXT_bgra");
 
+   /* Packed 16-bit uploads (GL_UNSIGNED_SHORT_5_6_5) are core since
+    * GL 1.2. They let us hand RGB565 core frames straight to the
+    * driver instead of expanding them to 8888 on the CPU first. */
+   gl1->supports_packed_pixels =
+         (gl1->version_major > 1 ||
+         (gl1->version_major == 1 && gl1->version_minor >= 2));
+
    glDisable(GL_BLEND);
    glDisable(GL_DEPTH_TEST);
    glDisable(GL_CULL_FACE);
@@ -550,11 +557,11 @@ void gl1_gfx_set_viewport(gl1_t *gl1,
 #endif
 }
 
-static void draw_tex(gl1_t *gl1, int pot_width, int pot_height, int width, int height, GLuint tex, const void *frame_to_copy)
+static void draw_tex(gl1_t *gl1, int pot_width, int pot_height, int width, int height, GLuint tex, const void *frame_to_copy, bool rgb565)
 {
    uint8_t *frame       = NULL;
    uint8_t *frame_rgba  = NULL;
-   /* FIXME: For now, everything is uploaded as BGRA8888, I could not get 444 or 555 to work, and there is no 565 support in GL 1.1 either. */
+   /* FIXME: For now, everything except 565 on GL 1.2+ is uploaded as BGRA8888, I could not get 444 or 555 to work, and there is no 565 support in GL 1.1 either. */
    GLint internalFormat = GL_RGB8;
    GLenum format        = gl1->supports_bgra ? GL_BGRA_EXT : GL_RGBA;
    GLenum type          = GL_UNSIGNED_BYTE;
@@ -586,6 +593,13 @@ static void draw_tex(gl1_t *gl1, int pot_width, int pot_height, int width, int h
    texcoords[1] = texcoords[5] = norm_height;
    texcoords[4] = texcoords[6] = norm_width;
 
+   if (rgb565)
+   {
+      internalFormat = GL_RGB5;
+      format         = GL_RGB;
+      type           = GL_UNSIGNED_SHORT_5_6_5;
+   }
+
    glDisable(GL_DEPTH_TEST);
    glDisable(GL_CULL_FACE);
    glDisable(GL_STENCIL_TEST);
@@ -602,7 +616,9 @@ static void draw_tex(gl1_t *gl1, int pot_width, int pot_height, int width, int h
    glBindTexture(GL_TEXTURE_2D, tex);
 
    frame = (uint8_t*)frame_to_copy;
-   if (!gl1->supports_bgra)
+   /* 565 uploads have a defined component order,
+    * no swizzle needed. */
+   if (!gl1->supports_bgra && !rgb565)
    {
       frame_rgba = (uint8_t*)malloc(pot_width * pot_height * 4);
       if (frame_rgba)
@@ -698,6 +714,7 @@ static bool gl1_gfx_frame(void *data, const void *frame,
    unsigned width                   = 0;
    unsigned height                  = 0;
    bool draw                        = true;
+   bool frame_rgb565                = false;
    gl1_t *gl1                       = (gl1_t*)data;
    unsigned bits                    = gl1->video_bits;
    unsigned pot_width               = 0;
@@ -775,15 +792,18 @@ static bool gl1_gfx_frame(void *data, const void *frame,
 
    if (draw && gl1->video_buf)
    {
-      if (bits == 32)
+      if (bits == 16 && !gl1->supports_packed_pixels)
+         conv_rgb565_argb8888(gl1->video_buf, frame, width, height, pot_width * sizeof(unsigned), pitch);
+      else
       {
          unsigned y;
          /* copy lines into top-left portion of larger (power-of-two) buffer */
          for (y = 0; y < height; y++)
             memcpy(gl1->video_buf + ((pot_width * (bits / 8)) * y), (const unsigned char*)frame + (pitch * y), width * (bits / 8));
+
+         /* GL 1.2+ accepts the packed frame as-is. */
+         frame_rgb565 = (bits == 16);
       }
-      else if (bits == 16)
-         conv_rgb565_argb8888(gl1->video_buf, frame, width, height, pot_width * sizeof(unsigned), pitch);
 
       frame_to_copy = gl1->video_buf;
    }
@@ -808,7 +828,7 @@ static bool gl1_gfx_frame(void *data, const void *frame,
    
       if (frame_to_copy)
          draw_tex(gl1, pot_width, pot_height,
-               width, height, gl1->tex, frame_to_copy);
+               width, height, gl1->tex, frame_to_copy, frame_rgb565);
    }
 
 #ifdef HAVE_MENU
@@ -848,12 +868,12 @@ static bool gl1_gfx_frame(void *data, const void *frame,
          {
             glViewport(0, 0, video_width, video_height);
             draw_tex(gl1, pot_width, pot_height,
-                  width, height, gl1->menu_tex, frame_to_copy);
+                  width, height, gl1->menu_tex, frame_to_copy, false);
             glViewport(gl1->vp.x, gl1->vp.y, gl1->vp.width, gl1->vp.height);
          }
          else
             draw_tex(gl1, pot_width, pot_height,
-                  width, height, gl1->menu_tex, frame_to_copy);
+                  width, height, gl1->menu_tex, frame_to_copy, false);
       }
    }
 
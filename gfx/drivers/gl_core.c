@@ -234,12 +234,116 @@ static void gl_core_deinit_pbo_readback(gl_core_t *gl)
 {
    unsigned i;
    for (i = 0; i < GL_CORE_NUM_PBOS; i++)
+   {
       if (gl->pbo_readback[i] != 0)
          glDeleteBuffers(1, &gl->pbo_readback[i]);
+      if (gl->pbo_readback_fences[i])
+         glDeleteSync(gl->pbo_readback_fences[i]);
+   }
    memset(gl->pbo_readback, 0, sizeof(gl->pbo_readback));
+   memset(gl->pbo_readback_fences, 0, sizeof(gl->pbo_readback_fences));
    scaler_ctx_gen_reset(&gl->pbo_readback_scaler);
 }
 
+/* Persistent PBO upload streaming
+ *
+ * Software cores hand us a CPU frame every retro_run();
+ * uploading it straight from client memory makes the driver
+ * stage an internal copy synchronously inside
+ * glTexSubImage2D(). With GL_ARB_buffer_storage we can
+ * instead keep one persistently mapped coherent PBO,
+ * memcpy() the frame into a fenced ring slice and let the
+ * GPU pull from it asynchronously. */
+#if !defined(HAVE_OPENGLES) && defined(GL_MAP_PERSISTENT_BIT) && defined(GL_MAP_COHERENT_BIT)
+#define GL_CORE_HAVE_PBO_UPLOAD
+#endif
+
+#ifdef GL_CORE_HAVE_PBO_UPLOAD
+static bool gl_core_has_buffer_storage(gl_core_t *gl)
+{
+   GLint i;
+   GLint exts = 0;
+
+   if (    (gl->version_major > 4)
+       || ((gl->version_major == 4) && (gl->version_minor >= 4)))
+      return true;
+
+   glGetIntegerv(GL_NUM_EXTENSIONS, &exts);
+
+   for (i = 0; i < exts; i++)
+   {
+      const char *ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+
+      if (ext && string_is_equal(ext, "GL_ARB_buffer_storage"))
+         return true;
+   }
+
+   return false;
+}
+
+static bool gl_core_init_pbo_upload(gl_core_t *gl,
+      unsigned max_width, unsigned max_height)
+{
+   GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+   if (!gl_core_has_buffer_storage(gl))
+      return false;
+
+   /* Worst case frame is RGBA8888 */
+   gl->pbo_upload_slice = (size_t)max_width * max_height * 4;
+
+   glGenBuffers(1, &gl->pbo_upload);
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gl->pbo_upload);
+   glBufferStorage(GL_PIXEL_UNPACK_BUFFER,
+         gl->pbo_upload_slice * GL_CORE_NUM_PBOS, NULL, flags);
+   gl->pbo_upload_map = (uint8_t*)glMapBufferRange(
+         GL_PIXEL_UNPACK_BUFFER, 0,
+         gl->pbo_upload_slice * GL_CORE_NUM_PBOS, flags);
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+   if (!gl->pbo_upload_map)
+   {
+      glDeleteBuffers(1, &gl->pbo_upload);
+      gl->pbo_upload       = 0;
+      gl->pbo_upload_slice = 0;
+      return false;
+   }
+
+   gl->pbo_upload_index = 0;
+   return true;
+}
+#endif
+
+static void gl_core_deinit_pbo_upload(gl_core_t *gl)
+{
+#ifdef GL_CORE_HAVE_PBO_UPLOAD
+   unsigned i;
+
+   if (gl->pbo_upload_map)
+   {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gl->pbo_upload);
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   }
+
+   if (gl->pbo_upload != 0)
+      glDeleteBuffers(1, &gl->pbo_upload);
+
+   for (i = 0; i < GL_CORE_NUM_PBOS; i++)
+   {
+      if (gl->pbo_upload_fences[i])
+         glDeleteSync(gl->pbo_upload_fences[i]);
+      gl->pbo_upload_fences[i] = NULL;
+   }
+
+   gl->pbo_upload        = 0;
+   gl->pbo_upload_map    = NULL;
+   gl->pbo_upload_slice  = 0;
+   gl->pbo_upload_enable = false;
+#endif
+}
+
 static void gl_core_slow_readback(gl_core_t *gl, void *buffer)
 {
    glPixelStorei(GL_PACK_ALIGNMENT, 4);
@@ -256,6 +360,8 @@ static void gl_core_slow_readback(gl_core_t *gl, void *buffer)
 
 static void gl_core_pbo_async_readback(gl_core_t *gl)
 {
+   unsigned index = gl->pbo_readback_index;
+
    glBindBuffer(GL_PIXEL_PACK_BUFFER, gl->pbo_readback[gl->pbo_readback_index++]);
    glPixelStorei(GL_PACK_ALIGNMENT, 4);
    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
@@ -270,6 +376,13 @@ static void gl_core_pbo_async_readback(gl_core_t *gl)
                 gl->vp.width, gl->vp.height,
                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+   /* Fence the copy so collection can prove it finished
+    * rather than rely on an implicit stall when mapping. */
+   if (gl->pbo_readback_fences[index])
+      glDeleteSync(gl->pbo_readback_fences[index]);
+   gl->pbo_readback_fences[index] =
+      glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
 }
 
 static void gl_core_fence_iterate(gl_core_t *gl, unsigned hard_sync_frames)
@@ -572,6 +685,15 @@ static void gl_core_destroy_resources(gl_core_t *gl)
    if (gl->menu_texture != 0)
       glDeleteTextures(1, &gl->menu_texture);
 
+   if (gl->dup_fbo != 0)
+      glDeleteFramebuffers(1, &gl->dup_fbo);
+   if (gl->dup_texture != 0)
+      glDeleteTextures(1, &gl->dup_texture);
+   gl->dup_fbo        = 0;
+   gl->dup_texture    = 0;
+   gl->dup_fbo_width  = 0;
+   gl->dup_fbo_height = 0;
+
    if (gl->pipelines.alpha_blend)
       glDeleteProgram(gl->pipelines.alpha_blend);
    if (gl->pipelines.font)
@@ -593,6 +715,7 @@ static void gl_core_destroy_resources(gl_core_t *gl)
 #endif
    gl_core_deinit_fences(gl);
    gl_core_deinit_pbo_readback(gl);
+   gl_core_deinit_pbo_upload(gl);
    gl_core_deinit_hw_render(gl);
 }
 
@@ -1338,6 +1461,15 @@ static void *gl_core_init(const video_info_t *video,
       RARCH_LOG("[GLCore]: Async PBO readback enabled.\n");
    }
 
+#ifdef GL_CORE_HAVE_PBO_UPLOAD
+   gl->pbo_upload_enable = gl_core_init_pbo_upload(gl,
+         RARCH_SCALE_BASE * video->input_scale,
+         RARCH_SCALE_BASE * video->input_scale);
+
+   if (gl->pbo_upload_enable)
+      RARCH_LOG("[GLCore]: Persistent PBO upload streaming enabled.\n");
+#endif
+
    if (!gl_check_error(&error_string))
    {
       RARCH_ERR("%s\n", error_string);
@@ -1704,6 +1836,18 @@ static bool gl_core_read_viewport(void *data, uint8_t *buffer, bool is_idle)
          goto error;
 
       gl->pbo_readback_valid[gl->pbo_readback_index] = false;
+
+      /* The copy was fenced GL_CORE_NUM_PBOS - 1 frames ago,
+       * so this wait is almost always a no-op and the map
+       * below never has to block on the GPU. */
+      if (gl->pbo_readback_fences[gl->pbo_readback_index])
+      {
+         glClientWaitSync(gl->pbo_readback_fences[gl->pbo_readback_index],
+               GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+         glDeleteSync(gl->pbo_readback_fences[gl->pbo_readback_index]);
+         gl->pbo_readback_fences[gl->pbo_readback_index] = NULL;
+      }
+
       glBindBuffer(GL_PIXEL_PACK_BUFFER, gl->pbo_readback[gl->pbo_readback_index]);
 
       ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, num_pixels * sizeof(uint32_t), GL_MAP_READ_BIT);
@@ -1774,20 +1918,63 @@ static void gl_core_update_cpu_texture(gl_core_t *gl,
    else
       glBindTexture(GL_TEXTURE_2D, streamed->tex);
 
-   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-   if (gl->video_info.rgb32)
    {
-      glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 2);
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-                      width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame);
-   }
-   else
-   {
-      glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 1);
-      glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
-                      width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, frame);
+      const void *upload = frame;
+#ifdef GL_CORE_HAVE_PBO_UPLOAD
+      size_t upload_size = (size_t)pitch * height;
+      bool use_pbo       = gl->pbo_upload_enable &&
+            (upload_size <= gl->pbo_upload_slice);
+
+      if (use_pbo)
+      {
+         unsigned index = gl->pbo_upload_index;
+         size_t offset  = (size_t)index * gl->pbo_upload_slice;
+
+         /* The GPU may still be sourcing this slice from
+          * GL_CORE_NUM_PBOS frames ago */
+         if (gl->pbo_upload_fences[index])
+         {
+            glClientWaitSync(gl->pbo_upload_fences[index],
+                  GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            glDeleteSync(gl->pbo_upload_fences[index]);
+            gl->pbo_upload_fences[index] = NULL;
+         }
+
+         /* Coherent mapping - no explicit flush needed */
+         memcpy(gl->pbo_upload_map + offset, frame, upload_size);
+         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, gl->pbo_upload);
+         upload = (const void*)(uintptr_t)offset;
+      }
+      else
+#endif
+         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+      if (gl->video_info.rgb32)
+      {
+         glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 2);
+         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                         width, height, GL_RGBA, GL_UNSIGNED_BYTE, upload);
+      }
+      else
+      {
+         glPixelStorei(GL_UNPACK_ROW_LENGTH, pitch >> 1);
+         glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0,
+                         width, height, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, upload);
+      }
+
+#ifdef GL_CORE_HAVE_PBO_UPLOAD
+      if (use_pbo)
+      {
+         gl->pbo_upload_fences[gl->pbo_upload_index] =
+            glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+         gl->pbo_upload_index++;
+         if (gl->pbo_upload_index >= GL_CORE_NUM_PBOS)
+            gl->pbo_upload_index = 0;
+         glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      }
+#endif
    }
 }
 
@@ -1837,6 +2024,66 @@ static void gl_core_draw_menu_texture(gl_core_t *gl,
 }
 #endif
 
+/* Copies the finished backbuffer into a cached FBO so the frame can
+ * be presented a second time - backbuffer contents are undefined
+ * after a swap, so the duplicate cannot be read back afterwards.
+ * Returns false when no duplicate could be captured. */
+static bool gl_core_dup_frame_capture(gl_core_t *gl)
+{
+   unsigned width  = gl->video_width;
+   unsigned height = gl->video_height;
+
+   if (gl->dup_fbo_width != width || gl->dup_fbo_height != height)
+   {
+      if (gl->dup_fbo != 0)
+         glDeleteFramebuffers(1, &gl->dup_fbo);
+      if (gl->dup_texture != 0)
+         glDeleteTextures(1, &gl->dup_texture);
+
+      glGenTextures(1, &gl->dup_texture);
+      glBindTexture(GL_TEXTURE_2D, gl->dup_texture);
+      glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+      glBindTexture(GL_TEXTURE_2D, 0);
+
+      glGenFramebuffers(1, &gl->dup_fbo);
+      glBindFramebuffer(GL_FRAMEBUFFER, gl->dup_fbo);
+      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D, gl->dup_texture, 0);
+
+      if (glCheckFramebufferStatus(GL_FRAMEBUFFER)
+            != GL_FRAMEBUFFER_COMPLETE)
+      {
+         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+         glDeleteFramebuffers(1, &gl->dup_fbo);
+         glDeleteTextures(1, &gl->dup_texture);
+         gl->dup_fbo        = 0;
+         gl->dup_texture    = 0;
+         gl->dup_fbo_width  = 0;
+         gl->dup_fbo_height = 0;
+         return false;
+      }
+
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      gl->dup_fbo_width  = width;
+      gl->dup_fbo_height = height;
+   }
+
+   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gl->dup_fbo);
+   glBlitFramebuffer(0, 0, width, height, 0, 0, width, height,
+         GL_COLOR_BUFFER_BIT, GL_NEAREST);
+   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+   return true;
+}
+
+static void gl_core_dup_frame_present(gl_core_t *gl)
+{
+   glBindFramebuffer(GL_READ_FRAMEBUFFER, gl->dup_fbo);
+   glBlitFramebuffer(0, 0, gl->dup_fbo_width, gl->dup_fbo_height,
+         0, 0, gl->dup_fbo_width, gl->dup_fbo_height,
+         GL_COLOR_BUFFER_BIT, GL_NEAREST);
+   glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
 static bool gl_core_frame(void *data, const void *frame,
       unsigned frame_width, unsigned frame_height,
       uint64_t frame_count,
@@ -1854,6 +2101,7 @@ static bool gl_core_frame(void *data, const void *frame,
    bool statistics_show                        = video_info->statistics_show;
    bool msg_bgcolor_enable                     = video_info->msg_bgcolor_enable;
    bool black_frame_insertion                  = video_info->black_frame_insertion;
+   bool frame_duplication                      = video_info->frame_duplication;
    unsigned hard_sync_frames                   = video_info->hard_sync_frames;
    bool runloop_is_paused                      = video_info->runloop_is_paused;
    bool runloop_is_slowmotion                  = video_info->runloop_is_slowmotion;
@@ -1989,17 +2237,25 @@ static bool gl_core_frame(void *data, const void *frame,
          gl_core_pbo_async_readback(gl);
    }
 
-   /* Disable BFI during fast forward, slow-motion,
-    * and pause to prevent flicker. */
+   /* Disable BFI/frame duplication during fast forward,
+    * slow-motion, and pause to prevent flicker. */
    if (
-         black_frame_insertion
-         && !input_driver_nonblock_state
+            !input_driver_nonblock_state
          && !runloop_is_slowmotion
          && !runloop_is_paused)
    {
-      if (gl->ctx_driver->swap_buffers)
-         gl->ctx_driver->swap_buffers(gl->ctx_data);
-      glClear(GL_COLOR_BUFFER_BIT);
+      if (black_frame_insertion)
+      {
+         if (gl->ctx_driver->swap_buffers)
+            gl->ctx_driver->swap_buffers(gl->ctx_data);
+         glClear(GL_COLOR_BUFFER_BIT);
+      }
+      else if (frame_duplication && gl_core_dup_frame_capture(gl))
+      {
+         if (gl->ctx_driver->swap_buffers)
+            gl->ctx_driver->swap_buffers(gl->ctx_data);
+         gl_core_dup_frame_present(gl);
+      }
    }
 
    if (gl->ctx_driver->swap_buffers)
@@ -2064,6 +2320,14 @@ static struct video_shader *gl_core_get_current_shader(void *data)
    return gl_core_filter_chain_get_preset(gl->filter_chain);
 }
 
+static bool gl_core_get_shader_pass_profile(void *data, char *s, size_t len)
+{
+   gl_core_t *gl = (gl_core_t*)data;
+   if (!gl || !gl->filter_chain)
+      return false;
+   return gl_core_filter_chain_get_pass_profile(gl->filter_chain, s, len);
+}
+
 #ifdef HAVE_THREADS
 static int video_texture_load_wrap_gl_core_mipmap(void *data)
 {
@@ -2277,6 +2541,7 @@ static const video_poke_interface_t gl_core_poke_interface = {
    gl_core_get_current_shader,
    NULL,
    NULL,
+   gl_core_get_shader_pass_profile,
 };
 
 static void gl_core_get_poke_interface(void *data,
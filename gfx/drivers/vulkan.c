@@ -27,6 +27,9 @@
 #include <retro_math.h>
 #include <retro_assert.h>
 #include <string/stdstring.h>
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <features/features_cpu.h>
 #include <libretro.h>
 
 #ifdef HAVE_CONFIG_H
@@ -91,6 +94,15 @@ static void vulkan_init_render_pass(
    VkAttachmentDescription attachment = {0};
    VkSubpassDescription subpass       = {0};
 
+   /* The render pass only depends on the backbuffer format,
+    * so reuse it across swapchain recreations. */
+   if (     vk->render_pass != VK_NULL_HANDLE
+         && vk->render_pass_format == vk->context->swapchain_format)
+      return;
+
+   if (vk->render_pass != VK_NULL_HANDLE)
+      vkDestroyRenderPass(vk->context->device, vk->render_pass, NULL);
+
    /* Backbuffer format. */
    attachment.format            = vk->context->swapchain_format;
    /* Not multisampled. */
@@ -122,6 +134,7 @@ static void vulkan_init_render_pass(
 
    vkCreateRenderPass(vk->context->device,
          &rp_info, NULL, &vk->render_pass);
+   vk->render_pass_format = vk->context->swapchain_format;
 }
 
 static void vulkan_init_framebuffers(
@@ -753,8 +766,15 @@ static void vulkan_deinit_framebuffers(vk_t *vk)
                vk->backbuffers[i].view, NULL);
       }
    }
+}
+
+static void vulkan_deinit_render_pass(vk_t *vk)
+{
+   if (vk->render_pass == VK_NULL_HANDLE)
+      return;
 
    vkDestroyRenderPass(vk->context->device, vk->render_pass, NULL);
+   vk->render_pass = VK_NULL_HANDLE;
 }
 
 static bool vulkan_init_default_filter_chain(vk_t *vk)
@@ -830,9 +850,14 @@ static bool vulkan_init_filter_chain_preset(vk_t *vk, const char *shader_path)
 
 static bool vulkan_init_filter_chain(vk_t *vk)
 {
+   settings_t        *settings = config_get_ptr();
    const char     *shader_path = retroarch_get_shader_preset();
    enum rarch_shader_type type = video_shader_parse_type(shader_path);
 
+   /* Compiled SPIR-V is cached on disk to avoid
+    * recompiling unchanged shaders on every load. */
+   glslang_set_cache_directory(settings->paths.directory_cache);
+
    if (string_is_empty(shader_path))
    {
       RARCH_LOG("[Vulkan]: Loading stock shader.\n");
@@ -866,6 +891,132 @@ static void vulkan_init_resources(vk_t *vk)
    vulkan_init_command_buffers(vk);
 }
 
+/* Pipeline cache serialization
+ * > The driver-level pipeline cache is saved to
+ *   disk on teardown and primed from disk on the
+ *   next run, skipping most pipeline compilation
+ * > The blob is keyed by vendor/device/driver
+ *   version - stale data is discarded and the
+ *   driver additionally validates its own header */
+
+#define VULKAN_PIPELINE_CACHE_MAGIC   0x43505652 /* 'RVPC' */
+#define VULKAN_PIPELINE_CACHE_VERSION 1
+
+static void vulkan_get_pipeline_cache_path(vk_t *vk, char *s, size_t len)
+{
+   settings_t *settings = config_get_ptr();
+
+   s[0] = '\0';
+
+   if (string_is_empty(settings->paths.directory_cache))
+      return;
+
+   fill_pathname_join(s, settings->paths.directory_cache,
+         "vulkan_pipeline.cache", len);
+}
+
+static void vulkan_load_pipeline_cache(vk_t *vk)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   VkPhysicalDeviceProperties props;
+   VkPipelineCacheCreateInfo cache = {
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+   void *buf   = NULL;
+   int64_t len = 0;
+
+   vulkan_get_pipeline_cache_path(vk, cache_path, sizeof(cache_path));
+
+   vkGetPhysicalDeviceProperties(vk->context->gpu, &props);
+
+   if (!string_is_empty(cache_path) &&
+       path_is_valid(cache_path)    &&
+       filestream_read_file(cache_path, &buf, &len) && buf)
+   {
+      const uint32_t *header = (const uint32_t*)buf;
+
+      /* Header: magic, version, vendor ID, device ID,
+       * driver version, blob size */
+      if ((len >= (int64_t)(6 * sizeof(uint32_t)))          &&
+          (header[0] == VULKAN_PIPELINE_CACHE_MAGIC)        &&
+          (header[1] == VULKAN_PIPELINE_CACHE_VERSION)      &&
+          (header[2] == props.vendorID)                     &&
+          (header[3] == props.deviceID)                     &&
+          (header[4] == props.driverVersion)                &&
+          ((int64_t)header[5] == len - 6 * sizeof(uint32_t)))
+      {
+         cache.initialDataSize = (size_t)header[5];
+         cache.pInitialData    = header + 6;
+
+         RARCH_LOG("[Vulkan]: Found %u byte pipeline cache.\n",
+               header[5]);
+      }
+      else
+         RARCH_WARN("[Vulkan]: Ignoring stale pipeline cache.\n");
+   }
+
+   if (vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache) != VK_SUCCESS &&
+         cache.pInitialData)
+   {
+      /* Driver rejected the blob - retry empty. */
+      cache.initialDataSize = 0;
+      cache.pInitialData    = NULL;
+      vkCreatePipelineCache(vk->context->device,
+            &cache, NULL, &vk->pipelines.cache);
+   }
+
+   if (buf)
+      free(buf);
+}
+
+static void vulkan_save_pipeline_cache(vk_t *vk)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   VkPhysicalDeviceProperties props;
+   uint32_t header[6];
+   RFILE *file = NULL;
+   size_t size = 0;
+   void *data  = NULL;
+
+   vulkan_get_pipeline_cache_path(vk, cache_path, sizeof(cache_path));
+
+   if (string_is_empty(cache_path))
+      return;
+
+   if (vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, NULL) != VK_SUCCESS || !size)
+      return;
+
+   if (!(data = malloc(size)))
+      return;
+
+   if (vkGetPipelineCacheData(vk->context->device,
+            vk->pipelines.cache, &size, data) == VK_SUCCESS)
+   {
+      file = filestream_open(cache_path,
+            RETRO_VFS_FILE_ACCESS_WRITE,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+      if (file)
+      {
+         vkGetPhysicalDeviceProperties(vk->context->gpu, &props);
+
+         header[0] = VULKAN_PIPELINE_CACHE_MAGIC;
+         header[1] = VULKAN_PIPELINE_CACHE_VERSION;
+         header[2] = props.vendorID;
+         header[3] = props.deviceID;
+         header[4] = props.driverVersion;
+         header[5] = (uint32_t)size;
+
+         filestream_write(file, header, sizeof(header));
+         filestream_write(file, data, size);
+         filestream_close(file);
+      }
+   }
+
+   free(data);
+}
+
 static void vulkan_init_static_resources(vk_t *vk)
 {
    unsigned i;
@@ -873,17 +1024,14 @@ static void vulkan_init_static_resources(vk_t *vk)
    VkCommandPoolCreateInfo pool_info = {
       VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
 
-   /* Create the pipeline cache. */
-   VkPipelineCacheCreateInfo cache   = {
-      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
-
    pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
    if (!vk->context)
       return;
 
-   vkCreatePipelineCache(vk->context->device,
-         &cache, NULL, &vk->pipelines.cache);
+   /* Create the pipeline cache, primed from
+    * disk when a previous run saved one. */
+   vulkan_load_pipeline_cache(vk);
 
    pool_info.queueFamilyIndex = vk->context->graphics_queue_index;
 
@@ -901,6 +1049,7 @@ static void vulkan_init_static_resources(vk_t *vk)
 static void vulkan_deinit_static_resources(vk_t *vk)
 {
    unsigned i;
+   vulkan_save_pipeline_cache(vk);
    vkDestroyPipelineCache(vk->context->device,
          vk->pipelines.cache, NULL);
    vulkan_destroy_texture(
@@ -924,6 +1073,7 @@ static void vulkan_deinit_resources(vk_t *vk)
 {
    vulkan_deinit_pipelines(vk);
    vulkan_deinit_framebuffers(vk);
+   vulkan_deinit_render_pass(vk);
    vulkan_deinit_descriptor_pool(vk);
    vulkan_deinit_textures(vk);
    vulkan_deinit_buffers(vk);
@@ -1317,7 +1467,24 @@ static void vulkan_update_filter_chain(vk_t *vk)
 
 static void vulkan_check_swapchain(vk_t *vk)
 {
-   if (vk->context->invalid_swapchain)
+   if (!vk->context->invalid_swapchain)
+      return;
+
+   if (     vk->num_swapchain_images == vk->context->num_swapchain_images
+         && vk->render_pass != VK_NULL_HANDLE
+         && vk->render_pass_format == vk->context->swapchain_format)
+   {
+      /* Same image count and backbuffer format, only the swapchain
+       * images themselves changed (resize, alt-tab). The context
+       * already waited for our in-flight frame fences when it
+       * recreated the swapchain, so only the backbuffer views and
+       * framebuffers have to be rebuilt. Render pass, pipelines,
+       * textures, buffers and command buffers all carry over, and
+       * we avoid draining the queue. */
+      vulkan_deinit_framebuffers(vk);
+      vulkan_init_framebuffers(vk);
+   }
+   else
    {
 #ifdef HAVE_THREADS
       slock_lock(vk->context->queue_lock);
@@ -1329,10 +1496,10 @@ static void vulkan_check_swapchain(vk_t *vk)
 
       vulkan_deinit_resources(vk);
       vulkan_init_resources(vk);
-      vk->context->invalid_swapchain = false;
-
-      vulkan_update_filter_chain(vk);
    }
+
+   vk->context->invalid_swapchain = false;
+   vulkan_update_filter_chain(vk);
 }
 
 static void vulkan_set_nonblock_state(void *data, bool state,
@@ -1725,6 +1892,7 @@ static bool vulkan_frame(void *data, const void *frame,
    bool statistics_show                          = video_info->statistics_show;
    const char *stat_text                         = video_info->stat_text;
    bool black_frame_insertion                    = video_info->black_frame_insertion;
+   bool frame_duplication                        = video_info->frame_duplication;
    bool input_driver_nonblock_state              = video_info->input_driver_nonblock_state;
    bool runloop_is_slowmotion                    = video_info->runloop_is_slowmotion;
    bool runloop_is_paused                        = video_info->runloop_is_paused;
@@ -2238,6 +2406,45 @@ static bool vulkan_frame(void *data, const void *frame,
    if (vk->ctx_driver->swap_buffers)
       vk->ctx_driver->swap_buffers(vk->ctx_data);
 
+   /* Hard GPU sync: cap the number of fences in flight the same way
+    * the GL drivers do, instead of letting the swapchain queue up to
+    * num_swapchain_images frames. hard_sync_frames == 0 blocks until
+    * the frame just submitted has retired. The wait time is tracked
+    * so the statistics display can show what the latency cap costs. */
+   if (      video_info->hard_sync
+         && !vk->context->swap_interval_emulation_lock
+         &&  vk->context->num_swapchain_images)
+   {
+      retro_time_t wait_time = 0;
+      unsigned num_images    = vk->context->num_swapchain_images;
+      unsigned sync_frames   = video_info->hard_sync_frames;
+
+      if (sync_frames < num_images)
+      {
+         unsigned wait_index = (frame_index + num_images - sync_frames)
+               % num_images;
+
+         if (     vk->context->swapchain_fences[wait_index] != VK_NULL_HANDLE
+               && vk->context->swapchain_fences_signalled[wait_index])
+         {
+            retro_time_t wait_start = cpu_features_get_time_usec();
+            /* The fence is only waited on, not reset - the regular
+             * per-frame fence handling still owns its lifetime. */
+            vkWaitForFences(vk->context->device, 1,
+                  &vk->context->swapchain_fences[wait_index],
+                  true, UINT64_MAX);
+            wait_time           = cpu_features_get_time_usec() - wait_start;
+         }
+      }
+
+      vk->hard_sync.fence_wait_last = wait_time;
+      vk->hard_sync.fence_wait_avg +=
+         (wait_time - vk->hard_sync.fence_wait_avg) / 8;
+      vk->hard_sync.active          = true;
+   }
+   else if (!vk->context->swap_interval_emulation_lock)
+      vk->hard_sync.active          = false;
+
    if (!vk->context->swap_interval_emulation_lock)
    {
       if (vk->ctx_driver->update_window_title)
@@ -2260,16 +2467,32 @@ static bool vulkan_frame(void *data, const void *frame,
 
    vulkan_check_swapchain(vk);
 
-   /* Disable BFI during fast forward, slow-motion,
-    * and pause to prevent flicker. */
+   /* Disable BFI/frame duplication during fast forward,
+    * slow-motion, and pause to prevent flicker. */
    if (
          backbuffer->image != VK_NULL_HANDLE
          && vk->context->has_acquired_swapchain
-         && black_frame_insertion
          && !input_driver_nonblock_state
          && !runloop_is_slowmotion
          && !runloop_is_paused)
-      vulkan_inject_black_frame(vk, video_info, vk->ctx_data);
+   {
+      if (black_frame_insertion)
+         vulkan_inject_black_frame(vk, video_info, vk->ctx_data);
+      else if (  frame_duplication
+              && !vk->context->swap_interval_emulation_lock)
+      {
+         /* Re-present the frame just rendered, reusing the
+          * frame-duping path of the swap interval emulation. */
+         vk->context->swap_interval_emulation_lock = true;
+         if (!vulkan_frame(vk, NULL, 0, 0, frame_count, 0, msg,
+                  video_info))
+         {
+            vk->context->swap_interval_emulation_lock = false;
+            return false;
+         }
+         vk->context->swap_interval_emulation_lock = false;
+      }
+   }
 
    /* Vulkan doesn't directly support swap_interval > 1, 
     * so we fake it by duping out more frames. */
@@ -2382,18 +2605,46 @@ static bool vulkan_get_hw_render_interface(void *data,
    return vk->hw.enable;
 }
 
+static bool vulkan_get_shader_pass_profile(void *data, char *s, size_t len)
+{
+   size_t written = 0;
+   bool ret       = false;
+   vk_t *vk       = (vk_t*)data;
+
+   if (!vk)
+      return false;
+
+   if (vk->filter_chain)
+      ret = vulkan_filter_chain_get_pass_profile(
+            (vulkan_filter_chain_t*)vk->filter_chain, s, len);
+   if (!ret)
+      s[0] = '\0';
+
+   if (vk->hard_sync.active)
+   {
+      written = strlen(s);
+      snprintf(s + written, len - written,
+            "GPU Hard Sync:\n -Fence wait: %.2f ms (last: %.2f ms)\n",
+            (double)vk->hard_sync.fence_wait_avg  / 1000.0,
+            (double)vk->hard_sync.fence_wait_last / 1000.0);
+      ret = true;
+   }
+
+   return ret;
+}
+
 static void vulkan_set_texture_frame(void *data,
       const void *frame, bool rgb32, unsigned width, unsigned height,
       float alpha)
 {
    unsigned y, stride;
-   uint8_t *ptr                        = NULL;
    uint8_t *dst                        = NULL;
    const uint8_t *src                  = NULL;
    vk_t *vk                            = (vk_t*)data;
    unsigned index                      = 0;
    struct vk_texture *texture          = NULL;
    struct vk_texture *texture_optimal  = NULL;
+   VkFormat fmt                        = VK_FORMAT_B8G8R8A8_UNORM;
    const VkComponentMapping br_swizzle = {
       VK_COMPONENT_SWIZZLE_B,
       VK_COMPONENT_SWIZZLE_G,
@@ -2407,43 +2658,50 @@ static void vulkan_set_texture_frame(void *data,
    index           = vk->context->current_frame_index;
    texture         = &vk->menu.textures[index];
    texture_optimal = &vk->menu.textures_optimal[index];
+   if (!rgb32)
+      fmt          = VK_FORMAT_B4G4R4A4_UNORM_PACK16;
+
+   /* As with the swapchain staging ring, recreate the texture only when
+    * the menu framebuffer changes shape and keep it persistently mapped,
+    * instead of recreating and mapping/unmapping it every frame. */
+   if (     texture->width  != width
+         || texture->height != height
+         || texture->format != fmt)
+   {
+      /* B4G4R4A4 must be supported, but R4G4B4A4 is optional,
+       * just apply the swizzle in the image view instead. */
+      *texture = vulkan_create_texture(vk,
+            texture->memory ? texture : NULL,
+            width, height, fmt,
+            NULL, rgb32 ? NULL : &br_swizzle,
+            texture_optimal->memory
+            ? VULKAN_TEXTURE_STAGING : VULKAN_TEXTURE_STREAMED);
 
-   /* B4G4R4A4 must be supported, but R4G4B4A4 is optional,
-    * just apply the swizzle in the image view instead. */
-   *texture = vulkan_create_texture(vk,
-         texture->memory ? texture : NULL,
-         width, height,
-         rgb32 ? VK_FORMAT_B8G8R8A8_UNORM : VK_FORMAT_B4G4R4A4_UNORM_PACK16,
-         NULL, rgb32 ? NULL : &br_swizzle,
-         texture_optimal->memory ? VULKAN_TEXTURE_STAGING : VULKAN_TEXTURE_STREAMED);
+      VK_MAP_PERSISTENT_TEXTURE(vk->context->device, texture);
 
-   vkMapMemory(vk->context->device, texture->memory,
-         texture->offset, texture->size, 0, (void**)&ptr);
+      if (texture->type == VULKAN_TEXTURE_STAGING)
+         *texture_optimal = vulkan_create_texture(vk,
+               texture_optimal->memory ? texture_optimal : NULL,
+               width, height, fmt,
+               NULL, rgb32 ? NULL : &br_swizzle,
+               VULKAN_TEXTURE_DYNAMIC);
+   }
 
-   dst       = ptr;
+   dst       = (uint8_t*)texture->mapped;
    src       = (const uint8_t*)frame;
    stride    = (rgb32 ? sizeof(uint32_t) : sizeof(uint16_t)) * width;
 
    for (y = 0; y < height; y++, dst += texture->stride, src += stride)
       memcpy(dst, src, stride);
 
-   vk->menu.alpha      = alpha;
-   vk->menu.last_index = index;
-
-   if (texture->type == VULKAN_TEXTURE_STAGING)
-   {
-      *texture_optimal = vulkan_create_texture(vk,
-            texture_optimal->memory ? texture_optimal : NULL,
-            width, height,
-            rgb32 ? VK_FORMAT_B8G8R8A8_UNORM : VK_FORMAT_B4G4R4A4_UNORM_PACK16,
-            NULL, rgb32 ? NULL : &br_swizzle,
-            VULKAN_TEXTURE_DYNAMIC);
-   }
-   else if (texture->need_manual_cache_management
+   /* The staging path syncs in vulkan_copy_staging_to_dynamic(). */
+   if (texture->type != VULKAN_TEXTURE_STAGING
+         && texture->need_manual_cache_management
          && texture->memory != VK_NULL_HANDLE)
        VULKAN_SYNC_TEXTURE_TO_GPU(vk->context->device, texture->memory);
 
-   vkUnmapMemory(vk->context->device, texture->memory);
+   vk->menu.alpha        = alpha;
+   vk->menu.last_index   = index;
    vk->menu.dirty[index] = true;
 }
 
@@ -2549,6 +2807,7 @@ static uint32_t vulkan_get_flags(void *data)
    BIT32_SET(flags, GFX_CTX_FLAGS_BLACK_FRAME_INSERTION);
    BIT32_SET(flags, GFX_CTX_FLAGS_MENU_FRAME_FILTERING);
    BIT32_SET(flags, GFX_CTX_FLAGS_SCREENSHOTS_SUPPORTED);
+   BIT32_SET(flags, GFX_CTX_FLAGS_HARD_SYNC);
 
    return flags;
 }
@@ -2602,6 +2861,7 @@ static const video_poke_interface_t vulkan_poke_interface = {
    vulkan_get_current_shader,
    vulkan_get_current_sw_framebuffer,
    vulkan_get_hw_render_interface,
+   vulkan_get_shader_pass_profile,
 };
 
 static void vulkan_get_poke_interface(void *data,
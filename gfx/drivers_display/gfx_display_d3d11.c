@@ -45,15 +45,13 @@ static void* gfx_display_d3d11_get_default_mvp(void *data)
 static void gfx_display_d3d11_blend_begin(void *data)
 {
    d3d11_video_t* d3d11 = (d3d11_video_t*)data;
-   D3D11SetBlendState(d3d11->context,
-         d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+   d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
 }
 
 static void gfx_display_d3d11_blend_end(void *data)
 {
    d3d11_video_t* d3d11 = (d3d11_video_t*)data;
-   D3D11SetBlendState(d3d11->context,
-         d3d11->blend_disable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+   d3d11_set_blend_cached(d3d11, d3d11->blend_disable);
 }
 
 static void gfx_display_d3d11_viewport(gfx_display_ctx_draw_t *draw, void *data) { }
@@ -75,11 +73,11 @@ static void gfx_display_d3d11_draw(gfx_display_ctx_draw_t *draw,
       case VIDEO_SHADER_MENU_4:
       case VIDEO_SHADER_MENU_5:
       case VIDEO_SHADER_MENU_6:
-         d3d11_set_shader(d3d11->context, &d3d11->shaders[draw->pipeline_id]);
+         d3d11_set_shader_cached(d3d11, &d3d11->shaders[draw->pipeline_id]);
          D3D11Draw(d3d11->context, draw->coords->vertices, 0);
 
-         D3D11SetBlendState(d3d11->context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
-         d3d11_set_shader(d3d11->context, &d3d11->sprites.shader);
+         d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
+         d3d11_set_shader_cached(d3d11, &d3d11->sprites.shader);
          D3D11SetVertexBuffer(d3d11->context, 0, d3d11->sprites.vbo, sizeof(d3d11_sprite_t), 0);
          D3D11SetPrimitiveTopology(d3d11->context, D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
          return;
@@ -93,15 +91,21 @@ static void gfx_display_d3d11_draw(gfx_display_ctx_draw_t *draw,
    if (!d3d11->sprites.enabled || vertex_count > d3d11->sprites.capacity)
       return;
 
-   if (d3d11->sprites.offset + vertex_count > d3d11->sprites.capacity)
-      d3d11->sprites.offset = 0;
-
    {
       D3D11_MAPPED_SUBRESOURCE mapped_vbo;
-      d3d11_sprite_t*          sprite = NULL;
+      d3d11_sprite_t*          sprite     = NULL;
+      D3D11_MAP                map_type   = D3D11_MAP_WRITE_NO_OVERWRITE;
+
+      /* On wrap-around, orphan the buffer instead of overwriting
+       * vertices the GPU may still be reading. */
+      if (d3d11->sprites.offset + vertex_count > d3d11->sprites.capacity)
+      {
+         d3d11->sprites.offset = 0;
+         map_type              = D3D11_MAP_WRITE_DISCARD;
+      }
 
       D3D11MapBuffer(
-            d3d11->context, d3d11->sprites.vbo, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped_vbo);
+            d3d11->context, d3d11->sprites.vbo, 0, map_type, 0, &mapped_vbo);
 
       sprite = (d3d11_sprite_t*)mapped_vbo.pData + d3d11->sprites.offset;
 
@@ -160,7 +164,7 @@ static void gfx_display_d3d11_draw(gfx_display_ctx_draw_t *draw,
             sprite++;
          }
 
-         d3d11_set_shader(d3d11->context, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
+         d3d11_set_shader_cached(d3d11, &d3d11->shaders[VIDEO_SHADER_STOCK_BLEND]);
          D3D11SetPrimitiveTopology(d3d11->context, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
       }
 
@@ -173,7 +177,7 @@ static void gfx_display_d3d11_draw(gfx_display_ctx_draw_t *draw,
 
    if (vertex_count > 1)
    {
-      d3d11_set_shader(d3d11->context, &d3d11->sprites.shader);
+      d3d11_set_shader_cached(d3d11, &d3d11->sprites.shader);
       D3D11SetPrimitiveTopology(d3d11->context, D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
    }
 
@@ -209,7 +213,7 @@ static void gfx_display_d3d11_draw_pipeline(gfx_display_ctx_draw_t *draw,
          }
          D3D11SetVertexBuffer(d3d11->context, 0, d3d11->menu_pipeline_vbo, 2 * sizeof(float), 0);
          draw->coords->vertices = ca->coords.vertices;
-         D3D11SetBlendState(d3d11->context, d3d11->blend_pipeline, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+         d3d11_set_blend_cached(d3d11, d3d11->blend_pipeline);
          break;
       }
 
@@ -130,17 +130,23 @@ static void d3d11_font_render_line(
 {
    unsigned                 i, count;
    D3D11_MAPPED_SUBRESOURCE mapped_vbo;
-   d3d11_sprite_t*          v      = NULL;
-   int                      x      = roundf(pos_x * width);
-   int                      y      = roundf((1.0 - pos_y) * height);
+   d3d11_sprite_t*          v        = NULL;
+   D3D11_MAP                map_type = D3D11_MAP_WRITE_NO_OVERWRITE;
+   int                      x        = roundf(pos_x * width);
+   int                      y        = roundf((1.0 - pos_y) * height);
 
    if (  !d3d11                  ||
          !d3d11->sprites.enabled ||
          msg_len > (unsigned)d3d11->sprites.capacity)
       return;
 
+   /* On wrap-around, orphan the buffer instead of overwriting
+    * vertices the GPU may still be reading. */
    if (d3d11->sprites.offset + msg_len > (unsigned)d3d11->sprites.capacity)
+   {
       d3d11->sprites.offset = 0;
+      map_type              = D3D11_MAP_WRITE_DISCARD;
+   }
 
    switch (text_align)
    {
@@ -153,7 +159,7 @@ static void d3d11_font_render_line(
          break;
    }
 
-   D3D11MapBuffer(d3d11->context, d3d11->sprites.vbo, 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mapped_vbo);
+   D3D11MapBuffer(d3d11->context, d3d11->sprites.vbo, 0, map_type, 0, &mapped_vbo);
    v = (d3d11_sprite_t*)mapped_vbo.pData + d3d11->sprites.offset;
 
    for (i = 0; i < msg_len; i++)
@@ -213,7 +219,7 @@ static void d3d11_font_render_line(
    }
 
    d3d11_set_texture_and_sampler(d3d11->context, 0, &font->texture);
-   D3D11SetBlendState(d3d11->context, d3d11->blend_enable, NULL, D3D11_DEFAULT_SAMPLE_MASK);
+   d3d11_set_blend_cached(d3d11, d3d11->blend_enable);
 
    D3D11SetPShader(d3d11->context, d3d11->sprites.shader_font.ps, NULL, 0);
    D3D11Draw(d3d11->context, count, d3d11->sprites.offset);
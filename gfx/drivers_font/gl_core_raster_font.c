@@ -97,6 +97,22 @@ static bool gl_core_raster_font_upload_atlas(gl_core_raster_t *font)
    return true;
 }
 
+static void gl_core_raster_font_upload_atlas_rows(
+      gl_core_raster_t *font, unsigned y0, unsigned y1)
+{
+   if (y1 > font->atlas->height)
+      y1 = font->atlas->height;
+   if (y0 >= y1)
+      return;
+
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+   glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0,
+                   font->atlas->width, y1 - y0, GL_RED, GL_UNSIGNED_BYTE,
+                   font->atlas->buffer + y0 * font->atlas->width);
+}
+
 static void *gl_core_raster_font_init_font(void *data,
       const char *font_path, float font_size,
       bool is_threaded)
@@ -129,7 +145,9 @@ static void *gl_core_raster_font_init_font(void *data,
    if (!gl_core_raster_font_upload_atlas(font))
       goto error;
 
-   font->atlas->dirty = false;
+   font->atlas->dirty    = false;
+   font->atlas->dirty_y0 = 0;
+   font->atlas->dirty_y1 = 0;
    return font;
 
 error:
@@ -170,15 +188,26 @@ static int gl_core_get_message_width(void *data, const char *msg,
 static void gl_core_raster_font_draw_vertices(gl_core_raster_t *font,
       const video_coords_t *coords)
 {
+   glActiveTexture(GL_TEXTURE1);
+   glBindTexture(GL_TEXTURE_2D, font->tex);
+
    if (font->atlas->dirty)
    {
-      gl_core_raster_font_upload_atlas(font);
-      font->atlas->dirty   = false;
+      /* Sub-upload the dirty row span when the renderer
+       * tracked it; fall back to a full upload otherwise. */
+      if (font->atlas->dirty_y1 > font->atlas->dirty_y0)
+         gl_core_raster_font_upload_atlas_rows(font,
+               font->atlas->dirty_y0, font->atlas->dirty_y1);
+      else
+      {
+         gl_core_raster_font_upload_atlas(font);
+         glBindTexture(GL_TEXTURE_2D, font->tex);
+      }
+      font->atlas->dirty    = false;
+      font->atlas->dirty_y0 = 0;
+      font->atlas->dirty_y1 = 0;
    }
 
-   glActiveTexture(GL_TEXTURE1);
-   glBindTexture(GL_TEXTURE_2D, font->tex);
-
    if (  font->gl &&
          font->gl->pipelines.font_loc.flat_ubo_vertex >= 0)
       glUniform4fv(font->gl->pipelines.font_loc.flat_ubo_vertex,
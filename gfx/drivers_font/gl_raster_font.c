@@ -178,6 +178,70 @@ static bool gl_raster_font_upload_atlas(gl_raster_t *font)
    return true;
 }
 
+/* Uploads only atlas rows [y0, y1) - used when glyphs
+ * stream into an already uploaded atlas, so a single new
+ * glyph does not force re-uploading the whole texture. */
+static bool gl_raster_font_upload_atlas_rows(gl_raster_t *font,
+      unsigned y0, unsigned y1)
+{
+   unsigned i, j;
+   GLenum gl_format                     = GL_LUMINANCE_ALPHA;
+   size_t ncomponents                   = 2;
+   uint8_t       *tmp                   = NULL;
+#if defined(GL_VERSION_3_0)
+   struct retro_hw_render_callback *hwr = video_driver_get_hw_context();
+
+   if ((font->gl && font->gl->core_context_in_use) ||
+         (hwr->context_type == RETRO_HW_CONTEXT_OPENGL &&
+          hwr->version_major >= 3))
+   {
+      gl_format   = GL_RED;
+      ncomponents = 1;
+   }
+#endif
+
+   if (y1 > font->atlas->height)
+      y1 = font->atlas->height;
+   if (y0 >= y1)
+      return true;
+
+   tmp = (uint8_t*)calloc(y1 - y0, font->atlas->width * ncomponents);
+
+   if (!tmp)
+      return false;
+
+   switch (ncomponents)
+   {
+      case 1:
+         for (i = y0; i < y1; ++i)
+            memcpy(&tmp[(i - y0) * font->atlas->width],
+                  &font->atlas->buffer[i * font->atlas->width],
+                  font->atlas->width);
+         break;
+      case 2:
+         for (i = y0; i < y1; ++i)
+         {
+            const uint8_t *src = &font->atlas->buffer[i * font->atlas->width];
+            uint8_t       *dst = &tmp[(i - y0) * font->atlas->width * ncomponents];
+
+            for (j = 0; j < font->atlas->width; ++j)
+            {
+               *dst++ = 0xff;
+               *dst++ = *src++;
+            }
+         }
+         break;
+   }
+
+   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y0,
+         font->atlas->width, y1 - y0,
+         gl_format, GL_UNSIGNED_BYTE, tmp);
+
+   free(tmp);
+
+   return true;
+}
+
 static void *gl_raster_font_init_font(void *data,
       const char *font_path, float font_size,
       bool is_threaded)
@@ -216,7 +280,9 @@ static void *gl_raster_font_init_font(void *data,
    if (!gl_raster_font_upload_atlas(font))
       goto error;
 
-   font->atlas->dirty = false;
+   font->atlas->dirty    = false;
+   font->atlas->dirty_y0 = 0;
+   font->atlas->dirty_y1 = 0;
 
    if (font->gl)
       glBindTexture(GL_TEXTURE_2D, font->gl->texture[font->gl->tex_index]);
@@ -265,8 +331,16 @@ static void gl_raster_font_draw_vertices(gl_raster_t *font,
 {
    if (font->atlas->dirty)
    {
-      gl_raster_font_upload_atlas(font);
-      font->atlas->dirty   = false;
+      /* Sub-upload the dirty row span when the renderer
+       * tracked it; fall back to a full upload otherwise. */
+      if (font->atlas->dirty_y1 > font->atlas->dirty_y0)
+         gl_raster_font_upload_atlas_rows(font,
+               font->atlas->dirty_y0, font->atlas->dirty_y1);
+      else
+         gl_raster_font_upload_atlas(font);
+      font->atlas->dirty    = false;
+      font->atlas->dirty_y0 = 0;
+      font->atlas->dirty_y1 = 0;
    }
 
    if (font->gl && font->gl->shader)
@@ -22,6 +22,7 @@
 
 #include <ft2build.h>
 
+#include <encodings/crc32.h>
 #include <file/file_path.h>
 #include <streams/file_stream.h>
 #include <retro_miscellaneous.h>
@@ -34,9 +35,44 @@
 #include FT_FREETYPE_H
 #include "../font_driver.h"
 
+#include "../../configuration.h"
+#include "../../verbosity.h"
+
+/* The atlas is a grid of equally sized glyph slots,
+ * organised as FT_ATLAS_PAGES stacked pages of
+ * FT_ATLAS_ROWS * FT_ATLAS_COLS slots inside a single
+ * texture. One page is enough for Latin text; the extra
+ * pages give CJK text room to stream in new glyphs via
+ * LRU eviction without thrashing the slots that are
+ * still on screen. */
 #define FT_ATLAS_ROWS 16
 #define FT_ATLAS_COLS 16
-#define FT_ATLAS_SIZE (FT_ATLAS_ROWS * FT_ATLAS_COLS)
+#define FT_ATLAS_PAGES 4
+#define FT_ATLAS_SIZE (FT_ATLAS_ROWS * FT_ATLAS_COLS * FT_ATLAS_PAGES)
+
+/* Persistent glyph atlas cache
+ * > The glyph set rasterized during atlas prefill is
+ *   written to the cache directory and blitted straight
+ *   back into a fresh atlas on the next run, so a warm
+ *   boot spends no FreeType rasterization time in init
+ * > Files are keyed by font identity and pixel size;
+ *   headers that do not match the current atlas
+ *   geometry or load flags are discarded */
+#define FT_ATLAS_CACHE_MAGIC   0x43414652 /* 'RFAC' */
+#define FT_ATLAS_CACHE_VERSION 1
+
+/* Fixed-size on-disk glyph record, followed by
+ * width * height bitmap bytes. */
+struct ft_atlas_cache_glyph
+{
+   uint32_t charcode;
+   uint32_t width;
+   uint32_t height;
+   int32_t  draw_offset_x;
+   int32_t  draw_offset_y;
+   int32_t  advance_x;
+   int32_t  advance_y;
+};
 
 typedef struct freetype_atlas_slot
 {
@@ -163,14 +199,221 @@ static const struct font_glyph *font_renderer_ft_get_glyph(
             dst[c] = src[c];
    }
 
-   handle->atlas.dirty = true;
+   /* Track the dirty row span so backends can
+    * sub-upload just the touched rows. */
+   font_atlas_mark_dirty(&handle->atlas,
+         atlas_slot->glyph.atlas_offset_y,
+         atlas_slot->glyph.atlas_offset_y + atlas_slot->glyph.height);
    atlas_slot->last_used = handle->usage_counter++;
    return &atlas_slot->glyph;
 }
 
-static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_size)
+static void font_renderer_ft_get_cache_path(
+      const char *font_path, unsigned size_px, char *s, size_t len)
+{
+   char name[64];
+   uint32_t hash;
+   int32_t file_size    = 0;
+   settings_t *settings = config_get_ptr();
+
+   s[0] = '\0';
+
+   if (     string_is_empty(font_path)
+         || string_is_empty(settings->paths.directory_cache))
+      return;
+
+   /* Identity hash covers the path and the file size;
+    * hashing the font contents themselves would read
+    * back the very data the cache exists to skip. */
+   file_size = path_get_size(font_path);
+   hash      = encoding_crc32(0, (const uint8_t*)font_path,
+         strlen(font_path));
+   hash      = encoding_crc32(hash, (const uint8_t*)&file_size,
+         sizeof(file_size));
+
+   snprintf(name, sizeof(name), "freetype_%08x_%u.atlas",
+         (unsigned)hash, size_px);
+   fill_pathname_join(s, settings->paths.directory_cache, name, len);
+}
+
+static bool font_renderer_ft_load_atlas_cache(
+      ft_font_renderer_t *handle, const char *cache_path)
+{
+   uint32_t i, count;
+   const uint32_t *header;
+   const uint8_t *ptr;
+   const uint8_t *end;
+   unsigned slot_width;
+   unsigned slot_height;
+   void *buf   = NULL;
+   int64_t len = 0;
+
+   if (     string_is_empty(cache_path)
+         || !path_is_valid(cache_path))
+      return false;
+
+   if (!filestream_read_file(cache_path, &buf, &len) || !buf)
+      return false;
+
+   header = (const uint32_t*)buf;
+
+   /* Header: magic, version, load flags,
+    * atlas width, atlas height, glyph count */
+   if (    (len < (int64_t)(6 * sizeof(uint32_t)))
+        || (header[0] != FT_ATLAS_CACHE_MAGIC)
+        || (header[1] != FT_ATLAS_CACHE_VERSION)
+        || (header[2] != (uint32_t)FT_LOAD_RENDER)
+        || (header[3] != handle->atlas.width)
+        || (header[4] != handle->atlas.height))
+   {
+      RARCH_WARN("[FreeType]: Ignoring stale glyph atlas cache.\n");
+      free(buf);
+      return false;
+   }
+
+   count       = header[5];
+   ptr         = (const uint8_t*)(header + 6);
+   end         = (const uint8_t*)buf + len;
+   slot_width  = handle->atlas.width  / FT_ATLAS_COLS;
+   slot_height = handle->atlas.height / (FT_ATLAS_ROWS * FT_ATLAS_PAGES);
+
+   for (i = 0; i < count; i++)
+   {
+      unsigned r;
+      struct ft_atlas_cache_glyph rec;
+      freetype_atlas_slot_t *atlas_slot;
+      unsigned map_id;
+      uint8_t *dst;
+
+      if (ptr + sizeof(rec) > end)
+         break;
+      memcpy(&rec, ptr, sizeof(rec));
+      ptr += sizeof(rec);
+
+      /* A record that does not fit its slot means the
+       * file is corrupt - stop and let the caller
+       * rasterize normally. */
+      if (     (rec.width  > slot_width)
+            || (rec.height > slot_height)
+            || (ptr + rec.width * rec.height > end))
+         break;
+
+      atlas_slot                      = font_renderer_get_slot(handle);
+      atlas_slot->charcode            = rec.charcode;
+      atlas_slot->glyph.width         = rec.width;
+      atlas_slot->glyph.height        = rec.height;
+      atlas_slot->glyph.draw_offset_x = rec.draw_offset_x;
+      atlas_slot->glyph.draw_offset_y = rec.draw_offset_y;
+      atlas_slot->glyph.advance_x     = rec.advance_x;
+      atlas_slot->glyph.advance_y     = rec.advance_y;
+
+      map_id                          = rec.charcode & 0xFF;
+      atlas_slot->next                = handle->uc_map[map_id];
+      handle->uc_map[map_id]          = atlas_slot;
+
+      dst = (uint8_t*)handle->atlas.buffer
+            + atlas_slot->glyph.atlas_offset_x
+            + atlas_slot->glyph.atlas_offset_y * handle->atlas.width;
+
+      for (r = 0; r < rec.height;
+            r++, dst += handle->atlas.width, ptr += rec.width)
+         memcpy(dst, ptr, rec.width);
+
+      atlas_slot->last_used = handle->usage_counter++;
+   }
+
+   free(buf);
+
+   if (i != count)
+      return false;
+
+   font_atlas_mark_dirty(&handle->atlas, 0, handle->atlas.height);
+   RARCH_LOG("[FreeType]: Restored %u glyphs from atlas cache.\n",
+         count);
+   return true;
+}
+
+static void font_renderer_ft_save_atlas_cache(
+      ft_font_renderer_t *handle, const char *cache_path)
+{
+   unsigned i;
+   uint32_t header[6];
+   freetype_atlas_slot_t *slot;
+   uint32_t count  = 0;
+   uint8_t *row_buf = NULL;
+   RFILE *file     = NULL;
+
+   if (string_is_empty(cache_path))
+      return;
+
+   for (i = 0; i < 0x100; i++)
+      for (slot = handle->uc_map[i]; slot; slot = slot->next)
+         count++;
+
+   if (!count)
+      return;
+
+   row_buf = (uint8_t*)malloc(
+           (handle->atlas.width  / FT_ATLAS_COLS)
+         * (handle->atlas.height / (FT_ATLAS_ROWS * FT_ATLAS_PAGES)));
+   if (!row_buf)
+      return;
+
+   file = filestream_open(cache_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+   {
+      free(row_buf);
+      return;
+   }
+
+   header[0] = FT_ATLAS_CACHE_MAGIC;
+   header[1] = FT_ATLAS_CACHE_VERSION;
+   header[2] = (uint32_t)FT_LOAD_RENDER;
+   header[3] = handle->atlas.width;
+   header[4] = handle->atlas.height;
+   header[5] = count;
+
+   filestream_write(file, header, sizeof(header));
+
+   for (i = 0; i < 0x100; i++)
+   {
+      for (slot = handle->uc_map[i]; slot; slot = slot->next)
+      {
+         unsigned r;
+         struct ft_atlas_cache_glyph rec;
+         const uint8_t *src = (const uint8_t*)handle->atlas.buffer
+               + slot->glyph.atlas_offset_x
+               + slot->glyph.atlas_offset_y * handle->atlas.width;
+
+         rec.charcode      = slot->charcode;
+         rec.width         = slot->glyph.width;
+         rec.height        = slot->glyph.height;
+         rec.draw_offset_x = slot->glyph.draw_offset_x;
+         rec.draw_offset_y = slot->glyph.draw_offset_y;
+         rec.advance_x     = slot->glyph.advance_x;
+         rec.advance_y     = slot->glyph.advance_y;
+
+         /* Pack the slot's rows tightly so the file only
+          * stores real glyph texels. */
+         for (r = 0; r < rec.height; r++, src += handle->atlas.width)
+            memcpy(row_buf + r * rec.width, src, rec.width);
+
+         filestream_write(file, &rec, sizeof(rec));
+         filestream_write(file, row_buf, rec.width * rec.height);
+      }
+   }
+
+   filestream_close(file);
+   free(row_buf);
+}
+
+static bool font_renderer_create_atlas(ft_font_renderer_t *handle,
+      const char *font_path, float font_size)
 {
    unsigned i, x, y;
+   char cache_path[PATH_MAX_LENGTH];
    freetype_atlas_slot_t* slot = NULL;
 
    unsigned max_width = round((handle->face->bbox.xMax - handle->face->bbox.xMin) * font_size / handle->face->units_per_EM);
@@ -178,7 +421,7 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
 
    unsigned atlas_width        = max_width  * FT_ATLAS_COLS;
 
-   unsigned atlas_height       = max_height * FT_ATLAS_ROWS;
+   unsigned atlas_height       = max_height * FT_ATLAS_ROWS * FT_ATLAS_PAGES;
 
    uint8_t *atlas_buffer       = (uint8_t*)
       calloc(atlas_width * atlas_height, 1);
@@ -191,7 +434,7 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
    handle->atlas.height        = atlas_height;
    slot                        = handle->atlas_slots;
 
-   for (y = 0; y < FT_ATLAS_ROWS; y++)
+   for (y = 0; y < FT_ATLAS_ROWS * FT_ATLAS_PAGES; y++)
    {
       for (x = 0; x < FT_ATLAS_COLS; x++)
       {
@@ -201,13 +444,21 @@ static bool font_renderer_create_atlas(ft_font_renderer_t *handle, float font_si
       }
    }
 
-   for (i = 0; i < 256; i++)
-      font_renderer_ft_get_glyph(handle, i);
+   font_renderer_ft_get_cache_path(font_path, (unsigned)font_size,
+         cache_path, sizeof(cache_path));
 
-   for (i = 0; i < 256; i++)
-      if (isalnum(i))
+   if (!font_renderer_ft_load_atlas_cache(handle, cache_path))
+   {
+      for (i = 0; i < 256; i++)
          font_renderer_ft_get_glyph(handle, i);
 
+      for (i = 0; i < 256; i++)
+         if (isalnum(i))
+            font_renderer_ft_get_glyph(handle, i);
+
+      font_renderer_ft_save_atlas_cache(handle, cache_path);
+   }
+
    return true;
 }
 
@@ -259,7 +510,7 @@ static void *font_renderer_ft_init(const char *font_path, float font_size)
    if (err)
       goto error;
 
-   if (!font_renderer_create_atlas(handle, font_size))
+   if (!font_renderer_create_atlas(handle, font_path, font_size))
       goto error;
 
    handle->line_metrics.ascender  = (float)handle->face->size->metrics.ascender / 64.0f;
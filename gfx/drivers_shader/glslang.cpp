@@ -45,11 +45,16 @@ struct SlangProcess
       TBuiltInResource Resources;
 };
 
-/* We don't use glslang from multiple threads, but to be sure.
- * Initializing TLS and freeing it for glslang works around 
- * a really bizarre issue where the TLS key is suddenly 
+/* Initializing TLS and freeing it for glslang works around
+ * a really bizarre issue where the TLS key is suddenly
  * corrupted *somehow*.
- */
+ *
+ * glslang reference counts InitializeProcess()/FinalizeProcess()
+ * internally and parse/link is thread safe as long as every
+ * thread works on its own TShader/TProgram instances, so the
+ * lock only needs to cover process setup/teardown - holding it
+ * for the duration of the compile would serialize the parallel
+ * preset compile path. */
 static std::mutex glslang_global_lock;
 
 struct SlangProcessHolder
@@ -58,10 +63,12 @@ struct SlangProcessHolder
    {
       glslang_global_lock.lock();
       InitializeProcess();
+      glslang_global_lock.unlock();
    }
 
    ~SlangProcessHolder()
    {
+      glslang_global_lock.lock();
       FinalizeProcess();
       glslang_global_lock.unlock();
    }
@@ -13,6 +13,7 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include <retro_miscellaneous.h>
@@ -25,6 +26,10 @@
 #include "config.h"
 #endif
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #include "glslang_util.h"
 #include "../../verbosity.h"
 
@@ -86,6 +91,169 @@ static void get_include_file(
    strlcpy(include_file, start, len);
 }
 
+/* Shader file cache
+ * > Multi-pass presets tend to #include the same
+ *   .inc files from every pass; while the cache is
+ *   active, each file is only read from disk once
+ * > The cache is scoped to a preset compile via
+ *   begin/end (reference counted, so nesting is
+ *   fine) - nothing is held across compiles, which
+ *   also means edited shaders are always re-read */
+
+#define GLSLANG_FILE_CACHE_MAX_ENTRIES 64
+
+struct glslang_file_cache_entry
+{
+   char *path;
+   uint8_t *data;
+   int64_t len;
+};
+
+/* TODO/FIXME - static global variables */
+static struct glslang_file_cache_entry
+      glslang_file_cache[GLSLANG_FILE_CACHE_MAX_ENTRIES];
+static size_t glslang_file_cache_size  = 0;
+static unsigned glslang_file_cache_users = 0;
+#ifdef HAVE_THREADS
+static slock_t *glslang_file_cache_lock  = NULL;
+#endif
+
+static void glslang_file_cache_mutex_lock(void)
+{
+#ifdef HAVE_THREADS
+   if (glslang_file_cache_lock)
+      slock_lock(glslang_file_cache_lock);
+#endif
+}
+
+static void glslang_file_cache_mutex_unlock(void)
+{
+#ifdef HAVE_THREADS
+   if (glslang_file_cache_lock)
+      slock_unlock(glslang_file_cache_lock);
+#endif
+}
+
+void glslang_shader_file_cache_begin(void)
+{
+#ifdef HAVE_THREADS
+   if (!glslang_file_cache_lock)
+      glslang_file_cache_lock = slock_new();
+#endif
+   glslang_file_cache_mutex_lock();
+   glslang_file_cache_users++;
+   glslang_file_cache_mutex_unlock();
+}
+
+void glslang_shader_file_cache_end(void)
+{
+   glslang_file_cache_mutex_lock();
+
+   if (glslang_file_cache_users > 0)
+      glslang_file_cache_users--;
+
+   if (glslang_file_cache_users == 0)
+   {
+      size_t i;
+      for (i = 0; i < glslang_file_cache_size; i++)
+      {
+         free(glslang_file_cache[i].path);
+         free(glslang_file_cache[i].data);
+         glslang_file_cache[i].path = NULL;
+         glslang_file_cache[i].data = NULL;
+      }
+      glslang_file_cache_size = 0;
+   }
+
+   glslang_file_cache_mutex_unlock();
+}
+
+/* Reads a shader file into a heap buffer owned by the
+ * caller, consulting/populating the cache when one is
+ * active. The buffer is always a private copy, since
+ * glslang_read_shader_file() splits it in place. */
+static bool glslang_read_shader_file_data(const char *path,
+      uint8_t **buf, int64_t *buf_len)
+{
+   size_t i;
+
+   glslang_file_cache_mutex_lock();
+
+   if (glslang_file_cache_users > 0)
+   {
+      for (i = 0; i < glslang_file_cache_size; i++)
+      {
+         if (string_is_equal(glslang_file_cache[i].path, path))
+         {
+            /* filestream_read_file() NUL terminates one
+             * byte past the reported length - preserve that */
+            uint8_t *copy = (uint8_t*)malloc(
+                  (size_t)glslang_file_cache[i].len + 1);
+
+            if (!copy)
+               break;
+
+            memcpy(copy, glslang_file_cache[i].data,
+                  (size_t)glslang_file_cache[i].len + 1);
+            *buf     = copy;
+            *buf_len = glslang_file_cache[i].len;
+
+            glslang_file_cache_mutex_unlock();
+            return true;
+         }
+      }
+   }
+
+   glslang_file_cache_mutex_unlock();
+
+   if (!filestream_read_file(path, (void**)buf, buf_len))
+      return false;
+
+   glslang_file_cache_mutex_lock();
+
+   if (     (glslang_file_cache_users > 0)
+         && (glslang_file_cache_size < GLSLANG_FILE_CACHE_MAX_ENTRIES)
+         && (*buf_len >= 0))
+   {
+      bool already_cached = false;
+
+      /* Another worker may have inserted this path
+       * while the file was being read */
+      for (i = 0; i < glslang_file_cache_size; i++)
+      {
+         if (string_is_equal(glslang_file_cache[i].path, path))
+         {
+            already_cached = true;
+            break;
+         }
+      }
+
+      if (!already_cached)
+      {
+         char *path_copy    = strdup(path);
+         uint8_t *data_copy = (uint8_t*)malloc((size_t)*buf_len + 1);
+
+         if (path_copy && data_copy)
+         {
+            memcpy(data_copy, *buf, (size_t)*buf_len + 1);
+            glslang_file_cache[glslang_file_cache_size].path = path_copy;
+            glslang_file_cache[glslang_file_cache_size].data = data_copy;
+            glslang_file_cache[glslang_file_cache_size].len  = *buf_len;
+            glslang_file_cache_size++;
+         }
+         else
+         {
+            free(path_copy);
+            free(data_copy);
+         }
+      }
+   }
+
+   glslang_file_cache_mutex_unlock();
+
+   return true;
+}
+
 bool slang_texture_semantic_is_array(enum slang_texture_semantic sem)
 {
    switch (sem)
@@ -161,7 +329,7 @@ bool glslang_read_shader_file(const char *path,
       return false;
 
    /* Read file contents */
-   if (!filestream_read_file(path, (void**)&buf, &buf_len))
+   if (!glslang_read_shader_file_data(path, &buf, &buf_len))
    {
       RARCH_ERR("Failed to open shader file: \"%s\".\n", path);
       return false;
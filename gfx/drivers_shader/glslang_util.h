@@ -123,6 +123,24 @@ enum glslang_format glslang_find_format(const char *fmt);
 bool glslang_read_shader_file(const char *path,
       struct string_list *output, bool root_file);
 
+/* Enables/disables caching of raw shader file
+ * contents, so .inc files shared between the passes
+ * of a preset are only read from disk once. Calls
+ * are reference counted and may come from multiple
+ * threads; the cache is dropped once the last
+ * user calls end. */
+void glslang_shader_file_cache_begin(void);
+
+void glslang_shader_file_cache_end(void);
+
+/* Sets the directory used for the on-disk SPIR-V
+ * blob cache. Pass NULL/empty to disable caching. */
+void glslang_set_cache_directory(const char *dir);
+
+/* Compiles a shader purely to warm the SPIR-V blob
+ * cache. Safe to call from worker threads. */
+bool glslang_precompile_shader(const char *shader_path);
+
 bool slang_texture_semantic_is_array(enum slang_texture_semantic sem);
 
 enum slang_texture_semantic slang_name_to_texture_semantic_array(
@@ -17,8 +17,14 @@
 #include <string.h>
 #include <string>
 #include <algorithm>
+#include <vector>
+#ifdef HAVE_THREADS
+#include <atomic>
+#include <thread>
+#endif
 
 #include <retro_miscellaneous.h>
+#include <features/features_cpu.h>
 #include <file/file_path.h>
 #include <file/config_file.h>
 #include <streams/file_stream.h>
@@ -35,6 +41,152 @@
 #endif
 #include "../../verbosity.h"
 
+/* SPIR-V blob cache
+ * > glslang compilation of large multi-pass
+ *   presets takes on the order of a second; the
+ *   resulting SPIR-V is deterministic for a given
+ *   source, so it is cached on disk keyed by a
+ *   hash of the fully include-resolved source
+ * > The cache directory is provided by the video
+ *   driver; caching is disabled while it is unset */
+
+#define GLSLANG_SPIRV_CACHE_MAGIC   0x56505352 /* 'RSPV' */
+#define GLSLANG_SPIRV_CACHE_VERSION 1
+
+static char glslang_cache_directory[PATH_MAX_LENGTH];
+
+void glslang_set_cache_directory(const char *dir)
+{
+   if (string_is_empty(dir))
+      glslang_cache_directory[0] = '\0';
+   else
+      strlcpy(glslang_cache_directory, dir,
+            sizeof(glslang_cache_directory));
+}
+
+#if defined(HAVE_GLSLANG)
+static uint64_t glslang_source_hash(const struct string_list *lines)
+{
+   size_t i;
+   /* FNV-1a, line separators included so that
+    * line splits/joins alter the hash */
+   uint64_t hash = 0xCBF29CE484222325ULL;
+
+   for (i = 0; i < lines->size; i++)
+   {
+      const char *line = lines->elems[i].data;
+
+      for (; line && *line; line++)
+      {
+         hash ^= (uint8_t)*line;
+         hash *= 0x100000001B3ULL;
+      }
+
+      hash ^= (uint8_t)'\n';
+      hash *= 0x100000001B3ULL;
+   }
+
+   /* Compiler behaviour is part of the key */
+   hash ^= GLSLANG_SPIRV_CACHE_VERSION;
+   hash *= 0x100000001B3ULL;
+
+   return hash;
+}
+
+static void glslang_spirv_cache_path(char *s, size_t len, uint64_t hash)
+{
+   char name[64];
+
+   snprintf(name, sizeof(name), "slang-%08x%08x.spv",
+         (unsigned)(hash >> 32), (unsigned)(hash & 0xFFFFFFFF));
+
+   fill_pathname_join(s, glslang_cache_directory, name, len);
+}
+
+static bool glslang_read_spirv_cache(uint64_t hash,
+      std::vector<uint32_t> *vertex, std::vector<uint32_t> *fragment)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   void *buf   = NULL;
+   int64_t len = 0;
+   bool ret    = false;
+
+   if (string_is_empty(glslang_cache_directory))
+      return false;
+
+   cache_path[0] = '\0';
+   glslang_spirv_cache_path(cache_path, sizeof(cache_path), hash);
+
+   if (!path_is_valid(cache_path))
+      return false;
+
+   if (filestream_read_file(cache_path, &buf, &len) && buf)
+   {
+      const uint32_t *words = (const uint32_t*)buf;
+
+      /* Header: magic, version, vertex word count,
+       * fragment word count. The blob is only read
+       * back on the machine that wrote it, so
+       * native word order is fine */
+      if ((len >= (int64_t)(4 * sizeof(uint32_t))) &&
+          (words[0] == GLSLANG_SPIRV_CACHE_MAGIC)  &&
+          (words[1] == GLSLANG_SPIRV_CACHE_VERSION))
+      {
+         uint64_t vertex_words   = words[2];
+         uint64_t fragment_words = words[3];
+
+         if ((int64_t)((4 + vertex_words + fragment_words)
+                  * sizeof(uint32_t)) == len)
+         {
+            vertex->assign(words + 4,
+                  words + 4 + vertex_words);
+            fragment->assign(words + 4 + vertex_words,
+                  words + 4 + vertex_words + fragment_words);
+            ret = true;
+         }
+      }
+   }
+
+   if (buf)
+      free(buf);
+   return ret;
+}
+
+static void glslang_write_spirv_cache(uint64_t hash,
+      const std::vector<uint32_t> &vertex,
+      const std::vector<uint32_t> &fragment)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   uint32_t header[4];
+   RFILE *file = NULL;
+
+   if (string_is_empty(glslang_cache_directory))
+      return;
+
+   cache_path[0] = '\0';
+   glslang_spirv_cache_path(cache_path, sizeof(cache_path), hash);
+
+   file = filestream_open(cache_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!file)
+      return;
+
+   header[0] = GLSLANG_SPIRV_CACHE_MAGIC;
+   header[1] = GLSLANG_SPIRV_CACHE_VERSION;
+   header[2] = (uint32_t)vertex.size();
+   header[3] = (uint32_t)fragment.size();
+
+   filestream_write(file, header, sizeof(header));
+   filestream_write(file, vertex.data(),
+         vertex.size() * sizeof(uint32_t));
+   filestream_write(file, fragment.data(),
+         fragment.size() * sizeof(uint32_t));
+   filestream_close(file);
+}
+#endif
+
 static std::string build_stage_source(
       const struct string_list *lines, const char *stage)
 {
@@ -221,18 +373,38 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
 {
 #if defined(HAVE_GLSLANG)
    struct string_list lines;
-   
+   uint64_t hash = 0;
+   bool read_ok  = false;
+
    if (!string_list_initialize(&lines))
       return false;
 
-   RARCH_LOG("[slang]: Compiling shader \"%s\".\n", shader_path);
+   /* Harmless no-op when the caller already holds the
+    * file cache open - within a single pass this still
+    * collapses multiply-included files into one read */
+   glslang_shader_file_cache_begin();
+   read_ok = glslang_read_shader_file(shader_path, &lines, true);
+   glslang_shader_file_cache_end();
 
-   if (!glslang_read_shader_file(shader_path, &lines, true))
+   if (!read_ok)
       goto error;
    output->meta = glslang_meta{};
    if (!glslang_parse_meta(&lines, &output->meta))
       goto error;
 
+   /* Metadata is parsed from source above either
+    * way - only the expensive SPIR-V generation
+    * is served from the cache */
+   hash = glslang_source_hash(&lines);
+
+   if (glslang_read_spirv_cache(hash, &output->vertex, &output->fragment))
+   {
+      string_list_deinitialize(&lines);
+      return true;
+   }
+
+   RARCH_LOG("[slang]: Compiling shader \"%s\".\n", shader_path);
+
    if (!glslang::compile_spirv(build_stage_source(&lines, "vertex"),
             glslang::StageVertex, &output->vertex))
    {
@@ -247,6 +419,8 @@ bool glslang_compile_shader(const char *shader_path, glslang_output *output)
       goto error;
    }
 
+   glslang_write_spirv_cache(hash, output->vertex, output->fragment);
+
    string_list_deinitialize(&lines);
 
    return true;
@@ -257,3 +431,131 @@ error:
 
    return false;
 }
+
+bool glslang_compile_shader_passes(struct video_shader *shader,
+      std::vector<glslang_output> *outputs)
+{
+   unsigned i;
+   std::vector<unsigned> primary;
+   std::vector<uint8_t> success;
+
+   if (!shader || !outputs || !shader->passes)
+      return false;
+
+   outputs->clear();
+   outputs->resize(shader->passes);
+   primary.resize(shader->passes);
+   success.resize(shader->passes, 0);
+
+   /* Presets may reference the same source file from
+    * several passes - compile each unique file once and
+    * share the result */
+   for (i = 0; i < shader->passes; i++)
+   {
+      unsigned j;
+
+      primary[i] = i;
+
+      for (j = 0; j < i; j++)
+      {
+         if (string_is_equal(shader->pass[i].source.path,
+                  shader->pass[j].source.path))
+         {
+            primary[i] = primary[j];
+            break;
+         }
+      }
+   }
+
+   /* Keep .inc files shared between passes in memory
+    * for the duration of the preset compile */
+   glslang_shader_file_cache_begin();
+
+#ifdef HAVE_THREADS
+   {
+      std::atomic<unsigned> next_pass(0);
+
+      /* glslang's front end is embarrassingly parallel
+       * across passes - each worker owns its shader
+       * instances, and process init is reference counted */
+      auto compile_worker = [&]()
+      {
+         for (;;)
+         {
+            unsigned pass = next_pass.fetch_add(1);
+
+            if (pass >= shader->passes)
+               break;
+
+            if (primary[pass] != pass)
+               continue;
+
+            if (glslang_compile_shader(
+                     shader->pass[pass].source.path, &(*outputs)[pass]))
+               success[pass] = 1;
+         }
+      };
+
+      unsigned num_workers = cpu_features_get_core_amount();
+
+      if (num_workers > shader->passes)
+         num_workers = shader->passes;
+
+      if (num_workers > 1)
+      {
+         std::vector<std::thread> workers;
+
+         /* The calling thread participates as well */
+         for (i = 0; i < num_workers - 1; i++)
+            workers.emplace_back(compile_worker);
+
+         compile_worker();
+
+         for (auto &worker : workers)
+            worker.join();
+      }
+      else
+         compile_worker();
+   }
+#else
+   for (i = 0; i < shader->passes; i++)
+   {
+      if (primary[i] != i)
+         continue;
+
+      if (glslang_compile_shader(
+               shader->pass[i].source.path, &(*outputs)[i]))
+         success[i] = 1;
+   }
+#endif
+
+   glslang_shader_file_cache_end();
+
+   for (i = 0; i < shader->passes; i++)
+   {
+      if (primary[i] != i)
+      {
+         (*outputs)[i] = (*outputs)[primary[i]];
+         success[i]    = success[primary[i]];
+      }
+
+      if (!success[i])
+      {
+         RARCH_ERR("[slang]: Failed to compile shader"
+               " for pass #%u: \"%s\".\n",
+               i, shader->pass[i].source.path);
+         return false;
+      }
+   }
+
+   return true;
+}
+
+bool glslang_precompile_shader(const char *shader_path)
+{
+   /* Compiled only for the side effect of
+    * populating the SPIR-V blob cache - the
+    * output itself is thrown away */
+   glslang_output output;
+   return glslang_compile_shader(shader_path, &output);
+}
@@ -55,6 +55,13 @@ struct glslang_output
 
 bool glslang_compile_shader(const char *shader_path, glslang_output *output);
 
+/* Compiles every pass of a preset up front, spreading
+ * the glslang front end across one worker thread per
+ * core. outputs is resized to shader->passes; passes
+ * sharing a source file are only compiled once. */
+bool glslang_compile_shader_passes(struct video_shader *shader,
+      std::vector<glslang_output> *outputs);
+
 /* Helpers for internal use. */
 bool glslang_parse_meta(const struct string_list *lines, glslang_meta *meta);
 
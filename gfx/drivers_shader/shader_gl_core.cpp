@@ -1548,6 +1548,7 @@ struct gl_core_filter_chain
 {
 public:
    gl_core_filter_chain(unsigned num_passes) { set_num_passes(num_passes); }
+   ~gl_core_filter_chain();
 
    inline void set_shader_preset(unique_ptr<video_shader> shader)
    {
@@ -1579,8 +1580,19 @@ public:
    void add_static_texture(unique_ptr<gl_core_shader::StaticTexture> texture);
    void add_parameter(unsigned pass, unsigned parameter_index, const std::string &id);
    void set_num_passes(unsigned passes);
+   bool get_pass_profile(char *s, size_t len);
 
 private:
+#if !defined(HAVE_OPENGLES)
+   /* GL_TIME_ELAPSED queries, double buffered per pass so
+    * reading the results back never waits on the GPU. */
+   vector<GLuint> time_queries;
+   vector<bool> time_query_used;
+   vector<double> pass_gpu_ms;
+   unsigned time_query_parity = 0;
+   bool time_queries_unsupported = false;
+   void begin_frame_time_queries();
+#endif
    vector<unique_ptr<gl_core_shader::Pass>> passes;
    vector<gl_core_filter_chain_pass_info> pass_info;
    vector<vector<function<void ()>>> deferred_calls;
@@ -1646,11 +1658,98 @@ void gl_core_filter_chain::update_feedback_info()
    }
 }
 
+gl_core_filter_chain::~gl_core_filter_chain()
+{
+#if !defined(HAVE_OPENGLES)
+   if (!time_queries.empty())
+      glDeleteQueries(GLsizei(time_queries.size()), time_queries.data());
+#endif
+}
+
+#if !defined(HAVE_OPENGLES)
+void gl_core_filter_chain::begin_frame_time_queries()
+{
+   unsigned i;
+
+   if (time_queries_unsupported)
+      return;
+
+   if (time_queries.empty())
+   {
+      /* The loader leaves these NULL when the driver does not
+       * expose ARB_timer_query. */
+      if (!glGenQueries || !glGetQueryObjectui64v)
+      {
+         time_queries_unsupported = true;
+         return;
+      }
+
+      time_queries.resize(passes.size() * 2);
+      glGenQueries(GLsizei(time_queries.size()), time_queries.data());
+      time_query_used.assign(time_queries.size(), false);
+      pass_gpu_ms.assign(passes.size(), 0.0);
+   }
+
+   /* The slot we are about to reuse was written two frames ago,
+    * so its result is almost always in by now. If it is not,
+    * just drop the sample rather than stall. */
+   for (i = 0; i < passes.size(); i++)
+   {
+      unsigned slot = i * 2 + time_query_parity;
+      GLuint available = 0;
+
+      if (!time_query_used[slot])
+         continue;
+
+      glGetQueryObjectuiv(time_queries[slot],
+            GL_QUERY_RESULT_AVAILABLE, &available);
+      if (available)
+      {
+         GLuint64 ns = 0;
+         glGetQueryObjectui64v(time_queries[slot],
+               GL_QUERY_RESULT, &ns);
+         /* Keep a gentle moving average so the numbers
+          * are readable on-screen. */
+         pass_gpu_ms[i] += (double(ns) * 1e-6 - pass_gpu_ms[i]) * 0.125;
+      }
+      time_query_used[slot] = false;
+   }
+}
+#endif
+
+bool gl_core_filter_chain::get_pass_profile(char *s, size_t len)
+{
+#if !defined(HAVE_OPENGLES)
+   unsigned i;
+   size_t written;
+
+   if (pass_gpu_ms.empty())
+      return false;
+
+   written = size_t(snprintf(s, len, "Shader pass GPU time:\n"));
+
+   for (i = 0; i < passes.size() && written < len; i++)
+   {
+      const string &name = passes[i]->get_name();
+      written += size_t(snprintf(s + written, len - written,
+            " -#%u %s: %.3f ms\n", i,
+            name.empty() ? "(unnamed)" : name.c_str(),
+            pass_gpu_ms[i]));
+   }
+
+   return true;
+#else
+   /* GLES only has the EXT timer query entry points -
+    * not worth a separate code path. */
+   return false;
+#endif
+}
+
 void gl_core_filter_chain::build_offscreen_passes(const gl_core_viewport &vp)
 {
    unsigned i;
 
-   /* First frame, make sure our history and feedback textures 
+   /* First frame, make sure our history and feedback textures
     * are in a clean state. */
    if (require_clear)
    {
@@ -1658,6 +1757,10 @@ void gl_core_filter_chain::build_offscreen_passes(const gl_core_viewport &vp)
       require_clear = false;
    }
 
+#if !defined(HAVE_OPENGLES)
+   begin_frame_time_queries();
+#endif
+
    update_history_info();
    if (!common.framebuffer_feedback.empty())
       update_feedback_info();
@@ -1672,8 +1775,22 @@ void gl_core_filter_chain::build_offscreen_passes(const gl_core_viewport &vp)
 
    for (i = 0; i < passes.size() - 1; i++)
    {
+#if !defined(HAVE_OPENGLES)
+      if (!time_queries.empty())
+         glBeginQuery(GL_TIME_ELAPSED,
+               time_queries[i * 2 + time_query_parity]);
+#endif
+
       passes[i]->build_commands(original, source, vp, nullptr);
 
+#if !defined(HAVE_OPENGLES)
+      if (!time_queries.empty())
+      {
+         glEndQuery(GL_TIME_ELAPSED);
+         time_query_used[i * 2 + time_query_parity] = true;
+      }
+#endif
+
       const gl_core_shader::Framebuffer &fb   = passes[i]->get_framebuffer();
 
       source.texture.image             = fb.get_image();
@@ -1762,8 +1879,23 @@ void gl_core_filter_chain::build_viewport_pass(
       source.address                 = passes.back()->get_address_mode();
    }
 
+#if !defined(HAVE_OPENGLES)
+   if (!time_queries.empty())
+      glBeginQuery(GL_TIME_ELAPSED,
+            time_queries[(passes.size() - 1) * 2 + time_query_parity]);
+#endif
+
    passes.back()->build_commands(original, source, vp, mvp);
 
+#if !defined(HAVE_OPENGLES)
+   if (!time_queries.empty())
+   {
+      glEndQuery(GL_TIME_ELAPSED);
+      time_query_used[(passes.size() - 1) * 2 + time_query_parity] = true;
+      time_query_parity ^= 1;
+   }
+#endif
+
    /* For feedback FBOs, swap current and previous. */
    for (i = 0; i < passes.size(); i++)
    {
@@ -2147,6 +2279,7 @@ gl_core_filter_chain_t *gl_core_filter_chain_create_from_preset(
 {
    unsigned i;
    config_file_t *conf            = NULL;
+   std::vector<glslang_output> pass_outputs;
    unique_ptr<video_shader> shader{ new video_shader() };
    if (!shader)
       return nullptr;
@@ -2171,9 +2304,14 @@ gl_core_filter_chain_t *gl_core_filter_chain_create_from_preset(
 
    shader->num_parameters = 0;
 
+   /* Front-end compilation of the passes is independent,
+    * so it is farmed out to one worker per core */
+   if (!glslang_compile_shader_passes(shader.get(), &pass_outputs))
+      goto error;
+
    for (i = 0; i < shader->passes; i++)
    {
-      glslang_output output;
+      glslang_output &output = pass_outputs[i];
       struct gl_core_filter_chain_pass_info pass_info;
       const video_shader_pass *pass      = &shader->pass[i];
       const video_shader_pass *next_pass =
@@ -2189,13 +2327,6 @@ gl_core_filter_chain_t *gl_core_filter_chain_create_from_preset(
       pass_info.address       = GLSLANG_FILTER_CHAIN_ADDRESS_REPEAT;
       pass_info.max_levels    = 0;
 
-      if (!glslang_compile_shader(pass->source.path, &output))
-      {
-         RARCH_ERR("Failed to compile shader: \"%s\".\n",
-               pass->source.path);
-         goto error;
-      }
-
       for (auto &meta_param : output.meta.parameters)
       {
          if (shader->num_parameters >= GFX_MAX_PARAMETERS)
@@ -2504,3 +2635,10 @@ void gl_core_filter_chain_end_frame(gl_core_filter_chain_t *chain)
 {
    chain->end_frame();
 }
+
+bool gl_core_filter_chain_get_pass_profile(
+      gl_core_filter_chain_t *chain,
+      char *s, size_t len)
+{
+   return chain->get_pass_profile(s, len);
+}
@@ -139,6 +139,12 @@ struct video_shader *gl_core_filter_chain_get_preset(
 
 void gl_core_filter_chain_end_frame(gl_core_filter_chain_t *chain);
 
+/* Writes a short per-pass GPU time report into s.
+ * Returns false if timer queries are unavailable or
+ * no results have come back yet. */
+bool gl_core_filter_chain_get_pass_profile(gl_core_filter_chain_t *chain,
+      char *s, size_t len);
+
 GLuint gl_core_cross_compile_program(
       const uint32_t *vertex,
       size_t vertex_size,
@@ -308,6 +308,26 @@ class Pass
             slang_texture_semantic semantic, unsigned index,
             const Texture &texture);
 
+      struct BoundImage
+      {
+         VkSampler sampler    = VK_NULL_HANDLE;
+         VkImageView view     = VK_NULL_HANDLE;
+         VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+      };
+
+      /* What each binding of the persistent descriptor sets
+       * currently holds, per sync index. Only bindings whose
+       * image actually changed are rewritten, and those writes
+       * are batched into a single vkUpdateDescriptorSets call
+       * per pass per frame. */
+      vector<vector<BoundImage>> bound_images;
+      vector<VkDescriptorImageInfo> image_write_infos;
+      vector<VkWriteDescriptorSet> image_writes;
+
+      void set_texture_descriptor(VkDescriptorSet set, unsigned binding,
+            VkSampler sampler, VkImageView view, VkImageLayout layout);
+      void flush_texture_descriptors();
+
       slang_reflection reflection;
       void build_semantics(VkDescriptorSet set, uint8_t *buffer,
             const float *mvp, const Texture &original, const Texture &source);
@@ -335,6 +355,17 @@ class Pass
       size_t ubo_offset           = 0;
       string pass_name;
 
+      /* CPU-side staging for the reflected UBO block.
+       * build_semantics() assembles into this buffer so the result
+       * can be compared against what was last uploaded for the
+       * current sync index - identical blocks skip the write into
+       * the mapped UBO ring. */
+      vector<uint8_t> ubo_scratch;
+      /* Last uploaded UBO contents per sync index.
+       * An empty entry means nothing has been uploaded yet and the
+       * uniform buffer descriptor still has to be written. */
+      vector<vector<uint8_t>> ubo_uploaded;
+
       struct Parameter
       {
          string id;
@@ -390,6 +421,7 @@ struct vulkan_filter_chain
       void set_frame_count_period(unsigned pass, unsigned period);
       void set_frame_direction(int32_t direction);
       void set_pass_name(unsigned pass, const char *name);
+      bool get_pass_profile(char *s, size_t len);
 
       void add_static_texture(unique_ptr<StaticTexture> texture);
       void add_parameter(unsigned pass, unsigned parameter_index, const std::string &id);
@@ -412,6 +444,16 @@ struct vulkan_filter_chain
       vulkan_filter_chain_swapchain_info swapchain_info;
       unsigned current_sync_index;
 
+      /* GPU timestamps, two per pass per sync index.
+       * Read back when the sync index comes around again,
+       * so no stall is introduced. */
+      VkQueryPool timestamp_pool = VK_NULL_HANDLE;
+      double timestamp_period = 0.0;
+      bool timestamp_unsupported = false;
+      vector<double> pass_gpu_ms;
+      vector<bool> timestamp_pending;
+      void begin_frame_timestamps(VkCommandBuffer cmd);
+
       void flush();
 
       void set_num_passes(unsigned passes);
@@ -829,6 +871,104 @@ void vulkan_filter_chain::flush()
 {
    vkDeviceWaitIdle(device);
    execute_deferred();
+
+   /* Device is idle here, so the pool cannot be referenced by
+    * in-flight command buffers anymore. It is rebuilt lazily,
+    * sized for the new swapchain, on the next frame. */
+   if (timestamp_pool != VK_NULL_HANDLE)
+   {
+      vkDestroyQueryPool(device, timestamp_pool, nullptr);
+      timestamp_pool = VK_NULL_HANDLE;
+   }
+}
+
+void vulkan_filter_chain::begin_frame_timestamps(VkCommandBuffer cmd)
+{
+   unsigned i;
+   uint32_t base;
+
+   if (timestamp_unsupported)
+      return;
+
+   if (timestamp_pool == VK_NULL_HANDLE)
+   {
+      VkPhysicalDeviceProperties props;
+      VkQueryPoolCreateInfo info = {
+         VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+
+      vkGetPhysicalDeviceProperties(gpu, &props);
+      if (!props.limits.timestampComputeAndGraphics ||
+            props.limits.timestampPeriod <= 0.0f)
+      {
+         timestamp_unsupported = true;
+         return;
+      }
+
+      info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+      info.queryCount = unsigned(deferred_calls.size() * passes.size()) * 2;
+
+      if (vkCreateQueryPool(device, &info, nullptr,
+               &timestamp_pool) != VK_SUCCESS)
+      {
+         timestamp_pool        = VK_NULL_HANDLE;
+         timestamp_unsupported = true;
+         return;
+      }
+
+      timestamp_period = double(props.limits.timestampPeriod);
+      timestamp_pending.assign(deferred_calls.size(), false);
+      pass_gpu_ms.assign(passes.size(), 0.0);
+   }
+
+   base = uint32_t(current_sync_index * passes.size()) * 2;
+
+   /* The frame which last used this sync index has retired,
+    * so its queries are available now. */
+   if (timestamp_pending[current_sync_index])
+   {
+      for (i = 0; i < passes.size(); i++)
+      {
+         uint64_t ticks[2];
+         if (vkGetQueryPoolResults(device, timestamp_pool,
+                  base + 2 * i, 2,
+                  sizeof(ticks), ticks, sizeof(uint64_t),
+                  VK_QUERY_RESULT_64_BIT) == VK_SUCCESS &&
+               ticks[1] > ticks[0])
+         {
+            double ms = double(ticks[1] - ticks[0]) *
+               timestamp_period * 1e-6;
+            /* Keep a gentle moving average so the numbers
+             * are readable on-screen. */
+            pass_gpu_ms[i] += (ms - pass_gpu_ms[i]) * 0.125;
+         }
+      }
+      timestamp_pending[current_sync_index] = false;
+   }
+
+   vkCmdResetQueryPool(cmd, timestamp_pool, base,
+         uint32_t(passes.size()) * 2);
+}
+
+bool vulkan_filter_chain::get_pass_profile(char *s, size_t len)
+{
+   unsigned i;
+   size_t written;
+
+   if (timestamp_pool == VK_NULL_HANDLE || pass_gpu_ms.empty())
+      return false;
+
+   written = size_t(snprintf(s, len, "Shader pass GPU time:\n"));
+
+   for (i = 0; i < passes.size() && written < len; i++)
+   {
+      const string &name = passes[i]->get_name();
+      written += size_t(snprintf(s + written, len - written,
+            " -#%u %s: %.3f ms\n", i,
+            name.empty() ? "(unnamed)" : name.c_str(),
+            pass_gpu_ms[i]));
+   }
+
+   return true;
 }
 
 void vulkan_filter_chain::update_history_info()
@@ -899,6 +1039,9 @@ void vulkan_filter_chain::build_offscreen_passes(VkCommandBuffer cmd,
    update_history_info();
    update_feedback_info();
 
+   /* Outside any render pass, so the query reset is legal here. */
+   begin_frame_timestamps(cmd);
+
    DeferredDisposer disposer(deferred_calls[current_sync_index]);
    const Texture original = {
       input_texture,
@@ -911,9 +1054,19 @@ void vulkan_filter_chain::build_offscreen_passes(VkCommandBuffer cmd,
 
    for (i = 0; i < passes.size() - 1; i++)
    {
+      if (timestamp_pool != VK_NULL_HANDLE)
+         vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+               timestamp_pool,
+               uint32_t(current_sync_index * passes.size() + i) * 2);
+
       passes[i]->build_commands(disposer, cmd,
             original, source, vp, nullptr);
 
+      if (timestamp_pool != VK_NULL_HANDLE)
+         vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+               timestamp_pool,
+               uint32_t(current_sync_index * passes.size() + i) * 2 + 1);
+
       const Framebuffer &fb   = passes[i]->get_framebuffer();
 
       source.texture.view     = fb.get_view();
@@ -1039,9 +1192,24 @@ void vulkan_filter_chain::build_viewport_pass(
       source.address         = passes.back()->get_address_mode();
    }
 
+   /* Timestamps are fine inside the backbuffer render pass,
+    * only the reset has to happen in the offscreen stage. */
+   if (timestamp_pool != VK_NULL_HANDLE)
+      vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            timestamp_pool,
+            uint32_t((current_sync_index + 1) * passes.size() - 1) * 2);
+
    passes.back()->build_commands(disposer, cmd,
          original, source, vp, mvp);
 
+   if (timestamp_pool != VK_NULL_HANDLE)
+   {
+      vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            timestamp_pool,
+            uint32_t((current_sync_index + 1) * passes.size() - 1) * 2 + 1);
+      timestamp_pending[current_sync_index] = true;
+   }
+
    /* For feedback FBOs, swap current and previous. */
    for (i = 0; i < passes.size(); i++)
       passes[i]->end_frame();
@@ -1650,6 +1818,12 @@ bool Pass::init_pipeline_layout()
    for (i = 0; i < num_sync_indices; i++)
       vkAllocateDescriptorSets(device, &alloc_info, &sets[i]);
 
+   /* Fresh sets hold nothing - drop any stale binding cache */
+   bound_images.clear();
+   bound_images.resize(num_sync_indices);
+   image_writes.clear();
+   image_write_infos.clear();
+
    return true;
 }
 
@@ -1914,6 +2088,11 @@ CommonResources::~CommonResources()
 
 void Pass::allocate_buffers()
 {
+   /* The backing UBO is recreated and descriptor sets have been
+    * reallocated by this point, so any cached uploads are stale. */
+   ubo_scratch.clear();
+   ubo_uploaded.clear();
+
    if (reflection.ubo_stage_mask)
    {
       /* Align */
@@ -1923,6 +2102,9 @@ void Pass::allocate_buffers()
 
       /* Allocate */
       common->ubo_offset += reflection.ubo_size;
+
+      ubo_scratch.resize(reflection.ubo_size);
+      ubo_uploaded.resize(num_sync_indices);
    }
 }
 
@@ -1990,13 +2172,75 @@ bool Pass::build()
    return init_pipeline();
 }
 
+void Pass::set_texture_descriptor(VkDescriptorSet set, unsigned binding,
+      VkSampler sampler, VkImageView view, VkImageLayout layout)
+{
+   VkDescriptorImageInfo image_info;
+   VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+   auto &bound                = bound_images[sync_index];
+
+   if (binding >= bound.size())
+      bound.resize(binding + 1);
+
+   /* The sets are persistent - a binding that already holds this
+    * exact image does not have to be touched at all. LUTs and
+    * stable pass outputs settle after the first few frames. */
+   if (     bound[binding].sampler == sampler
+         && bound[binding].view    == view
+         && bound[binding].layout  == layout)
+      return;
+
+   bound[binding].sampler = sampler;
+   bound[binding].view    = view;
+   bound[binding].layout  = layout;
+
+   image_info.sampler     = sampler;
+   image_info.imageView   = view;
+   image_info.imageLayout = layout;
+
+   write.dstSet           = set;
+   write.dstBinding       = binding;
+   write.dstArrayElement  = 0;
+   write.descriptorCount  = 1;
+   write.descriptorType   = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+   /* Patched in flush_texture_descriptors() - the info vector
+    * may still reallocate while writes accumulate. */
+   write.pImageInfo       = nullptr;
+   write.pBufferInfo      = nullptr;
+   write.pTexelBufferView = nullptr;
+
+   image_write_infos.push_back(image_info);
+   image_writes.push_back(write);
+}
+
+void Pass::flush_texture_descriptors()
+{
+   size_t i;
+
+   if (image_writes.empty())
+      return;
+
+   for (i = 0; i < image_writes.size(); i++)
+      image_writes[i].pImageInfo = &image_write_infos[i];
+
+   /* One update call per pass per frame instead of one per bound
+    * texture - per-call overhead in vkUpdateDescriptorSets is
+    * what hurts on mobile drivers. */
+   vkUpdateDescriptorSets(device, image_writes.size(),
+         image_writes.data(), 0, nullptr);
+
+   image_writes.clear();
+   image_write_infos.clear();
+}
+
 void Pass::set_semantic_texture(VkDescriptorSet set,
       slang_texture_semantic semantic, const Texture &texture)
 {
    if (reflection.semantic_textures[semantic][0].texture)
-   {
-      VULKAN_PASS_SET_TEXTURE(device, set, common->samplers[texture.filter][texture.mip_filter][texture.address], reflection.semantic_textures[semantic][0].binding, texture.texture.view, texture.texture.layout);
-   }
+      set_texture_descriptor(set,
+            reflection.semantic_textures[semantic][0].binding,
+            common->samplers[texture.filter][texture.mip_filter][texture.address],
+            texture.texture.view, texture.texture.layout);
 }
 
 void Pass::set_semantic_texture_array(VkDescriptorSet set,
@@ -2005,9 +2249,10 @@ void Pass::set_semantic_texture_array(VkDescriptorSet set,
 {
    if (index < reflection.semantic_textures[semantic].size() &&
          reflection.semantic_textures[semantic][index].texture)
-   {
-      VULKAN_PASS_SET_TEXTURE(device, set, common->samplers[texture.filter][texture.mip_filter][texture.address],  reflection.semantic_textures[semantic][index].binding, texture.texture.view, texture.texture.layout);
-   }
+      set_texture_descriptor(set,
+            reflection.semantic_textures[semantic][index].binding,
+            common->samplers[texture.filter][texture.mip_filter][texture.address],
+            texture.texture.view, texture.texture.layout);
 }
 
 void Pass::build_semantic_texture_array_vec4(uint8_t *data, slang_texture_semantic semantic,
@@ -2196,8 +2441,6 @@ void Pass::build_commands(
       const VkViewport &vp,
       const float *mvp)
 {
-   uint8_t *u       = nullptr;
-
    current_viewport = vp;
    Size2D size      = get_output_size(
          { original.texture.width, original.texture.height },
@@ -2211,18 +2454,42 @@ void Pass::build_commands(
    current_framebuffer_size = size;
 
    if (reflection.ubo_stage_mask && common->ubo_mapped)
-      u = common->ubo_mapped + ubo_offset +
-         sync_index * common->ubo_sync_index_stride;
-
-   build_semantics(sets[sync_index], u, mvp, original, source);
+   {
+      build_semantics(sets[sync_index], ubo_scratch.data(),
+            mvp, original, source);
+
+      /* Most of the block (sizes, viewport, parameters) only
+       * changes on resize or when the user edits a parameter, so
+       * skip the upload when the contents match what this sync
+       * index already holds. Frame-varying builtins like
+       * FrameCount naturally force an upload when present. */
+      if (ubo_uploaded[sync_index].empty() ||
+            memcmp(ubo_uploaded[sync_index].data(), ubo_scratch.data(),
+               reflection.ubo_size) != 0)
+      {
+         memcpy(common->ubo_mapped + ubo_offset +
+               sync_index * common->ubo_sync_index_stride,
+               ubo_scratch.data(), reflection.ubo_size);
+
+         /* The descriptor points at a fixed buffer range and only
+          * has to be written the first time around. */
+         if (ubo_uploaded[sync_index].empty())
+            vulkan_set_uniform_buffer(device,
+                  sets[sync_index],
+                  reflection.ubo_binding,
+                  common->ubo->get_buffer(),
+                  ubo_offset + sync_index * common->ubo_sync_index_stride,
+                  reflection.ubo_size);
+
+         ubo_uploaded[sync_index] = ubo_scratch;
+      }
+   }
+   else
+      build_semantics(sets[sync_index], nullptr, mvp, original, source);
 
-   if (reflection.ubo_stage_mask)
-      vulkan_set_uniform_buffer(device,
-            sets[sync_index],
-            reflection.ubo_binding,
-            common->ubo->get_buffer(),
-            ubo_offset + sync_index * common->ubo_sync_index_stride,
-            reflection.ubo_size);
+   /* Must happen before the set is bound below - these sets are
+    * not UPDATE_AFTER_BIND capable. */
+   flush_texture_descriptors();
 
    /* The final pass is always executed inside
     * another render pass since the frontend will
@@ -2556,6 +2823,7 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
 {
    unsigned i;
    config_file_t *conf            = NULL;
+   std::vector<glslang_output> pass_outputs;
    unique_ptr<video_shader> shader{ new video_shader() };
    if (!shader)
       return nullptr;
@@ -2582,9 +2850,14 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
 
    shader->num_parameters = 0;
 
+   /* Compile every pass up front - the glslang front end
+    * runs one pass per core rather than serially */
+   if (!glslang_compile_shader_passes(shader.get(), &pass_outputs))
+      goto error;
+
    for (i = 0; i < shader->passes; i++)
    {
-      glslang_output output;
+      glslang_output &output = pass_outputs[i];
       struct vulkan_filter_chain_pass_info pass_info;
       const video_shader_pass *pass      = &shader->pass[i];
       const video_shader_pass *next_pass =
@@ -2600,13 +2873,6 @@ vulkan_filter_chain_t *vulkan_filter_chain_create_from_preset(
       pass_info.address       = GLSLANG_FILTER_CHAIN_ADDRESS_REPEAT;
       pass_info.max_levels    = 0;
 
-      if (!glslang_compile_shader(pass->source.path, &output))
-      {
-         RARCH_ERR("Failed to compile shader: \"%s\".\n",
-               pass->source.path);
-         goto error;
-      }
-
       for (auto &meta_param : output.meta.parameters)
       {
          if (shader->num_parameters >= GFX_MAX_PARAMETERS)
@@ -2932,3 +3198,10 @@ void vulkan_filter_chain_end_frame(
 {
    chain->end_frame(cmd);
 }
+
+bool vulkan_filter_chain_get_pass_profile(
+      vulkan_filter_chain_t *chain,
+      char *s, size_t len)
+{
+   return chain->get_pass_profile(s, len);
+}
@@ -134,6 +134,12 @@ void vulkan_filter_chain_build_viewport_pass(vulkan_filter_chain_t *chain,
 void vulkan_filter_chain_end_frame(vulkan_filter_chain_t *chain,
       VkCommandBuffer cmd);
 
+/* Writes a short per-pass GPU time report into s.
+ * Returns false if timestamps are unsupported or
+ * no results have come back yet. */
+bool vulkan_filter_chain_get_pass_profile(vulkan_filter_chain_t *chain,
+      char *s, size_t len);
+
 vulkan_filter_chain_t *vulkan_filter_chain_create_default(
       const struct vulkan_filter_chain_create_info *info,
       enum glslang_filter_chain_filter filter);
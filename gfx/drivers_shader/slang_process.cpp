@@ -428,12 +428,19 @@ bool slang_preprocess_parse_parameters(const char *shader_path,
       struct video_shader *shader)
 {
    glslang_meta meta;
+   bool read_ok             = false;
    struct string_list lines = {0};
-   
+
    if (!string_list_initialize(&lines))
       goto error;
 
-   if (!glslang_read_shader_file(shader_path, &lines, true))
+   /* Keeps repeatedly #included .inc files in memory
+    * while the include tree is resolved */
+   glslang_shader_file_cache_begin();
+   read_ok = glslang_read_shader_file(shader_path, &lines, true);
+   glslang_shader_file_cache_end();
+
+   if (!read_ok)
       goto error;
    meta = glslang_meta{};
    if (!glslang_parse_meta(&lines, &meta))
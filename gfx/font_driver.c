@@ -1072,6 +1072,43 @@ void font_driver_bind_block(void *font_data, void *block)
       font->renderer->bind_block(font->renderer_data, block);
 }
 
+void font_driver_frame_begin(void *font_data)
+{
+   font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
+
+   if (  !font
+       || !font->renderer
+       || !font->renderer->bind_block
+       || !font->renderer->flush)
+      return;
+
+   if (!font->block)
+      font->block = (video_font_raster_block_t*)
+         calloc(1, sizeof(*font->block));
+
+   if (!font->block)
+      return;
+
+   /* The coord array keeps its allocation across frames -
+    * only the vertex count is rewound */
+   font->block->carr.coords.vertices = 0;
+   font->renderer->bind_block(font->renderer_data, font->block);
+}
+
+void font_driver_frame_end(unsigned width, unsigned height,
+      void *font_data)
+{
+   font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
+
+   if (!font || !font->block || !font->renderer)
+      return;
+
+   if (font->renderer->flush)
+      font->renderer->flush(width, height, font->renderer_data);
+   if (font->renderer->bind_block)
+      font->renderer->bind_block(font->renderer_data, NULL);
+}
+
 void font_driver_flush(unsigned width, unsigned height, void *font_data)
 {
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
@@ -1079,15 +1116,68 @@ void font_driver_flush(unsigned width, unsigned height, void *font_data)
       font->renderer->flush(width, height, font->renderer_data);
 }
 
+/* Number of slots in the per-font measurement cache.
+ * Must be a power of two. */
+#define FONT_WIDTH_CACHE_SIZE 256
+/* Strings longer than this are measured directly -
+ * they are rare and would bloat the cache. */
+#define FONT_WIDTH_CACHE_MAX_LEN 1024
+
 int font_driver_get_message_width(void *font_data,
       const char *msg, unsigned len, float scale)
 {
+   struct font_width_cache_entry *entry = NULL;
+   int width         = 0;
    font_data_t *font = (font_data_t*)(font_data ? font_data : video_font_driver);
    if (len == 0 && msg)
       len = (unsigned)strlen(msg);
-   if (font && font->renderer && font->renderer->get_message_width)
-      return font->renderer->get_message_width(font->renderer_data, msg, len, scale);
-   return -1;
+   if (!font || !font->renderer || !font->renderer->get_message_width)
+      return -1;
+
+   /* Menus measure the same labels every frame, so cache widths
+    * keyed by the string itself. Entries are validated with a full
+    * compare - a hash collision merely evicts. */
+   if (msg && len && len <= FONT_WIDTH_CACHE_MAX_LEN)
+   {
+      unsigned i;
+      uint32_t hash = 5381;
+      for (i = 0; i < len; i++)
+         hash = (hash << 5) + hash + (uint8_t)msg[i];
+
+      if (!font->width_cache)
+         font->width_cache = (struct font_width_cache_entry*)
+            calloc(FONT_WIDTH_CACHE_SIZE, sizeof(*font->width_cache));
+
+      if (font->width_cache)
+      {
+         entry = &font->width_cache[hash & (FONT_WIDTH_CACHE_SIZE - 1)];
+         if (     entry->msg
+               && entry->len   == len
+               && entry->scale == scale
+               && memcmp(entry->msg, msg, len) == 0)
+            return entry->width;
+      }
+   }
+
+   width = font->renderer->get_message_width(
+         font->renderer_data, msg, len, scale);
+
+   if (entry)
+   {
+      char *copy = (char*)malloc(len);
+      if (copy)
+      {
+         memcpy(copy, msg, len);
+         if (entry->msg)
+            free(entry->msg);
+         entry->msg   = copy;
+         entry->len   = len;
+         entry->scale = scale;
+         entry->width = width;
+      }
+   }
+
+   return width;
 }
 
 int font_driver_get_line_height(void *font_data, float scale)
@@ -1173,6 +1263,25 @@ void font_driver_free(void *font_data)
       font->renderer      = NULL;
       font->renderer_data = NULL;
 
+      if (font->block)
+      {
+         video_coord_array_free(&font->block->carr);
+         free(font->block);
+         font->block      = NULL;
+      }
+
+      if (font->width_cache)
+      {
+         unsigned i;
+         for (i = 0; i < FONT_WIDTH_CACHE_SIZE; i++)
+         {
+            if (font->width_cache[i].msg)
+               free(font->width_cache[i].msg);
+         }
+         free(font->width_cache);
+         font->width_cache = NULL;
+      }
+
       free(font);
    }
 }
@@ -1203,6 +1312,8 @@ font_data_t *font_driver_init_first(
       font_data_t *font   = (font_data_t*)malloc(sizeof(*font));
       font->renderer      = (const font_renderer_t*)font_driver;
       font->renderer_data = font_handle;
+      font->block         = NULL;
+      font->width_cache   = NULL;
       font->size          = font_size;
       return font;
    }
@@ -21,10 +21,12 @@
 
 #include <boolean.h>
 #include <retro_common_api.h>
+#include <retro_inline.h>
 
 #include "../retroarch.h"
 
 #include "video_defines.h"
+#include "video_coord_array.h"
 
 RETRO_BEGIN_DECLS
 
@@ -60,9 +62,35 @@ struct font_atlas
    uint8_t *buffer; /* Alpha channel. */
    unsigned width;
    unsigned height;
+   /* Row span [dirty_y0, dirty_y1) covering every texel
+    * modified since the last upload. Backends may use it
+    * to sub-upload instead of re-uploading the whole
+    * atlas; a zero span with 'dirty' set means the span
+    * is unknown and a full upload is required. */
+   unsigned dirty_y0;
+   unsigned dirty_y1;
    bool dirty;
 };
 
+/* Marks rows [y0, y1) of the atlas as needing upload. */
+static INLINE void font_atlas_mark_dirty(struct font_atlas *atlas,
+      unsigned y0, unsigned y1)
+{
+   if (atlas->dirty)
+   {
+      if (y0 < atlas->dirty_y0)
+         atlas->dirty_y0 = y0;
+      if (y1 > atlas->dirty_y1)
+         atlas->dirty_y1 = y1;
+   }
+   else
+   {
+      atlas->dirty_y0 = y0;
+      atlas->dirty_y1 = y1;
+      atlas->dirty    = true;
+   }
+}
+
 struct font_params
 {
    /* Drop shadow offset.
@@ -128,10 +156,27 @@ typedef struct font_renderer_driver
    bool (*get_line_metrics)(void* data, struct font_line_metrics **metrics);
 } font_renderer_driver_t;
 
+struct font_width_cache_entry
+{
+   char *msg;
+   unsigned len;
+   float scale;
+   int width;
+};
+
 typedef struct
 {
    const font_renderer_t *renderer;
    void *renderer_data;
+   /* Persistent per-font vertex block used by the
+    * frame-scoped batcher (font_driver_frame_begin).
+    * Allocated lazily, kept across frames. */
+   video_font_raster_block_t *block;
+   /* Direct-mapped measurement cache: string hash -> pixel
+    * width. Widths for a given renderer instance never change,
+    * so entries live as long as the font itself; replacing the
+    * font invalidates them wholesale. Allocated lazily. */
+   struct font_width_cache_entry *width_cache;
    float size;
 } font_data_t;
 
@@ -146,6 +191,17 @@ void font_driver_render_msg(void *data,
 
 void font_driver_bind_block(void *font_data, void *block);
 
+/* Frame-scoped text batching. Between begin and end, all
+ * messages rendered through this font accumulate into its
+ * persistent vertex block; end issues a single draw per
+ * atlas texture. Fonts whose renderer lacks block support
+ * keep drawing immediately. NULL font_data targets the
+ * OSD font. */
+void font_driver_frame_begin(void *font_data);
+
+void font_driver_frame_end(unsigned width, unsigned height,
+      void *font_data);
+
 int font_driver_get_message_width(void *font_data, const char *msg, unsigned len, float scale);
 
 void font_driver_flush(unsigned width, unsigned height, void *font_data);
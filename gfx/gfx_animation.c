@@ -1136,6 +1136,8 @@ bool gfx_animation_push(gfx_animation_ctx_entry_t *entry)
 
    if (p_anim->in_update)
       RBUF_PUSH(p_anim->pending, t);
+   else if (RBUF_LEN(p_anim->free_slots) > 0)
+      p_anim->list[RBUF_POP(p_anim->free_slots)] = t;
    else
       RBUF_PUSH(p_anim->list, t);
 
@@ -1288,7 +1290,9 @@ bool gfx_animation_update(
    {
       struct tween *tween   = &p_anim->list[i];
 
-      if (tween->deleted)
+      /* Skip recycled slots and tweens
+       * killed earlier this update */
+      if (!tween->subject || tween->deleted)
          continue;
 
       tween->running_since += p_anim->delta_time;
@@ -1306,8 +1310,10 @@ bool gfx_animation_update(
          if (tween->cb)
             tween->cb(tween->userdata);
 
-         RBUF_REMOVE(p_anim->list, i);
-         i--;
+         /* Park the slot on the free list instead of
+          * compacting the array with a memmove */
+         tween->subject = NULL;
+         RBUF_PUSH(p_anim->free_slots, i);
       }
    }
 
@@ -1316,10 +1322,10 @@ bool gfx_animation_update(
       for (i = 0; i < RBUF_LEN(p_anim->list); i++)
       {
          struct tween *tween = &p_anim->list[i];
-         if (tween->deleted)
+         if (tween->subject && tween->deleted)
          {
-            RBUF_REMOVE(p_anim->list, i);
-            i--;
+            tween->subject = NULL;
+            RBUF_PUSH(p_anim->free_slots, i);
          }
       }
       p_anim->pending_deletes = false;
@@ -1327,14 +1333,28 @@ bool gfx_animation_update(
 
    if (RBUF_LEN(p_anim->pending) > 0)
    {
-      size_t list_len    = RBUF_LEN(p_anim->list);
       size_t pending_len = RBUF_LEN(p_anim->pending);
-      RBUF_RESIZE(p_anim->list, list_len + pending_len);
-      memcpy(p_anim->list + list_len, p_anim->pending,
-            sizeof(*p_anim->pending) * pending_len);
+
+      /* Fill recycled slots before growing the list */
+      for (i = 0; i < pending_len; i++)
+      {
+         if (RBUF_LEN(p_anim->free_slots) > 0)
+            p_anim->list[RBUF_POP(p_anim->free_slots)] = p_anim->pending[i];
+         else
+            RBUF_PUSH(p_anim->list, p_anim->pending[i]);
+      }
       RBUF_CLEAR(p_anim->pending);
    }
 
+   /* Once every animation has finished, reset the slot
+    * bookkeeping (allocations are kept for reuse) so an
+    * idle animation list costs nothing to walk */
+   if (RBUF_LEN(p_anim->list) == RBUF_LEN(p_anim->free_slots))
+   {
+      RBUF_CLEAR(p_anim->list);
+      RBUF_CLEAR(p_anim->free_slots);
+   }
+
    p_anim->in_update           = false;
    p_anim->animation_is_active = RBUF_LEN(p_anim->list) > 0;
 
@@ -1409,11 +1429,23 @@ static void build_line_ticker_string(
 bool gfx_animation_ticker(gfx_animation_ctx_ticker_t *ticker)
 {
    gfx_animation_t *p_anim = anim_get_ptr();
-   size_t str_len          = utf8len(ticker->str);
+   size_t str_len;
+
+   /* Every UTF-8 character occupies at least one byte,
+    * so a string whose *byte* length fits in the field
+    * is guaranteed to fit - copy it directly instead of
+    * walking the string twice (utf8len() + utf8cpy()) */
+   if (strlen(ticker->str) <= ticker->len)
+   {
+      strlcpy(ticker->s, ticker->str, PATH_MAX_LENGTH);
+      return false;
+   }
 
    if (!ticker->spacer)
       ticker->spacer       = TICKER_SPACER_DEFAULT;
 
+   str_len = utf8len(ticker->str);
+
    if ((size_t)str_len <= ticker->len)
    {
       utf8cpy(ticker->s,
@@ -2166,12 +2198,12 @@ bool gfx_animation_kill_by_tag(uintptr_t *tag)
    {
       struct tween *t = &p_anim->list[i];
 
-      if (t->tag != *tag)
+      if (!t->subject || (t->tag != *tag))
          continue;
 
       /* If we are currently inside gfx_animation_update(),
        * we are already looping over p_anim->list entries
-       * > Cannot modify p_anim->list now, so schedule a
+       * > Cannot recycle the slot now, so schedule a
        *   delete for when the gfx_animation_update() loop
        *   is complete */
       if (p_anim->in_update)
@@ -2181,8 +2213,8 @@ bool gfx_animation_kill_by_tag(uintptr_t *tag)
       }
       else
       {
-         RBUF_REMOVE(p_anim->list, i);
-         --i;
+         t->subject = NULL;
+         RBUF_PUSH(p_anim->free_slots, i);
       }
    }
 
@@ -2223,6 +2255,7 @@ bool gfx_animation_ctl(enum gfx_animation_ctl_state state, void *data)
       case MENU_ANIMATION_CTL_DEINIT:
          RBUF_FREE(p_anim->list);
          RBUF_FREE(p_anim->pending);
+         RBUF_FREE(p_anim->free_slots);
          memset(p_anim, 0, sizeof(*p_anim));
          break;
       case MENU_ANIMATION_CTL_CLEAR_ACTIVE:
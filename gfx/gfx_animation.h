@@ -217,6 +217,11 @@ struct gfx_animation
    retro_time_t old_time;
    struct tween* list;
    struct tween* pending;
+   /* Indices of recyclable entries in 'list' (subject == NULL).
+    * Finished tweens park their slot here instead of compacting
+    * the list, so entries keep stable addresses and pushes reuse
+    * slots without reallocating */
+   size_t* free_slots;
 
    float delta_time;
 
@@ -14,6 +14,10 @@
  *  You should have received a copy of the GNU General Public License along with RetroArch.
  *  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <encodings/crc32.h>
+
 #include "gfx_display.h"
 #include "gfx_animation.h"
 
@@ -900,6 +904,151 @@ void gfx_display_draw_quad(
       dispctx->blend_end(data);
 }
 
+/* Queue a quad for deferred rendering. Consecutive quads sharing a
+ * texture are merged into a single triangle strip (sections are joined
+ * by degenerate triangles, which every display driver can render) and
+ * submitted with one draw by gfx_display_batch_flush(), instead of one
+ * backend draw per quad. Queueing a quad with a different texture
+ * flushes the pending batch first. */
+void gfx_display_batch_quad(
+      void *userdata,
+      unsigned video_width,
+      unsigned video_height,
+      int x, int y, unsigned w, unsigned h,
+      unsigned width, unsigned height,
+      float *color, uintptr_t texture)
+{
+   float vertex[12];
+   float tex_coord[12];
+   float colors[24];
+   video_coords_t coords;
+   unsigned i;
+   const float *coord_draw_ptr       = NULL;
+   gfx_display_t            *p_disp  = disp_get_ptr();
+   video_coord_array_t *ca           = &p_disp->batchca;
+   gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   static const float default_tex_coord[8] = {
+      0.0f, 1.0f,
+      1.0f, 1.0f,
+      0.0f, 0.0f,
+      1.0f, 0.0f,
+   };
+   /* quad corners in strip order: BL, BR, TL, TR */
+   float x0                          = x / (float)width;
+   float x1                          = (x + (int)w) / (float)width;
+   float y0                          = ((int)height - y - (int)h)
+      / (float)height;
+   float y1                          = ((int)height - y) / (float)height;
+
+   if (!texture)
+      texture                        = gfx_display_white_texture;
+
+   if (ca->coords.vertices && (p_disp->batch_texture != texture))
+      gfx_display_batch_flush(userdata, video_width, video_height);
+
+   p_disp->batch_texture             = texture;
+
+   if (dispctx && dispctx->get_default_tex_coords)
+      coord_draw_ptr                 = dispctx->get_default_tex_coords();
+   if (!coord_draw_ptr)
+      coord_draw_ptr                 = default_tex_coord;
+
+   vertex[0]                         = x0;
+   vertex[1]                         = y0;
+   vertex[2]                         = x1;
+   vertex[3]                         = y0;
+   vertex[4]                         = x0;
+   vertex[5]                         = y1;
+   vertex[6]                         = x1;
+   vertex[7]                         = y1;
+
+   if (ca->coords.vertices)
+   {
+      /* Join with the queued strip by repeating its last vertex
+       * and our first one - the extra triangles are degenerate. */
+      unsigned last = ca->coords.vertices - 1;
+
+      memcpy(&vertex[8],     &ca->coords.vertex[last * 2],
+            2 * sizeof(float));
+      memcpy(&tex_coord[8],  &ca->coords.tex_coord[last * 2],
+            2 * sizeof(float));
+      memcpy(&colors[16],    &ca->coords.color[last * 4],
+            4 * sizeof(float));
+      memcpy(&vertex[10],    &vertex[0],        2 * sizeof(float));
+      memcpy(&tex_coord[10], coord_draw_ptr,    2 * sizeof(float));
+      memcpy(&colors[20],    color,             4 * sizeof(float));
+
+      coords.vertex        = &vertex[8];
+      coords.tex_coord     = &tex_coord[8];
+      coords.lut_tex_coord = &tex_coord[8];
+      coords.color         = &colors[16];
+      coords.vertices      = 2;
+
+      video_coord_array_append(ca, &coords, 2);
+   }
+
+   for (i = 0; i < 4; i++)
+   {
+      memcpy(&tex_coord[i * 2], &coord_draw_ptr[i * 2],
+            2 * sizeof(float));
+      memcpy(&colors[i * 4],    &color[i * 4],
+            4 * sizeof(float));
+   }
+
+   coords.vertex        = vertex;
+   coords.tex_coord     = tex_coord;
+   coords.lut_tex_coord = tex_coord;
+   coords.color         = colors;
+   coords.vertices      = 4;
+
+   video_coord_array_append(ca, &coords, 4);
+}
+
+/* Submit the quads queued by gfx_display_batch_quad()
+ * as a single backend draw call. */
+void gfx_display_batch_flush(
+      void *userdata,
+      unsigned video_width,
+      unsigned video_height)
+{
+   gfx_display_ctx_draw_t draw;
+   struct video_coords coords;
+   gfx_display_t            *p_disp  = disp_get_ptr();
+   gfx_display_ctx_driver_t *dispctx = p_disp->dispctx;
+   video_coord_array_t *ca           = &p_disp->batchca;
+
+   if (!dispctx || !dispctx->draw || !ca->coords.vertices)
+      return;
+
+   coords.vertices      = ca->coords.vertices;
+   coords.vertex        = ca->coords.vertex;
+   coords.tex_coord     = ca->coords.tex_coord;
+   coords.lut_tex_coord = ca->coords.lut_tex_coord;
+   coords.color         = ca->coords.color;
+
+   draw.x            = 0;
+   draw.y            = 0;
+   draw.width        = video_width;
+   draw.height       = video_height;
+   draw.coords       = &coords;
+   draw.matrix_data  = NULL;
+   draw.texture      = p_disp->batch_texture;
+   draw.prim_type    = GFX_DISPLAY_PRIM_TRIANGLESTRIP;
+   draw.pipeline_id  = 0;
+   draw.scale_factor = 1.0f;
+   draw.rotation     = 0.0f;
+
+   if (dispctx->blend_begin)
+      dispctx->blend_begin(userdata);
+
+   dispctx->draw(&draw, userdata, video_width, video_height);
+
+   if (dispctx->blend_end)
+      dispctx->blend_end(userdata);
+
+   ca->coords.vertices = 0;
+}
+
 void gfx_display_draw_polygon(
       void *userdata,
       unsigned video_width,
@@ -994,6 +1143,41 @@ void gfx_display_draw_texture(
          video_width, video_height);
 }
 
+/* Appends one section of a sliced texture to the strip being built up
+ * in gfx_display_draw_texture_slice(). Sections after the first are
+ * joined to the previous one with a pair of degenerate triangles, so
+ * the whole slice can be submitted as a single draw. */
+static void gfx_display_texture_slice_append(
+      float *vert_out, float *tex_out, float *color_out,
+      unsigned *vertices,
+      const float *vert_coord, const float *tex_coord,
+      const float *color)
+{
+   unsigned i;
+   unsigned v = *vertices;
+
+   if (v)
+   {
+      memcpy(&vert_out[v * 2],  &vert_out[(v - 1) * 2],  2 * sizeof(float));
+      memcpy(&tex_out[v * 2],   &tex_out[(v - 1) * 2],   2 * sizeof(float));
+      memcpy(&color_out[v * 4], &color_out[(v - 1) * 4], 4 * sizeof(float));
+      v++;
+      memcpy(&vert_out[v * 2],  vert_coord, 2 * sizeof(float));
+      memcpy(&tex_out[v * 2],   tex_coord,  2 * sizeof(float));
+      memcpy(&color_out[v * 4], color,      4 * sizeof(float));
+      v++;
+   }
+
+   for (i = 0; i < 4; i++, v++)
+   {
+      memcpy(&vert_out[v * 2],  &vert_coord[i * 2], 2 * sizeof(float));
+      memcpy(&tex_out[v * 2],   &tex_coord[i * 2],  2 * sizeof(float));
+      memcpy(&color_out[v * 4], &color[i * 4],      4 * sizeof(float));
+   }
+
+   *vertices = v;
+}
+
 /* Draw the texture split into 9 sections, without scaling the corners.
  * The middle sections will only scale in the X axis, and the side
  * sections will only scale in the Y axis. */
@@ -1057,6 +1241,13 @@ void gfx_display_draw_texture_slice(
    float tex_coord[8];
    float vert_coord[8];
    float colors[16];
+   /* 9 sections of 4 strip vertices each, plus 2 degenerate vertices
+    * between consecutive sections: 9 * 4 + 8 * 2 = 52 */
+   float slice_vert[104];
+   float slice_tex[104];
+   float slice_color[208];
+   unsigned vertices = 0;
+   const float *draw_color;
 
    /* normalized width/height of the amount to offset from the corners,
     * for both the vertex and texture coordinates */
@@ -1105,17 +1296,18 @@ void gfx_display_draw_texture_slice(
    rotate_draw.scale_y      = 1.0;
    rotate_draw.scale_z      = 1;
    rotate_draw.scale_enable = true;
-   coords.vertices          = 4;
-   coords.vertex            = vert_coord;
-   coords.tex_coord         = tex_coord;
+   draw_color               = (const float*)(color == NULL ? colors : color);
+
+   coords.vertex            = slice_vert;
+   coords.tex_coord         = slice_tex;
    coords.lut_tex_coord     = NULL;
+   coords.color             = slice_color;
    draw.width               = width;
    draw.height              = height;
    draw.coords              = &coords;
    draw.matrix_data         = &mymat;
    draw.prim_type           = GFX_DISPLAY_PRIM_TRIANGLESTRIP;
    draw.pipeline_id         = 0;
-   coords.color             = (const float*)(color == NULL ? colors : color);
 
    gfx_display_rotate_z(&rotate_draw, userdata);
 
@@ -1126,9 +1318,6 @@ void gfx_display_draw_texture_slice(
    /* vertex coords are specfied bottom-up in this order: BL BR TL TR */
    /* texture coords are specfied top-down in this order: BL BR TL TR */
 
-   /* If someone wants to change this to not draw several times, the
-    * coordinates will need to be modified because of the triangle strip usage. */
-
    /* top-left corner */
    vert_coord[0] = V_BL[0];
    vert_coord[1] = V_BL[1];
@@ -1148,8 +1337,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* top-middle section */
    vert_coord[0] = V_BL[0] + vert_woff;
@@ -1170,8 +1359,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* top-right corner */
    vert_coord[0] = V_BL[0] + vert_woff + vert_scaled_mid_width;
@@ -1192,8 +1381,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width + tex_woff;
    tex_coord[7] = T_TR[1];
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* middle-left section */
    vert_coord[0] = V_BL[0];
@@ -1214,8 +1403,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* center section */
    vert_coord[0] = V_BL[0] + vert_woff;
@@ -1236,8 +1425,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* middle-right section */
    vert_coord[0] = V_BL[0] + vert_woff + vert_scaled_mid_width;
@@ -1258,8 +1447,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_woff + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff;
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* bottom-left corner */
    vert_coord[0] = V_BL[0];
@@ -1280,8 +1469,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0];
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* bottom-middle section */
    vert_coord[0] = V_BL[0] + vert_woff;
@@ -1302,8 +1491,8 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
-   gfx_display_draw(&draw, userdata,
-         video_width, video_height);
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
 
    /* bottom-right corner */
    vert_coord[0] = V_BL[0] + vert_woff + vert_scaled_mid_width;
@@ -1324,6 +1513,12 @@ void gfx_display_draw_texture_slice(
    tex_coord[6] = T_TR[0] + tex_woff + tex_mid_width;
    tex_coord[7] = T_TR[1] + tex_hoff + tex_mid_height;
 
+   gfx_display_texture_slice_append(slice_vert, slice_tex, slice_color,
+         &vertices, vert_coord, tex_coord, draw_color);
+
+   /* submit all nine sections as a single strip */
+   coords.vertices = vertices;
+
    gfx_display_draw(&draw, userdata,
          video_width, video_height);
 }
@@ -1792,6 +1987,147 @@ void gfx_display_draw_text(
    video_driver_set_osd_msg(text, &params, (void*)font);
 }
 
+/* Decoded menu asset cache
+ * > Menu icons and backgrounds are PNGs that have to be
+ *   inflated one by one on the menu thread every time a
+ *   theme is (re)loaded
+ * > After the first decode the raw pixel data is written
+ *   to the cache directory; later loads are a single read
+ *   handed straight to the texture upload, skipping the
+ *   decoder entirely
+ * > Entries are keyed by a hash of the asset path and
+ *   validated against the source file size and the pixel
+ *   ordering of the current video driver */
+
+#define GFX_DISPLAY_ASSET_CACHE_MAGIC   0x43414D52 /* 'RMAC' */
+#define GFX_DISPLAY_ASSET_CACHE_VERSION 1
+
+struct gfx_display_asset_cache_header
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t width;
+   uint32_t height;
+   uint32_t source_size;
+   uint32_t is_rgba;
+};
+
+static bool gfx_display_asset_cache_path(const char *texpath,
+      char *s, size_t len, char *dir, size_t dir_len)
+{
+   char name[32];
+   uint32_t hash;
+   settings_t *settings = config_get_ptr();
+
+   if (!settings || string_is_empty(settings->paths.directory_cache))
+      return false;
+
+   fill_pathname_join(dir, settings->paths.directory_cache,
+         "menu_assets", dir_len);
+
+   hash = encoding_crc32(0, (const uint8_t*)texpath, strlen(texpath));
+   snprintf(name, sizeof(name), "%08x.rgba", (unsigned)hash);
+   fill_pathname_join(s, dir, name, len);
+
+   return true;
+}
+
+static bool gfx_display_asset_cache_load(const char *texpath,
+      struct texture_image *ti)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   char cache_dir[PATH_MAX_LENGTH];
+   struct gfx_display_asset_cache_header header;
+   uint32_t *pixels  = NULL;
+   void *buf         = NULL;
+   int64_t len       = 0;
+   size_t pixel_size = 0;
+
+   if (!gfx_display_asset_cache_path(texpath,
+            cache_path, sizeof(cache_path),
+            cache_dir, sizeof(cache_dir)))
+      return false;
+
+   if (!path_is_valid(cache_path))
+      return false;
+
+   if (!filestream_read_file(cache_path, &buf, &len) || !buf)
+      return false;
+
+   if (len < (int64_t)sizeof(header))
+      goto error;
+
+   memcpy(&header, buf, sizeof(header));
+
+   if (     (header.magic      != GFX_DISPLAY_ASSET_CACHE_MAGIC)
+         || (header.version    != GFX_DISPLAY_ASSET_CACHE_VERSION)
+         || ((header.is_rgba != 0) != ti->supports_rgba)
+         || (header.width  == 0) || (header.width  > 16384)
+         || (header.height == 0) || (header.height > 16384))
+      goto error;
+
+   /* Source asset was replaced - entry is stale. */
+   if (header.source_size != (uint32_t)path_get_size(texpath))
+      goto error;
+
+   pixel_size = (size_t)header.width * header.height * sizeof(uint32_t);
+   if ((int64_t)(sizeof(header) + pixel_size) != len)
+      goto error;
+
+   if (!(pixels = (uint32_t*)malloc(pixel_size)))
+      goto error;
+
+   memcpy(pixels, (const uint8_t*)buf + sizeof(header), pixel_size);
+
+   ti->width  = header.width;
+   ti->height = header.height;
+   ti->pixels = pixels;
+
+   free(buf);
+   return true;
+
+error:
+   free(buf);
+   return false;
+}
+
+static void gfx_display_asset_cache_save(const char *texpath,
+      const struct texture_image *ti)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   char cache_dir[PATH_MAX_LENGTH];
+   struct gfx_display_asset_cache_header header;
+   RFILE *file = NULL;
+
+   if (!ti->pixels || (ti->width == 0) || (ti->height == 0))
+      return;
+
+   if (!gfx_display_asset_cache_path(texpath,
+            cache_path, sizeof(cache_path),
+            cache_dir, sizeof(cache_dir)))
+      return;
+
+   if (!path_is_directory(cache_dir) && !path_mkdir(cache_dir))
+      return;
+
+   if (!(file = filestream_open(cache_path,
+               RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return;
+
+   header.magic       = GFX_DISPLAY_ASSET_CACHE_MAGIC;
+   header.version     = GFX_DISPLAY_ASSET_CACHE_VERSION;
+   header.width       = ti->width;
+   header.height      = ti->height;
+   header.source_size = (uint32_t)path_get_size(texpath);
+   header.is_rgba     = ti->supports_rgba ? 1 : 0;
+
+   filestream_write(file, &header, sizeof(header));
+   filestream_write(file, ti->pixels,
+         (size_t)ti->width * ti->height * sizeof(uint32_t));
+   filestream_close(file);
+}
+
 bool gfx_display_reset_textures_list(
       const char *texture_path, const char *iconpath,
       uintptr_t *item, enum texture_filter_type filter_type,
@@ -1799,6 +2135,7 @@ bool gfx_display_reset_textures_list(
 {
    char texpath[PATH_MAX_LENGTH];
    struct texture_image ti;
+   bool cached                   = false;
 
    texpath[0]                    = '\0';
 
@@ -1815,7 +2152,11 @@ bool gfx_display_reset_textures_list(
    if (!path_is_valid(texpath))
       return false;
 
-   if (!image_texture_load(&ti, texpath))
+   /* A cache hit hands the decoded pixels straight
+    * to the texture upload. */
+   if (gfx_display_asset_cache_load(texpath, &ti))
+      cached = true;
+   else if (!image_texture_load(&ti, texpath))
       return false;
 
    if (width)
@@ -1826,6 +2167,10 @@ bool gfx_display_reset_textures_list(
 
    video_driver_texture_load(&ti,
          filter_type, item);
+
+   if (!cached)
+      gfx_display_asset_cache_save(texpath, &ti);
+
    image_texture_free(&ti);
 
    return true;
@@ -1887,6 +2232,7 @@ void gfx_display_free(void)
 {
    gfx_display_t           *p_disp   = disp_get_ptr();
    video_coord_array_free(&p_disp->dispca);
+   video_coord_array_free(&p_disp->batchca);
    gfx_animation_ctl(MENU_ANIMATION_CTL_DEINIT, NULL);
 
    p_disp->msg_force           = false;
@@ -1905,6 +2251,8 @@ void gfx_display_init(void)
 
    p_disp->has_windowed          = video_driver_has_windowed();
    p_dispca->allocated           =  0;
+   p_disp->batchca.allocated     =  0;
+   p_disp->batchca.coords.vertices = 0;
 }
 
 bool gfx_display_driver_exists(const char *s)
@@ -204,6 +204,11 @@ struct gfx_display
    gfx_display_ctx_driver_t *dispctx;
    video_coord_array_t dispca; /* ptr alignment */
 
+   /* Quads queued by gfx_display_batch_quad(), waiting to be
+    * submitted as a single draw by gfx_display_batch_flush() */
+   video_coord_array_t batchca; /* ptr alignment */
+   uintptr_t batch_texture;
+
    /* Width, height and pitch of the display framebuffer */
    size_t   framebuf_pitch;
    unsigned framebuf_width;
@@ -234,6 +239,19 @@ void gfx_display_push_quad(
       const float *colors, int x1, int y1,
       int x2, int y2);
 
+void gfx_display_batch_quad(
+      void *userdata,
+      unsigned video_width,
+      unsigned video_height,
+      int x, int y, unsigned w, unsigned h,
+      unsigned width, unsigned height,
+      float *color, uintptr_t texture);
+
+void gfx_display_batch_flush(
+      void *userdata,
+      unsigned video_width,
+      unsigned video_height);
+
 void gfx_display_snow(
       int16_t pointer_x,
       int16_t pointer_y,
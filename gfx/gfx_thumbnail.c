@@ -27,6 +27,7 @@
 #include <features/features_cpu.h>
 #include <file/file_path.h>
 #include <string/stdstring.h>
+#include <formats/image.h>
 
 #include "gfx_display.h"
 #include "gfx_animation.h"
@@ -34,18 +35,200 @@
 #include "gfx_thumbnail.h"
 
 #include "../tasks/tasks_internal.h"
+#include "../cache_coordinator.h"
 
 #define DEFAULT_GFX_THUMBNAIL_STREAM_DELAY  83.333333f
 #define DEFAULT_GFX_THUMBNAIL_FADE_DURATION 166.66667f
 
+/* Byte budget for the decoded thumbnail cache. Entries
+ * are evicted least-recently-used once the combined
+ * size of the cached pixel buffers exceeds this limit */
+#define GFX_THUMBNAIL_CACHE_BUDGET (32 * 1024 * 1024)
+
+/* Decoded images larger than this on either axis are
+ * reduced by successive 2x2 box filtering before the
+ * GPU upload. Bounds both VRAM usage and upload stalls
+ * when scanning through playlists with oversized
+ * artwork, at no visible cost at menu display sizes */
+#define GFX_THUMBNAIL_MAX_DIMENSION 1024
+
 /* Utility structure, sent as userdata when pushing
  * an image load */
 typedef struct
 {
    uint64_t list_id;
    gfx_thumbnail_t *thumbnail;
+   /* Source path of the image load - used to key the
+    * decoded thumbnail cache (NULL if the image should
+    * not be cached, e.g. savestate previews that may
+    * change on disk) */
+   char *path;
 } gfx_thumbnail_tag_t;
 
+/* In-memory cache of decoded thumbnail images
+ * > When an entry scrolls back into view, the cached
+ *   pixels are re-uploaded to the GPU directly - no
+ *   disk access or PNG/JPEG decode is involved
+ * > Only ever touched from the main thread (requests
+ *   and image load task callbacks), so no locking is
+ *   required */
+typedef struct gfx_thumbnail_cache_entry
+{
+   char *path;
+   struct texture_image image;
+   struct gfx_thumbnail_cache_entry *prev;
+   struct gfx_thumbnail_cache_entry *next;
+} gfx_thumbnail_cache_entry_t;
+
+static gfx_thumbnail_cache_entry_t *gfx_thumbnail_cache_head = NULL;
+static gfx_thumbnail_cache_entry_t *gfx_thumbnail_cache_tail = NULL;
+static size_t gfx_thumbnail_cache_bytes                      = 0;
+
+static size_t gfx_thumbnail_cache_image_bytes(
+      const struct texture_image *image)
+{
+   return (size_t)image->width * (size_t)image->height *
+         sizeof(uint32_t);
+}
+
+/* Unlinks and frees the specified cache entry */
+static void gfx_thumbnail_cache_evict(gfx_thumbnail_cache_entry_t *entry)
+{
+   if (entry->prev)
+      entry->prev->next = entry->next;
+   else
+      gfx_thumbnail_cache_head = entry->next;
+
+   if (entry->next)
+      entry->next->prev = entry->prev;
+   else
+      gfx_thumbnail_cache_tail = entry->prev;
+
+   gfx_thumbnail_cache_bytes -= gfx_thumbnail_cache_image_bytes(&entry->image);
+
+   image_texture_free(&entry->image);
+   free(entry->path);
+   free(entry);
+}
+
+/* Moves the specified cache entry to the
+ * most-recently-used position */
+static void gfx_thumbnail_cache_promote(gfx_thumbnail_cache_entry_t *entry)
+{
+   if (entry == gfx_thumbnail_cache_head)
+      return;
+
+   /* Unlink... */
+   entry->prev->next = entry->next;
+   if (entry->next)
+      entry->next->prev = entry->prev;
+   else
+      gfx_thumbnail_cache_tail = entry->prev;
+
+   /* ...and relink at the head */
+   entry->prev                    = NULL;
+   entry->next                    = gfx_thumbnail_cache_head;
+   gfx_thumbnail_cache_head->prev = entry;
+   gfx_thumbnail_cache_head       = entry;
+}
+
+/* Returns cached decoded image for the specified
+ * path, or NULL if it is not resident */
+static gfx_thumbnail_cache_entry_t *gfx_thumbnail_cache_find(
+      const char *path)
+{
+   gfx_thumbnail_cache_entry_t *entry = gfx_thumbnail_cache_head;
+
+   for (; entry; entry = entry->next)
+      if (string_is_equal(entry->path, path))
+         return entry;
+
+   return NULL;
+}
+
+/* Cache coordinator hooks - let the global budget
+ * shrink this cache alongside the other frontend
+ * caches under memory pressure */
+static size_t gfx_thumbnail_cache_size(void)
+{
+   return gfx_thumbnail_cache_bytes;
+}
+
+static void gfx_thumbnail_cache_shrink(size_t limit)
+{
+   while (gfx_thumbnail_cache_tail
+         && gfx_thumbnail_cache_bytes > limit)
+      gfx_thumbnail_cache_evict(gfx_thumbnail_cache_tail);
+}
+
+/* Adds a decoded image to the cache, evicting
+ * least-recently-used entries to stay within budget
+ * > On success the cache takes ownership of the pixel
+ *   buffer and true is returned
+ * > On failure the caller retains ownership */
+static bool gfx_thumbnail_cache_insert(
+      const char *path, struct texture_image *image)
+{
+   gfx_thumbnail_cache_entry_t *entry = NULL;
+   size_t image_bytes                 = gfx_thumbnail_cache_image_bytes(image);
+
+   /* Images larger than the entire budget can never
+    * be cached */
+   if (image_bytes > GFX_THUMBNAIL_CACHE_BUDGET)
+      return false;
+
+   /* If the path is already resident (e.g. two requests
+    * for the same image were in flight at once), keep
+    * the existing entry */
+   if (gfx_thumbnail_cache_find(path))
+      return false;
+
+   /* Evict until the new image fits */
+   while (gfx_thumbnail_cache_tail &&
+          (gfx_thumbnail_cache_bytes + image_bytes >
+               GFX_THUMBNAIL_CACHE_BUDGET))
+      gfx_thumbnail_cache_evict(gfx_thumbnail_cache_tail);
+
+   entry = (gfx_thumbnail_cache_entry_t*)malloc(sizeof(*entry));
+
+   if (!entry)
+      return false;
+
+   entry->path = strdup(path);
+
+   if (!entry->path)
+   {
+      free(entry);
+      return false;
+   }
+
+   entry->image = *image;
+   entry->prev  = NULL;
+   entry->next  = gfx_thumbnail_cache_head;
+
+   if (gfx_thumbnail_cache_head)
+      gfx_thumbnail_cache_head->prev = entry;
+   else
+      gfx_thumbnail_cache_tail       = entry;
+
+   gfx_thumbnail_cache_head   = entry;
+   gfx_thumbnail_cache_bytes += image_bytes;
+
+   cache_coordinator_register("menu_thumbnails",
+         gfx_thumbnail_cache_size, gfx_thumbnail_cache_shrink);
+   cache_coordinator_touch("menu_thumbnails");
+
+   return true;
+}
+
+/* Releases all decoded images held by the thumbnail
+ * cache */
+void gfx_thumbnail_cache_purge(void)
+{
+   while (gfx_thumbnail_cache_head)
+      gfx_thumbnail_cache_evict(gfx_thumbnail_cache_head);
+}
+
 /* Setters */
 
 /* When streaming thumbnails, sets time in ms that an
@@ -161,6 +344,58 @@ static void gfx_thumbnail_init_fade(
    }
 }
 
+/* Halves image dimensions in place with a 2x2 box
+ * filter (per-channel average). The last row/column
+ * of odd-sized images is dropped. Works in place
+ * because destination offsets never overtake the
+ * source reads of the same iteration */
+static void gfx_thumbnail_halve_image(struct texture_image *img)
+{
+   unsigned x, y;
+   unsigned dst_width  = img->width >> 1;
+   unsigned dst_height = img->height >> 1;
+   uint32_t *dst       = img->pixels;
+   uint32_t *shrunk    = NULL;
+
+   for (y = 0; y < dst_height; y++)
+   {
+      const uint32_t *row0 = img->pixels + (size_t)(y << 1) * img->width;
+      const uint32_t *row1 = row0 + img->width;
+
+      for (x = 0; x < dst_width; x++)
+      {
+         uint32_t p00 = row0[(x << 1)];
+         uint32_t p01 = row0[(x << 1) + 1];
+         uint32_t p10 = row1[(x << 1)];
+         uint32_t p11 = row1[(x << 1) + 1];
+         /* Channel sums need 10 bits; the masked pairs
+          * leave enough headroom for that */
+         uint32_t rb  = ( (p00        & 0x00ff00ffu) +
+                          (p01        & 0x00ff00ffu) +
+                          (p10        & 0x00ff00ffu) +
+                          (p11        & 0x00ff00ffu)) >> 2;
+         uint32_t ag  = (((p00 >> 8)  & 0x00ff00ffu) +
+                         ((p01 >> 8)  & 0x00ff00ffu) +
+                         ((p10 >> 8)  & 0x00ff00ffu) +
+                         ((p11 >> 8)  & 0x00ff00ffu)) >> 2;
+
+         dst[x] = (rb & 0x00ff00ffu) | ((ag & 0x00ff00ffu) << 8);
+      }
+
+      dst += dst_width;
+   }
+
+   img->width  = dst_width;
+   img->height = dst_height;
+
+   /* Release the now-unused tail of the pixel buffer */
+   shrunk = (uint32_t*)realloc(img->pixels,
+         (size_t)dst_width * dst_height * sizeof(uint32_t));
+
+   if (shrunk)
+      img->pixels = shrunk;
+}
+
 /* Used to process thumbnail data following completion
  * of image load task */
 static void gfx_thumbnail_handle_upload(
@@ -171,6 +406,15 @@ static void gfx_thumbnail_handle_upload(
    gfx_thumbnail_tag_t *thumbnail_tag = (gfx_thumbnail_tag_t*)user_data;
    bool fade_enabled                  = false;
 
+   /* Bound texture dimensions before the upload (and
+    * before the image reaches the cache) - done first
+    * so stale loads are shrunk too */
+   if (img && img->pixels)
+      while (((img->width  > GFX_THUMBNAIL_MAX_DIMENSION)  ||
+              (img->height > GFX_THUMBNAIL_MAX_DIMENSION)) &&
+             (img->width > 1) && (img->height > 1))
+         gfx_thumbnail_halve_image(img);
+
    /* Sanity check */
    if (!thumbnail_tag)
       goto end;
@@ -221,7 +465,14 @@ end:
    /* Clean up */
    if (img)
    {
-      image_texture_free(img);
+      /* Stash the decoded pixels in the cache - even if
+       * this particular upload turned out to be stale,
+       * they remain valid for the next request of the
+       * same path */
+      if (!(thumbnail_tag && thumbnail_tag->path &&
+            (img->width > 0) && (img->height > 0) &&
+            gfx_thumbnail_cache_insert(thumbnail_tag->path, img)))
+         image_texture_free(img);
       free(img);
    }
 
@@ -232,6 +483,8 @@ end:
          gfx_thumbnail_init_fade(p_gfx_thumb,
                thumbnail_tag->thumbnail);
 
+      if (thumbnail_tag->path)
+         free(thumbnail_tag->path);
       free(thumbnail_tag);
    }
 }
@@ -295,7 +548,29 @@ void gfx_thumbnail_request(
    {
       if (path_is_valid(thumbnail_path))
       {
-         gfx_thumbnail_tag_t *thumbnail_tag =
+         gfx_thumbnail_tag_t *thumbnail_tag         = NULL;
+         gfx_thumbnail_cache_entry_t *cached_entry  =
+               gfx_thumbnail_cache_find(thumbnail_path);
+
+         /* Cache hit - upload the previously decoded
+          * pixels directly, skipping both the disk read
+          * and the decoder */
+         if (cached_entry)
+         {
+            gfx_thumbnail_cache_promote(cached_entry);
+
+            if (video_driver_texture_load(
+                  &cached_entry->image, TEXTURE_FILTER_MIPMAP_LINEAR,
+                  &thumbnail->texture))
+            {
+               thumbnail->width  = cached_entry->image.width;
+               thumbnail->height = cached_entry->image.height;
+               thumbnail->status = GFX_THUMBNAIL_STATUS_AVAILABLE;
+               goto end;
+            }
+         }
+
+         thumbnail_tag =
                (gfx_thumbnail_tag_t*)malloc(sizeof(gfx_thumbnail_tag_t));
 
          if (!thumbnail_tag)
@@ -304,6 +579,7 @@ void gfx_thumbnail_request(
          /* Configure user data */
          thumbnail_tag->thumbnail = thumbnail;
          thumbnail_tag->list_id   = p_gfx_thumb->list_id;
+         thumbnail_tag->path      = strdup(thumbnail_path);
 
          /* Would like to cancel any existing image load tasks
           * here, but can't see how to do it... */
@@ -401,9 +677,13 @@ void gfx_thumbnail_request_file(
    if (!thumbnail_tag)
       return;
 
-   /* Configure user data */
+   /* Configure user data
+    * > Note: 'path' is left unset, since arbitrary image
+    *   files (e.g. savestate previews) may be rewritten
+    *   on disk at any time and must not be cached */
    thumbnail_tag->thumbnail = thumbnail;
    thumbnail_tag->list_id   = p_gfx_thumb->list_id;
+   thumbnail_tag->path      = NULL;
 
    /* Would like to cancel any existing image load tasks
     * here, but can't see how to do it... */
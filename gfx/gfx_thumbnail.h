@@ -201,6 +201,10 @@ void gfx_thumbnail_request_file(
  * specified thumbnail */
 void gfx_thumbnail_reset(gfx_thumbnail_t *thumbnail);
 
+/* Releases all decoded images held by the in-memory
+ * thumbnail cache */
+void gfx_thumbnail_cache_purge(void);
+
 /* Stream processing */
 
 /* Handles streaming of the specified thumbnail as it moves
@@ -35,6 +35,15 @@
 #include "video_filter.h"
 #include "video_filters/softfilter.h"
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+/* Each worker pulls strips from a shared pool, so the image is split
+ * finer than the thread count; fast cores pick up strips that slow
+ * cores have not started yet instead of idling on a static row split. */
+#define SOFTFILTER_STRIPS_PER_THREAD 4
+
 struct rarch_soft_plug
 {
 #ifdef HAVE_DYLIB
@@ -57,20 +66,21 @@ struct rarch_softfilter
    enum retro_pixel_format pix_fmt, out_pix_fmt;
 
    struct softfilter_work_packet *packets;
+   unsigned num_packets;
    unsigned threads;
 
 #ifdef HAVE_THREADS
    struct filter_thread_data *thread_data;
+   slock_t *sched_lock;
+   unsigned sched_next;
 #endif
 };
 
 #ifdef HAVE_THREADS
-#include <rthreads/rthreads.h>
-
 struct filter_thread_data
 {
    sthread_t *thread;
-   const struct softfilter_work_packet *packet;
+   struct rarch_softfilter *filt;
    scond_t *cond;
    slock_t *lock;
    void *userdata;
@@ -94,8 +104,23 @@ static void filter_thread_loop(void *data)
       if (die)
          break;
 
-      if (thr->packet && thr->packet->work)
-         thr->packet->work(thr->userdata, thr->packet->thread_data);
+      /* Drain the packet pool together with the other workers. */
+      for (;;)
+      {
+         const struct softfilter_work_packet *packet;
+         unsigned i;
+
+         slock_lock(thr->filt->sched_lock);
+         i = thr->filt->sched_next++;
+         slock_unlock(thr->filt->sched_lock);
+
+         if (i >= thr->filt->num_packets)
+            break;
+
+         packet = &thr->filt->packets[i];
+         if (packet->work)
+            packet->work(thr->userdata, packet->thread_data);
+      }
 
       slock_lock(thr->lock);
       thr->done = true;
@@ -207,10 +232,12 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
    filt->max_width = max_width;
    filt->max_height = max_height;
 
+   if (threads == RARCH_SOFTFILTER_THREADS_AUTO)
+      threads = cpu_features_get_core_amount();
+
    filt->impl_data = filt->impl->create(
          &softfilter_config, input_fmt, input_fmt, max_width, max_height,
-         threads != RARCH_SOFTFILTER_THREADS_AUTO ? threads :
-         cpu_features_get_core_amount(), cpu_features,
+         threads * SOFTFILTER_STRIPS_PER_THREAD, cpu_features,
          &userdata);
    if (!filt->impl_data)
    {
@@ -218,18 +245,19 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
       return false;
    }
 
-   threads = filt->impl->query_num_threads(filt->impl_data);
-   if (!threads)
+   filt->num_packets = filt->impl->query_num_threads(filt->impl_data);
+   if (!filt->num_packets)
    {
       RARCH_ERR("Invalid number of threads.\n");
       return false;
    }
 
-   filt->threads = threads;
-   RARCH_LOG("Using %u threads for softfilter.\n", threads);
+   filt->threads = MIN(threads, filt->num_packets);
+   RARCH_LOG("Using %u threads (%u strips) for softfilter.\n",
+         filt->threads, filt->num_packets);
 
    filt->packets = (struct softfilter_work_packet*)
-      calloc(threads, sizeof(*filt->packets));
+      calloc(filt->num_packets, sizeof(*filt->packets));
    if (!filt->packets)
    {
       RARCH_ERR("Failed to allocate softfilter packets.\n");
@@ -239,13 +267,18 @@ static bool create_softfilter_graph(rarch_softfilter_t *filt,
 #ifdef HAVE_THREADS
    if (filt->threads > 1)
    {
+      filt->sched_lock  = slock_new();
+      if (!filt->sched_lock)
+         return false;
+
       filt->thread_data = (struct filter_thread_data*)
-         calloc(threads, sizeof(*filt->thread_data));
+         calloc(filt->threads, sizeof(*filt->thread_data));
       if (!filt->thread_data)
          return false;
 
-      for (i = 0; i < threads; i++)
+      for (i = 0; i < filt->threads; i++)
       {
+         filt->thread_data[i].filt     = filt;
          filt->thread_data[i].userdata = filt->impl_data;
          filt->thread_data[i].done     = true;
 
@@ -494,6 +527,8 @@ void rarch_softfilter_free(rarch_softfilter_t *filt)
       }
       free(filt->thread_data);
    }
+   if (filt->sched_lock)
+      slock_free(filt->sched_lock);
 #endif
 
    if (filt->conf)
@@ -541,13 +576,15 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
 #ifdef HAVE_THREADS
    if (filt->threads > 1)
    {
+      /* All workers are idle here, no lock needed */
+      filt->sched_next = 0;
+
       /* Fire off workers */
       for (i = 0; i < filt->threads; i++)
       {
 #if 0
          RARCH_LOG("Firing off filter thread %u ...\n", i);
 #endif
-         filt->thread_data[i].packet = &filt->packets[i];
          slock_lock(filt->thread_data[i].lock);
          filt->thread_data[i].done = false;
          scond_signal(filt->thread_data[i].cond);
@@ -569,6 +606,6 @@ void rarch_softfilter_process(rarch_softfilter_t *filt,
    }
 #endif
 
-   for (i = 0; i < filt->threads; i++)
+   for (i = 0; i < filt->num_packets; i++)
       filt->packets[i].work(filt->impl_data, filt->packets[i].thread_data);
 }
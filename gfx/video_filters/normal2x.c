@@ -20,6 +20,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NORMAL2X_SIMD
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#define NORMAL2X_NEON
+#define NORMAL2X_SIMD
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation normal2x_get_implementation
 #define softfilter_thread_data normal2x_softfilter_thread_data
@@ -75,10 +84,10 @@ static void *normal2x_generic_create(const struct softfilter_config *config,
    if (!filt) {
       return NULL;
    }
-   /* Apparently the code is not thread-safe,
-    * so force single threaded operation... */
-   filt->workers = (struct softfilter_thread_data*)calloc(1, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
+   /* Each strip writes its own output rows only,
+    * so row splits are safe to run concurrently. */
+   filt->workers = (struct softfilter_thread_data*)calloc(threads, sizeof(struct softfilter_thread_data));
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    if (!filt->workers) {
       free(filt);
@@ -117,7 +126,39 @@ static void normal2x_work_cb_xrgb8888(void *data, void *thread_data)
    for (y = 0; y < thr->height; ++y)
    {
       uint32_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+
+      x = 0;
+
+#if defined(NORMAL2X_NEON)
+      for (; x + 4 <= thr->width; x += 4)
+      {
+         uint32x4_t   color = vld1q_u32(input + x);
+         uint32x4x2_t pair  = vzipq_u32(color, color);
+
+         vst1q_u32(out_ptr,                  pair.val[0]);
+         vst1q_u32(out_ptr + 4,              pair.val[1]);
+         vst1q_u32(out_ptr + out_stride,     pair.val[0]);
+         vst1q_u32(out_ptr + out_stride + 4, pair.val[1]);
+
+         out_ptr += 8;
+      }
+#elif defined(NORMAL2X_SIMD)
+      for (; x + 4 <= thr->width; x += 4)
+      {
+         __m128i color = _mm_loadu_si128((const __m128i*)(input + x));
+         __m128i lo    = _mm_unpacklo_epi32(color, color);
+         __m128i hi    = _mm_unpackhi_epi32(color, color);
+
+         _mm_storeu_si128((__m128i*)out_ptr,                    lo);
+         _mm_storeu_si128((__m128i*)(out_ptr + 4),              hi);
+         _mm_storeu_si128((__m128i*)(out_ptr + out_stride),     lo);
+         _mm_storeu_si128((__m128i*)(out_ptr + out_stride + 4), hi);
+
+         out_ptr += 8;
+      }
+#endif
+
+      for (; x < thr->width; ++x)
       {
          uint32_t color = *(input + x);
          uint32_t color_buf[2];
@@ -148,7 +189,39 @@ static void normal2x_work_cb_rgb565(void *data, void *thread_data)
    for (y = 0; y < thr->height; ++y)
    {
       uint16_t *out_ptr = output;
-      for (x = 0; x < thr->width; ++x)
+
+      x = 0;
+
+#if defined(NORMAL2X_NEON)
+      for (; x + 8 <= thr->width; x += 8)
+      {
+         uint16x8_t   color = vld1q_u16(input + x);
+         uint16x8x2_t pair  = vzipq_u16(color, color);
+
+         vst1q_u16(out_ptr,                  pair.val[0]);
+         vst1q_u16(out_ptr + 8,              pair.val[1]);
+         vst1q_u16(out_ptr + out_stride,     pair.val[0]);
+         vst1q_u16(out_ptr + out_stride + 8, pair.val[1]);
+
+         out_ptr += 16;
+      }
+#elif defined(NORMAL2X_SIMD)
+      for (; x + 8 <= thr->width; x += 8)
+      {
+         __m128i color = _mm_loadu_si128((const __m128i*)(input + x));
+         __m128i lo    = _mm_unpacklo_epi16(color, color);
+         __m128i hi    = _mm_unpackhi_epi16(color, color);
+
+         _mm_storeu_si128((__m128i*)out_ptr,                    lo);
+         _mm_storeu_si128((__m128i*)(out_ptr + 8),              hi);
+         _mm_storeu_si128((__m128i*)(out_ptr + out_stride),     lo);
+         _mm_storeu_si128((__m128i*)(out_ptr + out_stride + 8), hi);
+
+         out_ptr += 16;
+      }
+#endif
+
+      for (; x < thr->width; ++x)
       {
          uint16_t color = *(input + x);
          uint16_t color_buf[2];
@@ -172,27 +245,29 @@ static void normal2x_generic_packets(void *data,
       void *output, size_t output_stride,
       const void *input, unsigned width, unsigned height, size_t input_stride)
 {
-   /* We are guaranteed single threaded operation
-    * (filt->threads = 1) so we don't need to loop
-    * over threads and can cull some code. This only
-    * makes the tiniest performance difference, but
-    * every little helps when running on an o3DS... */
    struct filter_data *filt = (struct filter_data*)data;
-   struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[0];
-
-   thr->out_data = (uint8_t*)output;
-   thr->in_data = (const uint8_t*)input;
-   thr->out_pitch = output_stride;
-   thr->in_pitch = input_stride;
-   thr->width = width;
-   thr->height = height;
-
-   if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888) {
-      packets[0].work = normal2x_work_cb_xrgb8888;
-   } else if (filt->in_fmt == SOFTFILTER_FMT_RGB565) {
-      packets[0].work = normal2x_work_cb_rgb565;
+   unsigned i;
+
+   for (i = 0; i < filt->threads; i++)
+   {
+      struct softfilter_thread_data *thr = (struct softfilter_thread_data*)&filt->workers[i];
+
+      unsigned y_start = (height * i) / filt->threads;
+      unsigned y_end = (height * (i + 1)) / filt->threads;
+      thr->out_data = (uint8_t*)output + y_start * 2 * output_stride;
+      thr->in_data = (const uint8_t*)input + y_start * input_stride;
+      thr->out_pitch = output_stride;
+      thr->in_pitch = input_stride;
+      thr->width = width;
+      thr->height = y_end - y_start;
+
+      if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888) {
+         packets[i].work = normal2x_work_cb_xrgb8888;
+      } else if (filt->in_fmt == SOFTFILTER_FMT_RGB565) {
+         packets[i].work = normal2x_work_cb_rgb565;
+      }
+      packets[i].thread_data = thr;
    }
-   packets[0].thread_data = thr;
 }
 
 static const struct softfilter_implementation normal2x_generic = {
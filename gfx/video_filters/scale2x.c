@@ -19,6 +19,15 @@
 #include "softfilter.h"
 #include <stdlib.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SCALE2X_SIMD
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#define SCALE2X_NEON
+#define SCALE2X_SIMD
+#endif
+
 #ifdef RARCH_INTERNAL
 #define softfilter_get_implementation scale2x_get_implementation
 #define softfilter_thread_data scale2x_softfilter_thread_data
@@ -82,6 +91,7 @@ struct filter_data
       out1 += dst_stride + dst_stride - (width * SCALE2X_SCALE); \
    }
 
+#ifndef SCALE2X_SIMD
 static void scale2x_generic_rgb565(unsigned width, unsigned height,
       int first, int last,
       const uint16_t *src, unsigned src_stride,
@@ -107,6 +117,200 @@ static void scale2x_generic_xrgb8888(unsigned width, unsigned height,
    SCALE2X_GENERIC(uint32_t, width, height, first, last,
          src, src_stride, dst, dst_stride, out0, out1);
 }
+#else
+
+/* Scalar helper for the columns the vector loop cannot reach
+ * (the edges, and anything left over after the last full vector). */
+#define SCALE2X_PIXEL(typename_t, x) \
+   do { \
+      const typename_t A = a_row[x]; \
+      const typename_t B = ((x) > 0) ? src[(x) - 1] : src[x]; \
+      const typename_t C = src[x]; \
+      const typename_t D = ((x) < width - 1) ? src[(x) + 1] : src[x]; \
+      const typename_t E = e_row[x]; \
+      if (A != E && B != D) \
+      { \
+         out0[2 * (x)]     = (A == B ? A : C); \
+         out0[2 * (x) + 1] = (A == D ? A : C); \
+         out1[2 * (x)]     = (E == B ? E : C); \
+         out1[2 * (x) + 1] = (E == D ? E : C); \
+      } \
+      else \
+      { \
+         out0[2 * (x)]     = C; \
+         out0[2 * (x) + 1] = C; \
+         out1[2 * (x)]     = C; \
+         out1[2 * (x) + 1] = C; \
+      } \
+   } while (0)
+
+static void scale2x_simd_xrgb8888(unsigned width, unsigned height,
+      int first, int last,
+      const uint32_t *src, unsigned src_stride,
+      uint32_t *dst, unsigned dst_stride)
+{
+   unsigned x, y;
+
+   for (y = 0; y < height; ++y)
+   {
+      const int prevline    = ((y == 0) && first) ? 0 : (int)src_stride;
+      const int nextline    = ((y == height - 1) && last) ? 0 : (int)src_stride;
+      const uint32_t *a_row = src - prevline;
+      const uint32_t *e_row = src + nextline;
+      uint32_t *out0        = dst;
+      uint32_t *out1        = dst + dst_stride;
+
+      x = 0;
+
+      if (width > 1)
+      {
+         SCALE2X_PIXEL(uint32_t, 0);
+         x = 1;
+
+#if defined(SCALE2X_NEON)
+         for (; x + 4 <= width - 1; x += 4)
+         {
+            uint32x4_t A    = vld1q_u32(a_row + x);
+            uint32x4_t B    = vld1q_u32(src + x - 1);
+            uint32x4_t C    = vld1q_u32(src + x);
+            uint32x4_t D    = vld1q_u32(src + x + 1);
+            uint32x4_t E    = vld1q_u32(e_row + x);
+            uint32x4_t cond = vandq_u32(
+                  vmvnq_u32(vceqq_u32(A, E)),
+                  vmvnq_u32(vceqq_u32(B, D)));
+            uint32x4_t o00  = vbslq_u32(vandq_u32(cond, vceqq_u32(A, B)), A, C);
+            uint32x4_t o01  = vbslq_u32(vandq_u32(cond, vceqq_u32(A, D)), A, C);
+            uint32x4_t o10  = vbslq_u32(vandq_u32(cond, vceqq_u32(E, B)), E, C);
+            uint32x4_t o11  = vbslq_u32(vandq_u32(cond, vceqq_u32(E, D)), E, C);
+            uint32x4x2_t r0 = vzipq_u32(o00, o01);
+            uint32x4x2_t r1 = vzipq_u32(o10, o11);
+
+            vst1q_u32(out0 + 2 * x,     r0.val[0]);
+            vst1q_u32(out0 + 2 * x + 4, r0.val[1]);
+            vst1q_u32(out1 + 2 * x,     r1.val[0]);
+            vst1q_u32(out1 + 2 * x + 4, r1.val[1]);
+         }
+#else
+         for (; x + 4 <= width - 1; x += 4)
+         {
+            const __m128i ones = _mm_set1_epi32(-1);
+            __m128i A    = _mm_loadu_si128((const __m128i*)(a_row + x));
+            __m128i B    = _mm_loadu_si128((const __m128i*)(src + x - 1));
+            __m128i C    = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i D    = _mm_loadu_si128((const __m128i*)(src + x + 1));
+            __m128i E    = _mm_loadu_si128((const __m128i*)(e_row + x));
+            __m128i cond = _mm_andnot_si128(_mm_cmpeq_epi32(A, E),
+                  _mm_xor_si128(_mm_cmpeq_epi32(B, D), ones));
+            __m128i s00  = _mm_and_si128(cond, _mm_cmpeq_epi32(A, B));
+            __m128i s01  = _mm_and_si128(cond, _mm_cmpeq_epi32(A, D));
+            __m128i s10  = _mm_and_si128(cond, _mm_cmpeq_epi32(E, B));
+            __m128i s11  = _mm_and_si128(cond, _mm_cmpeq_epi32(E, D));
+            __m128i o00  = _mm_or_si128(_mm_and_si128(s00, A), _mm_andnot_si128(s00, C));
+            __m128i o01  = _mm_or_si128(_mm_and_si128(s01, A), _mm_andnot_si128(s01, C));
+            __m128i o10  = _mm_or_si128(_mm_and_si128(s10, E), _mm_andnot_si128(s10, C));
+            __m128i o11  = _mm_or_si128(_mm_and_si128(s11, E), _mm_andnot_si128(s11, C));
+
+            _mm_storeu_si128((__m128i*)(out0 + 2 * x),     _mm_unpacklo_epi32(o00, o01));
+            _mm_storeu_si128((__m128i*)(out0 + 2 * x + 4), _mm_unpackhi_epi32(o00, o01));
+            _mm_storeu_si128((__m128i*)(out1 + 2 * x),     _mm_unpacklo_epi32(o10, o11));
+            _mm_storeu_si128((__m128i*)(out1 + 2 * x + 4), _mm_unpackhi_epi32(o10, o11));
+         }
+#endif
+      }
+
+      for (; x < width; ++x)
+         SCALE2X_PIXEL(uint32_t, x);
+
+      src += src_stride;
+      dst += 2 * dst_stride;
+   }
+}
+
+static void scale2x_simd_rgb565(unsigned width, unsigned height,
+      int first, int last,
+      const uint16_t *src, unsigned src_stride,
+      uint16_t *dst, unsigned dst_stride)
+{
+   unsigned x, y;
+
+   for (y = 0; y < height; ++y)
+   {
+      const int prevline    = ((y == 0) && first) ? 0 : (int)src_stride;
+      const int nextline    = ((y == height - 1) && last) ? 0 : (int)src_stride;
+      const uint16_t *a_row = src - prevline;
+      const uint16_t *e_row = src + nextline;
+      uint16_t *out0        = dst;
+      uint16_t *out1        = dst + dst_stride;
+
+      x = 0;
+
+      if (width > 1)
+      {
+         SCALE2X_PIXEL(uint16_t, 0);
+         x = 1;
+
+#if defined(SCALE2X_NEON)
+         for (; x + 8 <= width - 1; x += 8)
+         {
+            uint16x8_t A    = vld1q_u16(a_row + x);
+            uint16x8_t B    = vld1q_u16(src + x - 1);
+            uint16x8_t C    = vld1q_u16(src + x);
+            uint16x8_t D    = vld1q_u16(src + x + 1);
+            uint16x8_t E    = vld1q_u16(e_row + x);
+            uint16x8_t cond = vandq_u16(
+                  vmvnq_u16(vceqq_u16(A, E)),
+                  vmvnq_u16(vceqq_u16(B, D)));
+            uint16x8_t o00  = vbslq_u16(vandq_u16(cond, vceqq_u16(A, B)), A, C);
+            uint16x8_t o01  = vbslq_u16(vandq_u16(cond, vceqq_u16(A, D)), A, C);
+            uint16x8_t o10  = vbslq_u16(vandq_u16(cond, vceqq_u16(E, B)), E, C);
+            uint16x8_t o11  = vbslq_u16(vandq_u16(cond, vceqq_u16(E, D)), E, C);
+            uint16x8x2_t r0 = vzipq_u16(o00, o01);
+            uint16x8x2_t r1 = vzipq_u16(o10, o11);
+
+            vst1q_u16(out0 + 2 * x,     r0.val[0]);
+            vst1q_u16(out0 + 2 * x + 8, r0.val[1]);
+            vst1q_u16(out1 + 2 * x,     r1.val[0]);
+            vst1q_u16(out1 + 2 * x + 8, r1.val[1]);
+         }
+#else
+         for (; x + 8 <= width - 1; x += 8)
+         {
+            const __m128i ones = _mm_set1_epi16(-1);
+            __m128i A    = _mm_loadu_si128((const __m128i*)(a_row + x));
+            __m128i B    = _mm_loadu_si128((const __m128i*)(src + x - 1));
+            __m128i C    = _mm_loadu_si128((const __m128i*)(src + x));
+            __m128i D    = _mm_loadu_si128((const __m128i*)(src + x + 1));
+            __m128i E    = _mm_loadu_si128((const __m128i*)(e_row + x));
+            __m128i cond = _mm_andnot_si128(_mm_cmpeq_epi16(A, E),
+                  _mm_xor_si128(_mm_cmpeq_epi16(B, D), ones));
+            __m128i s00  = _mm_and_si128(cond, _mm_cmpeq_epi16(A, B));
+            __m128i s01  = _mm_and_si128(cond, _mm_cmpeq_epi16(A, D));
+            __m128i s10  = _mm_and_si128(cond, _mm_cmpeq_epi16(E, B));
+            __m128i s11  = _mm_and_si128(cond, _mm_cmpeq_epi16(E, D));
+            __m128i o00  = _mm_or_si128(_mm_and_si128(s00, A), _mm_andnot_si128(s00, C));
+            __m128i o01  = _mm_or_si128(_mm_and_si128(s01, A), _mm_andnot_si128(s01, C));
+            __m128i o10  = _mm_or_si128(_mm_and_si128(s10, E), _mm_andnot_si128(s10, C));
+            __m128i o11  = _mm_or_si128(_mm_and_si128(s11, E), _mm_andnot_si128(s11, C));
+
+            _mm_storeu_si128((__m128i*)(out0 + 2 * x),     _mm_unpacklo_epi16(o00, o01));
+            _mm_storeu_si128((__m128i*)(out0 + 2 * x + 8), _mm_unpackhi_epi16(o00, o01));
+            _mm_storeu_si128((__m128i*)(out1 + 2 * x),     _mm_unpacklo_epi16(o10, o11));
+            _mm_storeu_si128((__m128i*)(out1 + 2 * x + 8), _mm_unpackhi_epi16(o10, o11));
+         }
+#endif
+      }
+
+      for (; x < width; ++x)
+         SCALE2X_PIXEL(uint16_t, x);
+
+      src += src_stride;
+      dst += 2 * dst_stride;
+   }
+}
+
+#define scale2x_generic_rgb565   scale2x_simd_rgb565
+#define scale2x_generic_xrgb8888 scale2x_simd_xrgb8888
+#endif
 
 static unsigned scale2x_generic_input_fmts(void)
 {
@@ -137,7 +341,7 @@ static void *scale2x_generic_create(const struct softfilter_config *config,
       return NULL;
    filt->workers = (struct softfilter_thread_data*)
       calloc(threads, sizeof(struct softfilter_thread_data));
-   filt->threads = 1;
+   filt->threads = threads;
    filt->in_fmt  = in_fmt;
    if (!filt->workers)
    {
@@ -222,7 +426,7 @@ static void scale2x_generic_packets(void *data,
 
       /* Workers need to know if they can access pixels
        * outside their given buffer. */
-      thr->first = y_start;
+      thr->first = y_start == 0;
       thr->last = y_end == height;
 
       if (filt->in_fmt == SOFTFILTER_FMT_XRGB8888)
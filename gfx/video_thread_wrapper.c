@@ -21,6 +21,7 @@
 
 #include <compat/strl.h>
 #include <features/features_cpu.h>
+#include <retro_memcpy_nt.h>
 #include <rthreads/rthreads.h>
 #include <string/stdstring.h>
 
@@ -28,6 +29,7 @@
 #include "font_driver.h"
 
 #include "../retroarch.h"
+#include "../performance_counters.h"
 #include "../verbosity.h"
 
 enum thread_cmd
@@ -206,10 +208,21 @@ struct thread_video
    {
       uint64_t count;
       slock_t *lock;
-      uint8_t *buffer;
+      /* Triple-buffered frame handoff. The core thread owns
+       * buffers[write_idx] exclusively, the video thread owns
+       * buffers[read_idx] while rendering, and pending_idx is the
+       * latest published frame (-1 once the video thread has picked
+       * it up). Swaps happen under 'lock' and are latest-wins:
+       * publishing over an unconsumed frame replaces it instead of
+       * stalling the core behind the GPU. */
+      uint8_t *buffers[3];
       unsigned width;
       unsigned height;
       unsigned pitch;
+      unsigned write_idx;
+      unsigned read_idx;
+      int pending_idx;
+      int last_idx; /* Slot holding the most recent frame content. */
       char msg[255];
       bool updated;
       bool within_thread;
@@ -567,16 +580,39 @@ static void video_thread_loop(void *data)
 {
    thread_video_t *thr = (thread_video_t*)data;
 
+   RARCH_TRACE_NAME_THREAD("video thread");
+
    for (;;)
    {
+      char frame_msg[255];
       thread_packet_t pkt;
-      bool updated = false;
+      bool updated          = false;
+      unsigned frame_width  = 0;
+      unsigned frame_height = 0;
+      unsigned frame_pitch  = 0;
+      uint64_t frame_count  = 0;
+
+      frame_msg[0]          = '\0';
 
       slock_lock(thr->lock);
-      while (thr->send_cmd == CMD_VIDEO_NONE && !thr->frame.updated)
+      while (thr->send_cmd == CMD_VIDEO_NONE && thr->frame.pending_idx < 0)
          scond_wait(thr->cond_thread, thr->lock);
-      if (thr->frame.updated)
-         updated = true;
+      if (thr->frame.pending_idx >= 0)
+      {
+         /* Claim the published buffer and free the slot right away
+          * so the core can queue the next frame while this one is
+          * being rendered. Snapshot the metadata as well - the core
+          * may publish over it mid-render. */
+         thr->frame.read_idx    = (unsigned)thr->frame.pending_idx;
+         thr->frame.pending_idx = -1;
+         frame_width            = thr->frame.width;
+         frame_height           = thr->frame.height;
+         frame_pitch            = thr->frame.pitch;
+         frame_count            = thr->frame.count;
+         strlcpy(frame_msg, thr->frame.msg, sizeof(frame_msg));
+         updated                = true;
+         scond_signal(thr->cond_cmd);
+      }
 
       /* To avoid race condition where send_cmd is updated
        * right after the switch is checked. */
@@ -602,6 +638,8 @@ static void video_thread_loop(void *data)
          vp.full_width            = 0;
          vp.full_height           = 0;
 
+         RARCH_TRACE_BEGIN("video frame");
+
          slock_lock(thr->frame.lock);
 
          thread_update_driver_state(thr);
@@ -609,19 +647,22 @@ static void video_thread_loop(void *data)
          if (thr->driver && thr->driver->frame)
          {
             video_frame_info_t video_info;
-            /* TODO/FIXME - not thread-safe - should get 
+            /* TODO/FIXME - not thread-safe - should get
              * rid of this */
             video_driver_build_info(&video_info);
 
             ret = thr->driver->frame(thr->driver_data,
-                  thr->frame.buffer, thr->frame.width, thr->frame.height,
-                  thr->frame.count,
-                  thr->frame.pitch, *thr->frame.msg ? thr->frame.msg : NULL,
+                  thr->frame.buffers[thr->frame.read_idx],
+                  frame_width, frame_height,
+                  frame_count,
+                  frame_pitch, *frame_msg ? frame_msg : NULL,
                   &video_info);
          }
 
          slock_unlock(thr->frame.lock);
 
+         RARCH_TRACE_END();
+
          if (thr->driver && thr->driver->alive)
             alive = ret && thr->driver->alive(thr->driver_data);
 
@@ -638,7 +679,9 @@ static void video_thread_loop(void *data)
          thr->alive         = alive;
          thr->focus         = focus;
          thr->has_windowed  = has_windowed;
-         thr->frame.updated = false;
+         /* Keep 'updated' set if another frame was published while
+          * this one was being rendered. */
+         thr->frame.updated = (thr->frame.pending_idx >= 0);
          thr->vp            = vp;
          scond_signal(thr->cond_cmd);
          slock_unlock(thr->lock);
@@ -728,7 +771,18 @@ static bool video_thread_frame(void *data, const void *frame_,
          ? sizeof(uint32_t) : sizeof(uint16_t));
 
    src = (const uint8_t*)frame_;
-   dst = thr->frame.buffer;
+
+   /* The write buffer is owned exclusively by this thread, so the
+    * copy itself never contends with the video thread. Streaming
+    * stores keep the handoff from evicting the core's working
+    * set - this thread never reads the copy back. */
+   if (src)
+   {
+      unsigned h;
+      dst = thr->frame.buffers[thr->frame.write_idx];
+      for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
+         retro_memcpy_nt(dst, src, copy_stride);
+   }
 
    slock_lock(thr->lock);
 
@@ -739,8 +793,11 @@ static bool video_thread_frame(void *data, const void *frame_,
          roundf(1000000 / video_info->refresh_rate);
       retro_time_t target = thr->last_time + target_frame_time;
 
-      /* Ideally, use absolute time, but that is only a good idea on POSIX. */
-      while (thr->frame.updated)
+      /* Ideally, use absolute time, but that is only a good idea on POSIX.
+       * Only waits for the previous frame to be picked up, not
+       * rendered - pacing against vsync without stalling behind
+       * the GPU. */
+      while (thr->frame.pending_idx >= 0)
       {
          retro_time_t current = cpu_features_get_time_usec();
          retro_time_t delta   = target - current;
@@ -753,41 +810,62 @@ static bool video_thread_frame(void *data, const void *frame_,
       }
    }
 
-   /* Drop frame if updated flag is still set, as thread is
-    * still working on last frame. */
-   if (!thr->frame.updated)
+   if (src)
    {
-      if (src)
+      if (thr->frame.pending_idx >= 0)
       {
-         unsigned h;
-         for (h = 0; h < height; h++, src += pitch, dst += copy_stride)
-            memcpy(dst, src, copy_stride);
+         /* Latest wins: the video thread never picked up the
+          * previous frame, so it is replaced rather than this
+          * one being dropped. The reclaimed slot becomes the new
+          * write buffer unless the video thread happens to render
+          * out of it (only possible after a dupe republish). */
+         unsigned reclaimed = (unsigned)thr->frame.pending_idx;
+         if (reclaimed == thr->frame.read_idx)
+            reclaimed = 3 - thr->frame.write_idx - thr->frame.read_idx;
+         thr->frame.pending_idx = (int)thr->frame.write_idx;
+         thr->frame.write_idx   = reclaimed;
+         thr->miss_count++;
       }
+      else
+      {
+         unsigned free_slot     = 3 -
+            thr->frame.write_idx - thr->frame.read_idx;
+         thr->frame.pending_idx = (int)thr->frame.write_idx;
+         thr->frame.write_idx   = free_slot;
+      }
+      thr->frame.last_idx = thr->frame.pending_idx;
+   }
+   else if (thr->frame.pending_idx < 0)
+   {
+      /* Dupe frame: republish the slot holding the last frame.
+       * The video thread may still render out of it, but only it
+       * ever reads the slot, so this cannot race. */
+      thr->frame.pending_idx = thr->frame.last_idx;
+   }
+   /* else an unconsumed frame is already pending and is newer
+    * than a dupe would be - only refresh the metadata. */
 
-      thr->frame.updated = true;
-      thr->frame.width  = width;
-      thr->frame.height = height;
-      thr->frame.count  = frame_count;
-      thr->frame.pitch  = copy_stride;
+   thr->frame.updated = true;
+   thr->frame.width   = width;
+   thr->frame.height  = height;
+   thr->frame.count   = frame_count;
+   thr->frame.pitch   = copy_stride;
 
-      if (msg)
-         strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
-      else
-         *thr->frame.msg = '\0';
+   if (msg)
+      strlcpy(thr->frame.msg, msg, sizeof(thr->frame.msg));
+   else
+      *thr->frame.msg = '\0';
 
-      scond_signal(thr->cond_thread);
+   scond_signal(thr->cond_thread);
 
 #if defined(HAVE_MENU)
-      if (thr->texture.enable)
-      {
-         while (thr->frame.updated)
-            scond_wait(thr->cond_cmd, thr->lock);
-      }
-#endif
-      thr->hit_count++;
+   if (thr->texture.enable)
+   {
+      while (thr->frame.updated)
+         scond_wait(thr->cond_cmd, thr->lock);
    }
-   else
-      thr->miss_count++;
+#endif
+   thr->hit_count++;
 
    slock_unlock(thr->lock);
 
@@ -829,19 +907,34 @@ static bool video_thread_init(thread_video_t *thr,
    max_size                  = info.input_scale * RARCH_SCALE_BASE;
    max_size                 *= max_size;
    max_size                 *= info.rgb32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
+   {
+      unsigned i;
+      for (i = 0; i < 3; i++)
+      {
 #ifdef _3DS
-   thr->frame.buffer         = linearMemAlign(max_size, 0x80);
+         thr->frame.buffers[i] = linearMemAlign(max_size, 0x80);
 #else
-   thr->frame.buffer         = (uint8_t*)malloc(max_size);
+         thr->frame.buffers[i] = (uint8_t*)malloc(max_size);
 #endif
 
-   if (!thr->frame.buffer)
-      return false;
+         if (!thr->frame.buffers[i])
+            return false;
 
-   memset(thr->frame.buffer, 0x80, max_size);
+         memset(thr->frame.buffers[i], 0x80, max_size);
+      }
+   }
+
+   thr->frame.write_idx      = 0;
+   thr->frame.read_idx       = 1;
+   thr->frame.pending_idx    = -1;
+   /* Until a real frame arrives, dupe publishes show the cleared
+    * third slot. */
+   thr->frame.last_idx       = 2;
 
    thr->last_time            = cpu_features_get_time_usec();
-   thr->thread               = sthread_create(video_thread_loop, thr);
+   thr->thread               = sthread_create_with_class(
+         video_thread_loop, thr, "retroarch-video", STHREAD_CLASS_VIDEO);
 
    if (!thr->thread)
       return false;
@@ -953,11 +1046,17 @@ static void video_thread_free(void *data)
 #if defined(HAVE_MENU)
    free(thr->texture.frame);
 #endif
+   {
+      unsigned i;
+      for (i = 0; i < 3; i++)
+      {
 #ifdef _3DS
-   linearFree(thr->frame.buffer);
+         linearFree(thr->frame.buffers[i]);
 #else
-   free(thr->frame.buffer);
+         free(thr->frame.buffers[i]);
 #endif
+      }
+   }
    slock_free(thr->frame.lock);
    slock_free(thr->lock);
    scond_free(thr->cond_cmd);
@@ -966,7 +1065,7 @@ static void video_thread_free(void *data)
    free(thr->alpha_mod);
    slock_free(thr->alpha_lock);
 
-   RARCH_LOG("Threaded video stats: Frames pushed: %u, Frames dropped: %u.\n",
+   RARCH_LOG("Threaded video stats: Frames pushed: %u, Frames replaced: %u.\n",
          thr->hit_count, thr->miss_count);
 
    free(thr);
@@ -1298,6 +1397,16 @@ static uint32_t thread_get_flags(void *data)
    return thr->poke->get_flags(thr->driver_data);
 }
 
+/* The averages this formats are updated on the video thread,
+ * but a torn read only garbles one on-screen sample. */
+static bool thread_get_shader_pass_profile(void *data, char *s, size_t len)
+{
+   thread_video_t *thr = (thread_video_t*)data;
+   if (!thr || !thr->poke || !thr->poke->get_shader_pass_profile)
+      return false;
+   return thr->poke->get_shader_pass_profile(thr->driver_data, s, len);
+}
+
 static const video_poke_interface_t thread_poke = {
    thread_get_flags,
    thread_load_texture,
@@ -1321,7 +1430,8 @@ static const video_poke_interface_t thread_poke = {
 
    thread_get_current_shader,
    NULL,                      /* get_current_software_framebuffer */
-   NULL                       /* get_hw_render_interface */
+   NULL,                      /* get_hw_render_interface */
+   thread_get_shader_pass_profile
 };
 
 static void video_thread_get_poke_interface(
@@ -1470,6 +1580,21 @@ const char *video_thread_get_ident(void)
    return thr->driver->ident;
 }
 
+bool video_thread_frame_stats(unsigned *pushed, unsigned *replaced)
+{
+   thread_video_t *thr = (thread_video_t*)video_driver_get_ptr(true);
+
+   if (!thr)
+      return false;
+
+   slock_lock(thr->lock);
+   *pushed   = thr->hit_count;
+   *replaced = thr->miss_count;
+   slock_unlock(thr->lock);
+
+   return true;
+}
+
 static void video_thread_send_and_wait(thread_video_t *thr,
       thread_packet_t *pkt)
 {
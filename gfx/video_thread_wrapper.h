@@ -72,6 +72,18 @@ void *video_thread_get_ptr(const video_driver_t **drv);
 
 const char *video_thread_get_ident(void);
 
+/**
+ * video_thread_frame_stats:
+ * @pushed                    : Set to the number of frames published.
+ * @replaced                  : Set to the number of frames replaced
+ *                              before the video thread consumed them.
+ *
+ * Gets the frame handoff counters of the threaded video wrapper.
+ *
+ * Returns: true (1) if threaded video is active, otherwise false (0).
+ **/
+bool video_thread_frame_stats(unsigned *pushed, unsigned *replaced);
+
 bool video_thread_font_init(
       const void **font_driver,
       void **font_handle,
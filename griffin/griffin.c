@@ -149,6 +149,10 @@ COMPRESSION
 #include "../libretro-common/streams/rzip_stream.c"
 #endif
 
+#ifdef HAVE_ZSTD
+#include "../libretro-common/streams/trans_stream_zstd.c"
+#endif
+
 /*============================================================
 ENCODINGS
 ============================================================ */
@@ -822,6 +826,7 @@ INPUT (HID)
 FIFO BUFFER
 ============================================================ */
 #include "../libretro-common/queues/fifo_queue.c"
+#include "../libretro-common/queues/fifo_queue_spsc.c"
 
 /*============================================================
 AUDIO RESAMPLER
@@ -1062,6 +1067,7 @@ FILE
 #include "../libretro-common/file/nbio/nbio_stdio.c"
 #if defined(__linux__)
 #include "../libretro-common/file/nbio/nbio_linux.c"
+#include "../libretro-common/file/nbio/nbio_uring.c"
 #endif
 #if defined(HAVE_MMAP) && defined(BSD)
 #include "../libretro-common/file/nbio/nbio_unixmmap.c"
@@ -1302,6 +1308,9 @@ DATA RUNLOOP
 #include "../tasks/task_playlist_manager.c"
 #include "../tasks/task_manual_content_scan.c"
 #include "../tasks/task_core_backup.c"
+#ifdef HAVE_SLANG
+#include "../tasks/task_shader.c"
+#endif
 #ifdef HAVE_ZLIB
 #include "../tasks/task_decompress.c"
 #endif
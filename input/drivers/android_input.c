@@ -42,6 +42,7 @@
 #include "../../tasks/tasks_internal.h"
 #include "../../performance_counters.h"
 
+#include "../../cache_coordinator.h"
 #include "../../configuration.h"
 #include "../../retroarch.h"
 
@@ -357,6 +358,12 @@ static void android_input_poll_main_cmd(void)
          AConfiguration_fromAssetManager(android_app->config,
                android_app->activity->assetManager);
          break;
+
+      case APP_CMD_LOW_MEMORY:
+         /* The system is about to start killing processes -
+          * drop every registered frontend cache */
+         cache_coordinator_pressure(CACHE_PRESSURE_CRITICAL);
+         break;
       case APP_CMD_TERM_WINDOW:
          slock_lock(android_app->mutex);
 
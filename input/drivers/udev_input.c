@@ -80,6 +80,13 @@
 
 #define UDEV_MAX_KEYS (KEY_MAX + 7) / 8
 
+/* Pre-4.16 kernel headers expose the event time as a plain
+ * timeval instead of the split seconds/microseconds members. */
+#ifndef input_event_sec
+#define input_event_sec  time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
 typedef struct udev_input udev_input_t;
 
 typedef struct udev_input_device udev_input_device_t;
@@ -120,6 +127,9 @@ struct udev_input_device
    dev_t dev;
    udev_input_mouse_t mouse;
    enum udev_input_dev_type type;
+   /* Event timestamps are on the monotonic clock and can feed
+    * the latency probe (EVIOCSCLOCKID succeeded on this fd). */
+   bool monotonic_ts;
    char devnode[PATH_MAX_LENGTH];
 };
 
@@ -170,6 +180,15 @@ static unsigned input_unify_ev_key_code(unsigned code)
    return code;
 }
 
+static int64_t udev_input_event_time_us(
+      const struct input_event *event, udev_input_device_t *dev)
+{
+   if (!dev->monotonic_ts)
+      return 0;
+   return (int64_t)event->input_event_sec * 1000000
+        + (int64_t)event->input_event_usec;
+}
+
 static void udev_handle_keyboard(void *data,
       const struct input_event *event, udev_input_device_t *dev)
 {
@@ -179,6 +198,10 @@ static void udev_handle_keyboard(void *data,
    switch (event->type)
    {
       case EV_KEY:
+         if (event->value == 1)
+            input_latency_probe_event(
+                  udev_input_event_time_us(event, dev));
+
          keysym = input_unify_ev_key_code(event->code);
          if (event->value && video_driver_has_focus())
             BIT_SET(udev->state, keysym);
@@ -404,6 +427,10 @@ static void udev_handle_mouse(void *data,
    switch (event->type)
    {
       case EV_KEY:
+         if (event->value == 1)
+            input_latency_probe_event(
+                  udev_input_event_time_us(event, dev));
+
          switch (event->code)
          {
             case BTN_LEFT:
@@ -501,6 +528,15 @@ static bool udev_input_add_device(udev_input_t *udev,
    device->handle_cb = cb;
    device->type      = type;
 
+#ifdef EVIOCSCLOCKID
+   {
+      /* Ask for monotonic event timestamps so they are comparable
+       * with cpu_features_get_time_usec() in the latency probe. */
+      int clkid            = CLOCK_MONOTONIC;
+      device->monotonic_ts = ioctl(fd, EVIOCSCLOCKID, &clkid) >= 0;
+   }
+#endif
+
    strlcpy(device->devnode, devnode, sizeof(device->devnode));
 
    /* UDEV_INPUT_MOUSE may report in absolute coords too */
@@ -738,8 +774,12 @@ static void udev_input_poll(void *data)
       mouse->whd   = false;
    }
 
+#if !defined(HAVE_EPOLL)
+   /* With epoll the monitor FD sits in the same event set as the
+    * devices, so hotplug is only checked when it actually fired. */
    while (udev->monitor && udev_input_poll_hotplug_available(udev->monitor))
       udev_input_handle_hotplug(udev);
+#endif
 
 #if defined(HAVE_EPOLL)
    ret = epoll_wait(udev->fd, events, ARRAY_SIZE(events), 0);
@@ -759,13 +799,26 @@ static void udev_input_poll(void *data)
       if (events[i].events & EPOLLIN)
       {
          int j, len;
-         struct input_event input_events[32];
+         /* Sized so a high-rate mouse burst usually drains in a
+          * single syscall. */
+         struct input_event input_events[64];
 #if defined(HAVE_EPOLL)
          udev_input_device_t *device = (udev_input_device_t*)events[i].data.ptr;
 #elif defined(HAVE_KQUEUE)
          udev_input_device_t *device = (udev_input_device_t*)events[i].udata;
 #endif
 
+#if defined(HAVE_EPOLL)
+         /* NULL tags the udev monitor - drain hotplug events. */
+         if (!device)
+         {
+            while (udev->monitor &&
+                  udev_input_poll_hotplug_available(udev->monitor))
+               udev_input_handle_hotplug(udev);
+            continue;
+         }
+#endif
+
          while ((len = read(device->fd,
                      input_events, sizeof(input_events))) > 0)
          {
@@ -1333,6 +1386,26 @@ static void *udev_input_init(const char *joypad_driver)
 
    udev->fd  = fd;
 
+#if defined(HAVE_EPOLL)
+   /* Let the hotplug monitor wake the same epoll set as the evdev
+    * devices - a NULL data pointer tags it apart from a device, and
+    * the per-frame poll() on the monitor FD goes away. */
+   if (udev->monitor)
+   {
+      struct epoll_event event;
+
+      event.events   = EPOLLIN;
+      event.data.ptr = NULL;
+
+      if (epoll_ctl(udev->fd, EPOLL_CTL_ADD,
+               udev_monitor_get_fd(udev->monitor), &event) < 0)
+      {
+         RARCH_ERR("Failed to add udev monitor FD to epoll list (%s).\n",
+               strerror(errno));
+      }
+   }
+#endif
+
    if (!open_devices(udev, UDEV_INPUT_KEYBOARD, udev_handle_keyboard))
       goto error;
 
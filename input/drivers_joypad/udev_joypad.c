@@ -60,6 +60,13 @@
    (((1UL << ((nr) % (sizeof(long) * CHAR_BIT))) & ((addr)[(nr) / (sizeof(long) * CHAR_BIT)])) != 0)
 #define NBITS(x) ((((x) - 1) / (sizeof(long) * CHAR_BIT)) + 1)
 
+/* Pre-4.16 kernel headers expose the event time as a plain
+ * timeval instead of the split seconds/microseconds members. */
+#ifndef input_event_sec
+#define input_event_sec  time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
 struct udev_joypad
 {
    int fd;
@@ -87,6 +94,9 @@ struct udev_joypad
    int32_t pid;
    /* Deal with analog triggers that report -32767 to 32767 */
    bool neg_trigger[NUM_AXES];
+   /* Event timestamps use the monotonic clock and can feed the
+    * latency probe (EVIOCSCLOCKID succeeded on this fd). */
+   bool monotonic_ts;
 };
 
 struct joypad_udev_entry
@@ -112,6 +122,15 @@ static INLINE int16_t udev_compute_axis(const struct input_absinfo *info, int va
    return axis;
 }
 
+static int64_t udev_joypad_event_time_us(
+      const struct udev_joypad *pad, const struct input_event *event)
+{
+   if (!pad->monotonic_ts)
+      return 0;
+   return (int64_t)event->input_event_sec * 1000000
+        + (int64_t)event->input_event_usec;
+}
+
 static int udev_find_vacant_pad(void)
 {
    unsigned i;
@@ -173,6 +192,15 @@ static int udev_add_pad(struct udev_device *dev, unsigned p, int fd, const char
    if (ioctl(fd, EVIOCGNAME(sizeof(pad->ident)), pad->ident) < 0)
       return -1;
 
+#ifdef EVIOCSCLOCKID
+   {
+      /* Monotonic event timestamps keep the latency probe in the
+       * same clock domain as cpu_features_get_time_usec(). */
+      int clkid         = CLOCK_MONOTONIC;
+      pad->monotonic_ts = ioctl(fd, EVIOCSCLOCKID, &clkid) >= 0;
+   }
+#endif
+
    pad->vid = pad->pid = 0;
 
    if (ioctl(fd, EVIOCGID, &inputid) >= 0)
@@ -498,7 +526,11 @@ static void udev_joypad_poll(void)
                   if (code > 0 && code < KEY_MAX)
                   {
                      if (value)
+                     {
                         BIT64_SET(pad->buttons, pad->button_bind[code]);
+                        input_latency_probe_event(
+                              udev_joypad_event_time_us(pad, &events[i]));
+                     }
                      else
                         BIT64_CLEAR(pad->buttons, pad->button_bind[code]);
                   }
@@ -520,6 +552,12 @@ static void udev_joypad_poll(void)
                      case ABS_HAT3Y:
                         code                           -= ABS_HAT0X;
                         pad->hats[code >> 1][code & 1]  = value;
+                        /* Hat deflections are digital presses; analog
+                         * axes are skipped so stick drift does not
+                         * flood the probe. */
+                        if (value)
+                           input_latency_probe_event(
+                                 udev_joypad_event_time_us(pad, &events[i]));
                         break;
                      default:
                         {
@@ -409,6 +409,20 @@ struct input_keyboard_ctx_wait
 void input_keyboard_event(bool down, unsigned code, uint32_t character,
       uint16_t mod, unsigned device);
 
+/**
+ * input_latency_probe_event:
+ * @event_time_us            : Event timestamp in microseconds on the
+ *                             monotonic clock, or 0 to stamp with the
+ *                             decode time.
+ *
+ * Feeds the input-to-display latency probe. Called by input drivers
+ * for state-changing events (button/key presses); the age of the
+ * oldest stamped event is measured against the presentation of the
+ * frame that consumed it and reported in the statistics overlay and
+ * the trace dump.
+ **/
+void input_latency_probe_event(int64_t event_time_us);
+
 extern struct retro_keybind input_config_binds[MAX_USERS][RARCH_BIND_LIST_END];
 extern struct retro_keybind input_autoconf_binds[MAX_USERS][RARCH_BIND_LIST_END];
 
@@ -1810,9 +1810,38 @@ const struct rarch_key_map rarch_key_map_winraw[] = {
 /* TODO/FIXME - global */
 enum retro_key rarch_keysym_lut[RETROK_LAST];
 
+/* Symbols at or above this bound do not get a slot in the flat
+ * reverse LUT; they go to the sorted side table instead. */
+#define RARCH_KEYSYM_RLUT_MAX 65536
+
+struct rarch_keysym_ovfl
+{
+   unsigned sym;
+   enum retro_key rk;
+};
+
 /* TODO/FIXME - static globals */
-static unsigned *rarch_keysym_rlut           = NULL;
-static unsigned rarch_keysym_rlut_size       = 0;
+static unsigned *rarch_keysym_rlut            = NULL;
+static unsigned rarch_keysym_rlut_size        = 0;
+static struct rarch_keysym_ovfl
+            *rarch_keysym_ovfl                = NULL;
+static unsigned rarch_keysym_ovfl_size        = 0;
+static const char *rarch_key_name_lut[RETROK_LAST];
+static bool rarch_key_name_lut_ready          = false;
+
+static int input_keymaps_ovfl_cmp(const void *a, const void *b)
+{
+   const struct rarch_keysym_ovfl *ka =
+      (const struct rarch_keysym_ovfl*)a;
+   const struct rarch_keysym_ovfl *kb =
+      (const struct rarch_keysym_ovfl*)b;
+
+   if (ka->sym < kb->sym)
+      return -1;
+   if (ka->sym > kb->sym)
+      return 1;
+   return 0;
+}
 
 /**
  * input_keymaps_init_keyboard_lut:
@@ -1823,28 +1852,72 @@ static unsigned rarch_keysym_rlut_size       = 0;
 void input_keymaps_init_keyboard_lut(const struct rarch_key_map *map)
 {
    const struct rarch_key_map *map_start = map;
+   unsigned max_sym                      = 0;
+   unsigned ovfl_count                   = 0;
+
    memset(rarch_keysym_lut, 0, sizeof(rarch_keysym_lut));
+
+   if (rarch_keysym_rlut)
+      free(rarch_keysym_rlut);
+   if (rarch_keysym_ovfl)
+      free(rarch_keysym_ovfl);
+   rarch_keysym_rlut      = NULL;
    rarch_keysym_rlut_size = 0;
+   rarch_keysym_ovfl      = NULL;
+   rarch_keysym_ovfl_size = 0;
 
    for (; map->rk != RETROK_UNKNOWN; map++)
    {
       rarch_keysym_lut[map->rk] = (enum retro_key)map->sym;
-      if (map->sym > rarch_keysym_rlut_size)
-         rarch_keysym_rlut_size = map->sym;
+      if (map->sym < RARCH_KEYSYM_RLUT_MAX)
+      {
+         if (map->sym > max_sym)
+            max_sym = map->sym;
+      }
+      else
+         ovfl_count++;
    }
 
-   if (rarch_keysym_rlut_size < 65536)
+   rarch_keysym_rlut = (unsigned*)calloc(max_sym + 1, sizeof(unsigned));
+   if (rarch_keysym_rlut)
    {
-      if (rarch_keysym_rlut)
-         free(rarch_keysym_rlut);
-
-      rarch_keysym_rlut = (unsigned*)calloc(++rarch_keysym_rlut_size, sizeof(unsigned));
-
+      rarch_keysym_rlut_size = max_sym + 1;
       for (map = map_start; map->rk != RETROK_UNKNOWN; map++)
-         rarch_keysym_rlut[map->sym] = (enum retro_key)map->rk;
+         if (map->sym < rarch_keysym_rlut_size)
+            rarch_keysym_rlut[map->sym] = (enum retro_key)map->rk;
+   }
+
+   if (ovfl_count)
+   {
+      rarch_keysym_ovfl = (struct rarch_keysym_ovfl*)
+         malloc(ovfl_count * sizeof(*rarch_keysym_ovfl));
+
+      if (rarch_keysym_ovfl)
+      {
+         unsigned i = 0;
+
+         for (map = map_start; map->rk != RETROK_UNKNOWN; map++)
+         {
+            if (map->sym < RARCH_KEYSYM_RLUT_MAX)
+               continue;
+            rarch_keysym_ovfl[i].sym = map->sym;
+            rarch_keysym_ovfl[i].rk  = (enum retro_key)map->rk;
+            i++;
+         }
+
+         rarch_keysym_ovfl_size = ovfl_count;
+         qsort(rarch_keysym_ovfl, ovfl_count,
+               sizeof(*rarch_keysym_ovfl), input_keymaps_ovfl_cmp);
+      }
+      else
+      {
+         /* Without the side table the LUT would drop the large
+          * symbols; fall back to the linear scan wholesale */
+         free(rarch_keysym_rlut);
+         rarch_keysym_rlut      = NULL;
+         rarch_keysym_rlut_size = 0;
+      }
    }
-   else
-      rarch_keysym_rlut_size = 0;
 }
 
 /**
@@ -1861,10 +1934,33 @@ enum retro_key input_keymaps_translate_keysym_to_rk(unsigned sym)
    unsigned i;
 
    /* Fast path */
-   if (rarch_keysym_rlut && sym < rarch_keysym_rlut_size)
-      return (enum retro_key)rarch_keysym_rlut[sym];
+   if (rarch_keysym_rlut)
+   {
+      unsigned lo = 0;
+      unsigned hi = rarch_keysym_ovfl_size;
+
+      if (sym < rarch_keysym_rlut_size)
+         return (enum retro_key)rarch_keysym_rlut[sym];
+
+      /* Symbols above the flat LUT live in a sorted side table */
+      while (lo < hi)
+      {
+         unsigned mid = lo + ((hi - lo) >> 1);
+         if (rarch_keysym_ovfl[mid].sym < sym)
+            lo = mid + 1;
+         else
+            hi = mid;
+      }
+
+      if (     lo < rarch_keysym_ovfl_size
+            && rarch_keysym_ovfl[lo].sym == sym)
+         return rarch_keysym_ovfl[lo].rk;
+
+      return RETROK_UNKNOWN;
+   }
 
-   /* Slow path */
+   /* Slow path - only reachable if the tables could not
+    * be allocated */
    for (i = 0; i < ARRAY_SIZE(rarch_keysym_lut); i++)
    {
       if (rarch_keysym_lut[i] != sym)
@@ -1887,8 +1983,6 @@ enum retro_key input_keymaps_translate_keysym_to_rk(unsigned sym)
  **/
 void input_keymaps_translate_rk_to_str(enum retro_key key, char *buf, size_t size)
 {
-   unsigned i;
-
    retro_assert(size >= 2);
    *buf = '\0';
 
@@ -1899,12 +1993,23 @@ void input_keymaps_translate_rk_to_str(enum retro_key key, char *buf, size_t siz
       return;
    }
 
-   for (i = 0; input_config_key_map[i].str; i++)
+   if (!rarch_key_name_lut_ready)
    {
-      if (input_config_key_map[i].key != key)
-         continue;
+      unsigned i;
+
+      for (i = 0; input_config_key_map[i].str; i++)
+      {
+         enum retro_key k = input_config_key_map[i].key;
 
-      strlcpy(buf, input_config_key_map[i].str, size);
-      break;
+         /* First entry wins, as the linear scan did - the
+          * table carries aliases like "add"/"kp_plus" */
+         if ((unsigned)k < RETROK_LAST && !rarch_key_name_lut[k])
+            rarch_key_name_lut[k] = input_config_key_map[i].str;
+      }
+
+      rarch_key_name_lut_ready = true;
    }
+
+   if ((unsigned)key < RETROK_LAST && rarch_key_name_lut[key])
+      strlcpy(buf, rarch_key_name_lut[key], size);
 }
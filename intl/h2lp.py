@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+# Compile a translation header into a binary language pack (*.lp)
+# that msg_hash_to_str can load at runtime when RetroArch is built
+# with HAVE_LANGPACK (and without HAVE_LANGEXTRA), so console ports
+# keep only the English tables resident.
+#
+# Entries are keyed by the djb2 hash of the English string from
+# msg_hash_us.h instead of by enum value, since msg_hash_enums is
+# laid out differently per platform/build. Packs are written
+# little-endian; the loader byteswaps on big-endian targets.
+#
+# Usage: ./h2lp.py msg_hash_de.h
+
+import os
+import re
+import struct
+import sys
+
+# RETRO_LANGUAGE_* values from libretro.h, by intl/ file suffix
+languages = {
+   'ja':    1,
+   'fr':    2,
+   'es':    3,
+   'de':    4,
+   'it':    5,
+   'nl':    6,
+   'pt_br': 7,
+   'pt_pt': 8,
+   'ru':    9,
+   'ko':    10,
+   'cht':   11,
+   'chs':   12,
+   'eo':    13,
+   'pl':    14,
+   'vn':    15,
+   'ar':    16,
+   'el':    17,
+   'tr':    18,
+   'sk':    19,
+   'fa':    20,
+   'he':    21,
+   'ast':   22,
+}
+
+try:
+   h_filename = sys.argv[1]
+   lp_filename = h_filename.replace('.h', '.lp')
+except IndexError:
+   print("Usage: ./h2lp.py msg_hash_de.h")
+   sys.exit(1)
+
+suffix = os.path.basename(h_filename).replace('msg_hash_', '').replace('.h', '')
+
+if suffix not in languages:
+   print("No RETRO_LANGUAGE for " + h_filename)
+   sys.exit(1)
+
+p = re.compile(r'MSG_HASH\(\s*\/?\*?.*\*?\/?\s*[a-zA-Z0-9_]+\s*,\s*\".*\"\s*\)')
+
+def parse_message(message):
+   key_start = max(message.find('(') + 1, message.find('*/') + 2)
+   key_end = message.find(',', key_start)
+   key = message[key_start:key_end].strip()
+   value_start = message.find('"') + 1
+   value_end = message.rfind('"')
+   value = message[value_start:value_end]
+   return key, value
+
+def parse_header(filename):
+   messages = {}
+   with open(filename, 'r') as h_file:
+      for msg in p.findall(h_file.read()):
+         key, val = parse_message(msg)
+         if val and val != 'null':
+            messages[key] = val.replace('\\\"', '"') # unescape
+   return messages
+
+def djb2(string):
+   hash = 5381
+   for c in string.encode('utf-8'):
+      hash = (hash * 33 + c) & 0xffffffff
+   return hash
+
+us_filename = os.path.join(os.path.dirname(h_filename), 'msg_hash_us.h')
+
+translated = parse_header(h_filename)
+english = parse_header(us_filename)
+
+pairs = {}
+blob = bytearray()
+offsets = {}
+
+for key, val in translated.items():
+   if key not in english or english[key] == val:
+      continue
+   hash = djb2(english[key])
+   if hash in pairs:
+      if blob[pairs[hash]:].split(b'\0')[0] != val.encode('utf-8'):
+         print("Hash collision, keeping first: " + key)
+      continue
+   if val not in offsets:
+      offsets[val] = len(blob)
+      blob += val.encode('utf-8') + b'\0'
+   pairs[hash] = offsets[val]
+
+with open(lp_filename, 'wb') as lp_file:
+   lp_file.write(b'RALP')
+   lp_file.write(struct.pack('<III', 1, languages[suffix], len(pairs)))
+   for hash in sorted(pairs):
+      lp_file.write(struct.pack('<II', hash, pairs[hash]))
+   lp_file.write(bytes(blob))
+
+print("Wrote " + lp_filename + ": " + str(len(pairs)) + " messages")
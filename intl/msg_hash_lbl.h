@@ -3160,6 +3160,10 @@ MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS,
    "video_shader_parameters"
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS_UNDO,
+   "video_shader_parameters_undo"
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VIDEO_SHADER_PASS,
    "video_shader_pass"
@@ -6551,6 +6551,14 @@ MSG_HASH(
    MENU_ENUM_SUBLABEL_VIDEO_SHADER_PARAMETERS,
    "Modifies the current shader directly. Changes will not be saved to the preset file."
    )
+MSG_HASH(
+   MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_PARAMETERS_UNDO,
+   "Undo Parameter Change"
+   )
+MSG_HASH(
+   MENU_ENUM_SUBLABEL_VIDEO_SHADER_PARAMETERS_UNDO,
+   "Revert the most recent shader parameter edit. Consecutive changes to the same parameter are undone as one."
+   )
 MSG_HASH(
    MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_NUM_PASSES,
    "Shader Passes"
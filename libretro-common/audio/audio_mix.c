@@ -29,6 +29,8 @@
 #include <emmintrin.h>
 #elif defined(__ALTIVEC__)
 #include <altivec.h>
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
 #endif
 
 #include <retro_miscellaneous.h>
@@ -77,6 +79,37 @@ void audio_mix_volume_SSE2(float *out, const float *in, float vol, size_t sample
 }
 #endif
 
+#if defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+void audio_mix_volume_NEON(float *out, const float *in, float vol, size_t samples)
+{
+   size_t i, remaining_samples;
+   float32x4_t volume = vdupq_n_f32(vol);
+
+   for (i = 0; i + 16 <= samples; i += 16, out += 16, in += 16)
+   {
+      float32x4_t acc0 = vld1q_f32(out +  0);
+      float32x4_t acc1 = vld1q_f32(out +  4);
+      float32x4_t acc2 = vld1q_f32(out +  8);
+      float32x4_t acc3 = vld1q_f32(out + 12);
+
+      acc0 = vmlaq_f32(acc0, vld1q_f32(in +  0), volume);
+      acc1 = vmlaq_f32(acc1, vld1q_f32(in +  4), volume);
+      acc2 = vmlaq_f32(acc2, vld1q_f32(in +  8), volume);
+      acc3 = vmlaq_f32(acc3, vld1q_f32(in + 12), volume);
+
+      vst1q_f32(out +  0, acc0);
+      vst1q_f32(out +  4, acc1);
+      vst1q_f32(out +  8, acc2);
+      vst1q_f32(out + 12, acc3);
+   }
+
+   remaining_samples = samples - i;
+
+   for (i = 0; i < remaining_samples; i++)
+      out[i] += in[i] * vol;
+}
+#endif
+
 void audio_mix_free_chunk(audio_chunk_t *chunk)
 {
    if (!chunk)
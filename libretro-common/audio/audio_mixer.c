@@ -33,6 +33,14 @@
 #include <string.h>
 #include <math.h>
 
+#include <retro_math.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#endif
+
 #ifdef HAVE_CONFIG_H
 #include "../../config.h"
 #endif
@@ -61,9 +69,20 @@
 #include <ibxm/ibxm.h>
 #endif
 
+#ifdef HAVE_THREADS
+#include <queues/fifo_queue.h>
+#include <rthreads/rthreads.h>
+#endif
+
 #define AUDIO_MIXER_MAX_VOICES      8
 #define AUDIO_MIXER_TEMP_BUFFER 8192
 
+#ifdef HAVE_THREADS
+/* How much decoded PCM the decode thread keeps buffered
+ * ahead of the mixer, per streamed voice. */
+#define AUDIO_MIXER_STREAM_AHEAD_MS 500
+#endif
+
 struct audio_mixer_sound
 {
    enum audio_mixer_type type;
@@ -182,7 +201,17 @@ struct audio_mixer_voice
    audio_mixer_stop_cb_t stop_cb;
    unsigned type;
    float    volume;
+   float    fade_target;
+   float    fade_step;     /* volume change per frame, 0 when idle */
+   float    pan_left;      /* per-channel gains, both 1.0 when centered */
+   float    pan_right;
    bool     repeat;
+#ifdef HAVE_THREADS
+   fifo_buffer_t *ring;    /* decoded PCM, filled by the decode thread */
+   bool     ring_busy;     /* decode thread is inside this voice's codec */
+   bool     ring_eof;      /* decoder reached the end of the stream */
+   bool     ring_wrap;     /* stream looped; REPEATED callback still owed */
+#endif
 
 };
 
@@ -190,6 +219,32 @@ struct audio_mixer_voice
 static struct audio_mixer_voice s_voices[AUDIO_MIXER_MAX_VOICES] = {0};
 static unsigned s_rate = 0;
 
+#ifdef HAVE_THREADS
+/* Guards the rings and voice setup/teardown; never held
+ * across a decode call. */
+static slock_t   *s_lock        = NULL;
+static scond_t   *s_cond        = NULL;
+static sthread_t *s_thread      = NULL;
+static bool       s_thread_quit = false;
+
+static void audio_mixer_thread_loop(void *data);
+
+static void audio_mixer_lock(void)
+{
+   if (s_lock)
+      slock_lock(s_lock);
+}
+
+static void audio_mixer_unlock(void)
+{
+   if (s_lock)
+      slock_unlock(s_lock);
+}
+#else
+#define audio_mixer_lock()   do {} while (0)
+#define audio_mixer_unlock() do {} while (0)
+#endif
+
 #ifdef HAVE_RWAV
 static bool wav_to_float(const rwav_t* wav, float** pcm, size_t samples_out)
 {
@@ -313,12 +368,60 @@ void audio_mixer_init(unsigned rate)
 
    for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
       s_voices[i].type = AUDIO_MIXER_TYPE_NONE;
+
+#ifdef HAVE_THREADS
+   if (!s_lock)
+      s_lock = slock_new();
+   if (!s_cond)
+      s_cond = scond_new();
+
+   s_thread_quit = false;
+
+   /* If the thread cannot be brought up the voices simply never get
+    * a ring attached, and everything decodes on the mixer thread as
+    * before. */
+   if (!s_thread && s_lock && s_cond)
+      s_thread = sthread_create(audio_mixer_thread_loop, NULL);
+#endif
 }
 
 void audio_mixer_done(void)
 {
    unsigned i;
 
+#ifdef HAVE_THREADS
+   if (s_thread)
+   {
+      slock_lock(s_lock);
+      s_thread_quit = true;
+      scond_signal(s_cond);
+      slock_unlock(s_lock);
+      sthread_join(s_thread);
+      s_thread = NULL;
+   }
+
+   for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
+   {
+      if (s_voices[i].ring)
+      {
+         fifo_free(s_voices[i].ring);
+         s_voices[i].ring = NULL;
+      }
+      s_voices[i].ring_busy = false;
+   }
+
+   if (s_cond)
+   {
+      scond_free(s_cond);
+      s_cond = NULL;
+   }
+   if (s_lock)
+   {
+      slock_free(s_lock);
+      s_lock = NULL;
+   }
+#endif
+
    for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++)
       s_voices[i].type = AUDIO_MIXER_TYPE_NONE;
 }
@@ -780,6 +883,65 @@ error:
 }
 #endif
 
+#ifdef HAVE_THREADS
+/* Largest number of samples a single decode can put into the
+ * voice buffer. Zero for types that are not streamed. */
+static unsigned audio_mixer_voice_chunk_samples(audio_mixer_voice_t* voice)
+{
+   switch (voice->type)
+   {
+#ifdef HAVE_STB_VORBIS
+      case AUDIO_MIXER_TYPE_OGG:
+         return voice->types.ogg.buf_samples;
+#endif
+#ifdef HAVE_DR_FLAC
+      case AUDIO_MIXER_TYPE_FLAC:
+         return voice->types.flac.buf_samples;
+#endif
+#ifdef HAVE_DR_MP3
+      case AUDIO_MIXER_TYPE_MP3:
+         return voice->types.mp3.buf_samples;
+#endif
+#ifdef HAVE_IBXM
+      case AUDIO_MIXER_TYPE_MOD:
+         return voice->types.mod.buf_samples;
+#endif
+      default:
+         break;
+   }
+
+   return 0;
+}
+
+/* Gives a freshly started streamed voice its decode-ahead ring.
+ * Called with the mixer lock held. */
+static void audio_mixer_voice_attach_ring(audio_mixer_voice_t* voice)
+{
+   size_t sz;
+   unsigned chunk = audio_mixer_voice_chunk_samples(voice);
+
+   if (voice->ring)
+   {
+      fifo_free(voice->ring);
+      voice->ring = NULL;
+   }
+
+   voice->ring_eof  = false;
+   voice->ring_wrap = false;
+
+   if (!s_thread || !chunk)
+      return;
+
+   /* Half a second of decoded stereo PCM, but never less than two
+    * decode chunks so the thread can get ahead at all. */
+   sz = (size_t)s_rate * 2 * AUDIO_MIXER_STREAM_AHEAD_MS / 1000;
+   if (sz < (size_t)chunk * 2)
+      sz = (size_t)chunk * 2;
+
+   voice->ring = fifo_new((sz + 1) * sizeof(float));
+}
+#endif
+
 audio_mixer_voice_t* audio_mixer_play(audio_mixer_sound_t* sound, bool repeat,
       float volume, audio_mixer_stop_cb_t stop_cb)
 {
@@ -790,11 +952,20 @@ audio_mixer_voice_t* audio_mixer_play(audio_mixer_sound_t* sound, bool repeat,
    if (!sound)
       return NULL;
 
+   audio_mixer_lock();
+
    for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++, voice++)
    {
       if (voice->type != AUDIO_MIXER_TYPE_NONE)
          continue;
 
+#ifdef HAVE_THREADS
+      /* The decode thread may still be winding down a voice that
+       * was just stopped - take the next free one instead. */
+      if (voice->ring_busy)
+         continue;
+#endif
+
       switch (sound->type)
       {
          case AUDIO_MIXER_TYPE_WAV:
@@ -829,15 +1000,26 @@ audio_mixer_voice_t* audio_mixer_play(audio_mixer_sound_t* sound, bool repeat,
 
    if (res)
    {
-      voice->type     = sound->type;
-      voice->repeat   = repeat;
-      voice->volume   = volume;
-      voice->sound    = sound;
-      voice->stop_cb  = stop_cb;
+      voice->type      = sound->type;
+      voice->repeat    = repeat;
+      voice->volume    = volume;
+      voice->fade_step = 0.0f;
+      voice->pan_left  = 1.0f;
+      voice->pan_right = 1.0f;
+      voice->sound     = sound;
+      voice->stop_cb   = stop_cb;
+
+#ifdef HAVE_THREADS
+      audio_mixer_voice_attach_ring(voice);
+      if (s_cond)
+         scond_signal(s_cond);
+#endif
    }
    else
       voice = NULL;
 
+   audio_mixer_unlock();
+
    return voice;
 }
 
@@ -851,30 +1033,95 @@ void audio_mixer_stop(audio_mixer_voice_t* voice)
       stop_cb     = voice->stop_cb;
       sound       = voice->sound;
 
+      audio_mixer_lock();
       voice->type = AUDIO_MIXER_TYPE_NONE;
+#ifdef HAVE_THREADS
+      /* The decode thread may be inside this voice's codec with the
+       * lock dropped - don't return until it is out, since callers
+       * are free to destroy the sound right after stopping it. */
+      while (voice->ring_busy && s_cond)
+         scond_wait(s_cond, s_lock);
+#endif
+      audio_mixer_unlock();
 
       if (stop_cb)
          stop_cb(sound, AUDIO_MIXER_SOUND_STOPPED);
    }
 }
 
+/* Accumulates interleaved stereo samples into the output with
+ * independent left/right gains. All the decoder mix loops funnel
+ * through here, so this is the hottest loop in the mixer. */
+static void audio_mixer_mix_pan(float* buffer, const float* pcm,
+      size_t samples, float vol_l, float vol_r)
+{
+   size_t i = 0;
+
+#if defined(__SSE2__)
+   __m128 gains = _mm_setr_ps(vol_l, vol_r, vol_l, vol_r);
+
+   for (; i + 8 <= samples; i += 8)
+   {
+      __m128 out0 = _mm_loadu_ps(buffer + i + 0);
+      __m128 out1 = _mm_loadu_ps(buffer + i + 4);
+
+      out0 = _mm_add_ps(out0, _mm_mul_ps(_mm_loadu_ps(pcm + i + 0), gains));
+      out1 = _mm_add_ps(out1, _mm_mul_ps(_mm_loadu_ps(pcm + i + 4), gains));
+
+      _mm_storeu_ps(buffer + i + 0, out0);
+      _mm_storeu_ps(buffer + i + 4, out1);
+   }
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+   float vol_pair[2];
+   float32x4_t gains;
+
+   vol_pair[0] = vol_l;
+   vol_pair[1] = vol_r;
+   gains       = vcombine_f32(vld1_f32(vol_pair), vld1_f32(vol_pair));
+
+   for (; i + 8 <= samples; i += 8)
+   {
+      float32x4_t out0 = vld1q_f32(buffer + i + 0);
+      float32x4_t out1 = vld1q_f32(buffer + i + 4);
+
+      out0 = vmlaq_f32(out0, vld1q_f32(pcm + i + 0), gains);
+      out1 = vmlaq_f32(out1, vld1q_f32(pcm + i + 4), gains);
+
+      vst1q_f32(buffer + i + 0, out0);
+      vst1q_f32(buffer + i + 4, out1);
+   }
+#endif
+
+   for (; i + 2 <= samples; i += 2)
+   {
+      buffer[i + 0] += pcm[i + 0] * vol_l;
+      buffer[i + 1] += pcm[i + 1] * vol_r;
+   }
+
+   /* Streams are interleaved stereo so counts are even - this is
+    * just belt and braces for a truncated last frame. */
+   if (i < samples)
+      buffer[i] += pcm[i] * vol_l;
+}
+
 static void audio_mixer_mix_wav(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
    unsigned buf_free                = (unsigned)(num_frames * 2);
    const audio_mixer_sound_t* sound = voice->sound;
    unsigned pcm_available           = sound->types.wav.frames
       * 2 - voice->types.wav.position;
    const float* pcm                 = sound->types.wav.pcm +
       voice->types.wav.position;
+   float vol_l                      = volume * voice->pan_left;
+   float vol_r                      = volume * voice->pan_right;
 
 again:
    if (pcm_available < buf_free)
    {
-      for (i = pcm_available; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_mix_pan(buffer, pcm, pcm_available, vol_l, vol_r);
+      buffer += pcm_available;
 
       if (voice->repeat)
       {
@@ -895,96 +1142,146 @@ again:
    }
    else
    {
-      for (i = buf_free; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_mix_pan(buffer, pcm, buf_free, vol_l, vol_r);
 
       voice->types.wav.position += buf_free;
    }
 }
 
 #ifdef HAVE_STB_VORBIS
+/* Decodes and resamples the next chunk into the voice buffer.
+ * Returns the number of samples now there, or 0 when the stream
+ * ended and the voice does not repeat. *wrapped is set when a
+ * repeating stream was seeked back to the start. */
+static unsigned audio_mixer_fill_ogg(audio_mixer_voice_t* voice,
+      bool *wrapped)
+{
+   unsigned temp_samples = 0;
+   float* temp_buffer    = (float*)malloc(
+         AUDIO_MIXER_TEMP_BUFFER * sizeof(float));
+
+   if (!temp_buffer)
+      return 0;
+
+again:
+   temp_samples = stb_vorbis_get_samples_float_interleaved(
+         voice->types.ogg.stream, 2, temp_buffer,
+         AUDIO_MIXER_TEMP_BUFFER) * 2;
+
+   if (temp_samples == 0)
+   {
+      if (voice->repeat)
+      {
+         *wrapped = true;
+         stb_vorbis_seek_start(voice->types.ogg.stream);
+         goto again;
+      }
+
+      free(temp_buffer);
+      return 0;
+   }
+
+   if (voice->types.ogg.resampler)
+   {
+      struct resampler_data info;
+      info.data_in = temp_buffer;
+      info.data_out = voice->types.ogg.buffer;
+      info.input_frames = temp_samples / 2;
+      info.output_frames = 0;
+      info.ratio = voice->types.ogg.ratio;
+
+      voice->types.ogg.resampler->process(
+            voice->types.ogg.resampler_data, &info);
+   }
+   else
+      memcpy(voice->types.ogg.buffer, temp_buffer,
+            temp_samples * sizeof(float));
+
+   free(temp_buffer);
+   return voice->types.ogg.buf_samples;
+}
+
 static void audio_mixer_mix_ogg(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
-   float* temp_buffer = NULL;
    unsigned buf_free                = (unsigned)(num_frames * 2);
-   unsigned temp_samples            = 0;
    float* pcm                       = NULL;
+   bool wrapped                     = false;
+   float vol_l                      = volume * voice->pan_left;
+   float vol_r                      = volume * voice->pan_right;
 
    if (voice->types.ogg.position == voice->types.ogg.samples)
    {
 again:
-      if (temp_buffer == NULL)
-         temp_buffer = (float*)malloc(AUDIO_MIXER_TEMP_BUFFER * sizeof(float));
-
-      temp_samples = stb_vorbis_get_samples_float_interleaved(
-            voice->types.ogg.stream, 2, temp_buffer,
-            AUDIO_MIXER_TEMP_BUFFER) * 2;
+      voice->types.ogg.samples = audio_mixer_fill_ogg(voice, &wrapped);
 
-      if (temp_samples == 0)
+      if (wrapped && voice->stop_cb)
       {
-         if (voice->repeat)
-         {
-            if (voice->stop_cb)
-               voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
-
-            stb_vorbis_seek_start(voice->types.ogg.stream);
-            goto again;
-         }
+         voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+         wrapped = false;
+      }
 
+      if (voice->types.ogg.samples == 0)
+      {
          if (voice->stop_cb)
             voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_FINISHED);
 
          voice->type = AUDIO_MIXER_TYPE_NONE;
-         goto cleanup;
-      }
-
-      if (voice->types.ogg.resampler)
-      {
-         struct resampler_data info;
-         info.data_in = temp_buffer;
-         info.data_out = voice->types.ogg.buffer;
-         info.input_frames = temp_samples / 2;
-         info.output_frames = 0;
-         info.ratio = voice->types.ogg.ratio;
-
-         voice->types.ogg.resampler->process(
-               voice->types.ogg.resampler_data, &info);
+         return;
       }
-      else
-         memcpy(voice->types.ogg.buffer, temp_buffer,
-               temp_samples * sizeof(float));
 
       voice->types.ogg.position = 0;
-      voice->types.ogg.samples  = voice->types.ogg.buf_samples;
    }
 
    pcm = voice->types.ogg.buffer + voice->types.ogg.position;
 
    if (voice->types.ogg.samples < buf_free)
    {
-      for (i = voice->types.ogg.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_mix_pan(buffer, pcm, voice->types.ogg.samples,
+            vol_l, vol_r);
+      buffer   += voice->types.ogg.samples;
 
       buf_free -= voice->types.ogg.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_mix_pan(buffer, pcm, buf_free, vol_l, vol_r);
 
    voice->types.ogg.position += buf_free;
    voice->types.ogg.samples  -= buf_free;
-
-cleanup:
-   if (temp_buffer != NULL)
-      free(temp_buffer);
 }
 #endif
 
 #ifdef HAVE_IBXM
+/* See audio_mixer_fill_ogg. The buffer holds raw replay output -
+ * the conversion to float happens at mix (or ring fill) time. */
+static unsigned audio_mixer_fill_mod(audio_mixer_voice_t* voice,
+      bool *wrapped)
+{
+   unsigned temp_samples = 0;
+
+again:
+   temp_samples = replay_get_audio(
+         voice->types.mod.stream, voice->types.mod.buffer );
+
+   temp_samples *= 2; /* stereo */
+
+   if (temp_samples == 0)
+   {
+      if (voice->repeat)
+      {
+         *wrapped = true;
+         replay_seek( voice->types.mod.stream, 0);
+         goto again;
+      }
+
+      return 0;
+   }
+
+   return temp_samples;
+}
+
 static void audio_mixer_mix_mod(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
@@ -992,29 +1289,25 @@ static void audio_mixer_mix_mod(float* buffer, size_t num_frames,
    int i;
    float samplef                    = 0.0f;
    int samplei                      = 0;
-   unsigned temp_samples            = 0;
    unsigned buf_free                = (unsigned)(num_frames * 2);
    int* pcm                         = NULL;
+   bool wrapped                     = false;
+   float vol_l                      = volume * voice->pan_left;
+   float vol_r                      = volume * voice->pan_right;
 
    if (voice->types.mod.position == voice->types.mod.samples)
    {
 again:
-      temp_samples = replay_get_audio(
-            voice->types.mod.stream, voice->types.mod.buffer );
-
-      temp_samples *= 2; /* stereo */
+      voice->types.mod.samples = audio_mixer_fill_mod(voice, &wrapped);
 
-      if (temp_samples == 0)
+      if (wrapped && voice->stop_cb)
       {
-         if (voice->repeat)
-         {
-            if (voice->stop_cb)
-               voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
-
-            replay_seek( voice->types.mod.stream, 0);
-            goto again;
-         }
+         voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+         wrapped = false;
+      }
 
+      if (voice->types.mod.samples == 0)
+      {
          if (voice->stop_cb)
             voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_FINISHED);
 
@@ -1023,15 +1316,21 @@ again:
       }
 
       voice->types.mod.position = 0;
-      voice->types.mod.samples  = temp_samples;
    }
    pcm = voice->types.mod.buffer + voice->types.mod.position;
 
    if (voice->types.mod.samples < buf_free)
    {
-      for (i = voice->types.mod.samples; i != 0; i--)
+      /* Counts are always even (interleaved stereo), so the
+       * left/right gains track the channel phase. */
+      for (i = voice->types.mod.samples / 2; i != 0; i--)
       {
-         samplei     = *pcm++ * volume;
+         samplei     = *pcm++ * vol_l;
+         samplef     = (float)((int)samplei + 32768) / 65535.0f;
+         samplef     = samplef * 2.0f - 1.0f;
+         *buffer++  += samplef;
+
+         samplei     = *pcm++ * vol_r;
          samplef     = (float)((int)samplei + 32768) / 65535.0f;
          samplef     = samplef * 2.0f - 1.0f;
          *buffer++  += samplef;
@@ -1041,9 +1340,14 @@ again:
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
+   for (i = buf_free / 2; i != 0; --i )
    {
-      samplei     = *pcm++ * volume;
+      samplei     = *pcm++ * vol_l;
+      samplef     = (float)((int)samplei + 32768) / 65535.0f;
+      samplef     = samplef * 2.0f - 1.0f;
+      *buffer++  += samplef;
+
+      samplei     = *pcm++ * vol_r;
       samplef     = (float)((int)samplei + 32768) / 65535.0f;
       samplef     = samplef * 2.0f - 1.0f;
       *buffer++  += samplef;
@@ -1055,32 +1359,66 @@ again:
 #endif
 
 #ifdef HAVE_DR_FLAC
+/* See audio_mixer_fill_ogg. */
+static unsigned audio_mixer_fill_flac(audio_mixer_voice_t* voice,
+      bool *wrapped)
+{
+   struct resampler_data info;
+   float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
+   unsigned temp_samples                      = 0;
+
+again:
+   temp_samples = (unsigned)drflac_read_f32( voice->types.flac.stream, AUDIO_MIXER_TEMP_BUFFER, temp_buffer);
+   if (temp_samples == 0)
+   {
+      if (voice->repeat)
+      {
+         *wrapped = true;
+         drflac_seek_to_sample(voice->types.flac.stream,0);
+         goto again;
+      }
+
+      return 0;
+   }
+
+   info.data_in              = temp_buffer;
+   info.data_out             = voice->types.flac.buffer;
+   info.input_frames         = temp_samples / 2;
+   info.output_frames        = 0;
+   info.ratio                = voice->types.flac.ratio;
+
+   if (voice->types.flac.resampler)
+      voice->types.flac.resampler->process(
+            voice->types.flac.resampler_data, &info);
+   else
+      memcpy(voice->types.flac.buffer, temp_buffer, temp_samples * sizeof(float));
+
+   return voice->types.flac.buf_samples;
+}
+
 static void audio_mixer_mix_flac(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
-   struct resampler_data info;
-   float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
    unsigned buf_free                = (unsigned)(num_frames * 2);
-   unsigned temp_samples            = 0;
    float *pcm                       = NULL;
+   bool wrapped                     = false;
+   float vol_l                      = volume * voice->pan_left;
+   float vol_r                      = volume * voice->pan_right;
 
    if (voice->types.flac.position == voice->types.flac.samples)
    {
 again:
-      temp_samples = (unsigned)drflac_read_f32( voice->types.flac.stream, AUDIO_MIXER_TEMP_BUFFER, temp_buffer);
-      if (temp_samples == 0)
-      {
-         if (voice->repeat)
-         {
-            if (voice->stop_cb)
-               voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+      voice->types.flac.samples = audio_mixer_fill_flac(voice, &wrapped);
 
-            drflac_seek_to_sample(voice->types.flac.stream,0);
-            goto again;
-         }
+      if (wrapped && voice->stop_cb)
+      {
+         voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+         wrapped = false;
+      }
 
+      if (voice->types.flac.samples == 0)
+      {
          if (voice->stop_cb)
             voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_FINISHED);
 
@@ -1088,34 +1426,22 @@ again:
          return;
       }
 
-      info.data_in              = temp_buffer;
-      info.data_out             = voice->types.flac.buffer;
-      info.input_frames         = temp_samples / 2;
-      info.output_frames        = 0;
-      info.ratio                = voice->types.flac.ratio;
-
-      if (voice->types.flac.resampler)
-         voice->types.flac.resampler->process(
-               voice->types.flac.resampler_data, &info);
-      else
-         memcpy(voice->types.flac.buffer, temp_buffer, temp_samples * sizeof(float));
       voice->types.flac.position = 0;
-      voice->types.flac.samples  = voice->types.flac.buf_samples;
    }
 
    pcm = voice->types.flac.buffer + voice->types.flac.position;
 
    if (voice->types.flac.samples < buf_free)
    {
-      for (i = voice->types.flac.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_mix_pan(buffer, pcm, voice->types.flac.samples,
+            vol_l, vol_r);
+      buffer   += voice->types.flac.samples;
 
       buf_free -= voice->types.flac.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_mix_pan(buffer, pcm, buf_free, vol_l, vol_r);
 
    voice->types.flac.position += buf_free;
    voice->types.flac.samples  -= buf_free;
@@ -1123,35 +1449,70 @@ again:
 #endif
 
 #ifdef HAVE_DR_MP3
+/* See audio_mixer_fill_ogg. */
+static unsigned audio_mixer_fill_mp3(audio_mixer_voice_t* voice,
+      bool *wrapped)
+{
+   struct resampler_data info;
+   float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
+   unsigned temp_samples                      = 0;
+
+again:
+   temp_samples = (unsigned)drmp3_read_f32(
+         &voice->types.mp3.stream,
+         AUDIO_MIXER_TEMP_BUFFER / 2, temp_buffer) * 2;
+
+   if (temp_samples == 0)
+   {
+      if (voice->repeat)
+      {
+         *wrapped = true;
+         drmp3_seek_to_frame(&voice->types.mp3.stream,0);
+         goto again;
+      }
+
+      return 0;
+   }
+
+   info.data_in              = temp_buffer;
+   info.data_out             = voice->types.mp3.buffer;
+   info.input_frames         = temp_samples / 2;
+   info.output_frames        = 0;
+   info.ratio                = voice->types.mp3.ratio;
+
+   if (voice->types.mp3.resampler)
+      voice->types.mp3.resampler->process(
+            voice->types.mp3.resampler_data, &info);
+   else
+      memcpy(voice->types.mp3.buffer, temp_buffer,
+            temp_samples * sizeof(float));
+
+   return voice->types.mp3.buf_samples;
+}
+
 static void audio_mixer_mix_mp3(float* buffer, size_t num_frames,
       audio_mixer_voice_t* voice,
       float volume)
 {
-   int i;
-   struct resampler_data info;
-   float temp_buffer[AUDIO_MIXER_TEMP_BUFFER] = { 0 };
    unsigned buf_free                = (unsigned)(num_frames * 2);
-   unsigned temp_samples            = 0;
    float* pcm                       = NULL;
+   bool wrapped                     = false;
+   float vol_l                      = volume * voice->pan_left;
+   float vol_r                      = volume * voice->pan_right;
 
    if (voice->types.mp3.position == voice->types.mp3.samples)
    {
 again:
-      temp_samples = (unsigned)drmp3_read_f32(
-            &voice->types.mp3.stream,
-            AUDIO_MIXER_TEMP_BUFFER / 2, temp_buffer) * 2;
+      voice->types.mp3.samples = audio_mixer_fill_mp3(voice, &wrapped);
 
-      if (temp_samples == 0)
+      if (wrapped && voice->stop_cb)
       {
-         if (voice->repeat)
-         {
-            if (voice->stop_cb)
-               voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
-
-            drmp3_seek_to_frame(&voice->types.mp3.stream,0);
-            goto again;
-         }
+         voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+         wrapped = false;
+      }
 
+      if (voice->types.mp3.samples == 0)
+      {
          if (voice->stop_cb)
             voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_FINISHED);
 
@@ -1159,41 +1520,226 @@ again:
          return;
       }
 
-      info.data_in              = temp_buffer;
-      info.data_out             = voice->types.mp3.buffer;
-      info.input_frames         = temp_samples / 2;
-      info.output_frames        = 0;
-      info.ratio                = voice->types.mp3.ratio;
-
-      if (voice->types.mp3.resampler)
-         voice->types.mp3.resampler->process(
-               voice->types.mp3.resampler_data, &info);
-      else
-         memcpy(voice->types.mp3.buffer, temp_buffer,
-               temp_samples * sizeof(float));
       voice->types.mp3.position = 0;
-      voice->types.mp3.samples  = voice->types.mp3.buf_samples;
    }
 
    pcm = voice->types.mp3.buffer + voice->types.mp3.position;
 
    if (voice->types.mp3.samples < buf_free)
    {
-      for (i = voice->types.mp3.samples; i != 0; i--)
-         *buffer++ += *pcm++ * volume;
+      audio_mixer_mix_pan(buffer, pcm, voice->types.mp3.samples,
+            vol_l, vol_r);
+      buffer   += voice->types.mp3.samples;
 
       buf_free -= voice->types.mp3.samples;
       goto again;
    }
 
-   for (i = buf_free; i != 0; --i )
-      *buffer++ += *pcm++ * volume;
+   audio_mixer_mix_pan(buffer, pcm, buf_free, vol_l, vol_r);
 
    voice->types.mp3.position += buf_free;
    voice->types.mp3.samples  -= buf_free;
 }
 #endif
 
+#ifdef HAVE_THREADS
+/* Decodes one chunk for a ring-backed voice and pushes it into the
+ * ring. The codec runs with the lock dropped - ring_busy keeps the
+ * voice from being reused until the result is back. Returns false
+ * when nothing could be queued. */
+static bool audio_mixer_thread_fill_voice(audio_mixer_voice_t* voice)
+{
+   bool wrapped      = false;
+   unsigned samples  = 0;
+   unsigned type     = voice->type;
+   const float* src  = NULL;
+
+   voice->ring_busy  = true;
+   slock_unlock(s_lock);
+
+   switch (type)
+   {
+#ifdef HAVE_STB_VORBIS
+      case AUDIO_MIXER_TYPE_OGG:
+         samples = audio_mixer_fill_ogg(voice, &wrapped);
+         src     = voice->types.ogg.buffer;
+         break;
+#endif
+#ifdef HAVE_DR_FLAC
+      case AUDIO_MIXER_TYPE_FLAC:
+         samples = audio_mixer_fill_flac(voice, &wrapped);
+         src     = voice->types.flac.buffer;
+         break;
+#endif
+#ifdef HAVE_DR_MP3
+      case AUDIO_MIXER_TYPE_MP3:
+         samples = audio_mixer_fill_mp3(voice, &wrapped);
+         src     = voice->types.mp3.buffer;
+         break;
+#endif
+#ifdef HAVE_IBXM
+      case AUDIO_MIXER_TYPE_MOD:
+         samples = audio_mixer_fill_mod(voice, &wrapped);
+         break;
+#endif
+      default:
+         break;
+   }
+
+   slock_lock(s_lock);
+   voice->ring_busy = false;
+   /* audio_mixer_stop() may be blocked on this voice - broadcast,
+    * since the worker wait shares the same condition variable */
+   scond_broadcast(s_cond);
+
+   /* The voice may have been stopped while the lock was dropped. */
+   if (!voice->ring || voice->type != type)
+      return false;
+
+   if (samples == 0)
+   {
+      voice->ring_eof = true;
+      return false;
+   }
+
+   if (wrapped)
+      voice->ring_wrap = true;
+
+#ifdef HAVE_IBXM
+   if (type == AUDIO_MIXER_TYPE_MOD)
+   {
+      /* The replay works in fixed point - convert on this thread
+       * so the mixer really only copies. */
+      float out[256];
+      unsigned i, j;
+      const int* pcm = voice->types.mod.buffer;
+
+      for (i = 0; i < samples; i += j)
+      {
+         unsigned n = samples - i;
+         if (n > 256)
+            n = 256;
+
+         for (j = 0; j < n; j++)
+         {
+            float samplef = (float)((int)*pcm++ + 32768) / 65535.0f;
+            out[j]        = samplef * 2.0f - 1.0f;
+         }
+
+         fifo_write(voice->ring, out, n * sizeof(float));
+      }
+
+      return true;
+   }
+#endif
+
+   if (src)
+      fifo_write(voice->ring, src, samples * sizeof(float));
+
+   return true;
+}
+
+static void audio_mixer_thread_loop(void *data)
+{
+   (void)data;
+
+   slock_lock(s_lock);
+
+   while (!s_thread_quit)
+   {
+      unsigned i;
+      bool filled                = false;
+      audio_mixer_voice_t* voice = s_voices;
+
+      for (i = 0; i < AUDIO_MIXER_MAX_VOICES && !s_thread_quit; i++, voice++)
+      {
+         unsigned chunk;
+
+         if (!voice->ring || voice->ring_eof)
+            continue;
+         if (voice->type == AUDIO_MIXER_TYPE_NONE)
+            continue;
+
+         chunk = audio_mixer_voice_chunk_samples(voice);
+         if (!chunk
+               || FIFO_WRITE_AVAIL(voice->ring) < chunk * sizeof(float))
+            continue;
+
+         if (audio_mixer_thread_fill_voice(voice))
+            filled = true;
+      }
+
+      /* Everything is topped up - sleep until the mixer drains some
+       * of it. The timeout covers a signal racing the wait. */
+      if (!filled && !s_thread_quit)
+         scond_wait_timeout(s_cond, s_lock, 100000);
+   }
+
+   slock_unlock(s_lock);
+}
+
+/* Mix path for ring-backed voices: nothing but copies. An underrun
+ * leaves the rest of the block silent instead of stalling on the
+ * decoder - the thread catches up by the next block. */
+static void audio_mixer_mix_stream(float* buffer, size_t num_frames,
+      audio_mixer_voice_t* voice,
+      float volume)
+{
+   float chunk[256];
+   unsigned buf_free = (unsigned)(num_frames * 2);
+   bool wrapped      = false;
+   bool finished     = false;
+   float vol_l       = volume * voice->pan_left;
+   float vol_r       = volume * voice->pan_right;
+
+   slock_lock(s_lock);
+
+   if (!voice->ring || voice->type == AUDIO_MIXER_TYPE_NONE)
+   {
+      slock_unlock(s_lock);
+      return;
+   }
+
+   while (buf_free)
+   {
+      size_t avail = FIFO_READ_AVAIL(voice->ring) / sizeof(float);
+      unsigned n   = (avail < buf_free) ? (unsigned)avail : buf_free;
+
+      if (!n)
+         break;
+      if (n > 256)
+         n = 256;
+
+      fifo_read(voice->ring, chunk, n * sizeof(float));
+
+      audio_mixer_mix_pan(buffer, chunk, n, vol_l, vol_r);
+      buffer   += n;
+
+      buf_free -= n;
+   }
+
+   wrapped          = voice->ring_wrap;
+   voice->ring_wrap = false;
+
+   if (buf_free && voice->ring_eof)
+   {
+      finished    = true;
+      voice->type = AUDIO_MIXER_TYPE_NONE;
+   }
+
+   slock_unlock(s_lock);
+
+   if (s_cond)
+      scond_signal(s_cond);
+
+   if (wrapped && voice->stop_cb)
+      voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_REPEATED);
+
+   if (finished && voice->stop_cb)
+      voice->stop_cb(voice->sound, AUDIO_MIXER_SOUND_FINISHED);
+}
+#endif
+
 void audio_mixer_mix(float* buffer, size_t num_frames,
       float volume_override, bool override)
 {
@@ -1204,7 +1750,31 @@ void audio_mixer_mix(float* buffer, size_t num_frames,
 
    for (i = 0; i < AUDIO_MIXER_MAX_VOICES; i++, voice++)
    {
-      float volume = (override) ? volume_override : voice->volume;
+      float volume;
+
+      if (voice->type != AUDIO_MIXER_TYPE_NONE && voice->fade_step != 0.0f)
+      {
+         float vol = voice->volume + voice->fade_step * (float)num_frames;
+
+         if (     (voice->fade_step > 0.0f && vol >= voice->fade_target)
+               || (voice->fade_step < 0.0f && vol <= voice->fade_target))
+         {
+            vol              = voice->fade_target;
+            voice->fade_step = 0.0f;
+         }
+
+         voice->volume = vol;
+      }
+
+      volume = (override) ? volume_override : voice->volume;
+
+#ifdef HAVE_THREADS
+      if (voice->ring && voice->type != AUDIO_MIXER_TYPE_NONE)
+      {
+         audio_mixer_mix_stream(buffer, num_frames, voice, volume);
+         continue;
+      }
+#endif
 
       switch (voice->type)
       {
@@ -1258,5 +1828,48 @@ void audio_mixer_voice_set_volume(audio_mixer_voice_t *voice, float val)
    if (!voice)
       return;
 
-   voice->volume = val;
+   voice->volume    = val;
+   voice->fade_step = 0.0f;
+}
+
+void audio_mixer_voice_set_pan(audio_mixer_voice_t *voice, float pan)
+{
+   float angle;
+
+   if (!voice)
+      return;
+
+   if (pan < -1.0f)
+      pan = -1.0f;
+   else if (pan > 1.0f)
+      pan = 1.0f;
+
+   /* Constant-power curve, scaled so the centre position
+    * keeps both channels at unity. */
+   angle            = (pan + 1.0f) * (float)M_PI / 4.0f;
+   voice->pan_left  = cosf(angle) * 1.41421356237f;
+   voice->pan_right = sinf(angle) * 1.41421356237f;
+}
+
+void audio_mixer_voice_fade(audio_mixer_voice_t *voice, float target,
+      unsigned duration_ms)
+{
+   float frames;
+
+   if (!voice)
+      return;
+
+   if (!duration_ms || !s_rate)
+   {
+      voice->volume    = target;
+      voice->fade_step = 0.0f;
+      return;
+   }
+
+   frames             = (float)s_rate * (float)duration_ms / 1000.0f;
+   voice->fade_target = target;
+   voice->fade_step   = (target - voice->volume) / frames;
+
+   if (voice->fade_step == 0.0f)
+      voice->volume = target;
 }
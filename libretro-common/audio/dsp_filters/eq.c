@@ -100,8 +100,48 @@ static void eq_process(void *data, struct dspfilter_output *output,
          for (c = 0; c < 2; c++)
          {
             fft_process_forward(eq->fft, eq->fftblock, eq->block + c, 2);
+
+            /* Apply the FFT filter, two bins per vector.
+             * Same complex multiply as in the fft.c butterflies. */
+#if defined(__SSE2__)
+            {
+               const __m128 flip = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+               for (i = 0; i < 2 * eq->block_size; i += 2)
+               {
+                  __m128 f    = _mm_loadu_ps((const float*)&eq->filter[i]);
+                  __m128 x    = _mm_loadu_ps((const float*)&eq->fftblock[i]);
+                  __m128 f_re = _mm_shuffle_ps(f, f, _MM_SHUFFLE(2, 2, 0, 0));
+                  __m128 f_im = _mm_shuffle_ps(f, f, _MM_SHUFFLE(3, 3, 1, 1));
+                  __m128 x_sw = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+
+                  _mm_storeu_ps((float*)&eq->fftblock[i],
+                        _mm_add_ps(_mm_mul_ps(f_re, x),
+                           _mm_xor_ps(_mm_mul_ps(f_im, x_sw), flip)));
+               }
+            }
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+            {
+               static const uint32_t flip_bits[4] =
+                  { 0x80000000u, 0, 0x80000000u, 0 };
+               const uint32x4_t flip = vld1q_u32(flip_bits);
+               for (i = 0; i < 2 * eq->block_size; i += 2)
+               {
+                  float32x4_t f    = vld1q_f32((const float*)&eq->filter[i]);
+                  float32x4_t x    = vld1q_f32((const float*)&eq->fftblock[i]);
+                  float32x4x2_t tr = vtrnq_f32(f, f);
+                  float32x4_t x_sw = vrev64q_f32(x);
+
+                  vst1q_f32((float*)&eq->fftblock[i],
+                        vaddq_f32(vmulq_f32(tr.val[0], x),
+                           vreinterpretq_f32_u32(veorq_u32(
+                                 vreinterpretq_u32_f32(
+                                    vmulq_f32(tr.val[1], x_sw)), flip))));
+               }
+            }
+#else
             for (i = 0; i < 2 * eq->block_size; i++)
                eq->fftblock[i] = fft_complex_mul(eq->fftblock[i], eq->filter[i]);
+#endif
             fft_process_inverse(eq->fft, out + c, eq->fftblock, 2);
          }
 
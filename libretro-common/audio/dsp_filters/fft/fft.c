@@ -23,6 +23,12 @@
 #include <math.h>
 #include <stdlib.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#endif
+
 #include "fft.h"
 
 #include <retro_miscellaneous.h>
@@ -145,6 +151,90 @@ static void butterflies(fft_complex_t *butterfly_buf,
       int phase_dir, unsigned step_size, unsigned samples)
 {
    unsigned i, j;
+
+   /* From the second stage on, the two wings of a butterfly are at
+    * least two complex numbers apart, so a pair of butterflies can
+    * ride in one 4-float vector. The first stage (step_size == 1)
+    * stays scalar - it works on adjacent elements. */
+#if defined(__SSE2__)
+   if (step_size >= 2)
+   {
+      /* Flips the sign of the real lanes, for the subtract half
+       * of the complex multiply. */
+      const __m128 flip = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+
+      for (i = 0; i < samples; i += step_size << 1)
+      {
+         int phase_step = (int)samples * phase_dir / (int)step_size;
+         for (j = i; j < i + step_size; j += 2)
+         {
+            const fft_complex_t *p0 =
+               &phase_lut[phase_step * (int)(j - i)];
+            const fft_complex_t *p1 =
+               &phase_lut[phase_step * (int)(j - i + 1)];
+            __m128 mod  = _mm_loadl_pi(_mm_setzero_ps(),
+                  (const __m64*)p0);
+            __m128 a    = _mm_loadu_ps(
+                  (const float*)&butterfly_buf[j]);
+            __m128 b    = _mm_loadu_ps(
+                  (const float*)&butterfly_buf[j + step_size]);
+            __m128 m_re, m_im, b_sw, prod;
+
+            mod  = _mm_loadh_pi(mod, (const __m64*)p1);
+            m_re = _mm_shuffle_ps(mod, mod, _MM_SHUFFLE(2, 2, 0, 0));
+            m_im = _mm_shuffle_ps(mod, mod, _MM_SHUFFLE(3, 3, 1, 1));
+            b_sw = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+            prod = _mm_add_ps(_mm_mul_ps(m_re, b),
+                  _mm_xor_ps(_mm_mul_ps(m_im, b_sw), flip));
+
+            _mm_storeu_ps((float*)&butterfly_buf[j + step_size],
+                  _mm_sub_ps(a, prod));
+            _mm_storeu_ps((float*)&butterfly_buf[j],
+                  _mm_add_ps(a, prod));
+         }
+      }
+      return;
+   }
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+   if (step_size >= 2)
+   {
+      static const uint32_t flip_bits[4] =
+         { 0x80000000u, 0, 0x80000000u, 0 };
+      const uint32x4_t flip = vld1q_u32(flip_bits);
+
+      for (i = 0; i < samples; i += step_size << 1)
+      {
+         int phase_step = (int)samples * phase_dir / (int)step_size;
+         for (j = i; j < i + step_size; j += 2)
+         {
+            const fft_complex_t *p0 =
+               &phase_lut[phase_step * (int)(j - i)];
+            const fft_complex_t *p1 =
+               &phase_lut[phase_step * (int)(j - i + 1)];
+            float32x4_t mod  = vcombine_f32(
+                  vld1_f32((const float*)p0),
+                  vld1_f32((const float*)p1));
+            float32x4_t a    = vld1q_f32(
+                  (const float*)&butterfly_buf[j]);
+            float32x4_t b    = vld1q_f32(
+                  (const float*)&butterfly_buf[j + step_size]);
+            float32x4x2_t tr = vtrnq_f32(mod, mod);
+            float32x4_t b_sw = vrev64q_f32(b);
+            float32x4_t prod = vaddq_f32(vmulq_f32(tr.val[0], b),
+                  vreinterpretq_f32_u32(veorq_u32(
+                        vreinterpretq_u32_f32(
+                           vmulq_f32(tr.val[1], b_sw)), flip)));
+
+            vst1q_f32((float*)&butterfly_buf[j + step_size],
+                  vsubq_f32(a, prod));
+            vst1q_f32((float*)&butterfly_buf[j],
+                  vaddq_f32(a, prod));
+         }
+      }
+      return;
+   }
+#endif
+
    for (i = 0; i < samples; i += step_size << 1)
    {
       int phase_step = (int)samples * phase_dir / (int)step_size;
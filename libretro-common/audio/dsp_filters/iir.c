@@ -24,6 +24,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#endif
+
 #include <retro_miscellaneous.h>
 #include <libretro_dspfilter.h>
 #include <string/stdstring.h>
@@ -91,6 +97,101 @@ static void iir_process(void *data, struct dspfilter_output *output,
    output->samples      = input->samples;
    output->frames       = input->frames;
 
+   /* The recurrence is serial in time, but left and right run the
+    * same filter independently - fold the two channels into the
+    * low lanes of one vector and step both at once. */
+#if defined(__SSE2__)
+   {
+      __m128 b0v    = _mm_set1_ps(b0);
+      __m128 b1v    = _mm_set1_ps(b1);
+      __m128 b2v    = _mm_set1_ps(b2);
+      __m128 a1v    = _mm_set1_ps(a1);
+      __m128 a2v    = _mm_set1_ps(a2);
+      __m128 inv_a0 = _mm_set1_ps(1.0f / a0);
+      __m128 xn1    = _mm_setr_ps(xn1_l, xn1_r, 0.0f, 0.0f);
+      __m128 xn2    = _mm_setr_ps(xn2_l, xn2_r, 0.0f, 0.0f);
+      __m128 yn1    = _mm_setr_ps(yn1_l, yn1_r, 0.0f, 0.0f);
+      __m128 yn2    = _mm_setr_ps(yn2_l, yn2_r, 0.0f, 0.0f);
+
+      for (i = 0; i < input->frames; i++, out += 2)
+      {
+         __m128 x = _mm_castpd_ps(_mm_load_sd((const double*)out));
+         __m128 y = _mm_mul_ps(b0v, x);
+
+         y        = _mm_add_ps(y, _mm_mul_ps(b1v, xn1));
+         y        = _mm_add_ps(y, _mm_mul_ps(b2v, xn2));
+         y        = _mm_sub_ps(y, _mm_mul_ps(a1v, yn1));
+         y        = _mm_sub_ps(y, _mm_mul_ps(a2v, yn2));
+         y        = _mm_mul_ps(y, inv_a0);
+
+         xn2      = xn1;
+         xn1      = x;
+         yn2      = yn1;
+         yn1      = y;
+
+         _mm_store_sd((double*)out, _mm_castps_pd(y));
+      }
+
+      xn1_l = _mm_cvtss_f32(xn1);
+      xn1_r = _mm_cvtss_f32(_mm_shuffle_ps(xn1, xn1, 0x55));
+      xn2_l = _mm_cvtss_f32(xn2);
+      xn2_r = _mm_cvtss_f32(_mm_shuffle_ps(xn2, xn2, 0x55));
+      yn1_l = _mm_cvtss_f32(yn1);
+      yn1_r = _mm_cvtss_f32(_mm_shuffle_ps(yn1, yn1, 0x55));
+      yn2_l = _mm_cvtss_f32(yn2);
+      yn2_r = _mm_cvtss_f32(_mm_shuffle_ps(yn2, yn2, 0x55));
+   }
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+   {
+      float state[8];
+      float32x2_t b0v    = vdup_n_f32(b0);
+      float32x2_t b1v    = vdup_n_f32(b1);
+      float32x2_t b2v    = vdup_n_f32(b2);
+      float32x2_t a1v    = vdup_n_f32(a1);
+      float32x2_t a2v    = vdup_n_f32(a2);
+      float32x2_t inv_a0 = vdup_n_f32(1.0f / a0);
+      float32x2_t xn1, xn2, yn1, yn2;
+
+      state[0] = xn1_l; state[1] = xn1_r;
+      state[2] = xn2_l; state[3] = xn2_r;
+      state[4] = yn1_l; state[5] = yn1_r;
+      state[6] = yn2_l; state[7] = yn2_r;
+
+      xn1 = vld1_f32(state + 0);
+      xn2 = vld1_f32(state + 2);
+      yn1 = vld1_f32(state + 4);
+      yn2 = vld1_f32(state + 6);
+
+      for (i = 0; i < input->frames; i++, out += 2)
+      {
+         float32x2_t x = vld1_f32(out);
+         float32x2_t y = vmul_f32(b0v, x);
+
+         y             = vmla_f32(y, b1v, xn1);
+         y             = vmla_f32(y, b2v, xn2);
+         y             = vmls_f32(y, a1v, yn1);
+         y             = vmls_f32(y, a2v, yn2);
+         y             = vmul_f32(y, inv_a0);
+
+         xn2           = xn1;
+         xn1           = x;
+         yn2           = yn1;
+         yn1           = y;
+
+         vst1_f32(out, y);
+      }
+
+      vst1_f32(state + 0, xn1);
+      vst1_f32(state + 2, xn2);
+      vst1_f32(state + 4, yn1);
+      vst1_f32(state + 6, yn2);
+
+      xn1_l = state[0]; xn1_r = state[1];
+      xn2_l = state[2]; xn2_r = state[3];
+      yn1_l = state[4]; yn1_r = state[5];
+      yn2_l = state[6]; yn2_r = state[7];
+   }
+#else
    for (i = 0; i < input->frames; i++, out += 2)
    {
       float in_l = out[0];
@@ -112,6 +213,7 @@ static void iir_process(void *data, struct dspfilter_output *output,
       out[0]     = l;
       out[1]     = r;
    }
+#endif
 
    iir->l.xn1 = xn1_l;
    iir->l.xn2 = xn2_l;
@@ -0,0 +1,540 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (bench.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* Microbenchmarks for the hot kernels in libretro-common (plus the
+ * rewind delta encoder). Prints one JSON document to stdout so the
+ * numbers can be archived and diffed between revisions:
+ *
+ *   make -C libretro-common/benchmarks && libretro-common/benchmarks/retro_bench
+ *
+ * Wall time comes from cpu_features_get_time_usec() and the raw
+ * counter from cpu_features_get_perf_counter(), which is the cycle
+ * counter on the platforms we care about. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <features/features_cpu.h>
+#include <retro_timers.h>
+#include <audio/audio_resampler.h>
+#include <audio/audio_mix.h>
+#include <audio/conversion/float_to_s16.h>
+#include <audio/conversion/s16_to_float.h>
+#include <encodings/crc32.h>
+#include <formats/rpng.h>
+#include <formats/image.h>
+#include <streams/file_stream.h>
+#include <queues/fifo_queue.h>
+#include <libretro.h>
+
+#include "../../core.h"
+#include "../../managers/state_manager.h"
+#include "../../msg_hash.h"
+#include "../../retroarch.h"
+#include "../../verbosity.h"
+
+/* Defeats dead code elimination of the kernels under test. */
+static volatile uint32_t bench_sink;
+
+static bool bench_first = true;
+
+static void bench_report(const char *name, uint64_t iters,
+      retro_time_t total_usec, uint64_t total_counts,
+      double bytes_per_iter)
+{
+   double us_per_iter = (double)total_usec / (double)iters;
+   double mb_per_sec  = 0.0;
+
+   if (total_usec > 0)
+      mb_per_sec = (bytes_per_iter * (double)iters) /
+         ((double)total_usec / 1000000.0) / (1024.0 * 1024.0);
+
+   printf("%s    {\"name\": \"%s\", \"iterations\": %llu, "
+         "\"us_per_iter\": %.3f, \"counts_per_iter\": %.0f, "
+         "\"mb_per_s\": %.1f}",
+         bench_first ? "" : ",\n",
+         name,
+         (unsigned long long)iters,
+         us_per_iter,
+         (double)total_counts / (double)iters,
+         mb_per_sec);
+   bench_first = false;
+}
+
+/* Fills a buffer with something compressible but not trivial,
+ * so zlib/CRC/delta benchmarks see realistic entropy. */
+static void bench_fill_pattern(void *buf, size_t size, uint32_t seed)
+{
+   size_t i;
+   uint8_t *b = (uint8_t*)buf;
+
+   for (i = 0; i < size; i++)
+   {
+      seed = seed * 1664525 + 1013904223;
+      b[i] = (uint8_t)((seed >> 24) & 0x3f);
+   }
+}
+
+/* ---- sinc resampler -------------------------------------------- */
+
+#define SINC_FRAMES 1024
+#define SINC_ITERS  2048
+
+static void bench_sinc(enum resampler_quality quality, const char *name)
+{
+   unsigned i, j;
+   retro_time_t t0;
+   uint64_t c0;
+   const retro_resampler_t *resampler = NULL;
+   void *resampler_data               = NULL;
+   double ratio                       = 48000.0 / 44100.0;
+   float *input                       = (float*)malloc(
+         SINC_FRAMES * 2 * sizeof(float));
+   float *output                      = (float*)malloc(
+         SINC_FRAMES * 4 * sizeof(float));
+   struct resampler_data data;
+
+   if (!input || !output)
+      goto end;
+
+   for (i = 0; i < SINC_FRAMES; i++)
+   {
+      float v              = sinf((float)i * 0.07f);
+      input[2 * i + 0]     = v;
+      input[2 * i + 1]     = -v;
+   }
+
+   if (!retro_resampler_realloc(&resampler_data, &resampler,
+            "sinc", quality, ratio))
+      goto end;
+
+   data.data_in       = input;
+   data.data_out      = output;
+   data.input_frames  = SINC_FRAMES;
+   data.output_frames = 0;
+   data.ratio         = ratio;
+
+   /* Warm the filter state and caches. */
+   for (j = 0; j < 8; j++)
+      resampler->process(resampler_data, &data);
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+
+   for (j = 0; j < SINC_ITERS; j++)
+      resampler->process(resampler_data, &data);
+
+   bench_report(name, SINC_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(SINC_FRAMES * 2 * sizeof(float)));
+
+   bench_sink += (uint32_t)output[0];
+
+end:
+   if (resampler && resampler_data)
+      resampler->free(resampler_data);
+   free(input);
+   free(output);
+}
+
+/* ---- audio_mix_volume / float<->s16 ---------------------------- */
+
+#define CONV_SAMPLES 16384
+#define CONV_ITERS   16384
+
+static void bench_audio_conversion(void)
+{
+   unsigned i, j;
+   retro_time_t t0;
+   uint64_t c0;
+   float *dst     = (float*)calloc(CONV_SAMPLES, sizeof(float));
+   float *src     = (float*)malloc(CONV_SAMPLES * sizeof(float));
+   int16_t *s16   = (int16_t*)malloc(CONV_SAMPLES * sizeof(int16_t));
+
+   if (!dst || !src || !s16)
+      goto end;
+
+   for (i = 0; i < CONV_SAMPLES; i++)
+      src[i] = sinf((float)i * 0.011f);
+
+   convert_float_to_s16_init_simd();
+   convert_s16_to_float_init_simd();
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < CONV_ITERS; j++)
+      audio_mix_volume(dst, src, 0.707f, CONV_SAMPLES);
+   bench_report("audio_mix_volume", CONV_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(CONV_SAMPLES * sizeof(float)));
+   bench_sink += (uint32_t)dst[1];
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < CONV_ITERS; j++)
+      convert_float_to_s16(s16, src, CONV_SAMPLES);
+   bench_report("convert_float_to_s16", CONV_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(CONV_SAMPLES * sizeof(float)));
+   bench_sink += (uint32_t)s16[1];
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < CONV_ITERS; j++)
+      convert_s16_to_float(dst, s16, CONV_SAMPLES, 1.0f);
+   bench_report("convert_s16_to_float", CONV_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(CONV_SAMPLES * sizeof(int16_t)));
+   bench_sink += (uint32_t)dst[2];
+
+end:
+   free(dst);
+   free(src);
+   free(s16);
+}
+
+/* ---- CRC32 ----------------------------------------------------- */
+
+#define CRC_SIZE  (1024 * 1024)
+#define CRC_ITERS 256
+
+static void bench_crc32(void)
+{
+   unsigned j;
+   retro_time_t t0;
+   uint64_t c0;
+   uint32_t crc  = 0;
+   uint8_t *buf  = (uint8_t*)malloc(CRC_SIZE);
+
+   if (!buf)
+      return;
+
+   bench_fill_pattern(buf, CRC_SIZE, 0xdeadbeef);
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < CRC_ITERS; j++)
+      crc = encoding_crc32(crc, buf, CRC_SIZE);
+   bench_report("encoding_crc32", CRC_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)CRC_SIZE);
+
+   bench_sink += crc;
+   free(buf);
+}
+
+/* ---- rpng decode ----------------------------------------------- */
+
+#define RPNG_DIM   256
+#define RPNG_ITERS 64
+#define RPNG_PATH  "bench_rpng.png"
+
+static bool bench_rpng_decode_once(const uint8_t *buf, size_t len)
+{
+   int retval;
+   unsigned width  = 0;
+   unsigned height = 0;
+   uint32_t *data  = NULL;
+   bool ret        = true;
+   rpng_t *rpng    = rpng_alloc();
+
+   if (!rpng)
+      return false;
+
+   if (!rpng_set_buf_ptr(rpng, (uint8_t*)buf, len))
+   {
+      ret = false;
+      goto end;
+   }
+   if (!rpng_start(rpng))
+   {
+      ret = false;
+      goto end;
+   }
+
+   while (rpng_iterate_image(rpng));
+
+   if (!rpng_is_valid(rpng))
+   {
+      ret = false;
+      goto end;
+   }
+
+   do
+   {
+      retval = rpng_process_image(rpng,
+            (void**)&data, len, &width, &height);
+   } while (retval == IMAGE_PROCESS_NEXT);
+
+   if (retval == IMAGE_PROCESS_ERROR || retval == IMAGE_PROCESS_ERROR_END)
+      ret = false;
+
+   if (data)
+      bench_sink += data[0];
+
+end:
+   rpng_free(rpng);
+   free(data);
+   return ret;
+}
+
+static void bench_rpng(void)
+{
+   unsigned i, j;
+   retro_time_t t0;
+   uint64_t c0;
+   int64_t len    = 0;
+   uint8_t *buf   = NULL;
+   uint32_t *img  = (uint32_t*)malloc(
+         RPNG_DIM * RPNG_DIM * sizeof(uint32_t));
+
+   if (!img)
+      return;
+
+   bench_fill_pattern(img, RPNG_DIM * RPNG_DIM * sizeof(uint32_t), 0xcafe);
+   for (i = 0; i < RPNG_DIM * RPNG_DIM; i++)
+      img[i] |= 0xff000000;
+
+   if (!rpng_save_image_argb(RPNG_PATH, img,
+            RPNG_DIM, RPNG_DIM, RPNG_DIM * sizeof(uint32_t)))
+      goto end;
+
+   if (!filestream_read_file(RPNG_PATH, (void**)&buf, &len) || len <= 0)
+      goto end;
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < RPNG_ITERS; j++)
+   {
+      if (!bench_rpng_decode_once(buf, (size_t)len))
+         goto end;
+   }
+   bench_report("rpng_decode_256x256", RPNG_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(RPNG_DIM * RPNG_DIM * sizeof(uint32_t)));
+
+end:
+   filestream_delete(RPNG_PATH);
+   free(buf);
+   free(img);
+}
+
+/* ---- rewind delta encode --------------------------------------- */
+
+/* The compressor itself is private to state_manager.c, so this
+ * drives it through the public rewind API. The core_serialize stub
+ * below hands it a synthetic state where a small, moving fraction
+ * of the words changes per frame - roughly what a real core
+ * produces between frames. */
+
+#define STATE_SIZE    (2 * 1024 * 1024)
+#define STATE_BUFFER  (64 * 1024 * 1024)
+#define STATE_ITERS   512
+
+static uint8_t *bench_state;
+static uint32_t bench_state_frame;
+
+static void bench_state_mutate(void)
+{
+   unsigned i;
+   uint32_t off = (bench_state_frame * 4099) % (STATE_SIZE - 4096);
+
+   /* Touch ~1% of the state in a handful of runs. */
+   for (i = 0; i < STATE_SIZE / 100; i++)
+      bench_state[(off + i * 7) % STATE_SIZE] ^=
+         (uint8_t)(bench_state_frame + i);
+
+   bench_state_frame++;
+}
+
+static void bench_state_manager(void)
+{
+   unsigned j;
+   retro_time_t t0;
+   uint64_t c0;
+   char msg[128];
+   unsigned time_val = 0;
+
+   bench_state = (uint8_t*)malloc(STATE_SIZE);
+   if (!bench_state)
+      return;
+
+   bench_fill_pattern(bench_state, STATE_SIZE, 0x1234);
+
+   state_manager_event_init(STATE_BUFFER);
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < STATE_ITERS; j++)
+   {
+      bench_state_mutate();
+      state_manager_check_rewind(false, 1, false,
+            msg, sizeof(msg), &time_val);
+   }
+   bench_report("state_manager_delta_encode", STATE_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)STATE_SIZE);
+
+   state_manager_event_deinit();
+   free(bench_state);
+   bench_state = NULL;
+}
+
+/* ---- fifo_queue ------------------------------------------------ */
+
+#define FIFO_SIZE  (1024 * 1024)
+#define FIFO_CHUNK 4096
+#define FIFO_ITERS 200000
+
+static void bench_fifo(void)
+{
+   unsigned j;
+   retro_time_t t0;
+   uint64_t c0;
+   uint8_t chunk[FIFO_CHUNK];
+   fifo_buffer_t *fifo = fifo_new(FIFO_SIZE);
+
+   if (!fifo)
+      return;
+
+   bench_fill_pattern(chunk, sizeof(chunk), 0x77);
+
+   c0 = cpu_features_get_perf_counter();
+   t0 = cpu_features_get_time_usec();
+   for (j = 0; j < FIFO_ITERS; j++)
+   {
+      fifo_write(fifo, chunk, sizeof(chunk));
+      fifo_read(fifo, chunk, sizeof(chunk));
+   }
+   bench_report("fifo_queue_write_read_4k", FIFO_ITERS,
+         cpu_features_get_time_usec() - t0,
+         cpu_features_get_perf_counter() - c0,
+         (double)(2 * sizeof(chunk)));
+
+   bench_sink += chunk[0];
+   fifo_free(fifo);
+}
+
+/* ---- frontend stubs -------------------------------------------- */
+
+/* state_manager.c is a frontend translation unit; these satisfy its
+ * few outward references so it links into this standalone binary. */
+
+const char *msg_hash_to_str(enum msg_hash_enums msg)
+{
+   (void)msg;
+   return "benchmark";
+}
+
+bool rarch_ctl(enum rarch_ctl_state state, void *data)
+{
+   (void)state;
+   (void)data;
+   return false;
+}
+
+bool audio_driver_has_callback(void)
+{
+   return false;
+}
+
+void audio_driver_frame_is_reverse(void)
+{
+}
+
+void audio_driver_setup_rewind(void)
+{
+}
+
+bool core_serialize_size(retro_ctx_size_info_t *info)
+{
+   info->size = STATE_SIZE;
+   return true;
+}
+
+bool core_serialize(retro_ctx_serialize_info_t *info)
+{
+   memcpy((void*)info->data, bench_state, STATE_SIZE);
+   return true;
+}
+
+bool core_unserialize(retro_ctx_serialize_info_t *info)
+{
+   memcpy(bench_state, info->data, STATE_SIZE);
+   return true;
+}
+
+bool core_set_rewind_callbacks(void)
+{
+   return true;
+}
+
+void RARCH_LOG(const char *fmt, ...)
+{
+   (void)fmt;
+}
+
+void RARCH_WARN(const char *fmt, ...)
+{
+   (void)fmt;
+}
+
+void RARCH_ERR(const char *fmt, ...)
+{
+   (void)fmt;
+}
+
+/* ---------------------------------------------------------------- */
+
+int main(void)
+{
+   printf("{\n  \"benchmarks\": [\n");
+
+   bench_sinc(RESAMPLER_QUALITY_LOWEST,  "sinc_lowest");
+   bench_sinc(RESAMPLER_QUALITY_LOWER,   "sinc_lower");
+   bench_sinc(RESAMPLER_QUALITY_NORMAL,  "sinc_normal");
+   bench_sinc(RESAMPLER_QUALITY_HIGHER,  "sinc_higher");
+   bench_sinc(RESAMPLER_QUALITY_HIGHEST, "sinc_highest");
+   bench_audio_conversion();
+   bench_crc32();
+   bench_rpng();
+   bench_state_manager();
+   bench_fifo();
+
+   printf("\n  ]\n}\n");
+
+   /* Keep the compiler honest. */
+   if (bench_sink == 0xffffffffu)
+      fprintf(stderr, "sink: %u\n", bench_sink);
+
+   return 0;
+}
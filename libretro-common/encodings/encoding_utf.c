@@ -37,8 +37,20 @@
 #include <xtl.h>
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define UTF8_WALKBYTE(string) (*((*(string))++))
 
+/* The length/skip/copy helpers below walk one byte at a time and sit
+ * in per-frame paths (ticker text, word wrapping, width measurement).
+ * With SSE2 they process 16-byte chunks instead: continuation bytes
+ * all match (b & 0xC0) == 0x80, so a chunk can be counted or skipped
+ * with a couple of compares and a movemask. Loads are aligned so they
+ * cannot cross into an unmapped page, and the scalar loops remain as
+ * both tail handling and the portable fallback. */
+
 static unsigned leading_ones(uint8_t c)
 {
    unsigned ones = 0;
@@ -61,10 +73,46 @@ size_t utf8_conv_utf32(uint32_t *out, size_t out_chars,
    size_t ret = 0;
    while (in_size && out_chars)
    {
-      unsigned extra, shift;
+      unsigned extra, shift, ones;
       uint32_t c;
-      uint8_t first = *in++;
-      unsigned ones = leading_ones(first);
+      uint8_t first;
+
+#if defined(__SSE2__)
+      /* Bulk-widen runs of ASCII. */
+      while (in_size >= 16 && out_chars >= 16)
+      {
+         __m128i zero  = _mm_setzero_si128();
+         __m128i chunk = _mm_loadu_si128((const __m128i*)in);
+         __m128i lo, hi;
+
+         if (_mm_movemask_epi8(chunk))
+            break;
+
+         lo = _mm_unpacklo_epi8(chunk, zero);
+         hi = _mm_unpackhi_epi8(chunk, zero);
+
+         _mm_storeu_si128((__m128i*)(out + 0),
+               _mm_unpacklo_epi16(lo, zero));
+         _mm_storeu_si128((__m128i*)(out + 4),
+               _mm_unpackhi_epi16(lo, zero));
+         _mm_storeu_si128((__m128i*)(out + 8),
+               _mm_unpacklo_epi16(hi, zero));
+         _mm_storeu_si128((__m128i*)(out + 12),
+               _mm_unpackhi_epi16(hi, zero));
+
+         in        += 16;
+         out       += 16;
+         in_size   -= 16;
+         out_chars -= 16;
+         ret       += 16;
+      }
+
+      if (!in_size || !out_chars)
+         break;
+#endif
+
+      first = *in++;
+      ones  = leading_ones(first);
 
       if (ones > 6 || ones == 1) /* Invalid or desync. */
          break;
@@ -166,6 +214,35 @@ size_t utf8cpy(char *d, size_t d_len, const char *s, size_t chars)
    if (!s)
       return 0;
 
+#if defined(__SSE2__)
+   if (chars >= 16)
+   {
+      while (((uintptr_t)sb & 15) && *sb && chars)
+      {
+         sb++;
+         chars--;
+         while ((*sb & 0xC0) == 0x80)
+            sb++;
+      }
+
+      /* The alignment loop may have stopped at the terminator
+       * instead of at an aligned address. */
+      while (!((uintptr_t)sb & 15) && chars >= 16)
+      {
+         __m128i chunk = _mm_load_si128((const __m128i*)sb);
+
+         /* Chunk must be all ASCII with no terminator. */
+         if (     _mm_movemask_epi8(chunk)
+               || _mm_movemask_epi8(_mm_cmpeq_epi8(chunk,
+                     _mm_setzero_si128())))
+            break;
+
+         sb    += 16;
+         chars -= 16;
+      }
+   }
+#endif
+
    while (*sb && chars-- > 0)
    {
       sb++;
@@ -193,6 +270,34 @@ const char *utf8skip(const char *str, size_t chars)
    if (!chars)
       return str;
 
+#if defined(__SSE2__)
+   if (chars >= 16)
+   {
+      while (((uintptr_t)strb & 15) && chars)
+      {
+         strb++;
+         while ((*strb & 0xC0) == 0x80)
+            strb++;
+         chars--;
+      }
+
+      /* ASCII-only chunks are one char per byte. */
+      while (chars >= 16)
+      {
+         __m128i chunk = _mm_load_si128((const __m128i*)strb);
+
+         if (_mm_movemask_epi8(chunk))
+            break;
+
+         strb  += 16;
+         chars -= 16;
+      }
+
+      if (!chars)
+         return (const char*)strb;
+   }
+#endif
+
    do
    {
       strb++;
@@ -206,16 +311,51 @@ const char *utf8skip(const char *str, size_t chars)
 
 size_t utf8len(const char *string)
 {
-   size_t ret = 0;
+   size_t ret       = 0;
+   const uint8_t *s = (const uint8_t*)string;
 
    if (!string)
       return 0;
 
-   while (*string)
+#if defined(__SSE2__)
+   while (((uintptr_t)s & 15) && *s)
+   {
+      if ((*s & 0xC0) != 0x80)
+         ret++;
+      s++;
+   }
+
+   /* Count every byte that is not a continuation byte;
+    * works for ASCII and multi-byte chunks alike. */
+   while (*s)
+   {
+      unsigned cont;
+      __m128i chunk = _mm_load_si128((const __m128i*)s);
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk,
+                  _mm_setzero_si128())))
+         break;
+
+      cont = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(
+               _mm_and_si128(chunk, _mm_set1_epi8((char)0xC0)),
+               _mm_set1_epi8((char)0x80)));
+
+      /* Population count of the 16-bit continuation mask. */
+      cont = cont - ((cont >> 1) & 0x5555);
+      cont = (cont & 0x3333) + ((cont >> 2) & 0x3333);
+      cont = (cont + (cont >> 4)) & 0x0F0F;
+      cont = (cont + (cont >> 8)) & 0x1F;
+
+      ret += 16 - cont;
+      s   += 16;
+   }
+#endif
+
+   while (*s)
    {
-      if ((*string & 0xC0) != 0x80)
+      if ((*s & 0xC0) != 0x80)
          ret++;
-      string++;
+      s++;
    }
    return ret;
 }
@@ -61,6 +61,59 @@ struct sevenzip_context_t
    uint32_t packIndex;
 };
 
+/* Decoded-folder cache
+ * > Members of a solid 7z archive share one compressed
+ *   'folder' that the SDK can only decode front to back,
+ *   so reading any single member costs a decompression of
+ *   the whole block it lives in
+ * > Keep the most recently decoded folder in memory, keyed
+ *   by archive path, archive size and folder index; further
+ *   reads from the same solid block (cue/bin pairs,
+ *   multi-disc sets, reloading the same content) become a
+ *   plain copy out of the cached buffer
+ * TODO/FIXME - static global variable */
+static struct
+{
+   char *path;
+   uint8_t *output;
+   uint64_t archive_size;
+   size_t output_size;
+   uint32_t block_index;
+} sevenzip_folder_cache;
+
+static void sevenzip_folder_cache_clear(void)
+{
+   if (sevenzip_folder_cache.path)
+      free(sevenzip_folder_cache.path);
+   if (sevenzip_folder_cache.output)
+      free(sevenzip_folder_cache.output);
+   sevenzip_folder_cache.path         = NULL;
+   sevenzip_folder_cache.output       = NULL;
+   sevenzip_folder_cache.archive_size = 0;
+   sevenzip_folder_cache.output_size  = 0;
+   sevenzip_folder_cache.block_index  = 0xFFFFFFFF;
+}
+
+/* Takes ownership of output (allocated with the malloc()
+ * based allocator above) */
+static void sevenzip_folder_cache_store(const char *path,
+      uint64_t archive_size, uint8_t *output, size_t output_size,
+      uint32_t block_index)
+{
+   sevenzip_folder_cache_clear();
+
+   if (!(sevenzip_folder_cache.path = strdup(path)))
+   {
+      free(output);
+      return;
+   }
+
+   sevenzip_folder_cache.output       = output;
+   sevenzip_folder_cache.archive_size = archive_size;
+   sevenzip_folder_cache.output_size  = output_size;
+   sevenzip_folder_cache.block_index  = block_index;
+}
+
 static void *sevenzip_stream_alloc_impl(void *p, size_t size)
 {
    if (size == 0)
@@ -137,6 +190,7 @@ static int64_t sevenzip_file_read(
    CSzArEx db;
    uint8_t *output      = 0;
    int64_t outsize      = -1;
+   uint64_t archive_size = 0;
 
    /*These are the allocation routines.
     * Currently using the non-standard 7zip choices. */
@@ -168,6 +222,11 @@ static int64_t sevenzip_file_read(
       return -1;
 #endif
 
+   /* Archive size is used to validate the decoded-folder
+    * cache - an archive that was replaced on disk must not
+    * serve stale data */
+   File_GetLength(&archiveStream.file, &archive_size);
+
    FileInStream_CreateVTable(&archiveStream);
    LookToRead_CreateVTable(&lookStream, false);
    lookStream.realStream = &archiveStream.s;
@@ -201,8 +260,24 @@ static int64_t sevenzip_file_read(
       uint16_t *temp       = NULL;
       size_t temp_size     = 0;
       uint32_t block_index = 0xFFFFFFFF;
+      size_t output_size   = 0;
       SRes res             = SZ_OK;
 
+      /* Adopt the cached folder buffer when it belongs to
+       * this archive; SzArEx_Extract() skips the decode
+       * entirely if the wanted member lives in the folder
+       * the buffer already holds */
+      if (     sevenzip_folder_cache.output
+            && string_is_equal(sevenzip_folder_cache.path, path)
+            && sevenzip_folder_cache.archive_size == archive_size)
+      {
+         block_index = sevenzip_folder_cache.block_index;
+         output      = sevenzip_folder_cache.output;
+         output_size = sevenzip_folder_cache.output_size;
+         /* Owned locally until stored back */
+         sevenzip_folder_cache.output = NULL;
+      }
+
       for (i = 0; i < db.db.NumFiles; i++)
       {
          size_t len;
@@ -242,8 +317,6 @@ static int64_t sevenzip_file_read(
 
          if (string_is_equal(infile, needle))
          {
-            size_t output_size   = 0;
-
             /* C LZMA SDK does not support chunked extraction - see here:
              * sourceforge.net/p/sevenzip/discussion/45798/thread/6fb59aaf/
              * */
@@ -285,7 +358,21 @@ static int64_t sevenzip_file_read(
 
       if (temp)
          free(temp);
-      IAlloc_Free(&allocImp, output);
+
+      /* Keep the decoded folder around for the next read
+       * from this archive; a failed decode may have left the
+       * buffer in an undefined state, so drop it instead */
+      if (output)
+      {
+         if (res == SZ_OK && block_index != 0xFFFFFFFF)
+            sevenzip_folder_cache_store(path, archive_size,
+                  output, output_size, block_index);
+         else
+         {
+            IAlloc_Free(&allocImp, output);
+            sevenzip_folder_cache_clear();
+         }
+      }
 
       if (!(file_found && res == SZ_OK))
       {
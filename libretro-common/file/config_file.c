@@ -60,6 +60,104 @@ struct config_include_list
 static bool config_file_parse_line(config_file_t *conf,
       struct config_entry_list *list, char *line, config_file_cb_t *cb);
 
+/* Hash index over the entry list
+ * > Key lookups used to walk the entire linked
+ *   list; configs with thousands of entries made
+ *   repeated config_get_*() calls quadratic
+ * > The index is built in one pass on the first
+ *   lookup (i.e. after bulk parsing is done) and
+ *   kept up to date as entries are appended;
+ *   operations that restructure the list simply
+ *   drop it, forcing a rebuild on the next lookup */
+
+#define CONFIG_FILE_MIN_BUCKETS 32
+
+static uint32_t config_file_hash_key(const char *key)
+{
+   uint32_t hash = 5381;
+   while (*key)
+      hash = ((hash << 5) + hash) ^ (uint8_t)*key++;
+   return hash;
+}
+
+static void config_file_index_free(config_file_t *conf)
+{
+   if (conf->index_buckets)
+      free(conf->index_buckets);
+   conf->index_buckets = NULL;
+   conf->index_size    = 0;
+   conf->index_count   = 0;
+   conf->index_valid   = false;
+}
+
+static bool config_file_index_rebuild(config_file_t *conf)
+{
+   size_t count                    = 0;
+   size_t size                     = CONFIG_FILE_MIN_BUCKETS;
+   struct config_entry_list *entry = NULL;
+
+   config_file_index_free(conf);
+
+   for (entry = conf->entries; entry; entry = entry->next)
+      count++;
+
+   while (size < count)
+      size <<= 1;
+
+   conf->index_buckets = (struct config_entry_list**)
+      calloc(size, sizeof(*conf->index_buckets));
+
+   if (!conf->index_buckets)
+      return false;
+
+   conf->index_size  = size;
+   conf->index_count = count;
+
+   /* Entries are pushed to the head of their
+    * bucket, so walking the main list front to
+    * back leaves the earliest entry deepest in
+    * each chain */
+   for (entry = conf->entries; entry; entry = entry->next)
+   {
+      size_t bucket;
+
+      if (!entry->key)
+         continue;
+
+      bucket                      =
+         config_file_hash_key(entry->key) & (size - 1);
+      entry->hash_next            = conf->index_buckets[bucket];
+      conf->index_buckets[bucket] = entry;
+   }
+
+   conf->index_valid = true;
+   return true;
+}
+
+static void config_file_index_add(config_file_t *conf,
+      struct config_entry_list *entry)
+{
+   size_t bucket;
+
+   if (!conf->index_valid)
+      return;
+
+   /* If the load factor becomes degenerate, drop
+    * the index and let the next lookup rebuild it
+    * at a suitable size */
+   if (conf->index_count >= (conf->index_size << 1))
+   {
+      config_file_index_free(conf);
+      return;
+   }
+
+   bucket                      =
+      config_file_hash_key(entry->key) & (conf->index_size - 1);
+   entry->hash_next            = conf->index_buckets[bucket];
+   conf->index_buckets[bucket] = entry;
+   conf->index_count++;
+}
+
 static int config_file_sort_compare_func(struct config_entry_list *a,
       struct config_entry_list *b)
 {
@@ -308,6 +406,10 @@ static void config_file_add_child_list(config_file_t *parent, config_file_t *chi
 
    child->entries = NULL;
 
+   /* List has been restructured - force an index
+    * rebuild on the next lookup */
+   config_file_index_free(parent);
+
    /* Rebase tail. */
    if (parent->entries)
    {
@@ -414,6 +516,7 @@ static int config_file_load_internal(
       list->key       = NULL;
       list->value     = NULL;
       list->next      = NULL;
+      list->hash_next = NULL;
 
       line            = filestream_getline(file);
 
@@ -593,6 +696,7 @@ static int config_file_from_string_internal(
       list->key       = NULL;
       list->value     = NULL;
       list->next      = NULL;
+      list->hash_next = NULL;
 
       /* Parse current line */
       if (
@@ -656,6 +760,8 @@ bool config_file_deinitialize(config_file_t *conf)
          free(hold);
    }
 
+   config_file_index_free(conf);
+
    if (conf->path)
       free(conf->path);
    return true;
@@ -679,6 +785,26 @@ bool config_append_file(config_file_t *conf, const char *path)
       new_conf->tail->next = conf->entries;
       conf->entries        = new_conf->entries; /* Pilfer. */
       new_conf->entries    = NULL;
+      config_file_index_free(conf);
+   }
+
+   config_file_free(new_conf);
+   return true;
+}
+
+bool config_append_string(config_file_t *conf, char *from_string,
+      const char *path)
+{
+   config_file_t *new_conf = config_file_new_from_string(from_string, path);
+   if (!new_conf)
+      return false;
+
+   if (new_conf->tail)
+   {
+      new_conf->tail->next = conf->entries;
+      conf->entries        = new_conf->entries; /* Pilfer. */
+      new_conf->entries    = NULL;
+      config_file_index_free(conf);
    }
 
    config_file_free(new_conf);
@@ -775,7 +901,11 @@ void config_file_initialize(struct config_file *conf)
    conf->tail                     = NULL;
    conf->last                     = NULL;
    conf->includes                 = NULL;
+   conf->index_buckets            = NULL;
+   conf->index_size               = 0;
+   conf->index_count              = 0;
    conf->include_depth            = 0;
+   conf->index_valid              = false;
    conf->guaranteed_no_duplicates = false;
    conf->modified                 = false;
 }
@@ -814,6 +944,36 @@ struct config_entry_list *config_get_entry(
       const config_file_t *conf, const char *key)
 {
    struct config_entry_list *entry    = NULL;
+
+   /* The index is a lazily built cache - the
+    * constness of 'conf' extends only to the
+    * entry data itself */
+   if (!conf->index_valid)
+      config_file_index_rebuild((config_file_t*)conf);
+
+   if (conf->index_valid)
+   {
+      /* Bucket chains hold the newest entry
+       * first; the last match is therefore the
+       * entry closest to the head of the main
+       * list, preserving the duplicate-key
+       * semantics of the former linear walk */
+      struct config_entry_list *match = NULL;
+      size_t bucket                   =
+         config_file_hash_key(key) & (conf->index_size - 1);
+
+      for (entry = conf->index_buckets[bucket];
+           entry; entry = entry->hash_next)
+      {
+         if (string_is_equal(key, entry->key))
+            match = entry;
+      }
+
+      return match;
+   }
+
+   /* Index allocation failed - fall back to a
+    * full walk */
    for (entry = conf->entries; entry; entry = entry->next)
    {
       if (string_is_equal(key, entry->key))
@@ -1086,6 +1246,7 @@ void config_set_string(config_file_t *conf, const char *key, const char *val)
    entry->key       = strdup(key);
    entry->value     = strdup(val);
    entry->next      = NULL;
+   entry->hash_next = NULL;
    conf->modified   = true;
 
    if (last)
@@ -1094,6 +1255,8 @@ void config_set_string(config_file_t *conf, const char *key, const char *val)
       conf->entries = entry;
 
    conf->last       = entry;
+
+   config_file_index_add(conf, entry);
 }
 
 void config_unset(config_file_t *conf, const char *key)
@@ -1258,6 +1421,7 @@ void config_file_dump_orbis(config_file_t *conf, int fd)
          (struct config_entry_list*)conf->entries,
          config_file_sort_compare_func);
    conf->entries = list;
+   config_file_index_free(conf);
 
    while (list)
    {
@@ -1293,6 +1457,9 @@ void config_file_dump(config_file_t *conf, FILE *file, bool sort)
 
    conf->entries = list;
 
+   if (sort)
+      config_file_index_free(conf);
+
    while (list)
    {
       if (!list->readonly && list->key)
@@ -1303,16 +1470,7 @@ void config_file_dump(config_file_t *conf, FILE *file, bool sort)
 
 bool config_entry_exists(config_file_t *conf, const char *entry)
 {
-   struct config_entry_list *list = conf->entries;
-
-   while (list)
-   {
-      if (string_is_equal(entry, list->key))
-         return true;
-      list = list->next;
-   }
-
-   return false;
+   return config_get_entry(conf, entry) != NULL;
 }
 
 bool config_get_entry_list_head(config_file_t *conf,
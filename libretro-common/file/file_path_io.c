@@ -165,6 +165,52 @@ int32_t path_get_size(const char *path)
    return -1;
 }
 
+int64_t path_get_mtime(const char *path)
+{
+#if defined(_WIN32)
+   struct _stat buf;
+   int ret                = -1;
+#if defined(LEGACY_WIN32)
+   char *path_local       = NULL;
+#else
+   wchar_t *path_wide     = NULL;
+#endif
+
+   if (!path || !*path)
+      return -1;
+
+#if defined(LEGACY_WIN32)
+   path_local             = utf8_to_local_string_alloc(path);
+
+   if (path_local)
+   {
+      ret = _stat(path_local, &buf);
+      free(path_local);
+   }
+#else
+   path_wide              = utf8_to_utf16_string_alloc(path);
+
+   if (path_wide)
+   {
+      ret = _wstat(path_wide, &buf);
+      free(path_wide);
+   }
+#endif
+
+   if (ret != 0)
+      return -1;
+#else
+   struct stat buf;
+
+   if (!path || !*path)
+      return -1;
+   if (stat(path, &buf) != 0)
+      return -1;
+#endif
+
+   return (int64_t)buf.st_mtime;
+}
+
 /**
  * path_mkdir:
  * @dir                : directory
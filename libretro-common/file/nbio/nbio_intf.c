@@ -29,7 +29,12 @@
 
 #include <file/nbio.h>
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
 extern nbio_intf_t nbio_linux;
+extern nbio_intf_t nbio_uring;
 extern nbio_intf_t nbio_mmap_unix;
 extern nbio_intf_t nbio_mmap_win32;
 #if defined(ORBIS)
@@ -55,7 +60,11 @@ extern nbio_intf_t nbio_stdio;
 
 #endif
 
-#if defined(_linux__)
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+/* Picked on first open - io_uring when the running kernel
+ * supports it (5.1+), the blocking stdio backend otherwise */
+static nbio_intf_t *internal_nbio = NULL;
+#elif defined(_linux__)
 static nbio_intf_t *internal_nbio = &nbio_linux;
 #elif defined(HAVE_MMAP) && defined(BSD)
 static nbio_intf_t *internal_nbio = &nbio_mmap_unix;
@@ -69,6 +78,11 @@ static nbio_intf_t *internal_nbio = &nbio_stdio;
 
 void *nbio_open(const char * filename, unsigned mode)
 {
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+   if (!internal_nbio)
+      internal_nbio = nbio_uring_supported()
+         ? &nbio_uring : &nbio_stdio;
+#endif
    return internal_nbio->open(filename, mode);
 }
 
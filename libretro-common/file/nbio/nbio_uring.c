@@ -0,0 +1,411 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (nbio_uring.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <file/nbio.h>
+
+#if defined(__linux__)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+
+#include <linux/io_uring.h>
+
+/* Number of submission queue entries. Only one operation is
+ * ever in flight per handle, but the kernel rounds the queue
+ * up to a power of two anyway */
+#define NBIO_URING_ENTRIES 4
+
+/* unlike the legacy AIO backend, io_uring completes reads and
+ * writes in kernel worker context for every filesystem, so
+ * O_DIRECT is not needed to make operations truly asynchronous.
+ * We use raw syscalls and map the rings ourselves to avoid a
+ * liburing dependency */
+
+struct nbio_uring_t
+{
+   void* ptr;
+   struct io_uring_sqe *sqes;
+   void *sq_ring;
+   void *cq_ring;
+   unsigned *sq_head;
+   unsigned *sq_tail;
+   unsigned *sq_mask;
+   unsigned *sq_array;
+   unsigned *cq_head;
+   unsigned *cq_tail;
+   struct io_uring_cqe *cqes;
+   struct iovec iov;
+   size_t sq_ring_sz;
+   size_t cq_ring_sz;
+   size_t sqes_sz;
+   size_t len;
+   int fd;
+   int ring_fd;
+   bool busy;
+};
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *p)
+{
+   return syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int io_uring_enter(int ring_fd, unsigned to_submit,
+      unsigned min_complete, unsigned flags)
+{
+   return syscall(__NR_io_uring_enter, ring_fd, to_submit,
+         min_complete, flags, NULL, 0);
+}
+
+bool nbio_uring_supported(void)
+{
+   static int supported = -1;
+
+   if (supported < 0)
+   {
+      struct io_uring_params p;
+      int ring_fd;
+
+      memset(&p, 0, sizeof(p));
+      ring_fd   = io_uring_setup(NBIO_URING_ENTRIES, &p);
+
+      if (ring_fd >= 0)
+         close(ring_fd);
+
+      supported = (ring_fd >= 0);
+   }
+
+   return supported > 0;
+}
+
+static void nbio_uring_unmap(struct nbio_uring_t *handle)
+{
+   if (handle->sqes)
+      munmap(handle->sqes, handle->sqes_sz);
+   if (handle->cq_ring && handle->cq_ring != handle->sq_ring)
+      munmap(handle->cq_ring, handle->cq_ring_sz);
+   if (handle->sq_ring)
+      munmap(handle->sq_ring, handle->sq_ring_sz);
+
+   handle->sqes    = NULL;
+   handle->cq_ring = NULL;
+   handle->sq_ring = NULL;
+}
+
+static bool nbio_uring_map(struct nbio_uring_t *handle,
+      struct io_uring_params *p)
+{
+   uint8_t *sq_base;
+   uint8_t *cq_base;
+   size_t sq_sz = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+   size_t cq_sz = p->cq_off.cqes  + p->cq_entries * sizeof(struct io_uring_cqe);
+
+#ifdef IORING_FEAT_SINGLE_MMAP
+   /* 5.4+ kernels serve both rings from one mapping */
+   if (p->features & IORING_FEAT_SINGLE_MMAP)
+   {
+      if (cq_sz > sq_sz)
+         sq_sz = cq_sz;
+      cq_sz    = sq_sz;
+   }
+#endif
+
+   handle->sq_ring    = mmap(NULL, sq_sz, PROT_READ | PROT_WRITE,
+         MAP_SHARED | MAP_POPULATE, handle->ring_fd, IORING_OFF_SQ_RING);
+
+   if (handle->sq_ring == MAP_FAILED)
+   {
+      handle->sq_ring = NULL;
+      return false;
+   }
+
+   handle->sq_ring_sz = sq_sz;
+
+#ifdef IORING_FEAT_SINGLE_MMAP
+   if (p->features & IORING_FEAT_SINGLE_MMAP)
+      handle->cq_ring = handle->sq_ring;
+   else
+#endif
+   {
+      handle->cq_ring = mmap(NULL, cq_sz, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, handle->ring_fd, IORING_OFF_CQ_RING);
+
+      if (handle->cq_ring == MAP_FAILED)
+      {
+         handle->cq_ring = NULL;
+         nbio_uring_unmap(handle);
+         return false;
+      }
+   }
+
+   handle->cq_ring_sz = cq_sz;
+   handle->sqes_sz    = p->sq_entries * sizeof(struct io_uring_sqe);
+   handle->sqes       = (struct io_uring_sqe*)mmap(NULL, handle->sqes_sz,
+         PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+         handle->ring_fd, IORING_OFF_SQES);
+
+   if (handle->sqes == (struct io_uring_sqe*)MAP_FAILED)
+   {
+      handle->sqes = NULL;
+      nbio_uring_unmap(handle);
+      return false;
+   }
+
+   sq_base          = (uint8_t*)handle->sq_ring;
+   cq_base          = (uint8_t*)handle->cq_ring;
+
+   handle->sq_head  = (unsigned*)(sq_base + p->sq_off.head);
+   handle->sq_tail  = (unsigned*)(sq_base + p->sq_off.tail);
+   handle->sq_mask  = (unsigned*)(sq_base + p->sq_off.ring_mask);
+   handle->sq_array = (unsigned*)(sq_base + p->sq_off.array);
+
+   handle->cq_head  = (unsigned*)(cq_base + p->cq_off.head);
+   handle->cq_tail  = (unsigned*)(cq_base + p->cq_off.tail);
+   handle->cqes     = (struct io_uring_cqe*)(cq_base + p->cq_off.cqes);
+
+   return true;
+}
+
+static void nbio_uring_begin_op(struct nbio_uring_t* handle, uint8_t op)
+{
+   unsigned tail            = *handle->sq_tail;
+   unsigned idx             = tail & *handle->sq_mask;
+   struct io_uring_sqe *sqe = &handle->sqes[idx];
+
+   memset(sqe, 0, sizeof(*sqe));
+
+   handle->iov.iov_base     = handle->ptr;
+   handle->iov.iov_len      = handle->len;
+
+   sqe->opcode              = op;
+   sqe->fd                  = handle->fd;
+   sqe->off                 = 0;
+   sqe->addr                = (uint64_t)(uintptr_t)&handle->iov;
+   sqe->len                 = 1;
+
+   handle->sq_array[idx]    = idx;
+
+   /* Publish the new tail only after the SQE is fully written */
+   __sync_synchronize();
+   *handle->sq_tail         = tail + 1;
+   __sync_synchronize();
+
+   if (io_uring_enter(handle->ring_fd, 1, 0, 0) != 1)
+      abort();
+
+   handle->busy = true;
+}
+
+static void *nbio_uring_open(const char * filename, unsigned mode)
+{
+   static const int o_flags[]  =   { O_RDONLY, O_RDWR|O_CREAT|O_TRUNC, O_RDWR, O_RDONLY, O_RDWR|O_CREAT|O_TRUNC };
+
+   struct io_uring_params p;
+   struct nbio_uring_t* handle = NULL;
+   int ring_fd                 = -1;
+   int fd                      = open(filename, o_flags[mode]|O_CLOEXEC, 0644);
+   if (fd < 0)
+      return NULL;
+
+   memset(&p, 0, sizeof(p));
+   ring_fd = io_uring_setup(NBIO_URING_ENTRIES, &p);
+
+   if (ring_fd < 0)
+   {
+      close(fd);
+      return NULL;
+   }
+
+   handle          = (struct nbio_uring_t*)calloc(1, sizeof(struct nbio_uring_t));
+   handle->fd      = fd;
+   handle->ring_fd = ring_fd;
+   handle->len     = lseek(fd, 0, SEEK_END);
+   handle->ptr     = malloc(handle->len);
+   handle->busy    = false;
+
+   if (!nbio_uring_map(handle, &p))
+   {
+      close(ring_fd);
+      close(fd);
+      free(handle->ptr);
+      free(handle);
+      return NULL;
+   }
+
+   return handle;
+}
+
+static void nbio_uring_begin_read(void *data)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (handle)
+      nbio_uring_begin_op(handle, IORING_OP_READV);
+}
+
+static void nbio_uring_begin_write(void *data)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (handle)
+      nbio_uring_begin_op(handle, IORING_OP_WRITEV);
+}
+
+static bool nbio_uring_iterate(void *data)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (!handle)
+      return false;
+
+   if (handle->busy)
+   {
+      unsigned head = *handle->cq_head;
+
+      __sync_synchronize();
+
+      if (head != *handle->cq_tail)
+      {
+         *handle->cq_head = head + 1;
+         __sync_synchronize();
+         handle->busy     = false;
+      }
+   }
+
+   return !handle->busy;
+}
+
+static void nbio_uring_resize(void *data, size_t len)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (!handle)
+      return;
+
+   /* This works perfectly fine if this check is removed, but it
+    * won't work on other nbio implementations */
+   /* therefore, it's blocked so nobody accidentally relies on it */
+   if (len < handle->len)
+      abort();
+
+   if (ftruncate(handle->fd, len) != 0)
+      abort(); /* this one returns void and I can't find any other way
+                  for it to report failure */
+
+   handle->ptr = realloc(handle->ptr, len);
+   handle->len = len;
+}
+
+static void *nbio_uring_get_ptr(void *data, size_t* len)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (!handle)
+      return NULL;
+   if (len)
+      *len = handle->len;
+   if (!handle->busy)
+      return handle->ptr;
+   return NULL;
+}
+
+static void nbio_uring_cancel(void *data)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (!handle)
+      return;
+
+   if (handle->busy)
+   {
+      /* IORING_OP_ASYNC_CANCEL needs a 5.5+ kernel - just wait
+       * the single in-flight operation out and consume its
+       * completion so the buffer can be freed safely */
+      if (io_uring_enter(handle->ring_fd, 0, 1,
+               IORING_ENTER_GETEVENTS) == 0)
+      {
+         unsigned head = *handle->cq_head;
+
+         __sync_synchronize();
+
+         if (head != *handle->cq_tail)
+         {
+            *handle->cq_head = head + 1;
+            __sync_synchronize();
+         }
+      }
+
+      handle->busy = false;
+   }
+}
+
+static void nbio_uring_free(void *data)
+{
+   struct nbio_uring_t* handle = (struct nbio_uring_t*)data;
+   if (!handle)
+      return;
+
+   nbio_uring_unmap(handle);
+   close(handle->ring_fd);
+   close(handle->fd);
+   free(handle->ptr);
+   free(handle);
+}
+
+nbio_intf_t nbio_uring = {
+   nbio_uring_open,
+   nbio_uring_begin_read,
+   nbio_uring_begin_write,
+   nbio_uring_iterate,
+   nbio_uring_resize,
+   nbio_uring_get_ptr,
+   nbio_uring_cancel,
+   nbio_uring_free,
+   "nbio_uring",
+};
+#else
+
+bool nbio_uring_supported(void)
+{
+   return false;
+}
+
+nbio_intf_t nbio_uring = {
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   NULL,
+   "nbio_uring",
+};
+
+#endif
@@ -125,6 +125,11 @@ struct rjpeg
 #endif
 
 /* ARM NEON */
+#if defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS) && \
+    !defined(RJPEG_NEON)
+#define RJPEG_NEON
+#endif
+
 #if defined(RJPEG_NO_SIMD) && defined(RJPEG_NEON)
 #undef RJPEG_NEON
 #endif
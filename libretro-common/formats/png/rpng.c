@@ -31,6 +31,15 @@
 #include <malloc.h>
 #endif
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RPNG_SIMD
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#define RPNG_NEON
+#define RPNG_SIMD
+#endif
+
 #include <boolean.h>
 #include <formats/image.h>
 #include <formats/rpng.h>
@@ -556,6 +565,161 @@ error:
    return -1;
 }
 
+/* Reverse filtering is the hottest part of PNG decode -
+ * the filters run over every byte of every scanline.
+ * The 'up' filter vectorises trivially (independent byte
+ * adds); 'sub' and 'paeth' carry a dependency on the
+ * previous pixel, but with 4 bytes per pixel (RGBA8, by
+ * far the common case for thumbnails/screenshots) a whole
+ * pixel can still be processed per step */
+
+/* Unfilters a whole scanline with the 'up' predictor */
+static void png_reverse_filter_up(uint8_t *decoded,
+      const uint8_t *prev, const uint8_t *inflate, unsigned pitch)
+{
+   unsigned i = 0;
+
+#if defined(__SSE2__)
+   for (; i + 16 <= pitch; i += 16)
+      _mm_storeu_si128((__m128i*)(decoded + i),
+            _mm_add_epi8(
+                  _mm_loadu_si128((const __m128i*)(prev + i)),
+                  _mm_loadu_si128((const __m128i*)(inflate + i))));
+#elif defined(RPNG_NEON)
+   for (; i + 16 <= pitch; i += 16)
+      vst1q_u8(decoded + i,
+            vaddq_u8(vld1q_u8(prev + i), vld1q_u8(inflate + i)));
+#endif
+
+   for (; i < pitch; i++)
+      decoded[i] = prev[i] + inflate[i];
+}
+
+#ifdef RPNG_SIMD
+/* Unfilters a 4 bpp scanline with the 'sub' predictor
+ * > Requires pitch to be a multiple of 4 */
+static void png_reverse_filter_sub4(uint8_t *decoded,
+      const uint8_t *inflate, unsigned pitch)
+{
+   unsigned i;
+#if defined(__SSE2__)
+   __m128i d = _mm_setzero_si128();
+
+   for (i = 0; i + 4 <= pitch; i += 4)
+   {
+      uint32_t x;
+      memcpy(&x, inflate + i, sizeof(x));
+      d = _mm_add_epi8(d, _mm_cvtsi32_si128((int)x));
+      x = (uint32_t)_mm_cvtsi128_si32(d);
+      memcpy(decoded + i, &x, sizeof(x));
+   }
+#else
+   uint8x8_t d = vdup_n_u8(0);
+
+   for (i = 0; i + 4 <= pitch; i += 4)
+   {
+      uint64_t x = 0;
+      memcpy(&x, inflate + i, sizeof(uint32_t));
+      d = vadd_u8(d, vcreate_u8(x));
+      x = vget_lane_u64(vreinterpret_u64_u8(d), 0);
+      memcpy(decoded + i, &x, sizeof(uint32_t));
+   }
+#endif
+}
+
+/* Unfilters a 4 bpp scanline with the 'paeth' predictor
+ * > Requires pitch to be a multiple of 4
+ * > Predictor selection runs in 16-bit lanes; byte
+ *   wraparound is emulated by masking before repacking */
+static void png_reverse_filter_paeth4(uint8_t *decoded,
+      const uint8_t *prev, const uint8_t *inflate, unsigned pitch)
+{
+   unsigned i;
+#if defined(__SSE2__)
+   __m128i zero = _mm_setzero_si128();
+   __m128i a    = zero; /* Pixel to the left */
+   __m128i c    = zero; /* Pixel above-left */
+
+   for (i = 0; i + 4 <= pitch; i += 4)
+   {
+      uint32_t x32;
+      __m128i b, x, pa, pb, pc, smallest, mask_a, mask_b, d;
+
+      memcpy(&x32, prev + i, sizeof(x32));
+      b  = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)x32), zero);
+      memcpy(&x32, inflate + i, sizeof(x32));
+      x  = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)x32), zero);
+
+      pa = _mm_sub_epi16(b, c);
+      pb = _mm_sub_epi16(a, c);
+      pc = _mm_add_epi16(pa, pb);
+      pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+      pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+      pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+
+      /* Match the tie-breaking order of paeth():
+       * 'a' wins over 'b' wins over 'c' */
+      smallest = _mm_min_epi16(_mm_min_epi16(pa, pb), pc);
+      mask_a   = _mm_cmpeq_epi16(smallest, pa);
+      mask_b   = _mm_cmpeq_epi16(smallest, pb);
+
+      d = _mm_or_si128(
+            _mm_and_si128(mask_a, a),
+            _mm_andnot_si128(mask_a,
+                  _mm_or_si128(_mm_and_si128(mask_b, b),
+                        _mm_andnot_si128(mask_b, c))));
+
+      d = _mm_and_si128(_mm_add_epi16(x, d), _mm_set1_epi16(0xff));
+
+      x32 = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(d, d));
+      memcpy(decoded + i, &x32, sizeof(x32));
+
+      c = b;
+      a = d;
+   }
+#else
+   int16x8_t a = vdupq_n_s16(0); /* Pixel to the left */
+   int16x8_t c = vdupq_n_s16(0); /* Pixel above-left */
+
+   for (i = 0; i + 4 <= pitch; i += 4)
+   {
+      uint64_t x64 = 0;
+      uint32_t x32;
+      int16x8_t b, x, pa, pb, pc, smallest, d;
+      uint16x8_t mask_a, mask_b;
+
+      memcpy(&x64, prev + i, sizeof(uint32_t));
+      b  = vreinterpretq_s16_u16(vmovl_u8(vcreate_u8(x64)));
+      memcpy(&x64, inflate + i, sizeof(uint32_t));
+      x  = vreinterpretq_s16_u16(vmovl_u8(vcreate_u8(x64)));
+
+      pa = vsubq_s16(b, c);
+      pb = vsubq_s16(a, c);
+      pc = vaddq_s16(pa, pb);
+      pa = vabsq_s16(pa);
+      pb = vabsq_s16(pb);
+      pc = vabsq_s16(pc);
+
+      /* Match the tie-breaking order of paeth():
+       * 'a' wins over 'b' wins over 'c' */
+      smallest = vminq_s16(vminq_s16(pa, pb), pc);
+      mask_a   = vceqq_s16(smallest, pa);
+      mask_b   = vceqq_s16(smallest, pb);
+
+      d = vbslq_s16(mask_a, a, vbslq_s16(mask_b, b, c));
+      d = vandq_s16(vaddq_s16(x, d), vdupq_n_s16(0xff));
+
+      x32 = vget_lane_u32(vreinterpret_u32_u8(
+            vmovn_u16(vreinterpretq_u16_s16(d))), 0);
+      memcpy(decoded + i, &x32, sizeof(x32));
+
+      c = b;
+      a = d;
+   }
+#endif
+}
+#endif
+
 static int png_reverse_filter_copy_line(uint32_t *data, const struct png_ihdr *ihdr,
       struct rpng_process *pngp, unsigned filter)
 {
@@ -567,14 +731,22 @@ static int png_reverse_filter_copy_line(uint32_t *data, const struct png_ihdr *i
          memcpy(pngp->decoded_scanline, pngp->inflate_buf, pngp->pitch);
          break;
       case PNG_FILTER_SUB:
+#ifdef RPNG_SIMD
+         if ((pngp->bpp == 4) && !(pngp->pitch & 3))
+         {
+            png_reverse_filter_sub4(pngp->decoded_scanline,
+                  pngp->inflate_buf, pngp->pitch);
+            break;
+         }
+#endif
          for (i = 0; i < pngp->bpp; i++)
             pngp->decoded_scanline[i] = pngp->inflate_buf[i];
          for (i = pngp->bpp; i < pngp->pitch; i++)
             pngp->decoded_scanline[i] = pngp->decoded_scanline[i - pngp->bpp] + pngp->inflate_buf[i];
          break;
       case PNG_FILTER_UP:
-         for (i = 0; i < pngp->pitch; i++)
-            pngp->decoded_scanline[i] = pngp->prev_scanline[i] + pngp->inflate_buf[i];
+         png_reverse_filter_up(pngp->decoded_scanline,
+               pngp->prev_scanline, pngp->inflate_buf, pngp->pitch);
          break;
       case PNG_FILTER_AVERAGE:
          for (i = 0; i < pngp->bpp; i++)
@@ -589,6 +761,14 @@ static int png_reverse_filter_copy_line(uint32_t *data, const struct png_ihdr *i
          }
          break;
       case PNG_FILTER_PAETH:
+#ifdef RPNG_SIMD
+         if ((pngp->bpp == 4) && !(pngp->pitch & 3))
+         {
+            png_reverse_filter_paeth4(pngp->decoded_scanline,
+                  pngp->prev_scanline, pngp->inflate_buf, pngp->pitch);
+            break;
+         }
+#endif
          for (i = 0; i < pngp->bpp; i++)
             pngp->decoded_scanline[i] = paeth(0, pngp->prev_scanline[i], 0) + pngp->inflate_buf[i];
          for (i = pngp->bpp; i < pngp->pitch; i++)
@@ -29,6 +29,12 @@
 #include <streams/interface_stream.h>
 #include <streams/trans_stream.h>
 
+#if defined(HAVE_THREADS) && HAVE_ZLIB
+#include <zlib.h>
+#include <rthreads/rthreads.h>
+#include <features/features_cpu.h>
+#endif
+
 #include "rpng_internal.h"
 
 #undef GOTO_END_ERROR
@@ -203,12 +209,156 @@ static unsigned filter_paeth(uint8_t *target,
    return count_sad(target, width);
 }
 
+#if defined(HAVE_THREADS) && HAVE_ZLIB
+/* Below this many rows the fork/join overhead
+ * is not worth splitting the deflate. */
+#define PNG_STRIP_MIN_ROWS 256
+#define PNG_MAX_STRIPS 4
+
+struct png_deflate_strip
+{
+   const uint8_t *in;
+   uint8_t *out;     /* 8 bytes of IDAT chunk header headroom, then data. */
+   size_t in_size;
+   size_t out_cap;
+   uint32_t out_size;
+   bool is_last;
+   bool ok;
+};
+
+static void png_deflate_strip_thread(void *data)
+{
+   z_stream strm;
+   struct png_deflate_strip *strip = (struct png_deflate_strip*)data;
+   int ret;
+
+   memset(&strm, 0, sizeof(strm));
+
+   /* Raw deflate - the caller emits the zlib header up front and the
+    * combined adler32 of all strips at the end. Ending every strip but
+    * the last with a full flush aligns it to a byte boundary and resets
+    * the window, so the concatenation is one valid deflate stream. */
+   if (deflateInit2(&strm, 9, Z_DEFLATED, -15, 8,
+            Z_DEFAULT_STRATEGY) != Z_OK)
+      return;
+
+   strm.next_in   = (Bytef*)strip->in;
+   strm.avail_in  = (uInt)strip->in_size;
+   strm.next_out  = strip->out + 8;
+   strm.avail_out = (uInt)strip->out_cap;
+
+   ret = deflate(&strm, strip->is_last ? Z_FINISH : Z_FULL_FLUSH);
+
+   if (strm.avail_in == 0 &&
+         (strip->is_last ? (ret == Z_STREAM_END) : (ret == Z_OK)))
+   {
+      strip->out_size = (uint32_t)strm.total_out;
+      strip->ok       = true;
+   }
+
+   deflateEnd(&strm);
+}
+
+/* Deflates the filtered image as PNG_MAX_STRIPS row slices on worker
+ * threads and streams each slice out as its own IDAT chunk as it
+ * completes, so the write overlaps the compression of later slices.
+ * Returns -1 if the attempt could not be started (nothing written yet,
+ * caller may fall back), 0 on a fatal error and 1 on success. */
+static int png_write_idat_strips(intfstream_t *intf_s,
+      const uint8_t *encode_buf, size_t line_size, unsigned height)
+{
+   unsigned i;
+   struct png_deflate_strip strips[PNG_MAX_STRIPS];
+   sthread_t *threads[PNG_MAX_STRIPS];
+   uint8_t tail[12];
+   static const uint8_t zlib_header[] = {
+      0, 0, 0, 2, 'I', 'D', 'A', 'T', 0x78, 0xda
+   };
+   uint32_t adler        = 0;
+   unsigned num_strips   = cpu_features_get_core_amount();
+   unsigned row          = 0;
+   int ret               = 1;
+
+   if (num_strips < 2)
+      return -1;
+   if (num_strips > PNG_MAX_STRIPS)
+      num_strips = PNG_MAX_STRIPS;
+
+   memset(strips, 0, sizeof(strips));
+
+   for (i = 0; i < num_strips; i++)
+   {
+      unsigned rows      = height / num_strips +
+         (i < height % num_strips ? 1 : 0);
+
+      strips[i].in       = encode_buf + (size_t)row * line_size;
+      strips[i].in_size  = (size_t)rows * line_size;
+      strips[i].out_cap  = strips[i].in_size * 2 + 64; /* Just to be sure. */
+      strips[i].out      = (uint8_t*)malloc(strips[i].out_cap + 8);
+      strips[i].is_last  = (i == num_strips - 1);
+      row               += rows;
+
+      if (!strips[i].out)
+      {
+         while (i--)
+            free(strips[i].out);
+         return -1;
+      }
+   }
+
+   if (!png_write_idat_string(intf_s, zlib_header, sizeof(zlib_header)))
+      ret = 0;
+
+   for (i = 0; i < num_strips; i++)
+      if (!(threads[i] = sthread_create(png_deflate_strip_thread,
+                  &strips[i])))
+         png_deflate_strip_thread(&strips[i]);
+
+   for (i = 0; i < num_strips; i++)
+   {
+      if (threads[i])
+         sthread_join(threads[i]);
+
+      if (ret != 1 || !strips[i].ok)
+      {
+         ret = 0;
+         continue;
+      }
+
+      dword_write_be(strips[i].out, strips[i].out_size);
+      memcpy(strips[i].out + 4, "IDAT", 4);
+
+      if (!png_write_idat_string(intf_s, strips[i].out,
+               (size_t)strips[i].out_size + 8))
+         ret = 0;
+   }
+
+   for (i = 0; i < num_strips; i++)
+      free(strips[i].out);
+
+   if (ret != 1)
+      return 0;
+
+   /* The checksum of the whole filtered image closes the zlib stream. */
+   adler = adler32(adler32(0, NULL, 0),
+         encode_buf, (size_t)line_size * height);
+   dword_write_be(tail, 4);
+   memcpy(tail + 4, "IDAT", 4);
+   dword_write_be(tail + 8, adler);
+   if (!png_write_idat_string(intf_s, tail, sizeof(tail)))
+      return 0;
+
+   return 1;
+}
+#endif
+
 bool rpng_save_image_stream(const uint8_t *data, intfstream_t* intf_s,
       unsigned width, unsigned height, signed pitch, unsigned bpp)
 {
    unsigned h;
    struct png_ihdr ihdr = {0};
    bool ret = true;
+   bool idat_written = false;
    const struct trans_stream_backend *stream_backend = NULL;
    size_t encode_buf_size  = 0;
    uint8_t *encode_buf     = NULL;
@@ -316,31 +466,54 @@ bool rpng_save_image_stream(const uint8_t *data, intfstream_t* intf_s,
       }
    }
 
-   deflate_buf = (uint8_t*)malloc(encode_buf_size * 2); /* Just to be sure. */
-   if (!deflate_buf)
-      GOTO_END_ERROR();
-
-   stream = stream_backend->stream_new();
-
-   if (!stream)
-      GOTO_END_ERROR();
-
-   stream_backend->set_in(
-         stream,
-         encode_buf,
-         (unsigned)encode_buf_size);
-   stream_backend->set_out(
-         stream,
-         deflate_buf + 8,
-         (unsigned)(encode_buf_size * 2));
-
-   if (!stream_backend->trans(stream, true, &total_in, &total_out, NULL))
-      GOTO_END_ERROR();
+#if defined(HAVE_THREADS) && HAVE_ZLIB
+   /* Large images: deflate row slices on worker threads and overlap
+    * the file write with compression. Small ones are not worth the
+    * thread fork/join and keep the single-stream path below. */
+   if (height >= PNG_STRIP_MIN_ROWS)
+   {
+      switch (png_write_idat_strips(intf_s, encode_buf,
+               (size_t)width * bpp + 1, height))
+      {
+         case 1:
+            idat_written = true;
+            break;
+         case 0:
+            GOTO_END_ERROR();
+         default: /* Could not start - fall back below. */
+            break;
+      }
+   }
+#endif
 
-   memcpy(deflate_buf + 4, "IDAT", 4);
-   dword_write_be(deflate_buf + 0,        ((uint32_t)total_out));
-   if (!png_write_idat_string(intf_s, deflate_buf, ((size_t)total_out + 8)))
-      GOTO_END_ERROR();
+   if (!idat_written)
+   {
+      deflate_buf = (uint8_t*)malloc(encode_buf_size * 2); /* Just to be sure. */
+      if (!deflate_buf)
+         GOTO_END_ERROR();
+
+      stream = stream_backend->stream_new();
+
+      if (!stream)
+         GOTO_END_ERROR();
+
+      stream_backend->set_in(
+            stream,
+            encode_buf,
+            (unsigned)encode_buf_size);
+      stream_backend->set_out(
+            stream,
+            deflate_buf + 8,
+            (unsigned)(encode_buf_size * 2));
+
+      if (!stream_backend->trans(stream, true, &total_in, &total_out, NULL))
+         GOTO_END_ERROR();
+
+      memcpy(deflate_buf + 4, "IDAT", 4);
+      dword_write_be(deflate_buf + 0,        ((uint32_t)total_out));
+      if (!png_write_idat_string(intf_s, deflate_buf, ((size_t)total_out + 8)))
+         GOTO_END_ERROR();
+   }
 
    if (!png_write_iend_string(intf_s))
       GOTO_END_ERROR();
@@ -30,6 +30,134 @@
 #include <gfx/scaler/filter.h>
 #include <gfx/scaler/pixconv.h>
 
+#ifdef HAVE_THREADS
+#include <features/features_cpu.h>
+#include <rthreads/tpool.h>
+
+/* Strip-parallel scaling.
+ *
+ * Every pass of the scaler (pixel conversion, horizontal filter,
+ * vertical filter, point special case) works on rows independently,
+ * so a frame can be cut into horizontal strips and handed to a
+ * small worker pool, with a barrier between passes. Only contexts
+ * whose frames are large enough to amortize the synchronization get
+ * a pool; everything else keeps the plain single-threaded path. */
+
+#define SCALER_POOL_MIN_PIXELS (1280 * 720)
+#define SCALER_POOL_MAX_STRIPS 4
+
+struct scaler_strip
+{
+   const struct scaler_ctx *ctx;
+   void *output;
+   const void *input;
+   void (*pixconv)(void*, const void*, int, int, int, int);
+   int out_stride;
+   int in_stride;
+   int width;
+   int h_start;
+   int h_end;
+};
+
+static void scaler_strip_horiz(void *data)
+{
+   struct scaler_strip *strip = (struct scaler_strip*)data;
+   strip->ctx->scaler_horiz_range(strip->ctx, strip->input,
+         strip->in_stride, strip->h_start, strip->h_end);
+}
+
+static void scaler_strip_vert(void *data)
+{
+   struct scaler_strip *strip = (struct scaler_strip*)data;
+   strip->ctx->scaler_vert_range(strip->ctx, strip->output,
+         strip->out_stride, strip->h_start, strip->h_end);
+}
+
+static void scaler_strip_special(void *data)
+{
+   struct scaler_strip *strip = (struct scaler_strip*)data;
+   strip->ctx->scaler_special_range(strip->ctx,
+         strip->output, strip->input,
+         strip->ctx->out_width, strip->ctx->out_height,
+         strip->ctx->in_width, strip->ctx->in_height,
+         strip->out_stride, strip->in_stride,
+         strip->h_start, strip->h_end);
+}
+
+static void scaler_strip_pixconv(void *data)
+{
+   struct scaler_strip *strip = (struct scaler_strip*)data;
+   strip->pixconv(
+         (uint8_t*)strip->output
+            + (size_t)strip->h_start * strip->out_stride,
+         (const uint8_t*)strip->input
+            + (size_t)strip->h_start * strip->in_stride,
+         strip->width, strip->h_end - strip->h_start,
+         strip->out_stride, strip->in_stride);
+}
+
+static void scaler_strips_init(const struct scaler_ctx *ctx,
+      struct scaler_strip *strips,
+      void *output, const void *input,
+      int out_stride, int in_stride,
+      void (*pixconv)(void*, const void*, int, int, int, int),
+      int width)
+{
+   int i;
+
+   for (i = 0; i < ctx->pool_strips; i++)
+   {
+      strips[i].ctx        = ctx;
+      strips[i].output     = output;
+      strips[i].input      = input;
+      strips[i].pixconv    = pixconv;
+      strips[i].out_stride = out_stride;
+      strips[i].in_stride  = in_stride;
+      strips[i].width      = width;
+   }
+}
+
+static void scaler_strips_dispatch(const struct scaler_ctx *ctx,
+      struct scaler_strip *strips, int height, void (*func)(void*))
+{
+   int i;
+   int h    = 0;
+   int rows = (height + ctx->pool_strips - 1) / ctx->pool_strips;
+
+   for (i = 0; i < ctx->pool_strips && h < height; i++, h += rows)
+   {
+      strips[i].h_start = h;
+      strips[i].h_end   = (h + rows < height) ? (h + rows) : height;
+
+      /* Queue full? Process the strip inline instead. */
+      if (!tpool_add_work(ctx->pool, func, &strips[i]))
+         func(&strips[i]);
+   }
+
+   tpool_wait(ctx->pool);
+}
+
+static void scaler_ctx_init_pool(struct scaler_ctx *ctx)
+{
+   unsigned cores;
+
+   if (     ctx->in_width  * ctx->in_height  < SCALER_POOL_MIN_PIXELS
+         && ctx->out_width * ctx->out_height < SCALER_POOL_MIN_PIXELS)
+      return;
+
+   cores = cpu_features_get_core_amount();
+   if (cores < 2)
+      return;
+   if (cores > SCALER_POOL_MAX_STRIPS)
+      cores = SCALER_POOL_MAX_STRIPS;
+
+   if (!(ctx->pool = tpool_create(cores)))
+      return;
+
+   ctx->pool_strips = (int)cores;
+}
+#endif
+
 static bool allocate_frames(struct scaler_ctx *ctx)
 {
    uint64_t *scaled_frame = NULL;
@@ -78,8 +206,9 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
 {
    scaler_ctx_gen_reset(ctx);
 
-   ctx->scaler_special = NULL;
-   ctx->unscaled       = false;
+   ctx->scaler_special       = NULL;
+   ctx->scaler_special_range = NULL;
+   ctx->unscaled             = false;
 
    if (!allocate_frames(ctx))
       return false;
@@ -204,8 +333,10 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
    }
    else
    {
-      ctx->scaler_horiz = scaler_argb8888_horiz;
-      ctx->scaler_vert  = scaler_argb8888_vert;
+      ctx->scaler_horiz       = scaler_argb8888_horiz;
+      ctx->scaler_vert        = scaler_argb8888_vert;
+      ctx->scaler_horiz_range = scaler_argb8888_horiz_range;
+      ctx->scaler_vert_range  = scaler_argb8888_vert_range;
 
       switch (ctx->in_fmt)
       {
@@ -263,11 +394,22 @@ bool scaler_ctx_gen_filter(struct scaler_ctx *ctx)
          return false;
    }
 
+#ifdef HAVE_THREADS
+   scaler_ctx_init_pool(ctx);
+#endif
+
    return true;
 }
 
 void scaler_ctx_gen_reset(struct scaler_ctx *ctx)
 {
+#ifdef HAVE_THREADS
+   if (ctx->pool)
+      tpool_destroy(ctx->pool);
+   ctx->pool        = NULL;
+   ctx->pool_strips = 0;
+#endif
+
    if (ctx->horiz.filter)
       free(ctx->horiz.filter);
    if (ctx->horiz.filter_pos)
@@ -320,9 +462,23 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
    void *output_frame      = output;
    int input_stride        = ctx->in_stride;
    int output_stride       = ctx->out_stride;
+#ifdef HAVE_THREADS
+   struct scaler_strip strips[SCALER_POOL_MAX_STRIPS];
+#endif
 
    if (ctx->in_fmt != SCALER_FMT_ARGB8888)
    {
+#ifdef HAVE_THREADS
+      if (ctx->pool)
+      {
+         scaler_strips_init(ctx, strips, ctx->input.frame, input,
+               ctx->input.stride, ctx->in_stride,
+               ctx->in_pixconv, ctx->in_width);
+         scaler_strips_dispatch(ctx, strips, ctx->in_height,
+               scaler_strip_pixconv);
+      }
+      else
+#endif
       ctx->in_pixconv(ctx->input.frame, input,
             ctx->in_width, ctx->in_height,
             ctx->input.stride, ctx->in_stride);
@@ -339,21 +495,60 @@ void scaler_ctx_scale(struct scaler_ctx *ctx,
 
    /* Take some special, and (hopefully) more optimized path. */
    if (ctx->scaler_special)
+   {
+#ifdef HAVE_THREADS
+      if (ctx->pool && ctx->scaler_special_range)
+      {
+         scaler_strips_init(ctx, strips, output_frame, input_frame,
+               output_stride, input_stride, NULL, 0);
+         scaler_strips_dispatch(ctx, strips, ctx->out_height,
+               scaler_strip_special);
+      }
+      else
+#endif
       ctx->scaler_special(ctx, output_frame, input_frame,
             ctx->out_width, ctx->out_height,
             ctx->in_width, ctx->in_height,
             output_stride, input_stride);
+   }
    else
    {
       /* Take generic filter path. */
-      if (ctx->scaler_horiz)
-         ctx->scaler_horiz(ctx, input_frame, input_stride);
-      if (ctx->scaler_vert)
-         ctx->scaler_vert (ctx, output, output_stride);
+#ifdef HAVE_THREADS
+      if (ctx->pool && ctx->scaler_horiz_range && ctx->scaler_vert_range)
+      {
+         scaler_strips_init(ctx, strips, output, input_frame,
+               output_stride, input_stride, NULL, 0);
+         scaler_strips_dispatch(ctx, strips, ctx->scaled.height,
+               scaler_strip_horiz);
+         scaler_strips_dispatch(ctx, strips, ctx->out_height,
+               scaler_strip_vert);
+      }
+      else
+#endif
+      {
+         if (ctx->scaler_horiz)
+            ctx->scaler_horiz(ctx, input_frame, input_stride);
+         if (ctx->scaler_vert)
+            ctx->scaler_vert (ctx, output, output_stride);
+      }
    }
 
    if (ctx->out_fmt != SCALER_FMT_ARGB8888)
+   {
+#ifdef HAVE_THREADS
+      if (ctx->pool)
+      {
+         scaler_strips_init(ctx, strips, output, ctx->output.frame,
+               ctx->out_stride, ctx->output.stride,
+               ctx->out_pixconv, ctx->out_width);
+         scaler_strips_dispatch(ctx, strips, ctx->out_height,
+               scaler_strip_pixconv);
+      }
+      else
+#endif
       ctx->out_pixconv(output, ctx->output.frame,
             ctx->out_width, ctx->out_height,
             ctx->out_stride, ctx->output.stride);
+   }
 }
@@ -210,7 +210,8 @@ bool scaler_gen_filter(struct scaler_ctx *ctx)
          gen_filter_point_sub(&ctx->horiz, ctx->out_width,  x_pos, x_step);
          gen_filter_point_sub(&ctx->vert,  ctx->out_height, y_pos, y_step);
 
-         ctx->scaler_special = scaler_argb8888_point_special;
+         ctx->scaler_special       = scaler_argb8888_point_special;
+         ctx->scaler_special_range = scaler_argb8888_point_special_range;
          break;
 
       case SCALER_TYPE_BILINEAR:
@@ -60,17 +60,25 @@
  *
  * The C version of scalers perform the exact same operations as the
  * SIMD code for testing purposes.
+ *
+ * Every kernel comes in a _range variant that only touches output rows
+ * [h_start, h_end). Rows are independent within a pass, so scaler_ctx
+ * can hand disjoint strips to worker threads. The plain entry points
+ * are full-range wrappers.
  */
 
-void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+void scaler_argb8888_vert_range(const struct scaler_ctx *ctx,
+      void *output_, int stride, int h_start, int h_end)
 {
    int h, w, y;
    const uint64_t      *input = ctx->scaled.frame;
-   uint32_t           *output = (uint32_t*)output_;
+   uint32_t           *output = (uint32_t*)output_
+      + h_start * (stride >> 2);
 
-   const int16_t *filter_vert = ctx->vert.filter;
+   const int16_t *filter_vert = ctx->vert.filter
+      + h_start * ctx->vert.filter_stride;
 
-   for (h = 0; h < ctx->out_height; h++,
+   for (h = h_start; h < h_end; h++,
          filter_vert += ctx->vert.filter_stride, output += stride >> 2)
    {
       const uint64_t *input_base = input + ctx->vert.filter_pos[h]
@@ -145,13 +153,21 @@ void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int strid
    }
 }
 
-void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+void scaler_argb8888_vert(const struct scaler_ctx *ctx, void *output_, int stride)
+{
+   scaler_argb8888_vert_range(ctx, output_, stride, 0, ctx->out_height);
+}
+
+void scaler_argb8888_horiz_range(const struct scaler_ctx *ctx,
+      const void *input_, int stride, int h_start, int h_end)
 {
    int h, w, x;
-   const uint32_t *input = (uint32_t*)input_;
-   uint64_t *output      = ctx->scaled.frame;
+   const uint32_t *input = (uint32_t*)input_
+      + h_start * (stride >> 2);
+   uint64_t *output      = ctx->scaled.frame
+      + h_start * (ctx->scaled.stride >> 3);
 
-   for (h = 0; h < ctx->scaled.height; h++, input += stride >> 2,
+   for (h = h_start; h < h_end; h++, input += stride >> 2,
          output += ctx->scaled.stride >> 3)
    {
       const int16_t *filter_horiz = ctx->horiz.filter;
@@ -231,11 +247,17 @@ void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int
    }
 }
 
-void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
+void scaler_argb8888_horiz(const struct scaler_ctx *ctx, const void *input_, int stride)
+{
+   scaler_argb8888_horiz_range(ctx, input_, stride, 0, ctx->scaled.height);
+}
+
+void scaler_argb8888_point_special_range(const struct scaler_ctx *ctx,
       void *output_, const void *input_,
       int out_width, int out_height,
       int in_width, int in_height,
-      int out_stride, int in_stride)
+      int out_stride, int in_stride,
+      int h_start, int h_end)
 {
    int h, w;
    int x_pos             = (1 << 15) * in_width / out_width - (1 << 15);
@@ -243,14 +265,17 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
    int y_pos             = (1 << 15) * in_height / out_height - (1 << 15);
    int y_step            = (1 << 16) * in_height / out_height;
    const uint32_t *input = (const uint32_t*)input_;
-   uint32_t *output      = (uint32_t*)output_;
+   uint32_t *output      = (uint32_t*)output_
+      + h_start * (out_stride >> 2);
 
    if (x_pos < 0)
       x_pos = 0;
    if (y_pos < 0)
       y_pos = 0;
 
-   for (h = 0; h < out_height; h++, y_pos += y_step, output += out_stride >> 2)
+   y_pos += h_start * y_step;
+
+   for (h = h_start; h < h_end; h++, y_pos += y_step, output += out_stride >> 2)
    {
       int               x = x_pos;
       const uint32_t *inp = input + (y_pos >> 16) * (in_stride >> 2);
@@ -259,3 +284,16 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
          output[w] = inp[x >> 16];
    }
 }
+
+void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
+      void *output_, const void *input_,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride)
+{
+   scaler_argb8888_point_special_range(ctx, output_, input_,
+         out_width, out_height,
+         in_width, in_height,
+         out_stride, in_stride,
+         0, out_height);
+}
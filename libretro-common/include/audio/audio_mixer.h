@@ -77,6 +77,17 @@ float audio_mixer_voice_get_volume(audio_mixer_voice_t *voice);
 
 void audio_mixer_voice_set_volume(audio_mixer_voice_t *voice, float val);
 
+/* Pans the voice across the stereo field: -1.0 is hard left, 0.0 is
+ * centered (the default), 1.0 is hard right. Uses a constant-power
+ * curve so sounds keep their perceived loudness as they move. */
+void audio_mixer_voice_set_pan(audio_mixer_voice_t *voice, float pan);
+
+/* Ramps the voice volume towards target over duration_ms. Starting a
+ * new track and fading the old voice out gives a crossfade - each voice
+ * keeps its own decoded stream, so nothing is decoded twice. */
+void audio_mixer_voice_fade(audio_mixer_voice_t *voice, float target,
+      unsigned duration_ms);
+
 void audio_mixer_mix(float* buffer, size_t num_frames, float volume_override, bool override);
 
 RETRO_END_DECLS
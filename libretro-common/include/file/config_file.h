@@ -58,7 +58,14 @@ struct config_file
    struct config_entry_list *tail;
    struct config_entry_list *last;
    struct config_include_list *includes;
+   /* Hash index over 'entries', built lazily on
+    * first key lookup. Chained through the
+    * 'hash_next' entry field */
+   struct config_entry_list **index_buckets;
+   size_t index_size;
+   size_t index_count;
    unsigned include_depth;
+   bool index_valid;
    bool guaranteed_no_duplicates;
    bool modified;
 };
@@ -113,6 +120,13 @@ bool config_file_deinitialize(config_file_t *conf);
  * The key-value pairs of the new config file takes priority over the old. */
 bool config_append_file(config_file_t *conf, const char *path);
 
+/* Like config_append_file, but parses the new config from an
+ * in-memory string instead of reading @path from disk.
+ * @from_string is modified in the process. @path is only used
+ * to resolve relative includes and for error messages. */
+bool config_append_string(config_file_t *conf, char *from_string,
+      const char *path);
+
 /* All extract functions return true when value is valid and exists.
  * Returns false otherwise. */
 
@@ -123,6 +137,9 @@ struct config_entry_list
    char *key;
    char *value;
    struct config_entry_list *next;
+   /* Bucket chain of the config_file hash index.
+    * Only meaningful while the index is valid. */
+   struct config_entry_list *hash_next;
    /* If we got this from an #include,
     * do not allow overwrite. */
    bool readonly;
@@ -524,6 +524,20 @@ bool path_is_valid(const char *path);
 
 int32_t path_get_size(const char *path);
 
+/**
+ * path_get_mtime:
+ * @path               : path
+ *
+ * Gets last modification time of the file at @path. The VFS
+ * stat interface does not expose timestamps, so this queries
+ * the filesystem directly, converting the path the same way
+ * the VFS does on Windows.
+ *
+ * Returns: modification time as seconds since the epoch,
+ * or -1 on failure.
+ **/
+int64_t path_get_mtime(const char *path);
+
 bool is_path_accessible_using_standard_io(const char *path);
 
 RETRO_END_DECLS
@@ -73,6 +73,12 @@ typedef struct nbio_intf
    const char *ident;
 } nbio_intf_t;
 
+/*
+ * Returns true if the io_uring backend can be used on the
+ * running kernel. Always false when the backend is not built.
+ */
+bool nbio_uring_supported(void);
+
 /*
  * Creates an nbio structure for performing the
  * given operation on the given file.
@@ -32,6 +32,8 @@
 
 RETRO_BEGIN_DECLS
 
+struct tpool;
+
 enum scaler_pix_fmt
 {
    SCALER_FMT_ARGB8888 = 0,
@@ -68,6 +70,20 @@ struct scaler_ctx
    void (*scaler_special)(const struct scaler_ctx*,
          void*, const void*, int, int, int, int, int, int);
 
+   /* Row-range versions of the above, used to run disjoint
+    * strips on the worker pool. Always set alongside their
+    * full-range counterparts. */
+   void (*scaler_horiz_range)(const struct scaler_ctx*,
+         const void*, int, int, int);
+   void (*scaler_vert_range)(const struct scaler_ctx*,
+         void*, int, int, int);
+   void (*scaler_special_range)(const struct scaler_ctx*,
+         void*, const void*, int, int, int, int, int, int, int, int);
+
+   /* Worker pool for strip-parallel scaling. NULL when threads are
+    * unavailable or the frame is too small to be worth splitting. */
+   struct tpool *pool;
+
    void (*in_pixconv)(void*, const void*, int, int, int, int);
    void (*out_pixconv)(void*, const void*, int, int, int, int);
    void (*direct_pixconv)(void*, const void*, int, int, int, int);
@@ -93,6 +109,8 @@ struct scaler_ctx
       int stride;
    } output;
 
+   int pool_strips;
+
    int in_width;
    int in_height;
    int in_stride;
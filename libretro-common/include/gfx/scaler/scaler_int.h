@@ -41,6 +41,22 @@ void scaler_argb8888_point_special(const struct scaler_ctx *ctx,
       int in_width, int in_height,
       int out_stride, int in_stride);
 
+/* Strip variants of the above, restricted to
+ * output rows [h_start, h_end). */
+
+void scaler_argb8888_vert_range(const struct scaler_ctx *ctx,
+      void *output, int stride, int h_start, int h_end);
+
+void scaler_argb8888_horiz_range(const struct scaler_ctx *ctx,
+      const void *input, int stride, int h_start, int h_end);
+
+void scaler_argb8888_point_special_range(const struct scaler_ctx *ctx,
+      void *output, const void *input,
+      int out_width, int out_height,
+      int in_width, int in_height,
+      int out_stride, int in_stride,
+      int h_start, int h_end);
+
 RETRO_END_DECLS
 
 #endif
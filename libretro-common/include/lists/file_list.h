@@ -44,9 +44,18 @@ struct item_file
    unsigned type;
 };
 
+/* Bulk storage for entry strings - see file_list.c */
+struct file_list_block;
+
 typedef struct file_list
 {
    struct item_file *list;
+   struct file_list_block *blocks;
+   /* Open-addressed table over the interned strings
+    * living in 'blocks' - see file_list.c */
+   void **intern_buckets;
+   size_t intern_size;
+   size_t intern_count;
 
    size_t capacity;
    size_t size;
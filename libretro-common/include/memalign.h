@@ -35,6 +35,15 @@ void *memalign_alloc_aligned(size_t size);
 
 void memalign_free(void *ptr);
 
+/* For large, long-lived buffers that get rewritten every
+ * frame (savestates and the like). Page-backed and
+ * transparent-hugepage-advised where the platform supports
+ * it, plain aligned allocation elsewhere. The same size must
+ * be passed to memalign_free_big(). Memory is NOT zeroed. */
+void *memalign_alloc_big(size_t size);
+
+void memalign_free_big(void *ptr, size_t size);
+
 RETRO_END_DECLS
 
 #endif
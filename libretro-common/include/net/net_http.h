@@ -44,6 +44,17 @@ void net_http_connection_free(struct http_connection_t *conn);
 
 void net_http_connection_set_user_agent(struct http_connection_t* conn, const char* user_agent);
 
+/* Request only part of the resource; range is the value placed after
+ * "Range: bytes=", e.g. "0-1023" or "1024-". Pass NULL to clear it.
+ * Servers that honor the range answer with status 206. */
+void net_http_connection_set_range(struct http_connection_t* conn, const char* range);
+
+/* Cache validators for conditional requests; a server holding a
+ * matching copy answers with status 304 and an empty body.
+ * Pass NULL to clear them. */
+void net_http_connection_set_if_none_match(struct http_connection_t* conn, const char* etag);
+void net_http_connection_set_if_modified_since(struct http_connection_t* conn, const char* date);
+
 const char *net_http_connection_url(struct http_connection_t *conn);
 
 struct http_t *net_http_new(struct http_connection_t *conn);
@@ -59,6 +70,16 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total);
 /* 200, 404, or whatever.  */
 int net_http_status(struct http_t *state);
 
+/* Size of the complete resource as reported by a Content-Range
+ * response header, or 0 if the server did not send one. */
+size_t net_http_content_range_total(struct http_t *state);
+
+/* Cache validators from the response headers, or NULL if the
+ * server did not send them. The returned strings are owned by
+ * the HTTP handler and freed by net_http_delete. */
+const char *net_http_etag(struct http_t *state);
+const char *net_http_last_modified(struct http_t *state);
+
 bool net_http_error(struct http_t *state);
 
 /* Returns the downloaded data. The returned buffer is owned by the
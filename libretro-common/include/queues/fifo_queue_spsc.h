@@ -0,0 +1,148 @@
+/* Copyright  (C) 2010-2020 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (fifo_queue_spsc.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __LIBRETRO_SDK_FIFO_BUFFER_SPSC_H
+#define __LIBRETRO_SDK_FIFO_BUFFER_SPSC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <retro_common_api.h>
+#include <retro_inline.h>
+#include <boolean.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+RETRO_BEGIN_DECLS
+
+/* Single-producer/single-consumer byte FIFO.
+ *
+ * Unlike fifo_buffer, this variant is safe to share between
+ * exactly one producer thread and one consumer thread without
+ * any external locking - e.g. for handing audio off to a
+ * realtime callback that must not block on a mutex.
+ *
+ * The contract matches fifo_buffer: check the available
+ * byte count on your own side before calling write/read. */
+
+#define FIFO_SPSC_CACHE_LINE 64
+
+struct fifo_buffer_spsc
+{
+   uint8_t *buffer;
+   size_t size;
+   /* Each position is written by one thread only and
+    * padded onto its own cache line to avoid false
+    * sharing between producer and consumer. */
+   volatile size_t first; /* Consumer (read) position */
+   char _pad1[FIFO_SPSC_CACHE_LINE - sizeof(size_t)];
+   volatile size_t end;   /* Producer (write) position */
+   char _pad2[FIFO_SPSC_CACHE_LINE - sizeof(size_t)];
+};
+
+typedef struct fifo_buffer_spsc fifo_buffer_spsc_t;
+
+#if defined(_MSC_VER)
+/* MSVC: volatile accesses do not reorder against other
+ * memory operations on x86, and /volatile:ms inserts the
+ * required barriers on ARM; a compiler barrier is enough. */
+static INLINE size_t fifo_spsc_load_acquire(const volatile size_t *addr)
+{
+   size_t v = *addr;
+   _ReadWriteBarrier();
+   return v;
+}
+
+static INLINE void fifo_spsc_store_release(volatile size_t *addr, size_t v)
+{
+   _ReadWriteBarrier();
+   *addr = v;
+}
+#elif defined(__clang__) || (defined(__GNUC__) && \
+      ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+static INLINE size_t fifo_spsc_load_acquire(const volatile size_t *addr)
+{
+   return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static INLINE void fifo_spsc_store_release(volatile size_t *addr, size_t v)
+{
+   __atomic_store_n(addr, v, __ATOMIC_RELEASE);
+}
+#else
+/* Older GCC - full barriers, stronger than needed
+ * but correct. */
+static INLINE size_t fifo_spsc_load_acquire(const volatile size_t *addr)
+{
+   size_t v = *addr;
+   __sync_synchronize();
+   return v;
+}
+
+static INLINE void fifo_spsc_store_release(volatile size_t *addr, size_t v)
+{
+   __sync_synchronize();
+   *addr = v;
+}
+#endif
+
+fifo_buffer_spsc_t *fifo_spsc_new(size_t size);
+
+/* Call only while neither thread is accessing
+ * the buffer. */
+static INLINE void fifo_spsc_clear(fifo_buffer_spsc_t *buffer)
+{
+   buffer->first = 0;
+   buffer->end   = 0;
+}
+
+/* Consumer side. */
+static INLINE size_t fifo_spsc_read_avail(fifo_buffer_spsc_t *buffer)
+{
+   size_t first = buffer->first;
+   size_t end   = fifo_spsc_load_acquire(&buffer->end);
+   return (end + ((end < first) ? buffer->size : 0)) - first;
+}
+
+/* Producer side. */
+static INLINE size_t fifo_spsc_write_avail(fifo_buffer_spsc_t *buffer)
+{
+   size_t end   = buffer->end;
+   size_t first = fifo_spsc_load_acquire(&buffer->first);
+   return (buffer->size - 1) -
+      ((end + ((end < first) ? buffer->size : 0)) - first);
+}
+
+void fifo_spsc_write(fifo_buffer_spsc_t *buffer,
+      const void *in_buf, size_t size);
+
+void fifo_spsc_read(fifo_buffer_spsc_t *buffer,
+      void *in_buf, size_t size);
+
+void fifo_spsc_free(fifo_buffer_spsc_t *buffer);
+
+RETRO_END_DECLS
+
+#endif
@@ -43,22 +43,31 @@ enum message_queue_category
    MESSAGE_QUEUE_CATEGORY_SUCCESS
 };
 
+/* Inline element storage - big enough for any OSD message.
+ * Longer strings are truncated on push instead of allocated. */
+#define MSG_QUEUE_MSG_SIZE   1024
+#define MSG_QUEUE_TITLE_SIZE 1024
+
 typedef struct queue_elem
 {
-   char *msg;
-   char *title;
    unsigned duration;
    unsigned prio;
+   unsigned seq; /* insertion order, used by the eviction policy */
    enum message_queue_icon icon;
    enum message_queue_category category;
+   bool used;
+   char msg[MSG_QUEUE_MSG_SIZE];
+   char title[MSG_QUEUE_TITLE_SIZE];
 } queue_elem_t;
 
 typedef struct msg_queue
 {
-   char *tmp_msg;
-   queue_elem_t **elems;
+   queue_elem_t *pool;   /* fixed element storage, allocated once */
+   queue_elem_t **elems; /* priority heap of pointers into pool */
    size_t ptr;
    size_t size;
+   unsigned seq;
+   char tmp_msg[MSG_QUEUE_MSG_SIZE];
 } msg_queue_t;
 
 typedef struct
@@ -44,6 +44,18 @@ enum task_type
    TASK_TYPE_BLOCKING
 };
 
+enum task_priority
+{
+   /* Background bulk work (downloads, database scans) -
+    * yields to everything else */
+   TASK_PRIORITY_BULK             = -1,
+   /* Default */
+   TASK_PRIORITY_INTERACTIVE      = 0,
+   /* Directly requested by user interaction (e.g. menu
+    * thumbnail decodes) - picked up before anything else */
+   TASK_PRIORITY_LATENCY_CRITICAL = 1
+};
+
 typedef struct retro_task retro_task_t;
 typedef void (*retro_task_callback_t)(retro_task_t *task,
       void *task_data,
@@ -60,6 +72,8 @@ typedef void (*retro_task_queue_msg_t)(retro_task_t *task,
 
 typedef bool (*retro_task_retriever_t)(retro_task_t *task, void *data);
 
+typedef void (*retro_task_queue_trace_t)(retro_task_t *task, bool begin);
+
 typedef bool (*retro_task_condition_fn_t)(void *data);
 
 typedef struct
@@ -115,6 +129,10 @@ struct retro_task
 
    enum task_type type;
 
+   /* scheduling class - decides which waiting task a
+    * worker picks up first, never starves a class */
+   enum task_priority priority;
+
    /* if set to true, frontend will
    use an alternative look for the
    task progress display */
@@ -128,6 +146,10 @@ struct retro_task
     * to signal the task *must* end. */
    bool cancelled;
 
+   /* set while a worker thread is inside the handler,
+    * so other workers skip the task. don't touch this. */
+   bool in_worker;
+
    /* if true no OSD messages will be displayed. */
    bool mute;
 };
@@ -252,6 +274,11 @@ void task_queue_deinit(void);
  * This must only be called from the main thread. */
 void task_queue_init(bool threaded, retro_task_queue_msg_t msg_push);
 
+/* Installs a hook invoked around every task handler call, on the
+ * thread running the task - begin right before, end right after.
+ * Pass NULL to remove. Used by the frontend for trace capture. */
+void task_queue_set_trace(retro_task_queue_trace_t trace);
+
 /* Allocates and inits a new retro_task_t */
 retro_task_t *task_init(void);
 
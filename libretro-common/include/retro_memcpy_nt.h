@@ -0,0 +1,124 @@
+/* Copyright  (C) 2010-2021 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (retro_memcpy_nt.h).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef _LIBRETRO_MEMCPY_NT_H
+#define _LIBRETRO_MEMCPY_NT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <retro_common_api.h>
+#include <retro_inline.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+RETRO_BEGIN_DECLS
+
+/* Copies below this size stay on plain memcpy - they fit in
+ * cache anyway and the store fence would dominate */
+#define RETRO_MEMCPY_NT_THRESHOLD 1024
+
+/**
+ * retro_memcpy_nt:
+ *
+ * memcpy variant for frame-sized buffers that are written once
+ * and not read back by the writing thread: the bulk of the copy
+ * uses non-temporal stores where the target supports them
+ * (SSE2), so a multi-megabyte frame handoff does not evict the
+ * core's working set from the cache. Falls back to plain memcpy
+ * for small copies and on other targets. Regions must not
+ * overlap, as with memcpy.
+ **/
+static INLINE void *retro_memcpy_nt(void *dst,
+      const void *src, size_t len)
+{
+#if defined(__SSE2__)
+   uint8_t *d       = (uint8_t*)dst;
+   const uint8_t *s = (const uint8_t*)src;
+
+   if (len >= RETRO_MEMCPY_NT_THRESHOLD)
+   {
+      /* Streaming stores require a 16-byte-aligned
+       * destination; copy a head fragment to get there */
+      size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+
+      if (head)
+      {
+         memcpy(d, s, head);
+         d   += head;
+         s   += head;
+         len -= head;
+      }
+
+      if (!((uintptr_t)s & 15))
+      {
+         for (; len >= 64; d += 64, s += 64, len -= 64)
+         {
+            _mm_stream_si128((__m128i*)(d +  0),
+                  _mm_load_si128((const __m128i*)(s +  0)));
+            _mm_stream_si128((__m128i*)(d + 16),
+                  _mm_load_si128((const __m128i*)(s + 16)));
+            _mm_stream_si128((__m128i*)(d + 32),
+                  _mm_load_si128((const __m128i*)(s + 32)));
+            _mm_stream_si128((__m128i*)(d + 48),
+                  _mm_load_si128((const __m128i*)(s + 48)));
+         }
+      }
+      else
+      {
+         for (; len >= 64; d += 64, s += 64, len -= 64)
+         {
+            _mm_stream_si128((__m128i*)(d +  0),
+                  _mm_loadu_si128((const __m128i*)(s +  0)));
+            _mm_stream_si128((__m128i*)(d + 16),
+                  _mm_loadu_si128((const __m128i*)(s + 16)));
+            _mm_stream_si128((__m128i*)(d + 32),
+                  _mm_loadu_si128((const __m128i*)(s + 32)));
+            _mm_stream_si128((__m128i*)(d + 48),
+                  _mm_loadu_si128((const __m128i*)(s + 48)));
+         }
+      }
+
+      for (; len >= 16; d += 16, s += 16, len -= 16)
+         _mm_stream_si128((__m128i*)d,
+               _mm_loadu_si128((const __m128i*)s));
+
+      /* Make the streamed data visible before any flag or lock
+       * that publishes the buffer to another thread */
+      _mm_sfence();
+   }
+
+   if (len)
+      memcpy(d, s, len);
+
+   return dst;
+#else
+   return memcpy(dst, src, len);
+#endif
+}
+
+RETRO_END_DECLS
+
+#endif
@@ -36,6 +36,20 @@ typedef struct sthread sthread_t;
 typedef struct slock slock_t;
 typedef struct scond scond_t;
 
+enum sthread_class
+{
+   STHREAD_CLASS_DEFAULT = 0,
+   /* Latency-critical presentation work -
+    * prefers the fast cores on asymmetric CPUs. */
+   STHREAD_CLASS_VIDEO,
+   /* Latency-critical audio work -
+    * prefers the fast cores on asymmetric CPUs. */
+   STHREAD_CLASS_AUDIO,
+   /* Bulk work that should stay out of the way
+    * of the latency-critical threads. */
+   STHREAD_CLASS_BACKGROUND
+};
+
 #ifdef HAVE_THREAD_STORAGE
 typedef unsigned sthread_tls_t;
 #endif
@@ -69,6 +83,25 @@ sthread_t *sthread_create(void (*thread_func)(void*), void *userdata);
  */
 sthread_t *sthread_create_with_priority(void (*thread_func)(void*), void *userdata, int thread_priority);
 
+/**
+ * sthread_create_with_class:
+ * @start_routine           : thread entry callback function
+ * @userdata                : pointer to userdata that will be made
+ *                            available in thread entry callback function
+ * @name                    : descriptive thread name, or NULL
+ *                            (truncated to 15 characters where the
+ *                            platform exposes thread names)
+ * @thread_class            : placement hint from enum sthread_class
+ *
+ * Create a new thread with a placement hint. The name and class are
+ * applied on a best-effort basis: platforms without thread naming,
+ * affinity or priority control simply create a default thread.
+ *
+ * Returns: pointer to new thread if successful, otherwise NULL.
+ */
+sthread_t *sthread_create_with_class(void (*thread_func)(void*),
+      void *userdata, const char *name, enum sthread_class thread_class);
+
 /**
  * sthread_detach:
  * @thread                  : pointer to thread object
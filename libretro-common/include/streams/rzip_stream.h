@@ -52,9 +52,14 @@ RETRO_BEGIN_DECLS
  * uncompressed) is detected via the RZIP header.
  * 
  * ## RZIP file format:
- * 
+ *
  * <file id header>:                8 bytes
  *                                  - [#][R][Z][I][P][v][file format version][#]
+ *                                  - low nibble of the version byte is the
+ *                                    format version; high bits are format
+ *                                    flags (0x20: delta (XOR) coded against
+ *                                    a previous state, 0x40: chunks are
+ *                                    zstd- rather than zlib-compressed)
  * <uncompressed chunk size>:       4 bytes, little endian order
  *                                  - nominal (maximum) size of each uncompressed
  *                                    chunk, in bytes
@@ -72,6 +77,20 @@ RETRO_BEGIN_DECLS
 /* Prevent direct access to rzipstream_t members */
 typedef struct rzipstream rzipstream_t;
 
+/* Stream format flags for rzipstream_open_ext()
+ * > ZSTD:  compress chunks with zstd instead of
+ *          zlib (requires HAVE_ZSTD; silently
+ *          falls back to zlib otherwise)
+ * > DELTA: XOR data against a previous-state
+ *          reference buffer (assigned via
+ *          rzipstream_set_delta()) before
+ *          compression, so that periodic
+ *          savestate-style writes only pay for
+ *          the bytes that actually changed */
+#define RZIP_STREAM_FLAG_NONE  0
+#define RZIP_STREAM_FLAG_ZSTD  (1 << 0)
+#define RZIP_STREAM_FLAG_DELTA (1 << 1)
+
 /* File Open */
 
 /* Opens a new or existing RZIP file
@@ -84,6 +103,28 @@ typedef struct rzipstream rzipstream_t;
  * is invalid or an IO error occurs */
 rzipstream_t* rzipstream_open(const char *path, unsigned mode);
 
+/* Opens a new or existing RZIP file, with explicit
+ * format flags (RZIP_STREAM_FLAG_*)
+ * > Flags only affect written files; when reading,
+ *   format is detected from the file header
+ * > rzipstream_open() is equivalent to calling
+ *   this with RZIP_STREAM_FLAG_NONE */
+rzipstream_t* rzipstream_open_ext(const char *path, unsigned mode,
+      unsigned flags);
+
+/* Assigns the previous-state reference buffer of a
+ * delta (XOR) coded stream.
+ * > Stream merely borrows the buffer; caller retains
+ *   ownership, and must ensure it remains valid for
+ *   the lifetime of the stream
+ * > Must be called before the first read/write of a
+ *   stream carrying RZIP_STREAM_FLAG_DELTA; such
+ *   reads/writes fail if no reference buffer is set
+ * Returns false if stream is invalid or not delta
+ * coded */
+bool rzipstream_set_delta(rzipstream_t *stream,
+      const void *data, uint64_t len);
+
 /* File Read */
 
 /* Reads (a maximum of) 'len' bytes from an RZIP file.
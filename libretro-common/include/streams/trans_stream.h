@@ -96,10 +96,18 @@ bool trans_stream_trans_full(
 const struct trans_stream_backend* trans_stream_get_zlib_deflate_backend(void);
 const struct trans_stream_backend* trans_stream_get_zlib_inflate_backend(void);
 const struct trans_stream_backend* trans_stream_get_pipe_backend(void);
+#ifdef HAVE_ZSTD
+const struct trans_stream_backend* trans_stream_get_zstd_compress_backend(void);
+const struct trans_stream_backend* trans_stream_get_zstd_decompress_backend(void);
+#endif
 
 extern const struct trans_stream_backend zlib_deflate_backend;
 extern const struct trans_stream_backend zlib_inflate_backend;
 extern const struct trans_stream_backend pipe_backend;
+#ifdef HAVE_ZSTD
+extern const struct trans_stream_backend zstd_compress_backend;
+extern const struct trans_stream_backend zstd_decompress_backend;
+#endif
 
 RETRO_END_DECLS
 
@@ -169,6 +169,19 @@ unsigned string_to_unsigned(const char *str);
  * Returns 0 if string is invalid  */
 unsigned string_hex_to_unsigned(const char *str);
 
+/* Appends 'src' to 's' at offset 'pos', NUL-terminating within
+ * 'len' bytes. Returns the offset of the new terminator, so calls
+ * chain without the destination rescans of strlcat. Fast
+ * replacement for snprintf() "%s..." patterns on hot paths  */
+size_t string_append(char *s, size_t len, size_t pos, const char *src);
+
+/* Appends the decimal representation of 'value' ("%u") */
+size_t string_append_unsigned(char *s, size_t len, size_t pos,
+      unsigned value);
+
+/* Appends the decimal representation of 'value' ("%d") */
+size_t string_append_signed(char *s, size_t len, size_t pos, int value);
+
 char *string_init(const char *src);
 
 void string_set(char **string, const char *src);
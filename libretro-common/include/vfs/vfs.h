@@ -56,10 +56,21 @@ typedef struct
 } vfs_cdrom_t;
 #endif
 
+#ifdef HAVE_COMPRESSION
+typedef struct
+{
+   /* Inflated copy of the archive entry */
+   uint8_t *data;
+   int64_t size;
+   int64_t pos;
+} vfs_archive_t;
+#endif
+
 enum vfs_scheme
 {
    VFS_SCHEME_NONE = 0,
-   VFS_SCHEME_CDROM
+   VFS_SCHEME_CDROM,
+   VFS_SCHEME_ARCHIVE
 };
 
 #ifndef __WINRT__
@@ -71,6 +82,9 @@ struct libretro_vfs_implementation_file
 {
 #ifdef HAVE_CDROM
    vfs_cdrom_t cdrom; /* int64_t alignment */
+#endif
+#ifdef HAVE_COMPRESSION
+   vfs_archive_t archive; /* int64_t alignment */
 #endif
    int64_t size;
    uint64_t mappos;
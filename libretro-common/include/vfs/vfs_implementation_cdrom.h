@@ -45,6 +45,11 @@ int retro_vfs_file_error_cdrom(libretro_vfs_implementation_file *stream);
 
 const cdrom_toc_t* retro_vfs_file_get_cdrom_toc(void);
 
+/* Sets the size of the read-ahead sector cache used for
+ * physical drives. Flushes any cached sectors; a size of
+ * zero disables caching. */
+void retro_vfs_file_set_cdrom_cache_size(size_t bytes);
+
 const vfs_cdrom_t* retro_vfs_file_get_cdrom_position(const libretro_vfs_implementation_file *stream);
 
 RETRO_END_DECLS
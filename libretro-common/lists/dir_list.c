@@ -93,6 +93,41 @@ bool dir_list_deinitialize(struct string_list *list)
    return string_list_deinitialize(list);
 }
 
+/**
+ * dir_list_ext_matches:
+ * @ext_list           : the string list of extensions to include
+ * @file_ext           : extension of the current directory entry
+ *
+ * Checks whether @file_ext appears in @ext_list. Entries may be
+ * listed with or without a leading dot. Unlike
+ * string_list_find_elem_prefix(), no per-call scratch string is
+ * built - this runs once per directory entry, so it has to stay
+ * cheap on large directories.
+ *
+ * Returns: true if the extension is in the list, otherwise false.
+ **/
+static bool dir_list_ext_matches(const struct string_list *ext_list,
+      const char *file_ext)
+{
+   size_t i;
+
+   if (!ext_list)
+      return false;
+
+   for (i = 0; i < ext_list->size; i++)
+   {
+      const char *ext = ext_list->elems[i].data;
+
+      if (*ext == '.')
+         ext++;
+
+      if (string_is_equal_noncase(ext, file_ext))
+         return true;
+   }
+
+   return false;
+}
+
 /**
  * dir_list_read:
  * @dir                : directory path.
@@ -139,11 +174,11 @@ static int dir_list_read(const char *dir,
             continue;
       }
 
-      file_path[0] = '\0';
-      fill_pathname_join(file_path, dir, name, sizeof(file_path));
-
       if (retro_dirent_is_dir(entry, NULL))
       {
+         file_path[0] = '\0';
+         fill_pathname_join(file_path, dir, name, sizeof(file_path));
+
          if (recursive)
             dir_list_read(file_path, list, ext_list, include_dirs,
                   include_hidden, include_compressed, recursive);
@@ -166,18 +201,23 @@ static int dir_list_read(const char *dir,
           * compressed_file. In that case, we have to interpret it as a image.
           *
           * */
-         if (string_list_find_elem_prefix(ext_list, ".", file_ext))
+         if (dir_list_ext_matches(ext_list, file_ext))
             attr.i            = RARCH_PLAIN_FILE;
          else
          {
             bool is_compressed_file;
-            if ((is_compressed_file = path_is_compressed_file(file_path)))
+            if ((is_compressed_file = path_is_compressed_file(name)))
                attr.i               = RARCH_COMPRESSED_ARCHIVE;
 
             if (ext_list &&
                   (!is_compressed_file || !include_compressed))
                continue;
          }
+
+         /* Entry survived filtering - only now pay for
+          * building its full path */
+         file_path[0] = '\0';
+         fill_pathname_join(file_path, dir, name, sizeof(file_path));
       }
 
       if (!string_list_append(list, file_path, attr))
@@ -20,7 +20,9 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <stddef.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -29,6 +31,271 @@
 #include <string/stdstring.h>
 #include <compat/strcasestr.h>
 
+#define FILE_LIST_BLOCK_MIN_SIZE 4096
+
+/* Entry strings are bump-allocated out of a chain of
+ * geometrically growing blocks instead of one heap
+ * allocation per string; a large displaylist rebuild
+ * would otherwise perform tens of thousands of small
+ * mallocs, fragmenting the heap on console ports.
+ * Blocks are kept across file_list_clear() so a rebuild
+ * reuses the storage of the list it replaces. */
+struct file_list_block
+{
+   struct file_list_block *next;
+   size_t cap;
+   size_t used;
+   char data[1];
+};
+
+/* Interned-string node, allocated inline in the blocks with
+ * the header right ahead of the characters. Identical strings
+ * within one list share a single node - most labels and values
+ * in a menu list repeat heavily (group names, ON/OFF values,
+ * static msg_hash labels), so sharing avoids both the copy and
+ * the block growth. 'ref' counts the entry fields referencing
+ * the node. */
+struct file_list_string
+{
+   uint32_t hash;
+   uint32_t ref;
+   char data[1];
+};
+
+#define FILE_LIST_INTERN_MIN_BUCKETS 128
+/* Marks a vacated slot in the linear-probed bucket table */
+#define FILE_LIST_INTERN_TOMBSTONE   ((void*)(uintptr_t)1)
+
+static uint32_t file_list_hash_key(const char *str)
+{
+   uint32_t hash = 5381;
+   while (*str)
+      hash = (hash << 5) + hash + (uint8_t)*str++;
+   return hash;
+}
+
+#define FILE_LIST_STRING_NODE(str) \
+   ((struct file_list_string*)((str) - offsetof(struct file_list_string, data)))
+
+static void *file_list_block_alloc(file_list_t *list, size_t len)
+{
+   void *dst;
+   struct file_list_block *block = list->blocks;
+   /* Nodes carry uint32_t members - keep them aligned */
+   size_t used                   = block
+         ? ((block->used + 3) & ~(size_t)3) : 0;
+
+   if (!block || (block->cap - used) < len)
+   {
+      struct file_list_block *new_block;
+      size_t cap = block ? (block->cap << 1) : FILE_LIST_BLOCK_MIN_SIZE;
+
+      while (cap < len)
+         cap <<= 1;
+
+      new_block = (struct file_list_block*)malloc(
+            offsetof(struct file_list_block, data) + cap);
+
+      if (!new_block)
+         return NULL;
+
+      new_block->next = block;
+      new_block->cap  = cap;
+      new_block->used = 0;
+      list->blocks    = new_block;
+      block           = new_block;
+      used            = 0;
+   }
+
+   dst         = block->data + used;
+   block->used = used + len;
+   return dst;
+}
+
+static bool file_list_block_owns(const file_list_t *list, const char *str)
+{
+   const struct file_list_block *block;
+   for (block = list->blocks; block; block = block->next)
+      if ((str >= block->data) && (str < block->data + block->used))
+         return true;
+   return false;
+}
+
+static bool file_list_intern_rehash(file_list_t *list, size_t new_size)
+{
+   size_t i;
+   void **new_buckets = (void**)calloc(new_size, sizeof(void*));
+
+   if (!new_buckets)
+      return false;
+
+   list->intern_count = 0;
+
+   for (i = 0; i < list->intern_size; i++)
+   {
+      struct file_list_string *node =
+            (struct file_list_string*)list->intern_buckets[i];
+      size_t idx;
+
+      if (!node || ((void*)node == FILE_LIST_INTERN_TOMBSTONE))
+         continue;
+
+      idx = node->hash & (new_size - 1);
+      while (new_buckets[idx])
+         idx = (idx + 1) & (new_size - 1);
+      new_buckets[idx] = node;
+      list->intern_count++;
+   }
+
+   free(list->intern_buckets);
+   list->intern_buckets = new_buckets;
+   list->intern_size    = new_size;
+   return true;
+}
+
+/* Returns a shared copy of @str owned by the list, creating
+ * it if this is the first reference. Falls back to a plain
+ * heap copy if the table or block cannot be grown. */
+static char *file_list_intern(file_list_t *list, const char *str)
+{
+   uint32_t hash;
+   size_t len, idx;
+   size_t free_slot              = (size_t)-1;
+   struct file_list_string *node = NULL;
+
+   if (!list->intern_buckets)
+   {
+      if (!(list->intern_buckets = (void**)calloc(
+                  FILE_LIST_INTERN_MIN_BUCKETS, sizeof(void*))))
+         return strdup(str);
+      list->intern_size  = FILE_LIST_INTERN_MIN_BUCKETS;
+      list->intern_count = 0;
+   }
+
+   /* Keep the table at most half full (tombstones count
+    * until the next rehash clears them) */
+   if (  ((list->intern_count + 1) << 1) > list->intern_size &&
+         !file_list_intern_rehash(list, list->intern_size << 1))
+      return strdup(str);
+
+   hash = file_list_hash_key(str);
+   idx  = hash & (list->intern_size - 1);
+
+   for (;;)
+   {
+      void *bucket = list->intern_buckets[idx];
+
+      if (!bucket)
+         break;
+
+      if (bucket == FILE_LIST_INTERN_TOMBSTONE)
+      {
+         if (free_slot == (size_t)-1)
+            free_slot = idx;
+      }
+      else
+      {
+         node = (struct file_list_string*)bucket;
+         if ((node->hash == hash) && string_is_equal(node->data, str))
+         {
+            node->ref++;
+            return node->data;
+         }
+      }
+
+      idx = (idx + 1) & (list->intern_size - 1);
+   }
+
+   len  = strlen(str) + 1;
+
+   if (!(node = (struct file_list_string*)file_list_block_alloc(list,
+               offsetof(struct file_list_string, data) + len)))
+      return strdup(str);
+
+   node->hash = hash;
+   node->ref  = 1;
+   memcpy(node->data, str, len);
+
+   if (free_slot != (size_t)-1)
+      idx = free_slot;
+   else
+      list->intern_count++;
+   list->intern_buckets[idx] = node;
+
+   return node->data;
+}
+
+/* Releases an entry string. Strings written into entries
+ * by outside code (e.g. menu driver list deep copies) live
+ * on the heap and are freed; interned strings drop one
+ * reference, and on the last reference leave the table.
+ * Their storage is reclaimed in bulk on clear/deinit,
+ * except that the most recent allocation is rolled back
+ * immediately so stack pops do not grow the blocks over
+ * time. */
+static void file_list_intern_release(file_list_t *list, char *str)
+{
+   size_t idx;
+   struct file_list_string *node = NULL;
+   struct file_list_block *block = list->blocks;
+
+   if (!str)
+      return;
+
+   if (!file_list_block_owns(list, str))
+   {
+      free(str);
+      return;
+   }
+
+   node = FILE_LIST_STRING_NODE(str);
+
+   if (node->ref > 1)
+   {
+      node->ref--;
+      return;
+   }
+
+   node->ref = 0;
+   idx       = node->hash & (list->intern_size - 1);
+
+   while (list->intern_buckets[idx] != (void*)node)
+      idx = (idx + 1) & (list->intern_size - 1);
+   list->intern_buckets[idx] = FILE_LIST_INTERN_TOMBSTONE;
+
+   {
+      size_t total = offsetof(struct file_list_string, data)
+            + strlen(str) + 1;
+      if (      ((char*)node >= block->data)
+            && (((char*)node + total) == (block->data + block->used)))
+         block->used = (char*)node - block->data;
+   }
+}
+
+static void file_list_block_reset(file_list_t *list)
+{
+   struct file_list_block *block;
+   for (block = list->blocks; block; block = block->next)
+      block->used = 0;
+
+   if (list->intern_buckets)
+      memset(list->intern_buckets, 0,
+            list->intern_size * sizeof(void*));
+   list->intern_count = 0;
+}
+
+static void file_list_block_deinit(file_list_t *list)
+{
+   struct file_list_block *block = list->blocks;
+   while (block)
+   {
+      struct file_list_block *next = block->next;
+      free(block);
+      block = next;
+   }
+   list->blocks = NULL;
+}
+
 static bool file_list_deinitialize_internal(file_list_t *list)
 {
    size_t i;
@@ -38,20 +305,28 @@ static bool file_list_deinitialize_internal(file_list_t *list)
       file_list_free_actiondata(list, i);
 
       if (list->list[i].path)
-         free(list->list[i].path);
+         file_list_intern_release(list, list->list[i].path);
       list->list[i].path = NULL;
 
       if (list->list[i].label)
-         free(list->list[i].label);
+         file_list_intern_release(list, list->list[i].label);
       list->list[i].label = NULL;
 
       if (list->list[i].alt)
-         free(list->list[i].alt);
+         file_list_intern_release(list, list->list[i].alt);
       list->list[i].alt = NULL;
    }
    if (list->list)
       free(list->list);
    list->list = NULL;
+
+   if (list->intern_buckets)
+      free(list->intern_buckets);
+   list->intern_buckets = NULL;
+   list->intern_size    = 0;
+   list->intern_count   = 0;
+
+   file_list_block_deinit(list);
    return true;
 }
 
@@ -60,9 +335,13 @@ bool file_list_initialize(file_list_t *list)
    if (!list)
       return false;
 
-   list->list     = NULL;
-   list->capacity = 0;
-   list->size     = 0;
+   list->list           = NULL;
+   list->blocks         = NULL;
+   list->intern_buckets = NULL;
+   list->intern_size    = 0;
+   list->intern_count   = 0;
+   list->capacity       = 0;
+   list->size           = 0;
 
    return true;
 }
@@ -106,34 +385,17 @@ bool file_list_insert(file_list_t *list,
       size_t entry_idx,
       size_t idx)
 {
-   int i;
-
    /* Expand file list if needed */
    if (list->size >= list->capacity)
       if (!file_list_reserve(list, list->capacity * 2 + 1))
          return false;
 
-   for (i = (unsigned)list->size; i > (int)idx; i--)
-   {
-      struct item_file *copy = (struct item_file*)
-         malloc(sizeof(struct item_file));
-
-      copy->path             = NULL;
-      copy->label            = NULL;
-      copy->alt              = NULL;
-      copy->type             = 0;
-      copy->directory_ptr    = 0;
-      copy->entry_idx        = 0;
-      copy->userdata         = NULL;
-      copy->actiondata       = NULL;
-
-      memcpy(copy, &list->list[i-1], sizeof(struct item_file));
-
-      memcpy(&list->list[i-1], &list->list[i], sizeof(struct item_file));
-      memcpy(&list->list[i],             copy, sizeof(struct item_file));
-
-      free(copy);
-   }
+   /* Shift the succeeding entries up by one slot in a
+    * single move - ownership of their heap data moves
+    * with them */
+   if (idx < list->size)
+      memmove(&list->list[idx + 1], &list->list[idx],
+            (list->size - idx) * sizeof(struct item_file));
 
    list->list[idx].path          = NULL;
    list->list[idx].label         = NULL;
@@ -145,9 +407,9 @@ bool file_list_insert(file_list_t *list,
    list->list[idx].actiondata    = NULL;
 
    if (label)
-      list->list[idx].label      = strdup(label);
+      list->list[idx].label      = file_list_intern(list, label);
    if (path)
-      list->list[idx].path       = strdup(path);
+      list->list[idx].path       = file_list_intern(list, path);
 
    list->size++;
 
@@ -175,9 +437,9 @@ bool file_list_append(file_list_t *list,
    list->list[idx].actiondata    = NULL;
 
    if (label)
-      list->list[idx].label      = strdup(label);
+      list->list[idx].label      = file_list_intern(list, label);
    if (path)
-      list->list[idx].path       = strdup(path);
+      list->list[idx].path       = file_list_intern(list, path);
 
    list->size++;
 
@@ -206,11 +468,11 @@ void file_list_pop(file_list_t *list, size_t *directory_ptr)
    {
       --list->size;
       if (list->list[list->size].path)
-         free(list->list[list->size].path);
+         file_list_intern_release(list, list->list[list->size].path);
       list->list[list->size].path = NULL;
 
       if (list->list[list->size].label)
-         free(list->list[list->size].label);
+         file_list_intern_release(list, list->list[list->size].label);
       list->list[list->size].label = NULL;
    }
 
@@ -246,34 +508,47 @@ void file_list_clear(file_list_t *list)
 
    for (i = 0; i < list->size; i++)
    {
-      if (list->list[i].path)
+      /* Heap strings written by outside code have to be
+       * freed one by one; block-owned strings are all
+       * reclaimed by the reset below */
+      if (     list->list[i].path
+            && !file_list_block_owns(list, list->list[i].path))
          free(list->list[i].path);
       list->list[i].path = NULL;
 
-      if (list->list[i].label)
+      if (     list->list[i].label
+            && !file_list_block_owns(list, list->list[i].label))
          free(list->list[i].label);
       list->list[i].label = NULL;
 
-      if (list->list[i].alt)
+      if (     list->list[i].alt
+            && !file_list_block_owns(list, list->list[i].alt))
          free(list->list[i].alt);
       list->list[i].alt = NULL;
    }
 
+   file_list_block_reset(list);
+
    list->size = 0;
 }
 
 void file_list_set_label_at_offset(file_list_t *list, size_t idx,
       const char *label)
 {
+   char *old;
+
    if (!list)
       return;
 
-   if (list->list[idx].label)
-      free(list->list[idx].label);
+   /* Acquire the new string before releasing the old one,
+    * so setting an identical string reuses its node */
+   old                      = list->list[idx].label;
+   list->list[idx].label    = label
+         ? file_list_intern(list, label) : NULL;
    list->list[idx].alt      = NULL;
 
-   if (label)
-      list->list[idx].label = strdup(label);
+   if (old)
+      file_list_intern_release(list, old);
 }
 
 void file_list_get_label_at_offset(const file_list_t *list, size_t idx,
@@ -290,15 +565,18 @@ void file_list_get_label_at_offset(const file_list_t *list, size_t idx,
 void file_list_set_alt_at_offset(file_list_t *list, size_t idx,
       const char *alt)
 {
+   char *old;
+
    if (!list || !alt)
       return;
 
-   if (list->list[idx].alt)
-      free(list->list[idx].alt);
-   list->list[idx].alt      = NULL;
+   /* Acquire the new string before releasing the old one,
+    * so setting an identical string reuses its node */
+   old                      = list->list[idx].alt;
+   list->list[idx].alt      = file_list_intern(list, alt);
 
-   if (alt)
-      list->list[idx].alt   = strdup(alt);
+   if (old)
+      file_list_intern_release(list, old);
 }
 
 static int file_list_alt_cmp(const void *a_, const void *b_)
@@ -22,9 +22,20 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <memalign.h>
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#elif defined(_WIN32) && !defined(_XBOX)
+#include <windows.h>
+#endif
+
+/* Buffers at least this large go through the page-backed
+ * path in memalign_alloc_big(). */
+#define MEMALIGN_BIG_THRESHOLD (2 * 1024 * 1024)
+
 void *memalign_alloc(size_t boundary, size_t size)
 {
    void **place   = NULL;
@@ -61,3 +72,71 @@ void *memalign_alloc_aligned(size_t size)
    return memalign_alloc(32, size);
 #endif
 }
+
+void *memalign_alloc_big(size_t size)
+{
+#if defined(__linux__)
+   if (size >= MEMALIGN_BIG_THRESHOLD)
+   {
+      size_t rounded = (size + 0xfff) & ~(size_t)0xfff;
+      void *ptr      = mmap(NULL, rounded, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+      if (ptr == MAP_FAILED)
+         return NULL;
+
+#ifdef MADV_HUGEPAGE
+      /* Advisory only; the mapping works either way. */
+      madvise(ptr, rounded, MADV_HUGEPAGE);
+#endif
+      return ptr;
+   }
+#elif defined(_WIN32) && !defined(_XBOX)
+   if (size >= MEMALIGN_BIG_THRESHOLD)
+   {
+      void *ptr        = NULL;
+      size_t large_min = GetLargePageMinimum();
+
+      if (large_min)
+      {
+         size_t rounded = (size + large_min - 1) & ~(large_min - 1);
+         ptr            = VirtualAlloc(NULL, rounded,
+               MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES,
+               PAGE_READWRITE);
+      }
+
+      /* Large pages need SeLockMemoryPrivilege, which most
+       * processes do not hold - fall back to a regular
+       * VirtualAlloc mapping, so the free path can still be
+       * decided from the size alone. */
+      if (!ptr)
+         ptr = VirtualAlloc(NULL, size,
+               MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+      return ptr;
+   }
+#endif
+   return memalign_alloc_aligned(size);
+}
+
+void memalign_free_big(void *ptr, size_t size)
+{
+   if (!ptr)
+      return;
+#if defined(__linux__)
+   /* Mirrors the decision taken in memalign_alloc_big();
+    * the big path never falls back to the heap. */
+   if (size >= MEMALIGN_BIG_THRESHOLD)
+   {
+      munmap(ptr, (size + 0xfff) & ~(size_t)0xfff);
+      return;
+   }
+#elif defined(_WIN32) && !defined(_XBOX)
+   if (size >= MEMALIGN_BIG_THRESHOLD)
+   {
+      VirtualFree(ptr, 0, MEM_RELEASE);
+      return;
+   }
+#endif
+   memalign_free(ptr);
+}
@@ -33,9 +33,25 @@
 #include <compat/strl.h>
 #include <string/stdstring.h>
 #include <string.h>
+#include <time.h>
 #include <retro_common_api.h>
 #include <retro_miscellaneous.h>
 
+/* Start the TCP handshake without waiting for it and send the request
+ * once the socket becomes writable, so several transfers can ramp up in
+ * parallel instead of serializing on each other's connects. Plain
+ * sockets on platforms with POSIX-style connect semantics only; SSL and
+ * everything else keeps the blocking path. */
+#if !defined(_WIN32) && !defined(VITA) && !defined(WIIU) && !defined(_3DS) && \
+    !defined(GEKKO) && !defined(__CELLOS_LV2__) && !defined(_XBOX)
+#define NET_HTTP_CONNECT_NONBLOCKING
+#include <errno.h>
+#endif
+
+/* How long we give a deferred connect before declaring the host
+ * unreachable */
+#define NET_HTTP_CONNECT_TIMEOUT_SECONDS 10
+
 enum
 {
    P_HEADER_TOP = 0,
@@ -58,15 +74,30 @@ struct http_socket_state_t
    void *ssl_ctx;
    int fd;
    bool ssl;
+   /* True while a deferred (non-blocking) connect is still in flight */
+   bool connecting;
 };
 
 struct http_t
 {
    char *data;
+   /* Cache validators from the response headers; NULL when
+    * the server did not send them */
+   char *etag;
+   char *last_modified;
    struct http_socket_state_t sock_state; /* ptr alignment */
+   /* The assembled request; sent once the connect completes and freed
+    * afterwards */
+   char *request;
+   size_t request_len;
+   size_t request_cap;
+   time_t connect_deadline;
    size_t pos;
    size_t len;
    size_t buflen;
+   /* Total resource size advertised by a Content-Range header;
+    * zero when the server did not send one */
+   size_t range_total;
    int status;
    char part;
    char bodytype;
@@ -83,6 +114,9 @@ struct http_connection_t
    char *contenttypecopy;
    char *postdatacopy;
    char* useragentcopy;
+   char* rangecopy;
+   char* ifnonematchcopy;
+   char* ifmodifiedsincecopy;
    struct http_socket_state_t sock_state; /* ptr alignment */
    int port;
 };
@@ -444,12 +478,34 @@ static int net_http_new_socket(struct http_connection_t *conn)
       else
 #endif
       {
+#ifdef NET_HTTP_CONNECT_NONBLOCKING
+         /* Switch to non-blocking before connecting so the handshake
+          * proceeds in the background; net_http_update() polls for
+          * completion. Commits to the first usable address rather than
+          * trying each in turn, which is fine in practice. */
+         if (socket_nonblock(fd))
+         {
+            ret = socket_connect(fd, (void*)next_addr, false);
+
+            if (ret >= 0)
+               break;
+
+            if (errno == EINPROGRESS)
+            {
+               conn->sock_state.connecting = true;
+               break;
+            }
+         }
+
+         socket_close(fd);
+#else
          ret = socket_connect(fd, (void*)next_addr, true);
 
          if (ret >= 0 && socket_nonblock(fd))
             break;
 
          socket_close(fd);
+#endif
       }
 
       fd = socket_next((void**)&next_addr);
@@ -463,27 +519,53 @@ static int net_http_new_socket(struct http_connection_t *conn)
    return fd;
 }
 
-static void net_http_send_str(
-      struct http_socket_state_t *sock_state, bool *error, const char *text)
+static void net_http_req_str(
+      struct http_t *state, bool *error, const char *text)
 {
    size_t text_size;
    if (*error)
       return;
    text_size = strlen(text);
-#ifdef HAVE_SSL
-   if (sock_state->ssl)
+   if (state->request_len + text_size + 1 > state->request_cap)
    {
-      if (!ssl_socket_send_all_blocking(
-               sock_state->ssl_ctx, text, text_size, true))
+      char *request  = NULL;
+      size_t new_cap = state->request_cap ? state->request_cap : 512;
+      while (state->request_len + text_size + 1 > new_cap)
+         new_cap *= 2;
+      request = (char*)realloc(state->request, new_cap);
+      if (!request)
+      {
          *error = true;
+         return;
+      }
+      state->request     = request;
+      state->request_cap = new_cap;
    }
+   memcpy(state->request + state->request_len, text, text_size);
+   state->request_len                += text_size;
+   state->request[state->request_len] = '\0';
+}
+
+static bool net_http_send_request(struct http_t *state)
+{
+   bool ok;
+#ifdef HAVE_SSL
+   if (state->sock_state.ssl)
+      ok = ssl_socket_send_all_blocking(
+            state->sock_state.ssl_ctx, state->request,
+            state->request_len, true);
    else
 #endif
-   {
-      if (!socket_send_all_blocking(
-               sock_state->fd, text, text_size, true))
-         *error = true;
-   }
+      ok = socket_send_all_blocking(
+            state->sock_state.fd, state->request,
+            state->request_len, true);
+
+   free(state->request);
+   state->request     = NULL;
+   state->request_len = 0;
+   state->request_cap = 0;
+
+   return ok;
 }
 
 struct http_connection_t *net_http_connection_new(const char *url,
@@ -509,10 +591,14 @@ struct http_connection_t *net_http_connection_new(const char *url,
    conn->contenttypecopy   = NULL;
    conn->postdatacopy      = NULL;
    conn->useragentcopy     = NULL;
+   conn->rangecopy         = NULL;
+   conn->ifnonematchcopy   = NULL;
+   conn->ifmodifiedsincecopy = NULL;
    conn->port              = 0;
    conn->sock_state.fd     = 0;
    conn->sock_state.ssl    = false;
    conn->sock_state.ssl_ctx= NULL;
+   conn->sock_state.connecting = false;
 
    if (method)
       conn->methodcopy     = strdup(method);
@@ -659,11 +745,23 @@ void net_http_connection_free(struct http_connection_t *conn)
    if (conn->useragentcopy)
       free(conn->useragentcopy);
 
+   if (conn->rangecopy)
+      free(conn->rangecopy);
+
+   if (conn->ifnonematchcopy)
+      free(conn->ifnonematchcopy);
+
+   if (conn->ifmodifiedsincecopy)
+      free(conn->ifmodifiedsincecopy);
+
    conn->urlcopy         = NULL;
    conn->methodcopy      = NULL;
    conn->contenttypecopy = NULL;
    conn->postdatacopy    = NULL;
    conn->useragentcopy   = NULL;
+   conn->rangecopy       = NULL;
+   conn->ifnonematchcopy = NULL;
+   conn->ifmodifiedsincecopy = NULL;
 
    free(conn);
 }
@@ -677,6 +775,33 @@ void net_http_connection_set_user_agent(
    conn->useragentcopy = user_agent ? strdup(user_agent) : NULL;
 }
 
+void net_http_connection_set_range(
+      struct http_connection_t* conn, const char* range)
+{
+   if (conn->rangecopy)
+      free(conn->rangecopy);
+
+   conn->rangecopy = range ? strdup(range) : NULL;
+}
+
+void net_http_connection_set_if_none_match(
+      struct http_connection_t* conn, const char* etag)
+{
+   if (conn->ifnonematchcopy)
+      free(conn->ifnonematchcopy);
+
+   conn->ifnonematchcopy = etag ? strdup(etag) : NULL;
+}
+
+void net_http_connection_set_if_modified_since(
+      struct http_connection_t* conn, const char* date)
+{
+   if (conn->ifmodifiedsincecopy)
+      free(conn->ifmodifiedsincecopy);
+
+   conn->ifmodifiedsincecopy = date ? strdup(date) : NULL;
+}
+
 const char *net_http_connection_url(struct http_connection_t *conn)
 {
    return conn->urlcopy;
@@ -696,24 +821,50 @@ struct http_t *net_http_new(struct http_connection_t *conn)
    if (fd < 0)
       goto error;
 
-   error = false;
+   error                  = false;
+
+   state                  = (struct http_t*)malloc(sizeof(struct http_t));
+
+   if (!state)
+      goto error;
+
+   state->sock_state      = conn->sock_state;
+   state->etag            = NULL;
+   state->last_modified   = NULL;
+   state->request         = NULL;
+   state->request_len     = 0;
+   state->request_cap     = 0;
+   state->connect_deadline= 0;
+   state->status          = -1;
+   state->data            = NULL;
+   state->part            = P_HEADER_TOP;
+   state->bodytype        = T_FULL;
+   state->error           = false;
+   state->pos             = 0;
+   state->len             = 0;
+   state->range_total     = 0;
+   state->buflen          = 512;
+   state->data            = (char*)malloc(state->buflen);
+
+   if (!state->data)
+      goto error;
 
    /* This is a bit lazy, but it works. */
    if (conn->methodcopy)
    {
-      net_http_send_str(&conn->sock_state, &error, conn->methodcopy);
-      net_http_send_str(&conn->sock_state, &error, " /");
+      net_http_req_str(state, &error, conn->methodcopy);
+      net_http_req_str(state, &error, " /");
    }
    else
    {
-      net_http_send_str(&conn->sock_state, &error, "GET /");
+      net_http_req_str(state, &error, "GET /");
    }
 
-   net_http_send_str(&conn->sock_state, &error, conn->location);
-   net_http_send_str(&conn->sock_state, &error, " HTTP/1.1\r\n");
+   net_http_req_str(state, &error, conn->location);
+   net_http_req_str(state, &error, " HTTP/1.1\r\n");
 
-   net_http_send_str(&conn->sock_state, &error, "Host: ");
-   net_http_send_str(&conn->sock_state, &error, conn->domain);
+   net_http_req_str(state, &error, "Host: ");
+   net_http_req_str(state, &error, conn->domain);
 
    if (!conn->port)
    {
@@ -722,17 +873,38 @@ struct http_t *net_http_new(struct http_connection_t *conn)
       portstr[0] = '\0';
 
       snprintf(portstr, sizeof(portstr), ":%i", conn->port);
-      net_http_send_str(&conn->sock_state, &error, portstr);
+      net_http_req_str(state, &error, portstr);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+   net_http_req_str(state, &error, "\r\n");
+
+   if (conn->rangecopy)
+   {
+      net_http_req_str(state, &error, "Range: bytes=");
+      net_http_req_str(state, &error, conn->rangecopy);
+      net_http_req_str(state, &error, "\r\n");
+   }
+
+   if (conn->ifnonematchcopy)
+   {
+      net_http_req_str(state, &error, "If-None-Match: ");
+      net_http_req_str(state, &error, conn->ifnonematchcopy);
+      net_http_req_str(state, &error, "\r\n");
+   }
+
+   if (conn->ifmodifiedsincecopy)
+   {
+      net_http_req_str(state, &error, "If-Modified-Since: ");
+      net_http_req_str(state, &error, conn->ifmodifiedsincecopy);
+      net_http_req_str(state, &error, "\r\n");
+   }
 
    /* This is not being set anywhere yet */
    if (conn->contenttypecopy)
    {
-      net_http_send_str(&conn->sock_state, &error, "Content-Type: ");
-      net_http_send_str(&conn->sock_state, &error, conn->contenttypecopy);
-      net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_req_str(state, &error, "Content-Type: ");
+      net_http_req_str(state, &error, conn->contenttypecopy);
+      net_http_req_str(state, &error, "\r\n");
    }
 
    if (conn->methodcopy && (string_is_equal(conn->methodcopy, "POST")))
@@ -744,10 +916,10 @@ struct http_t *net_http_new(struct http_connection_t *conn)
          goto error;
 
       if (!conn->contenttypecopy)
-         net_http_send_str(&conn->sock_state, &error,
+         net_http_req_str(state, &error,
                "Content-Type: application/x-www-form-urlencoded\r\n");
 
-      net_http_send_str(&conn->sock_state, &error, "Content-Length: ");
+      net_http_req_str(state, &error, "Content-Length: ");
 
       post_len = strlen(conn->postdatacopy);
 #ifdef _WIN32
@@ -762,41 +934,36 @@ struct http_t *net_http_new(struct http_connection_t *conn)
 
       len_str[len] = '\0';
 
-      net_http_send_str(&conn->sock_state, &error, len_str);
-      net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_req_str(state, &error, len_str);
+      net_http_req_str(state, &error, "\r\n");
 
       free(len_str);
    }
 
-   net_http_send_str(&conn->sock_state, &error, "User-Agent: ");
+   net_http_req_str(state, &error, "User-Agent: ");
    if (conn->useragentcopy)
-      net_http_send_str(&conn->sock_state, &error, conn->useragentcopy);
+      net_http_req_str(state, &error, conn->useragentcopy);
    else
-      net_http_send_str(&conn->sock_state, &error, "libretro");
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+      net_http_req_str(state, &error, "libretro");
+   net_http_req_str(state, &error, "\r\n");
 
-   net_http_send_str(&conn->sock_state, &error, "Connection: close\r\n");
-   net_http_send_str(&conn->sock_state, &error, "\r\n");
+   net_http_req_str(state, &error, "Connection: close\r\n");
+   net_http_req_str(state, &error, "\r\n");
 
    if (conn->methodcopy && (string_is_equal(conn->methodcopy, "POST")))
-      net_http_send_str(&conn->sock_state, &error, conn->postdatacopy);
+      net_http_req_str(state, &error, conn->postdatacopy);
 
    if (error)
       goto error;
 
-   state             = (struct http_t*)malloc(sizeof(struct http_t));
-   state->sock_state = conn->sock_state;
-   state->status     = -1;
-   state->data       = NULL;
-   state->part       = P_HEADER_TOP;
-   state->bodytype   = T_FULL;
-   state->error      = false;
-   state->pos        = 0;
-   state->len        = 0;
-   state->buflen     = 512;
-   state->data       = (char*)malloc(state->buflen);
-
-   if (!state->data)
+   if (state->sock_state.connecting)
+   {
+      /* Connect still in flight; net_http_update() sends the request
+       * once the socket goes writable */
+      state->connect_deadline = time(NULL) +
+         NET_HTTP_CONNECT_TIMEOUT_SECONDS;
+   }
+   else if (!net_http_send_request(state))
       goto error;
 
    return state;
@@ -824,7 +991,13 @@ error:
       socket_close(fd);
 #endif
    if (state)
+   {
+      if (state->data)
+         free(state->data);
+      if (state->request)
+         free(state->request);
       free(state);
+   }
    return NULL;
 }
 
@@ -842,6 +1015,41 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
    if (!state || state->error)
       goto fail;
 
+#ifdef NET_HTTP_CONNECT_NONBLOCKING
+   if (state->sock_state.connecting)
+   {
+      fd_set wfds;
+      struct timeval tv = {0};
+      int so_error      = 0;
+      socklen_t so_len  = sizeof(so_error);
+
+      FD_ZERO(&wfds);
+      FD_SET(state->sock_state.fd, &wfds);
+
+      if (socket_select(state->sock_state.fd + 1,
+               NULL, &wfds, NULL, &tv) <= 0)
+      {
+         /* Still handshaking */
+         if (time(NULL) > state->connect_deadline)
+            goto fail;
+         if (progress)
+            *progress = 0;
+         if (total)
+            *total = 0;
+         return false;
+      }
+
+      if (getsockopt(state->sock_state.fd, SOL_SOCKET, SO_ERROR,
+               (char*)&so_error, &so_len) < 0 || so_error)
+         goto fail;
+
+      state->sock_state.connecting = false;
+
+      if (!net_http_send_request(state))
+         goto fail;
+   }
+#endif
+
    if (state->part < P_BODY)
    {
       if (state->error)
@@ -903,6 +1111,35 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
             if (string_is_equal(state->data, "Transfer-Encoding: chunked"))
                state->bodytype = T_CHUNK;
 
+            if (!strncmp(state->data, "ETag: ",
+                     STRLEN_CONST("ETag: ")))
+            {
+               if (state->etag)
+                  free(state->etag);
+               state->etag = strdup(state->data
+                     + STRLEN_CONST("ETag: "));
+            }
+
+            if (!strncmp(state->data, "Last-Modified: ",
+                     STRLEN_CONST("Last-Modified: ")))
+            {
+               if (state->last_modified)
+                  free(state->last_modified);
+               state->last_modified = strdup(state->data
+                     + STRLEN_CONST("Last-Modified: "));
+            }
+
+            /* "Content-Range: bytes 0-1023/146515" - the size after
+             * the slash is the complete resource */
+            if (!strncmp(state->data, "Content-Range: ",
+                     STRLEN_CONST("Content-Range: ")))
+            {
+               char *total_str = strchr(state->data, '/');
+
+               if (total_str && isdigit((int)total_str[1]))
+                  state->range_total = strtoul(total_str + 1, NULL, 10);
+            }
+
             /* TODO: save headers somewhere */
             if (state->data[0]=='\0')
             {
@@ -953,6 +1190,11 @@ bool net_http_update(struct http_t *state, size_t* progress, size_t* total)
                state->part = P_DONE;
                state->data = (char*)realloc(state->data, state->len);
             }
+            else if (state->bodytype == T_LEN && state->pos == state->len)
+               /* The complete body (notably the empty body of a
+                * 304 reply) was already received together with the
+                * headers; the peer closing is not an error */
+               state->part = P_DONE;
             else
                goto fail;
             newlen=0;
@@ -1072,6 +1314,27 @@ int net_http_status(struct http_t *state)
    return state->status;
 }
 
+size_t net_http_content_range_total(struct http_t *state)
+{
+   if (!state)
+      return 0;
+   return state->range_total;
+}
+
+const char *net_http_etag(struct http_t *state)
+{
+   if (!state)
+      return NULL;
+   return state->etag;
+}
+
+const char *net_http_last_modified(struct http_t *state)
+{
+   if (!state)
+      return NULL;
+   return state->last_modified;
+}
+
 uint8_t* net_http_data(struct http_t *state, size_t* len, bool accept_error)
 {
    if (!state)
@@ -1106,6 +1369,12 @@ void net_http_delete(struct http_t *state)
       }
 #endif
    }
+   if (state->request)
+      free(state->request);
+   if (state->etag)
+      free(state->etag);
+   if (state->last_modified)
+      free(state->last_modified);
    free(state);
 }
 
@@ -28,18 +28,31 @@
 #include <compat/strl.h>
 #include <compat/posix_string.h>
 
+/* All element storage lives in a pool allocated once at
+ * initialization; pushing and pulling messages never touches
+ * the allocator. The heap in 'elems' holds pointers into the
+ * pool, ordered by priority (insertion order among equals). */
+
 static bool msg_queue_initialize_internal(msg_queue_t *queue, size_t size)
 {
-   struct queue_elem **elems = (struct queue_elem**)calloc(size + 1,
-         sizeof(struct queue_elem*));
+   queue_elem_t **elems = (queue_elem_t**)calloc(size + 1,
+         sizeof(queue_elem_t*));
+   queue_elem_t *pool   = (queue_elem_t*)calloc(size + 1,
+         sizeof(queue_elem_t));
 
-   if (!elems)
+   if (!elems || !pool)
+   {
+      free(elems);
+      free(pool);
       return false;
+   }
 
-   queue->tmp_msg            = NULL;
+   queue->pool               = pool;
    queue->elems              = elems;
    queue->ptr                = 1;
    queue->size               = size + 1;
+   queue->seq                = 0;
+   queue->tmp_msg[0]         = '\0';
 
    return true;
 }
@@ -86,8 +99,8 @@ void msg_queue_free(msg_queue_t *queue)
 {
    if (!queue)
       return;
-   msg_queue_clear(queue);
    free(queue->elems);
+   free(queue->pool);
    free(queue);
 }
 
@@ -95,15 +108,92 @@ bool msg_queue_deinitialize(msg_queue_t *queue)
 {
    if (!queue)
       return false;
-   msg_queue_clear(queue);
    free(queue->elems);
-   queue->elems   = NULL;
-   queue->tmp_msg = NULL;
-   queue->ptr     = 0;
-   queue->size    = 0;
+   free(queue->pool);
+   queue->elems      = NULL;
+   queue->pool       = NULL;
+   queue->ptr        = 0;
+   queue->size       = 0;
+   queue->tmp_msg[0] = '\0';
    return true;
 }
 
+static queue_elem_t *msg_queue_pool_alloc(msg_queue_t *queue)
+{
+   size_t i;
+
+   for (i = 0; i < queue->size; i++)
+   {
+      if (!queue->pool[i].used)
+      {
+         queue->pool[i].used = true;
+         return &queue->pool[i];
+      }
+   }
+
+   return NULL;
+}
+
+static void msg_queue_sift_up(msg_queue_t *queue, size_t tmp_ptr)
+{
+   while (tmp_ptr > 1)
+   {
+      queue_elem_t *parent       = queue->elems[tmp_ptr >> 1];
+      queue_elem_t *child        = queue->elems[tmp_ptr];
+
+      if (child->prio <= parent->prio)
+         break;
+
+      queue->elems[tmp_ptr >> 1] = child;
+      queue->elems[tmp_ptr]      = parent;
+
+      tmp_ptr >>= 1;
+   }
+}
+
+static void msg_queue_sift_down(msg_queue_t *queue, size_t tmp_ptr)
+{
+   size_t last = queue->ptr - 1; /* elements occupy 1..last */
+
+   for (;;)
+   {
+      queue_elem_t *tmp;
+      size_t left    = tmp_ptr * 2;
+      size_t right   = left + 1;
+      size_t largest = tmp_ptr;
+
+      if (left <= last &&
+            queue->elems[left]->prio > queue->elems[largest]->prio)
+         largest = left;
+      if (right <= last &&
+            queue->elems[right]->prio > queue->elems[largest]->prio)
+         largest = right;
+
+      if (largest == tmp_ptr)
+         break;
+
+      tmp                   = queue->elems[tmp_ptr];
+      queue->elems[tmp_ptr] = queue->elems[largest];
+      queue->elems[largest] = tmp;
+      tmp_ptr               = largest;
+   }
+}
+
+/* Removes the element at heap index idx and returns its
+ * storage to the pool */
+static void msg_queue_remove_at(msg_queue_t *queue, size_t idx)
+{
+   queue->elems[idx]->used = false;
+   queue->elems[idx]       = queue->elems[--queue->ptr];
+   queue->elems[queue->ptr] = NULL;
+
+   if (idx < queue->ptr)
+   {
+      msg_queue_sift_up(queue, idx);
+      msg_queue_sift_down(queue, idx);
+   }
+}
+
 /**
  * msg_queue_push:
  * @queue             : pointer to queue object
@@ -120,41 +210,48 @@ void msg_queue_push(msg_queue_t *queue, const char *msg,
       char *title,
       enum message_queue_icon icon, enum message_queue_category category)
 {
-   size_t tmp_ptr = 0;
-   struct queue_elem *new_elem = NULL;
+   queue_elem_t *new_elem = NULL;
 
-   if (!queue || queue->ptr >= queue->size)
+   if (!queue || !queue->elems)
       return;
 
-   new_elem                      = (struct queue_elem*)malloc(
-      sizeof(struct queue_elem));
-   if (!new_elem)
+   if (queue->ptr >= queue->size)
+   {
+      /* Queue full - evict the lowest priority element, oldest
+       * first among equals, so fresh messages keep flowing
+       * instead of being dropped on the floor. */
+      size_t i;
+      size_t victim = 1;
+
+      for (i = 2; i < queue->ptr; i++)
+      {
+         if (  queue->elems[i]->prio <  queue->elems[victim]->prio ||
+              (queue->elems[i]->prio == queue->elems[victim]->prio &&
+               queue->elems[i]->seq  <  queue->elems[victim]->seq))
+            victim = i;
+      }
+
+      msg_queue_remove_at(queue, victim);
+   }
+
+   if (!(new_elem = msg_queue_pool_alloc(queue)))
       return;
 
    new_elem->duration            = duration;
    new_elem->prio                = prio;
-   new_elem->msg                 = msg   ? strdup(msg)   : NULL;
-   new_elem->title               = title ? strdup(title) : NULL;
+   new_elem->seq                 = queue->seq++;
    new_elem->icon                = icon;
    new_elem->category            = category;
+   new_elem->msg[0]              = '\0';
+   new_elem->title[0]            = '\0';
 
-   queue->elems[queue->ptr]      = new_elem;
-
-   tmp_ptr                       = queue->ptr++;
+   if (msg)
+      strlcpy(new_elem->msg, msg, sizeof(new_elem->msg));
+   if (title)
+      strlcpy(new_elem->title, title, sizeof(new_elem->title));
 
-   while (tmp_ptr > 1)
-   {
-      struct queue_elem *parent  = queue->elems[tmp_ptr >> 1];
-      struct queue_elem *child   = queue->elems[tmp_ptr];
-
-      if (child->prio <= parent->prio)
-         break;
-
-      queue->elems[tmp_ptr >> 1] = child;
-      queue->elems[tmp_ptr]      = parent;
-
-      tmp_ptr >>= 1;
-   }
+   queue->elems[queue->ptr]      = new_elem;
+   msg_queue_sift_up(queue, queue->ptr++);
 }
 
 /**
@@ -174,15 +271,13 @@ void msg_queue_clear(msg_queue_t *queue)
    {
       if (queue->elems[i])
       {
-         free(queue->elems[i]->msg);
-         free(queue->elems[i]->title);
-         free(queue->elems[i]);
-         queue->elems[i] = NULL;
+         queue->elems[i]->used = false;
+         queue->elems[i]       = NULL;
       }
    }
-   queue->ptr = 1;
-   free(queue->tmp_msg);
-   queue->tmp_msg = NULL;
+   queue->ptr        = 1;
+   queue->seq        = 0;
+   queue->tmp_msg[0] = '\0';
 }
 
 /**
@@ -196,61 +291,22 @@ void msg_queue_clear(msg_queue_t *queue)
  **/
 const char *msg_queue_pull(msg_queue_t *queue)
 {
-   struct queue_elem *front  = NULL, *last = NULL;
-   size_t tmp_ptr = 1;
-
-   (void)tmp_ptr;
+   queue_elem_t *front = NULL;
 
    /* Nothing in queue. */
    if (!queue || queue->ptr == 1)
       return NULL;
 
-   front = (struct queue_elem*)queue->elems[1];
+   front = queue->elems[1];
    front->duration--;
    if (front->duration > 0)
       return front->msg;
 
-   free(queue->tmp_msg);
-   queue->tmp_msg = front->msg;
-   front->msg = NULL;
-
-   last  = (struct queue_elem*)queue->elems[--queue->ptr];
-   queue->elems[1] = last;
-   free(front->title);
-   free(front);
-
-   for (;;)
-   {
-      struct queue_elem *parent = NULL;
-      struct queue_elem *child  = NULL;
-      size_t switch_index       = tmp_ptr;
-      bool left                 = (tmp_ptr * 2 <= queue->ptr)
-         && (queue->elems[tmp_ptr] < queue->elems[tmp_ptr * 2]);
-      bool right                = (tmp_ptr * 2 + 1 <= queue->ptr)
-         && (queue->elems[tmp_ptr] < queue->elems[tmp_ptr * 2 + 1]);
-
-      if (!left && !right)
-         break;
-
-      if (left && !right)
-         switch_index <<= 1;
-      else if (right && !left)
-         switch_index += switch_index + 1;
-      else
-      {
-         if (queue->elems[tmp_ptr * 2]
-               >= queue->elems[tmp_ptr * 2 + 1])
-            switch_index <<= 1;
-         else
-            switch_index += switch_index + 1;
-      }
+   /* The element goes back to the pool now - keep the text in
+    * the queue's own buffer until the next expired pull. */
+   strlcpy(queue->tmp_msg, front->msg, sizeof(queue->tmp_msg));
 
-      parent = (struct queue_elem*)queue->elems[tmp_ptr];
-      child  = (struct queue_elem*)queue->elems[switch_index];
-      queue->elems[tmp_ptr]      = child;
-      queue->elems[switch_index] = parent;
-      tmp_ptr                    = switch_index;
-   }
+   msg_queue_remove_at(queue, 1);
 
    return queue->tmp_msg;
 }
@@ -267,69 +323,25 @@ const char *msg_queue_pull(msg_queue_t *queue)
  **/
 bool msg_queue_extract(msg_queue_t *queue, msg_queue_entry_t *queue_entry)
 {
-   struct queue_elem *front  = NULL, *last = NULL;
-   size_t tmp_ptr = 1;
+   queue_elem_t *front = NULL;
 
    /* Ensure arguments are valid and queue is not
     * empty */
    if (!queue || queue->ptr == 1 || !queue_entry)
       return false;
 
-   front = (struct queue_elem*)queue->elems[1];
-   last  = (struct queue_elem*)queue->elems[--queue->ptr];
-   queue->elems[1] = last;
+   front = queue->elems[1];
 
    /* Copy element parameters */
    queue_entry->duration = front->duration;
    queue_entry->prio     = front->prio;
    queue_entry->icon     = front->icon;
    queue_entry->category = front->category;
-   queue_entry->msg[0]   = '\0';
-   queue_entry->title[0] = '\0';
 
-   if (front->msg)
-      strlcpy(queue_entry->msg, front->msg, sizeof(queue_entry->msg));
+   strlcpy(queue_entry->msg, front->msg, sizeof(queue_entry->msg));
+   strlcpy(queue_entry->title, front->title, sizeof(queue_entry->title));
 
-   if (front->title)
-      strlcpy(queue_entry->title, front->title, sizeof(queue_entry->title));
-
-   /* Delete element */
-   free(front->msg);
-   free(front->title);
-   free(front);
-
-   for (;;)
-   {
-      struct queue_elem *parent = NULL;
-      struct queue_elem *child  = NULL;
-      size_t switch_index       = tmp_ptr;
-      bool left                 = (tmp_ptr * 2 <= queue->ptr)
-         && (queue->elems[tmp_ptr] < queue->elems[tmp_ptr * 2]);
-      bool right                = (tmp_ptr * 2 + 1 <= queue->ptr)
-         && (queue->elems[tmp_ptr] < queue->elems[tmp_ptr * 2 + 1]);
-
-      if (!left && !right)
-         break;
-
-      if (left && !right)
-         switch_index <<= 1;
-      else if (right && !left)
-         switch_index += switch_index + 1;
-      else
-      {
-         if (queue->elems[tmp_ptr * 2]
-               >= queue->elems[tmp_ptr * 2 + 1])
-            switch_index <<= 1;
-         else
-            switch_index += switch_index + 1;
-      }
-
-      parent = (struct queue_elem*)queue->elems[tmp_ptr];
-      child  = (struct queue_elem*)queue->elems[switch_index];
-      queue->elems[tmp_ptr]      = child;
-      queue->elems[switch_index] = parent;
-      tmp_ptr                    = switch_index;
-   }
+   msg_queue_remove_at(queue, 1);
 
    return true;
 }
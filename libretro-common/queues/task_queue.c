@@ -64,15 +64,21 @@ static task_queue_t tasks_finished          = {NULL, NULL};
 
 static struct retro_task_impl *impl_current = NULL;
 static bool task_threaded_enable            = false;
+static retro_task_queue_trace_t task_trace  = NULL;
 
 #ifdef HAVE_THREADS
+/* Upper bound on worker threads - tasks are mostly I/O bound
+ * state machines, more threads only add wakeups */
+#define TASK_QUEUE_MAX_WORKERS 4
+
 static slock_t *running_lock                = NULL;
 static slock_t *finished_lock               = NULL;
 static slock_t *property_lock               = NULL;
 static slock_t *queue_lock                  = NULL;
 static scond_t *worker_cond                 = NULL;
-static sthread_t *worker_thread             = NULL;
-static bool worker_continue                 = true; 
+static sthread_t *worker_threads[TASK_QUEUE_MAX_WORKERS];
+static unsigned worker_thread_count         = 0;
+static bool worker_continue                 = true;
 /* use running_lock when touching it */
 #endif
 
@@ -219,8 +225,14 @@ static void retro_task_regular_gather(void)
 
       if (!task->when || task->when < cpu_features_get_time_usec())
       {
+         if (task_trace)
+            task_trace(task, true);
+
          task->handler(task);
 
+         if (task_trace)
+            task_trace(task, false);
+
          task_queue_push_progress(task);
       }
 
@@ -481,31 +493,60 @@ static void threaded_worker(void *userdata)
 
       slock_lock(running_lock);
 
-      /* Get first task to run */
-      task = tasks_running.front;
-      if (!task)
       {
-         scond_wait(worker_cond, running_lock);
-         slock_unlock(running_lock);
-         continue;
-      }
+         /* Get first due task no other worker is
+          * already handling */
+         retro_time_t now      = cpu_features_get_time_usec();
+         retro_time_t min_when = 0;
+         retro_task_t *t       = NULL;
 
-      if (task->when)
-      {
-         retro_time_t now   = cpu_features_get_time_usec();
-         retro_time_t delay = task->when - now - 500; /* allow half a millisecond for context switching */
-         if (delay > 0)
+         for (t = tasks_running.front; t; t = t->next)
+         {
+            if (t->in_worker)
+               continue;
+
+            /* allow half a millisecond for context switching */
+            if (t->when && t->when > now + 500)
+            {
+               /* Scheduled for later - remember the earliest
+                * deadline in case nothing is due right now */
+               if (!min_when || t->when < min_when)
+                  min_when = t->when;
+               continue;
+            }
+
+            /* Among due tasks, prefer the higher scheduling
+             * class; FIFO order breaks ties within a class */
+            if (!task || t->priority > task->priority)
+               task = t;
+            if (task->priority == TASK_PRIORITY_LATENCY_CRITICAL)
+               break;
+         }
+
+         if (!task)
          {
-            scond_wait_timeout(worker_cond, running_lock, delay);
+            if (min_when)
+               scond_wait_timeout(worker_cond, running_lock,
+                     min_when - now - 500);
+            else
+               scond_wait(worker_cond, running_lock);
             slock_unlock(running_lock);
             continue;
          }
+
+         task->in_worker = true;
       }
 
       slock_unlock(running_lock);
 
+      if (task_trace)
+         task_trace(task, true);
+
       task->handler(task);
 
+      if (task_trace)
+         task_trace(task, false);
+
       slock_lock(property_lock);
       finished = task->finished;
       slock_unlock(property_lock);
@@ -514,18 +555,20 @@ static void threaded_worker(void *userdata)
       if (!finished)
       {
          /* Move the task to the back of the queue */
-         /* mimics retro_task_threaded_push_running, 
+         /* mimics retro_task_threaded_push_running,
           * but also includes a task_queue_remove */
          slock_lock(running_lock);
          slock_lock(queue_lock);
 
+         task->in_worker = false;
+
          /* do nothing if only item in queue */
-         if (task->next) 
+         if (task->next)
          {
             task_queue_remove(&tasks_running, task);
             task_queue_put(&tasks_running, task);
-            scond_signal(worker_cond);
          }
+         scond_signal(worker_cond);
          slock_unlock(queue_lock);
          slock_unlock(running_lock);
       }
@@ -534,6 +577,7 @@ static void threaded_worker(void *userdata)
          /* Remove task from running queue */
          slock_lock(running_lock);
          slock_lock(queue_lock);
+         task->in_worker = false;
          task_queue_remove(&tasks_running, task);
          slock_unlock(queue_lock);
          slock_unlock(running_lock);
@@ -548,6 +592,9 @@ static void threaded_worker(void *userdata)
 
 static void retro_task_threaded_init(void)
 {
+   unsigned i;
+   unsigned cores  = cpu_features_get_core_amount();
+
    running_lock    = slock_new();
    finished_lock   = slock_new();
    property_lock   = slock_new();
@@ -558,17 +605,36 @@ static void retro_task_threaded_init(void)
    worker_continue = true;
    slock_unlock(running_lock);
 
-   worker_thread   = sthread_create(threaded_worker, NULL);
+   /* One worker per core, up to the cap, so independent
+    * tasks (image decode, http, database scan) no longer
+    * serialise behind each other */
+   worker_thread_count = cores;
+   if (worker_thread_count > TASK_QUEUE_MAX_WORKERS)
+      worker_thread_count = TASK_QUEUE_MAX_WORKERS;
+   if (worker_thread_count < 1)
+      worker_thread_count = 1;
+
+   for (i = 0; i < worker_thread_count; i++)
+      worker_threads[i] = sthread_create_with_class(threaded_worker,
+            NULL, "retroarch-task", STHREAD_CLASS_BACKGROUND);
 }
 
 static void retro_task_threaded_deinit(void)
 {
+   unsigned i;
+
    slock_lock(running_lock);
    worker_continue = false;
-   scond_signal(worker_cond);
+   scond_broadcast(worker_cond);
    slock_unlock(running_lock);
 
-   sthread_join(worker_thread);
+   for (i = 0; i < worker_thread_count; i++)
+   {
+      if (worker_threads[i])
+         sthread_join(worker_threads[i]);
+      worker_threads[i] = NULL;
+   }
+   worker_thread_count = 0;
 
    scond_free(worker_cond);
    slock_free(running_lock);
@@ -576,7 +642,6 @@ static void retro_task_threaded_deinit(void)
    slock_free(property_lock);
    slock_free(queue_lock);
 
-   worker_thread   = NULL;
    worker_cond     = NULL;
    running_lock    = NULL;
    finished_lock   = NULL;
@@ -627,6 +692,11 @@ void task_queue_init(bool threaded, retro_task_queue_msg_t msg_push)
    impl_current->init();
 }
 
+void task_queue_set_trace(retro_task_queue_trace_t trace)
+{
+   task_trace = trace;
+}
+
 void task_queue_set_threaded(void)
 {
    task_threaded_enable = true;
@@ -908,6 +978,8 @@ retro_task_t *task_init(void)
    task->progress_cb       = NULL;
    task->title             = NULL;
    task->type              = TASK_TYPE_NONE;
+   task->priority          = TASK_PRIORITY_INTERACTIVE;
+   task->in_worker         = false;
    task->ident             = task_count++;
    task->frontend_userdata = NULL;
    task->alternative_look  = false;
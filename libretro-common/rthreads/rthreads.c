@@ -20,6 +20,11 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* For pthread_setname_np, pthread_setaffinity_np and cpu_set_t. */
+#define _GNU_SOURCE
+#endif
+
 #ifdef __unix__
 #ifndef __sun__
 #define _POSIX_C_SOURCE 199309
@@ -30,6 +35,7 @@
 #include <string.h>
 
 #include <boolean.h>
+#include <compat/strl.h>
 #include <rthreads/rthreads.h>
 
 /* with RETRO_WIN32_USE_PTHREADS, pthreads can be used even on win32. Maybe only supported in MSVC>=2005  */
@@ -67,10 +73,24 @@
 #include <mach/mach.h>
 #endif
 
+#if defined(__linux__) && !defined(ANDROID) && !defined(__ANDROID__)
+#define HAVE_THREAD_CLASS_LINUX
+#include <stdio.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/resource.h>
+#endif
+
+/* Thread names are limited to 15 characters
+ * plus the terminator on Linux. */
+#define STHREAD_NAME_LEN 16
+
 struct thread_data
 {
    void (*func)(void*);
    void *userdata;
+   enum sthread_class thread_class;
+   char name[STHREAD_NAME_LEN];
 };
 
 struct sthread
@@ -134,6 +154,104 @@ struct scond
 #endif
 };
 
+#ifdef HAVE_THREAD_CLASS_LINUX
+/* Builds the set of CPUs whose maximum cpufreq matches the fastest
+ * core in the system. On asymmetric (big.LITTLE / hybrid) CPUs this
+ * selects the fast cluster; on symmetric CPUs it selects everything,
+ * making the affinity call a no-op. */
+static void sthread_fast_cpu_mask(cpu_set_t *set)
+{
+   unsigned long freqs[64];
+   unsigned long max_freq = 0;
+   long i;
+   long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+   if (num_cpus > 64)
+      num_cpus = 64;
+
+   for (i = 0; i < num_cpus; i++)
+   {
+      char path[128];
+      FILE *file;
+      unsigned long freq = 0;
+
+      snprintf(path, sizeof(path),
+            "/sys/devices/system/cpu/cpu%ld/cpufreq/cpuinfo_max_freq", i);
+
+      if ((file = fopen(path, "r")))
+      {
+         if (fscanf(file, "%lu", &freq) != 1)
+            freq = 0;
+         fclose(file);
+      }
+
+      freqs[i] = freq;
+      if (freq > max_freq)
+         max_freq = freq;
+   }
+
+   CPU_ZERO(set);
+
+   for (i = 0; i < num_cpus; i++)
+   {
+      /* No cpufreq information - assume symmetric cores. */
+      if (max_freq == 0 || freqs[i] == max_freq)
+         CPU_SET(i, set);
+   }
+}
+#endif
+
+/* Applies name, priority and affinity hints from the calling thread
+ * itself. Everything here is best-effort: elevated scheduling classes
+ * are commonly refused for unprivileged processes, in which case the
+ * thread simply keeps its default priority. */
+static void sthread_apply_class(struct thread_data *data)
+{
+   if (data->name[0] != '\0')
+   {
+#if defined(HAVE_THREAD_CLASS_LINUX)
+      pthread_setname_np(pthread_self(), data->name);
+#elif defined(__APPLE__)
+      pthread_setname_np(data->name);
+#endif
+   }
+
+   switch (data->thread_class)
+   {
+      case STHREAD_CLASS_VIDEO:
+      case STHREAD_CLASS_AUDIO:
+#if defined(HAVE_THREAD_CLASS_LINUX)
+         {
+            cpu_set_t set;
+            struct sched_param sp;
+
+            sthread_fast_cpu_mask(&set);
+            if (CPU_COUNT(&set) > 0)
+               pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+            memset(&sp, 0, sizeof(sp));
+            sp.sched_priority = (data->thread_class == STHREAD_CLASS_AUDIO)
+               ? 10 : 8;
+            pthread_setschedparam(pthread_self(), SCHED_RR, &sp);
+         }
+#elif defined(USE_WIN32_THREADS) && !defined(_XBOX)
+         SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+         break;
+      case STHREAD_CLASS_BACKGROUND:
+#if defined(HAVE_THREAD_CLASS_LINUX)
+         /* On Linux, nice values are per-thread. */
+         setpriority(PRIO_PROCESS, 0, 10);
+#elif defined(USE_WIN32_THREADS) && !defined(_XBOX)
+         SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+         break;
+      case STHREAD_CLASS_DEFAULT:
+      default:
+         break;
+   }
+}
+
 #ifdef USE_WIN32_THREADS
 static DWORD CALLBACK thread_wrap(void *data_)
 #else
@@ -143,6 +261,7 @@ static void *thread_wrap(void *data_)
    struct thread_data *data = (struct thread_data*)data_;
    if (!data)
 	   return 0;
+   sthread_apply_class(data);
    data->func(data->userdata);
    free(data);
    return 0;
@@ -158,9 +277,14 @@ static void *thread_wrap(void *data_)
  *
  * Returns: pointer to new thread if successful, otherwise NULL.
  */
+static sthread_t *sthread_create_internal(
+      void (*thread_func)(void*), void *userdata, int thread_priority,
+      const char *name, enum sthread_class thread_class);
+
 sthread_t *sthread_create(void (*thread_func)(void*), void *userdata)
 {
-	return sthread_create_with_priority(thread_func, userdata, 0);
+   return sthread_create_internal(thread_func, userdata, 0,
+         NULL, STHREAD_CLASS_DEFAULT);
 }
 
 /* TODO/FIXME - this needs to be implemented for Switch/3DS */
@@ -184,6 +308,36 @@ sthread_t *sthread_create(void (*thread_func)(void*), void *userdata)
  * Returns: pointer to new thread if successful, otherwise NULL.
  */
 sthread_t *sthread_create_with_priority(void (*thread_func)(void*), void *userdata, int thread_priority)
+{
+   return sthread_create_internal(thread_func, userdata, thread_priority,
+         NULL, STHREAD_CLASS_DEFAULT);
+}
+
+/**
+ * sthread_create_with_class:
+ * @start_routine           : thread entry callback function
+ * @userdata                : pointer to userdata that will be made
+ *                            available in thread entry callback function
+ * @name                    : descriptive thread name, or NULL
+ * @thread_class            : placement hint from enum sthread_class
+ *
+ * Create a new thread with a placement hint. Name, priority and
+ * affinity are applied on a best-effort basis from the new thread
+ * itself; platforms without the corresponding controls simply get a
+ * default thread.
+ *
+ * Returns: pointer to new thread if successful, otherwise NULL.
+ */
+sthread_t *sthread_create_with_class(void (*thread_func)(void*),
+      void *userdata, const char *name, enum sthread_class thread_class)
+{
+   return sthread_create_internal(thread_func, userdata, 0,
+         name, thread_class);
+}
+
+static sthread_t *sthread_create_internal(
+      void (*thread_func)(void*), void *userdata, int thread_priority,
+      const char *name, enum sthread_class thread_class)
 {
 #ifdef HAVE_THREAD_ATTR
    pthread_attr_t thread_attr;
@@ -202,6 +356,10 @@ sthread_t *sthread_create_with_priority(void (*thread_func)(void*), void *userda
 
    data->func               = thread_func;
    data->userdata           = userdata;
+   data->thread_class       = thread_class;
+   data->name[0]            = '\0';
+   if (name)
+      strlcpy(data->name, name, sizeof(data->name));
 
 #ifdef USE_WIN32_THREADS
    thread->id               = 0;
@@ -31,23 +31,43 @@
 #include <libchdr/chd.h>
 #include <string/stdstring.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define SECTOR_SIZE 2352
 #define SUBCODE_SIZE 96
 #define TRACK_PAD 4
 
+/* Number of decompressed hunks kept around. Interleaved access
+ * patterns (alternating data/audio reads, seeks across a hunk
+ * boundary) thrash a single-hunk cache and pay for decompression
+ * on every switch */
+#define HUNK_CACHE_SIZE 8
+
+typedef struct hunk_cache_entry
+{
+   uint8_t *data;
+   /* Cached hunk number, -1 if the slot is empty */
+   int32_t num;
+   /* Value of the use counter when this hunk was last
+    * touched; the smallest value marks the LRU slot */
+   uint32_t age;
+} hunk_cache_entry_t;
+
 struct chdstream
 {
    chd_file *chd;
-   /* Loaded hunk */
-   uint8_t *hunkmem;
+   /* Decompressed hunk cache, LRU eviction */
+   hunk_cache_entry_t hunks[HUNK_CACHE_SIZE];
+   /* Monotonic use counter for LRU bookkeeping */
+   uint32_t hunk_uses;
    /* Byte offset where track data starts (after pregap) */
    size_t track_start;
    /* Byte offset where track data ends */
    size_t track_end;
    /* Byte offset of read cursor */
    size_t offset;
-   /* Loaded hunk number */
-   int32_t hunknum;
    /* Size of frame taken from each hunk */
    uint32_t frame_size;
    /* Offset of data within frame */
@@ -207,8 +227,8 @@ chdstream_find_track(chd_file *fd, int32_t track, metadata_t *meta)
 chdstream_t *chdstream_open(const char *path, int32_t track)
 {
    metadata_t meta;
+   size_t i;
    uint32_t pregap         = 0;
-   uint8_t *hunkmem        = NULL;
    const chd_header *hd    = NULL;
    chdstream_t *stream     = NULL;
    chd_file *chd           = NULL;
@@ -233,15 +253,23 @@ chdstream_t *chdstream_open(const char *path, int32_t track)
    stream->track_start     = 0;
    stream->track_end       = 0;
    stream->offset          = 0;
-   stream->hunkmem         = NULL;
-   stream->hunknum         = -1;
+   stream->hunk_uses       = 0;
+
+   for (i = 0; i < HUNK_CACHE_SIZE; i++)
+   {
+      stream->hunks[i].data = NULL;
+      stream->hunks[i].num  = -1;
+      stream->hunks[i].age  = 0;
+   }
 
    hd                      = chd_get_header(chd);
-   hunkmem                 = (uint8_t*)malloc(hd->hunkbytes);
-   if (!hunkmem)
-      goto error;
 
-   stream->hunkmem         = hunkmem;
+   for (i = 0; i < HUNK_CACHE_SIZE; i++)
+   {
+      stream->hunks[i].data = (uint8_t*)malloc(hd->hunkbytes);
+      if (!stream->hunks[i].data)
+         goto error;
+   }
 
    if (string_is_equal(meta.type, "MODE1_RAW"))
       stream->frame_size   = SECTOR_SIZE;
@@ -280,38 +308,74 @@ error:
 
 void chdstream_close(chdstream_t *stream)
 {
+   size_t i;
+
    if (!stream)
       return;
 
-   if (stream->hunkmem)
-      free(stream->hunkmem);
+   for (i = 0; i < HUNK_CACHE_SIZE; i++)
+      if (stream->hunks[i].data)
+         free(stream->hunks[i].data);
    if (stream->chd)
       chd_close(stream->chd);
    free(stream);
 }
 
-static bool
+static void chdstream_swab_hunk(uint8_t *hunkmem, uint32_t hunkbytes)
+{
+   uint32_t i        = 0;
+   uint32_t count    = hunkbytes / 2;
+   uint16_t *array   = (uint16_t*)hunkmem;
+
+#if defined(__SSE2__)
+   /* Swap the bytes of eight 16-bit samples per iteration */
+   for (; i + 8 <= count; i += 8)
+   {
+      __m128i v = _mm_loadu_si128((__m128i*)(array + i));
+      v         = _mm_or_si128(
+            _mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+      _mm_storeu_si128((__m128i*)(array + i), v);
+   }
+#endif
+
+   for (; i < count; ++i)
+      array[i] = SWAP16(array[i]);
+}
+
+static uint8_t *
 chdstream_load_hunk(chdstream_t *stream, uint32_t hunknum)
 {
-   uint16_t *array;
+   size_t i;
+   hunk_cache_entry_t *slot = &stream->hunks[0];
 
-   if (hunknum == stream->hunknum)
-      return true;
+   for (i = 0; i < HUNK_CACHE_SIZE; i++)
+   {
+      hunk_cache_entry_t *hunk = &stream->hunks[i];
+
+      if (hunk->num == (int32_t)hunknum)
+      {
+         hunk->age = ++stream->hunk_uses;
+         return hunk->data;
+      }
 
-   if (chd_read(stream->chd, hunknum, stream->hunkmem) != CHDERR_NONE)
-      return false;
+      /* Remember the least recently used slot for eviction */
+      if (hunk->age < slot->age)
+         slot = hunk;
+   }
 
-   if (stream->swab)
+   if (chd_read(stream->chd, hunknum, slot->data) != CHDERR_NONE)
    {
-      uint32_t i;
-      uint32_t count = chd_get_header(stream->chd)->hunkbytes / 2;
-      array          = (uint16_t*)stream->hunkmem;
-      for (i = 0; i < count; ++i)
-         array[i] = SWAP16(array[i]);
+      slot->num = -1;
+      return NULL;
    }
 
-   stream->hunknum = hunknum;
-   return true;
+   if (stream->swab)
+      chdstream_swab_hunk(slot->data,
+            chd_get_header(stream->chd)->hunkbytes);
+
+   slot->num = (int32_t)hunknum;
+   slot->age = ++stream->hunk_uses;
+   return slot->data;
 }
 
 ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes)
@@ -342,14 +406,15 @@ ssize_t chdstream_read(chdstream_t *stream, void *data, size_t bytes)
          uint32_t chd_frame   = (uint32_t)(stream->track_frame +
             (stream->offset - stream->track_start) / stream->frame_size);
          uint32_t hunk        = chd_frame / stream->frames_per_hunk;
-         uint32_t hunk_offset = (chd_frame % stream->frames_per_hunk) 
+         uint32_t hunk_offset = (chd_frame % stream->frames_per_hunk)
             * hd->unitbytes;
+         uint8_t *hunkmem     = chdstream_load_hunk(stream, hunk);
 
-         if (!chdstream_load_hunk(stream, hunk))
+         if (!hunkmem)
             return -1;
 
          memcpy(out + data_offset,
-                stream->hunkmem + frame_offset
+                hunkmem + frame_offset
                 + hunk_offset + stream->frame_offset, amount);
       }
 
@@ -41,9 +41,21 @@
 
 #define VFS_ERROR_RETURN_VALUE -1
 
+/* Size of the user-space read buffer attached to read-only
+ * streams. Small sequential reads (config parsers, cue sheet
+ * readers, per-character access) are served from this buffer
+ * instead of generating one VFS call - and typically one
+ * syscall - per request. Requests of at least this size
+ * bypass the buffer entirely */
+#define FILESTREAM_READ_BUF_SIZE 4096
+
 struct RFILE
 {
    struct retro_vfs_file_handle *hfile;
+   uint8_t *buf;    /* read buffer, allocated on first small read */
+   size_t buf_len;  /* number of valid bytes in buf */
+   size_t buf_pos;  /* read offset into buf */
+   bool buffered;   /* stream was opened read-only */
 	bool error_flag;
 	bool eof_flag;
 };
@@ -185,6 +197,12 @@ RFILE* filestream_open(const char *path, unsigned mode, unsigned hints)
    output->error_flag = false;
    output->eof_flag   = false;
    output->hfile      = fp;
+   /* Only buffer plain read streams; interleaving a read
+    * buffer with writes is not worth the bookkeeping */
+   output->buffered   = (mode == RETRO_VFS_FILE_ACCESS_READ);
+   output->buf        = NULL;
+   output->buf_len    = 0;
+   output->buf_pos    = 0;
    return output;
 }
 
@@ -197,11 +215,35 @@ char* filestream_gets(RFILE *stream, char *s, size_t len)
 
    /* get max bytes or up to a newline */
 
-   for (len--; len > 0; len--)
+   for (len--; len > 0;)
    {
+      /* Scan the read buffer for a newline in one pass
+       * instead of pulling it out a character at a time */
+      if (stream->buf_pos < stream->buf_len)
+      {
+         size_t avail       = stream->buf_len - stream->buf_pos;
+         size_t n           = (avail < len) ? avail : len;
+         const uint8_t *src = stream->buf + stream->buf_pos;
+         const uint8_t *nl  = (const uint8_t*)memchr(src, '\n', n);
+
+         if (nl)
+            n               = (size_t)(nl - src) + 1;
+
+         memcpy(p, src, n);
+         stream->buf_pos   += n;
+         p                 += n;
+         len               -= n;
+         c                  = (unsigned char)p[-1];
+
+         if (nl)
+            break;
+         continue;
+      }
+
       if ((c = filestream_getc(stream)) == EOF)
          break;
       *p++ = c;
+      len--;
       if (c == '\n')
          break;
    }
@@ -337,6 +379,17 @@ int64_t filestream_seek(RFILE *stream, int64_t offset, int seek_position)
 {
    int64_t output;
 
+   /* The logical position trails the VFS position by however
+    * many buffered bytes are still unread - rebase relative
+    * seeks and drop the buffer */
+   if (stream->buf_len)
+   {
+      if (seek_position == RETRO_VFS_SEEK_POSITION_CURRENT)
+         offset         -= (int64_t)(stream->buf_len - stream->buf_pos);
+      stream->buf_len    = 0;
+      stream->buf_pos    = 0;
+   }
+
    if (filestream_seek_cb)
       output = filestream_seek_cb(stream->hfile, offset, seek_position);
    else
@@ -369,6 +422,8 @@ int64_t filestream_tell(RFILE *stream)
 
    if (output == VFS_ERROR_RETURN_VALUE)
       stream->error_flag = true;
+   else
+      output -= (int64_t)(stream->buf_len - stream->buf_pos);
 
    return output;
 }
@@ -382,15 +437,94 @@ void filestream_rewind(RFILE *stream)
    stream->eof_flag   = false;
 }
 
+static int64_t filestream_read_raw(RFILE *stream, void *s, int64_t len)
+{
+   if (filestream_read_cb)
+      return filestream_read_cb(stream->hfile, s, len);
+   return retro_vfs_file_read_impl(
+         (libretro_vfs_implementation_file*)stream->hfile, s, len);
+}
+
 int64_t filestream_read(RFILE *stream, void *s, int64_t len)
 {
    int64_t output;
 
-   if (filestream_read_cb)
-      output = filestream_read_cb(stream->hfile, s, len);
-   else
-      output = retro_vfs_file_read_impl(
-            (libretro_vfs_implementation_file*)stream->hfile, s, len);
+   if (stream->buffered && len > 0)
+   {
+      uint8_t *dst   = (uint8_t*)s;
+      int64_t copied = 0;
+      size_t avail   = stream->buf_len - stream->buf_pos;
+
+      /* Serve as much as possible from the buffer */
+      if (avail)
+      {
+         size_t n = ((int64_t)avail < len) ? avail : (size_t)len;
+         memcpy(dst, stream->buf + stream->buf_pos, n);
+         stream->buf_pos += n;
+         dst             += n;
+         copied          += (int64_t)n;
+      }
+
+      if (copied == len)
+         return copied;
+
+      if (len - copied < FILESTREAM_READ_BUF_SIZE)
+      {
+         if (!stream->buf)
+            stream->buf = (uint8_t*)malloc(FILESTREAM_READ_BUF_SIZE);
+
+         if (stream->buf)
+         {
+            /* Refill and serve the remainder from the new block */
+            size_t left = (size_t)(len - copied);
+            size_t n;
+
+            output = filestream_read_raw(stream, stream->buf,
+                  FILESTREAM_READ_BUF_SIZE);
+
+            if (output == VFS_ERROR_RETURN_VALUE)
+            {
+               stream->error_flag = true;
+               return copied ? copied : VFS_ERROR_RETURN_VALUE;
+            }
+
+            stream->buf_len = (size_t)output;
+            stream->buf_pos = 0;
+
+            n = (stream->buf_len < left) ? stream->buf_len : left;
+
+            if (n)
+            {
+               memcpy(dst, stream->buf, n);
+               stream->buf_pos += n;
+               copied          += (int64_t)n;
+            }
+
+            if (copied < len)
+               stream->eof_flag = true;
+            return copied;
+         }
+         /* Allocation failed - fall through to a direct read */
+      }
+
+      /* Large requests (and OOM fallback) go straight to the
+       * VFS - bouncing them through the buffer would only add
+       * a memcpy */
+      output = filestream_read_raw(stream, dst, len - copied);
+
+      if (output == VFS_ERROR_RETURN_VALUE)
+      {
+         stream->error_flag = true;
+         return copied ? copied : VFS_ERROR_RETURN_VALUE;
+      }
+
+      copied += output;
+      if (copied < len)
+         stream->eof_flag = true;
+      return copied;
+   }
+
+   output = filestream_read_raw(stream, s, len);
 
    if (output == VFS_ERROR_RETURN_VALUE)
       stream->error_flag = true;
@@ -510,7 +644,11 @@ int filestream_close(RFILE *stream)
             (libretro_vfs_implementation_file*)fp);
 
    if (output == 0)
+   {
+      if (stream->buf)
+         free(stream->buf);
       free(stream);
+   }
 
    return output;
 }
@@ -648,6 +786,39 @@ char* filestream_getline(RFILE *stream)
       }
 
       newline[idx++] = in;
+
+      /* Copy whole buffered runs up to the next newline
+       * instead of one character per call */
+      if (stream->buf_pos < stream->buf_len)
+      {
+         size_t avail       = stream->buf_len - stream->buf_pos;
+         const uint8_t *src = stream->buf + stream->buf_pos;
+         const uint8_t *nl  = (const uint8_t*)memchr(src, '\n', avail);
+         size_t n           = nl ? (size_t)(nl - src) : avail;
+
+         if (n)
+         {
+            if (idx + n > cur_size)
+            {
+               while (idx + n > cur_size)
+                  cur_size *= 2;
+               newline_tmp  = (char*)realloc(newline, cur_size + 1);
+
+               if (!newline_tmp)
+               {
+                  free(newline);
+                  return NULL;
+               }
+
+               newline     = newline_tmp;
+            }
+
+            memcpy(newline + idx, src, n);
+            idx             += n;
+            stream->buf_pos += n;
+         }
+      }
+
       in             = filestream_getc(stream);
    }
 
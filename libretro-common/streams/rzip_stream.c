@@ -31,6 +31,16 @@
 /* Current RZIP file format version */
 #define RZIP_VERSION 1
 
+/* Format flags
+ * > Stored in the high bits of the header
+ *   version byte, so that legacy files
+ *   (plain zlib, no delta) remain readable
+ *   by old and new code alike */
+#define RZIP_VERSION_MASK 0x0F
+#define RZIP_FLAG_DELTA   0x20
+#define RZIP_FLAG_ZSTD    0x40
+#define RZIP_FLAG_MASK    (RZIP_FLAG_DELTA | RZIP_FLAG_ZSTD)
+
 /* Compression level
  * > zlib default of 6 provides the best
  *   balance between file size and
@@ -64,6 +74,15 @@ struct rzipstream
    uint32_t out_buf_ptr;
    uint32_t out_buf_occupancy;
    uint32_t chunk_size;
+   /* delta_buf: previous-state reference for
+    * delta (XOR) coded streams - borrowed,
+    * not owned */
+   const uint8_t *delta_buf;
+   uint64_t delta_buf_size;
+   /* chunk_offset: uncompressed offset of the
+    * chunk currently held in out_buf (read mode) */
+   uint64_t chunk_offset;
+   uint8_t format_flags;
    bool is_compressed;
    bool is_writing;
 };
@@ -105,10 +124,14 @@ static bool rzipstream_read_file_header(rzipstream_t *stream)
        (header_bytes[3] !=           73) || /* I */
        (header_bytes[4] !=           80) || /* P */
        (header_bytes[5] !=          118) || /* v */
-       (header_bytes[6] != RZIP_VERSION) || /* file format version number */
+       ((header_bytes[6] & RZIP_VERSION_MASK)
+                        != RZIP_VERSION) || /* file format version number */
        (header_bytes[7] !=           35))   /* # */
       goto file_uncompressed;
 
+   /* Extract format flags from version byte */
+   stream->format_flags = header_bytes[6] & RZIP_FLAG_MASK;
+
    /* Get uncompressed chunk size - next 4 bytes */
    stream->chunk_size = ((uint32_t)header_bytes[11] << 24) |
                         ((uint32_t)header_bytes[10] << 16) |
@@ -167,7 +190,8 @@ static bool rzipstream_write_file_header(rzipstream_t *stream)
    header_bytes[3]    =        73;    /* I */
    header_bytes[4]    =        80;    /* P */
    header_bytes[5]    =       118;    /* v */
-   header_bytes[6]    = RZIP_VERSION; /* file format version number */
+   header_bytes[6]    = RZIP_VERSION  /* file format version number */
+         | stream->format_flags;      /* + format flags */
    header_bytes[7]    =        35;    /* # */
 
    /* > Uncompressed chunk size - next 4 bytes */
@@ -203,7 +227,8 @@ static bool rzipstream_write_file_header(rzipstream_t *stream)
 /* Initialises all members of an rzipstream_t struct,
  * reading config from existing file header if available */
 static bool rzipstream_init_stream(
-      rzipstream_t *stream, const char *path, bool is_writing)
+      rzipstream_t *stream, const char *path, bool is_writing,
+      unsigned flags)
 {
    unsigned file_mode;
 
@@ -225,6 +250,10 @@ static bool rzipstream_init_stream(
    stream->out_buf_size      = 0;
    stream->out_buf_ptr       = 0;
    stream->out_buf_occupancy = 0;
+   stream->delta_buf         = NULL;
+   stream->delta_buf_size    = 0;
+   stream->chunk_offset      = 0;
+   stream->format_flags      = 0;
 
    /* Check whether this is a read or write stream */
    stream->is_writing = is_writing;
@@ -233,6 +262,16 @@ static bool rzipstream_init_stream(
       /* Written files are always compressed */
       stream->is_compressed = true;
       file_mode             = RETRO_VFS_FILE_ACCESS_WRITE;
+
+      /* Format flags are chosen by the writer
+       * (when reading, they are parsed from the
+       *  file header instead) */
+#ifdef HAVE_ZSTD
+      if (flags & RZIP_STREAM_FLAG_ZSTD)
+         stream->format_flags |= RZIP_FLAG_ZSTD;
+#endif
+      if (flags & RZIP_STREAM_FLAG_DELTA)
+         stream->format_flags |= RZIP_FLAG_DELTA;
    }
    /* For read files, must get compression status
     * from file itself... */
@@ -266,6 +305,11 @@ static bool rzipstream_init_stream(
    if (stream->is_writing)
    {
       /* Compression */
+#ifdef HAVE_ZSTD
+      if (stream->format_flags & RZIP_FLAG_ZSTD)
+         stream->deflate_backend = trans_stream_get_zstd_compress_backend();
+      else
+#endif
       stream->deflate_backend = trans_stream_get_zlib_deflate_backend();
       if (!stream->deflate_backend)
          return false;
@@ -301,7 +345,18 @@ static bool rzipstream_init_stream(
    else if (stream->is_compressed)
    {
       /* Decompression */
-      stream->inflate_backend = trans_stream_get_zlib_inflate_backend();
+      if (stream->format_flags & RZIP_FLAG_ZSTD)
+      {
+#ifdef HAVE_ZSTD
+         stream->inflate_backend = trans_stream_get_zstd_decompress_backend();
+#else
+         /* File requires a codec this build
+          * does not provide */
+         return false;
+#endif
+      }
+      else
+         stream->inflate_backend = trans_stream_get_zlib_inflate_backend();
       if (!stream->inflate_backend)
          return false;
 
@@ -397,7 +452,8 @@ static int rzipstream_free_stream(rzipstream_t *stream)
  *   or uncompressed data
  * Returns NULL if arguments are invalid, file
  * is invalid or an IO error occurs */
-rzipstream_t* rzipstream_open(const char *path, unsigned mode)
+rzipstream_t* rzipstream_open_ext(const char *path, unsigned mode,
+      unsigned flags)
 {
    rzipstream_t *stream = NULL;
 
@@ -436,11 +492,16 @@ rzipstream_t* rzipstream_open(const char *path, unsigned mode)
    stream->out_buf_size    = 0;
    stream->out_buf_ptr     = 0;
    stream->out_buf_occupancy = 0;
+   stream->delta_buf       = NULL;
+   stream->delta_buf_size  = 0;
+   stream->chunk_offset    = 0;
+   stream->format_flags    = 0;
 
    /* Initialise stream */
    if (!rzipstream_init_stream(
          stream, path,
-         (mode == RETRO_VFS_FILE_ACCESS_WRITE)))
+         (mode == RETRO_VFS_FILE_ACCESS_WRITE),
+         flags))
    {
       rzipstream_free_stream(stream);
       return NULL;
@@ -449,6 +510,65 @@ rzipstream_t* rzipstream_open(const char *path, unsigned mode)
    return stream;
 }
 
+rzipstream_t* rzipstream_open(const char *path, unsigned mode)
+{
+   return rzipstream_open_ext(path, mode, RZIP_STREAM_FLAG_NONE);
+}
+
+/* Assigns the previous-state reference buffer
+ * of a delta (XOR) coded stream.
+ * > Stream merely borrows the buffer; caller
+ *   retains ownership, and must ensure it
+ *   remains valid for the lifetime of the
+ *   stream
+ * > When writing, must be called before the
+ *   first rzipstream_write()
+ * > When reading, must be called before the
+ *   first rzipstream_read()
+ * Returns false if stream is invalid or not
+ * delta coded */
+bool rzipstream_set_delta(rzipstream_t *stream,
+      const void *data, uint64_t len)
+{
+   if (!stream || !data || (len == 0))
+      return false;
+
+   /* Writes opt in via RZIP_STREAM_FLAG_DELTA;
+    * reads detect the flag from the file header */
+   if (!(stream->format_flags & RZIP_FLAG_DELTA))
+      return false;
+
+   stream->delta_buf      = (const uint8_t*)data;
+   stream->delta_buf_size = len;
+   return true;
+}
+
+/* Delta Coding */
+
+/* XORs 'len' bytes at 'buf' against the delta
+ * reference buffer, starting at uncompressed
+ * offset 'offset'
+ * > Bytes beyond the end of the reference
+ *   buffer are passed through unmodified
+ *   (XOR with zero), keeping the transform
+ *   symmetric when stream and reference
+ *   sizes differ */
+static void rzipstream_apply_delta(rzipstream_t *stream,
+      uint8_t *buf, uint64_t offset, uint32_t len)
+{
+   uint64_t i;
+   const uint8_t *ref = stream->delta_buf;
+
+   if (offset >= stream->delta_buf_size)
+      return;
+
+   if (len > stream->delta_buf_size - offset)
+      len = (uint32_t)(stream->delta_buf_size - offset);
+
+   for (i = 0; i < len; i++)
+      buf[i] ^= ref[offset + i];
+}
+
 /* File Read */
 
 /* Reads and decompresses the next chunk of data
@@ -531,6 +651,19 @@ static bool rzipstream_read_chunk(rzipstream_t *stream)
        (inflate_written > stream->out_buf_size))
       return false;
 
+   /* If stream is delta coded, recover absolute
+    * data by XORing against the previous state */
+   if (stream->format_flags & RZIP_FLAG_DELTA)
+   {
+      /* Cannot decode without a reference buffer */
+      if (!stream->delta_buf)
+         return false;
+
+      rzipstream_apply_delta(stream, stream->out_buf,
+            stream->chunk_offset, inflate_written);
+   }
+   stream->chunk_offset     += inflate_written;
+
    /* Record current output buffer occupancy
     * and reset pointer */
    stream->out_buf_occupancy = inflate_written;
@@ -756,6 +889,20 @@ static bool rzipstream_write_chunk(rzipstream_t *stream)
    for (i = 0; i < RZIP_CHUNK_HEADER_SIZE; i++)
       chunk_header_bytes[i] = 0;
 
+   /* If stream is delta coded, XOR against the
+    * previous state before compression - unchanged
+    * regions collapse to runs of zeros, which
+    * compress to almost nothing */
+   if (stream->format_flags & RZIP_FLAG_DELTA)
+   {
+      /* Cannot encode without a reference buffer */
+      if (!stream->delta_buf)
+         return false;
+
+      rzipstream_apply_delta(stream, stream->in_buf,
+            stream->size - stream->in_buf_ptr, stream->in_buf_ptr);
+   }
+
    /* Compress data currently held in input buffer */
    stream->deflate_backend->set_in(
          stream->deflate_stream,
@@ -0,0 +1,290 @@
+/* Copyright  (C) 2010-2022 The RetroArch team
+ *
+ * ---------------------------------------------------------------------------------------
+ * The following license statement only applies to this file (trans_stream_zstd.c).
+ * ---------------------------------------------------------------------------------------
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef HAVE_ZSTD
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <zstd.h>
+#include <string/stdstring.h>
+#include <streams/trans_stream.h>
+
+/* Default compression level
+ * > zstd is fast enough that a mid-range level
+ *   still beats zlib on both speed and ratio */
+#define ZSTD_TRANS_DEFAULT_LEVEL 3
+
+struct zstd_trans_stream
+{
+   ZSTD_CStream *c;
+   ZSTD_DStream *d;
+   ZSTD_inBuffer in;
+   ZSTD_outBuffer out;
+   int level;
+};
+
+static void *zstd_compress_stream_new(void)
+{
+   struct zstd_trans_stream *ret = (struct zstd_trans_stream*)
+      calloc(1, sizeof(*ret));
+   if (!ret)
+      return NULL;
+   ret->level = ZSTD_TRANS_DEFAULT_LEVEL;
+   return (void *)ret;
+}
+
+static void *zstd_decompress_stream_new(void)
+{
+   struct zstd_trans_stream *ret = (struct zstd_trans_stream*)
+      calloc(1, sizeof(*ret));
+   if (!ret)
+      return NULL;
+   return (void *)ret;
+}
+
+static void zstd_compress_stream_free(void *data)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+   if (!z)
+      return;
+   if (z->c)
+      ZSTD_freeCStream(z->c);
+   free(z);
+}
+
+static void zstd_decompress_stream_free(void *data)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+   if (!z)
+      return;
+   if (z->d)
+      ZSTD_freeDStream(z->d);
+   free(z);
+}
+
+static bool zstd_compress_define(void *data, const char *prop, uint32_t val)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+   if (string_is_equal(prop, "level"))
+   {
+      if (z)
+         z->level = (int)val;
+      return true;
+   }
+   return false;
+}
+
+static bool zstd_decompress_define(void *data, const char *prop, uint32_t val)
+{
+   /* No decompression properties are required
+    * > Accept (and ignore) 'window_bits' so that
+    *   callers can treat this backend as a drop-in
+    *   replacement for zlib */
+   if (string_is_equal(prop, "window_bits"))
+      return true;
+   return false;
+}
+
+static void zstd_compress_set_in(void *data, const uint8_t *in, uint32_t in_size)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+
+   if (!z)
+      return;
+
+   z->in.src  = in;
+   z->in.size = in_size;
+   z->in.pos  = 0;
+
+   if (!z->c)
+   {
+      z->c = ZSTD_createCStream();
+      if (z->c)
+         ZSTD_initCStream(z->c, z->level);
+   }
+}
+
+static void zstd_decompress_set_in(void *data, const uint8_t *in, uint32_t in_size)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+
+   if (!z)
+      return;
+
+   z->in.src  = in;
+   z->in.size = in_size;
+   z->in.pos  = 0;
+
+   if (!z->d)
+   {
+      z->d = ZSTD_createDStream();
+      if (z->d)
+         ZSTD_initDStream(z->d);
+   }
+}
+
+static void zstd_set_out(void *data, uint8_t *out, uint32_t out_size)
+{
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+
+   if (!z)
+      return;
+
+   z->out.dst  = out;
+   z->out.size = out_size;
+   z->out.pos  = 0;
+}
+
+static bool zstd_compress_trans(
+      void *data, bool flush,
+      uint32_t *rd, uint32_t *wn,
+      enum trans_stream_error *error)
+{
+   size_t zret;
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+
+   if (!z || !z->c)
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_INVALID;
+      return false;
+   }
+
+   zret = ZSTD_compressStream2(z->c, &z->out, &z->in,
+         flush ? ZSTD_e_end : ZSTD_e_continue);
+
+   *rd = (uint32_t)z->in.pos;
+   *wn = (uint32_t)z->out.pos;
+
+   if (ZSTD_isError(zret))
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_OTHER;
+      return false;
+   }
+
+   if (flush && zret == 0)
+   {
+      /* Frame fully flushed - reset session so the
+       * stream object can be reused for the next chunk */
+      ZSTD_CCtx_reset(z->c, ZSTD_reset_session_only);
+      if (error)
+         *error = TRANS_STREAM_ERROR_NONE;
+      return true;
+   }
+
+   if (z->out.pos == z->out.size && z->in.pos < z->in.size)
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_BUFFER_FULL;
+      return false;
+   }
+
+   if (error)
+      *error = TRANS_STREAM_ERROR_AGAIN;
+   return true;
+}
+
+static bool zstd_decompress_trans(
+      void *data, bool flush,
+      uint32_t *rd, uint32_t *wn,
+      enum trans_stream_error *error)
+{
+   size_t zret;
+   struct zstd_trans_stream *z = (struct zstd_trans_stream *)data;
+
+   if (!z || !z->d)
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_INVALID;
+      return false;
+   }
+
+   zret = ZSTD_decompressStream(z->d, &z->out, &z->in);
+
+   *rd = (uint32_t)z->in.pos;
+   *wn = (uint32_t)z->out.pos;
+
+   if (ZSTD_isError(zret))
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_OTHER;
+      return false;
+   }
+
+   if (zret == 0)
+   {
+      /* Frame complete - reset session for reuse */
+      ZSTD_DCtx_reset(z->d, ZSTD_reset_session_only);
+      if (error)
+         *error = TRANS_STREAM_ERROR_NONE;
+      return true;
+   }
+
+   if (z->out.pos == z->out.size && z->in.pos < z->in.size)
+   {
+      if (error)
+         *error = TRANS_STREAM_ERROR_BUFFER_FULL;
+      return false;
+   }
+
+   if (error)
+      *error = TRANS_STREAM_ERROR_AGAIN;
+   return true;
+}
+
+const struct trans_stream_backend zstd_compress_backend =
+{
+   "zstd_compress",
+   &zstd_decompress_backend,
+   zstd_compress_stream_new,
+   zstd_compress_stream_free,
+   zstd_compress_define,
+   zstd_compress_set_in,
+   zstd_set_out,
+   zstd_compress_trans
+};
+
+const struct trans_stream_backend zstd_decompress_backend =
+{
+   "zstd_decompress",
+   &zstd_compress_backend,
+   zstd_decompress_stream_new,
+   zstd_decompress_stream_free,
+   zstd_decompress_define,
+   zstd_decompress_set_in,
+   zstd_set_out,
+   zstd_decompress_trans
+};
+
+const struct trans_stream_backend* trans_stream_get_zstd_compress_backend(void)
+{
+   return &zstd_compress_backend;
+}
+
+const struct trans_stream_backend* trans_stream_get_zstd_decompress_backend(void)
+{
+   return &zstd_decompress_backend;
+}
+
+#endif /* HAVE_ZSTD */
@@ -394,3 +394,54 @@ unsigned string_hex_to_unsigned(const char *str)
 
    return (unsigned)strtoul(hex_str, NULL, 16);
 }
+
+/* Appends 'src' to 's' at offset 'pos', always NUL-terminating
+ * within 'len' bytes. Returns the offset of the new terminator,
+ * so calls chain without rescanning the destination the way
+ * strlcat does. Together with the typed variants below this is
+ * a fast replacement for snprintf() on hot paths  */
+size_t string_append(char *s, size_t len, size_t pos, const char *src)
+{
+   if (!s || !src || pos >= len)
+      return pos;
+
+   while (*src && pos < len - 1)
+      s[pos++] = *src++;
+   s[pos] = '\0';
+
+   return pos;
+}
+
+/* Appends the decimal representation of 'value' to 's' at
+ * offset 'pos'. Equivalent to appending snprintf() "%u"  */
+size_t string_append_unsigned(char *s, size_t len, size_t pos,
+      unsigned value)
+{
+   char digits[16];
+   char *ptr = digits + sizeof(digits) - 1;
+
+   *ptr = '\0';
+   do
+   {
+      *--ptr = (char)('0' + (value % 10));
+      value /= 10;
+   } while (value);
+
+   return string_append(s, len, pos, ptr);
+}
+
+/* Appends the decimal representation of 'value' to 's' at
+ * offset 'pos'. Equivalent to appending snprintf() "%d"  */
+size_t string_append_signed(char *s, size_t len, size_t pos, int value)
+{
+   unsigned mag = (unsigned)value;
+
+   if (value < 0)
+   {
+      /* Two's complement safe for INT_MIN */
+      mag = (unsigned)(-(value + 1)) + 1;
+      pos = string_append(s, len, pos, "-");
+   }
+
+   return string_append_unsigned(s, len, pos, mag);
+}
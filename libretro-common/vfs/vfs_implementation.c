@@ -177,6 +177,10 @@
 #include <vfs/vfs_implementation_cdrom.h>
 #endif
 
+#ifdef HAVE_COMPRESSION
+#include <file/archive_file.h>
+#endif
+
 #if (defined(_POSIX_C_SOURCE) && (_POSIX_C_SOURCE - 0) >= 200112) || (defined(__POSIX_VISIBLE) && __POSIX_VISIBLE >= 200112) || (defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112) || __USE_LARGEFILE || (defined(_FILE_OFFSET_BITS) && _FILE_OFFSET_BITS == 64)
 #ifndef HAVE_64BIT_OFFSETS
 #define HAVE_64BIT_OFFSETS
@@ -192,6 +196,34 @@ int64_t retro_vfs_file_seek_internal(
    if (!stream)
       return -1;
 
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+   {
+      int64_t new_pos = stream->archive.pos;
+
+      switch (whence)
+      {
+         case SEEK_SET:
+            new_pos = offset;
+            break;
+         case SEEK_CUR:
+            new_pos = stream->archive.pos + offset;
+            break;
+         case SEEK_END:
+            new_pos = stream->archive.size + offset;
+            break;
+      }
+
+      /* Like a read-only file descriptor, allow the
+       * cursor to move past EOF but not below zero */
+      if (new_pos < 0)
+         return -1;
+
+      stream->archive.pos = new_pos;
+      return 0;
+   }
+#endif
+
    if ((stream->hints & RFILE_HINT_UNBUFFERED) == 0)
    {
 #ifdef HAVE_CDROM
@@ -305,6 +337,11 @@ libretro_vfs_implementation_file *retro_vfs_file_open_impl(
    stream->mapsize                = 0;
    stream->mapped                 = NULL;
    stream->scheme                 = VFS_SCHEME_NONE;
+#ifdef HAVE_COMPRESSION
+   stream->archive.data           = NULL;
+   stream->archive.size           = 0;
+   stream->archive.pos            = 0;
+#endif
 
 #ifdef VFS_FRONTEND
    if (path_len >= dumb_prefix_len)
@@ -338,6 +375,29 @@ libretro_vfs_implementation_file *retro_vfs_file_open_impl(
 
    stream->orig_path       = strdup(path);
 
+#ifdef HAVE_COMPRESSION
+   /* An archive member ("/path/to/file.zip#member") is exposed
+    * as a seekable read-only file by inflating the entry into
+    * memory, so callers (including cores going through the
+    * libretro VFS) can read it in place without a temporary
+    * extraction to disk */
+   if (     (mode == RETRO_VFS_FILE_ACCESS_READ)
+         && path_contains_compressed_file(path))
+   {
+      int64_t len = 0;
+
+      if (!file_archive_compressed_read(path,
+               (void**)&stream->archive.data, NULL, &len)
+            || (len < 0))
+         goto error;
+
+      stream->scheme       = VFS_SCHEME_ARCHIVE;
+      stream->archive.size = len;
+      stream->size         = len;
+      return stream;
+   }
+#endif
+
 #ifdef HAVE_MMAP
    if (stream->hints & RETRO_VFS_FILE_ACCESS_HINT_FREQUENT_ACCESS && mode == RETRO_VFS_FILE_ACCESS_READ)
       stream->hints |= RFILE_HINT_UNBUFFERED;
@@ -575,6 +635,10 @@ int retro_vfs_file_close_impl(libretro_vfs_implementation_file *stream)
 end:
    if (stream->cdrom.cue_buf)
       free(stream->cdrom.cue_buf);
+#endif
+#ifdef HAVE_COMPRESSION
+   if (stream->archive.data)
+      free(stream->archive.data);
 #endif
    if (stream->buf)
       free(stream->buf);
@@ -593,6 +657,10 @@ int retro_vfs_file_error_impl(libretro_vfs_implementation_file *stream)
    if (stream->scheme == VFS_SCHEME_CDROM)
       return retro_vfs_file_error_cdrom(stream);
 #endif
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+      return 0;
+#endif
 #ifdef ORBIS
    /* TODO/FIXME - implement this? */
    return 0;
@@ -613,6 +681,11 @@ int64_t retro_vfs_file_truncate_impl(libretro_vfs_implementation_file *stream, i
    if (!stream)
       return -1;
 
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+      return -1;
+#endif
+
 #ifdef _WIN32
    if (_chsize(_fileno(stream->fp), length) != 0)
       return -1;
@@ -629,6 +702,11 @@ int64_t retro_vfs_file_tell_impl(libretro_vfs_implementation_file *stream)
    if (!stream)
       return -1;
 
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+      return stream->archive.pos;
+#endif
+
    if ((stream->hints & RFILE_HINT_UNBUFFERED) == 0)
    {
 #ifdef HAVE_CDROM
@@ -692,6 +770,22 @@ int64_t retro_vfs_file_read_impl(libretro_vfs_implementation_file *stream,
    if (!stream || !s)
       return -1;
 
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+   {
+      if (stream->archive.pos >= stream->archive.size)
+         return 0;
+
+      if (stream->archive.pos + (int64_t)len > stream->archive.size)
+         len = stream->archive.size - stream->archive.pos;
+
+      memcpy(s, stream->archive.data + stream->archive.pos, (size_t)len);
+      stream->archive.pos += len;
+
+      return len;
+   }
+#endif
+
    if ((stream->hints & RFILE_HINT_UNBUFFERED) == 0)
    {
 #ifdef HAVE_CDROM
@@ -730,6 +824,11 @@ int64_t retro_vfs_file_write_impl(libretro_vfs_implementation_file *stream, cons
    if (!stream)
       return -1;
 
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+      return -1;
+#endif
+
    if ((stream->hints & RFILE_HINT_UNBUFFERED) == 0)
    {
 #ifdef ORBIS
@@ -752,6 +851,10 @@ int retro_vfs_file_flush_impl(libretro_vfs_implementation_file *stream)
 {
    if (!stream)
       return -1;
+#ifdef HAVE_COMPRESSION
+   if (stream->scheme == VFS_SCHEME_ARCHIVE)
+      return 0;
+#endif
 #ifdef ORBIS
    return 0;
 #else
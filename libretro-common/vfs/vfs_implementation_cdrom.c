@@ -20,12 +20,18 @@
 * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+#include <stdlib.h>
+
 #include <vfs/vfs_implementation.h>
 #include <file/file_path.h>
 #include <compat/fopen_utf8.h>
 #include <string/stdstring.h>
 #include <cdrom/cdrom.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #if defined(_WIN32) && !defined(_XBOX)
 #include <windows.h>
 #endif
@@ -33,6 +39,393 @@
 /* TODO/FIXME - static global variable */
 static cdrom_toc_t vfs_cdrom_toc = {0};
 
+/* Sector cache
+ * > Physical drives are read in chunk-aligned spans of
+ *   CDROM_CACHE_CHUNK_SECTORS sectors, so a small read
+ *   pulls its neighbourhood into memory and sequential
+ *   access rarely touches the drive again
+ * > With threads available, the chunks following each
+ *   served read are queued for a background worker that
+ *   fetches them in ascending-LBA (elevator) order while
+ *   the caller keeps running
+ * > Chunks are keyed by absolute LBA and shared by every
+ *   stream on the drive; the cache is flushed whenever a
+ *   cuesheet is opened, which is when the TOC (and thus
+ *   possibly the disc) changes */
+#define CDROM_CACHE_CHUNK_SECTORS    32
+#define CDROM_CACHE_CHUNK_BYTES      (CDROM_CACHE_CHUNK_SECTORS * 2352)
+#define CDROM_CACHE_DEFAULT_BYTES    (16 * 1024 * 1024)
+#define CDROM_CACHE_READAHEAD_CHUNKS 4
+#define CDROM_CACHE_QUEUE_LEN        8
+
+typedef struct
+{
+   uint8_t *data;      /* ptr alignment */
+   unsigned lba;       /* first sector held in this chunk */
+   unsigned size;      /* valid bytes in data */
+   unsigned last_used;
+   bool valid;
+} vfs_cdrom_cache_chunk_t;
+
+/* TODO/FIXME - static global variables */
+static vfs_cdrom_cache_chunk_t *vfs_cdrom_cache = NULL;
+static size_t vfs_cdrom_cache_chunks            = 0;
+static size_t vfs_cdrom_cache_bytes             = CDROM_CACHE_DEFAULT_BYTES;
+static unsigned vfs_cdrom_cache_counter         = 0;
+
+#ifdef HAVE_THREADS
+static slock_t *vfs_cdrom_cache_lock            = NULL;
+static scond_t *vfs_cdrom_cache_cond            = NULL;
+static sthread_t *vfs_cdrom_cache_thread        = NULL;
+static libretro_vfs_implementation_file
+      *vfs_cdrom_cache_stream                   = NULL;
+static unsigned vfs_cdrom_cache_queue[CDROM_CACHE_QUEUE_LEN];
+static size_t vfs_cdrom_cache_queue_len         = 0;
+static unsigned vfs_cdrom_cache_head_lba        = 0;
+static bool vfs_cdrom_cache_thread_stop         = false;
+#endif
+
+static void vfs_cdrom_cache_mutex_lock(void)
+{
+#ifdef HAVE_THREADS
+   if (!vfs_cdrom_cache_lock)
+      vfs_cdrom_cache_lock = slock_new();
+   if (vfs_cdrom_cache_lock)
+      slock_lock(vfs_cdrom_cache_lock);
+#endif
+}
+
+static void vfs_cdrom_cache_mutex_unlock(void)
+{
+#ifdef HAVE_THREADS
+   if (vfs_cdrom_cache_lock)
+      slock_unlock(vfs_cdrom_cache_lock);
+#endif
+}
+
+/* First sector past the end of the last track - reads and
+ * read-ahead must never cross it. */
+static unsigned vfs_cdrom_disc_end_lba(void)
+{
+   unsigned char i;
+   unsigned end = 0;
+
+   for (i = 0; i < vfs_cdrom_toc.num_tracks; i++)
+   {
+      unsigned track_end = vfs_cdrom_toc.track[i].lba_start
+            + vfs_cdrom_toc.track[i].track_size;
+      if (track_end > end)
+         end = track_end;
+   }
+
+   return end;
+}
+
+static vfs_cdrom_cache_chunk_t *vfs_cdrom_cache_find(unsigned lba)
+{
+   size_t i;
+
+   for (i = 0; i < vfs_cdrom_cache_chunks; i++)
+      if (vfs_cdrom_cache[i].valid && vfs_cdrom_cache[i].lba == lba)
+         return &vfs_cdrom_cache[i];
+
+   return NULL;
+}
+
+/* Fetches the chunk starting at lba into the cache (evicting
+ * the least recently used chunk if needed) and returns it.
+ * Caller holds the cache lock. */
+static vfs_cdrom_cache_chunk_t *vfs_cdrom_cache_fetch(
+      libretro_vfs_implementation_file *stream, unsigned lba)
+{
+   size_t i;
+   unsigned size;
+   unsigned char min           = 0;
+   unsigned char sec           = 0;
+   unsigned char frame         = 0;
+   unsigned end_lba            = vfs_cdrom_disc_end_lba();
+   vfs_cdrom_cache_chunk_t *chunk;
+
+   if ((chunk = vfs_cdrom_cache_find(lba)))
+      return chunk;
+
+   if (!vfs_cdrom_cache)
+   {
+      if (vfs_cdrom_cache_bytes < CDROM_CACHE_CHUNK_BYTES)
+         return NULL;
+
+      vfs_cdrom_cache_chunks = vfs_cdrom_cache_bytes
+            / CDROM_CACHE_CHUNK_BYTES;
+      vfs_cdrom_cache        = (vfs_cdrom_cache_chunk_t*)calloc(
+            vfs_cdrom_cache_chunks, sizeof(*vfs_cdrom_cache));
+
+      if (!vfs_cdrom_cache)
+      {
+         vfs_cdrom_cache_chunks = 0;
+         return NULL;
+      }
+   }
+
+   if (lba >= end_lba)
+      return NULL;
+
+   /* Prefer a never-used slot, otherwise evict the least
+    * recently used one. */
+   chunk = &vfs_cdrom_cache[0];
+   for (i = 0; i < vfs_cdrom_cache_chunks; i++)
+   {
+      if (!vfs_cdrom_cache[i].valid && vfs_cdrom_cache[i].data)
+      {
+         chunk = &vfs_cdrom_cache[i];
+         break;
+      }
+      if (!vfs_cdrom_cache[i].data)
+      {
+         if (!(vfs_cdrom_cache[i].data = (uint8_t*)
+               malloc(CDROM_CACHE_CHUNK_BYTES)))
+            continue;
+         chunk = &vfs_cdrom_cache[i];
+         break;
+      }
+      if ((vfs_cdrom_cache_counter - vfs_cdrom_cache[i].last_used) >
+            (vfs_cdrom_cache_counter - chunk->last_used))
+         chunk = &vfs_cdrom_cache[i];
+   }
+
+   if (!chunk->data)
+      return NULL;
+
+   size = CDROM_CACHE_CHUNK_BYTES;
+   if (lba + CDROM_CACHE_CHUNK_SECTORS > end_lba)
+      size = (end_lba - lba) * 2352;
+
+   chunk->valid = false;
+
+   cdrom_lba_to_msf(lba, &min, &sec, &frame);
+
+   if (cdrom_read(stream, &vfs_cdrom_toc.timeouts, min, sec, frame,
+         chunk->data, (size_t)size, 0))
+      return NULL;
+
+   chunk->lba       = lba;
+   chunk->size      = size;
+   chunk->last_used = vfs_cdrom_cache_counter++;
+   chunk->valid     = true;
+
+   return chunk;
+}
+
+static void vfs_cdrom_cache_flush(void)
+{
+   size_t i;
+
+   vfs_cdrom_cache_mutex_lock();
+   for (i = 0; i < vfs_cdrom_cache_chunks; i++)
+      vfs_cdrom_cache[i].valid = false;
+#ifdef HAVE_THREADS
+   vfs_cdrom_cache_queue_len = 0;
+#endif
+   vfs_cdrom_cache_mutex_unlock();
+}
+
+#ifdef HAVE_THREADS
+static void vfs_cdrom_cache_thread_loop(void *data)
+{
+   slock_lock(vfs_cdrom_cache_lock);
+
+   for (;;)
+   {
+      size_t i;
+      size_t pick;
+      unsigned lba;
+
+      while (!vfs_cdrom_cache_thread_stop && !vfs_cdrom_cache_queue_len)
+         scond_wait(vfs_cdrom_cache_cond, vfs_cdrom_cache_lock);
+
+      if (vfs_cdrom_cache_thread_stop)
+         break;
+
+      /* Elevator order: service the lowest LBA at or above
+       * the current head position, wrapping to the lowest
+       * pending LBA when nothing lies ahead. */
+      pick = 0;
+      for (i = 1; i < vfs_cdrom_cache_queue_len; i++)
+      {
+         bool pick_ahead = vfs_cdrom_cache_queue[pick]
+               >= vfs_cdrom_cache_head_lba;
+         bool cand_ahead = vfs_cdrom_cache_queue[i]
+               >= vfs_cdrom_cache_head_lba;
+
+         if (cand_ahead != pick_ahead)
+         {
+            if (cand_ahead)
+               pick = i;
+         }
+         else if (vfs_cdrom_cache_queue[i] < vfs_cdrom_cache_queue[pick])
+            pick = i;
+      }
+
+      lba = vfs_cdrom_cache_queue[pick];
+      vfs_cdrom_cache_queue[pick] =
+            vfs_cdrom_cache_queue[--vfs_cdrom_cache_queue_len];
+      vfs_cdrom_cache_head_lba    = lba;
+
+      if (vfs_cdrom_cache_stream)
+         vfs_cdrom_cache_fetch(vfs_cdrom_cache_stream, lba);
+
+      /* Give a foreground reader waiting on the lock a
+       * window between chunks. */
+      slock_unlock(vfs_cdrom_cache_lock);
+      slock_lock(vfs_cdrom_cache_lock);
+   }
+
+   slock_unlock(vfs_cdrom_cache_lock);
+}
+
+/* Queues the chunks following the last served read for the
+ * background worker. Caller holds the cache lock. */
+static void vfs_cdrom_cache_readahead(
+      libretro_vfs_implementation_file *stream, unsigned lba)
+{
+   unsigned i;
+   unsigned end_lba = vfs_cdrom_disc_end_lba();
+
+   if (!vfs_cdrom_cache_lock)
+      return;
+   if (!vfs_cdrom_cache_cond)
+      vfs_cdrom_cache_cond = scond_new();
+   if (!vfs_cdrom_cache_cond)
+      return;
+
+   if (!vfs_cdrom_cache_thread)
+   {
+      vfs_cdrom_cache_thread_stop = false;
+      vfs_cdrom_cache_stream      = stream;
+      vfs_cdrom_cache_thread      = sthread_create(
+            vfs_cdrom_cache_thread_loop, NULL);
+      if (!vfs_cdrom_cache_thread)
+         return;
+   }
+
+   for (i = 0; i < CDROM_CACHE_READAHEAD_CHUNKS; i++)
+   {
+      size_t j;
+      unsigned next = lba + (i + 1) * CDROM_CACHE_CHUNK_SECTORS;
+
+      if (next >= end_lba)
+         break;
+      if (vfs_cdrom_cache_queue_len >= CDROM_CACHE_QUEUE_LEN)
+         break;
+      if (vfs_cdrom_cache_find(next))
+         continue;
+
+      for (j = 0; j < vfs_cdrom_cache_queue_len; j++)
+         if (vfs_cdrom_cache_queue[j] == next)
+            break;
+      if (j < vfs_cdrom_cache_queue_len)
+         continue;
+
+      vfs_cdrom_cache_queue[vfs_cdrom_cache_queue_len++] = next;
+   }
+
+   scond_signal(vfs_cdrom_cache_cond);
+}
+
+/* Stops the worker when the stream it reads through goes
+ * away; the next cached read restarts it. */
+static void vfs_cdrom_cache_thread_release(
+      libretro_vfs_implementation_file *stream)
+{
+   if (!vfs_cdrom_cache_thread || stream != vfs_cdrom_cache_stream)
+      return;
+
+   slock_lock(vfs_cdrom_cache_lock);
+   vfs_cdrom_cache_thread_stop = true;
+   scond_signal(vfs_cdrom_cache_cond);
+   slock_unlock(vfs_cdrom_cache_lock);
+
+   sthread_join(vfs_cdrom_cache_thread);
+   vfs_cdrom_cache_thread = NULL;
+   vfs_cdrom_cache_stream = NULL;
+}
+#endif
+
+/* Serves a read at the stream's current position from the
+ * sector cache, fetching missing chunks from the drive.
+ * Returns false (without touching s) when caching is
+ * disabled or a drive read fails, in which case the caller
+ * falls back to a direct read. */
+static bool vfs_cdrom_cache_read(
+      libretro_vfs_implementation_file *stream,
+      uint8_t *s, size_t len, size_t skip)
+{
+   uint64_t abs_byte;
+   unsigned last_lba;
+
+   vfs_cdrom_cache_mutex_lock();
+
+   abs_byte = (uint64_t)stream->cdrom.cur_lba * 2352 + skip;
+   last_lba = stream->cdrom.cur_lba;
+
+   while (len)
+   {
+      size_t copy;
+      unsigned chunk_lba = (unsigned)(abs_byte / 2352)
+            / CDROM_CACHE_CHUNK_SECTORS * CDROM_CACHE_CHUNK_SECTORS;
+      size_t offset      = (size_t)(abs_byte
+            - (uint64_t)chunk_lba * 2352);
+      vfs_cdrom_cache_chunk_t *chunk =
+            vfs_cdrom_cache_fetch(stream, chunk_lba);
+
+      if (!chunk || offset >= chunk->size)
+      {
+         vfs_cdrom_cache_mutex_unlock();
+         return false;
+      }
+
+      copy = chunk->size - offset;
+      if (copy > len)
+         copy = len;
+
+      memcpy(s, chunk->data + offset, copy);
+      chunk->last_used = vfs_cdrom_cache_counter++;
+
+      s        += copy;
+      len      -= copy;
+      abs_byte += copy;
+      last_lba  = chunk_lba;
+   }
+
+#ifdef HAVE_THREADS
+   vfs_cdrom_cache_readahead(stream, last_lba);
+#endif
+
+   vfs_cdrom_cache_mutex_unlock();
+   return true;
+}
+
+void retro_vfs_file_set_cdrom_cache_size(size_t bytes)
+{
+   size_t i;
+
+   vfs_cdrom_cache_mutex_lock();
+
+   for (i = 0; i < vfs_cdrom_cache_chunks; i++)
+      if (vfs_cdrom_cache[i].data)
+         free(vfs_cdrom_cache[i].data);
+   if (vfs_cdrom_cache)
+      free(vfs_cdrom_cache);
+
+   vfs_cdrom_cache        = NULL;
+   vfs_cdrom_cache_chunks = 0;
+   vfs_cdrom_cache_bytes  = bytes;
+#ifdef HAVE_THREADS
+   vfs_cdrom_cache_queue_len = 0;
+#endif
+
+   vfs_cdrom_cache_mutex_unlock();
+}
+
 const cdrom_toc_t* retro_vfs_file_get_cdrom_toc(void)
 {
    return &vfs_cdrom_toc;
@@ -308,6 +701,11 @@ void retro_vfs_file_open_cdrom(
 #endif
    }
 #endif
+   /* A fresh cuesheet means the TOC - and possibly the
+    * disc - changed; drop any cached sectors. */
+   if (string_is_equal_noncase(path_get_extension(path), "cue"))
+      vfs_cdrom_cache_flush();
+
    if (vfs_cdrom_toc.num_tracks > 1 && stream->cdrom.cur_track)
    {
       stream->cdrom.cur_min   = vfs_cdrom_toc.track[stream->cdrom.cur_track - 1].min;
@@ -331,6 +729,10 @@ int retro_vfs_file_close_cdrom(libretro_vfs_implementation_file *stream)
    fflush(stdout);
 #endif
 
+#ifdef HAVE_THREADS
+   vfs_cdrom_cache_thread_release(stream);
+#endif
+
 #if defined(_WIN32) && !defined(_XBOX)
    if (!stream->fh || !CloseHandle(stream->fh))
       return -1;
@@ -434,12 +836,16 @@ int64_t retro_vfs_file_read_cdrom(libretro_vfs_implementation_file *stream,
       fflush(stdout);
 #endif
 
+      if (vfs_cdrom_cache_read(stream, (uint8_t*)s, (size_t)len, skip))
+         rv = 0;
 #if 1
-      rv = cdrom_read(stream, &vfs_cdrom_toc.timeouts, min, sec,
-            frame, s, (size_t)len, skip);
+      else
+         rv = cdrom_read(stream, &vfs_cdrom_toc.timeouts, min, sec,
+               frame, s, (size_t)len, skip);
 #else
-      rv = cdrom_read_lba(stream, stream->cdrom.cur_lba, s,
-            (size_t)len, skip);
+      else
+         rv = cdrom_read_lba(stream, stream->cdrom.cur_lba, s,
+               (size_t)len, skip);
 #endif
 
       if (rv)
@@ -86,8 +86,20 @@ struct libretrodb_cursor
 	libretrodb_t *db;
 	int is_valid;
 	int eof;
+   /* Reusable record buffer for libretrodb_cursor_read_item_view */
+   uint8_t *view_buf;
+   size_t view_cap;
+   size_t view_len;  /* Valid bytes in view_buf */
+   size_t view_pos;  /* Start of the next unparsed record */
+   /* Byte at view_pos before the previous record's string terminator
+    * overwrote it; restored before the next parse */
+   uint8_t view_saved;
+   int view_restore;
 };
 
+/* Chosen so a typical record fits without growing the buffer */
+#define VIEW_BUF_MIN_SIZE 8192
+
 static int libretrodb_read_metadata(RFILE *fd, libretrodb_metadata_t *md)
 {
    return rmsgpack_dom_read_into(fd, "count", &md->count, NULL);
@@ -286,69 +298,63 @@ static int libretrodb_find_index(libretrodb_t *db, const char *index_name,
    return -1;
 }
 
-static int binsearch(const void *buff, const void *item,
-      uint64_t count, uint8_t field_size, uint64_t *offset)
-{
-   int mid            = (int)(count / 2);
-   int item_size      = field_size + sizeof(uint64_t);
-   uint64_t *current  = (uint64_t *)buff + (mid * item_size);
-   int rv             = memcmp(current, item, field_size);
-
-   if (rv == 0)
-   {
-      *offset = *(uint64_t *)(current + field_size);
-      return 0;
-   }
-
-   if (count == 0)
-      return -1;
-
-   if (rv > 0)
-      return binsearch(buff, item, mid, field_size, offset);
-
-   return binsearch(current + item_size, item,
-         count - mid, field_size, offset);
-}
-
 int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
       const void *key, struct rmsgpack_dom_value *out)
 {
    libretrodb_index_t idx;
-   int rv;
-   void *buff;
-   uint64_t offset;
-   ssize_t bufflen, nread = 0;
+   uint8_t buff[64];
+   uint64_t item_size, count, first;
+   ssize_t base;
 
    if (libretrodb_find_index(db, index_name, &idx) < 0)
       return -1;
 
-   bufflen = idx.next;
-   buff    = malloc(bufflen);
+   if (idx.key_size == 0
+         || idx.key_size > sizeof(buff) - sizeof(uint64_t))
+      return -EINVAL;
 
-   if (!buff)
-      return -ENOMEM;
+   item_size = idx.key_size + sizeof(uint64_t);
+   base      = filestream_tell(db->fd);
+   count     = idx.next / item_size;
+   first     = 0;
 
-   while (nread < bufflen)
+   /* Binary search the sorted on-disk index directly; each probe
+    * reads a single key/offset pair, so a lookup touches a handful
+    * of pages instead of pulling the whole index into memory */
+   while (count > 0)
    {
-      void *buff_ = (uint64_t *)buff + nread;
-      rv          = (int)filestream_read(db->fd, buff_, bufflen - nread);
+      int rv;
+      uint64_t half = count / 2;
+      uint64_t mid  = first + half;
 
-      if (rv <= 0)
-      {
-         free(buff);
+      filestream_seek(db->fd, base + (ssize_t)(mid * item_size),
+            RETRO_VFS_SEEK_POSITION_START);
+
+      if (filestream_read(db->fd, buff, (ssize_t)item_size)
+            != (ssize_t)item_size)
          return -errno;
-      }
-      nread += rv;
-   }
 
-   rv = binsearch(buff, key, db->count, (ssize_t)idx.key_size, &offset);
-   free(buff);
+      rv = memcmp(buff, key, (size_t)idx.key_size);
 
-   if (rv == 0)
-      filestream_seek(db->fd, (ssize_t)offset,
-            RETRO_VFS_SEEK_POSITION_START);
+      if (rv == 0)
+      {
+         uint64_t offset;
+         memcpy(&offset, buff + idx.key_size, sizeof(offset));
+         filestream_seek(db->fd, (ssize_t)offset,
+               RETRO_VFS_SEEK_POSITION_START);
+         return rmsgpack_dom_read(db->fd, out);
+      }
+
+      if (rv > 0)
+         count  = half;
+      else
+      {
+         first += half + 1;
+         count -= half + 1;
+      }
+   }
 
-   return rmsgpack_dom_read(db->fd, out);
+   return -1;
 }
 
 /**
@@ -361,7 +367,10 @@ int libretrodb_find_entry(libretrodb_t *db, const char *index_name,
  **/
 int libretrodb_cursor_reset(libretrodb_cursor_t *cursor)
 {
-   cursor->eof = 0;
+   cursor->eof          = 0;
+   cursor->view_len     = 0;
+   cursor->view_pos     = 0;
+   cursor->view_restore = 0;
    return (int)filestream_seek(cursor->fd,
          (ssize_t)(cursor->db->root + sizeof(libretrodb_header_t)),
          RETRO_VFS_SEEK_POSITION_START);
@@ -375,6 +384,36 @@ int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
    if (cursor->eof)
       return EOF;
 
+   /* Stream-eligible queries pre-screen records on the raw msgpack,
+    * so rejected records are never DOM-materialized; only matches
+    * are re-read as a document */
+   if (cursor->query && libretrodb_query_is_streamable(cursor->query))
+   {
+      for (;;)
+      {
+         int match   = 0;
+         ssize_t pos = filestream_tell(cursor->fd);
+
+         rv = libretrodb_query_stream_filter(
+               cursor->query, cursor->fd, &match);
+
+         if (rv == EOF)
+         {
+            cursor->eof = 1;
+            return EOF;
+         }
+         if (rv < 0)
+            return rv;
+
+         if (match)
+         {
+            filestream_seek(cursor->fd, pos,
+                  RETRO_VFS_SEEK_POSITION_START);
+            return rmsgpack_dom_read(cursor->fd, out);
+         }
+      }
+   }
+
 retry:
    rv = rmsgpack_dom_read(cursor->fd, out);
    if (rv < 0)
@@ -398,6 +437,120 @@ retry:
    return 0;
 }
 
+/* Shifts the unparsed tail of the record buffer to the front and tops
+ * it up from the file, growing the buffer when a record is larger than
+ * its current capacity. One byte of capacity is reserved for the string
+ * terminator a parse may write past the end of the last record. */
+static int libretrodb_cursor_view_fill(libretrodb_cursor_t *cursor)
+{
+   ssize_t nread;
+
+   if (cursor->view_pos)
+   {
+      memmove(cursor->view_buf, cursor->view_buf + cursor->view_pos,
+            cursor->view_len - cursor->view_pos);
+      cursor->view_len -= cursor->view_pos;
+      cursor->view_pos  = 0;
+   }
+
+   if (cursor->view_len + 1 >= cursor->view_cap)
+   {
+      size_t cap   = cursor->view_cap
+         ? (cursor->view_cap << 1) : VIEW_BUF_MIN_SIZE;
+      uint8_t *buf = (uint8_t *)realloc(cursor->view_buf, cap);
+
+      if (!buf)
+         return -ENOMEM;
+
+      cursor->view_buf = buf;
+      cursor->view_cap = cap;
+   }
+
+   nread = filestream_read(cursor->fd,
+         cursor->view_buf + cursor->view_len,
+         cursor->view_cap - 1 - cursor->view_len);
+
+   if (nread < 0)
+      return -errno;
+   if (nread == 0)
+      return -EINVAL; /* Truncated record */
+
+   cursor->view_len += nread;
+   return 0;
+}
+
+/**
+ * libretrodb_cursor_read_item_view:
+ * @cursor              : Handle to database cursor.
+ * @out                 : Output value.
+ *
+ * Reads the next matching record like libretrodb_cursor_read_item, but
+ * without copying payloads out of the record: string and binary values
+ * point into a cursor-owned buffer and stay valid only until the next
+ * call on (or close of) the cursor. Copy out anything that has to
+ * outlive that. The result must be released with
+ * rmsgpack_dom_view_free, not rmsgpack_dom_value_free.
+ *
+ * Reads on a cursor must not mix this with libretrodb_cursor_read_item,
+ * which consumes the file directly.
+ *
+ * Returns: 0 if successful, EOF at end of records,
+ * otherwise negative.
+ **/
+int libretrodb_cursor_read_item_view(libretrodb_cursor_t *cursor,
+      struct rmsgpack_dom_value *out)
+{
+   int rv;
+
+   if (cursor->eof)
+      return EOF;
+
+   for (;;)
+   {
+      size_t used;
+
+      if (cursor->view_restore)
+      {
+         cursor->view_buf[cursor->view_pos] = cursor->view_saved;
+         cursor->view_restore               = 0;
+      }
+
+      rv = rmsgpack_dom_parse(
+            cursor->view_buf + cursor->view_pos,
+            cursor->view_len - cursor->view_pos, &used, out);
+
+      if (rv == -EAGAIN)
+      {
+         if ((rv = libretrodb_cursor_view_fill(cursor)) < 0)
+            return rv;
+         continue;
+      }
+      if (rv < 0)
+         return rv;
+
+      if (out->type == RDT_NULL)
+      {
+         cursor->eof = 1;
+         return EOF;
+      }
+
+      /* Terminating the string views clobbers the byte after the
+       * record, so it is saved first and restored before the next
+       * record is parsed */
+      cursor->view_pos    += used;
+      cursor->view_saved   = cursor->view_buf[cursor->view_pos];
+      cursor->view_restore = 1;
+      rmsgpack_dom_view_terminate(out);
+
+      if (cursor->query && !libretrodb_query_filter(cursor->query, out))
+      {
+         rmsgpack_dom_view_free(out);
+         continue;
+      }
+      return 0;
+   }
+}
+
 /**
  * libretrodb_cursor_close:
  * @cursor              : Handle to database cursor.
@@ -415,11 +568,18 @@ void libretrodb_cursor_close(libretrodb_cursor_t *cursor)
    if (cursor->query)
       libretrodb_query_free(cursor->query);
 
+   if (cursor->view_buf)
+      free(cursor->view_buf);
+
    cursor->is_valid = 0;
    cursor->eof      = 1;
    cursor->fd       = NULL;
    cursor->db       = NULL;
    cursor->query    = NULL;
+   cursor->view_buf = NULL;
+   cursor->view_cap = 0;
+   cursor->view_len = 0;
+   cursor->view_pos = 0;
 }
 
 /**
@@ -600,6 +760,11 @@ libretrodb_cursor_t *libretrodb_cursor_new(void)
    dbc->eof                 = 0;
    dbc->query               = NULL;
    dbc->db                  = NULL;
+   dbc->view_buf            = NULL;
+   dbc->view_cap            = 0;
+   dbc->view_len            = 0;
+   dbc->view_pos            = 0;
+   dbc->view_restore        = 0;
 
    return dbc;
 }
@@ -105,6 +105,23 @@ void libretrodb_query_free(void *q);
 int libretrodb_cursor_read_item(libretrodb_cursor_t *cursor,
       struct rmsgpack_dom_value *out);
 
+/**
+ * libretrodb_cursor_read_item_view:
+ * @cursor              : Handle to database cursor.
+ * @out                 : Output value.
+ *
+ * Zero-copy variant of libretrodb_cursor_read_item: string and binary
+ * values point into a cursor-owned buffer and are only valid until the
+ * next read on (or close of) the cursor. Release results with
+ * rmsgpack_dom_view_free instead of rmsgpack_dom_value_free. Do not
+ * mix with libretrodb_cursor_read_item on the same cursor.
+ *
+ * Returns: 0 if successful, EOF at end of records,
+ * otherwise negative.
+ **/
+int libretrodb_cursor_read_item_view(libretrodb_cursor_t *cursor,
+      struct rmsgpack_dom_value *out);
+
 RETRO_END_DECLS
 
 #endif
@@ -28,6 +28,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
 #include <string.h>
 
 #include <compat/fnmatch.h>
@@ -37,6 +38,7 @@
 
 #include "libretrodb.h"
 #include "query.h"
+#include "rmsgpack.h"
 #include "rmsgpack_dom.h"
 
 #define MAX_ERROR_LEN   256
@@ -84,6 +86,10 @@ struct query
 {
    struct invocation root; /* ptr alignment */
    unsigned ref_count;
+   /* True when the query is a plain top-level field-equality map
+    * that can be evaluated against raw msgpack without building a
+    * DOM tree for the record */
+   bool simple;
 };
 
 struct registered_func
@@ -915,6 +921,248 @@ success:
    return buff;
 }
 
+/* A query is stream-evaluable when it is a single field-equality
+ * map - the shape the content scanner produces ({crc: b"...", ...}) -
+ * with plain literals on both sides of every pair */
+static bool query_is_simple(const struct invocation *inv)
+{
+   unsigned i;
+
+   if (inv->func != query_func_all_map || !inv->argc
+         || (inv->argc % 2) != 0)
+      return false;
+
+   for (i = 0; i < inv->argc; i += 2)
+   {
+      if (     inv->argv[i].type != AT_VALUE
+            || inv->argv[i].a.value.type != RDT_STRING)
+         return false;
+
+      if (inv->argv[i + 1].type != AT_VALUE)
+         return false;
+
+      switch (inv->argv[i + 1].a.value.type)
+      {
+         case RDT_NULL:
+         case RDT_BOOL:
+         case RDT_INT:
+         case RDT_UINT:
+         case RDT_STRING:
+         case RDT_BINARY:
+            break;
+         default:
+            return false;
+      }
+   }
+
+   return true;
+}
+
+static int query_stream_skip_payload(RFILE *fd, uint64_t len)
+{
+   if (filestream_seek(fd, (ssize_t)len,
+            RETRO_VFS_SEEK_POSITION_CURRENT) < 0)
+      return -errno;
+   return 0;
+}
+
+/* Finishes skipping a value whose header token has already been
+ * consumed */
+static int query_stream_skip_open(RFILE *fd,
+      const struct rmsgpack_token *tok)
+{
+   int rv;
+   uint64_t i, n = 0;
+
+   switch (tok->type)
+   {
+      case RMSGPACK_TOKEN_STRING:
+      case RMSGPACK_TOKEN_BINARY:
+         return query_stream_skip_payload(fd, tok->len);
+      case RMSGPACK_TOKEN_MAP:
+         n = tok->len * 2;
+         break;
+      case RMSGPACK_TOKEN_ARRAY:
+         n = tok->len;
+         break;
+      default:
+         break;
+   }
+
+   for (i = 0; i < n; i++)
+      if ((rv = rmsgpack_skip(fd)) < 0)
+         return rv;
+   return 0;
+}
+
+/* Compares the value whose header token was just read against a
+ * query literal, consuming the value either way. Mirrors the type
+ * coercion of func_equals: a signed query literal matches an
+ * unsigned field of equal magnitude. */
+static int query_stream_compare_value(RFILE *fd,
+      const struct rmsgpack_token *tok,
+      const struct rmsgpack_dom_value *want, int *match)
+{
+   *match = 0;
+
+   switch (tok->type)
+   {
+      case RMSGPACK_TOKEN_NIL:
+         *match = (want->type == RDT_NULL);
+         return 0;
+      case RMSGPACK_TOKEN_BOOL:
+         *match = (want->type == RDT_BOOL
+               && (want->val.bool_ != 0) == (tok->bool_ != 0));
+         return 0;
+      case RMSGPACK_TOKEN_INT:
+         *match = (want->type == RDT_INT
+               && want->val.int_ == tok->int_);
+         return 0;
+      case RMSGPACK_TOKEN_UINT:
+         if (want->type == RDT_UINT)
+            *match = (want->val.uint_ == tok->uint_);
+         else if (want->type == RDT_INT)
+            *match = (want->val.int_ >= 0
+                  && (uint64_t)want->val.int_ == tok->uint_);
+         return 0;
+      case RMSGPACK_TOKEN_STRING:
+      case RMSGPACK_TOKEN_BINARY:
+      {
+         char buff[64];
+         uint64_t off = 0;
+         enum rmsgpack_dom_type expect =
+               (tok->type == RMSGPACK_TOKEN_STRING)
+               ? RDT_STRING : RDT_BINARY;
+
+         if (     want->type != expect
+               || want->val.string.len != tok->len)
+            return query_stream_skip_payload(fd, tok->len);
+
+         while (off < tok->len)
+         {
+            size_t chunk = (size_t)(tok->len - off);
+            if (chunk > sizeof(buff))
+               chunk = sizeof(buff);
+
+            if (filestream_read(fd, buff, (ssize_t)chunk)
+                  != (ssize_t)chunk)
+               return -errno;
+
+            if (memcmp(buff, want->val.string.buff + off, chunk) != 0)
+               return query_stream_skip_payload(fd,
+                     tok->len - off - chunk);
+            off += chunk;
+         }
+
+         *match = 1;
+         return 0;
+      }
+      default:
+         /* structured field values never match a literal */
+         return query_stream_skip_open(fd, tok);
+   }
+}
+
+int libretrodb_query_is_streamable(libretrodb_query_t *q)
+{
+   return ((struct query *)q)->simple ? 1 : 0;
+}
+
+int libretrodb_query_stream_filter(libretrodb_query_t *q,
+      RFILE *fd, int *match)
+{
+   struct rmsgpack_token tok;
+   bool seen[QUERY_MAX_ARGS / 2];
+   uint64_t pairs;
+   unsigned i;
+   int rv;
+   struct query *rq             = (struct query*)q;
+   const struct invocation *inv = &rq->root;
+   unsigned nfields             = inv->argc / 2;
+   int ok                       = 1;
+
+   if (!rq->simple)
+      return -EINVAL;
+
+   if ((rv = rmsgpack_read_token(fd, &tok)) < 0)
+      return rv;
+
+   /* The end of the record stream is marked by a nil sentinel */
+   if (tok.type == RMSGPACK_TOKEN_NIL)
+      return EOF;
+
+   if (tok.type != RMSGPACK_TOKEN_MAP)
+   {
+      /* Documents are validated to be maps on write; consume the
+       * stray value to keep the cursor in sync */
+      *match = 0;
+      return query_stream_skip_open(fd, &tok);
+   }
+
+   for (i = 0; i < nfields; i++)
+      seen[i] = false;
+
+   for (pairs = tok.len; pairs; pairs--)
+   {
+      char key[64];
+      struct rmsgpack_token ktok, vtok;
+      unsigned field = nfields;
+
+      if ((rv = rmsgpack_read_token(fd, &ktok)) < 0)
+         return rv;
+
+      if (     ktok.type == RMSGPACK_TOKEN_STRING
+            && ktok.len < sizeof(key))
+      {
+         if (filestream_read(fd, key, (ssize_t)ktok.len)
+               != (ssize_t)ktok.len)
+            return -errno;
+
+         /* Only the first occurrence of a key counts, as with
+          * rmsgpack_dom_value_map_value */
+         for (field = 0; field < nfields; field++)
+         {
+            const struct rmsgpack_dom_value *k =
+                  &inv->argv[field * 2].a.value;
+            if (     !seen[field]
+                  && k->val.string.len == ktok.len
+                  && memcmp(k->val.string.buff, key, (size_t)ktok.len) == 0)
+               break;
+         }
+      }
+      else if ((rv = query_stream_skip_open(fd, &ktok)) < 0)
+         return rv;
+
+      if ((rv = rmsgpack_read_token(fd, &vtok)) < 0)
+         return rv;
+
+      if (field == nfields)
+      {
+         if ((rv = query_stream_skip_open(fd, &vtok)) < 0)
+            return rv;
+      }
+      else
+      {
+         int m       = 0;
+         seen[field] = true;
+
+         if ((rv = query_stream_compare_value(fd, &vtok,
+                     &inv->argv[field * 2 + 1].a.value, &m)) < 0)
+            return rv;
+         if (!m)
+            ok = 0;
+      }
+   }
+
+   /* Fields missing from the record compare as nil */
+   for (i = 0; i < nfields; i++)
+      if (!seen[i] && inv->argv[i * 2 + 1].a.value.type != RDT_NULL)
+         ok = 0;
+
+   *match = ok;
+   return 0;
+}
+
 void libretrodb_query_free(void *q)
 {
    unsigned i;
@@ -946,6 +1194,7 @@ void *libretrodb_query_compile(libretrodb_t *db,
       return NULL;
 
    q->ref_count          = 1;
+   q->simple             = false;
    q->root.argc          = 0;
    q->root.func          = NULL;
    q->root.argv          = NULL;
@@ -986,6 +1235,8 @@ void *libretrodb_query_compile(libretrodb_t *db,
       goto error;
    }
 
+   q->simple = query_is_simple(&q->root);
+
    return q;
 
 error:
@@ -38,6 +38,16 @@ void libretrodb_query_dec_ref(libretrodb_query_t *q);
 
 int libretrodb_query_filter(libretrodb_query_t *q, struct rmsgpack_dom_value *v);
 
+/* Returns non-zero if the query can be evaluated against raw msgpack
+ * records via libretrodb_query_stream_filter. */
+int libretrodb_query_is_streamable(libretrodb_query_t *q);
+
+/* Consumes the next record from fd and stores whether it matches the
+ * query in *match, without materializing a DOM tree. Returns 0 on
+ * success, EOF when the nil end-of-records sentinel is reached and a
+ * negative value on read errors or when the query is not streamable. */
+int libretrodb_query_stream_filter(libretrodb_query_t *q, RFILE *fd, int *match);
+
 RETRO_END_DECLS
 
 #endif
@@ -526,6 +526,277 @@ static int read_array(RFILE *fd, uint32_t len,
    return 0;
 }
 
+int rmsgpack_read_token(RFILE *fd, struct rmsgpack_token *tok)
+{
+   uint8_t type = 0;
+
+   if (filestream_read(fd, &type, sizeof(uint8_t)) == -1)
+      return -errno;
+
+   if (type < _MPF_FIXMAP)
+   {
+      tok->type = RMSGPACK_TOKEN_INT;
+      tok->int_ = type;
+      return 0;
+   }
+   else if (type < _MPF_FIXARRAY)
+   {
+      tok->type = RMSGPACK_TOKEN_MAP;
+      tok->len  = type - _MPF_FIXMAP;
+      return 0;
+   }
+   else if (type < _MPF_FIXSTR)
+   {
+      tok->type = RMSGPACK_TOKEN_ARRAY;
+      tok->len  = type - _MPF_FIXARRAY;
+      return 0;
+   }
+   else if (type < _MPF_NIL)
+   {
+      tok->type = RMSGPACK_TOKEN_STRING;
+      tok->len  = type - _MPF_FIXSTR;
+      return 0;
+   }
+   else if (type > _MPF_MAP32)
+   {
+      tok->type = RMSGPACK_TOKEN_INT;
+      tok->int_ = (int64_t)type - 0xff - 1;
+      return 0;
+   }
+
+   switch (type)
+   {
+      case _MPF_NIL:
+         tok->type  = RMSGPACK_TOKEN_NIL;
+         return 0;
+      case _MPF_FALSE:
+         tok->type  = RMSGPACK_TOKEN_BOOL;
+         tok->bool_ = 0;
+         return 0;
+      case _MPF_TRUE:
+         tok->type  = RMSGPACK_TOKEN_BOOL;
+         tok->bool_ = 1;
+         return 0;
+      case _MPF_BIN8:
+      case _MPF_BIN16:
+      case _MPF_BIN32:
+         tok->type  = RMSGPACK_TOKEN_BINARY;
+         return read_uint(fd, &tok->len,
+               (size_t)(1 << (type - _MPF_BIN8)));
+      case _MPF_UINT8:
+      case _MPF_UINT16:
+      case _MPF_UINT32:
+      case _MPF_UINT64:
+         tok->type  = RMSGPACK_TOKEN_UINT;
+         return read_uint(fd, &tok->uint_,
+               (size_t)(UINT64_C(1) << (type - _MPF_UINT8)));
+      case _MPF_INT8:
+      case _MPF_INT16:
+      case _MPF_INT32:
+      case _MPF_INT64:
+         tok->type  = RMSGPACK_TOKEN_INT;
+         return read_int(fd, &tok->int_,
+               (size_t)(UINT64_C(1) << (type - _MPF_INT8)));
+      case _MPF_STR8:
+      case _MPF_STR16:
+      case _MPF_STR32:
+         tok->type  = RMSGPACK_TOKEN_STRING;
+         return read_uint(fd, &tok->len,
+               (size_t)(1 << (type - _MPF_STR8)));
+      case _MPF_ARRAY16:
+      case _MPF_ARRAY32:
+         tok->type  = RMSGPACK_TOKEN_ARRAY;
+         return read_uint(fd, &tok->len, 2 << (type - _MPF_ARRAY16));
+      case _MPF_MAP16:
+      case _MPF_MAP32:
+         tok->type  = RMSGPACK_TOKEN_MAP;
+         return read_uint(fd, &tok->len, 2 << (type - _MPF_MAP16));
+   }
+
+   return -EINVAL;
+}
+
+int rmsgpack_skip(RFILE *fd)
+{
+   struct rmsgpack_token tok;
+   uint64_t pending = 1;
+
+   while (pending)
+   {
+      int rv = rmsgpack_read_token(fd, &tok);
+
+      if (rv < 0)
+         return rv;
+
+      pending--;
+
+      switch (tok.type)
+      {
+         case RMSGPACK_TOKEN_STRING:
+         case RMSGPACK_TOKEN_BINARY:
+            if (filestream_seek(fd, (ssize_t)tok.len,
+                     RETRO_VFS_SEEK_POSITION_CURRENT) < 0)
+               return -errno;
+            break;
+         case RMSGPACK_TOKEN_MAP:
+            pending += tok.len * 2;
+            break;
+         case RMSGPACK_TOKEN_ARRAY:
+            pending += tok.len;
+            break;
+         default:
+            break;
+      }
+   }
+
+   return 0;
+}
+
+static uint64_t parse_be(const uint8_t *data, size_t size)
+{
+   uint64_t v = 0;
+   while (size--)
+      v = (v << 8) | *data++;
+   return v;
+}
+
+int rmsgpack_parse_token(const void *buf, size_t size,
+      size_t *pos, struct rmsgpack_token *tok)
+{
+   const uint8_t *data = (const uint8_t *)buf;
+   uint64_t raw;
+   size_t need = 0;
+   uint8_t type;
+
+   if (*pos >= size)
+      return -EAGAIN;
+
+   type = data[*pos];
+
+   if (type < _MPF_FIXMAP)
+   {
+      tok->type = RMSGPACK_TOKEN_INT;
+      tok->int_ = type;
+      (*pos)++;
+      return 0;
+   }
+   else if (type < _MPF_FIXARRAY)
+   {
+      tok->type = RMSGPACK_TOKEN_MAP;
+      tok->len  = type - _MPF_FIXMAP;
+      (*pos)++;
+      return 0;
+   }
+   else if (type < _MPF_FIXSTR)
+   {
+      tok->type = RMSGPACK_TOKEN_ARRAY;
+      tok->len  = type - _MPF_FIXARRAY;
+      (*pos)++;
+      return 0;
+   }
+   else if (type < _MPF_NIL)
+   {
+      tok->type = RMSGPACK_TOKEN_STRING;
+      tok->len  = type - _MPF_FIXSTR;
+      (*pos)++;
+      return 0;
+   }
+   else if (type > _MPF_MAP32)
+   {
+      tok->type = RMSGPACK_TOKEN_INT;
+      tok->int_ = (int64_t)type - 0xff - 1;
+      (*pos)++;
+      return 0;
+   }
+
+   switch (type)
+   {
+      case _MPF_NIL:
+         tok->type  = RMSGPACK_TOKEN_NIL;
+         (*pos)++;
+         return 0;
+      case _MPF_FALSE:
+      case _MPF_TRUE:
+         tok->type  = RMSGPACK_TOKEN_BOOL;
+         tok->bool_ = (type == _MPF_TRUE);
+         (*pos)++;
+         return 0;
+      case _MPF_BIN8:
+      case _MPF_BIN16:
+      case _MPF_BIN32:
+         tok->type  = RMSGPACK_TOKEN_BINARY;
+         need       = (size_t)(1 << (type - _MPF_BIN8));
+         break;
+      case _MPF_UINT8:
+      case _MPF_UINT16:
+      case _MPF_UINT32:
+      case _MPF_UINT64:
+         tok->type  = RMSGPACK_TOKEN_UINT;
+         need       = (size_t)(1 << (type - _MPF_UINT8));
+         break;
+      case _MPF_INT8:
+      case _MPF_INT16:
+      case _MPF_INT32:
+      case _MPF_INT64:
+         tok->type  = RMSGPACK_TOKEN_INT;
+         need       = (size_t)(1 << (type - _MPF_INT8));
+         break;
+      case _MPF_STR8:
+      case _MPF_STR16:
+      case _MPF_STR32:
+         tok->type  = RMSGPACK_TOKEN_STRING;
+         need       = (size_t)(1 << (type - _MPF_STR8));
+         break;
+      case _MPF_ARRAY16:
+      case _MPF_ARRAY32:
+         tok->type  = RMSGPACK_TOKEN_ARRAY;
+         need       = (size_t)(2 << (type - _MPF_ARRAY16));
+         break;
+      case _MPF_MAP16:
+      case _MPF_MAP32:
+         tok->type  = RMSGPACK_TOKEN_MAP;
+         need       = (size_t)(2 << (type - _MPF_MAP16));
+         break;
+      default:
+         return -EINVAL;
+   }
+
+   if (size - *pos - 1 < need)
+      return -EAGAIN;
+
+   raw = parse_be(data + *pos + 1, need);
+
+   switch (tok->type)
+   {
+      case RMSGPACK_TOKEN_UINT:
+         tok->uint_ = raw;
+         break;
+      case RMSGPACK_TOKEN_INT:
+         switch (need)
+         {
+            case 1:
+               tok->int_ = (int8_t)raw;
+               break;
+            case 2:
+               tok->int_ = (int16_t)raw;
+               break;
+            case 4:
+               tok->int_ = (int32_t)raw;
+               break;
+            default:
+               tok->int_ = (int64_t)raw;
+               break;
+         }
+         break;
+      default:
+         tok->len = raw;
+         break;
+   }
+
+   *pos += 1 + need;
+   return 0;
+}
+
 int rmsgpack_read(RFILE *fd,
       struct rmsgpack_read_callbacks *callbacks, void *data)
 {
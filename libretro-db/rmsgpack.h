@@ -23,6 +23,7 @@
 #ifndef __LIBRETRODB_MSGPACK_H__
 #define __LIBRETRODB_MSGPACK_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <streams/file_stream.h>
@@ -39,6 +40,28 @@ struct rmsgpack_read_callbacks
    int (*read_array_start)(uint32_t, void *);
 };
 
+enum rmsgpack_token_type
+{
+   RMSGPACK_TOKEN_NIL = 0,
+   RMSGPACK_TOKEN_BOOL,
+   RMSGPACK_TOKEN_INT,
+   RMSGPACK_TOKEN_UINT,
+   RMSGPACK_TOKEN_STRING,
+   RMSGPACK_TOKEN_BINARY,
+   RMSGPACK_TOKEN_MAP,
+   RMSGPACK_TOKEN_ARRAY
+};
+
+struct rmsgpack_token
+{
+   uint64_t len;   /* byte length for string/binary,
+                      element count for map/array */
+   uint64_t uint_;
+   int64_t int_;
+   int bool_;
+   enum rmsgpack_token_type type;
+};
+
 int rmsgpack_write_array_header(RFILE *fd, uint32_t size);
 
 int rmsgpack_write_map_header(RFILE *fd, uint32_t size);
@@ -57,4 +80,22 @@ int rmsgpack_write_uint(RFILE *fd, uint64_t value );
 
 int rmsgpack_read(RFILE *fd, struct rmsgpack_read_callbacks *callbacks, void *data);
 
+/* Reads the header of the next value without materializing anything.
+ * For string/binary tokens the payload is left unread; the caller has
+ * to consume or seek past tok->len bytes. For map/array tokens the
+ * elements follow as separate values. */
+int rmsgpack_read_token(RFILE *fd, struct rmsgpack_token *tok);
+
+/* Skips one complete value (including nested maps/arrays), seeking
+ * past payloads instead of reading them. */
+int rmsgpack_skip(RFILE *fd);
+
+/* In-memory counterpart of rmsgpack_read_token: decodes the next value
+ * header from buf at *pos and advances *pos past it. String/binary
+ * payloads are left in place; the caller consumes tok->len bytes at
+ * *pos. Returns -EAGAIN when the buffer ends before the header is
+ * complete. */
+int rmsgpack_parse_token(const void *buf, size_t size, size_t *pos,
+      struct rmsgpack_token *tok);
+
 #endif
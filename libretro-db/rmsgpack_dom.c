@@ -215,6 +215,31 @@ void rmsgpack_dom_value_free(struct rmsgpack_dom_value *v)
    }
 }
 
+void rmsgpack_dom_view_free(struct rmsgpack_dom_value *v)
+{
+   unsigned i;
+
+   switch (v->type)
+   {
+      case RDT_MAP:
+         for (i = 0; i < v->val.map.len; i++)
+         {
+            rmsgpack_dom_view_free(&v->val.map.items[i].key);
+            rmsgpack_dom_view_free(&v->val.map.items[i].value);
+         }
+         free(v->val.map.items);
+         break;
+      case RDT_ARRAY:
+         for (i = 0; i < v->val.array.len; i++)
+            rmsgpack_dom_view_free(&v->val.array.items[i]);
+         free(v->val.array.items);
+         break;
+      default:
+         /* Strings and binaries are views into the parse buffer */
+         break;
+   }
+}
+
 struct rmsgpack_dom_value *rmsgpack_dom_value_map_value(
       const struct rmsgpack_dom_value *map,
       const struct rmsgpack_dom_value *key)
@@ -423,6 +448,98 @@ int rmsgpack_dom_read(RFILE *fd, struct rmsgpack_dom_value *out)
    return rv;
 }
 
+int rmsgpack_dom_parse(void *buf, size_t size, size_t *consumed,
+      struct rmsgpack_dom_value *out)
+{
+   struct dom_reader_state s;
+   size_t pos = 0;
+   int rv     = 0;
+
+   s.i        = 0;
+   s.stack[0] = out;
+   out->type  = RDT_NULL;
+
+   while (s.i >= 0)
+   {
+      struct rmsgpack_token tok;
+
+      if ((rv = rmsgpack_parse_token(buf, size, &pos, &tok)) < 0)
+         goto error;
+
+      switch (tok.type)
+      {
+         case RMSGPACK_TOKEN_NIL:
+            rv = dom_read_nil(&s);
+            break;
+         case RMSGPACK_TOKEN_BOOL:
+            rv = dom_read_bool(tok.bool_, &s);
+            break;
+         case RMSGPACK_TOKEN_INT:
+            rv = dom_read_int(tok.int_, &s);
+            break;
+         case RMSGPACK_TOKEN_UINT:
+            rv = dom_read_uint(tok.uint_, &s);
+            break;
+         case RMSGPACK_TOKEN_STRING:
+         case RMSGPACK_TOKEN_BINARY:
+            if (size - pos < tok.len)
+            {
+               rv = -EAGAIN;
+               goto error;
+            }
+            if (tok.type == RMSGPACK_TOKEN_STRING)
+               rv = dom_read_string(
+                     (char *)buf + pos, (uint32_t)tok.len, &s);
+            else
+               rv = dom_read_bin(
+                     (char *)buf + pos, (uint32_t)tok.len, &s);
+            pos += (size_t)tok.len;
+            break;
+         case RMSGPACK_TOKEN_MAP:
+            rv = dom_read_map_start((uint32_t)tok.len, &s);
+            break;
+         case RMSGPACK_TOKEN_ARRAY:
+            rv = dom_read_array_start((uint32_t)tok.len, &s);
+            break;
+      }
+
+      if (rv < 0)
+         goto error;
+   }
+
+   *consumed = pos;
+   return 0;
+
+error:
+   rmsgpack_dom_view_free(out);
+   return rv;
+}
+
+void rmsgpack_dom_view_terminate(struct rmsgpack_dom_value *v)
+{
+   unsigned i;
+
+   switch (v->type)
+   {
+      case RDT_STRING:
+         v->val.string.buff[v->val.string.len] = '\0';
+         break;
+      case RDT_MAP:
+         for (i = 0; i < v->val.map.len; i++)
+         {
+            rmsgpack_dom_view_terminate(&v->val.map.items[i].key);
+            rmsgpack_dom_view_terminate(&v->val.map.items[i].value);
+         }
+         break;
+      case RDT_ARRAY:
+         for (i = 0; i < v->val.array.len; i++)
+            rmsgpack_dom_view_terminate(&v->val.array.items[i]);
+         break;
+      default:
+         break;
+   }
+}
+
 int rmsgpack_dom_read_into(RFILE *fd, ...)
 {
    int rv;
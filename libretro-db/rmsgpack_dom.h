@@ -23,6 +23,7 @@
 #ifndef __LIBRETRODB_MSGPACK_DOM_H__
 #define __LIBRETRODB_MSGPACK_DOM_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <retro_common_api.h>
@@ -91,6 +92,33 @@ struct rmsgpack_dom_value *rmsgpack_dom_value_map_value(
 
 int rmsgpack_dom_read(RFILE *fd, struct rmsgpack_dom_value *out);
 
+/* Non-owning variant of rmsgpack_dom_read: parses one value out of an
+ * in-memory msgpack buffer. String and binary payloads are not copied;
+ * the resulting values point into @buf and stay valid for as long as
+ * @buf does. Only map/array tables are heap-allocated, so the result
+ * must be released with rmsgpack_dom_view_free, never with
+ * rmsgpack_dom_value_free. String views are not NUL-terminated until
+ * rmsgpack_dom_view_terminate is called.
+ *
+ * Returns 0 on success and stores the number of bytes consumed in
+ * *consumed, -EAGAIN if the buffer ends before the value is complete
+ * and another negative value on malformed input. */
+int rmsgpack_dom_parse(void *buf, size_t size, size_t *consumed,
+      struct rmsgpack_dom_value *out);
+
+/* Writes a NUL terminator after each string payload of a parsed view
+ * so the views can be used as C strings. This overwrites the buffer
+ * byte following each payload - always an already decoded value header,
+ * except for a string ending flush with the parsed value, where the
+ * byte at buf + consumed is clobbered. Callers that parse several
+ * values out of one buffer have to save and restore that byte. */
+void rmsgpack_dom_view_terminate(struct rmsgpack_dom_value *v);
+
+/* Releases the map/array tables of a value built by rmsgpack_dom_parse.
+ * String and binary views point into the caller's buffer and are left
+ * alone. */
+void rmsgpack_dom_view_free(struct rmsgpack_dom_value *v);
+
 int rmsgpack_dom_write(RFILE *fd, const struct rmsgpack_dom_value *obj);
 
 int rmsgpack_dom_read_into(RFILE *fd, ...);
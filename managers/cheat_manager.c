@@ -42,6 +42,15 @@
 
 #include "cheat_manager.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define CHEAT_SEARCH_SIMD
+#elif defined(__ARM_NEON__) && !defined(DONT_WANT_ARM_OPTIMIZATIONS)
+#include <arm_neon.h>
+#define CHEAT_SEARCH_NEON
+#define CHEAT_SEARCH_SIMD
+#endif
+
 #include "../msg_hash.h"
 #include "../configuration.h"
 #include "../retroarch.h"
@@ -995,6 +1004,225 @@ static void cheat_manager_setup_search_meta(
    }
 }
 
+/* page size used to decide whether a stretch of memory needs
+ * rescanning at all on this search step */
+#define CHEAT_SEARCH_PAGE_SIZE 4096
+
+static bool cheat_manager_search_can_skip_unchanged(
+      enum cheat_search_type search_type)
+{
+   /* for these types an unchanged byte always keeps its match,
+    * so pages identical to the previous snapshot need no rescan */
+   switch (search_type)
+   {
+      case CHEAT_SEARCH_TYPE_EQ:
+      case CHEAT_SEARCH_TYPE_LTE:
+      case CHEAT_SEARCH_TYPE_GTE:
+         return true;
+      default:
+         break;
+   }
+
+   return false;
+}
+
+static bool cheat_manager_search_byte_match(
+      enum cheat_search_type search_type,
+      unsigned curr_val, unsigned prev_val)
+{
+   cheat_manager_t *cheat_st = &cheat_manager_state;
+
+   switch (search_type)
+   {
+      case CHEAT_SEARCH_TYPE_EXACT:
+         return (curr_val == cheat_st->search_exact_value);
+      case CHEAT_SEARCH_TYPE_LT:
+         return (curr_val < prev_val);
+      case CHEAT_SEARCH_TYPE_GT:
+         return (curr_val > prev_val);
+      case CHEAT_SEARCH_TYPE_LTE:
+         return (curr_val <= prev_val);
+      case CHEAT_SEARCH_TYPE_GTE:
+         return (curr_val >= prev_val);
+      case CHEAT_SEARCH_TYPE_EQ:
+         return (curr_val == prev_val);
+      case CHEAT_SEARCH_TYPE_NEQ:
+         return (curr_val != prev_val);
+      case CHEAT_SEARCH_TYPE_EQPLUS:
+         return (curr_val == prev_val + cheat_st->search_eqplus_value);
+      case CHEAT_SEARCH_TYPE_EQMINUS:
+         return (curr_val == prev_val - cheat_st->search_eqminus_value);
+   }
+
+   return false;
+}
+
+/* compares one run of guest memory against the previous snapshot,
+ * clearing match bytes that no longer satisfy the search. Only valid
+ * for 8-bit searches, where match bytes are whole bytes. Returns the
+ * number of matches eliminated. */
+static unsigned cheat_manager_search_block(
+      enum cheat_search_type search_type,
+      const uint8_t *curr, const uint8_t *prev,
+      uint8_t *matches, size_t size)
+{
+   cheat_manager_t *cheat_st = &cheat_manager_state;
+   unsigned removed          = 0;
+   size_t i                  = 0;
+
+#ifdef CHEAT_SEARCH_SIMD
+   if (     search_type != CHEAT_SEARCH_TYPE_EQPLUS
+         && search_type != CHEAT_SEARCH_TYPE_EQMINUS
+         && (search_type != CHEAT_SEARCH_TYPE_EXACT
+            || cheat_st->search_exact_value <= 0xFF))
+   {
+#ifdef CHEAT_SEARCH_NEON
+      const uint8x16_t exact = vdupq_n_u8((uint8_t)cheat_st->search_exact_value);
+      const uint8x16_t zero  = vdupq_n_u8(0);
+      const uint8x16_t one   = vdupq_n_u8(1);
+
+      for (; i + 16 <= size; i += 16)
+      {
+         uint8x16_t c = vld1q_u8(curr + i);
+         uint8x16_t p = vld1q_u8(prev + i);
+         uint8x16_t m = vld1q_u8(matches + i);
+         uint8x16_t keep, gone;
+         uint64x2_t sums;
+
+         switch (search_type)
+         {
+            case CHEAT_SEARCH_TYPE_EXACT:
+               keep = vceqq_u8(c, exact);
+               break;
+            case CHEAT_SEARCH_TYPE_LT:
+               keep = vcltq_u8(c, p);
+               break;
+            case CHEAT_SEARCH_TYPE_GT:
+               keep = vcgtq_u8(c, p);
+               break;
+            case CHEAT_SEARCH_TYPE_LTE:
+               keep = vcleq_u8(c, p);
+               break;
+            case CHEAT_SEARCH_TYPE_GTE:
+               keep = vcgeq_u8(c, p);
+               break;
+            case CHEAT_SEARCH_TYPE_EQ:
+               keep = vceqq_u8(c, p);
+               break;
+            default: /* NEQ */
+               keep = vmvnq_u8(vceqq_u8(c, p));
+               break;
+         }
+
+         /* match bytes are non-zero while still live */
+         gone = vbicq_u8(vmvnq_u8(vceqq_u8(m, zero)), keep);
+         sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vandq_u8(gone, one))));
+         removed += (unsigned)(vgetq_lane_u64(sums, 0)
+               + vgetq_lane_u64(sums, 1));
+
+         vst1q_u8(matches + i, vandq_u8(m, keep));
+      }
+#else
+      const __m128i exact = _mm_set1_epi8((char)cheat_st->search_exact_value);
+      const __m128i zero  = _mm_setzero_si128();
+      const __m128i ones  = _mm_set1_epi8((char)0xFF);
+
+      for (; i + 16 <= size; i += 16)
+      {
+         __m128i c  = _mm_loadu_si128((const __m128i*)(curr + i));
+         __m128i p  = _mm_loadu_si128((const __m128i*)(prev + i));
+         __m128i m  = _mm_loadu_si128((const __m128i*)(matches + i));
+         __m128i eq = _mm_cmpeq_epi8(c, p);
+         /* SSE2 has no unsigned byte compare; saturating subtraction
+          * gives zero exactly where curr <= prev */
+         __m128i le = _mm_cmpeq_epi8(_mm_subs_epu8(c, p), zero);
+         __m128i ge = _mm_cmpeq_epi8(_mm_subs_epu8(p, c), zero);
+         __m128i keep;
+         unsigned gone_mask;
+
+         switch (search_type)
+         {
+            case CHEAT_SEARCH_TYPE_EXACT:
+               keep = _mm_cmpeq_epi8(c, exact);
+               break;
+            case CHEAT_SEARCH_TYPE_LT:
+               keep = _mm_andnot_si128(eq, le);
+               break;
+            case CHEAT_SEARCH_TYPE_GT:
+               keep = _mm_andnot_si128(eq, ge);
+               break;
+            case CHEAT_SEARCH_TYPE_LTE:
+               keep = le;
+               break;
+            case CHEAT_SEARCH_TYPE_GTE:
+               keep = ge;
+               break;
+            case CHEAT_SEARCH_TYPE_EQ:
+               keep = eq;
+               break;
+            default: /* NEQ */
+               keep = _mm_xor_si128(eq, ones);
+               break;
+         }
+
+         /* match bytes are non-zero while still live */
+         gone_mask = _mm_movemask_epi8(_mm_andnot_si128(keep,
+               _mm_xor_si128(_mm_cmpeq_epi8(m, zero), ones)));
+
+         while (gone_mask)
+         {
+            gone_mask &= gone_mask - 1;
+            removed++;
+         }
+
+         _mm_storeu_si128((__m128i*)(matches + i), _mm_and_si128(m, keep));
+      }
+#endif
+   }
+#endif
+
+   for (; i < size; i++)
+   {
+      if (matches[i] &&
+            !cheat_manager_search_byte_match(search_type, curr[i], prev[i]))
+      {
+         matches[i] = 0;
+         removed++;
+      }
+   }
+
+   return removed;
+}
+
+static unsigned cheat_manager_search_buffer(
+      enum cheat_search_type search_type,
+      const uint8_t *curr, const uint8_t *prev,
+      uint8_t *matches, size_t size)
+{
+   size_t i;
+   unsigned removed = 0;
+
+   if (!cheat_manager_search_can_skip_unchanged(search_type))
+      return cheat_manager_search_block(search_type,
+            curr, prev, matches, size);
+
+   for (i = 0; i < size; i += CHEAT_SEARCH_PAGE_SIZE)
+   {
+      size_t page = size - i;
+
+      if (page > CHEAT_SEARCH_PAGE_SIZE)
+         page = CHEAT_SEARCH_PAGE_SIZE;
+
+      if (memcmp(curr + i, prev + i, page) == 0)
+         continue;
+
+      removed += cheat_manager_search_block(search_type,
+            curr + i, prev + i, matches + i, page);
+   }
+
+   return removed;
+}
+
 static int cheat_manager_search(enum cheat_search_type search_type)
 {
    char msg[100];
@@ -1019,92 +1247,116 @@ static int cheat_manager_search(enum cheat_search_type search_type)
 
    cheat_manager_setup_search_meta(cheat_st->search_bit_size, &bytes_per_item, &mask, &bits);
 
-   /* little endian FF000000 = 256 */
-   for (idx = 0; idx < cheat_st->total_memory_size; idx = idx + bytes_per_item)
+   if (bits == 8 && bytes_per_item == 1)
    {
-      unsigned byte_part;
-
-      offset = translate_address(idx, &curr);
+      /* 8-bit searches compare whole bytes, so each memory buffer can
+       * be scanned in place without translating addresses per item */
+      size_t buf_offset = 0;
 
-      switch (bytes_per_item)
+      for (i = 0; i < cheat_st->num_memory_buffers; i++)
       {
-         case 2:
-            curr_val = cheat_st->big_endian ?
-               (*(curr + idx - offset) * 256) + *(curr + idx + 1 - offset) :
-               *(curr + idx - offset) + (*(curr + idx + 1 - offset) * 256);
-            prev_val = cheat_st->big_endian ?
-               (*(prev + idx) * 256) + *(prev + idx + 1) :
-               *(prev + idx) + (*(prev + idx + 1) * 256);
-            break;
-         case 4:
-            curr_val = cheat_st->big_endian ?
-               (*(curr + idx - offset) * 256 * 256 * 256) + (*(curr + idx + 1 - offset) * 256 * 256) + (*(curr + idx + 2 - offset) * 256) + *(curr + idx + 3 - offset) :
-               *(curr + idx - offset) + (*(curr + idx + 1 - offset) * 256) + (*(curr + idx + 2 - offset) * 256 * 256) + (*(curr + idx + 3 - offset) * 256 * 256 * 256);
-            prev_val = cheat_st->big_endian ?
-               (*(prev + idx) * 256 * 256 * 256) + (*(prev + idx + 1) * 256 * 256) + (*(prev + idx + 2) * 256) + *(prev + idx + 3) :
-               *(prev + idx) + (*(prev + idx + 1) * 256) + (*(prev + idx + 2) * 256 * 256) + (*(prev + idx + 3) * 256 * 256 * 256);
-            break;
-         case 1:
-         default:
-            curr_val = *(curr - offset + idx);
-            prev_val = *(prev + idx);
-            break;
-      }
+         const size_t buf_size  = cheat_st->memory_size_list[i];
+         const unsigned removed = cheat_manager_search_buffer(search_type,
+               cheat_st->memory_buf_list[i], prev + buf_offset,
+               cheat_st->matches + buf_offset, buf_size);
 
-      for (byte_part = 0; byte_part < 8 / bits; byte_part++)
+         if (removed < cheat_st->num_matches)
+            cheat_st->num_matches -= removed;
+         else
+            cheat_st->num_matches = 0;
+
+         buf_offset += buf_size;
+      }
+   }
+   else
+   {
+      /* little endian FF000000 = 256 */
+      for (idx = 0; idx < cheat_st->total_memory_size; idx = idx + bytes_per_item)
       {
-         unsigned int curr_subval = (curr_val >> (byte_part * bits)) & mask;
-         unsigned int prev_subval = (prev_val >> (byte_part * bits)) & mask;
-         unsigned int prev_match;
+         unsigned byte_part;
 
-         if (bits < 8)
-            prev_match = *(cheat_st->matches + idx) & (mask << (byte_part * bits));
-         else
-            prev_match = *(cheat_st->matches + idx);
+         offset = translate_address(idx, &curr);
 
-         if (prev_match > 0)
+         switch (bytes_per_item)
          {
-            bool match = false;
-            switch (search_type)
-            {
-               case CHEAT_SEARCH_TYPE_EXACT:
-                  match = (curr_subval == cheat_st->search_exact_value);
-                  break;
-               case CHEAT_SEARCH_TYPE_LT:
-                  match = (curr_subval < prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_GT:
-                  match = (curr_subval > prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_LTE:
-                  match = (curr_subval <= prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_GTE:
-                  match = (curr_subval >= prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_EQ:
-                  match = (curr_subval == prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_NEQ:
-                  match = (curr_subval != prev_subval);
-                  break;
-               case CHEAT_SEARCH_TYPE_EQPLUS:
-                  match = (curr_subval == prev_subval + cheat_st->search_eqplus_value);
-                  break;
-               case CHEAT_SEARCH_TYPE_EQMINUS:
-                  match = (curr_subval == prev_subval - cheat_st->search_eqminus_value);
-                  break;
-            }
+            case 2:
+               curr_val = cheat_st->big_endian ?
+                  (*(curr + idx - offset) * 256) + *(curr + idx + 1 - offset) :
+                  *(curr + idx - offset) + (*(curr + idx + 1 - offset) * 256);
+               prev_val = cheat_st->big_endian ?
+                  (*(prev + idx) * 256) + *(prev + idx + 1) :
+                  *(prev + idx) + (*(prev + idx + 1) * 256);
+               break;
+            case 4:
+               curr_val = cheat_st->big_endian ?
+                  (*(curr + idx - offset) * 256 * 256 * 256) + (*(curr + idx + 1 - offset) * 256 * 256) + (*(curr + idx + 2 - offset) * 256) + *(curr + idx + 3 - offset) :
+                  *(curr + idx - offset) + (*(curr + idx + 1 - offset) * 256) + (*(curr + idx + 2 - offset) * 256 * 256) + (*(curr + idx + 3 - offset) * 256 * 256 * 256);
+               prev_val = cheat_st->big_endian ?
+                  (*(prev + idx) * 256 * 256 * 256) + (*(prev + idx + 1) * 256 * 256) + (*(prev + idx + 2) * 256) + *(prev + idx + 3) :
+                  *(prev + idx) + (*(prev + idx + 1) * 256) + (*(prev + idx + 2) * 256 * 256) + (*(prev + idx + 3) * 256 * 256 * 256);
+               break;
+            case 1:
+            default:
+               curr_val = *(curr - offset + idx);
+               prev_val = *(prev + idx);
+               break;
+         }
+
+         for (byte_part = 0; byte_part < 8 / bits; byte_part++)
+         {
+            unsigned int curr_subval = (curr_val >> (byte_part * bits)) & mask;
+            unsigned int prev_subval = (prev_val >> (byte_part * bits)) & mask;
+            unsigned int prev_match;
+
+            if (bits < 8)
+               prev_match = *(cheat_st->matches + idx) & (mask << (byte_part * bits));
+            else
+               prev_match = *(cheat_st->matches + idx);
 
-            if (!match)
+            if (prev_match > 0)
             {
-               if (bits < 8)
-                  *(cheat_st->matches + idx) = *(cheat_st->matches + idx) &
-                     ((~(mask << (byte_part * bits))) & 0xFF);
-               else
-                  memset(cheat_st->matches + idx, 0, bytes_per_item);
-               if (cheat_st->num_matches > 0)
-                  cheat_st->num_matches--;
+               bool match = false;
+               switch (search_type)
+               {
+                  case CHEAT_SEARCH_TYPE_EXACT:
+                     match = (curr_subval == cheat_st->search_exact_value);
+                     break;
+                  case CHEAT_SEARCH_TYPE_LT:
+                     match = (curr_subval < prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_GT:
+                     match = (curr_subval > prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_LTE:
+                     match = (curr_subval <= prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_GTE:
+                     match = (curr_subval >= prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_EQ:
+                     match = (curr_subval == prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_NEQ:
+                     match = (curr_subval != prev_subval);
+                     break;
+                  case CHEAT_SEARCH_TYPE_EQPLUS:
+                     match = (curr_subval == prev_subval + cheat_st->search_eqplus_value);
+                     break;
+                  case CHEAT_SEARCH_TYPE_EQMINUS:
+                     match = (curr_subval == prev_subval - cheat_st->search_eqminus_value);
+                     break;
+               }
+
+               if (!match)
+               {
+                  if (bits < 8)
+                     *(cheat_st->matches + idx) = *(cheat_st->matches + idx) &
+                        ((~(mask << (byte_part * bits))) & 0xFF);
+                  else
+                     memset(cheat_st->matches + idx, 0, bytes_per_item);
+                  if (cheat_st->num_matches > 0)
+                     cheat_st->num_matches--;
+               }
             }
          }
       }
@@ -18,6 +18,7 @@
 #define CORE_OPTION_MANAGER_H__
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <boolean.h>
 #include <retro_common_api.h>
@@ -27,6 +28,10 @@
 
 RETRO_BEGIN_DECLS
 
+/* Number of recent RETRO_ENVIRONMENT_GET_VARIABLE queries
+ * memoised per option manager */
+#define CORE_OPTION_QUERY_CACHE_SIZE 32
+
 struct core_option
 {
    char *desc;
@@ -36,6 +41,7 @@ struct core_option
    struct string_list *val_labels;
    size_t default_index;
    size_t index;
+   uint32_t key_hash;
    bool visible;
 };
 
@@ -46,6 +52,34 @@ struct core_option_manager
 
    struct core_option *opts;
    size_t size;
+
+   /* Open-addressed map from key hash to option index + 1
+    * (0 = empty slot); sized to a power of two of at least
+    * twice the option count. NULL if allocation failed, in
+    * which case lookups fall back to a linear search. */
+   size_t *hash_map;
+   size_t hash_map_mask;
+
+   /* Bumped on every option value change, so repeat
+    * GET_VARIABLE queries can be answered from the
+    * memo below without touching the key string */
+   uint32_t version;
+
+   /* Memo of recent GET_VARIABLE queries, keyed on the
+    * exact key pointer the core passed (cores query with
+    * the same static strings every frame). Hits are
+    * confirmed against the option's key string - pointer
+    * identity alone is not trusted, since nothing stops a
+    * core from reusing one buffer for different keys */
+   struct
+   {
+      const char *key;
+      const char *value;
+      size_t idx;
+      uint32_t version;
+   } query_cache[CORE_OPTION_QUERY_CACHE_SIZE];
+   size_t query_cache_pos;
+
    bool updated;
 };
 
@@ -23,10 +23,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <memalign.h>
 #include <retro_inline.h>
 #include <compat/strl.h>
 #include <compat/intrinsics.h>
 
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
 #include "state_manager.h"
 #include "../msg_hash.h"
 #include "../core.h"
@@ -60,6 +65,8 @@
 
 #if __SSE2__
 #include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
 #endif
 
 struct state_manager
@@ -87,6 +94,19 @@ struct state_manager
 
    unsigned entries;
    bool thisblock_valid;
+
+#ifdef HAVE_THREADS
+   /* Worker thread that runs the delta encoder, so the
+    * main thread only pays for core_serialize(). All
+    * other fields belong to the main thread while
+    * compress_pending is false, and to the worker while
+    * it is true; 'lock' only guards these three. */
+   sthread_t *thread;
+   slock_t *lock;
+   scond_t *cond;
+   bool compress_pending;
+   bool thread_exit;
+#endif
 };
 
 struct state_manager_rewind_state
@@ -145,6 +165,33 @@ static size_t find_change(const uint16_t *a, const uint16_t *b)
       a128++;
       b128++;
    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+   const uint16_t *a_org = a;
+
+   for (;;)
+   {
+      uint16x8_t v0 = vld1q_u16(a);
+      uint16x8_t v1 = vld1q_u16(b);
+      /* Narrow the per-lane compare result to one byte
+       * per lane, then pull it down as a single scalar;
+       * cheaper than the movemask dance NEON lacks. */
+      uint8x8_t  c  = vmovn_u16(vceqq_u16(v0, v1));
+      uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(c), 0);
+
+      if (mask != ~UINT64_C(0)) /* Something has changed, figure out where. */
+      {
+         /* At most seven iterations before the mismatch. */
+         while (*a == *b)
+         {
+            a++;
+            b++;
+         }
+         return a - a_org;
+      }
+
+      a += 8;
+      b += 8;
+   }
 #else
    const uint16_t *a_org = a;
 #ifdef NO_UNALIGNED_MEM
@@ -233,12 +280,21 @@ static size_t state_manager_raw_maxsize(size_t uncomp)
 
 /*
  * See state_manager_raw_compress for information about this.
- * When you're done with it, send it to free().
+ * When you're done with it, send it to memalign_free_big()
+ * along with the same total size it was allocated with.
  */
 static void *state_manager_raw_alloc(size_t len, uint16_t uniq)
 {
    size_t  len16 = (len + sizeof(uint16_t) - 1) & -sizeof(uint16_t);
-   uint16_t *ret = (uint16_t*)calloc(len16 + sizeof(uint16_t) * 4 + 16, 1);
+   uint16_t *ret = (uint16_t*)memalign_alloc_big(
+         len16 + sizeof(uint16_t) * 4 + 16);
+
+   if (!ret)
+      return NULL;
+
+   /* Serialized into and compared against every frame -
+    * worth hugepage backing on platforms that offer it. */
+   memset(ret, 0, len16 + sizeof(uint16_t) * 4 + 16);
 
    /* Force in a different byte at the end, so we don't need to check
     * bounds in the innermost loop (it's expensive).
@@ -408,17 +464,138 @@ static INLINE size_t read_size_t(const void *ptr)
    return ret;
 }
 
+/* Compresses nextblock against thisblock into the ring
+ * buffer and swaps the two. Runs on the worker thread
+ * when one is available, on the caller otherwise. */
+static void state_manager_push_execute(state_manager_t *state)
+{
+   uint8_t *swap = NULL;
+
+   if (state->thisblock_valid)
+   {
+      const uint8_t *oldb, *newb;
+      uint8_t *compressed;
+      size_t headpos, tailpos, remaining;
+      if (state->capacity < sizeof(size_t) + state->maxcompsize)
+         return;
+
+recheckcapacity:;
+
+      headpos = state->head - state->data;
+      tailpos = state->tail - state->data;
+      remaining = (tailpos + state->capacity -
+            sizeof(size_t) - headpos - 1) % state->capacity + 1;
+
+      if (remaining <= state->maxcompsize)
+      {
+         state->tail = state->data + read_size_t(state->tail);
+         state->entries--;
+         goto recheckcapacity;
+      }
+
+      oldb        = state->thisblock;
+      newb        = state->nextblock;
+      compressed  = state->head + sizeof(size_t);
+
+      compressed += state_manager_raw_compress(oldb, newb,
+            state->blocksize, compressed);
+
+      if (compressed - state->data + state->maxcompsize > state->capacity)
+      {
+         compressed = state->data;
+         if (state->tail == state->data + sizeof(size_t))
+            state->tail = state->data + read_size_t(state->tail);
+      }
+      write_size_t(compressed, state->head-state->data);
+      compressed += sizeof(size_t);
+      write_size_t(state->head, compressed-state->data);
+      state->head = compressed;
+   }
+   else
+      state->thisblock_valid = true;
+
+   swap             = state->thisblock;
+   state->thisblock = state->nextblock;
+   state->nextblock = swap;
+
+   state->entries++;
+}
+
+#ifdef HAVE_THREADS
+static void state_manager_thread(void *data)
+{
+   state_manager_t *state = (state_manager_t*)data;
+
+   slock_lock(state->lock);
+
+   while (!state->thread_exit)
+   {
+      if (!state->compress_pending)
+      {
+         scond_wait(state->cond, state->lock);
+         continue;
+      }
+
+      /* The main thread keeps its hands off the manager
+       * while compress_pending is set, so the actual work
+       * happens outside the lock. */
+      slock_unlock(state->lock);
+      state_manager_push_execute(state);
+      slock_lock(state->lock);
+
+      state->compress_pending = false;
+      scond_signal(state->cond);
+   }
+
+   slock_unlock(state->lock);
+}
+
+/* Waits for any in-flight compression job. The main
+ * thread must call this before touching the manager. */
+static void state_manager_sync(state_manager_t *state)
+{
+   if (!state->thread)
+      return;
+
+   slock_lock(state->lock);
+   while (state->compress_pending)
+      scond_wait(state->cond, state->lock);
+   slock_unlock(state->lock);
+}
+#endif
+
 static void state_manager_free(state_manager_t *state)
 {
    if (!state)
       return;
 
+#ifdef HAVE_THREADS
+   if (state->thread)
+   {
+      state_manager_sync(state);
+      slock_lock(state->lock);
+      state->thread_exit = true;
+      scond_signal(state->cond);
+      slock_unlock(state->lock);
+      sthread_join(state->thread);
+      state->thread = NULL;
+   }
+   if (state->lock)
+      slock_free(state->lock);
+   if (state->cond)
+      scond_free(state->cond);
+   state->lock = NULL;
+   state->cond = NULL;
+#endif
+
    if (state->data)
-      free(state->data);
+      memalign_free_big(state->data, state->capacity);
    if (state->thisblock)
-      free(state->thisblock);
+      memalign_free_big(state->thisblock,
+            state->blocksize + sizeof(uint16_t) * 4 + 16);
    if (state->nextblock)
-      free(state->nextblock);
+      memalign_free_big(state->nextblock,
+            state->blocksize + sizeof(uint16_t) * 4 + 16);
 #if STRICT_BUF_SIZE
    if (state->debugblock)
       free(state->debugblock);
@@ -444,7 +621,7 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
 
    /* the compressed data is surrounded by pointers to the other side */
    max_comp_size      = state_manager_raw_maxsize(state_size) + sizeof(size_t) * 2;
-   state_data         = (uint8_t*)malloc(buffer_size);
+   state_data         = (uint8_t*)memalign_alloc_big(buffer_size);
 
    if (!state_data)
       goto error;
@@ -470,11 +647,20 @@ static state_manager_t *state_manager_new(size_t state_size, size_t buffer_size)
    state->debugblock  = (uint8_t*)malloc(state_size);
 #endif
 
+#ifdef HAVE_THREADS
+   /* If any of this fails we just keep compressing on the
+    * main thread, like we always did. */
+   state->lock = slock_new();
+   state->cond = scond_new();
+   if (state->lock && state->cond)
+      state->thread = sthread_create(state_manager_thread, state);
+#endif
+
    return state;
 
 error:
    if (state_data)
-      free(state_data);
+      memalign_free_big(state_data, buffer_size);
    state_manager_free(state);
    free(state);
 
@@ -487,6 +673,10 @@ static bool state_manager_pop(state_manager_t *state, const void **data)
    uint8_t *out                 = NULL;
    const uint8_t *compressed    = NULL;
 
+#ifdef HAVE_THREADS
+   state_manager_sync(state);
+#endif
+
    *data = NULL;
 
    if (state->thisblock_valid)
@@ -520,6 +710,12 @@ static void state_manager_push_where(state_manager_t *state, void **data)
     * pushed state, or we could end up applying a 'patch' to wrong
     * savestate, and that'd blow up rather quickly. */
 
+#ifdef HAVE_THREADS
+   /* The worker may still be reading both blocks; by now
+    * (a frame later) it is almost always done already. */
+   state_manager_sync(state);
+#endif
+
    if (!state->thisblock_valid)
    {
       const void *ignored;
@@ -538,60 +734,26 @@ static void state_manager_push_where(state_manager_t *state, void **data)
 
 static void state_manager_push_do(state_manager_t *state)
 {
-   uint8_t *swap = NULL;
-
 #if STRICT_BUF_SIZE
    memcpy(state->nextblock, state->debugblock, state->debugsize);
 #endif
 
-   if (state->thisblock_valid)
+#ifdef HAVE_THREADS
+   if (state->thread)
    {
-      const uint8_t *oldb, *newb;
-      uint8_t *compressed;
-      size_t headpos, tailpos, remaining;
-      if (state->capacity < sizeof(size_t) + state->maxcompsize)
-         return;
-
-recheckcapacity:;
-
-      headpos = state->head - state->data;
-      tailpos = state->tail - state->data;
-      remaining = (tailpos + state->capacity -
-            sizeof(size_t) - headpos - 1) % state->capacity + 1;
-
-      if (remaining <= state->maxcompsize)
-      {
-         state->tail = state->data + read_size_t(state->tail);
-         state->entries--;
-         goto recheckcapacity;
-      }
-
-      oldb        = state->thisblock;
-      newb        = state->nextblock;
-      compressed  = state->head + sizeof(size_t);
-
-      compressed += state_manager_raw_compress(oldb, newb,
-            state->blocksize, compressed);
-
-      if (compressed - state->data + state->maxcompsize > state->capacity)
-      {
-         compressed = state->data;
-         if (state->tail == state->data + sizeof(size_t))
-            state->tail = state->data + read_size_t(state->tail);
-      }
-      write_size_t(compressed, state->head-state->data);
-      compressed += sizeof(size_t);
-      write_size_t(state->head, compressed-state->data);
-      state->head = compressed;
+      /* Hand the snapshot to the worker; emulation of the
+       * next frame overlaps the delta encoder, and
+       * state_manager_sync() collects the result before
+       * anyone touches the buffers again. */
+      slock_lock(state->lock);
+      state->compress_pending = true;
+      scond_signal(state->cond);
+      slock_unlock(state->lock);
+      return;
    }
-   else
-      state->thisblock_valid = true;
-
-   swap             = state->thisblock;
-   state->thisblock = state->nextblock;
-   state->nextblock = swap;
+#endif
 
-   state->entries++;
+   state_manager_push_execute(state);
 }
 
 #if 0
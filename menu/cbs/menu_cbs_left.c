@@ -81,6 +81,7 @@ static int shader_action_parameter_left_internal(unsigned type, const char *labe
 
    if (!param_prev || !param_menu)
       return menu_cbs_exit();
+   menu_shader_param_undo_record(type - offset, param_prev->current);
    ret = generic_shader_action_parameter_left(param_prev, type, label, wraparound);
 
    param_menu->current = param_prev->current;
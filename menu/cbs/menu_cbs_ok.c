@@ -1723,10 +1723,18 @@ static int generic_action_ok(const char *path,
             /* Cache selected shader parent directory */
             menu_driver_set_last_shader_preset_dir(action_path);
 
-            menu_shader_manager_set_preset(shader,
-                  menu_driver_get_last_shader_preset_type(),
-                  action_path,
-                  true);
+            /* Slang presets are compiled on a worker task so
+             * that the current chain keeps rendering; other
+             * backends apply immediately */
+#ifdef HAVE_SLANG
+            if (!task_push_shader_preset_load(
+                     menu_driver_get_last_shader_preset_type(),
+                     action_path))
+#endif
+               menu_shader_manager_set_preset(shader,
+                     menu_driver_get_last_shader_preset_type(),
+                     action_path,
+                     true);
          }
 #endif
          break;
@@ -4670,6 +4678,13 @@ DEFAULT_ACTION_OK_CMD_FUNC(action_ok_restart_content,          CMD_EVENT_RESET)
 DEFAULT_ACTION_OK_CMD_FUNC(action_ok_screenshot,               CMD_EVENT_TAKE_SCREENSHOT)
 #if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
 DEFAULT_ACTION_OK_CMD_FUNC(action_ok_shader_apply_changes,     CMD_EVENT_SHADERS_APPLY_CHANGES)
+
+static int action_ok_shader_parameters_undo(const char *path,
+      const char *label, unsigned type, size_t idx, size_t entry_idx)
+{
+   menu_shader_param_undo_pop();
+   return 0;
+}
 #endif
 DEFAULT_ACTION_OK_CMD_FUNC(action_ok_show_wimp,                CMD_EVENT_UI_COMPANION_TOGGLE)
 
@@ -5358,6 +5373,17 @@ static void netplay_refresh_rooms_cb(retro_task_t *task,
             lan_room_count                    = (int)lan_hosts->size;
 #endif
 
+         /* If the lobby payload is unchanged and no LAN hosts are
+          * involved, the room list built on the previous refresh is
+          * still valid - keep the menu entries as they are instead
+          * of tearing them down and rebuilding them. */
+         if (     lan_room_count == 0
+               && netplay_room_list
+               && (netplay_room_count == 0
+                  || !netplay_room_list[netplay_room_count - 1].lan)
+               && netplay_rooms_is_cached(data->data))
+            goto finish;
+
          netplay_rooms_parse(data->data);
 
          if (netplay_room_list)
@@ -5506,7 +5532,10 @@ static int action_ok_push_netplay_refresh_rooms(const char *path,
 #ifndef RARCH_CONSOLE
    task_push_netplay_lan_scan(netplay_lan_scan_callback);
 #endif
-   task_push_http_transfer(url, true, NULL, netplay_refresh_rooms_cb, NULL);
+   /* Cached: the lobby list rarely changes between refreshes, so
+    * revalidating with If-None-Match/If-Modified-Since usually
+    * turns the full download into a 304 */
+   task_push_http_transfer_cached(url, true, NULL, netplay_refresh_rooms_cb, NULL);
    return 0;
 }
 #endif
@@ -7024,6 +7053,7 @@ static int menu_cbs_init_bind_ok_compare_label(menu_file_list_cbs_t *cbs,
          {MENU_ENUM_LABEL_VIDEO_SHADER_PASS,                   action_ok_shader_pass},
          {MENU_ENUM_LABEL_VIDEO_SHADER_PRESET,                 action_ok_shader_preset},
          {MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS,             action_ok_shader_parameters},
+         {MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS_UNDO,        action_ok_shader_parameters_undo},
          {MENU_ENUM_LABEL_VIDEO_SHADER_PRESET_PARAMETERS,      action_ok_shader_parameters},
          {MENU_ENUM_LABEL_SHADER_APPLY_CHANGES,                action_ok_shader_apply_changes},
          {MENU_ENUM_LABEL_VIDEO_SHADER_PRESET_REMOVE,          action_ok_shader_preset_remove},
@@ -220,6 +220,7 @@ static int action_start_shader_action_parameter_generic(
 
    param          = &shader_info.data->parameters
       [parameter];
+   menu_shader_param_undo_record(parameter, param->current);
    param->current = param->initial;
    param->current = MIN(MAX(param->minimum, param->current), param->maximum);
 
@@ -798,6 +798,7 @@ DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_preset_remove_core,
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_preset_remove_parent,             MENU_ENUM_SUBLABEL_VIDEO_SHADER_PRESET_REMOVE_PARENT)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_preset_remove_game,               MENU_ENUM_SUBLABEL_VIDEO_SHADER_PRESET_REMOVE_GAME)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_parameters,                     MENU_ENUM_SUBLABEL_VIDEO_SHADER_PARAMETERS)
+DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_parameters_undo,                MENU_ENUM_SUBLABEL_VIDEO_SHADER_PARAMETERS_UNDO)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_shader_preset_parameters,              MENU_ENUM_SUBLABEL_VIDEO_SHADER_PRESET_PARAMETERS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_quick_menu,                            MENU_ENUM_SUBLABEL_CONTENT_SETTINGS)
 DEFAULT_SUBLABEL_MACRO(action_bind_sublabel_core_information,                      MENU_ENUM_SUBLABEL_CORE_INFORMATION)
@@ -962,9 +963,13 @@ static int action_bind_sublabel_cheevos_entry(
 
    rcheevos_get_description((rcheevos_ctx_desc_t*) &desc_info);
 
+   /* Achievement descriptions are fixed for the
+    * lifetime of the list - cache them */
    strlcpy(s, desc_info.s, len);
-#endif
+   return 1;
+#else
    return 0;
+#endif
 }
 
 static int action_bind_sublabel_subsystem_add(
@@ -1045,11 +1050,17 @@ static int action_bind_sublabel_remap_kbd_sublabel(
       const char *label, const char *path,
       char *s, size_t len)
 {
+   size_t _len       = 0;
    unsigned user_idx = (type - MENU_SETTINGS_INPUT_DESC_KBD_BEGIN) / RARCH_FIRST_CUSTOM_BIND;
 
-   snprintf(s, len, "%s #%d: %s",
-         msg_hash_to_str(MENU_ENUM_LABEL_VALUE_PORT),
-         user_idx + 1,
+   /* These run for every visible row whenever sublabels
+    * refresh, so avoid going through printf formatting */
+   _len = string_append(s, len, _len,
+         msg_hash_to_str(MENU_ENUM_LABEL_VALUE_PORT));
+   _len = string_append(s, len, _len, " #");
+   _len = string_append_unsigned(s, len, _len, user_idx + 1);
+   _len = string_append(s, len, _len, ": ");
+   string_append(s, len, _len,
          input_config_get_device_display_name(user_idx) ?
          input_config_get_device_display_name(user_idx) :
          (input_config_get_device_name(user_idx) ?
@@ -1106,12 +1117,16 @@ static int action_bind_sublabel_remap_sublabel(
       const char *label, const char *path,
       char *s, size_t len)
 {
+   size_t _len     = 0;
    unsigned offset = (type - MENU_SETTINGS_INPUT_DESC_BEGIN)
       / (RARCH_FIRST_CUSTOM_BIND + 8);
 
-   snprintf(s, len, "%s #%d: %s",
-         msg_hash_to_str(MENU_ENUM_LABEL_VALUE_PORT),
-         offset + 1,
+   _len = string_append(s, len, _len,
+         msg_hash_to_str(MENU_ENUM_LABEL_VALUE_PORT));
+   _len = string_append(s, len, _len, " #");
+   _len = string_append_unsigned(s, len, _len, offset + 1);
+   _len = string_append(s, len, _len, ": ");
+   string_append(s, len, _len,
          input_config_get_device_display_name(offset) ?
          input_config_get_device_display_name(offset) :
          (input_config_get_device_name(offset) ?
@@ -1135,6 +1150,11 @@ static int action_bind_sublabel_cheat_desc(
          strlcpy(s, "Emulator-Handled", len);
       else
          strlcpy(s, "RetroArch-Handled", len);
+
+      /* Changing the handler type goes through the cheat
+       * details screen, which refreshes this list - so the
+       * result can be cached */
+      return 1;
    }
 
    return 0;
@@ -1228,7 +1248,11 @@ static int action_bind_sublabel_netplay_room(
             gamecrc);
       }
    }
-   return 0;
+
+   /* Room info only changes when the room list is
+    * refreshed, which rebuilds this list - so the
+    * result can be cached */
+   return 1;
 }
 #endif
 
@@ -1307,7 +1331,7 @@ static int action_bind_sublabel_playlist_entry(
          !content_runtime_log) ||
        ((playlist_sublabel_runtime_type == PLAYLIST_RUNTIME_AGGREGATE) &&
          !content_runtime_log_aggregate))
-      return 0;
+      return 1;
 
    /* Note: This looks heavy, but each string_is_equal() call will
     * return almost immediately */
@@ -1317,7 +1341,7 @@ static int action_bind_sublabel_playlist_entry(
        !string_is_equal(label, msg_hash_to_str(MENU_ENUM_LABEL_FAVORITES_TAB)) &&
        !string_is_equal(label, msg_hash_to_str(MENU_ENUM_LABEL_DEFERRED_PLAYLIST_LIST)) &&
        !string_is_equal(label, msg_hash_to_str(MENU_ENUM_LABEL_HORIZONTAL_MENU)))
-      return 0;
+      return 1;
 
    /* Check whether runtime info should be loaded from log file */
    if (entry->runtime_status == PLAYLIST_RUNTIME_UNKNOWN)
@@ -1354,7 +1378,11 @@ static int action_bind_sublabel_playlist_entry(
          strlcat(s, tmp, len);
    }
 
-   return 0;
+   /* Runtime/last played info only changes while content
+    * is running, and closing content refreshes the menu
+    * list (which resets the sublabel cache) - so the
+    * result can be cached */
+   return 1;
 }
 
 static int action_bind_sublabel_core_option(
@@ -1372,7 +1400,12 @@ static int action_bind_sublabel_core_option(
    info = core_option_manager_get_info(opt, type - MENU_SETTINGS_CORE_OPTION_START);
 
    if (!string_is_empty(info))
+   {
+      /* Option info text is fixed for the lifetime
+       * of the list - cache it */
       strlcpy(s, info, len);
+      return 1;
+   }
 
    return 0;
 }
@@ -1832,6 +1865,9 @@ int menu_cbs_init_bind_sublabel(menu_file_list_cbs_t *cbs,
          case MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_shader_parameters);
             break;
+         case MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS_UNDO:
+            BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_shader_parameters_undo);
+            break;
          case MENU_ENUM_LABEL_VIDEO_SHADER_PRESET_PARAMETERS:
             BIND_ACTION_SUBLABEL(cbs, action_bind_sublabel_shader_preset_parameters);
             break;
@@ -4643,7 +4643,7 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
 
    /* Draw sidebar background
     * > Surface */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -4653,10 +4653,11 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
          (unsigned)background_height,
          video_width,
          video_height,
-         mui->colors.side_bar_background);
+         mui->colors.side_bar_background,
+         0);
 
    /* > Divider */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -4666,11 +4667,12 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
          (unsigned)background_height,
          video_width,
          video_height,
-         mui->colors.entry_divider);
+         mui->colors.entry_divider,
+         0);
 
    /* > Additional divider */
    if (mui->landscape_optimization.enabled)
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -4680,7 +4682,11 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
             (unsigned)background_height,
             video_width,
             video_height,
-            mui->colors.entry_divider);
+            mui->colors.entry_divider,
+            0);
+
+   /* Submit sidebar surface + dividers with a single draw call */
+   gfx_display_batch_flush(userdata, video_width, video_height);
 
    /* Draw thumbnails */
    if (node)
@@ -4751,7 +4757,7 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
 
       /* Background
        * > Surface */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -4761,12 +4767,13 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
             mui->status_bar.height,
             video_width,
             video_height,
-            mui->colors.status_bar_background);
+            mui->colors.status_bar_background,
+            0);
 
       /* > Shadow
        *   (For symmetry, header and status bar
        *    shadows have the same height) */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -4776,7 +4783,11 @@ static void materialui_render_selected_entry_aux_playlist_desktop(
             mui->header_shadow_height,
             video_width,
             video_height,
-            mui->colors.status_bar_shadow);
+            mui->colors.status_bar_shadow,
+            0);
+
+      /* Submit surface + shadow with a single draw call */
+      gfx_display_batch_flush(userdata, video_width, video_height);
 
       /* Text */
       if ((text_width > 0) && !string_is_empty(mui->status_bar.str))
@@ -5054,7 +5065,7 @@ static void materialui_render_landscape_border(
       int y                  = (int)header_height;
 
       /* Draw left border */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -5064,10 +5075,11 @@ static void materialui_render_landscape_border(
             border_height,
             video_width,
             video_height,
-            mui->colors.landscape_border_shadow_left);
+            mui->colors.landscape_border_shadow_left,
+            0);
 
       /* Draw right border */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -5077,7 +5089,11 @@ static void materialui_render_landscape_border(
             border_height,
             video_width,
             video_height,
-            mui->colors.landscape_border_shadow_right);
+            mui->colors.landscape_border_shadow_right,
+            0);
+
+      /* Submit both border shadows with a single draw call */
+      gfx_display_batch_flush(userdata, video_width, video_height);
    }
 }
 
@@ -5118,7 +5134,7 @@ static void materialui_render_selection_highlight(
       highlight_height = (int)(node->entry_height + 1.5f);
 
       /* Draw highlight quad */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -5128,12 +5144,13 @@ static void materialui_render_selection_highlight(
             (unsigned)highlight_height,
             video_width,
             video_height,
-            highlight_color);
+            highlight_color,
+            0);
 
       /* Draw shadow, if required */
       if (mui->show_selection_marker_shadow)
       {
-         gfx_display_draw_quad(
+         gfx_display_batch_quad(
                userdata,
                video_width,
                video_height,
@@ -5143,9 +5160,10 @@ static void materialui_render_selection_highlight(
                mui->selection_marker_shadow_height,
                video_width,
                video_height,
-               shadow_top_colour);
+               shadow_top_colour,
+               0);
 
-         gfx_display_draw_quad(
+         gfx_display_batch_quad(
                userdata,
                video_width,
                video_height,
@@ -5156,8 +5174,12 @@ static void materialui_render_selection_highlight(
                mui->selection_marker_shadow_height,
                video_width,
                video_height,
-               shadow_bottom_colour);
+               shadow_bottom_colour,
+               0);
       }
+
+      /* Submit highlight + marker shadows with a single draw call */
+      gfx_display_batch_flush(userdata, video_width, video_height);
    }
 }
 
@@ -5288,7 +5310,7 @@ static void materialui_render_header(
     * > Shadow is underneath title bar */
 
    /* > Shadow */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5298,10 +5320,11 @@ static void materialui_render_header(
          mui->header_shadow_height,
          video_width,
          video_height,
-         mui->colors.header_shadow);
+         mui->colors.header_shadow,
+         0);
 
    /* > Title bar background */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5311,10 +5334,11 @@ static void materialui_render_header(
          mui->sys_bar_height + mui->title_bar_height,
          video_width,
          video_height,
-         mui->colors.title_bar_background);
+         mui->colors.title_bar_background,
+         0);
 
    /* > System bar background */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5324,7 +5348,11 @@ static void materialui_render_header(
          mui->sys_bar_height,
          video_width,
          video_height,
-         mui->colors.sys_bar_background);
+         mui->colors.sys_bar_background,
+         0);
+
+   /* Submit all header background quads with a single draw call */
+   gfx_display_batch_flush(userdata, video_width, video_height);
 
    /* System bar items */
 
@@ -5689,7 +5717,7 @@ static void materialui_render_nav_bar_bottom(
    /* Draw navigation bar background */
 
    /* > Background */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5699,10 +5727,11 @@ static void materialui_render_nav_bar_bottom(
          nav_bar_height,
          video_width,
          video_height,
-         mui->colors.nav_bar_background);
+         mui->colors.nav_bar_background,
+         0);
 
    /* > Divider */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5712,7 +5741,11 @@ static void materialui_render_nav_bar_bottom(
          mui->nav_bar.divider_width,
          video_width,
          video_height,
-         mui->colors.divider);
+         mui->colors.divider,
+         0);
+
+   /* Submit background + divider with a single draw call */
+   gfx_display_batch_flush(userdata, video_width, video_height);
 
    /* Draw tabs */
 
@@ -5800,7 +5833,7 @@ static void materialui_render_nav_bar_right(
    /* Draw navigation bar background */
 
    /* > Background */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5810,10 +5843,11 @@ static void materialui_render_nav_bar_right(
          nav_bar_height,
          video_width,
          video_height,
-         mui->colors.nav_bar_background);
+         mui->colors.nav_bar_background,
+         0);
 
    /* > Divider */
-   gfx_display_draw_quad(
+   gfx_display_batch_quad(
          userdata,
          video_width,
          video_height,
@@ -5823,7 +5857,11 @@ static void materialui_render_nav_bar_right(
          nav_bar_height,
          video_width,
          video_height,
-         mui->colors.divider);
+         mui->colors.divider,
+         0);
+
+   /* Submit background + divider with a single draw call */
+   gfx_display_batch_flush(userdata, video_width, video_height);
 
    /* Draw tabs */
 
@@ -8336,10 +8374,10 @@ static bool materialui_preswitch_tabs(
    if (stack_size < 1)
       return false;
 
-   /* Delete existing label */
-   if (menu_stack->list[stack_size - 1].label)
-      free(menu_stack->list[stack_size - 1].label);
-   menu_stack->list[stack_size - 1].label = NULL;
+   /* Delete existing label. It may live in the list's own
+    * string storage, so release it through the list API
+    * instead of freeing it directly */
+   file_list_set_label_at_offset(menu_stack, stack_size - 1, NULL);
 
    /* Assign new label/type */
    switch (target_tab->type)
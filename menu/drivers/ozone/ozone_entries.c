@@ -554,7 +554,7 @@ void ozone_draw_entries(
       gfx_display_set_alpha(ozone->theme_dynamic.entries_checkmark, alpha);
 
       /* Borders */
-      gfx_display_draw_quad(
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -564,8 +564,9 @@ void ozone_draw_entries(
             ozone->dimensions.spacer_1px,
             video_width,
             video_height,
-            ozone->theme_dynamic.entries_border);
-      gfx_display_draw_quad(
+            ozone->theme_dynamic.entries_border,
+            0);
+      gfx_display_batch_quad(
             userdata,
             video_width,
             video_height,
@@ -575,13 +576,17 @@ void ozone_draw_entries(
             ozone->dimensions.spacer_1px,
             video_width,
             video_height,
-            ozone->theme_dynamic.entries_border);
+            ozone->theme_dynamic.entries_border,
+            0);
 
 border_iterate:
       if (node)
          y += node->height;
    }
 
+   /* Submit all entry borders with a single draw call */
+   gfx_display_batch_flush(userdata, video_width, video_height);
+
    /* Cursor(s) layer - current */
    if (!ozone->cursor_in_sidebar)
       ozone_draw_cursor(
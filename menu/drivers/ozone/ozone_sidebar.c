@@ -748,9 +748,10 @@ void ozone_change_tab(ozone_handle_t *ozone,
 
    stack_size = menu_stack->size;
 
-   if (menu_stack->list[stack_size - 1].label)
-      free(menu_stack->list[stack_size - 1].label);
-   menu_stack->list[stack_size - 1].label = NULL;
+   /* The old label may live in the list's own string
+    * storage - release it through the list API instead
+    * of freeing it directly */
+   file_list_set_label_at_offset(menu_stack, stack_size - 1, NULL);
 
    menu_stack->list[stack_size - 1].label =
       strdup(msg_hash_to_str(tab));
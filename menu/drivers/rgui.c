@@ -952,6 +952,17 @@ static frame_buf_t rgui_upscale_buf = {
    0,
    0
 };
+/* Copy of the frame buffer as it was last uploaded to the video
+ * driver. Used by rgui_set_texture() to work out which scanlines
+ * actually changed - a 'dirty' frame is repainted in full, but
+ * between consecutive frames most rows are usually identical
+ * (ticker updates, cursor moves), and some redraws change
+ * nothing at all. */
+static frame_buf_t rgui_shadow_buf = {
+   NULL,
+   0,
+   0
+};
 
 /* ==============================
  * pixel format conversion START
@@ -4138,10 +4149,17 @@ static void rgui_framebuffer_free(void)
 {
    rgui_frame_buf.width  = 0;
    rgui_frame_buf.height = 0;
-   
+
    if (rgui_frame_buf.data)
       free(rgui_frame_buf.data);
    rgui_frame_buf.data   = NULL;
+
+   rgui_shadow_buf.width  = 0;
+   rgui_shadow_buf.height = 0;
+
+   if (rgui_shadow_buf.data)
+      free(rgui_shadow_buf.data);
+   rgui_shadow_buf.data   = NULL;
 }
 
 static void rgui_background_free(void)
@@ -4764,6 +4782,8 @@ static void rgui_set_texture(void)
 {
    size_t fb_pitch;
    unsigned fb_width, fb_height;
+   unsigned dirty_y_start, dirty_y_end;
+   bool all_dirty                  = true;
    settings_t            *settings = config_get_ptr();
    unsigned internal_upscale_level = settings->uints.menu_rgui_internal_upscale_level;
 
@@ -4775,6 +4795,65 @@ static void rgui_set_texture(void)
 
    gfx_display_unset_framebuffer_dirty_flag();
 
+   /* Determine which scanlines actually changed since the
+    * last upload by comparing against the shadow buffer */
+   dirty_y_start = 0;
+   dirty_y_end   = fb_height;
+
+   if (   rgui_shadow_buf.data
+       && (rgui_shadow_buf.width  == fb_width)
+       && (rgui_shadow_buf.height == fb_height))
+   {
+      all_dirty = false;
+
+      while ((dirty_y_start < fb_height) &&
+             !memcmp(rgui_frame_buf.data  + (dirty_y_start * fb_width),
+                     rgui_shadow_buf.data + (dirty_y_start * fb_width),
+                     fb_width * sizeof(uint16_t)))
+         dirty_y_start++;
+
+      /* Frame is identical to the last one that was
+       * uploaded - nothing to do */
+      if (dirty_y_start == fb_height)
+         return;
+
+      while ((dirty_y_end > dirty_y_start) &&
+             !memcmp(rgui_frame_buf.data  + ((dirty_y_end - 1) * fb_width),
+                     rgui_shadow_buf.data + ((dirty_y_end - 1) * fb_width),
+                     fb_width * sizeof(uint16_t)))
+         dirty_y_end--;
+
+      memcpy(rgui_shadow_buf.data + (dirty_y_start * fb_width),
+             rgui_frame_buf.data  + (dirty_y_start * fb_width),
+             (dirty_y_end - dirty_y_start) * fb_width * sizeof(uint16_t));
+   }
+   else
+   {
+      /* (Re)allocate the shadow buffer. If allocation fails,
+       * we simply lose the ability to skip redundant work */
+      if (rgui_shadow_buf.data)
+      {
+         free(rgui_shadow_buf.data);
+         rgui_shadow_buf.data = NULL;
+      }
+
+      rgui_shadow_buf.data = (uint16_t*)
+            malloc(fb_width * fb_height * sizeof(uint16_t));
+
+      if (rgui_shadow_buf.data)
+      {
+         rgui_shadow_buf.width  = fb_width;
+         rgui_shadow_buf.height = fb_height;
+         memcpy(rgui_shadow_buf.data, rgui_frame_buf.data,
+               fb_width * fb_height * sizeof(uint16_t));
+      }
+      else
+      {
+         rgui_shadow_buf.width  = 0;
+         rgui_shadow_buf.height = 0;
+      }
+   }
+
    if (internal_upscale_level == RGUI_UPSCALE_NONE)
    {
       video_driver_set_texture_frame(rgui_frame_buf.data,
@@ -4814,10 +4893,14 @@ static void rgui_set_texture(void)
          }
          
          /* Allocate upscaling buffer, if required */
-         if (  (rgui_upscale_buf.width  != out_width)  || 
+         if (  (rgui_upscale_buf.width  != out_width)  ||
                (rgui_upscale_buf.height != out_height) ||
                !rgui_upscale_buf.data)
          {
+            /* A fresh upscale buffer holds no rows from the
+             * previous frame, so everything must be rescaled */
+            all_dirty = true;
+
             rgui_upscale_buf.width = out_width;
             rgui_upscale_buf.height = out_height;
             
@@ -4852,6 +4935,11 @@ static void rgui_set_texture(void)
          for (y_dst = 0; y_dst < out_height; y_dst++)
          {
             y_src = (y_dst * y_ratio) >> 16;
+            /* Unchanged source rows already have valid upscaled
+             * content from the previous frame */
+            if (!all_dirty &&
+                ((y_src < dirty_y_start) || (y_src >= dirty_y_end)))
+               continue;
             for (x_dst = 0; x_dst < out_width; x_dst++)
             {
                x_src = (x_dst * x_ratio) >> 16;
@@ -5610,6 +5698,12 @@ static void rgui_context_reset(void *data, bool is_threaded)
    if (!rgui)
       return;
 
+   /* The video driver has lost its menu texture; invalidate the
+    * shadow buffer so the next rgui_set_texture() re-uploads the
+    * frame buffer even if its contents have not changed */
+   rgui_shadow_buf.width  = 0;
+   rgui_shadow_buf.height = 0;
+
 #ifdef HAVE_GFX_WIDGETS
    if (rgui->widgets_supported)
       gfx_display_allocate_white_texture();
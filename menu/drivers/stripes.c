@@ -3972,9 +3972,10 @@ static void stripes_list_cache(void *data, enum menu_list_type type, unsigned ac
 
          stack_size = menu_stack->size;
 
-         if (menu_stack->list[stack_size - 1].label)
-            free(menu_stack->list[stack_size - 1].label);
-         menu_stack->list[stack_size - 1].label = NULL;
+         /* The old label may live in the list's own string
+          * storage - release it through the list API instead
+          * of freeing it directly */
+         file_list_set_label_at_offset(menu_stack, stack_size - 1, NULL);
 
          switch (stripes_get_system_tab(stripes, (unsigned)stripes->categories_selection_ptr))
          {
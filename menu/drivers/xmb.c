@@ -244,11 +244,26 @@ enum
    XMB_SYSTEM_TAB_MAX_LENGTH
 };
 
+/* Cached output of the smooth ticker for an entry that is not
+ * selected. Non-selected entries never scroll, so the displayed
+ * string is a pure function of the source text, the font and the
+ * field width - remembering it saves a per-glyph measurement pass
+ * through the font renderer on every frame */
+typedef struct
+{
+   char *src;            /* source string the layout was computed from */
+   char *dst;            /* resulting (possibly ellipsised) display string */
+   font_data_t *font;    /* font the glyphs were measured with */
+   unsigned field_width; /* field width the layout was computed for */
+} xmb_label_cache_t;
+
 /* NOTE: If you change this you HAVE to update
  * xmb_alloc_node() and xmb_copy_node() */
 typedef struct
 {
    char *fullpath;
+   xmb_label_cache_t label_cache;
+   xmb_label_cache_t value_cache;
    uintptr_t icon;
    uintptr_t content_icon;
    float alpha;
@@ -637,6 +652,50 @@ const char* xmb_theme_ident(void)
 
 /* NOTE: This exists because calloc()ing xmb_node_t is expensive
  * when you can have big lists like MAME and fba playlists */
+static void xmb_label_cache_reset(xmb_label_cache_t *cache)
+{
+   if (cache->src)
+      free(cache->src);
+   if (cache->dst)
+      free(cache->dst);
+
+   cache->src         = NULL;
+   cache->dst         = NULL;
+   cache->font        = NULL;
+   cache->field_width = 0;
+}
+
+static bool xmb_label_cache_get(xmb_label_cache_t *cache,
+      const char *src, font_data_t *font, unsigned field_width,
+      char *s, size_t len)
+{
+   if (      cache->dst
+         && (cache->font        == font)
+         && (cache->field_width == field_width)
+         &&  string_is_equal(cache->src, src))
+   {
+      strlcpy(s, cache->dst, len);
+      return true;
+   }
+
+   return false;
+}
+
+static void xmb_label_cache_set(xmb_label_cache_t *cache,
+      const char *src, font_data_t *font, unsigned field_width,
+      const char *dst)
+{
+   if (cache->src)
+      free(cache->src);
+   if (cache->dst)
+      free(cache->dst);
+
+   cache->src         = strdup(src);
+   cache->dst         = strdup(dst);
+   cache->font        = font;
+   cache->field_width = field_width;
+}
+
 static xmb_node_t *xmb_alloc_node(void)
 {
    xmb_node_t *node = (xmb_node_t*)malloc(sizeof(*node));
@@ -649,6 +708,12 @@ static xmb_node_t *xmb_alloc_node(void)
    node->icon     = node->content_icon = 0;
    node->fullpath = NULL;
 
+   node->label_cache.src         = NULL;
+   node->label_cache.dst         = NULL;
+   node->label_cache.font        = NULL;
+   node->label_cache.field_width = 0;
+   node->value_cache             = node->label_cache;
+
    return node;
 }
 
@@ -662,6 +727,9 @@ static void xmb_free_node(xmb_node_t *node)
 
    node->fullpath = NULL;
 
+   xmb_label_cache_reset(&node->label_cache);
+   xmb_label_cache_reset(&node->value_cache);
+
    free(node);
 }
 
@@ -701,6 +769,10 @@ static xmb_node_t *xmb_copy_node(const xmb_node_t *old_node)
    *new_node            = *old_node;
    new_node->fullpath   = old_node->fullpath ? strdup(old_node->fullpath) : NULL;
 
+   /* Label layout caches are rebuilt lazily on first draw */
+   new_node->label_cache.src = new_node->label_cache.dst = NULL;
+   new_node->value_cache.src = new_node->value_cache.dst = NULL;
+
    return new_node;
 }
 
@@ -3205,7 +3277,23 @@ static int xmb_draw_item(
       ticker_smooth.dst_str_len = sizeof(tmp);
 
       if (ticker_smooth.src_str)
-         gfx_animation_ticker_smooth(&ticker_smooth);
+      {
+         /* Only the selected entry scrolls; any other label is
+          * laid out to a static string that can be reused until
+          * the source text, font or field width changes */
+         if (       ticker_smooth.selected
+               || !xmb_label_cache_get(&node->label_cache,
+                     ticker_smooth.src_str, xmb->font,
+                     ticker_smooth.field_width, tmp, sizeof(tmp)))
+         {
+            gfx_animation_ticker_smooth(&ticker_smooth);
+
+            if (!ticker_smooth.selected)
+               xmb_label_cache_set(&node->label_cache,
+                     ticker_smooth.src_str, xmb->font,
+                     ticker_smooth.field_width, tmp);
+         }
+      }
    }
    else
    {
@@ -3343,7 +3431,20 @@ static int xmb_draw_item(
       ticker_smooth.dst_str_len = sizeof(tmp);
 
       if (!string_is_empty(entry.value))
-         gfx_animation_ticker_smooth(&ticker_smooth);
+      {
+         if (       ticker_smooth.selected
+               || !xmb_label_cache_get(&node->value_cache,
+                     ticker_smooth.src_str, xmb->font,
+                     ticker_smooth.field_width, tmp, sizeof(tmp)))
+         {
+            gfx_animation_ticker_smooth(&ticker_smooth);
+
+            if (!ticker_smooth.selected)
+               xmb_label_cache_set(&node->value_cache,
+                     ticker_smooth.src_str, xmb->font,
+                     ticker_smooth.field_width, tmp);
+         }
+      }
    }
    else
    {
@@ -6291,9 +6392,10 @@ static void xmb_list_cache(void *data, enum menu_list_type type, unsigned action
 
          stack_size = menu_stack->size;
 
-         if (menu_stack->list[stack_size - 1].label)
-            free(menu_stack->list[stack_size - 1].label);
-         menu_stack->list[stack_size - 1].label = NULL;
+         /* The old label may live in the list's own string
+          * storage - release it through the list API instead
+          * of freeing it directly */
+         file_list_set_label_at_offset(menu_stack, stack_size - 1, NULL);
 
          switch (xmb_get_system_tab(xmb, (unsigned)xmb->categories_selection_ptr))
          {
@@ -17,6 +17,7 @@
  */
 
 #include <stddef.h>
+#include <ctype.h>
 
 #include <compat/strl.h>
 #include <compat/strcasestr.h>
@@ -80,6 +81,7 @@
 #include "menu_networking.h"
 #include "menu_dialog.h"
 
+#include "../cache_coordinator.h"
 #include "../configuration.h"
 #include "../file_path_special.h"
 #include "../defaults.h"
@@ -158,6 +160,139 @@ void filebrowser_set_type(enum filebrowser_enums type)
    filebrowser_types = type;
 }
 
+/* Most recent file browser directory listing, kept warm across
+ * menu visits. The listing is only cached when the frontend can
+ * watch the directory for changes - without change notification
+ * there is no safe way to serve a possibly stale list - and is
+ * dropped as soon as the watch reports an event */
+typedef struct filebrowser_cache
+{
+   struct string_list list; /* sorted directory listing */
+   char *path;
+   char *exts;
+   path_change_data_t *change_data;
+   bool show_hidden;
+   bool include_compressed;
+   bool valid;
+} filebrowser_cache_t;
+
+static filebrowser_cache_t filebrowser_cache;
+
+static void filebrowser_cache_invalidate(void)
+{
+   if (filebrowser_cache.change_data)
+      frontend_driver_watch_path_for_changes(NULL, 0,
+            &filebrowser_cache.change_data);
+   filebrowser_cache.change_data = NULL;
+
+   if (filebrowser_cache.path)
+      free(filebrowser_cache.path);
+   if (filebrowser_cache.exts)
+      free(filebrowser_cache.exts);
+   filebrowser_cache.path        = NULL;
+   filebrowser_cache.exts        = NULL;
+
+   string_list_deinitialize(&filebrowser_cache.list);
+   filebrowser_cache.valid       = false;
+}
+
+static struct string_list *filebrowser_cache_get(const char *path,
+      const char *exts, bool show_hidden, bool include_compressed)
+{
+   if (!filebrowser_cache.valid)
+      return NULL;
+
+   if (      !string_is_equal(filebrowser_cache.path, path)
+         ||  !string_is_equal(filebrowser_cache.exts,
+               exts ? exts : "")
+         ||  (filebrowser_cache.show_hidden        != show_hidden)
+         ||  (filebrowser_cache.include_compressed != include_compressed))
+      return NULL;
+
+   /* Something inside the watched directory changed -
+    * the listing has to be rebuilt */
+   if (frontend_driver_check_for_path_changes(
+            filebrowser_cache.change_data))
+   {
+      filebrowser_cache_invalidate();
+      return NULL;
+   }
+
+   return &filebrowser_cache.list;
+}
+
+/* Cache coordinator hooks. The listing is all-or-nothing, so
+ * any shrink below the resident size drops it outright */
+static size_t filebrowser_cache_resident_bytes(void)
+{
+   size_t total = 0;
+   size_t i;
+
+   if (!filebrowser_cache.valid)
+      return 0;
+
+   for (i = 0; i < filebrowser_cache.list.size; i++)
+   {
+      if (filebrowser_cache.list.elems[i].data)
+         total += strlen(filebrowser_cache.list.elems[i].data) + 1;
+      total += sizeof(filebrowser_cache.list.elems[i]);
+   }
+
+   return total;
+}
+
+static void filebrowser_cache_shrink(size_t limit)
+{
+   if (filebrowser_cache_resident_bytes() > limit)
+      filebrowser_cache_invalidate();
+}
+
+static void filebrowser_cache_set(struct string_list *list,
+      const char *path, const char *exts,
+      bool show_hidden, bool include_compressed)
+{
+   union string_list_elem_attr attr;
+   struct string_list path_list = {0};
+   int flags                    =
+        PATH_CHANGE_TYPE_MODIFIED
+      | PATH_CHANGE_TYPE_WRITE_FILE_CLOSED
+      | PATH_CHANGE_TYPE_FILE_MOVED
+      | PATH_CHANGE_TYPE_FILE_DELETED
+      | PATH_CHANGE_TYPE_DIR_CONTENTS;
+
+   filebrowser_cache_invalidate();
+
+   if (!frontend_driver_can_watch_for_changes())
+      return;
+
+   attr.i = 0;
+   string_list_initialize(&path_list);
+   string_list_append(&path_list, path, attr);
+   frontend_driver_watch_path_for_changes(&path_list,
+         flags, &filebrowser_cache.change_data);
+   string_list_deinitialize(&path_list);
+
+   /* Watch could not be established (e.g. kernel too old) -
+    * do not cache, so every visit re-enumerates as before */
+   if (!filebrowser_cache.change_data)
+      return;
+
+   /* Take ownership of the listing; the caller's copy is
+    * left zeroed so its deinitialize becomes a no-op */
+   filebrowser_cache.list               = *list;
+   memset(list, 0, sizeof(*list));
+
+   filebrowser_cache.path               = strdup(path);
+   filebrowser_cache.exts               = strdup(exts ? exts : "");
+   filebrowser_cache.show_hidden        = show_hidden;
+   filebrowser_cache.include_compressed = include_compressed;
+   filebrowser_cache.valid              = true;
+
+   cache_coordinator_register("filebrowser_listing",
+         filebrowser_cache_resident_bytes, filebrowser_cache_shrink);
+   cache_coordinator_touch("filebrowser_listing");
+}
+
 static void filebrowser_parse(
       menu_displaylist_info_t *info,
       unsigned type_data,
@@ -171,6 +306,7 @@ static void filebrowser_parse(
    const struct retro_subsystem_info *subsystem;
    bool ret                             = false;
    struct string_list str_list          = {0};
+   struct string_list *listing          = &str_list;
    unsigned items_found                 = 0;
    unsigned files_count                 = 0;
    unsigned dirs_count                  = 0;
@@ -213,21 +349,42 @@ static void filebrowser_parse(
    }
    else if (!string_is_empty(path))
    {
+      const char *use_exts    = NULL;
+      bool include_compressed = true;
+      bool valid_request      = true;
+
       if (filebrowser_types == FILEBROWSER_SELECT_FILE_SUBSYSTEM)
       {
          if (subsystem && subsystem_current_count > 0 && content_get_subsystem_rom_id() < subsystem->num_roms)
-            ret = dir_list_initialize(&str_list,
-                  path,
-                  (filter_ext && info) ? subsystem->roms[content_get_subsystem_rom_id()].valid_extensions : NULL,
-                  true, show_hidden_files, true, false);
+            use_exts          = (filter_ext && info) ? subsystem->roms[content_get_subsystem_rom_id()].valid_extensions : NULL;
+         else
+            valid_request     = false;
       }
       else if (info && ((info->type_default == FILE_TYPE_MANUAL_SCAN_DAT) || (info->type_default == FILE_TYPE_SIDELOAD_CORE)))
-         ret = dir_list_initialize(&str_list, path,
-               info->exts, true, show_hidden_files, false, false);
+      {
+         use_exts             = info->exts;
+         include_compressed   = false;
+      }
       else
-         ret = dir_list_initialize(&str_list, path,
-               (filter_ext && info) ? info->exts : NULL,
-               true, show_hidden_files, true, false);
+         use_exts             = (filter_ext && info) ? info->exts : NULL;
+
+      if (valid_request)
+      {
+         if ((listing = filebrowser_cache_get(path, use_exts,
+                     show_hidden_files, include_compressed)))
+            ret = true;
+         else if ((ret = dir_list_initialize(&str_list, path, use_exts,
+                     true, show_hidden_files, include_compressed, false)))
+         {
+            dir_list_sort(&str_list, true);
+            filebrowser_cache_set(&str_list, path, use_exts,
+                  show_hidden_files, include_compressed);
+            listing = filebrowser_cache.valid
+                  ? &filebrowser_cache.list : &str_list;
+         }
+         else
+            listing = &str_list;
+      }
    }
 
    switch (filebrowser_types)
@@ -274,9 +431,13 @@ static void filebrowser_parse(
       goto end;
    }
 
-   dir_list_sort(&str_list, true);
+   /* Directory listings are sorted where they are built (and
+    * cached listings stay sorted) - only archive content still
+    * needs sorting here */
+   if (path_is_compressed)
+      dir_list_sort(&str_list, true);
 
-   list_size = str_list.size;
+   list_size = listing->size;
 
    if (list_size > 0)
    {
@@ -286,11 +447,11 @@ static void filebrowser_parse(
          bool is_dir                   = false;
          enum msg_hash_enums enum_idx  = MSG_UNKNOWN;
          enum msg_file_type file_type  = FILE_TYPE_NONE;
-         const char *path              = str_list.elems[i].data;
+         const char *path              = listing->elems[i].data;
 
          label[0] = '\0';
 
-         switch (str_list.elems[i].attr.i)
+         switch (listing->elems[i].attr.i)
          {
             case RARCH_DIRECTORY:
                file_type = FILE_TYPE_DIRECTORY;
@@ -472,7 +633,7 @@ static int menu_displaylist_parse_core_info(menu_displaylist_info_t *info)
    else if (core_info_get_current_core(&core_info) && core_info)
       core_path = core_info->path;
 
-   if (!core_info || !core_info->config_data)
+   if (!core_info || !core_info->has_info)
    {
       if (menu_entries_append_enum(info->list,
             msg_hash_to_str(MENU_ENUM_LABEL_VALUE_NO_CORE_INFORMATION_AVAILABLE),
@@ -1395,6 +1556,158 @@ static unsigned menu_displaylist_parse_system_info(file_list_t *list)
    return count;
 }
 
+/* Playlist search filter cache
+ * > Filtering a playlist re-runs strcasestr() over every
+ *   entry label for every term on each refresh; the compat
+ *   fallback case-folds both strings character by character,
+ *   which makes typing into a large list noticeably laggy
+ * > Keep one case-folded copy of each menu label, built the
+ *   first time a list is filtered, so each refresh does a
+ *   plain strstr() against pre-folded terms
+ * > Remember which entries matched the previous term set:
+ *   when the user narrows the search (terms are only ever
+ *   appended), entries that already failed are skipped
+ *   without touching their labels at all
+ * TODO/FIXME - static global state */
+typedef struct
+{
+   char *playlist_path;            /* identity of the cached list */
+   char **labels;                  /* case-folded menu labels */
+   struct string_list *prev_terms; /* term set of the last filter pass */
+   uint32_t *prev_matches;         /* bitmap of entries matching prev_terms */
+   uint32_t *new_matches;          /* bitmap being built this pass */
+   size_t list_size;
+   unsigned label_mode;
+   bool inline_core_name;
+} pl_filter_cache_t;
+
+static pl_filter_cache_t pl_filter_cache;
+
+#define PL_FILTER_BITMAP_WORDS(n) (((n) + 31) >> 5)
+#define PL_FILTER_BITMAP_GET(b, i) ((b)[(i) >> 5] &  ((uint32_t)1 << ((i) & 31)))
+#define PL_FILTER_BITMAP_SET(b, i) ((b)[(i) >> 5] |= ((uint32_t)1 << ((i) & 31)))
+
+static void pl_filter_casefold(char *s)
+{
+   for (; *s; s++)
+      *s = tolower((unsigned char)*s);
+}
+
+static void pl_filter_cache_reset(void)
+{
+   size_t i;
+   pl_filter_cache_t *cache = &pl_filter_cache;
+
+   if (cache->labels)
+   {
+      for (i = 0; i < cache->list_size; i++)
+         free(cache->labels[i]);
+      free(cache->labels);
+   }
+   if (cache->prev_terms)
+      string_list_free(cache->prev_terms);
+   free(cache->prev_matches);
+   free(cache->new_matches);
+   free(cache->playlist_path);
+
+   memset(cache, 0, sizeof(*cache));
+}
+
+/* Prepares the cache for one filter pass over the given list.
+ * Returns true if the cache may be used; sets *refine when
+ * the previous pass filtered a leading subset of the current
+ * terms, so entries it rejected can be skipped outright */
+static bool pl_filter_cache_prepare(playlist_t *playlist,
+      size_t list_size, unsigned label_mode, bool inline_core_name,
+      struct string_list *search_terms, bool *refine)
+{
+   size_t i;
+   pl_filter_cache_t *cache = &pl_filter_cache;
+   const char *path         = playlist_get_conf_path(playlist);
+
+   *refine = false;
+
+   if (string_is_empty(path))
+      return false;
+
+   /* A different list (or a list whose labels would render
+    * differently) throws the whole cache away */
+   if (!cache->playlist_path ||
+       !string_is_equal(cache->playlist_path, path) ||
+       cache->list_size        != list_size ||
+       cache->label_mode       != label_mode ||
+       cache->inline_core_name != inline_core_name)
+   {
+      pl_filter_cache_reset();
+
+      if (!(cache->playlist_path = strdup(path)))
+         return false;
+      if (!(cache->labels = (char**)calloc(list_size, sizeof(char*))))
+      {
+         pl_filter_cache_reset();
+         return false;
+      }
+      cache->list_size        = list_size;
+      cache->label_mode       = label_mode;
+      cache->inline_core_name = inline_core_name;
+   }
+
+   if (!(cache->new_matches = (uint32_t*)calloc(
+         PL_FILTER_BITMAP_WORDS(list_size), sizeof(uint32_t))))
+      return false;
+
+   /* Terms are only ever appended, so the previous result
+    * set can be refined whenever it covers a leading subset
+    * of the current terms */
+   if (cache->prev_terms && cache->prev_matches &&
+       cache->prev_terms->size <= search_terms->size)
+   {
+      *refine = true;
+      for (i = 0; i < cache->prev_terms->size; i++)
+      {
+         if (!string_is_equal(cache->prev_terms->elems[i].data,
+               search_terms->elems[i].data))
+         {
+            *refine = false;
+            break;
+         }
+      }
+   }
+
+   return true;
+}
+
+/* Returns the case-folded label of entry i, folding and
+ * storing it on first access */
+static const char *pl_filter_cache_label(size_t i, const char *label)
+{
+   pl_filter_cache_t *cache = &pl_filter_cache;
+
+   if (!cache->labels[i])
+   {
+      if (!(cache->labels[i] = strdup(label)))
+         return NULL; /* caller falls back to strcasestr() */
+      pl_filter_casefold(cache->labels[i]);
+   }
+
+   return cache->labels[i];
+}
+
+/* Ends a filter pass: the bitmap built this pass becomes
+ * the previous-result set for the next one */
+static void pl_filter_cache_commit(struct string_list *search_terms)
+{
+   pl_filter_cache_t *cache = &pl_filter_cache;
+
+   free(cache->prev_matches);
+   cache->prev_matches = cache->new_matches;
+   cache->new_matches  = NULL;
+
+   if (cache->prev_terms)
+      string_list_free(cache->prev_terms);
+   cache->prev_terms   = string_list_clone(search_terms);
+}
+
 static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
       playlist_t *playlist, const char *path_playlist, bool is_collection)
 {
@@ -1407,6 +1720,9 @@ static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
    struct string_list *search_terms  = menu_driver_search_get_terms();
    unsigned pl_show_inline_core_name = settings->uints.playlist_show_inline_core_name;
    bool pl_show_sublabels            = settings->bools.playlist_show_sublabels;
+   struct string_list *folded_terms  = NULL;
+   bool use_filter_cache             = false;
+   bool filter_refine                = false;
    void (*sanitization)(char*);
 
    label_spacer[0] = '\0';
@@ -1491,6 +1807,33 @@ static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
          sanitization = NULL;
    }
 
+   if (search_terms)
+   {
+      use_filter_cache = pl_filter_cache_prepare(playlist, list_size,
+            (unsigned)playlist_get_label_display_mode(playlist),
+            show_inline_core_name, search_terms, &filter_refine);
+
+      if (use_filter_cache)
+      {
+         /* Fold the terms once, not once per label */
+         if ((folded_terms = string_list_clone(search_terms)))
+         {
+            size_t j;
+            for (j = 0; j < folded_terms->size; j++)
+               if (folded_terms->elems[j].data)
+                  pl_filter_casefold(folded_terms->elems[j].data);
+         }
+         else
+         {
+            free(pl_filter_cache.new_matches);
+            pl_filter_cache.new_matches = NULL;
+            use_filter_cache            = false;
+         }
+      }
+   }
+   else
+      pl_filter_cache_reset();
+
    for (i = 0; i < list_size; i++)
    {
       char menu_entry_label[PATH_MAX_LENGTH];
@@ -1553,18 +1896,47 @@ static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
       if (search_terms)
       {
          size_t j;
+         const char *folded_label = NULL;
 
-         for (j = 0; j < search_terms->size; j++)
+         if (use_filter_cache && filter_refine &&
+             !PL_FILTER_BITMAP_GET(pl_filter_cache.prev_matches, i))
+         {
+            /* Entry already failed a subset of the current
+             * terms - no need to look at its label again */
+            entry_valid = false;
+         }
+         else if (use_filter_cache &&
+               (folded_label = pl_filter_cache_label(i, menu_entry_label)))
          {
-            const char *search_term = search_terms->elems[j].data;
+            for (j = 0; j < folded_terms->size; j++)
+            {
+               const char *search_term = folded_terms->elems[j].data;
 
-            if (!string_is_empty(search_term) &&
-                !strcasestr(menu_entry_label, search_term))
+               if (!string_is_empty(search_term) &&
+                   !strstr(folded_label, search_term))
+               {
+                  entry_valid = false;
+                  break;
+               }
+            }
+         }
+         else
+         {
+            for (j = 0; j < search_terms->size; j++)
             {
-               entry_valid = false;
-               break;
+               const char *search_term = search_terms->elems[j].data;
+
+               if (!string_is_empty(search_term) &&
+                   !strcasestr(menu_entry_label, search_term))
+               {
+                  entry_valid = false;
+                  break;
+               }
             }
          }
+
+         if (entry_valid && use_filter_cache)
+            PL_FILTER_BITMAP_SET(pl_filter_cache.new_matches, i);
       }
 
       /* Add menu entry */
@@ -1574,6 +1946,11 @@ static int menu_displaylist_parse_playlist(menu_displaylist_info_t *info,
          info->count++;
    }
 
+   if (use_filter_cache)
+      pl_filter_cache_commit(search_terms);
+   if (folded_terms)
+      string_list_free(folded_terms);
+
    if (info->count < 1)
       goto error;
 
@@ -1658,7 +2035,7 @@ static int create_string_list_rdb_entry_int(
    str_len                         += strlen(label) + 1;
    string_list_append(&str_list, label, attr);
 
-   snprintf(str, sizeof(str), "%d", actual_int);
+   string_append_signed(str, sizeof(str), 0, actual_int);
    str_len                         += strlen(str) + 1;
    string_list_append(&str_list, str, attr);
 
@@ -1668,7 +2045,13 @@ static int create_string_list_rdb_entry_int(
    string_list_join_concat(output_label, str_len, &str_list, "|");
    string_list_deinitialize(&str_list);
 
-   snprintf(tmp, sizeof(tmp), "%s : %d", desc, actual_int);
+   /* Runs once per database entry on list builds - build
+    * "<desc> : <int>" without printf formatting */
+   {
+      size_t _len = string_append(tmp, sizeof(tmp), 0, desc);
+      _len        = string_append(tmp, sizeof(tmp), _len, " : ");
+      string_append_signed(tmp, sizeof(tmp), _len, actual_int);
+   }
    menu_entries_append_enum(list, tmp, output_label,
          enum_idx,
          0, 0, 0);
@@ -2973,7 +3356,7 @@ static unsigned menu_displaylist_parse_information_list(file_list_t *info_list)
           !string_is_equal(system->library_name,
              msg_hash_to_str(MENU_ENUM_LABEL_VALUE_NO_CORE))
          )
-         && core_info && core_info->config_data
+         && core_info && core_info->has_info
       )
       if (menu_entries_append_enum(info_list,
             msg_hash_to_str(MENU_ENUM_LABEL_VALUE_CORE_INFORMATION),
@@ -9862,6 +10245,13 @@ bool menu_displaylist_ctl(enum menu_displaylist_ctl_state type,
                         MENU_SETTING_ACTION, 0, 0))
                   count++;
 
+               if (menu_entries_append_enum(info->list,
+                        msg_hash_to_str(MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_PARAMETERS_UNDO),
+                        msg_hash_to_str(MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS_UNDO),
+                        MENU_ENUM_LABEL_VIDEO_SHADER_PARAMETERS_UNDO,
+                        MENU_SETTING_ACTION, 0, 0))
+                  count++;
+
                if (menu_entries_append_enum(info->list,
                         msg_hash_to_str(MENU_ENUM_LABEL_VALUE_VIDEO_SHADER_NUM_PASSES),
                         msg_hash_to_str(MENU_ENUM_LABEL_VIDEO_SHADER_NUM_PASSES),
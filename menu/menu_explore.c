@@ -23,7 +23,10 @@
 #include "../libretro-db/libretrodb.h"
 #include <compat/strcasestr.h>
 #include <compat/strl.h>
+#include <file/file_path.h>
 #include <array/rbuf.h>
+#include <streams/interface_stream.h>
+#include <streams/file_stream.h>
 
 #define EX_ARENA_ALIGNMENT 8
 #define EX_ARENA_BLOCK_SIZE (64 * 1024)
@@ -92,6 +95,8 @@ typedef struct
 {
    ex_arena arena; /* ptr alignment */
    explore_string_t **by[EXPLORE_CAT_COUNT];
+   uint32_t *by_idx[EXPLORE_CAT_COUNT];     /* entry positions grouped by category value */
+   uint32_t *by_idx_off[EXPLORE_CAT_COUNT]; /* value idx -> by_idx range start */
    explore_entry_t *entries;
    playlist_t **playlists;
    uintptr_t *icons;
@@ -467,7 +472,11 @@ static void explore_free(explore_state_t *state)
    if (!state)
       return;
    for (i = 0; i != EXPLORE_CAT_COUNT; i++)
+   {
       RBUF_FREE(state->by[i]);
+      RBUF_FREE(state->by_idx[i]);
+      RBUF_FREE(state->by_idx_off[i]);
+   }
 
    RBUF_FREE(state->entries);
 
@@ -531,6 +540,680 @@ static void explore_load_icons(explore_state_t *state)
    }
 }
 
+/* Returns true if str is one of the unique values of the passed
+ * category. A string's idx is its position within its own category,
+ * so a single array lookup settles membership. */
+static INLINE bool explore_string_in_category(
+      explore_state_t *explore, unsigned cat, explore_string_t *str)
+{
+   return (str->idx < RBUF_LEN(explore->by[cat])
+         && explore->by[cat][str->idx] == str);
+}
+
+/* Precompute, for every category, the entry positions grouped by
+ * value (a counting sort over the final sorted entry order), so a
+ * filter query can visit just the candidate range instead of
+ * scanning the entire set. Requires by[] sorted with final value
+ * indices assigned and entries in final order. */
+static void explore_build_category_indexes(explore_state_t *explore)
+{
+   unsigned cat;
+   uint32_t n;
+   uint32_t entry_count = (uint32_t)RBUF_LEN(explore->entries);
+
+   for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+   {
+      uint32_t idx;
+      uint32_t *offs     = NULL;
+      uint32_t *grouped  = NULL;
+      uint32_t val_count = (uint32_t)RBUF_LEN(explore->by[cat]);
+      bool use_split     = explore_by_info[cat].use_split;
+
+      if (!val_count)
+         continue;
+
+      if (!RBUF_TRYFIT(explore->by_idx_off[cat], val_count + 1))
+         continue;
+      RBUF_RESIZE(explore->by_idx_off[cat], val_count + 1);
+      offs = explore->by_idx_off[cat];
+      memset(offs, 0, (val_count + 1) * sizeof(*offs));
+
+      for (n = 0; n != entry_count; n++)
+      {
+         explore_entry_t *e = &explore->entries[n];
+         if (e->by[cat])
+            offs[e->by[cat]->idx + 1]++;
+         if (use_split && e->split)
+         {
+            explore_string_t **s;
+            for (s = e->split; *s; s++)
+            {
+               explore_string_t **t;
+               if (!explore_string_in_category(explore, cat, *s))
+                  continue;
+               /* guard against the same value appearing twice
+                * within one entry's field */
+               if (*s == e->by[cat])
+                  continue;
+               for (t = e->split; t != s; t++)
+                  if (*t == *s)
+                     break;
+               if (t != s)
+                  continue;
+               offs[(*s)->idx + 1]++;
+            }
+         }
+      }
+
+      /* prefix sum - offs[idx] becomes the range start of value idx */
+      for (idx = 0; idx != val_count; idx++)
+         offs[idx + 1] += offs[idx];
+
+      if (!RBUF_TRYFIT(explore->by_idx[cat], offs[val_count]))
+      {
+         RBUF_FREE(explore->by_idx_off[cat]);
+         continue;
+      }
+      RBUF_RESIZE(explore->by_idx[cat], offs[val_count]);
+      grouped = explore->by_idx[cat];
+
+      /* fill, advancing each range start past the entries added to
+       * it; afterwards offs[idx] holds the start of value idx + 1 */
+      for (n = 0; n != entry_count; n++)
+      {
+         explore_entry_t *e = &explore->entries[n];
+         if (e->by[cat])
+            grouped[offs[e->by[cat]->idx]++] = n;
+         if (use_split && e->split)
+         {
+            explore_string_t **s;
+            for (s = e->split; *s; s++)
+            {
+               explore_string_t **t;
+               if (!explore_string_in_category(explore, cat, *s))
+                  continue;
+               if (*s == e->by[cat])
+                  continue;
+               for (t = e->split; t != s; t++)
+                  if (*t == *s)
+                     break;
+               if (t != s)
+                  continue;
+               grouped[offs[(*s)->idx]++] = n;
+            }
+         }
+      }
+
+      /* shift back into offset positions */
+      for (idx = val_count; idx != 0; idx--)
+         offs[idx] = offs[idx - 1];
+      offs[0] = 0;
+   }
+}
+
+/* Explore view materialization
+ * > The playlist x rdb join above costs several seconds on a
+ *   large library, and its inputs only change when content is
+ *   scanned or databases are updated
+ * > Flatten the joined result (category values, entry links,
+ *   split lists) into a single binary file in the cache
+ *   directory; the next launch loads it back in one read and
+ *   only recomputes the cheap category indexes
+ * > Every playlist and rdb file consulted by the build is
+ *   recorded with its mtime and size, and the cache is only
+ *   trusted while all of them still match and no playlist has
+ *   been added or removed */
+#define EXPLORE_CACHE_MAGIC    0x43584552 /* 'REXC' */
+#define EXPLORE_CACHE_VERSION  1
+#define EXPLORE_CACHE_FILENAME "explore.cache"
+
+typedef struct
+{
+   char *path;
+   int64_t mtime;
+   int64_t size;
+} explore_source_t;
+
+static bool explore_cache_get_path(char *path, size_t len)
+{
+   settings_t *settings = config_get_ptr();
+   const char *dir      = settings ? settings->paths.directory_cache : NULL;
+
+   if (!dir || !*dir)
+      return false;
+
+   fill_pathname_join(path, dir, EXPLORE_CACHE_FILENAME, len);
+   return true;
+}
+
+static bool explore_cache_stat(const char *path,
+      int64_t *mtime, int64_t *size)
+{
+   /* Path wrappers rather than raw stat(), which
+    * mishandles UTF-8 paths on Windows */
+   int32_t f_size  = path_get_size(path);
+   int64_t f_mtime = path_get_mtime(path);
+
+   if ((f_size < 0) || (f_mtime < 0))
+      return false;
+
+   *mtime = f_mtime;
+   *size  = (int64_t)f_size;
+   return true;
+}
+
+/* Remembers one input file of the current build; files that
+ * could not be read are recorded too, so their later
+ * appearance invalidates the cache */
+static void explore_cache_push_source(explore_source_t **sources,
+      const char *path)
+{
+   explore_source_t src;
+
+   src.path = strdup(path);
+   if (!src.path)
+      return;
+
+   if (!explore_cache_stat(path, &src.mtime, &src.size))
+   {
+      src.mtime = -1;
+      src.size  = -1;
+   }
+
+   RBUF_PUSH(*sources, src);
+}
+
+static void explore_cache_free_sources(explore_source_t *sources)
+{
+   size_t i;
+   for (i = 0; i != RBUF_LEN(sources); i++)
+      free(sources[i].path);
+   RBUF_FREE(sources);
+}
+
+/* Counts the .lpl files currently in the playlist directory,
+ * so playlists added since the cache was written are noticed */
+static uint32_t explore_cache_count_playlists(const char *directory_playlist)
+{
+   uint32_t count                       = 0;
+   libretro_vfs_implementation_dir *dir =
+         retro_vfs_opendir_impl(directory_playlist, false);
+
+   while (dir)
+   {
+      const char *fname = NULL;
+      const char *fext  = NULL;
+
+      if (!retro_vfs_readdir_impl(dir))
+      {
+         retro_vfs_closedir_impl(dir);
+         break;
+      }
+
+      fname = retro_vfs_dirent_get_name_impl(dir);
+      if (fname)
+         fext = strrchr(fname, '.');
+
+      if (fext && !strcasecmp(fext, ".lpl"))
+         count++;
+   }
+
+   return count;
+}
+
+static void explore_cache_write_u32(intfstream_t *file, uint32_t val)
+{
+   intfstream_write(file, &val, sizeof(val));
+}
+
+static void explore_cache_write_i64(intfstream_t *file, int64_t val)
+{
+   intfstream_write(file, &val, sizeof(val));
+}
+
+static void explore_cache_write_string(intfstream_t *file, const char *s)
+{
+   uint32_t len = s ? (uint32_t)strlen(s) + 1 : 0;
+   explore_cache_write_u32(file, len);
+   if (len)
+      intfstream_write(file, s, len);
+}
+
+/* Bounds-checked reader over the cache blob; any overrun or
+ * malformed field flips 'error' and the load is abandoned */
+typedef struct
+{
+   const uint8_t *data;
+   size_t size;
+   size_t ptr;
+   bool error;
+} explore_cache_reader_t;
+
+static uint32_t explore_cache_read_u32(explore_cache_reader_t *r)
+{
+   uint32_t val;
+   if (r->error || (r->size - r->ptr < sizeof(val)))
+   {
+      r->error = true;
+      return 0;
+   }
+   memcpy(&val, r->data + r->ptr, sizeof(val));
+   r->ptr += sizeof(val);
+   return val;
+}
+
+static int64_t explore_cache_read_i64(explore_cache_reader_t *r)
+{
+   int64_t val;
+   if (r->error || (r->size - r->ptr < sizeof(val)))
+   {
+      r->error = true;
+      return 0;
+   }
+   memcpy(&val, r->data + r->ptr, sizeof(val));
+   r->ptr += sizeof(val);
+   return val;
+}
+
+/* Returns a pointer into the blob itself - no allocation */
+static const char *explore_cache_read_string(explore_cache_reader_t *r)
+{
+   const char *s;
+   uint32_t len = explore_cache_read_u32(r);
+
+   if (r->error || (len == 0))
+      return NULL;
+
+   if ((r->size - r->ptr < len) ||
+       (r->data[r->ptr + len - 1] != '\0'))
+   {
+      r->error = true;
+      return NULL;
+   }
+
+   s       = (const char*)(r->data + r->ptr);
+   r->ptr += len;
+   return s;
+}
+
+/* Identifies which category a (possibly split) value string
+ * belongs to, for serialization as a (category, index) pair */
+static bool explore_cache_find_string(explore_state_t *explore,
+      explore_string_t *str, uint32_t *cat, uint32_t *idx)
+{
+   unsigned c;
+   for (c = 0; c != EXPLORE_CAT_COUNT; c++)
+   {
+      if (explore_string_in_category(explore, c, str))
+      {
+         *cat = c;
+         *idx = str->idx;
+         return true;
+      }
+   }
+   return false;
+}
+
+static void explore_cache_save(explore_state_t *explore,
+      explore_source_t *sources, uint32_t lpl_count)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   size_t i;
+   unsigned cat;
+   intfstream_t *file = NULL;
+
+   if (!explore)
+      return;
+
+   if (!explore_cache_get_path(cache_path, sizeof(cache_path)))
+      return;
+
+   file = intfstream_open_file(cache_path,
+         RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return;
+
+   explore_cache_write_u32(file, EXPLORE_CACHE_MAGIC);
+   explore_cache_write_u32(file, EXPLORE_CACHE_VERSION);
+
+   /* Input files the materialization depends on */
+   explore_cache_write_u32(file, lpl_count);
+   explore_cache_write_u32(file, (uint32_t)RBUF_LEN(sources));
+   for (i = 0; i != RBUF_LEN(sources); i++)
+   {
+      explore_cache_write_string(file, sources[i].path);
+      explore_cache_write_i64(file, sources[i].mtime);
+      explore_cache_write_i64(file, sources[i].size);
+   }
+
+   /* Category value strings, in final sorted order */
+   for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+      explore_cache_write_u32(file, explore->has_unknown[cat] ? 1 : 0);
+   for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+   {
+      uint32_t len = (uint32_t)RBUF_LEN(explore->by[cat]);
+      explore_cache_write_u32(file, len);
+      for (i = 0; i != len; i++)
+         explore_cache_write_string(file, explore->by[cat][i]->str);
+   }
+
+   /* Playlists that contributed entries */
+   explore_cache_write_u32(file, (uint32_t)RBUF_LEN(explore->playlists));
+   for (i = 0; i != RBUF_LEN(explore->playlists); i++)
+      explore_cache_write_string(file,
+            playlist_get_conf_path(explore->playlists[i]));
+
+   /* Joined entries, in final sorted order. Playlist entry
+    * references are stored as (playlist, position) pairs */
+   explore_cache_write_u32(file, (uint32_t)RBUF_LEN(explore->entries));
+   for (i = 0; i != RBUF_LEN(explore->entries); i++)
+   {
+      explore_entry_t *e = &explore->entries[i];
+      size_t pl;
+      uint32_t split_count = 0;
+      bool found           = false;
+
+      for (pl = 0; pl != RBUF_LEN(explore->playlists); pl++)
+      {
+         const struct playlist_entry *first = NULL;
+         size_t pl_size = playlist_size(explore->playlists[pl]);
+
+         if (!pl_size)
+            continue;
+
+         playlist_get_index(explore->playlists[pl], 0, &first);
+
+         if (e->playlist_entry >= first &&
+             e->playlist_entry <  first + pl_size)
+         {
+            explore_cache_write_u32(file, (uint32_t)pl);
+            explore_cache_write_u32(file,
+                  (uint32_t)(e->playlist_entry - first));
+            found = true;
+            break;
+         }
+      }
+
+      if (!found)
+      {
+         /* Should be unreachable - make sure the reader
+          * rejects the file rather than mislink entries */
+         intfstream_close(file);
+         free(file);
+         filestream_delete(cache_path);
+         return;
+      }
+
+      for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+         explore_cache_write_u32(file,
+               e->by[cat] ? e->by[cat]->idx : (uint32_t)-1);
+
+      if (e->split)
+      {
+         explore_string_t **s;
+         for (s = e->split; *s; s++)
+            split_count++;
+      }
+      explore_cache_write_u32(file, split_count);
+      if (e->split)
+      {
+         explore_string_t **s;
+         for (s = e->split; *s; s++)
+         {
+            uint32_t s_cat = 0;
+            uint32_t s_idx = 0;
+            if (!explore_cache_find_string(explore, *s, &s_cat, &s_idx))
+            {
+               intfstream_close(file);
+               free(file);
+               filestream_delete(cache_path);
+               return;
+            }
+            explore_cache_write_u32(file, s_cat);
+            explore_cache_write_u32(file, s_idx);
+         }
+      }
+
+#ifdef EXPLORE_SHOW_ORIGINAL_TITLE
+      explore_cache_write_string(file, e->original_title);
+#else
+      explore_cache_write_u32(file, 0);
+#endif
+   }
+
+   intfstream_close(file);
+   free(file);
+}
+
+/* Rebuilds an explore state from the materialized file.
+ * Returns NULL (and deletes nothing) on any mismatch - the
+ * caller then falls back to the full build, which rewrites
+ * the cache */
+static explore_state_t *explore_cache_load(void)
+{
+   char cache_path[PATH_MAX_LENGTH];
+   explore_cache_reader_t r;
+   uint32_t i, source_count, playlist_count, entry_count;
+   unsigned cat;
+   uint8_t *blob                  = NULL;
+   int64_t blob_size              = 0;
+   explore_state_t *explore       = NULL;
+   intfstream_t *file             = NULL;
+   settings_t *settings           = config_get_ptr();
+   const char *directory_playlist = settings->paths.directory_playlist;
+
+   if (!explore_cache_get_path(cache_path, sizeof(cache_path)))
+      return NULL;
+
+   file = intfstream_open_file(cache_path,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return NULL;
+
+   blob_size = intfstream_get_size(file);
+   if (blob_size <= 0 || !(blob = (uint8_t*)malloc((size_t)blob_size)))
+   {
+      intfstream_close(file);
+      free(file);
+      return NULL;
+   }
+
+   if (intfstream_read(file, blob, blob_size) != blob_size)
+   {
+      intfstream_close(file);
+      free(file);
+      free(blob);
+      return NULL;
+   }
+   intfstream_close(file);
+   free(file);
+
+   r.data  = blob;
+   r.size  = (size_t)blob_size;
+   r.ptr   = 0;
+   r.error = false;
+
+   if (explore_cache_read_u32(&r) != EXPLORE_CACHE_MAGIC ||
+       explore_cache_read_u32(&r) != EXPLORE_CACHE_VERSION)
+      goto abort;
+
+   /* Validate the recorded inputs against the file system */
+   if (explore_cache_read_u32(&r) !=
+         explore_cache_count_playlists(directory_playlist))
+      goto abort;
+
+   source_count = explore_cache_read_u32(&r);
+   for (i = 0; i != source_count; i++)
+   {
+      const char *path = explore_cache_read_string(&r);
+      int64_t mtime    = explore_cache_read_i64(&r);
+      int64_t size     = explore_cache_read_i64(&r);
+      int64_t cur_mtime;
+      int64_t cur_size;
+
+      if (r.error || !path)
+         goto abort;
+
+      if (!explore_cache_stat(path, &cur_mtime, &cur_size))
+      {
+         cur_mtime = -1;
+         cur_size  = -1;
+      }
+
+      if (mtime != cur_mtime || size != cur_size)
+         goto abort;
+   }
+
+   if (!(explore = (explore_state_t*)calloc(1, sizeof(*explore))))
+      goto abort;
+
+   explore->label_explore_item_str =
+      msg_hash_to_str(MENU_ENUM_LABEL_EXPLORE_ITEM);
+
+   for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+      explore->has_unknown[cat] = (explore_cache_read_u32(&r) != 0);
+
+   for (cat = 0; cat != EXPLORE_CAT_COUNT; cat++)
+   {
+      uint32_t len = explore_cache_read_u32(&r);
+
+      if (r.error)
+         goto abort;
+
+      for (i = 0; i != len; i++)
+      {
+         explore_string_t *str;
+         const char *s = explore_cache_read_string(&r);
+         size_t s_len;
+
+         if (!s)
+            goto abort;
+
+         s_len    = strlen(s);
+         str      = (explore_string_t*)ex_arena_alloc(&explore->arena,
+               sizeof(explore_string_t) + s_len);
+         memcpy(str->str, s, s_len + 1);
+         str->idx = i;
+         RBUF_PUSH(explore->by[cat], str);
+      }
+   }
+
+   playlist_count = explore_cache_read_u32(&r);
+   for (i = 0; i != playlist_count; i++)
+   {
+      playlist_config_t playlist_config;
+      playlist_t *playlist = NULL;
+      const char *path     = explore_cache_read_string(&r);
+
+      if (!path)
+         goto abort;
+
+      playlist_config.base_content_directory[0] = '\0';
+      playlist_config.old_format                = false;
+      playlist_config.compress                  = false;
+      playlist_config.fuzzy_archive_match       = false;
+      playlist_config.autofix_paths             = false;
+      playlist_config.capacity                  = COLLECTION_SIZE;
+      strlcpy(playlist_config.path, path, sizeof(playlist_config.path));
+
+      if (!(playlist = playlist_init(&playlist_config)))
+         goto abort;
+
+      RBUF_PUSH(explore->playlists, playlist);
+   }
+
+   entry_count = explore_cache_read_u32(&r);
+   for (i = 0; i != entry_count; i++)
+   {
+      explore_entry_t e;
+      unsigned l;
+      uint32_t split_count;
+      uint32_t pl_idx    = explore_cache_read_u32(&r);
+      uint32_t entry_idx = explore_cache_read_u32(&r);
+
+      if (r.error || pl_idx >= RBUF_LEN(explore->playlists) ||
+          entry_idx >= playlist_size(explore->playlists[pl_idx]))
+         goto abort;
+
+      playlist_get_index(explore->playlists[pl_idx],
+            entry_idx, &e.playlist_entry);
+
+      if (!e.playlist_entry || !e.playlist_entry->label ||
+          !*e.playlist_entry->label)
+         goto abort;
+
+      for (l = 0; l != EXPLORE_CAT_COUNT; l++)
+      {
+         uint32_t idx = explore_cache_read_u32(&r);
+         if (idx == (uint32_t)-1)
+            e.by[l] = NULL;
+         else
+         {
+            if (idx >= RBUF_LEN(explore->by[l]))
+               goto abort;
+            e.by[l] = explore->by[l][idx];
+         }
+      }
+
+      e.split     = NULL;
+      split_count = explore_cache_read_u32(&r);
+      if (split_count)
+      {
+         uint32_t s;
+         if (r.error || split_count > r.size / (2 * sizeof(uint32_t)))
+            goto abort;
+         e.split = (explore_string_t**)ex_arena_alloc(&explore->arena,
+               (split_count + 1) * sizeof(explore_string_t*));
+         for (s = 0; s != split_count; s++)
+         {
+            uint32_t s_cat = explore_cache_read_u32(&r);
+            uint32_t s_idx = explore_cache_read_u32(&r);
+            if (r.error || s_cat >= EXPLORE_CAT_COUNT ||
+                s_idx >= RBUF_LEN(explore->by[s_cat]))
+               goto abort;
+            e.split[s] = explore->by[s_cat][s_idx];
+         }
+         e.split[split_count] = NULL;
+      }
+
+#ifdef EXPLORE_SHOW_ORIGINAL_TITLE
+      {
+         const char *title = explore_cache_read_string(&r);
+         e.original_title  = NULL;
+         if (title)
+         {
+            size_t t_len     = strlen(title) + 1;
+            e.original_title = (char*)
+               ex_arena_alloc(&explore->arena, t_len);
+            memcpy(e.original_title, title, t_len);
+         }
+      }
+#else
+      /* Skip any stored original title */
+      explore_cache_read_string(&r);
+#endif
+
+      RBUF_PUSH(explore->entries, e);
+   }
+
+   if (r.error)
+      goto abort;
+
+   free(blob);
+
+   explore_build_category_indexes(explore);
+   return explore;
+
+abort:
+   free(blob);
+   if (explore)
+   {
+      explore_free(explore);
+      free(explore);
+   }
+   return NULL;
+}
+
 static explore_state_t *explore_build_list(void)
 {
    unsigned i;
@@ -547,6 +1230,8 @@ static explore_state_t *explore_build_list(void)
    ex_hashmap32 rdb_indices                 = {0};
    ex_hashmap32 cat_maps[EXPLORE_CAT_COUNT] = {{0}};
    explore_string_t **split_buf             = NULL;
+   explore_source_t *sources                = NULL;
+   uint32_t lpl_count                       = 0;
    settings_t *settings                     = config_get_ptr();
    const char *directory_playlist           = settings->paths.directory_playlist;
    const char *directory_database           = settings->paths.path_content_database;
@@ -597,6 +1282,9 @@ static explore_state_t *explore_build_list(void)
       playlist_config.capacity          = COLLECTION_SIZE;
       playlist                          = playlist_init(&playlist_config);
 
+      lpl_count++;
+      explore_cache_push_source(&sources, playlist_config.path);
+
       fhash = ex_hash32_nocase_filtered(
             (unsigned char*)fname, fext - fname, '0', 255);
 
@@ -649,6 +1337,8 @@ static explore_state_t *explore_build_list(void)
                   tmp, directory_database, db_name, sizeof(tmp));
             strlcat(tmp, ".rdb", sizeof(tmp));
 
+            explore_cache_push_source(&sources, tmp);
+
             if (libretrodb_open(tmp, newrdb.handle) != 0)
             {
                /* Invalid RDB file */
@@ -695,13 +1385,16 @@ static explore_state_t *explore_build_list(void)
       struct rmsgpack_dom_value item;
       struct explore_rdb* rdb  = &rdbs[i];
       libretrodb_cursor_t *cur = libretrodb_cursor_new();
-      bool more                = 
+      bool more                =
          (
           libretrodb_cursor_open(rdb->handle, cur, NULL) == 0
-          && libretrodb_cursor_read_item(cur, &item) == 0);
+          && libretrodb_cursor_read_item_view(cur, &item) == 0);
 
-      for (; more; more = (rmsgpack_dom_value_free(&item),
-               libretrodb_cursor_read_item(cur, &item) == 0))
+      /* Everything that is kept gets copied into the explore arena, so
+       * the records can be read as views into the cursor buffer instead
+       * of heap-allocated documents */
+      for (; more; more = (rmsgpack_dom_view_free(&item),
+               libretrodb_cursor_read_item_view(cur, &item) == 0))
       {
          unsigned k, l, cat;
          explore_entry_t e;
@@ -731,7 +1424,10 @@ static explore_state_t *explore_build_list(void)
             key_str                         = key->val.string.buff;
             if (string_is_equal(key_str, "crc"))
             {
-               crc32 = swap_if_little32(*(uint32_t*)val->val.binary.buff);
+               uint32_t crc_be;
+               /* The view into the record buffer is unaligned */
+               memcpy(&crc_be, val->val.binary.buff, sizeof(crc_be));
+               crc32 = swap_if_little32(crc_be);
                continue;
             }
             else if (string_is_equal(key_str, "name"))
@@ -826,7 +1522,7 @@ static explore_state_t *explore_build_list(void)
          /* if all entries have found connections, we can leave early */
          if (--rdb->count == 0)
          {
-            rmsgpack_dom_value_free(&item);
+            rmsgpack_dom_view_free(&item);
             break;
          }
       }
@@ -859,6 +1555,14 @@ static explore_state_t *explore_build_list(void)
    qsort(explore->entries,
          RBUF_LEN(explore->entries),
          sizeof(*explore->entries), explore_qsort_func_entries);
+
+   explore_build_category_indexes(explore);
+
+   /* Materialize the joined result so the next launch can
+    * skip the rdb pass entirely */
+   explore_cache_save(explore, sources, lpl_count);
+   explore_cache_free_sources(sources);
+
    return explore;
 }
 
@@ -965,7 +1669,8 @@ unsigned menu_displaylist_explore(file_list_t *list)
 
    if (!explore_state)
    {
-      explore_state             = explore_build_list();
+      if (!(explore_state       = explore_cache_load()))
+         explore_state          = explore_build_list();
       explore_state->top_depth  = (unsigned)menu_stack->size - 1;
       explore_load_icons(explore_state);
    }
@@ -1126,8 +1831,9 @@ SKIP_EXPLORE_BY_CATEGORY:;
       bool use_split[10];
       unsigned cats[10];
       explore_string_t* filter[10];
+      size_t n, scan_count;
+      const uint32_t *scan_idx            = NULL;
       explore_entry_t *e                  = NULL;
-      explore_entry_t *e_end              = NULL;
       ex_hashmap32 map_filtered_category  = {0};
       unsigned levels                     = 0;
       bool use_find                       = (
@@ -1190,12 +1896,32 @@ SKIP_EXPLORE_BY_CATEGORY:;
          levels++;
       }
 
-      e                             = explore_state->entries;
-      e_end                         = RBUF_END(explore_state->entries);
+      /* Use the most selective per-category index range among the
+       * active filters, so only candidate entries are visited
+       * instead of the entire set */
+      scan_count                    = RBUF_LEN(explore_state->entries);
+      for (i = 0; i != levels; i++)
+      {
+         const uint32_t *offs;
+         uint32_t range_len;
+         if (!filter[i])
+            continue;
+         offs      = explore_state->by_idx_off[cats[i]];
+         if (!offs)
+            continue;
+         range_len = offs[filter[i]->idx + 1] - offs[filter[i]->idx];
+         if (range_len < scan_count)
+         {
+            scan_idx   = explore_state->by_idx[cats[i]]
+                  + offs[filter[i]->idx];
+            scan_count = range_len;
+         }
+      }
 
-      for (; e != e_end; e++)
+      for (n = 0; n != scan_count; n++)
       {
          unsigned lvl;
+         e = explore_state->entries + (scan_idx ? scan_idx[n] : n);
          for (lvl = 0; lvl != levels; lvl++)
          {
             if (filter[lvl] == e->by[cats[lvl]])
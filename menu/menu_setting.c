@@ -6360,6 +6360,72 @@ int menu_action_handle_setting(rarch_setting_t *setting,
    return -1;
 }
 
+/* Read-only index over the current settings list, sorted by
+ * enum_idx. menu_setting_find_enum is called once per entry
+ * while settings displaylists are built, so scanning the full
+ * list linearly makes building those lists quadratic. */
+static rarch_setting_t **setting_enum_index           = NULL;
+static size_t setting_enum_index_size                 = 0;
+/* List the index was built for - lookups fall back to the
+ * linear scan if the current list is a different one */
+static const rarch_setting_t *setting_enum_index_list = NULL;
+
+static void menu_setting_index_free(void)
+{
+   if (setting_enum_index)
+      free(setting_enum_index);
+   setting_enum_index      = NULL;
+   setting_enum_index_size = 0;
+   setting_enum_index_list = NULL;
+}
+
+static int menu_setting_index_compare(const void *a, const void *b)
+{
+   const rarch_setting_t *setting_a = *(const rarch_setting_t* const*)a;
+   const rarch_setting_t *setting_b = *(const rarch_setting_t* const*)b;
+
+   if (setting_a->enum_idx != setting_b->enum_idx)
+      return (setting_a->enum_idx < setting_b->enum_idx) ? -1 : 1;
+
+   /* Tie-break on list position so lookups keep returning the
+    * first match, like the linear scan did */
+   if (setting_a < setting_b)
+      return -1;
+   return 1;
+}
+
+static void menu_setting_index_build(rarch_setting_t *list, unsigned count)
+{
+   unsigned i;
+   size_t size = 0;
+
+   menu_setting_index_free();
+
+   for (i = 0; i < count; i++)
+      if (  (list[i].enum_idx != MSG_UNKNOWN) &&
+            (list[i].type <= ST_GROUP))
+         size++;
+
+   /* If the index cannot be allocated, lookups simply keep
+    * using the linear scan */
+   if (!size || !(setting_enum_index = (rarch_setting_t**)
+            malloc(size * sizeof(*setting_enum_index))))
+      return;
+
+   size = 0;
+
+   for (i = 0; i < count; i++)
+      if (  (list[i].enum_idx != MSG_UNKNOWN) &&
+            (list[i].type <= ST_GROUP))
+         setting_enum_index[size++] = &list[i];
+
+   qsort(setting_enum_index, size, sizeof(*setting_enum_index),
+         menu_setting_index_compare);
+
+   setting_enum_index_size = size;
+   setting_enum_index_list = list;
+}
+
 /**
  * menu_setting_find:
  * @settings           : pointer to settings
@@ -6416,6 +6482,37 @@ rarch_setting_t *menu_setting_find_enum(enum msg_hash_enums enum_idx)
 
    if (!setting)
       return NULL;
+
+   if (setting == setting_enum_index_list && setting_enum_index)
+   {
+      size_t first = 0;
+      size_t last  = setting_enum_index_size;
+
+      while (first < last)
+      {
+         size_t mid = first + ((last - first) >> 1);
+
+         if (setting_enum_index[mid]->enum_idx < enum_idx)
+            first    = mid + 1;
+         else
+            last     = mid;
+      }
+
+      if (     (first >= setting_enum_index_size)
+            || (setting_enum_index[first]->enum_idx != enum_idx))
+         return NULL;
+
+      setting = setting_enum_index[first];
+
+      if (string_is_empty(setting->short_description))
+         return NULL;
+
+      if (setting->read_handler)
+         setting->read_handler(setting);
+
+      return setting;
+   }
+
    for (; setting->type != ST_NONE; (*list = *list + 1))
    {
       if (  setting->enum_idx == enum_idx &&
@@ -7094,6 +7191,9 @@ static void general_write_handler(rarch_setting_t *setting)
          audio_set_float(AUDIO_ACTION_MIXER_VOLUME_GAIN, *setting->value.target.fraction);
 #endif
          break;
+      case MENU_ENUM_LABEL_AUDIO_DEVICE:
+         rarch_cmd = CMD_EVENT_AUDIO_DEVICE_MIGRATE;
+         break;
       case MENU_ENUM_LABEL_AUDIO_LATENCY:
       case MENU_ENUM_LABEL_AUDIO_OUTPUT_RATE:
       case MENU_ENUM_LABEL_AUDIO_WASAPI_EXCLUSIVE_MODE:
@@ -18406,6 +18506,9 @@ void menu_setting_free(rarch_setting_t *setting)
    if (!setting)
       return;
 
+   if (setting == setting_enum_index_list)
+      menu_setting_index_free();
+
    list                   = (rarch_setting_t**)&setting;
 
    /* Free data which was previously tagged */
@@ -18588,6 +18691,8 @@ static rarch_setting_t *menu_setting_new_internal(rarch_setting_info_t *list_inf
 
    list = resized_list;
 
+   menu_setting_index_build(list, list_info->index);
+
    return list;
 }
 
@@ -18602,6 +18707,11 @@ static rarch_setting_t *menu_setting_new_internal(rarch_setting_info_t *list_inf
  **/
 static rarch_setting_t *menu_setting_new(void)
 {
+   /* Size of the last list we built - settings lists are
+    * rebuilt on every menu init, so after the first build the
+    * doubling reallocs (and their copies of the whole array)
+    * can be skipped by allocating the right size up front */
+   static unsigned last_list_size  = 0;
    rarch_setting_t* list           = NULL;
    rarch_setting_info_t *list_info = (rarch_setting_info_t*)
       malloc(sizeof(*list_info));
@@ -18610,10 +18720,13 @@ static rarch_setting_t *menu_setting_new(void)
       return NULL;
 
    list_info->index = 0;
-   list_info->size  = 32;
+   list_info->size  = (last_list_size > 32) ? last_list_size : 32;
 
    list             = menu_setting_new_internal(list_info);
 
+   if (list)
+      last_list_size = list_info->index;
+
    if (list_info)
       free(list_info);
 
@@ -33,6 +33,28 @@ enum auto_shader_type
 
 struct video_shader *menu_shader_get(void);
 
+/**
+ * menu_shader_param_undo_record:
+ * @index                    : parameter index
+ * @value                    : value the parameter had before the edit
+ *
+ * Records a parameter edit in the undo ring. Consecutive edits of
+ * the same parameter are coalesced into one entry.
+ **/
+void menu_shader_param_undo_record(unsigned index, float value);
+
+/**
+ * menu_shader_param_undo_pop:
+ *
+ * Reverts the most recent recorded parameter edit, patching both
+ * the menu shader and the live shader of the video driver.
+ *
+ * Returns: false if the undo ring is empty.
+ **/
+bool menu_shader_param_undo_pop(void);
+
+void menu_shader_param_undo_clear(void);
+
 void menu_shader_manager_free(void *data);
 
 /**
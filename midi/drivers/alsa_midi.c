@@ -287,10 +287,18 @@ static void *alsa_midi_init(const char *input, const char *output)
       RARCH_ERR("[MIDI]: snd_seq_open failed with error %d.\n", r);
       err = true;
    }
-   else if (!alsa_midi_set_input(d, input))
-      err = true;
-   else if (!alsa_midi_set_output(d, output))
-      err = true;
+   else
+   {
+      /* The default library buffer is small enough that a busy frame
+       * can force a drain inside the write call; give ourselves room
+       * to batch a whole frame of events for the per-frame drain. */
+      snd_seq_set_output_buffer_size(d->seq, 65536);
+
+      if (!alsa_midi_set_input(d, input))
+         err = true;
+      else if (!alsa_midi_set_output(d, output))
+         err = true;
+   }
 
    if (err)
    {
@@ -445,10 +453,18 @@ static bool alsa_midi_write(void *p, const midi_event_t *event)
       ev.data.ext.len = event->data_size;
    }
 
-   r = snd_seq_event_output(d->seq, &ev);
+   /* Buffer-only variant: unlike snd_seq_event_output this never
+    * drains to the kernel behind our back, so the write path stays
+    * syscall-free and the drain happens once, in flush */
+   r = snd_seq_event_output_buffer(d->seq, &ev);
+   if (r == -EAGAIN)
+   {
+      snd_seq_drain_output(d->seq);
+      r = snd_seq_event_output_buffer(d->seq, &ev);
+   }
 #ifdef DEBUG
    if (r < 0)
-      RARCH_ERR("[MIDI]: snd_seq_event_output failed with error %d.\n", r);
+      RARCH_ERR("[MIDI]: snd_seq_event_output_buffer failed with error %d.\n", r);
 #endif
 
    d->out_ev_time.tv_sec  = ev.time.time.tv_sec;
@@ -25,11 +25,235 @@
 #include "config.h"
 #endif
 
+#if defined(HAVE_LANGPACK) && !defined(HAVE_LANGEXTRA)
+#include <stdlib.h>
+
+#include <file/file_path.h>
+#include <streams/file_stream.h>
+#include <retro_endianness.h>
+#include <retro_miscellaneous.h>
+
+#include "configuration.h"
+#include "verbosity.h"
+#endif
+
 #include "msg_hash.h"
 
 /* TODO/FIXME - static public global variable */
 static unsigned uint_user_language;
 
+#if defined(HAVE_LANGPACK) && !defined(HAVE_LANGEXTRA)
+/* External language packs - compiled by intl/h2lp.py - let
+ * console ports drop the built-in translation tables
+ * (HAVE_LANGEXTRA) from the binary and load the user's
+ * language from disk instead, keeping only English resident.
+ *
+ * Entries are keyed by the djb2 hash of the English string
+ * rather than by enum value, since the msg_hash_enums layout
+ * differs between platforms and builds. */
+
+#define LANGPACK_MAGIC         "RALP"
+#define LANGPACK_VERSION       1
+#define LANGPACK_HEADER_SIZE   16
+
+/* Raw pack file, owned by this module */
+static uint8_t *langpack_data         = NULL;
+/* {djb2(english), blob offset} pairs, sorted by hash */
+static uint32_t *langpack_pairs       = NULL;
+static uint32_t langpack_pair_count   = 0;
+static const char *langpack_blob      = NULL;
+/* Language the loader last attempted, so a missing pack is
+ * only probed once per language switch */
+static unsigned langpack_language     = RETRO_LANGUAGE_ENGLISH;
+/* Memoised per-enum lookups - reset whenever a pack is
+ * (un)loaded */
+static const char *langpack_cache[MSG_LAST];
+
+/* Maps a language to the suffix used by the files in intl/ */
+static const char *msg_hash_langpack_suffix(unsigned lang)
+{
+   switch (lang)
+   {
+      case RETRO_LANGUAGE_FRENCH:
+         return "fr";
+      case RETRO_LANGUAGE_GERMAN:
+         return "de";
+      case RETRO_LANGUAGE_SPANISH:
+         return "es";
+      case RETRO_LANGUAGE_ITALIAN:
+         return "it";
+      case RETRO_LANGUAGE_PORTUGUESE_BRAZIL:
+         return "pt_br";
+      case RETRO_LANGUAGE_PORTUGUESE_PORTUGAL:
+         return "pt_pt";
+      case RETRO_LANGUAGE_DUTCH:
+         return "nl";
+      case RETRO_LANGUAGE_ESPERANTO:
+         return "eo";
+      case RETRO_LANGUAGE_POLISH:
+         return "pl";
+      case RETRO_LANGUAGE_RUSSIAN:
+         return "ru";
+      case RETRO_LANGUAGE_JAPANESE:
+         return "ja";
+      case RETRO_LANGUAGE_KOREAN:
+         return "ko";
+      case RETRO_LANGUAGE_VIETNAMESE:
+         return "vn";
+      case RETRO_LANGUAGE_CHINESE_SIMPLIFIED:
+         return "chs";
+      case RETRO_LANGUAGE_CHINESE_TRADITIONAL:
+         return "cht";
+      case RETRO_LANGUAGE_ARABIC:
+         return "ar";
+      case RETRO_LANGUAGE_GREEK:
+         return "el";
+      case RETRO_LANGUAGE_TURKISH:
+         return "tr";
+      case RETRO_LANGUAGE_SLOVAK:
+         return "sk";
+      case RETRO_LANGUAGE_PERSIAN:
+         return "fa";
+      case RETRO_LANGUAGE_HEBREW:
+         return "he";
+      case RETRO_LANGUAGE_ASTURIAN:
+         return "ast";
+      default:
+         break;
+   }
+
+   return NULL;
+}
+
+static void msg_hash_langpack_free(void)
+{
+   if (langpack_data)
+      free(langpack_data);
+   langpack_data       = NULL;
+   langpack_pairs      = NULL;
+   langpack_pair_count = 0;
+   langpack_blob       = NULL;
+   memset(langpack_cache, 0, sizeof(langpack_cache));
+}
+
+static void msg_hash_langpack_load(void)
+{
+   char name[64];
+   char dir[PATH_MAX_LENGTH];
+   char path[PATH_MAX_LENGTH];
+   int64_t len          = 0;
+   uint8_t *data        = NULL;
+   uint32_t *header     = NULL;
+   uint32_t count       = 0;
+   uint32_t blob_len    = 0;
+   uint32_t i;
+   const char *suffix   = msg_hash_langpack_suffix(uint_user_language);
+   settings_t *settings = config_get_ptr();
+
+   /* Configuration is not up yet - try again on the
+    * next call */
+   if (!settings)
+      return;
+
+   msg_hash_langpack_free();
+   langpack_language    = uint_user_language;
+
+   if (!suffix || string_is_empty(settings->paths.directory_assets))
+      return;
+
+   name[0] = dir[0] = path[0] = '\0';
+
+   snprintf(name, sizeof(name), "msg_hash_%s.lp", suffix);
+   fill_pathname_join(dir, settings->paths.directory_assets,
+         "intl", sizeof(dir));
+   fill_pathname_join(path, dir, name, sizeof(path));
+
+   if (!filestream_read_file(path, (void**)&data, &len))
+      return;
+
+   header = (uint32_t*)data;
+
+   /* Packs are written little-endian; reject anything that
+    * does not match this build */
+   if (     (len < LANGPACK_HEADER_SIZE + 1)
+         ||  memcmp(data, LANGPACK_MAGIC, 4)
+         || (swap_if_big32(header[1]) != LANGPACK_VERSION)
+         || (swap_if_big32(header[2]) != langpack_language)
+         || (data[len - 1] != '\0'))
+   {
+      RARCH_WARN("[Langpack]: Invalid language pack: \"%s\".\n", path);
+      free(data);
+      return;
+   }
+
+   count = swap_if_big32(header[3]);
+
+   if (!count || (len < (int64_t)(LANGPACK_HEADER_SIZE + count * 8 + 1)))
+   {
+      RARCH_WARN("[Langpack]: Invalid language pack: \"%s\".\n", path);
+      free(data);
+      return;
+   }
+
+   blob_len = (uint32_t)(len - (LANGPACK_HEADER_SIZE + count * 8));
+
+   /* Byteswap the lookup table in place (no-op on
+    * little-endian targets) and sanity-check the offsets */
+   for (i = 0; i < count * 2; i++)
+   {
+      uint32_t *entry = (uint32_t*)(data + LANGPACK_HEADER_SIZE) + i;
+      *entry          = swap_if_big32(*entry);
+
+      if ((i & 1) && (*entry >= blob_len))
+      {
+         RARCH_WARN("[Langpack]: Invalid language pack: \"%s\".\n", path);
+         free(data);
+         return;
+      }
+   }
+
+   langpack_data       = data;
+   langpack_pairs      = (uint32_t*)(data + LANGPACK_HEADER_SIZE);
+   langpack_pair_count = count;
+   langpack_blob       = (const char*)data + LANGPACK_HEADER_SIZE + count * 8;
+
+   RARCH_LOG("[Langpack]: Loaded language pack: \"%s\".\n", path);
+}
+
+static const char *msg_hash_langpack_lookup(enum msg_hash_enums msg)
+{
+   const char *ret = NULL;
+
+   if (!(ret = langpack_cache[msg]))
+   {
+      const char *us = msg_hash_to_str_us(msg);
+      uint32_t hash  = msg_hash_calculate(us);
+      size_t first   = 0;
+      size_t last    = langpack_pair_count;
+
+      ret            = us;
+
+      while (first < last)
+      {
+         size_t mid = first + ((last - first) >> 1);
+
+         if (langpack_pairs[mid * 2] < hash)
+            first   = mid + 1;
+         else
+            last    = mid;
+      }
+
+      if (     (first < langpack_pair_count)
+            && (langpack_pairs[first * 2] == hash))
+         ret = langpack_blob + langpack_pairs[first * 2 + 1];
+
+      langpack_cache[msg] = ret;
+   }
+
+   return ret;
+}
+#endif
+
 int msg_hash_get_help_enum(enum msg_hash_enums msg, char *s, size_t len)
 {
    int ret = -1;
@@ -197,6 +421,20 @@ const char *msg_hash_to_str(enum msg_hash_enums msg)
 {
    const char *ret = NULL;
 
+#if defined(HAVE_LANGPACK) && !defined(HAVE_LANGEXTRA)
+   /* Without the built-in translation tables, consult the
+    * external language pack - (re)loaded lazily whenever the
+    * user language changed since the last lookup */
+   if (uint_user_language != RETRO_LANGUAGE_ENGLISH)
+   {
+      if (langpack_language != uint_user_language)
+         msg_hash_langpack_load();
+
+      if (langpack_pairs && (msg < MSG_LAST))
+         ret = msg_hash_langpack_lookup(msg);
+   }
+#endif
+
 #ifdef HAVE_LANGEXTRA
    switch (uint_user_language)
    {
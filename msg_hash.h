@@ -2130,6 +2130,7 @@ enum msg_hash_enums
    MSG_CORE_INSTALLATION_DISABLED,
 
    MENU_LABEL(VIDEO_SHADER_PARAMETERS),
+   MENU_LABEL(VIDEO_SHADER_PARAMETERS_UNDO),
    MENU_LABEL(VIDEO_SHADER_PRESET_PARAMETERS),
    MENU_LABEL(DISK_OPTIONS),
    MENU_LABEL(DISK_CYCLE_TRAY_STATUS),
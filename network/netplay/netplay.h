@@ -90,6 +90,10 @@ bool netplay_driver_ctl(enum rarch_netplay_ctl_state state, void *data);
 
 int netplay_rooms_parse(const char *buf);
 
+/* Returns true if buf is identical to the last payload that
+ * was handed to netplay_rooms_parse() */
+bool netplay_rooms_is_cached(const char *buf);
+
 struct netplay_room* netplay_room_get(int index);
 
 int netplay_rooms_get_count(void);
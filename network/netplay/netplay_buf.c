@@ -20,6 +20,64 @@
 
 #include "netplay_private.h"
 
+/* Gather (iovec) sends let us push both halves of a wrapped ring, or the
+ * ring plus an oversized payload, through one syscall without copying
+ * them back together first. */
+#if !defined(_WIN32) && (defined(__linux__) || defined(__APPLE__) || defined(__unix__))
+#define NETPLAY_HAVE_GATHER_SEND
+#include <sys/uio.h>
+#endif
+
+#ifdef NETPLAY_HAVE_GATHER_SEND
+static ssize_t gather_send(int sockfd, struct iovec *iov, int iovcnt)
+{
+   struct msghdr msg;
+
+   memset(&msg, 0, sizeof(msg));
+   msg.msg_iov    = iov;
+   msg.msg_iovlen = iovcnt;
+
+   return sendmsg(sockfd, &msg, MSG_NOSIGNAL);
+}
+
+static void gather_advance(struct iovec *iov, int iovcnt, size_t adv)
+{
+   int i;
+   for (i = 0; i < iovcnt; i++)
+   {
+      size_t chunk = (adv < iov[i].iov_len) ? adv : iov[i].iov_len;
+      iov[i].iov_base = (unsigned char*)iov[i].iov_base + chunk;
+      iov[i].iov_len -= chunk;
+      adv -= chunk;
+   }
+}
+
+static bool gather_send_all_blocking(int sockfd, struct iovec *iov,
+      int iovcnt)
+{
+   size_t total = 0;
+   int i;
+
+   for (i = 0; i < iovcnt; i++)
+      total += iov[i].iov_len;
+
+   while (total)
+   {
+      ssize_t sent = gather_send(sockfd, iov, iovcnt);
+      if (sent <= 0)
+      {
+         if (isagain((int)sent))
+            continue;
+         return false;
+      }
+      gather_advance(iov, iovcnt, (size_t)sent);
+      total -= (size_t)sent;
+   }
+
+   return true;
+}
+#endif
+
 static size_t buf_used(struct socket_buffer *sbuf)
 {
    if (sbuf->end < sbuf->start)
@@ -138,6 +196,38 @@ bool netplay_send(
       int sockfd, const void *buf,
       size_t len)
 {
+#ifdef NETPLAY_HAVE_GATHER_SEND
+   if (len >= sbuf->bufsz)
+   {
+      /* Simply too big for our buffer: gather whatever's queued and the
+       * payload into one blocking send, with no staging copy */
+      struct iovec iov[3];
+
+      if (sbuf->end < sbuf->start)
+      {
+         iov[0].iov_base = sbuf->data + sbuf->start;
+         iov[0].iov_len  = sbuf->bufsz - sbuf->start;
+         iov[1].iov_base = sbuf->data;
+         iov[1].iov_len  = sbuf->end;
+      }
+      else
+      {
+         iov[0].iov_base = sbuf->data + sbuf->start;
+         iov[0].iov_len  = sbuf->end - sbuf->start;
+         iov[1].iov_base = NULL;
+         iov[1].iov_len  = 0;
+      }
+      iov[2].iov_base = (void*)buf;
+      iov[2].iov_len  = len;
+
+      if (!gather_send_all_blocking(sockfd, iov, 3))
+         return false;
+
+      sbuf->start = sbuf->end = 0;
+      return true;
+   }
+#endif
+
    if (buf_remaining(sbuf) < len)
    {
       /* Need to force a blocking send */
@@ -147,8 +237,8 @@ bool netplay_send(
 
    if (buf_remaining(sbuf) < len)
    {
-      /* Can only be that this is simply too big 
-       * for our buffer, in which case we just 
+      /* Can only be that this is simply too big
+       * for our buffer, in which case we just
        * need to do a blocking send */
       if (!socket_send_all_blocking(sockfd, buf, len, false))
          return false;
@@ -221,6 +311,47 @@ bool netplay_send_flush(struct socket_buffer *sbuf, int sockfd, bool block)
    else
    {
       /* Unusual case: Buffer overlaps break */
+#ifdef NETPLAY_HAVE_GATHER_SEND
+      struct iovec iov[2];
+
+      iov[0].iov_base = sbuf->data + sbuf->start;
+      iov[0].iov_len  = sbuf->bufsz - sbuf->start;
+      iov[1].iov_base = sbuf->data;
+      iov[1].iov_len  = sbuf->end;
+
+      if (block)
+      {
+         if (!gather_send_all_blocking(sockfd, iov, 2))
+            return false;
+
+         sbuf->start = sbuf->end = 0;
+      }
+      else
+      {
+         size_t sent_total = 0;
+
+         while (iov[0].iov_len + iov[1].iov_len > 0)
+         {
+            ssize_t ret = gather_send(sockfd, iov, 2);
+            if (ret < 0)
+            {
+               if (isagain((int)ret))
+                  break;
+               return false;
+            }
+            if (ret == 0)
+               break;
+            gather_advance(iov, 2, (size_t)ret);
+            sent_total += (size_t)ret;
+         }
+
+         sbuf->start += sent_total;
+         if (sbuf->start >= sbuf->bufsz)
+            sbuf->start -= sbuf->bufsz;
+         if (sbuf->start == sbuf->end)
+            sbuf->start = sbuf->end = 0;
+      }
+#else
       if (block)
       {
          if (!socket_send_all_blocking(
@@ -249,6 +380,7 @@ bool netplay_send_flush(struct socket_buffer *sbuf, int sockfd, bool block)
             return netplay_send_flush(sbuf, sockfd, false);
          }
       }
+#endif
 
    }
 
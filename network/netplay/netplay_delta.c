@@ -16,13 +16,31 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include <boolean.h>
 #include <encodings/crc32.h>
+#include <memalign.h>
+#include <retro_memcpy_nt.h>
 
 #include "netplay_private.h"
 
+static uint8_t *netplay_state_buf_get(netplay_t *netplay)
+{
+   if (netplay->state_pool_count > 0)
+      return netplay->state_pool[--netplay->state_pool_count];
+   return (uint8_t*)memalign_alloc_big(netplay->state_size);
+}
+
+static void netplay_state_buf_put(netplay_t *netplay, uint8_t *buf)
+{
+   if (netplay->state_pool_count < NETPLAY_STATE_POOL_MAX)
+      netplay->state_pool[netplay->state_pool_count++] = buf;
+   else
+      memalign_free_big(buf, netplay->state_size);
+}
+
 static void clear_input(netplay_input_state_t istate)
 {
    while (istate)
@@ -55,9 +73,13 @@ bool netplay_delta_frame_ready(netplay_t *netplay, struct delta_frame *delta,
          return false;
    }
 
-   delta->used  = true;
-   delta->frame = frame;
-   delta->crc   = 0;
+   delta->used              = true;
+   delta->frame             = frame;
+   delta->crc               = 0;
+   /* Whatever packed state this slot held belongs to a frame that's a
+    * whole buffer's length in the past; it must not end up in the unpack
+    * chain for the new frame. */
+   delta->state_packed_size = 0;
 
    for (i = 0; i < MAX_INPUT_DEVICES; i++)
    {
@@ -71,17 +93,234 @@ bool netplay_delta_frame_ready(netplay_t *netplay, struct delta_frame *delta,
    return true;
 }
 
+/**
+ * netplay_delta_frame_attach
+ *
+ * Attach a full-size state buffer to a delta frame so it can be serialized
+ * into. Any packed state the frame held becomes stale and is dropped. The
+ * buffer contents are undefined.
+ */
+bool netplay_delta_frame_attach(netplay_t *netplay, struct delta_frame *delta)
+{
+   delta->state_packed_size = 0;
+   if (!delta->state)
+      delta->state = netplay_state_buf_get(netplay);
+   return delta->state != NULL;
+}
+
+/**
+ * netplay_delta_frame_detach
+ *
+ * Drop a delta frame's state buffers entirely. Used when a frame is
+ * deliberately left without a snapshot; rollback then anchors on an
+ * older frame and resimulates.
+ */
+void netplay_delta_frame_detach(netplay_t *netplay, struct delta_frame *delta)
+{
+   delta->state_packed_size = 0;
+   if (delta->state)
+   {
+      netplay_state_buf_put(netplay, (uint8_t*)delta->state);
+      delta->state = NULL;
+   }
+}
+
+/**
+ * netplay_delta_frame_pack
+ *
+ * Pack delta's state against the previous frame's state and return the
+ * previous frame's full buffer to the state pool. Both states must be
+ * materialized and belong to adjacent frames.
+ */
+bool netplay_delta_frame_pack(netplay_t *netplay, struct delta_frame *delta,
+      struct delta_frame *prev)
+{
+   size_t i           = 0;
+   size_t size        = netplay->state_size;
+   size_t out_size    = 1;
+   const uint8_t *cur = (const uint8_t*)delta->state;
+   const uint8_t *old = (const uint8_t*)prev->state;
+   uint8_t *out;
+
+   if (!cur || !old)
+      return false;
+
+   /* Worst case we store the previous state raw */
+   if (delta->state_packed_alloc < size + 1)
+   {
+      uint8_t *packed = (uint8_t*)realloc(delta->state_packed, size + 1);
+      if (!packed)
+         return false;
+      delta->state_packed       = packed;
+      delta->state_packed_alloc = (uint32_t)(size + 1);
+   }
+   out    = delta->state_packed;
+   out[0] = 0;
+
+   while (i < size)
+   {
+      uint32_t skip, count;
+      size_t j;
+      size_t run = i;
+
+      while (run < size && cur[run] == old[run])
+         run++;
+      skip = (uint32_t)(run - i);
+      i    = run;
+      while (run < size && cur[run] != old[run])
+         run++;
+      count = (uint32_t)(run - i);
+      if (!count)
+         break;
+
+      /* Bail out to a raw copy if the packed form would be bigger */
+      if (out_size + 2 * sizeof(uint32_t) + count > size + 1)
+      {
+         out[0] = 1;
+         /* The raw form is only read back when sent or
+          * unpacked much later - keep it out of the cache */
+         retro_memcpy_nt(out + 1, old, size);
+         out_size = size + 1;
+         break;
+      }
+      memcpy(out + out_size, &skip, sizeof(skip));
+      out_size += sizeof(skip);
+      memcpy(out + out_size, &count, sizeof(count));
+      out_size += sizeof(count);
+      for (j = 0; j < count; j++)
+         out[out_size + j] = cur[i + j] ^ old[i + j];
+      out_size += count;
+      i = run;
+   }
+
+   delta->state_packed_size = (uint32_t)out_size;
+   netplay_state_buf_put(netplay, (uint8_t*)prev->state);
+   prev->state = NULL;
+   return true;
+}
+
+/**
+ * netplay_delta_frame_unpack
+ *
+ * Apply delta's packed state to a buffer holding delta's full state,
+ * turning it into the previous frame's state.
+ */
+static bool netplay_delta_frame_unpack(netplay_t *netplay,
+      struct delta_frame *delta, uint8_t *buf)
+{
+   size_t size       = netplay->state_size;
+   size_t in_size    = delta->state_packed_size;
+   size_t in_pos     = 1;
+   size_t pos        = 0;
+   const uint8_t *in = delta->state_packed;
+
+   if (!in || in_size < 1)
+      return false;
+
+   if (in[0] == 1)
+   {
+      if (in_size < size + 1)
+         return false;
+      retro_memcpy_nt(buf, in + 1, size);
+      return true;
+   }
+
+   while (in_pos + 2 * sizeof(uint32_t) <= in_size)
+   {
+      uint32_t skip, count;
+      size_t j;
+      memcpy(&skip, in + in_pos, sizeof(skip));
+      in_pos += sizeof(skip);
+      memcpy(&count, in + in_pos, sizeof(count));
+      in_pos += sizeof(count);
+      if (pos + skip + count > size || in_pos + count > in_size)
+         return false;
+      pos += skip;
+      for (j = 0; j < count; j++)
+         buf[pos + j] ^= in[in_pos + j];
+      pos    += count;
+      in_pos += count;
+   }
+   return true;
+}
+
+/**
+ * netplay_delta_frame_materialize
+ *
+ * Make sure the delta frame at the given buffer index holds a full state,
+ * unpacking along the chain from the nearest newer materialized frame if
+ * necessary.
+ *
+ * Returns the state, or NULL if it cannot be reconstructed.
+ */
+uint8_t *netplay_delta_frame_materialize(netplay_t *netplay, size_t idx)
+{
+   uint8_t *buf;
+   size_t cur                 = idx;
+   size_t steps               = 0;
+   struct delta_frame *target = &netplay->buffer[idx];
+
+   if (target->state)
+      return (uint8_t*)target->state;
+   if (!target->used)
+      return NULL;
+
+   /* Find the nearest newer frame that's still materialized. Every frame
+    * on the way must hold a packed state so the chain can be walked back
+    * down. */
+   do
+   {
+      cur = NEXT_PTR(cur);
+      steps++;
+      if (steps >= netplay->buffer_size ||
+          !netplay->buffer[cur].used ||
+          netplay->buffer[cur].frame != target->frame + steps ||
+          !netplay->buffer[cur].state_packed_size)
+         return NULL;
+   } while (!netplay->buffer[cur].state);
+
+   buf = netplay_state_buf_get(netplay);
+   if (!buf)
+      return NULL;
+   retro_memcpy_nt(buf, netplay->buffer[cur].state, netplay->state_size);
+
+   /* Walk back down, turning each state into its predecessor */
+   while (cur != idx)
+   {
+      if (!netplay_delta_frame_unpack(netplay, &netplay->buffer[cur], buf))
+      {
+         netplay_state_buf_put(netplay, buf);
+         return NULL;
+      }
+      cur = PREV_PTR(cur);
+   }
+
+   target->state = buf;
+   return buf;
+}
+
 /**
  * netplay_delta_frame_crc
  *
- * Get the CRC for the serialization of this frame.
+ * Get the CRC for the serialization of this frame, materializing the state
+ * if we only have it in packed form.
+ *
+ * Returns 0 if the state cannot be reconstructed.
  */
 uint32_t netplay_delta_frame_crc(netplay_t *netplay,
       struct delta_frame *delta)
 {
+   const uint8_t *state;
    if (!netplay->state_size)
       return 0;
-   return encoding_crc32(0L, (const unsigned char*)delta->state,
+   if (delta->state)
+      state = (const uint8_t*)delta->state;
+   else
+      state = netplay_delta_frame_materialize(netplay,
+            (size_t)(delta - netplay->buffer));
+   if (!state)
+      return 0;
+   return encoding_crc32(0L, (const unsigned char*)state,
          netplay->state_size);
 }
 
@@ -104,18 +343,27 @@ static void free_input_state(netplay_input_state_t *list)
 /**
  * netplay_delta_frame_free
  *
- * Free a delta frame's dependencies
+ * Free a delta frame's dependencies. state_size must match the size the
+ * state buffer was allocated with.
  */
-void netplay_delta_frame_free(struct delta_frame *delta)
+void netplay_delta_frame_free(struct delta_frame *delta, size_t state_size)
 {
    uint32_t i;
 
    if (delta->state)
    {
-      free(delta->state);
+      memalign_free_big(delta->state, state_size);
       delta->state = NULL;
    }
 
+   if (delta->state_packed)
+   {
+      free(delta->state_packed);
+      delta->state_packed       = NULL;
+      delta->state_packed_size  = 0;
+      delta->state_packed_alloc = 0;
+   }
+
    for (i = 0; i < MAX_INPUT_DEVICES; i++)
    {
       free_input_state(&delta->resolved_input[i]);
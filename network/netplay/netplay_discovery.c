@@ -88,6 +88,18 @@ static size_t discovered_hosts_allocated;
 /* Forward declarations */
 #ifdef HAVE_NETPLAYDISCOVERY
 static bool netplay_lan_ad_client(void);
+
+/* Cap on how many advertisement packets one poll consumes, so a flood
+ * of queries can't stall the frame */
+#define NETPLAY_DISCOVERY_RECV_BUDGET 64
+
+#if defined(__linux__)
+/* recvmmsg/sendmmsg move a whole batch of datagrams per syscall;
+ * worthwhile because each advertisement packet otherwise costs a
+ * select plus a recvfrom/sendto */
+#define NETPLAY_HAVE_MMSG
+#define NETPLAY_DISCOVERY_BATCH 8
+#endif
 #endif
 
 /** Initialize Netplay discovery (client) */
@@ -165,6 +177,35 @@ bool netplay_discovery_driver_ctl(enum rarch_netplay_discovery_ctl_state state,
          memcpy((void *) &ad_packet_buffer, "RANQ", 4);
          ad_packet_buffer.protocol_version = htonl(NETPLAY_PROTOCOL_VERSION);
 
+#ifdef NETPLAY_HAVE_MMSG
+         for (k = 0; k < (unsigned)interfaces.size;)
+         {
+            int c = 0;
+            struct mmsghdr msgs[NETPLAY_DISCOVERY_BATCH];
+            struct iovec iovs[NETPLAY_DISCOVERY_BATCH];
+            struct ad_packet pkts[NETPLAY_DISCOVERY_BATCH];
+
+            memset(msgs, 0, sizeof(msgs));
+            for (; k < (unsigned)interfaces.size &&
+                  c < NETPLAY_DISCOVERY_BATCH; k++, c++)
+            {
+               pkts[c] = ad_packet_buffer;
+               strlcpy(pkts[c].address, interfaces.entries[k].host,
+                  NETPLAY_HOST_STR_LEN);
+               iovs[c].iov_base            = &pkts[c];
+               iovs[c].iov_len             = sizeof(struct ad_packet);
+               msgs[c].msg_hdr.msg_iov     = &iovs[c];
+               msgs[c].msg_hdr.msg_iovlen  = 1;
+               msgs[c].msg_hdr.msg_name    = addr->ai_addr;
+               msgs[c].msg_hdr.msg_namelen = addr->ai_addrlen;
+            }
+
+            /* One query per interface, one syscall per batch */
+            ret = sendmmsg(lan_ad_client_fd, msgs, c, 0);
+            if (ret != c)
+               RARCH_WARN("[discovery] Failed to send netplay discovery query (error: %d)\n", errno);
+         }
+#else
          for (k = 0; k < (unsigned)interfaces.size; k++)
          {
             strlcpy(ad_packet_buffer.address, interfaces.entries[k].host,
@@ -176,6 +217,7 @@ bool netplay_discovery_driver_ctl(enum rarch_netplay_discovery_ctl_state state,
             if (ret < (ssize_t) (2*sizeof(uint32_t)))
                RARCH_WARN("[discovery] Failed to send netplay discovery query (error: %d)\n", errno);
          }
+#endif
 
          freeaddrinfo_retro(addr);
          net_ifinfo_free(&interfaces);
@@ -226,6 +268,139 @@ error:
    RARCH_ERR("[discovery] Failed to initialize netplay advertisement socket\n");
    return false;
 }
+
+/**
+ * netplay_lan_ad_server_reply
+ *
+ * Validate one received ad query and send our response back over every
+ * interface the querier shares with us.
+ */
+static void netplay_lan_ad_server_reply(netplay_t *netplay,
+      net_ifinfo_t *interfaces, struct string_list *subsystem,
+      const struct ad_packet *query, struct sockaddr *their_addr)
+{
+   char buf[4096];
+   char s[NETPLAY_HOST_STR_LEN];
+   char reply_addr[NETPLAY_HOST_STR_LEN], port_str[6];
+   struct addrinfo *our_addr, hints = {0};
+   uint32_t content_crc = 0;
+   unsigned k           = 0;
+
+   /* Make sure it's a valid query */
+   if (memcmp((const void *) query, "RANQ", 4))
+   {
+      RARCH_LOG("[discovery] invalid query\n");
+      return;
+   }
+
+   /* For this version */
+   if (ntohl(query->protocol_version) != NETPLAY_PROTOCOL_VERSION)
+   {
+      RARCH_LOG("[discovery] invalid protocol version\n");
+      return;
+   }
+
+   reply_addr[0] = '\0';
+   if (!string_is_empty(query->address))
+      strlcpy(reply_addr, query->address, NETPLAY_HOST_STR_LEN);
+
+   for (k = 0; k < interfaces->size; k++)
+   {
+      char *p;
+      char sub[NETPLAY_HOST_STR_LEN];
+      char frontend_architecture_tmp[32];
+      char frontend[256];
+      const frontend_ctx_driver_t *frontend_drv =
+         (const frontend_ctx_driver_t*)
+      frontend_driver_get_cpu_architecture_str(
+            frontend_architecture_tmp, sizeof(frontend_architecture_tmp));
+      snprintf(frontend, sizeof(frontend), "%s %s",
+            frontend_drv->ident, frontend_architecture_tmp);
+
+      p=strrchr(reply_addr,'.');
+      if (p)
+      {
+         strlcpy(sub, reply_addr, p - reply_addr + 1);
+         if (strstr(interfaces->entries[k].host, sub) &&
+            !strstr(interfaces->entries[k].host, "127.0.0.1"))
+         {
+            struct retro_system_info *info = runloop_get_libretro_system_info();
+
+            RARCH_LOG ("[discovery] query received on common interface: %s/%s (theirs / ours) \n",
+               reply_addr, interfaces->entries[k].host);
+
+            /* Now build our response */
+            buf[0]      = '\0';
+            content_crc = content_get_crc();
+
+            memset(&ad_packet_buffer, 0, sizeof(struct ad_packet));
+            memcpy(&ad_packet_buffer, "RANS", 4);
+
+            if (subsystem)
+            {
+               unsigned i;
+
+               for (i = 0; i < subsystem->size; i++)
+               {
+                  strlcat(buf, path_basename(subsystem->elems[i].data), NETPLAY_HOST_LONGSTR_LEN);
+                  if (i < subsystem->size - 1)
+                     strlcat(buf, "|", NETPLAY_HOST_LONGSTR_LEN);
+               }
+               strlcpy(ad_packet_buffer.content, buf,
+                  NETPLAY_HOST_LONGSTR_LEN);
+               strlcpy(ad_packet_buffer.subsystem_name, path_get(RARCH_PATH_SUBSYSTEM),
+                  NETPLAY_HOST_STR_LEN);
+            }
+            else
+            {
+               strlcpy(ad_packet_buffer.content, !string_is_empty(
+                        path_basename(path_get(RARCH_PATH_BASENAME)))
+                     ? path_basename(path_get(RARCH_PATH_BASENAME)) : "N/A",
+                     NETPLAY_HOST_LONGSTR_LEN);
+               strlcpy(ad_packet_buffer.subsystem_name, "N/A", NETPLAY_HOST_STR_LEN);
+            }
+
+            strlcpy(ad_packet_buffer.address, interfaces->entries[k].host,
+               NETPLAY_HOST_STR_LEN);
+            ad_packet_buffer.protocol_version =
+               htonl(NETPLAY_PROTOCOL_VERSION);
+            ad_packet_buffer.port = htonl(netplay->tcp_port);
+            strlcpy(ad_packet_buffer.retroarch_version, PACKAGE_VERSION,
+               NETPLAY_HOST_STR_LEN);
+            strlcpy(ad_packet_buffer.nick, netplay->nick, NETPLAY_HOST_STR_LEN);
+            strlcpy(ad_packet_buffer.frontend, frontend, NETPLAY_HOST_STR_LEN);
+
+            if (info)
+            {
+               strlcpy(ad_packet_buffer.core, info->library_name,
+                  NETPLAY_HOST_STR_LEN);
+               strlcpy(ad_packet_buffer.core_version, info->library_version,
+                  NETPLAY_HOST_STR_LEN);
+            }
+
+            snprintf(s, sizeof(s), "%d", content_crc);
+            strlcpy(ad_packet_buffer.content_crc, s,
+               NETPLAY_HOST_STR_LEN);
+
+            /* Build up the destination address*/
+            snprintf(port_str, 6, "%hu", ntohs(((struct sockaddr_in*)their_addr)->sin_port));
+            if (getaddrinfo_retro(reply_addr, port_str, &hints, &our_addr) < 0)
+               continue;
+
+            RARCH_LOG ("[discovery] sending reply to %s \n", reply_addr);
+
+            /* And send it */
+            sendto(lan_ad_server_fd, (const char*)&ad_packet_buffer,
+                  sizeof(struct ad_packet), 0, our_addr->ai_addr, our_addr->ai_addrlen);
+            freeaddrinfo_retro(our_addr);
+         }
+         else
+            continue;
+      }
+      else
+         continue;
+   }
+}
 #endif
 
 /**
@@ -237,25 +412,12 @@ bool netplay_lan_ad_server(netplay_t *netplay)
 {
 /* Todo: implement net_ifinfo and ntohs for consoles */
 #ifdef HAVE_NETPLAYDISCOVERY
-   fd_set fds;
-   int ret;
-   unsigned i;
-   char buf[4096];
    net_ifinfo_t interfaces;
-   socklen_t addr_size;
-   char reply_addr[NETPLAY_HOST_STR_LEN], port_str[6];
-   struct sockaddr their_addr;
-   struct timeval tmp_tv            = {0};
-   unsigned k                       = 0;
-   struct addrinfo *our_addr, hints = {0};
-   struct string_list *subsystem    = path_get_subsystem_list();
+   struct string_list *subsystem = path_get_subsystem_list();
+   unsigned budget               = NETPLAY_DISCOVERY_RECV_BUDGET;
 
-   interfaces.entries               = NULL;
-   interfaces.size                  = 0;
-
-   their_addr.sa_family             = 0;
-   for (i = 0; i < 14; i++)
-      their_addr.sa_data[i]         = 0;
+   interfaces.entries            = NULL;
+   interfaces.size               = 0;
 
    if (!net_ifinfo_new(&interfaces))
       return false;
@@ -264,9 +426,54 @@ bool netplay_lan_ad_server(netplay_t *netplay)
          && !init_lan_ad_server_socket(netplay, RARCH_DEFAULT_PORT))
       return false;
 
-   /* Check for any ad queries */
-   for (;;)
+   /* Check for any ad queries, draining the socket in batches under a
+    * per-poll packet budget */
+#ifdef NETPLAY_HAVE_MMSG
+   while (budget)
+   {
+      int n, j;
+      struct mmsghdr msgs[NETPLAY_DISCOVERY_BATCH];
+      struct iovec iovs[NETPLAY_DISCOVERY_BATCH];
+      struct ad_packet pkts[NETPLAY_DISCOVERY_BATCH];
+      struct sockaddr_storage addrs[NETPLAY_DISCOVERY_BATCH];
+
+      memset(msgs, 0, sizeof(msgs));
+      for (j = 0; j < NETPLAY_DISCOVERY_BATCH; j++)
+      {
+         iovs[j].iov_base            = &pkts[j];
+         iovs[j].iov_len             = sizeof(struct ad_packet);
+         msgs[j].msg_hdr.msg_iov     = &iovs[j];
+         msgs[j].msg_hdr.msg_iovlen  = 1;
+         msgs[j].msg_hdr.msg_name    = &addrs[j];
+         msgs[j].msg_hdr.msg_namelen = sizeof(addrs[j]);
+      }
+
+      n = recvmmsg(lan_ad_server_fd, msgs,
+            NETPLAY_DISCOVERY_BATCH, MSG_DONTWAIT, NULL);
+      if (n <= 0)
+         break;
+
+      for (j = 0; j < n && budget; j++, budget--)
+      {
+         if (msgs[j].msg_len < 2 * sizeof(uint32_t))
+            continue;
+         netplay_lan_ad_server_reply(netplay, &interfaces, subsystem,
+               &pkts[j], (struct sockaddr*)&addrs[j]);
+      }
+
+      /* A short batch means the queue is drained */
+      if (n < NETPLAY_DISCOVERY_BATCH)
+         break;
+   }
+#else
+   while (budget--)
    {
+      fd_set fds;
+      int ret;
+      socklen_t addr_size;
+      struct sockaddr their_addr;
+      struct timeval tmp_tv = {0};
+
       FD_ZERO(&fds);
       FD_SET(lan_ad_server_fd, &fds);
       if (socket_select(lan_ad_server_fd + 1, &fds, NULL, NULL, &tmp_tv) <= 0)
@@ -278,127 +485,13 @@ bool netplay_lan_ad_server(netplay_t *netplay)
       addr_size = sizeof(their_addr);
       ret       = (int)recvfrom(lan_ad_server_fd, (char*)&ad_packet_buffer,
             sizeof(struct ad_packet), 0, &their_addr, &addr_size);
-      if (ret >= (ssize_t) (2 * sizeof(uint32_t)))
-      {
-         char s[NETPLAY_HOST_STR_LEN];
-         uint32_t content_crc         = 0;
-
-         /* Make sure it's a valid query */
-         if (memcmp((void *) &ad_packet_buffer, "RANQ", 4))
-         {
-            RARCH_LOG("[discovery] invalid query\n");
-            continue;
-         }
-
-         /* For this version */
-         if (ntohl(ad_packet_buffer.protocol_version) !=
-               NETPLAY_PROTOCOL_VERSION)
-         {
-            RARCH_LOG("[discovery] invalid protocol version\n");
-            continue;
-         }
+      if (ret < (ssize_t) (2 * sizeof(uint32_t)))
+         continue;
 
-         if (!string_is_empty(ad_packet_buffer.address))
-            strlcpy(reply_addr, ad_packet_buffer.address, NETPLAY_HOST_STR_LEN);
-
-         for (k = 0; k < interfaces.size; k++)
-         {
-            char *p;
-            char sub[NETPLAY_HOST_STR_LEN];
-            char frontend_architecture_tmp[32];
-            char frontend[256];
-            const frontend_ctx_driver_t *frontend_drv = 
-               (const frontend_ctx_driver_t*)
-            frontend_driver_get_cpu_architecture_str(
-                  frontend_architecture_tmp, sizeof(frontend_architecture_tmp));
-            snprintf(frontend, sizeof(frontend), "%s %s",
-                  frontend_drv->ident, frontend_architecture_tmp);
-
-            p=strrchr(reply_addr,'.');
-            if (p)
-            {
-               strlcpy(sub, reply_addr, p - reply_addr + 1);
-               if (strstr(interfaces.entries[k].host, sub) &&
-                  !strstr(interfaces.entries[k].host, "127.0.0.1"))
-               {
-                  struct retro_system_info *info = runloop_get_libretro_system_info();
-
-                  RARCH_LOG ("[discovery] query received on common interface: %s/%s (theirs / ours) \n",
-                     reply_addr, interfaces.entries[k].host);
-
-                  /* Now build our response */
-                  buf[0]      = '\0';
-                  content_crc = content_get_crc();
-
-                  memset(&ad_packet_buffer, 0, sizeof(struct ad_packet));
-                  memcpy(&ad_packet_buffer, "RANS", 4);
-
-                  if (subsystem)
-                  {
-                     unsigned i;
-
-                     for (i = 0; i < subsystem->size; i++)
-                     {
-                        strlcat(buf, path_basename(subsystem->elems[i].data), NETPLAY_HOST_LONGSTR_LEN);
-                        if (i < subsystem->size - 1)
-                           strlcat(buf, "|", NETPLAY_HOST_LONGSTR_LEN);
-                     }
-                     strlcpy(ad_packet_buffer.content, buf,
-                        NETPLAY_HOST_LONGSTR_LEN);
-                     strlcpy(ad_packet_buffer.subsystem_name, path_get(RARCH_PATH_SUBSYSTEM),
-                        NETPLAY_HOST_STR_LEN);
-                  }
-                  else
-                  {
-                     strlcpy(ad_packet_buffer.content, !string_is_empty(
-                              path_basename(path_get(RARCH_PATH_BASENAME)))
-                           ? path_basename(path_get(RARCH_PATH_BASENAME)) : "N/A",
-                           NETPLAY_HOST_LONGSTR_LEN);
-                     strlcpy(ad_packet_buffer.subsystem_name, "N/A", NETPLAY_HOST_STR_LEN);
-                  }
-
-                  strlcpy(ad_packet_buffer.address, interfaces.entries[k].host,
-                     NETPLAY_HOST_STR_LEN);
-                  ad_packet_buffer.protocol_version =
-                     htonl(NETPLAY_PROTOCOL_VERSION);
-                  ad_packet_buffer.port = htonl(netplay->tcp_port);
-                  strlcpy(ad_packet_buffer.retroarch_version, PACKAGE_VERSION,
-                     NETPLAY_HOST_STR_LEN);
-                  strlcpy(ad_packet_buffer.nick, netplay->nick, NETPLAY_HOST_STR_LEN);
-                  strlcpy(ad_packet_buffer.frontend, frontend, NETPLAY_HOST_STR_LEN);
-
-                  if (info)
-                  {
-                     strlcpy(ad_packet_buffer.core, info->library_name,
-                        NETPLAY_HOST_STR_LEN);
-                     strlcpy(ad_packet_buffer.core_version, info->library_version,
-                        NETPLAY_HOST_STR_LEN);
-                  }
-
-                  snprintf(s, sizeof(s), "%d", content_crc);
-                  strlcpy(ad_packet_buffer.content_crc, s,
-                     NETPLAY_HOST_STR_LEN);
-
-                  /* Build up the destination address*/
-                  snprintf(port_str, 6, "%hu", ntohs(((struct sockaddr_in*)(&their_addr))->sin_port));
-                  if (getaddrinfo_retro(reply_addr, port_str, &hints, &our_addr) < 0)
-                     continue;
-
-                  RARCH_LOG ("[discovery] sending reply to %s \n", reply_addr);
-
-                  /* And send it */
-                  sendto(lan_ad_server_fd, (const char*)&ad_packet_buffer,
-                        sizeof(struct ad_packet), 0, our_addr->ai_addr, our_addr->ai_addrlen);
-                  freeaddrinfo_retro(our_addr);
-               }
-               else
-                  continue;
-            }
-            else
-               continue;
-         }
-      }
+      netplay_lan_ad_server_reply(netplay, &interfaces, subsystem,
+            &ad_packet_buffer, &their_addr);
    }
+#endif
    net_ifinfo_free(&interfaces);
 #endif
    return true;
@@ -423,24 +516,168 @@ static int16_t htons_for_morons(int16_t value)
 #endif
 
 #ifdef HAVE_NETPLAYDISCOVERY
+/**
+ * netplay_lan_ad_client_response
+ *
+ * Validate one received ad response and add it to the discovered host
+ * list. Returns false only on allocation failure.
+ */
+static bool netplay_lan_ad_client_response(const struct ad_packet *pkt,
+      struct sockaddr *their_addr, socklen_t addr_size)
+{
+   struct netplay_host *host = NULL;
+
+   /* Make sure it's a valid response */
+   if (memcmp((const void *) pkt, "RANS", 4))
+      return true;
+
+   /* For this version */
+   if (ntohl(pkt->protocol_version) != NETPLAY_PROTOCOL_VERSION)
+      return true;
+
+   /* And that we know how to handle it */
+   if (their_addr->sa_family == AF_INET)
+   {
+      struct sockaddr_in *sin = NULL;
+
+      RARCH_WARN ("[discovery] using IPv4 for discovery\n");
+      sin           = (struct sockaddr_in *) their_addr;
+      sin->sin_port = htons(ntohl(pkt->port));
+
+   }
+#ifdef HAVE_INET6
+   else if (their_addr->sa_family == AF_INET6)
+   {
+      struct sockaddr_in6 *sin6 = NULL;
+      RARCH_WARN ("[discovery] using IPv6 for discovery\n");
+      sin6            = (struct sockaddr_in6 *) their_addr;
+      sin6->sin6_port = htons(pkt->port);
+
+   }
+#endif
+   else return true;
+
+   /* Allocate space for it */
+   if (discovered_hosts.size >= discovered_hosts_allocated)
+   {
+      size_t allocated               = discovered_hosts_allocated;
+      struct netplay_host *new_hosts = NULL;
+
+      if (allocated == 0)
+         allocated  = 2;
+      else
+         allocated *= 2;
+
+      if (discovered_hosts.hosts)
+         new_hosts  = (struct netplay_host *)
+            realloc(discovered_hosts.hosts, allocated * sizeof(struct
+            netplay_host));
+      else
+         /* Should be equivalent to realloc, but I don't trust screwy libcs */
+         new_hosts = (struct netplay_host *)
+            malloc(allocated * sizeof(struct netplay_host));
+
+      if (!new_hosts)
+         return false;
+
+      discovered_hosts.hosts     = new_hosts;
+      discovered_hosts_allocated = allocated;
+   }
+
+   /* Get our host structure */
+   host = &discovered_hosts.hosts[discovered_hosts.size++];
+
+   /* Copy in the response */
+   memset(host, 0, sizeof(struct netplay_host));
+   host->addr    = *their_addr;
+   host->addrlen = addr_size;
+
+   host->port = ntohl(pkt->port);
+
+   strlcpy(host->address, pkt->address, NETPLAY_HOST_STR_LEN);
+   strlcpy(host->nick, pkt->nick, NETPLAY_HOST_STR_LEN);
+   strlcpy(host->core, pkt->core, NETPLAY_HOST_STR_LEN);
+   strlcpy(host->retroarch_version, pkt->retroarch_version,
+      NETPLAY_HOST_STR_LEN);
+   strlcpy(host->core_version, pkt->core_version,
+      NETPLAY_HOST_STR_LEN);
+   strlcpy(host->content, pkt->content,
+      NETPLAY_HOST_LONGSTR_LEN);
+   strlcpy(host->subsystem_name, pkt->subsystem_name,
+      NETPLAY_HOST_LONGSTR_LEN);
+   strlcpy(host->frontend, pkt->frontend,
+      NETPLAY_HOST_STR_LEN);
+
+   host->content_crc                  =
+      atoi(pkt->content_crc);
+   host->nick[NETPLAY_HOST_STR_LEN-1] =
+      host->core[NETPLAY_HOST_STR_LEN-1] =
+      host->core_version[NETPLAY_HOST_STR_LEN-1] =
+      host->content[NETPLAY_HOST_LONGSTR_LEN-1] = '\0';
+
+   return true;
+}
+
 static bool netplay_lan_ad_client(void)
 {
-   unsigned i;
-   fd_set fds;
-   socklen_t addr_size;
-   struct sockaddr their_addr;
-   struct timeval tmp_tv    = {0};
+   unsigned budget = NETPLAY_DISCOVERY_RECV_BUDGET;
 
    if (lan_ad_client_fd < 0)
       return false;
 
-   their_addr.sa_family     = 0;
-   for (i = 0; i < 14; i++)
-      their_addr.sa_data[i] = 0;
+   /* Check for any ad responses, draining the socket in batches under a
+    * per-poll packet budget */
+#ifdef NETPLAY_HAVE_MMSG
+   while (budget)
+   {
+      int n, j;
+      struct mmsghdr msgs[NETPLAY_DISCOVERY_BATCH];
+      struct iovec iovs[NETPLAY_DISCOVERY_BATCH];
+      struct ad_packet pkts[NETPLAY_DISCOVERY_BATCH];
+      struct sockaddr_storage addrs[NETPLAY_DISCOVERY_BATCH];
+
+      memset(msgs, 0, sizeof(msgs));
+      for (j = 0; j < NETPLAY_DISCOVERY_BATCH; j++)
+      {
+         iovs[j].iov_base            = &pkts[j];
+         iovs[j].iov_len             = sizeof(struct ad_packet);
+         msgs[j].msg_hdr.msg_iov     = &iovs[j];
+         msgs[j].msg_hdr.msg_iovlen  = 1;
+         msgs[j].msg_hdr.msg_name    = &addrs[j];
+         msgs[j].msg_hdr.msg_namelen = sizeof(addrs[j]);
+      }
+
+      n = recvmmsg(lan_ad_client_fd, msgs,
+            NETPLAY_DISCOVERY_BATCH, MSG_DONTWAIT, NULL);
+      if (n <= 0)
+         break;
 
-   /* Check for any ad queries */
-   for (;;)
+      for (j = 0; j < n && budget; j++, budget--)
+      {
+         if (msgs[j].msg_len < sizeof(struct ad_packet))
+            continue;
+         if (!netplay_lan_ad_client_response(&pkts[j],
+               (struct sockaddr*)&addrs[j], msgs[j].msg_hdr.msg_namelen))
+            return false;
+      }
+
+      /* A short batch means the queue is drained */
+      if (n < NETPLAY_DISCOVERY_BATCH)
+         break;
+   }
+#else
+   while (budget--)
    {
+      fd_set fds;
+      unsigned i;
+      socklen_t addr_size;
+      struct sockaddr their_addr;
+      struct timeval tmp_tv    = {0};
+
+      their_addr.sa_family     = 0;
+      for (i = 0; i < 14; i++)
+         their_addr.sa_data[i] = 0;
+
       FD_ZERO(&fds);
       FD_SET(lan_ad_client_fd, &fds);
       if (socket_select(lan_ad_client_fd + 1,
@@ -450,104 +687,19 @@ static bool netplay_lan_ad_client(void)
       if (!FD_ISSET(lan_ad_client_fd, &fds))
          break;
 
-      /* Somebody queried, so check that it's valid */
+      /* Somebody responded, so check that it's valid */
       addr_size = sizeof(their_addr);
 
       if (recvfrom(lan_ad_client_fd, (char*)&ad_packet_buffer,
-            sizeof(struct ad_packet), 0, &their_addr, &addr_size) >=
+            sizeof(struct ad_packet), 0, &their_addr, &addr_size) <
             (ssize_t) sizeof(struct ad_packet))
-      {
-         struct netplay_host *host = NULL;
-
-         /* Make sure it's a valid response */
-         if (memcmp((void *) &ad_packet_buffer, "RANS", 4))
-            continue;
-
-         /* For this version */
-         if (ntohl(ad_packet_buffer.protocol_version) != NETPLAY_PROTOCOL_VERSION)
-            continue;
-
-         /* And that we know how to handle it */
-         if (their_addr.sa_family == AF_INET)
-         {
-            struct sockaddr_in *sin = NULL;
+         continue;
 
-            RARCH_WARN ("[discovery] using IPv4 for discovery\n");
-            sin           = (struct sockaddr_in *) &their_addr;
-            sin->sin_port = htons(ntohl(ad_packet_buffer.port));
-
-         }
-#ifdef HAVE_INET6
-         else if (their_addr.sa_family == AF_INET6)
-         {
-            struct sockaddr_in6 *sin6 = NULL;
-            RARCH_WARN ("[discovery] using IPv6 for discovery\n");
-            sin6            = (struct sockaddr_in6 *) &their_addr;
-            sin6->sin6_port = htons(ad_packet_buffer.port);
-
-         }
-#endif
-         else continue;
-
-         /* Allocate space for it */
-         if (discovered_hosts.size >= discovered_hosts_allocated)
-         {
-            size_t allocated               = discovered_hosts_allocated;
-            struct netplay_host *new_hosts = NULL;
-
-            if (allocated == 0)
-               allocated  = 2;
-            else
-               allocated *= 2;
-
-            if (discovered_hosts.hosts)
-               new_hosts  = (struct netplay_host *)
-                  realloc(discovered_hosts.hosts, allocated * sizeof(struct
-                  netplay_host));
-            else
-               /* Should be equivalent to realloc, but I don't trust screwy libcs */
-               new_hosts = (struct netplay_host *)
-                  malloc(allocated * sizeof(struct netplay_host));
-
-            if (!new_hosts)
-               return false;
-
-            discovered_hosts.hosts     = new_hosts;
-            discovered_hosts_allocated = allocated;
-         }
-
-         /* Get our host structure */
-         host = &discovered_hosts.hosts[discovered_hosts.size++];
-
-         /* Copy in the response */
-         memset(host, 0, sizeof(struct netplay_host));
-         host->addr    = their_addr;
-         host->addrlen = addr_size;
-
-         host->port = ntohl(ad_packet_buffer.port);
-
-         strlcpy(host->address, ad_packet_buffer.address, NETPLAY_HOST_STR_LEN);
-         strlcpy(host->nick, ad_packet_buffer.nick, NETPLAY_HOST_STR_LEN);
-         strlcpy(host->core, ad_packet_buffer.core, NETPLAY_HOST_STR_LEN);
-         strlcpy(host->retroarch_version, ad_packet_buffer.retroarch_version,
-            NETPLAY_HOST_STR_LEN);
-         strlcpy(host->core_version, ad_packet_buffer.core_version,
-            NETPLAY_HOST_STR_LEN);
-         strlcpy(host->content, ad_packet_buffer.content,
-            NETPLAY_HOST_LONGSTR_LEN);
-         strlcpy(host->subsystem_name, ad_packet_buffer.subsystem_name,
-            NETPLAY_HOST_LONGSTR_LEN);
-         strlcpy(host->frontend, ad_packet_buffer.frontend,
-            NETPLAY_HOST_STR_LEN);
-
-         host->content_crc                  =
-            atoi(ad_packet_buffer.content_crc);
-         host->nick[NETPLAY_HOST_STR_LEN-1] =
-            host->core[NETPLAY_HOST_STR_LEN-1] =
-            host->core_version[NETPLAY_HOST_STR_LEN-1] =
-            host->content[NETPLAY_HOST_LONGSTR_LEN-1] = '\0';
-      }
+      if (!netplay_lan_ad_client_response(&ad_packet_buffer,
+            &their_addr, addr_size))
+         return false;
    }
+#endif
 
    return true;
 }
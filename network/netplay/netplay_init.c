@@ -25,6 +25,7 @@
 
 #include <boolean.h>
 #include <compat/strl.h>
+#include <memalign.h>
 
 #include "netplay_private.h"
 
@@ -284,15 +285,21 @@ static bool netplay_init_serialization(netplay_t *netplay)
 
    netplay->state_size = info.size;
 
-   for (i = 0; i < netplay->buffer_size; i++)
+   /* Frames only hold their state in packed form once the next frame has
+    * been serialized; prime the pool with enough full buffers for the
+    * steady state so we find out about allocation failure now. */
+   for (i = 0; i < 2; i++)
    {
-      netplay->buffer[i].state = calloc(netplay->state_size, 1);
+      uint8_t *buf = (uint8_t*)memalign_alloc_big(netplay->state_size);
 
-      if (!netplay->buffer[i].state)
+      if (!buf)
       {
          netplay->quirks |= NETPLAY_QUIRK_NO_SAVESTATES;
          return false;
       }
+
+      memset(buf, 0, netplay->state_size);
+      netplay->state_pool[netplay->state_pool_count++] = buf;
    }
 
    netplay->zbuffer_size = netplay->state_size * 2;
@@ -325,6 +332,10 @@ bool netplay_try_init_serialization(netplay_t *netplay)
       return false;
 
    /* Check if we can actually save */
+   if (!netplay_delta_frame_attach(netplay,
+            &netplay->buffer[netplay->run_ptr]))
+      return false;
+
    serial_info.data_const = NULL;
    serial_info.data       = netplay->buffer[netplay->run_ptr].state;
    serial_info.size       = netplay->state_size;
@@ -434,6 +445,7 @@ netplay_t *netplay_new(void *direct_host, const char *server, uint16_t port,
    netplay->check_frames         = check_frames;
    netplay->crc_validity_checked = false;
    netplay->crcs_valid           = true;
+   netplay->snapshot_interval    = 1;
    netplay->quirks               = quirks;
    netplay->self_mode            = netplay->is_server ?
                                 NETPLAY_CONNECTION_SPECTATING :
@@ -552,11 +564,15 @@ void netplay_free(netplay_t *netplay)
    if (netplay->buffer)
    {
       for (i = 0; i < netplay->buffer_size; i++)
-         netplay_delta_frame_free(&netplay->buffer[i]);
+         netplay_delta_frame_free(&netplay->buffer[i], netplay->state_size);
 
       free(netplay->buffer);
    }
 
+   while (netplay->state_pool_count > 0)
+      memalign_free_big(netplay->state_pool[--netplay->state_pool_count],
+            netplay->state_size);
+
    if (netplay->zbuffer)
       free(netplay->zbuffer);
 
@@ -1543,12 +1543,14 @@ static bool netplay_get_cmd(netplay_t *netplay,
             if (buffer[0] <= netplay->other_frame_count)
             {
                /* We've already replayed up to this frame, so we can check it
-                * directly */
+                * directly. A zero CRC means we couldn't reconstruct the
+                * state (it's fallen out of the packed chain), so there's
+                * nothing to check. */
                uint32_t local_crc = netplay_delta_frame_crc(
                      netplay, &netplay->buffer[tmp_ptr]);
 
                /* Problem! */
-               if (buffer[1] != local_crc)
+               if (local_crc && buffer[1] != local_crc)
                   netplay_cmd_request_savestate(netplay);
             }
             else
@@ -1654,7 +1656,8 @@ static bool netplay_get_cmd(netplay_t *netplay,
                return netplay_cmd_nak(netplay, connection);
             }
 
-            if (!netplay_delta_frame_ready(netplay, &netplay->buffer[load_ptr], load_frame_count))
+            if (!netplay_delta_frame_ready(netplay, &netplay->buffer[load_ptr], load_frame_count) ||
+                !netplay_delta_frame_attach(netplay, &netplay->buffer[load_ptr]))
             {
                /* Hopefully it will be after another round of input */
                goto shrt;
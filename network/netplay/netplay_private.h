@@ -57,6 +57,27 @@ typedef uint32_t client_bitmap_t;
 #define NETPLAY_MAX_REQ_STALL_TIME     60
 #define NETPLAY_MAX_REQ_STALL_FREQUENCY 120
 
+/* How many full-size state buffers we keep around for reuse. Only frames
+ * whose state is currently materialized hold one; everything else keeps a
+ * packed delta against the previous frame. */
+#define NETPLAY_STATE_POOL_MAX         8
+
+/* Cap on how much wall-clock time one call to netplay_sync_post() may
+ * spend resimulating after a rollback. Deeper rollbacks are spread over
+ * the following iterations so a high-latency peer doesn't freeze the
+ * local player. */
+#define NETPLAY_MAX_ROLLBACK_USEC      (10 * 1000)
+
+/* Widest the adaptive snapshot cadence may stretch: at most this many
+ * frames between savestate serializations while the connection is
+ * stable. Skipped frames are rebuilt by resimulation when a rollback
+ * needs them. */
+#define NETPLAY_MAX_SNAPSHOT_INTERVAL  8
+
+/* How many frames must confirm without a replay before the snapshot
+ * cadence relaxes another notch */
+#define NETPLAY_SNAPSHOT_RELAX_FRAMES  180
+
 #define PREV_PTR(x) ((x) == 0 ? netplay->buffer_size - 1 : (x) - 1)
 #define NEXT_PTR(x) ((x + 1) % netplay->buffer_size)
 
@@ -296,9 +317,18 @@ struct delta_frame
    /* The real input */
    netplay_input_state_t real_input[MAX_INPUT_DEVICES]; /* ptr alignment */
 
-   /* The serialized state of the core at this frame, before input */
+   /* The serialized state of the core at this frame, before input. NULL
+    * while the state only exists in packed form. */
    void *state;
 
+   /* The same state XOR/RLE-packed against the previous frame's state, so
+    * the full buffer can go back to the state pool once the next frame has
+    * been serialized. The full state is materialized back into 'state'
+    * lazily (see netplay_delta_frame_materialize). */
+   uint8_t *state_packed;
+   uint32_t state_packed_size; /* 0: no packed state */
+   uint32_t state_packed_alloc;
+
    uint32_t frame;
 
    /* The CRC-32 of the serialized state if we've calculated it, else 0 */
@@ -453,6 +483,11 @@ struct netplay
    uint8_t *zbuffer;
    size_t zbuffer_size;
 
+   /* Pool of full-size state buffers. Delta frames borrow one while their
+    * state is materialized; most frames only hold a packed state. */
+   uint8_t *state_pool[NETPLAY_STATE_POOL_MAX];
+   unsigned state_pool_count;
+
    /* The size of our packet buffers */
    size_t packet_buffer_size;
 
@@ -500,6 +535,20 @@ struct netplay
    /* Latency frames; positive to hide network latency, negative to hide input latency */
    int input_latency_frames;
 
+   /* Input prediction bookkeeping over a sliding window: frames
+    * confirmed without needing a replay, and frames that had to be
+    * replayed because the speculated input turned out wrong. Used to
+    * bias the input latency adjustment - frequent mispredictions mean
+    * visible rollback corrections, which extra input latency hides. */
+   uint32_t predict_window_hit;
+   uint32_t predict_window_miss;
+
+   /* Adaptive snapshot cadence: serialize every snapshot_interval-th
+    * frame, stretching while frames confirm without replays and
+    * snapping back to every frame on a rollback. Never zero. */
+   uint32_t snapshot_interval;
+   uint32_t snapshot_clean_frames;
+
    /* Frequency with which to check CRCs */
    int check_frames;
 
@@ -670,12 +719,52 @@ bool netplay_delta_frame_ready(netplay_t *netplay, struct delta_frame *delta,
  */
 uint32_t netplay_delta_frame_crc(netplay_t *netplay, struct delta_frame *delta);
 
+/**
+ * netplay_delta_frame_attach
+ *
+ * Attach a full-size state buffer to a delta frame so it can be serialized
+ * into. Any packed state the frame held becomes stale and is dropped. The
+ * buffer contents are undefined.
+ */
+bool netplay_delta_frame_attach(netplay_t *netplay, struct delta_frame *delta);
+
+/**
+ * netplay_delta_frame_detach
+ *
+ * Drop a delta frame's state buffers entirely. Used when a frame is
+ * deliberately left without a snapshot; rollback then anchors on an
+ * older frame and resimulates.
+ */
+void netplay_delta_frame_detach(netplay_t *netplay, struct delta_frame *delta);
+
+/**
+ * netplay_delta_frame_pack
+ *
+ * Pack delta's state against the previous frame's state and return the
+ * previous frame's full buffer to the state pool. Both states must be
+ * materialized and belong to adjacent frames.
+ */
+bool netplay_delta_frame_pack(netplay_t *netplay, struct delta_frame *delta,
+      struct delta_frame *prev);
+
+/**
+ * netplay_delta_frame_materialize
+ *
+ * Make sure the delta frame at the given buffer index holds a full state,
+ * unpacking along the chain from the nearest newer materialized frame if
+ * necessary.
+ *
+ * Returns the state, or NULL if it cannot be reconstructed.
+ */
+uint8_t *netplay_delta_frame_materialize(netplay_t *netplay, size_t idx);
+
 /**
  * netplay_delta_frame_free
  *
- * Free a delta frame's dependencies
+ * Free a delta frame's dependencies. state_size must match the size the
+ * state buffer was allocated with.
  */
-void netplay_delta_frame_free(struct delta_frame *delta);
+void netplay_delta_frame_free(struct delta_frame *delta, size_t state_size);
 
 /**
  * netplay_input_state_for
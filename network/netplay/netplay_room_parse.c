@@ -52,6 +52,13 @@ typedef struct tag_Context
 /* TODO/FIXME - static global variable */
 static struct netplay_rooms *netplay_rooms_data;
 
+/* Raw copy of the last lobby payload that was parsed.
+ * Lets callers (and netplay_rooms_parse() itself) detect
+ * that a refresh returned identical data and skip the
+ * re-parse and any downstream rebuilds.
+ * TODO/FIXME - static global variable */
+static char *netplay_rooms_last_buf;
+
 static void parse_context_init(Context* pCtx)
 {
    pCtx->parser = NULL;
@@ -398,10 +405,26 @@ void netplay_rooms_free(void)
    netplay_rooms_data = NULL;
 }
 
+bool netplay_rooms_is_cached(const char *buf)
+{
+   return netplay_rooms_last_buf
+         && string_is_equal(netplay_rooms_last_buf, buf);
+}
+
 int netplay_rooms_parse(const char *buf)
 {
    Context ctx;
 
+   /* An identical payload parses to an identical room list -
+    * as long as the previous list is still around, there is
+    * nothing to do. */
+   if (netplay_rooms_data && netplay_rooms_is_cached(buf))
+      return 0;
+
+   if (netplay_rooms_last_buf)
+      free(netplay_rooms_last_buf);
+   netplay_rooms_last_buf = strdup(buf);
+
    memset(&ctx, 0, sizeof(ctx));
 
    ctx.state = STATE_START;
@@ -26,6 +26,8 @@
 #include "../../autosave.h"
 #include "../../driver.h"
 #include "../../input/input_driver.h"
+#include "../../performance_counters.h"
+#include "../../retroarch.h"
 
 struct vote_count
 {
@@ -334,6 +336,99 @@ static void netplay_merge_analog(netplay_t *netplay,
    }
 }
 
+/* How many frames a client's input may be speculated before the
+ * prediction starts releasing state toward neutral. Analog sticks
+ * spring back on their own and decay early; buttons are stickier
+ * and only get released once the speculation window is so deep
+ * that a rollback correction would be visible anyway. */
+#define NETPLAY_PREDICT_ANALOG_HOLD_FRAMES 12
+#define NETPLAY_PREDICT_BUTTON_HOLD_FRAMES 30
+
+/**
+ * netplay_predict_input
+ * @simstate            : simulated input state to fill
+ * @pstate              : this client's last real input state
+ * @dtype               : libretro device type
+ * @dsize               : input state size in words
+ * @depth               : how many frames this client's input has been
+ *                        speculated past its last real frame
+ * @resim               : are we resimulating, or simulating this frame for the
+ *                        first time?
+ *
+ * Fill in the speculated input for one client-device. The base strategy
+ * is repeat-last; joypad and analog devices get per-part heuristics on
+ * top: held buttons are predicted released past a hold window, and
+ * analog axes decay toward neutral as the speculation deepens.
+ */
+static void netplay_predict_input(netplay_input_state_t simstate,
+      netplay_input_state_t pstate, unsigned dtype, uint32_t dsize,
+      uint32_t depth, bool resim)
+{
+   static const uint32_t keep =
+      (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_UP) |
+      (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_DOWN) |
+      (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_LEFT) |
+      (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_RIGHT);
+
+   if (resim && (dtype == RETRO_DEVICE_JOYPAD || dtype == RETRO_DEVICE_ANALOG))
+   {
+      /* In resimulation mode, we only copy the buttons. The reason for this
+       * is nonobvious:
+       *
+       * If we resimulated nothing, then the /duration/ with which any input
+       * was pressed would be approximately correct, since the original
+       * simulation came in as the input came in, but the /number of times/
+       * the input was pressed would be wrong, as there would be an
+       * advancing wavefront of real data overtaking the simulated data
+       * (which is really just real data offset by some frames).
+       *
+       * That's acceptable for arrows in most situations, since the amount
+       * you move is tied to the duration, but unacceptable for buttons,
+       * which will seem to jerkily be pressed numerous times with those
+       * wavefronts.
+       */
+      simstate->data[0] &= keep;
+      simstate->data[0] |= pstate->data[0] & ~keep;
+   }
+   else
+      memcpy(simstate->data, pstate->data, dsize * sizeof(uint32_t));
+
+   if (dtype != RETRO_DEVICE_JOYPAD && dtype != RETRO_DEVICE_ANALOG)
+      return;
+
+   /* Deep speculation: assume the action buttons have been released by
+    * now. The directions keep repeating - their effect is tied to hold
+    * duration, so repeating them stays close to the truth. */
+   if (depth > NETPLAY_PREDICT_BUTTON_HOLD_FRAMES)
+      simstate->data[0] &= keep;
+
+   if (dtype == RETRO_DEVICE_ANALOG &&
+         depth > NETPLAY_PREDICT_ANALOG_HOLD_FRAMES)
+   {
+      /* Decay the stick axes toward neutral, halving per frame
+       * speculated past the hold window. Each analog word packs two
+       * signed 16-bit axes. */
+      uint32_t word;
+      uint32_t shift = depth - NETPLAY_PREDICT_ANALOG_HOLD_FRAMES;
+
+      if (shift > 15)
+         shift = 15;
+
+      for (word = 1; word < dsize; word++)
+      {
+         int32_t lo = (int16_t)(simstate->data[word] & 0xFFFF);
+         int32_t hi = (int16_t)(simstate->data[word] >> 16);
+
+         /* Divide rather than shift so negative values reach zero */
+         lo /= (int32_t)1 << shift;
+         hi /= (int32_t)1 << shift;
+
+         simstate->data[word] =
+            ((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo;
+      }
+   }
+}
+
 /**
  * netplay_resolve_input
  * @netplay             : pointer to netplay object
@@ -395,34 +490,9 @@ bool netplay_resolve_input(netplay_t *netplay, size_t sim_ptr, bool resim)
             if (!pstate)
                continue;
 
-            if (resim && (dtype == RETRO_DEVICE_JOYPAD || dtype == RETRO_DEVICE_ANALOG))
-            {
-               /* In resimulation mode, we only copy the buttons. The reason for this
-                * is nonobvious:
-                *
-                * If we resimulated nothing, then the /duration/ with which any input
-                * was pressed would be approximately correct, since the original
-                * simulation came in as the input came in, but the /number of times/
-                * the input was pressed would be wrong, as there would be an
-                * advancing wavefront of real data overtaking the simulated data
-                * (which is really just real data offset by some frames).
-                *
-                * That's acceptable for arrows in most situations, since the amount
-                * you move is tied to the duration, but unacceptable for buttons,
-                * which will seem to jerkily be pressed numerous times with those
-                * wavefronts.
-                */
-               const uint32_t keep =
-                  (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_UP) |
-                  (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_DOWN) |
-                  (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_LEFT) |
-                  (UINT32_C(1) << RETRO_DEVICE_ID_JOYPAD_RIGHT);
-               simstate->data[0] &= keep;
-               simstate->data[0] |= pstate->data[0] & ~keep;
-            }
-            else
-               memcpy(simstate->data, pstate->data,
-                     dsize * sizeof(uint32_t));
+            netplay_predict_input(simstate, pstate, dtype, dsize,
+                  simframe->frame + 1 - netplay->read_frame_count[client],
+                  resim);
          }
 
          client_state = simstate;
@@ -514,14 +584,16 @@ static void netplay_handle_frame_hash(netplay_t *netplay,
           delta->frame % abs(netplay->check_frames) == 0)
       {
          delta->crc = netplay_delta_frame_crc(netplay, delta);
-         netplay_cmd_crc(netplay, delta);
+         if (delta->crc)
+            netplay_cmd_crc(netplay, delta);
       }
    }
    else if (delta->crc && netplay->crcs_valid)
    {
-      /* We have a remote CRC, so check it */
+      /* We have a remote CRC, so check it. A zero local CRC means we
+       * couldn't reconstruct the state, so there's nothing to check. */
       uint32_t local_crc = netplay_delta_frame_crc(netplay, delta);
-      if (local_crc != delta->crc)
+      if (local_crc && local_crc != delta->crc)
       {
          /* If the very first check frame is wrong,
           * they probably just don't work */
@@ -557,45 +629,88 @@ bool netplay_sync_pre_frame(netplay_t *netplay)
    if (netplay_delta_frame_ready(netplay,
             &netplay->buffer[netplay->run_ptr], netplay->run_frame_count))
    {
+      struct delta_frame *delta = &netplay->buffer[netplay->run_ptr];
+
       serial_info.data_const = NULL;
-      serial_info.data       = netplay->buffer[netplay->run_ptr].state;
       serial_info.size       = netplay->state_size;
 
-      memset(serial_info.data, 0, serial_info.size);
       if ((netplay->quirks & NETPLAY_QUIRK_INITIALIZATION)
             || netplay->run_frame_count == 0)
       {
          /* Don't serialize until it's safe */
       }
-      else if (!(netplay->quirks & NETPLAY_QUIRK_NO_SAVESTATES)
-            && core_serialize(&serial_info))
+      else if (!(netplay->quirks & NETPLAY_QUIRK_NO_SAVESTATES))
       {
-         if (netplay->force_send_savestate && !netplay->stall
-               && !netplay->remote_paused)
+         bool serialized = false;
+
+         /* While the connection is stable, only every
+          * snapshot_interval-th frame gets serialized; a rollback
+          * to a skipped frame anchors on an older snapshot and
+          * resimulates forward. A pending savestate send always
+          * needs the real thing. */
+         bool skipped    = netplay->snapshot_interval > 1 &&
+               netplay->run_frame_count % netplay->snapshot_interval != 0 &&
+               !netplay->force_send_savestate;
+
+         if (skipped)
+         {
+            /* Whatever state this slot held belongs to an old
+             * frame; drop it so rollback can't anchor here. */
+            netplay_delta_frame_detach(netplay, delta);
+         }
+         else if (netplay_delta_frame_attach(netplay, delta))
+         {
+            serial_info.data = delta->state;
+            memset(serial_info.data, 0, serial_info.size);
+            serialized = core_serialize(&serial_info);
+         }
+
+         if (skipped)
+         {
+            /* Nothing to pack or send this frame */
+         }
+         else if (serialized)
          {
-            /* Bring our running frame and input frames into
-             * parity so we don't send old info. */
-            if (netplay->run_ptr != netplay->self_ptr)
+            struct delta_frame *prev =
+               &netplay->buffer[PREV_PTR(netplay->run_ptr)];
+
+            /* The previous frame's full state is no longer needed; keep
+             * only the packed difference so its buffer goes back to the
+             * pool. It can be materialized again on rollback. */
+            if (prev != delta && prev->used && prev->state
+                  && prev->frame + 1 == delta->frame)
+               netplay_delta_frame_pack(netplay, delta, prev);
+
+            if (netplay->force_send_savestate && !netplay->stall
+                  && !netplay->remote_paused)
             {
-               memcpy(netplay->buffer[netplay->self_ptr].state,
-                  netplay->buffer[netplay->run_ptr].state,
-                  netplay->state_size);
-               netplay->run_ptr         = netplay->self_ptr;
-               netplay->run_frame_count = netplay->self_frame_count;
-            }
+               /* Bring our running frame and input frames into
+                * parity so we don't send old info. */
+               if (netplay->run_ptr != netplay->self_ptr &&
+                   netplay_delta_frame_attach(netplay,
+                      &netplay->buffer[netplay->self_ptr]))
+               {
+                  memcpy(netplay->buffer[netplay->self_ptr].state,
+                     netplay->buffer[netplay->run_ptr].state,
+                     netplay->state_size);
+                  netplay->run_ptr         = netplay->self_ptr;
+                  netplay->run_frame_count = netplay->self_frame_count;
+               }
 
-            /* Send this along to the other side */
-            serial_info.data_const = netplay->buffer[netplay->run_ptr].state;
-            netplay_load_savestate(netplay, &serial_info, false);
-            netplay->force_send_savestate = false;
+               /* Send this along to the other side */
+               serial_info.data_const = netplay->buffer[netplay->run_ptr].state;
+               netplay_load_savestate(netplay, &serial_info, false);
+               netplay->force_send_savestate = false;
+            }
+         }
+         else
+         {
+            /* If the core can't serialize properly (or we couldn't get a
+             * state buffer), we must stall for the remote input on EVERY
+             * frame, because we can't recover */
+            netplay->quirks |= NETPLAY_QUIRK_NO_SAVESTATES;
+            netplay->stateless_mode = true;
          }
-      }
-      else
-      {
-         /* If the core can't serialize properly, we must stall for the
-          * remote input on EVERY frame, because we can't recover */
-         netplay->quirks |= NETPLAY_QUIRK_NO_SAVESTATES;
-         netplay->stateless_mode = true;
       }
 
       /* If we can't transmit savestates, we must stall
@@ -814,6 +929,7 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
          netplay_handle_frame_hash(netplay, ptr);
          netplay->other_ptr = NEXT_PTR(netplay->other_ptr);
          netplay->other_frame_count++;
+         netplay->predict_window_hit++;
       }
       netplay->replay_ptr = netplay->other_ptr;
       netplay->replay_frame_count = netplay->other_frame_count;
@@ -836,6 +952,9 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
        netplay->replay_frame_count < netplay->run_frame_count)
    {
       retro_ctx_serialize_info_t serial_info;
+      retro_time_t replay_start;
+      uint32_t replay_depth;
+      bool replay_suspended = false;
 
       /* Replay frames. */
       netplay->is_replay = true;
@@ -863,28 +982,66 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
          netplay_wait_and_init_serialization(netplay);
 
       serial_info.data       = NULL;
-      serial_info.data_const = netplay->buffer[netplay->replay_ptr].state;
+      /* The rollback anchor is usually several frames back and only held
+       * in packed form by now; materialize it. With adaptive
+       * snapshotting the exact frame may have been skipped, in which
+       * case we anchor on the nearest older snapshot and resimulate
+       * the difference. */
+      while (!(serial_info.data_const = netplay_delta_frame_materialize(
+                  netplay, netplay->replay_ptr)))
+      {
+         struct delta_frame *pframe =
+            &netplay->buffer[PREV_PTR(netplay->replay_ptr)];
+
+         if (!netplay->replay_frame_count || !pframe->used ||
+               pframe->frame + 1 != netplay->replay_frame_count)
+            break;
+         netplay->replay_ptr = PREV_PTR(netplay->replay_ptr);
+         netplay->replay_frame_count--;
+      }
       serial_info.size       = netplay->state_size;
 
-      if (!core_unserialize(&serial_info))
+      if (!serial_info.data_const || !core_unserialize(&serial_info))
       {
          RARCH_ERR("Netplay savestate loading failed: Prepare for desync!\n");
       }
 
+      replay_start = cpu_features_get_time_usec();
+      replay_depth = netplay->run_frame_count - netplay->replay_frame_count;
+
+      /* Every replayed frame is one the prediction got wrong */
+      netplay->predict_window_miss += replay_depth;
+
+      /* Jitter: go back to snapshotting every frame so the next
+       * rollback is cheap */
+      netplay->snapshot_interval     = 1;
+      netplay->snapshot_clean_frames = 0;
+
       while (netplay->replay_frame_count < netplay->run_frame_count)
       {
          retro_time_t start, tm;
          struct delta_frame *ptr = &netplay->buffer[netplay->replay_ptr];
 
-         serial_info.data        = ptr->state;
          serial_info.size        = netplay->state_size;
          serial_info.data_const  = NULL;
 
          start                   = cpu_features_get_time_usec();
 
          /* Remember the current state */
-         memset(serial_info.data, 0, serial_info.size);
-         core_serialize(&serial_info);
+         if (netplay_delta_frame_attach(netplay, ptr))
+         {
+            struct delta_frame *prev =
+               &netplay->buffer[PREV_PTR(netplay->replay_ptr)];
+
+            serial_info.data = ptr->state;
+            memset(serial_info.data, 0, serial_info.size);
+            core_serialize(&serial_info);
+
+            /* Repack against the previous replayed frame */
+            if (prev != ptr && prev->used && prev->state
+                  && prev->frame + 1 == ptr->frame)
+               netplay_delta_frame_pack(netplay, ptr, prev);
+         }
          if (netplay->replay_frame_count < netplay->unread_frame_count)
             netplay_handle_frame_hash(netplay, ptr);
 
@@ -910,9 +1067,12 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
             else
                RARCH_LOG("INP  %X %X\n", ptr->self_state[0], ptr->real_input_state[0]);
             ptr = &netplay->buffer[netplay->replay_ptr];
-            serial_info.data = ptr->state;
-            memset(serial_info.data, 0, serial_info.size);
-            core_serialize(&serial_info);
+            if (netplay_delta_frame_attach(netplay, ptr))
+            {
+               serial_info.data = ptr->state;
+               memset(serial_info.data, 0, serial_info.size);
+               core_serialize(&serial_info);
+            }
             RARCH_LOG("POST %u: %X\n", netplay->replay_frame_count-1, netplay_delta_frame_crc(netplay, ptr));
          }
 #endif
@@ -925,23 +1085,87 @@ void netplay_sync_post_frame(netplay_t *netplay, bool stalled)
          netplay->frame_run_time_ptr++;
          if (netplay->frame_run_time_ptr >= NETPLAY_FRAME_RUN_TIME_WINDOW)
             netplay->frame_run_time_ptr = 0;
+
+         /* If this is a regular catch-up, don't let it eat the whole
+          * iteration; the remaining frames are verified over the next
+          * iterations instead of stalling the local player now */
+         if (!netplay->force_rewind &&
+             netplay->replay_frame_count < netplay->run_frame_count &&
+             cpu_features_get_time_usec() - replay_start >
+                   NETPLAY_MAX_ROLLBACK_USEC)
+         {
+            replay_suspended = true;
+            break;
+         }
+      }
+
+      if (replay_suspended)
+      {
+         /* Jump the core back to the present; everything up to
+          * replay_frame_count has been verified, so the next call picks
+          * up from there */
+         serial_info.data       = NULL;
+         serial_info.data_const = netplay_delta_frame_materialize(netplay,
+               netplay->run_ptr);
+         serial_info.size       = netplay->state_size;
+
+         if (!serial_info.data_const || !core_unserialize(&serial_info))
+         {
+            RARCH_ERR("Netplay rollback state restore failed: Prepare for desync!\n");
+         }
       }
 
       /* Average our time */
       netplay->frame_run_time_avg   = netplay->frame_run_time_sum / NETPLAY_FRAME_RUN_TIME_WINDOW;
 
-      if (netplay->unread_frame_count < netplay->run_frame_count)
+      /* We've only verified up to replay_frame_count, which is the run
+       * frame unless the rollback was suspended */
+      if (netplay->unread_frame_count < netplay->replay_frame_count)
       {
          netplay->other_ptr         = netplay->unread_ptr;
          netplay->other_frame_count = netplay->unread_frame_count;
       }
       else
       {
-         netplay->other_ptr         = netplay->run_ptr;
-         netplay->other_frame_count = netplay->run_frame_count;
+         netplay->other_ptr         = netplay->replay_ptr;
+         netplay->other_frame_count = netplay->replay_frame_count;
       }
       netplay->is_replay            = false;
       netplay->force_rewind         = false;
+
+      /* Instrumentation: how deep rollbacks go and how often they have
+       * to be spread over several iterations */
+      if (rarch_ctl(RARCH_CTL_IS_PERFCNT_ENABLE, NULL))
+      {
+         static struct retro_perf_counter perf_rollback_frames;
+         static struct retro_perf_counter perf_rollback_deferred;
+
+         performance_counter_init(perf_rollback_frames,
+               "netplay_rollback_frames");
+         perf_rollback_frames.call_cnt++;
+         perf_rollback_frames.total += replay_depth;
+
+         if (replay_suspended)
+         {
+            performance_counter_init(perf_rollback_deferred,
+                  "netplay_rollback_deferred");
+            perf_rollback_deferred.call_cnt++;
+            perf_rollback_deferred.total +=
+               netplay->run_frame_count - netplay->replay_frame_count;
+         }
+      }
+   }
+   else if (!netplay->stateless_mode &&
+         !(netplay->quirks & NETPLAY_QUIRK_NO_SAVESTATES))
+   {
+      /* Clean frame: let the snapshot cadence relax */
+      if (++netplay->snapshot_clean_frames >=
+            NETPLAY_SNAPSHOT_RELAX_FRAMES)
+      {
+         if (netplay->snapshot_interval < NETPLAY_MAX_SNAPSHOT_INTERVAL)
+            netplay->snapshot_interval <<= 1;
+         netplay->snapshot_clean_frames = 0;
+      }
    }
 
    if (netplay->is_server)
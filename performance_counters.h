@@ -85,6 +85,35 @@ void rarch_perf_register(struct retro_perf_counter *perf);
  **/
 #define performance_counter_stop_plus(is_perfcnt_enable, perf) performance_counter_stop_internal(is_perfcnt_enable, perf)
 
+/* Trace event layer. When HAVE_TRACE is defined, begin/end pairs,
+ * thread-name markers and counter samples are recorded into a process-wide ring
+ * together with a timestamp and the calling thread's id, and are
+ * included in the Chrome trace JSON written by the FRAME_TRACE
+ * command. When it is not defined, the macros compile to nothing.
+ *
+ * @name must outlive the event or be copied by the recorder -
+ * string literals and task titles at call time are both fine.
+ * Implemented in retroarch.c. */
+#if defined(HAVE_TRACE)
+void rarch_trace_begin(const char *name);
+
+void rarch_trace_end(void);
+
+void rarch_trace_name_thread(const char *name);
+
+void rarch_trace_counter(const char *name, int32_t value);
+
+#define RARCH_TRACE_BEGIN(name)          rarch_trace_begin(name)
+#define RARCH_TRACE_END()                rarch_trace_end()
+#define RARCH_TRACE_NAME_THREAD(name)    rarch_trace_name_thread(name)
+#define RARCH_TRACE_COUNTER(name, value) rarch_trace_counter(name, value)
+#else
+#define RARCH_TRACE_BEGIN(name)          ((void)0)
+#define RARCH_TRACE_END()                ((void)0)
+#define RARCH_TRACE_NAME_THREAD(name)    ((void)0)
+#define RARCH_TRACE_COUNTER(name, value) ((void)0)
+#endif
+
 RETRO_END_DECLS
 
 #endif
@@ -27,6 +27,7 @@
 #include <compat/posix_string.h>
 #include <string/stdstring.h>
 #include <streams/interface_stream.h>
+#include <streams/file_stream.h>
 #include <file/file_path.h>
 #include <lists/string_list.h>
 #include <formats/jsonsax_full.h>
@@ -56,6 +57,28 @@
 #define USING_POSIX_FILE_SYSTEM
 #endif
 
+/* Path membership index
+ * > playlist_entry_exists() is called once per candidate
+ *   file during content scans, and each call walked the
+ *   whole playlist, resolving every entry path as it
+ *   went - quadratic over a large library
+ * > Index the resolved entry paths once: a bloom filter
+ *   answers 'definitely not present' and a hash set
+ *   answers 'definitely present', so only ambiguous
+ *   lookups (bloom collisions, fuzzy archive matches)
+ *   fall back to the linear walk
+ * > Built lazily on the first membership test; pushes
+ *   update it in place, anything that removes or
+ *   rewrites entry paths just throws it away */
+typedef struct playlist_path_index
+{
+   char **keys;     /* open-addressed set of resolved paths */
+   uint32_t *bloom;
+   size_t table_size;  /* power of two */
+   size_t bloom_words; /* power of two */
+   size_t count;
+} playlist_path_index_t;
+
 struct content_playlist
 {
    char *default_core_path;
@@ -63,6 +86,7 @@ struct content_playlist
    char *base_content_directory;
 
    struct playlist_entry *entries;
+   playlist_path_index_t *path_index;
 
    playlist_config_t config;  /* size_t alignment */
 
@@ -71,10 +95,18 @@ struct content_playlist
    enum playlist_thumbnail_mode left_thumbnail_mode;
    enum playlist_sort_mode sort_mode;
 
+   /* journal_dirty: paths of entries whose metadata
+    * changed in ways that can be persisted by
+    * appending a journal record instead of
+    * rewriting the whole playlist */
+   struct string_list *journal_dirty;
+   unsigned journal_changes;
+
    bool modified;
    bool old_format;
    bool compressed;
    bool cached_external;
+   bool journal_compact_pending;
 };
 
 typedef struct
@@ -107,6 +139,18 @@ typedef struct
 /* TODO/FIXME - global state - perhaps move outside this file */
 static playlist_t *playlist_cached = NULL;
 
+#define PLAYLIST_JOURNAL_MAGIC   0x4A4C5052 /* 'RPLJ' */
+#define PLAYLIST_JOURNAL_VERSION 1
+#define PLAYLIST_JOURNAL_COMPACT_THRESHOLD 128
+
+/* Forward declarations */
+static void playlist_cache_write(playlist_t *playlist);
+static bool playlist_cache_read(playlist_t *playlist);
+static void playlist_journal_mark(playlist_t *playlist, const char *path);
+static bool playlist_journal_flush(playlist_t *playlist);
+static void playlist_journal_apply(playlist_t *playlist);
+static void playlist_journal_delete(playlist_t *playlist);
+
 typedef int (playlist_sort_fun_t)(
       const struct playlist_entry *a,
       const struct playlist_entry *b);
@@ -360,6 +404,250 @@ static bool playlist_core_path_equal(const char *real_core_path, const char *ent
    return false;
 }
 
+/* Mirrors the behaviour of playlist_path_equal():
+ * fuzzy archive matching is unconditional in
+ * non-RetroArch builds */
+static bool playlist_path_index_fuzzy(const playlist_config_t *config)
+{
+#ifdef RARCH_INTERNAL
+   return config->fuzzy_archive_match;
+#else
+   return true;
+#endif
+}
+
+/* Two independent hashes over the first len bytes of
+ * path; case-folded so that hashes agree wherever
+ * string_is_equal_noncase() would */
+static void playlist_path_index_hash(const char *path, size_t len,
+      uint32_t *hash_a, uint32_t *hash_b)
+{
+   uint32_t a = 5381;
+   uint32_t b = 0;
+   size_t i;
+
+   for (i = 0; i < len; i++)
+   {
+      uint32_t c = (uint32_t)(unsigned char)path[i];
+#ifdef _WIN32
+      if (c >= 'A' && c <= 'Z')
+         c += 'a' - 'A';
+#endif
+      a = ((a << 5) + a) ^ c;
+      b = c + (b << 6) + (b << 16) - b;
+   }
+
+   *hash_a = a;
+   *hash_b = b;
+}
+
+static void playlist_path_index_bloom_set(playlist_path_index_t *idx,
+      uint32_t hash_a, uint32_t hash_b)
+{
+   size_t mask = (idx->bloom_words << 5) - 1;
+   idx->bloom[(hash_a & mask) >> 5] |= (uint32_t)1 << (hash_a & 31);
+   idx->bloom[(hash_b & mask) >> 5] |= (uint32_t)1 << (hash_b & 31);
+}
+
+static bool playlist_path_index_bloom_test(playlist_path_index_t *idx,
+      uint32_t hash_a, uint32_t hash_b)
+{
+   size_t mask = (idx->bloom_words << 5) - 1;
+   return (idx->bloom[(hash_a & mask) >> 5] & ((uint32_t)1 << (hash_a & 31))) &&
+          (idx->bloom[(hash_b & mask) >> 5] & ((uint32_t)1 << (hash_b & 31)));
+}
+
+static bool playlist_path_index_set_contains(playlist_path_index_t *idx,
+      const char *real_path, uint32_t hash_a)
+{
+   size_t mask = idx->table_size - 1;
+   size_t pos  = hash_a & mask;
+
+   while (idx->keys[pos])
+   {
+#ifdef _WIN32
+      if (string_is_equal_noncase(idx->keys[pos], real_path))
+#else
+      if (string_is_equal(idx->keys[pos], real_path))
+#endif
+         return true;
+      pos = (pos + 1) & mask;
+   }
+
+   return false;
+}
+
+static void playlist_path_index_invalidate(playlist_t *playlist)
+{
+   playlist_path_index_t *idx = playlist->path_index;
+   size_t i;
+
+   if (!idx)
+      return;
+
+   if (idx->keys)
+   {
+      for (i = 0; i < idx->table_size; i++)
+         free(idx->keys[i]);
+      free(idx->keys);
+   }
+   free(idx->bloom);
+   free(idx);
+
+   playlist->path_index = NULL;
+}
+
+/* Adds one entry path to the index. An index that can
+ * no longer represent its playlist (table full, failed
+ * allocation, unresolvable path) is discarded; the next
+ * membership test rebuilds it */
+static void playlist_path_index_add(playlist_t *playlist,
+      const char *entry_path)
+{
+   char real_path[PATH_MAX_LENGTH];
+   uint32_t hash_a, hash_b;
+   playlist_path_index_t *idx = playlist->path_index;
+
+   if (!idx)
+      return;
+
+   /* Entries with empty paths can never satisfy
+    * playlist_path_equal() - nothing to record */
+   if (string_is_empty(entry_path))
+      return;
+
+   if ((idx->count + 1) * 2 > idx->table_size)
+   {
+      playlist_path_index_invalidate(playlist);
+      return;
+   }
+
+   real_path[0] = '\0';
+   strlcpy(real_path, entry_path, sizeof(real_path));
+   path_resolve_realpath(real_path, sizeof(real_path), true);
+
+   if (string_is_empty(real_path))
+      return;
+
+   playlist_path_index_hash(real_path, strlen(real_path),
+         &hash_a, &hash_b);
+
+   if (!playlist_path_index_set_contains(idx, real_path, hash_a))
+   {
+      char *key   = strdup(real_path);
+      size_t mask = idx->table_size - 1;
+      size_t pos  = hash_a & mask;
+
+      if (!key)
+      {
+         playlist_path_index_invalidate(playlist);
+         return;
+      }
+
+      while (idx->keys[pos])
+         pos = (pos + 1) & mask;
+
+      idx->keys[pos] = key;
+      idx->count++;
+   }
+
+   playlist_path_index_bloom_set(idx, hash_a, hash_b);
+
+   /* Record the archive prefix in the bloom filter so
+    * fuzzy matches against '[archive]#[file]' entries
+    * are never reported as definitely absent */
+   if (playlist_path_index_fuzzy(&playlist->config))
+   {
+      const char *delim = path_get_archive_delim(real_path);
+      if (delim)
+      {
+         playlist_path_index_hash(real_path,
+               (size_t)(delim - real_path), &hash_a, &hash_b);
+         playlist_path_index_bloom_set(idx, hash_a, hash_b);
+      }
+   }
+}
+
+static void playlist_path_index_build(playlist_t *playlist)
+{
+   size_t i, len;
+   size_t table_size = 8;
+   size_t bloom_words;
+   playlist_path_index_t *idx;
+
+   len = RBUF_LEN(playlist->entries);
+
+   /* Leave headroom so a scan can keep pushing new
+    * entries without immediately outgrowing the table */
+   while (table_size < (len + 64) * 2)
+      table_size <<= 1;
+
+   /* ~16 filter bits per entry */
+   bloom_words = table_size >> 1;
+
+   if (!(idx = (playlist_path_index_t*)calloc(1, sizeof(*idx))))
+      return;
+
+   idx->table_size  = table_size;
+   idx->bloom_words = bloom_words;
+   idx->keys        = (char**)calloc(table_size, sizeof(char*));
+   idx->bloom       = (uint32_t*)calloc(bloom_words, sizeof(uint32_t));
+
+   if (!idx->keys || !idx->bloom)
+   {
+      free(idx->keys);
+      free(idx->bloom);
+      free(idx);
+      return;
+   }
+
+   playlist->path_index = idx;
+
+   for (i = 0; i < len; i++)
+   {
+      playlist_path_index_add(playlist, playlist->entries[i].path);
+      if (!playlist->path_index)
+         return;
+   }
+}
+
+enum playlist_path_index_result
+{
+   PLAYLIST_PATH_INDEX_MISS = 0, /* definitely not present */
+   PLAYLIST_PATH_INDEX_HIT,      /* definitely present */
+   PLAYLIST_PATH_INDEX_UNKNOWN   /* caller must walk the playlist */
+};
+
+static enum playlist_path_index_result playlist_path_index_query(
+      playlist_t *playlist, const char *real_search_path)
+{
+   uint32_t hash_a, hash_b;
+   playlist_path_index_t *idx = playlist->path_index;
+
+   playlist_path_index_hash(real_search_path,
+         strlen(real_search_path), &hash_a, &hash_b);
+
+   if (playlist_path_index_set_contains(idx, real_search_path, hash_a))
+      return PLAYLIST_PATH_INDEX_HIT;
+
+   if (playlist_path_index_bloom_test(idx, hash_a, hash_b))
+      return PLAYLIST_PATH_INDEX_UNKNOWN;
+
+   if (playlist_path_index_fuzzy(&playlist->config))
+   {
+      const char *delim = path_get_archive_delim(real_search_path);
+      if (delim)
+      {
+         playlist_path_index_hash(real_search_path,
+               (size_t)(delim - real_search_path), &hash_a, &hash_b);
+         if (playlist_path_index_bloom_test(idx, hash_a, hash_b))
+            return PLAYLIST_PATH_INDEX_UNKNOWN;
+      }
+   }
+
+   return PLAYLIST_PATH_INDEX_MISS;
+}
+
 uint32_t playlist_get_size(playlist_t *playlist)
 {
    if (!playlist)
@@ -482,6 +770,8 @@ void playlist_delete_index(playlist_t *playlist,
 
    RBUF_RESIZE(playlist->entries, len - 1);
 
+   playlist_path_index_invalidate(playlist);
+
    playlist->modified = true;
 }
 
@@ -568,6 +858,23 @@ bool playlist_entry_exists(playlist_t *playlist,
    strlcpy(real_search_path, path, sizeof(real_search_path));
    path_resolve_realpath(real_search_path, sizeof(real_search_path), true);
 
+   if (!playlist->path_index)
+      playlist_path_index_build(playlist);
+
+   if (playlist->path_index)
+   {
+      switch (playlist_path_index_query(playlist, real_search_path))
+      {
+         case PLAYLIST_PATH_INDEX_HIT:
+            return true;
+         case PLAYLIST_PATH_INDEX_MISS:
+            return false;
+         default:
+            /* Ambiguous - walk the playlist */
+            break;
+      }
+   }
+
    for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
    {
       if (playlist_path_equal(real_search_path, playlist->entries[i].path,
@@ -593,6 +900,7 @@ void playlist_update(playlist_t *playlist, size_t idx,
       if (entry->path)
          free(entry->path);
       entry->path        = strdup(update_entry->path);
+      playlist_path_index_invalidate(playlist);
       playlist->modified = true;
    }
 
@@ -655,6 +963,7 @@ void playlist_update_runtime(playlist_t *playlist, size_t idx,
          free(entry->path);
       entry->path        = NULL;
       entry->path        = strdup(update_entry->path);
+      playlist_path_index_invalidate(playlist);
       playlist->modified = playlist->modified || register_update;
    }
 
@@ -813,7 +1122,10 @@ bool playlist_push_runtime(playlist_t *playlist,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
 
-      goto success;
+      /* Metadata-only change - journal it rather
+       * than forcing a full rewrite */
+      playlist_journal_mark(playlist, playlist->entries[0].path);
+      return true;
    }
 
    if (playlist->config.capacity == 0)
@@ -866,7 +1178,8 @@ bool playlist_push_runtime(playlist_t *playlist,
          playlist->entries[0].last_played_str = strdup(entry->last_played_str);
    }
 
-success:
+   playlist_path_index_invalidate(playlist);
+
    playlist->modified = true;
 
    return true;
@@ -1090,7 +1403,10 @@ bool playlist_push(playlist_t *playlist,
       if (i == 0)
       {
          if (entry_updated)
-            goto success;
+         {
+            playlist_journal_mark(playlist, playlist->entries[0].path);
+            return true;
+         }
 
          return false;
       }
@@ -1101,7 +1417,10 @@ bool playlist_push(playlist_t *playlist,
             i * sizeof(struct playlist_entry));
       playlist->entries[0] = tmp;
 
-      goto success;
+      /* Metadata-only change - journal it rather
+       * than forcing a full rewrite */
+      playlist_journal_mark(playlist, playlist->entries[0].path);
+      return true;
    }
 
    if (playlist->config.capacity == 0)
@@ -1111,6 +1430,7 @@ bool playlist_push(playlist_t *playlist,
    {
       struct playlist_entry *last_entry = &playlist->entries[len - 1];
       playlist_free_entry(last_entry);
+      playlist_path_index_invalidate(playlist);
       len--;
    }
    else
@@ -1173,9 +1493,10 @@ bool playlist_push(playlist_t *playlist,
          for (i = 0; i < entry->subsystem_roms->size; i++)
             string_list_append(playlist->entries[0].subsystem_roms, entry->subsystem_roms->elems[i].data, attributes);
       }
+
+      playlist_path_index_add(playlist, playlist->entries[0].path);
    }
 
-success:
    playlist->modified = true;
 
    return true;
@@ -1460,21 +1781,43 @@ void playlist_write_file(playlist_t *playlist)
    size_t i, len;
    intfstream_t *file = NULL;
    bool compressed    = false;
+   bool written       = false;
+   bool format_change = false;
+
+   if (!playlist)
+      return;
+
+   format_change = (
+#if defined(HAVE_ZLIB)
+         (playlist->compressed != playlist->config.compress) ||
+#endif
+         (playlist->old_format != playlist->config.old_format));
 
-   /* Playlist will be written if any of the
+   /* Playlist will be fully rewritten if any of the
     * following are true:
     * > 'modified' flag is set
     * > Current playlist format (old/new) does not
     *   match requested
     * > Current playlist compression status does
-    *   not match requested */
-   if (!playlist ||
-       !(playlist->modified ||
-#if defined(HAVE_ZLIB)
-        (playlist->compressed != playlist->config.compress) ||
-#endif
-        (playlist->old_format != playlist->config.old_format)))
-      return;
+    *   not match requested
+    * > The change journal is due for compaction
+    * Metadata-only changes (play counts, last
+    * played times, bumped history entries) are
+    * instead appended to the journal sidecar */
+   if (!playlist->modified && !format_change)
+   {
+      if (playlist->journal_dirty &&
+          !playlist->journal_compact_pending &&
+          ((playlist->journal_changes + playlist->journal_dirty->size)
+               < PLAYLIST_JOURNAL_COMPACT_THRESHOLD) &&
+          playlist_journal_flush(playlist))
+         return;
+
+      /* No pending changes of any kind */
+      if (!playlist->journal_dirty &&
+          !playlist->journal_compact_pending)
+         return;
+   }
 
 #if defined(HAVE_ZLIB)
    if (playlist->config.compress)
@@ -1872,11 +2215,28 @@ void playlist_write_file(playlist_t *playlist)
 
    playlist->modified   = false;
    playlist->compressed = compressed;
+   written              = true;
 
    RARCH_LOG("[Playlist]: Written to playlist file: %s\n", playlist->config.path);
 end:
    intfstream_close(file);
    free(file);
+
+   /* Refresh the sidecar cache against the newly
+    * written file (must happen after close, so the
+    * recorded mtime/size are final), and discard
+    * the journal - its contents are now folded
+    * into the main file */
+   if (written)
+   {
+      if (playlist->journal_dirty)
+      {
+         string_list_free(playlist->journal_dirty);
+         playlist->journal_dirty = NULL;
+      }
+      playlist_journal_delete(playlist);
+      playlist_cache_write(playlist);
+   }
 }
 
 /**
@@ -1904,6 +2264,12 @@ void playlist_free(playlist_t *playlist)
       free(playlist->base_content_directory);
    playlist->base_content_directory = NULL;
 
+   if (playlist->journal_dirty)
+      string_list_free(playlist->journal_dirty);
+   playlist->journal_dirty = NULL;
+
+   playlist_path_index_invalidate(playlist);
+
    if (playlist->entries)
    {
       for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
@@ -1940,6 +2306,8 @@ void playlist_clear(playlist_t *playlist)
          playlist_free_entry(entry);
    }
    RBUF_CLEAR(playlist->entries);
+
+   playlist_path_index_invalidate(playlist);
 }
 
 /**
@@ -2329,12 +2697,703 @@ static void get_old_format_metadata_value(
    strlcpy(value, start, len);
 }
 
+/* Binary sidecar cache
+ * > Parsing 20k-entry JSON playlists through jsonsax
+ *   on every menu open is expensive on weak CPUs, so
+ *   successfully parsed playlists are flattened into
+ *   a '<playlist>.cache' sidecar of length-prefixed
+ *   records that can be loaded with plain reads
+ * > The sidecar stores the mtime/size of the source
+ *   playlist and is ignored (and later regenerated)
+ *   whenever they no longer match, or on any parse
+ *   error, so it can always be safely deleted
+ * > Values are host-endian: a cache written by a
+ *   different architecture fails the magic check
+ *   and is simply regenerated */
+
+#define PLAYLIST_CACHE_MAGIC   0x434C5052 /* 'RPLC' */
+#define PLAYLIST_CACHE_VERSION 1
+
+static void playlist_get_cache_path(const playlist_t *playlist,
+      char *s, size_t len)
+{
+   strlcpy(s, playlist->config.path, len);
+   strlcat(s, ".cache", len);
+}
+
+static bool playlist_get_source_stat(const char *path,
+      int64_t *mtime, int64_t *size)
+{
+   /* Through the path wrappers rather than raw stat(),
+    * which mishandles UTF-8 paths on Windows */
+   int32_t src_size  = path_get_size(path);
+   int64_t src_mtime = path_get_mtime(path);
+
+   if ((src_size < 0) || (src_mtime < 0))
+      return false;
+
+   *mtime = src_mtime;
+   *size  = (int64_t)src_size;
+   return true;
+}
+
+static void playlist_cache_write_u32(intfstream_t *file, uint32_t val)
+{
+   intfstream_write(file, &val, sizeof(val));
+}
+
+static void playlist_cache_write_i64(intfstream_t *file, int64_t val)
+{
+   intfstream_write(file, &val, sizeof(val));
+}
+
+static void playlist_cache_write_string(intfstream_t *file, const char *s)
+{
+   uint32_t len = s ? (uint32_t)strlen(s) + 1 : 0;
+   playlist_cache_write_u32(file, len);
+   if (len)
+      intfstream_write(file, s, len);
+}
+
+/* Bounds-checked reader over the in-memory cache blob */
+typedef struct
+{
+   const uint8_t *data;
+   size_t size;
+   size_t ptr;
+   bool error;
+} playlist_cache_reader_t;
+
+static uint32_t playlist_cache_read_u32(playlist_cache_reader_t *r)
+{
+   uint32_t val;
+   if (r->error || (r->size - r->ptr < sizeof(val)))
+   {
+      r->error = true;
+      return 0;
+   }
+   memcpy(&val, r->data + r->ptr, sizeof(val));
+   r->ptr += sizeof(val);
+   return val;
+}
+
+static int64_t playlist_cache_read_i64(playlist_cache_reader_t *r)
+{
+   int64_t val;
+   if (r->error || (r->size - r->ptr < sizeof(val)))
+   {
+      r->error = true;
+      return 0;
+   }
+   memcpy(&val, r->data + r->ptr, sizeof(val));
+   r->ptr += sizeof(val);
+   return val;
+}
+
+static char *playlist_cache_read_string(playlist_cache_reader_t *r)
+{
+   char *s;
+   uint32_t len = playlist_cache_read_u32(r);
+
+   if (r->error || (len == 0))
+      return NULL;
+
+   if ((r->size - r->ptr < len) ||
+       (r->data[r->ptr + len - 1] != '\0'))
+   {
+      r->error = true;
+      return NULL;
+   }
+
+   s = (char*)malloc(len);
+   if (!s)
+   {
+      r->error = true;
+      return NULL;
+   }
+
+   memcpy(s, r->data + r->ptr, len);
+   r->ptr += len;
+   return s;
+}
+
+/* Flattens the current in-memory playlist into the
+ * sidecar cache file. Best-effort: failures merely
+ * mean the next load falls back to the JSON parser. */
+static void playlist_cache_write(playlist_t *playlist)
+{
+   size_t i, len;
+   char cache_path[PATH_MAX_LENGTH];
+   int64_t src_mtime = 0;
+   int64_t src_size  = 0;
+   intfstream_t *file = NULL;
+
+   if (string_is_empty(playlist->config.path))
+      return;
+
+   if (!playlist_get_source_stat(playlist->config.path,
+         &src_mtime, &src_size))
+      return;
+
+   playlist_get_cache_path(playlist, cache_path, sizeof(cache_path));
+
+   file = intfstream_open_file(cache_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return;
+
+   playlist_cache_write_u32(file, PLAYLIST_CACHE_MAGIC);
+   playlist_cache_write_u32(file, PLAYLIST_CACHE_VERSION);
+   playlist_cache_write_i64(file, src_mtime);
+   playlist_cache_write_i64(file, src_size);
+   playlist_cache_write_u32(file, playlist->old_format ? 1 : 0);
+   playlist_cache_write_u32(file, playlist->compressed ? 1 : 0);
+   playlist_cache_write_u32(file, (uint32_t)playlist->label_display_mode);
+   playlist_cache_write_u32(file, (uint32_t)playlist->right_thumbnail_mode);
+   playlist_cache_write_u32(file, (uint32_t)playlist->left_thumbnail_mode);
+   playlist_cache_write_u32(file, (uint32_t)playlist->sort_mode);
+   playlist_cache_write_string(file, playlist->default_core_path);
+   playlist_cache_write_string(file, playlist->default_core_name);
+   playlist_cache_write_string(file, playlist->base_content_directory);
+
+   len = RBUF_LEN(playlist->entries);
+   playlist_cache_write_u32(file, (uint32_t)len);
+
+   for (i = 0; i < len; i++)
+   {
+      size_t j;
+      const struct playlist_entry *entry = &playlist->entries[i];
+      uint32_t num_roms                  = entry->subsystem_roms ?
+            (uint32_t)entry->subsystem_roms->size : 0;
+
+      playlist_cache_write_string(file, entry->path);
+      playlist_cache_write_string(file, entry->label);
+      playlist_cache_write_string(file, entry->core_path);
+      playlist_cache_write_string(file, entry->core_name);
+      playlist_cache_write_string(file, entry->db_name);
+      playlist_cache_write_string(file, entry->crc32);
+      playlist_cache_write_string(file, entry->subsystem_ident);
+      playlist_cache_write_string(file, entry->subsystem_name);
+      playlist_cache_write_string(file, entry->runtime_str);
+      playlist_cache_write_string(file, entry->last_played_str);
+
+      playlist_cache_write_u32(file, (uint32_t)entry->runtime_status);
+      playlist_cache_write_u32(file, entry->runtime_hours);
+      playlist_cache_write_u32(file, entry->runtime_minutes);
+      playlist_cache_write_u32(file, entry->runtime_seconds);
+      playlist_cache_write_u32(file, entry->last_played_year);
+      playlist_cache_write_u32(file, entry->last_played_month);
+      playlist_cache_write_u32(file, entry->last_played_day);
+      playlist_cache_write_u32(file, entry->last_played_hour);
+      playlist_cache_write_u32(file, entry->last_played_minute);
+      playlist_cache_write_u32(file, entry->last_played_second);
+
+      playlist_cache_write_u32(file, num_roms);
+      for (j = 0; j < num_roms; j++)
+         playlist_cache_write_string(file,
+               entry->subsystem_roms->elems[j].data);
+   }
+
+   intfstream_close(file);
+   free(file);
+}
+
+/* Attempts to populate the playlist from the sidecar
+ * cache. Returns false (leaving the playlist empty)
+ * whenever the cache is missing, stale or malformed. */
+static bool playlist_cache_read(playlist_t *playlist)
+{
+   size_t i;
+   char cache_path[PATH_MAX_LENGTH];
+   playlist_cache_reader_t r;
+   uint32_t entry_count;
+   int64_t cache_mtime, cache_size;
+   int64_t src_mtime = 0;
+   int64_t src_size  = 0;
+   int64_t blob_len  = 0;
+   void *blob        = NULL;
+   bool ok           = false;
+
+   if (string_is_empty(playlist->config.path))
+      return false;
+
+   /* Source playlist must exist - otherwise any
+    * sidecar is an orphan */
+   if (!playlist_get_source_stat(playlist->config.path,
+         &src_mtime, &src_size))
+      return false;
+
+   playlist_get_cache_path(playlist, cache_path, sizeof(cache_path));
+
+   if (!path_is_valid(cache_path))
+      return false;
+
+   if (!filestream_read_file(cache_path, &blob, &blob_len) ||
+       !blob || (blob_len <= 0))
+   {
+      if (blob)
+         free(blob);
+      return false;
+   }
+
+   r.data  = (const uint8_t*)blob;
+   r.size  = (size_t)blob_len;
+   r.ptr   = 0;
+   r.error = false;
+
+   if ((playlist_cache_read_u32(&r) != PLAYLIST_CACHE_MAGIC) ||
+       (playlist_cache_read_u32(&r) != PLAYLIST_CACHE_VERSION))
+      goto done;
+
+   cache_mtime = playlist_cache_read_i64(&r);
+   cache_size  = playlist_cache_read_i64(&r);
+
+   /* Staleness check */
+   if (r.error || (cache_mtime != src_mtime) || (cache_size != src_size))
+      goto done;
+
+   playlist->old_format           = playlist_cache_read_u32(&r) != 0;
+   playlist->compressed           = playlist_cache_read_u32(&r) != 0;
+   playlist->label_display_mode   = (enum playlist_label_display_mode)
+         playlist_cache_read_u32(&r);
+   playlist->right_thumbnail_mode = (enum playlist_thumbnail_mode)
+         playlist_cache_read_u32(&r);
+   playlist->left_thumbnail_mode  = (enum playlist_thumbnail_mode)
+         playlist_cache_read_u32(&r);
+   playlist->sort_mode            = (enum playlist_sort_mode)
+         playlist_cache_read_u32(&r);
+   playlist->default_core_path    = playlist_cache_read_string(&r);
+   playlist->default_core_name    = playlist_cache_read_string(&r);
+   playlist->base_content_directory = playlist_cache_read_string(&r);
+
+   entry_count = playlist_cache_read_u32(&r);
+
+   if (r.error || (entry_count > playlist->config.capacity))
+      goto done;
+
+   if (entry_count > 0)
+      RBUF_RESIZE(playlist->entries, entry_count);
+
+   for (i = 0; i < entry_count; i++)
+   {
+      uint32_t j, num_roms;
+      struct playlist_entry *entry = &playlist->entries[i];
+
+      memset(entry, 0, sizeof(*entry));
+
+      entry->path               = playlist_cache_read_string(&r);
+      entry->label              = playlist_cache_read_string(&r);
+      entry->core_path          = playlist_cache_read_string(&r);
+      entry->core_name          = playlist_cache_read_string(&r);
+      entry->db_name            = playlist_cache_read_string(&r);
+      entry->crc32              = playlist_cache_read_string(&r);
+      entry->subsystem_ident    = playlist_cache_read_string(&r);
+      entry->subsystem_name     = playlist_cache_read_string(&r);
+      entry->runtime_str        = playlist_cache_read_string(&r);
+      entry->last_played_str    = playlist_cache_read_string(&r);
+
+      entry->runtime_status     = (enum playlist_runtime_status)
+            playlist_cache_read_u32(&r);
+      entry->runtime_hours      = playlist_cache_read_u32(&r);
+      entry->runtime_minutes    = playlist_cache_read_u32(&r);
+      entry->runtime_seconds    = playlist_cache_read_u32(&r);
+      entry->last_played_year   = playlist_cache_read_u32(&r);
+      entry->last_played_month  = playlist_cache_read_u32(&r);
+      entry->last_played_day    = playlist_cache_read_u32(&r);
+      entry->last_played_hour   = playlist_cache_read_u32(&r);
+      entry->last_played_minute = playlist_cache_read_u32(&r);
+      entry->last_played_second = playlist_cache_read_u32(&r);
+
+      num_roms                  = playlist_cache_read_u32(&r);
+
+      if (r.error)
+         goto done;
+
+      if (num_roms > 0)
+      {
+         union string_list_elem_attr attr;
+         attr.i                 = 0;
+         entry->subsystem_roms  = string_list_new();
+
+         if (!entry->subsystem_roms)
+            goto done;
+
+         for (j = 0; j < num_roms; j++)
+         {
+            char *rom_path = playlist_cache_read_string(&r);
+            if (r.error)
+               goto done;
+            string_list_append(entry->subsystem_roms,
+                  rom_path ? rom_path : "", attr);
+            if (rom_path)
+               free(rom_path);
+         }
+      }
+   }
+
+   ok = !r.error;
+
+done:
+   free(blob);
+
+   if (!ok)
+   {
+      /* Unwind any partially populated state so the
+       * JSON fallback starts from a clean slate */
+      size_t len = RBUF_LEN(playlist->entries);
+      for (i = 0; i < len; i++)
+         playlist_free_entry(&playlist->entries[i]);
+      RBUF_FREE(playlist->entries);
+      playlist->entries = NULL;
+
+      if (playlist->default_core_path)
+         free(playlist->default_core_path);
+      if (playlist->default_core_name)
+         free(playlist->default_core_name);
+      if (playlist->base_content_directory)
+         free(playlist->base_content_directory);
+      playlist->default_core_path      = NULL;
+      playlist->default_core_name      = NULL;
+      playlist->base_content_directory = NULL;
+   }
+
+   return ok;
+}
+
+/* Dirty-entry journal
+ * > Closing content only bumps one history entry
+ *   and its play metadata, yet used to serialise
+ *   and rewrite the entire playlist - a visible
+ *   hitch on network filesystems
+ * > Such changes are instead appended to a
+ *   '<playlist>.journal' sidecar as compact
+ *   records and replayed on top of the playlist
+ *   at load time; the journal is compacted into
+ *   the main file once it accumulates
+ *   PLAYLIST_JOURNAL_COMPACT_THRESHOLD records,
+ *   or whenever a structural change forces a
+ *   full rewrite anyway */
+
+static void playlist_get_journal_path(const playlist_t *playlist,
+      char *s, size_t len)
+{
+   strlcpy(s, playlist->config.path, len);
+   strlcat(s, ".journal", len);
+}
+
+static void playlist_journal_delete(playlist_t *playlist)
+{
+   char journal_path[PATH_MAX_LENGTH];
+
+   if (string_is_empty(playlist->config.path))
+      return;
+
+   playlist_get_journal_path(playlist, journal_path,
+         sizeof(journal_path));
+
+   if (path_is_valid(journal_path))
+      filestream_delete(journal_path);
+
+   playlist->journal_changes         = 0;
+   playlist->journal_compact_pending = false;
+}
+
+/* Flags an entry as having journal-able (metadata
+ * only) changes. Falls back to a full rewrite when
+ * journaling is not possible. */
+static void playlist_journal_mark(playlist_t *playlist, const char *path)
+{
+   union string_list_elem_attr attr;
+
+   if (string_is_empty(playlist->config.path))
+   {
+      playlist->modified = true;
+      return;
+   }
+
+   if (!playlist->journal_dirty)
+      playlist->journal_dirty = string_list_new();
+
+   if (!playlist->journal_dirty)
+   {
+      playlist->modified = true;
+      return;
+   }
+
+   if (path &&
+       string_list_find_elem(playlist->journal_dirty, path))
+      return;
+
+   attr.i = 0;
+   string_list_append(playlist->journal_dirty,
+         path ? path : "", attr);
+}
+
+/* Appends one record per dirty entry to the journal
+ * sidecar. Returns false if anything went wrong, in
+ * which case the caller must fall back to a full
+ * playlist rewrite. */
+static bool playlist_journal_flush(playlist_t *playlist)
+{
+   size_t i;
+   char journal_path[PATH_MAX_LENGTH];
+   intfstream_t *file = NULL;
+   bool new_file      = false;
+
+   if (!playlist->journal_dirty ||
+       (playlist->journal_dirty->size == 0))
+      return true;
+
+   playlist_get_journal_path(playlist, journal_path,
+         sizeof(journal_path));
+
+   new_file = !path_is_valid(journal_path);
+
+   if (new_file)
+      file = intfstream_open_file(journal_path,
+            RETRO_VFS_FILE_ACCESS_WRITE,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   else
+   {
+      file = intfstream_open_file(journal_path,
+            RETRO_VFS_FILE_ACCESS_READ_WRITE |
+            RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+      if (file)
+         intfstream_seek(file, 0, SEEK_END);
+   }
+
+   if (!file)
+      return false;
+
+   if (new_file)
+   {
+      playlist_cache_write_u32(file, PLAYLIST_JOURNAL_MAGIC);
+      playlist_cache_write_u32(file, PLAYLIST_JOURNAL_VERSION);
+   }
+
+   for (i = 0; i < playlist->journal_dirty->size; i++)
+   {
+      size_t j, len;
+      const char *path                   = playlist->journal_dirty->elems[i].data;
+      const struct playlist_entry *entry = NULL;
+
+      /* Locate current entry state by path */
+      for (j = 0, len = RBUF_LEN(playlist->entries); j < len; j++)
+      {
+         const char *entry_path = playlist->entries[j].path;
+         if ((string_is_empty(path) && string_is_empty(entry_path)) ||
+             (path && entry_path && string_is_equal(path, entry_path)))
+         {
+            entry = &playlist->entries[j];
+            break;
+         }
+      }
+
+      if (!entry)
+         continue;
+
+      playlist_cache_write_string(file, entry->path);
+      playlist_cache_write_string(file, entry->label);
+      playlist_cache_write_string(file, entry->crc32);
+      playlist_cache_write_string(file, entry->db_name);
+      playlist_cache_write_string(file, entry->runtime_str);
+      playlist_cache_write_string(file, entry->last_played_str);
+
+      playlist_cache_write_u32(file, (uint32_t)entry->runtime_status);
+      playlist_cache_write_u32(file, entry->runtime_hours);
+      playlist_cache_write_u32(file, entry->runtime_minutes);
+      playlist_cache_write_u32(file, entry->runtime_seconds);
+      playlist_cache_write_u32(file, entry->last_played_year);
+      playlist_cache_write_u32(file, entry->last_played_month);
+      playlist_cache_write_u32(file, entry->last_played_day);
+      playlist_cache_write_u32(file, entry->last_played_hour);
+      playlist_cache_write_u32(file, entry->last_played_minute);
+      playlist_cache_write_u32(file, entry->last_played_second);
+
+      /* History semantics: journaled entries move
+       * to the front on replay */
+      playlist_cache_write_u32(file, 1);
+
+      playlist->journal_changes++;
+   }
+
+   intfstream_close(file);
+   free(file);
+
+   string_list_free(playlist->journal_dirty);
+   playlist->journal_dirty = NULL;
+
+   return true;
+}
+
+/* Replays journal records on top of a freshly
+ * loaded playlist */
+static void playlist_journal_apply(playlist_t *playlist)
+{
+   char journal_path[PATH_MAX_LENGTH];
+   playlist_cache_reader_t r;
+   int64_t blob_len = 0;
+   void *blob       = NULL;
+
+   if (string_is_empty(playlist->config.path))
+      return;
+
+   playlist_get_journal_path(playlist, journal_path,
+         sizeof(journal_path));
+
+   if (!path_is_valid(journal_path))
+      return;
+
+   if (!filestream_read_file(journal_path, &blob, &blob_len) ||
+       !blob || (blob_len <= 0))
+   {
+      if (blob)
+         free(blob);
+      return;
+   }
+
+   r.data  = (const uint8_t*)blob;
+   r.size  = (size_t)blob_len;
+   r.ptr   = 0;
+   r.error = false;
+
+   if ((playlist_cache_read_u32(&r) != PLAYLIST_JOURNAL_MAGIC) ||
+       (playlist_cache_read_u32(&r) != PLAYLIST_JOURNAL_VERSION))
+   {
+      /* Unusable journal - compact it away on the
+       * next write */
+      free(blob);
+      playlist->journal_compact_pending = true;
+      return;
+   }
+
+   while (!r.error && (r.ptr < r.size))
+   {
+      size_t i, len;
+      char *path            = playlist_cache_read_string(&r);
+      char *label           = playlist_cache_read_string(&r);
+      char *crc32           = playlist_cache_read_string(&r);
+      char *db_name         = playlist_cache_read_string(&r);
+      char *runtime_str     = playlist_cache_read_string(&r);
+      char *last_played_str = playlist_cache_read_string(&r);
+      uint32_t scalars[10];
+      uint32_t bump;
+      struct playlist_entry *entry = NULL;
+
+      for (i = 0; i < 10; i++)
+         scalars[i] = playlist_cache_read_u32(&r);
+      bump = playlist_cache_read_u32(&r);
+
+      if (!r.error)
+      {
+         /* Locate target entry by path */
+         for (i = 0, len = RBUF_LEN(playlist->entries); i < len; i++)
+         {
+            const char *entry_path = playlist->entries[i].path;
+            if ((!path && string_is_empty(entry_path)) ||
+                (path && entry_path && string_is_equal(path, entry_path)))
+            {
+               entry = &playlist->entries[i];
+               break;
+            }
+         }
+
+         if (entry)
+         {
+            if (label)
+            {
+               if (entry->label)
+                  free(entry->label);
+               entry->label           = label;
+               label                  = NULL;
+            }
+            if (crc32)
+            {
+               if (entry->crc32)
+                  free(entry->crc32);
+               entry->crc32           = crc32;
+               crc32                  = NULL;
+            }
+            if (db_name)
+            {
+               if (entry->db_name)
+                  free(entry->db_name);
+               entry->db_name         = db_name;
+               db_name                = NULL;
+            }
+            if (runtime_str)
+            {
+               if (entry->runtime_str)
+                  free(entry->runtime_str);
+               entry->runtime_str     = runtime_str;
+               runtime_str            = NULL;
+            }
+            if (last_played_str)
+            {
+               if (entry->last_played_str)
+                  free(entry->last_played_str);
+               entry->last_played_str = last_played_str;
+               last_played_str        = NULL;
+            }
+
+            entry->runtime_status     = (enum playlist_runtime_status)scalars[0];
+            entry->runtime_hours      = scalars[1];
+            entry->runtime_minutes    = scalars[2];
+            entry->runtime_seconds    = scalars[3];
+            entry->last_played_year   = scalars[4];
+            entry->last_played_month  = scalars[5];
+            entry->last_played_day    = scalars[6];
+            entry->last_played_hour   = scalars[7];
+            entry->last_played_minute = scalars[8];
+            entry->last_played_second = scalars[9];
+
+            if (bump && (i > 0))
+            {
+               struct playlist_entry tmp = playlist->entries[i];
+               memmove(playlist->entries + 1, playlist->entries,
+                     i * sizeof(struct playlist_entry));
+               playlist->entries[0]      = tmp;
+            }
+         }
+
+         playlist->journal_changes++;
+      }
+
+      if (path)
+         free(path);
+      if (label)
+         free(label);
+      if (crc32)
+         free(crc32);
+      if (db_name)
+         free(db_name);
+      if (runtime_str)
+         free(runtime_str);
+      if (last_played_str)
+         free(last_played_str);
+   }
+
+   free(blob);
+
+   /* Truncated/corrupt journals and oversized ones
+    * are folded into the main file on the next write */
+   if (r.error ||
+       (playlist->journal_changes >= PLAYLIST_JOURNAL_COMPACT_THRESHOLD))
+      playlist->journal_compact_pending = true;
+}
+
 static bool playlist_read_file(playlist_t *playlist)
 {
    unsigned i;
    int test_char;
    bool res = true;
 
+   /* Entries are (re)populated wholesale - any existing
+    * membership index is stale */
+   playlist_path_index_invalidate(playlist);
+
 #if defined(HAVE_ZLIB)
       /* Always use RZIP interface when reading playlists
        * > this will automatically handle uncompressed
@@ -2676,6 +3735,12 @@ json_cleanup:
 end:
    intfstream_close(file);
    free(file);
+
+   /* Cache the parsed playlist so the next load
+    * can skip the parser entirely */
+   if (res)
+      playlist_cache_write(playlist);
+
    return res;
 }
 
@@ -2736,19 +3801,31 @@ playlist_t *playlist_init(const playlist_config_t *config)
    playlist->default_core_path      = NULL;
    playlist->base_content_directory = NULL;
    playlist->entries                = NULL;
+   playlist->path_index             = NULL;
    playlist->label_display_mode     = LABEL_DISPLAY_MODE_DEFAULT;
    playlist->right_thumbnail_mode   = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
    playlist->left_thumbnail_mode    = PLAYLIST_THUMBNAIL_MODE_DEFAULT;
    playlist->sort_mode              = PLAYLIST_SORT_MODE_DEFAULT;
+   playlist->journal_dirty          = NULL;
+   playlist->journal_changes        = 0;
+   playlist->journal_compact_pending = false;
 
    /* Cache configuration parameters */
    if (!playlist_config_copy(config, &playlist->config))
       goto error;
 
-   /* Attempt to read any existing playlist file */
-   if (!playlist_read_file(playlist))
+   /* Attempt to read any existing playlist file
+    * > Binary sidecar cache is tried first; on a
+    *   miss, fall back to the JSON/6-line parser */
+   if (!playlist_cache_read(playlist) &&
+       !playlist_read_file(playlist))
       goto error;
 
+   /* Replay any journaled metadata changes
+    * (must happen before path auto-fixing, since
+    * journal records reference on-disk paths) */
+   playlist_journal_apply(playlist);
+
    /* Try auto-fixing paths if enabled, and playlist
     * base content directory is different */
    if (config->autofix_paths && !string_is_equal(playlist->base_content_directory, config->base_content_directory))
@@ -410,6 +410,7 @@ check_enabled 'OPENGL OPENGLES OPENGLES3' GLSL GLSL \
 check_enabled ZLIB BUILTINZLIB 'builtin zlib' 'zlib is' true
 
 check_val '' ZLIB '-lz' '' zlib '' '' false
+check_val '' ZSTD '-lzstd' '' libzstd '' '' false
 check_val '' MPV -lmpv '' mpv '' '' false
 
 check_header '' DRMINGW exchndl.h
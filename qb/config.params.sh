@@ -99,6 +99,7 @@ HAVE_CG=auto               # Cg shader support
 HAVE_HLSL=no               # HLSL9 shader support (for Direct3D9)
 HAVE_BUILTINZLIB=auto      # Bake in zlib
 HAVE_ZLIB=auto             # zlib support (ZIP extract, PNG decoding/encoding)
+HAVE_ZSTD=auto             # zstd support (delta-compressed savestates)
 HAVE_ALSA=auto             # ALSA support
 C89_ALSA=no
 HAVE_RPILED=auto           # RPI led support
@@ -145,6 +145,11 @@ struct ff_video_info
    unsigned frame_drop_ratio;
    unsigned frame_drop_count;
 
+   /* Frames dropped because the encoder could not keep up,
+    * and the dupes still owed to the timeline for them. */
+   uint64_t frames_dropped;
+   unsigned dupes_owed;
+
    /* Input pixel size. */
    size_t pix_size;
 
@@ -1116,35 +1121,23 @@ static bool ffmpeg_push_video(void *data,
    if (drop_frame)
       return true;
 
-   for (;;)
-   {
-      unsigned avail;
-
-      slock_lock(handle->lock);
-      avail = FIFO_WRITE_AVAIL(handle->attr_fifo);
-      slock_unlock(handle->lock);
-
-      if (!handle->alive)
-         return false;
-
-      if (avail >= sizeof(*vid))
-         break;
+   if (!handle->alive)
+      return false;
 
-      slock_lock(handle->cond_lock);
-      if (handle->can_sleep)
-      {
-         handle->can_sleep = false;
-         scond_wait(handle->cond, handle->cond_lock);
-         handle->can_sleep = true;
-      }
-      else
-         scond_signal(handle->cond);
+   slock_lock(handle->lock);
 
-      slock_unlock(handle->cond_lock);
+   /* Every frame dropped under backpressure owes the timeline a
+    * dupe, or audio drifts ahead of video. Repay them as soon as
+    * the attribute FIFO has room again. */
+   while (handle->video.dupes_owed &&
+         FIFO_WRITE_AVAIL(handle->attr_fifo) > sizeof(attr_data))
+   {
+      struct record_video_data dupe = {0};
+      dupe.is_dupe = true;
+      fifo_write(handle->attr_fifo, &dupe, sizeof(dupe));
+      handle->video.dupes_owed--;
    }
 
-   slock_lock(handle->lock);
-
    /* Tightly pack our frame to conserve memory.
     * libretro tends to use a very large pitch.
     */
@@ -1155,14 +1148,45 @@ static bool ffmpeg_push_video(void *data,
    else
       attr_data.pitch = attr_data.width * handle->video.pix_size;
 
-   fifo_write(handle->attr_fifo, &attr_data, sizeof(attr_data));
+   if (FIFO_WRITE_AVAIL(handle->attr_fifo) < sizeof(attr_data))
+   {
+      /* Both FIFOs are backed up - drop outright rather than
+       * stall the thread that submits frames. */
+      handle->video.dupes_owed++;
+      handle->video.frames_dropped++;
+      slock_unlock(handle->lock);
+   }
+   else if (!attr_data.is_dupe &&
+         FIFO_WRITE_AVAIL(handle->video_fifo) <
+         (size_t)attr_data.height * attr_data.pitch)
+   {
+      /* No room for the payload - queue a dupe of the previous
+       * frame instead, which keeps the timeline intact for free. */
+      attr_data.width = attr_data.height = attr_data.pitch = 0;
+      attr_data.is_dupe = true;
+      fifo_write(handle->attr_fifo, &attr_data, sizeof(attr_data));
 
-   for (y = 0; y < attr_data.height; y++, offset += vid->pitch)
-      fifo_write(handle->video_fifo,
-            (const uint8_t*)vid->data + offset, attr_data.pitch);
+      handle->video.frames_dropped++;
+      slock_unlock(handle->lock);
+      scond_signal(handle->cond);
+   }
+   else
+   {
+      fifo_write(handle->attr_fifo, &attr_data, sizeof(attr_data));
 
-   slock_unlock(handle->lock);
-   scond_signal(handle->cond);
+      for (y = 0; y < attr_data.height; y++, offset += vid->pitch)
+         fifo_write(handle->video_fifo,
+               (const uint8_t*)vid->data + offset, attr_data.pitch);
+
+      slock_unlock(handle->lock);
+      scond_signal(handle->cond);
+      return true;
+   }
+
+   if (handle->video.frames_dropped == 1 ||
+         !(handle->video.frames_dropped % 600))
+      RARCH_WARN("[FFmpeg]: Encoder cannot keep up, dropped %u frames so far. Consider a faster recording preset.\n",
+            (unsigned)handle->video.frames_dropped);
 
    return true;
 }
@@ -98,6 +98,7 @@
 #include <streams/file_stream.h>
 #include <streams/interface_stream.h>
 #include <file/file_path.h>
+#include <memalign.h>
 #include <retro_assert.h>
 #include <retro_miscellaneous.h>
 #include <queues/message_queue.h>
@@ -144,6 +145,17 @@
 #include <net/net_socket.h>
 #endif
 
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
+
 #include <audio/audio_resampler.h>
 
 #include "gfx/gfx_animation.h"
@@ -252,6 +264,7 @@
 #include "version_git.h"
 
 #include "retroarch.h"
+#include "frame_export.h"
 
 #ifdef HAVE_ACCESSIBILITY
 #include "accessibility.h"
@@ -1143,6 +1156,16 @@ static const camera_driver_t *camera_drivers[] = {
 
 #define QUIT_DELAY_USEC 3 * 1000000 /* 3 seconds */
 
+#ifdef HAVE_MENU
+/* While only the menu runs: how long input/animations must stay
+ * quiet before presentation drops to the heartbeat rate, and how
+ * often the last frame is re-presented while quiet. The heartbeat
+ * keeps variable-refresh displays above their low-framerate
+ * compensation floor and gives compositors a liveness signal. */
+#define MENU_IDLE_DELAY_USEC   (1 * 1000000)
+#define MENU_IDLE_PRESENT_USEC 100000 /* 10 Hz */
+#endif
+
 #define DEBUG_INFO_FILENAME "debug_info.txt"
 
 #define MAGIC_INDEX        0
@@ -1163,6 +1186,15 @@ static const camera_driver_t *camera_drivers[] = {
 
 #define AUDIO_BUFFER_FREE_SAMPLES_COUNT (8 * 1024)
 
+/* Largest rate-control ratio step applied between consecutive audio
+ * blocks (~0.35 cents) - bigger corrections are spread over many
+ * blocks so the pitch slides instead of warbling. */
+#define AUDIO_RATIO_SLEW_STEP 0.0002
+
+/* Cap on the total rate-control correction. Beyond a couple of
+ * percent the pitch shift is worse than the dropouts it prevents. */
+#define AUDIO_RATIO_ADJUST_MAX 0.02
+
 #define MENU_SOUND_FORMATS "ogg|mod|xm|s3m|mp3|flac|wav"
 
 #define MIDI_DRIVER_BUF_SIZE 4096
@@ -1518,7 +1550,12 @@ enum
    RA_OPT_MAX_FRAMES_SCREENSHOT_PATH,
    RA_OPT_SET_SHADER,
    RA_OPT_ACCESSIBILITY,
-   RA_OPT_LOAD_MENU_ON_ERROR
+   RA_OPT_LOAD_MENU_ON_ERROR,
+   RA_OPT_BENCH,
+   RA_OPT_INPUT_TRACE_RECORD,
+   RA_OPT_INPUT_TRACE_PLAY,
+   RA_OPT_LOAD_FAST,
+   RA_OPT_RESUME
 };
 
 enum  runloop_state
@@ -1621,6 +1658,8 @@ typedef struct video_pixel_scaler
 {
    struct scaler_ctx *scaler;
    void *scaler_out;
+   /* Remembered for memalign_free_big() */
+   size_t scaler_out_size;
 } video_pixel_scaler_t;
 
 typedef struct
@@ -1699,6 +1738,11 @@ struct input_overlay
    const video_overlay_interface_t *iface;
    input_overlay_state_t overlay_state;
 
+   /* Last alpha value sent to the video driver for each image of
+    * the active overlay, so unchanged values can be skipped. */
+   float *image_alpha;
+   unsigned image_alpha_size;
+
    size_t index;
    size_t size;
 
@@ -1727,6 +1771,74 @@ struct cmd_action_map
 };
 #endif
 
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+/* Binary service socket.
+ *
+ * A local supervisor process (e.g. an arcade cabinet daemon)
+ * can poll a batch of runtime values, or subscribe to have
+ * them pushed, without paying the per-command string parsing
+ * of the UDP text protocol. Frames are length-prefixed:
+ *
+ *    uint32 length   payload size including the opcode byte
+ *    uint8  opcode
+ *    ...    payload
+ *
+ * Multi-byte fields are host byte order - both ends of a
+ * Unix domain socket are on the same machine. A value batch
+ * is requested as a uint32 bitmask of value IDs, and the
+ * VALUES reply (also sent for subscription pushes) echoes the
+ * mask followed by one int64 per set bit, in ascending ID
+ * order. A subscription additionally carries a uint16 push
+ * interval in frames; subscribed state bits (pause, menu,
+ * content) are pushed immediately when they flip. */
+enum rarch_svc_opcode
+{
+   RARCH_SVC_OP_GET         = 0x01,
+   RARCH_SVC_OP_SUBSCRIBE   = 0x02,
+   RARCH_SVC_OP_UNSUBSCRIBE = 0x03,
+   RARCH_SVC_OP_VALUES      = 0x81
+};
+
+enum rarch_svc_value_id
+{
+   RARCH_SVC_VAL_FRAME_COUNT = 0,
+   RARCH_SVC_VAL_FPS_MILLI,       /* presented fps x 1000 */
+   RARCH_SVC_VAL_PAUSED,
+   RARCH_SVC_VAL_MENU_ALIVE,
+   RARCH_SVC_VAL_CONTENT_LOADED,
+   RARCH_SVC_VAL_CONTENT_CRC32,
+   RARCH_SVC_VAL_STATE_SLOT,
+   RARCH_SVC_VAL_FAST_FORWARD,
+   RARCH_SVC_VAL_SLOWMOTION,
+   RARCH_SVC_VAL_AUDIO_MUTED,
+   RARCH_SVC_VAL_FULLSCREEN,
+   RARCH_SVC_VAL_END
+};
+
+/* Value IDs pushed on change, not just on the interval */
+#define RARCH_SVC_STATE_MASK \
+   (  (1u << RARCH_SVC_VAL_PAUSED) \
+    | (1u << RARCH_SVC_VAL_MENU_ALIVE) \
+    | (1u << RARCH_SVC_VAL_CONTENT_LOADED) \
+    | (1u << RARCH_SVC_VAL_FAST_FORWARD) \
+    | (1u << RARCH_SVC_VAL_SLOWMOTION) \
+    | (1u << RARCH_SVC_VAL_AUDIO_MUTED) \
+    | (1u << RARCH_SVC_VAL_FULLSCREEN))
+
+#define RARCH_SVC_MAX_CLIENTS 4
+#define RARCH_SVC_RXBUF_SIZE  64
+
+struct rarch_svc_client
+{
+   int fd;                        /* -1 when the slot is free */
+   size_t rx_len;
+   uint32_t sub_mask;             /* 0 when not subscribed */
+   uint16_t sub_interval;
+   uint16_t sub_countdown;
+   uint8_t rx[RARCH_SVC_RXBUF_SIZE];
+};
+#endif
+
 struct command
 {
 #ifdef HAVE_STDIN_CMD
@@ -1735,6 +1847,11 @@ struct command
 #ifdef HAVE_NETWORK_CMD
    int net_fd;
 #endif
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+   int svc_fd;                    /* -1 when the service socket is down */
+   uint32_t svc_prev_state;
+   struct rarch_svc_client svc_clients[RARCH_SVC_MAX_CLIENTS];
+#endif
 #ifdef HAVE_STDIN_CMD
    char stdin_buf[STDIN_BUF_SIZE];
 #endif
@@ -1928,19 +2045,81 @@ struct discord_state
 typedef struct discord_state discord_state_t;
 #endif
 
+/* Always-on frame timeline recorder - see the
+ * frame_timeline_* functions. */
+enum frame_timeline_slot
+{
+   FRAME_TIMELINE_CORE = 0,
+   FRAME_TIMELINE_VIDEO,
+   FRAME_TIMELINE_AUDIO,
+   FRAME_TIMELINE_MENU,
+   FRAME_TIMELINE_SLOT_LAST
+};
+
+/* Power of two; roughly half a minute of history at 60 Hz */
+#define FRAME_TIMELINE_RING_SIZE   2048
+/* 0.5 ms per histogram bucket; everything past 32 ms
+ * lands in the last bucket */
+#define FRAME_TIMELINE_BUCKET_USEC 500
+#define FRAME_TIMELINE_BUCKETS     64
+
+struct frame_timeline_record
+{
+   retro_time_t begin;
+   uint32_t slots[FRAME_TIMELINE_SLOT_LAST];
+   uint32_t total;
+};
+
+struct frame_timeline_state
+{
+   retro_time_t begin;
+   retro_time_t accum[FRAME_TIMELINE_SLOT_LAST];
+   /* Whole-session slot totals, for the benchmark report */
+   retro_time_t slot_total[FRAME_TIMELINE_SLOT_LAST];
+   retro_time_t total_usec;
+   uint64_t frame_count;
+   uint64_t hitch_count;
+   struct frame_timeline_record ring[FRAME_TIMELINE_RING_SIZE];
+   uint32_t histogram[FRAME_TIMELINE_BUCKETS];
+   bool open;
+};
+
+/* Assembled MIDI output events are staged in this ring and handed
+ * to the backend in one batch per flush, so a note-heavy frame
+ * costs one backend round trip instead of one per event. The ring
+ * is single-producer/single-consumer (midi_driver_write produces,
+ * the drain on flush consumes) and each side only advances its own
+ * index, so no lock is needed. */
+#define MIDI_DRIVER_RING_LEN     512 /* events; power of two */
+#define MIDI_DRIVER_RING_EV_SIZE 8   /* bytes per slot; bigger events
+                                        (SysEx) bypass the ring */
+
+struct midi_out_ring
+{
+   uint32_t delta_time[MIDI_DRIVER_RING_LEN];
+   uint8_t  data[MIDI_DRIVER_RING_LEN][MIDI_DRIVER_RING_EV_SIZE];
+   uint8_t  data_size[MIDI_DRIVER_RING_LEN];
+   volatile unsigned rd_idx;
+   volatile unsigned wr_idx;
+};
+
 struct rarch_state
 {
    double audio_source_ratio_original;
    double audio_source_ratio_current;
+   double audio_ratio_drift;        /* slewed rate-control factor, 1.0 nominal */
+   double audio_flush_interval_avg; /* EWMA of wall time between flushes (us) */
    struct retro_system_av_info video_driver_av_info; /* double alignment */
    videocrt_switch_t crt_switch_st;                  /* double alignment */
 
    retro_time_t frame_limit_minimum_time;
    retro_time_t frame_limit_last_time;
+   retro_time_t audio_last_flush_time;
    retro_time_t libretro_core_runtime_last;
    retro_time_t libretro_core_runtime_usec;
    retro_time_t video_driver_frame_time_samples[
       MEASURE_FRAME_TIME_SAMPLES_COUNT];
+   struct frame_timeline_state frame_timeline;  /* retro_time_t alignment */
    struct global              g_extern;         /* retro_time_t alignment */
 #ifdef HAVE_MENU
    menu_input_t menu_input_state;               /* retro_time_t alignment */
@@ -2047,6 +2226,8 @@ struct rarch_state
 #ifdef HAVE_VIDEO_FILTER
    rarch_softfilter_t *video_driver_state_filter;
    void               *video_driver_state_buffer;
+   /* Remembered for memalign_free_big() */
+   size_t              video_driver_state_buffer_size;
 #endif
 
    const void *frame_cache_data;
@@ -2118,6 +2299,16 @@ struct rarch_state
 #ifdef HAVE_RUNAHEAD
    my_list *runahead_save_state_list;
    my_list *input_state_list;
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   /* Worker thread that runs the primary core while the
+    * secondary instance replays on the main thread. */
+   sthread_t *runahead_thread;
+   slock_t *runahead_thread_lock;
+   scond_t *runahead_thread_cond;
+   /* Guards input_state_list; the worker records last input
+    * while the secondary instance is replaying it. */
+   slock_t *runahead_input_lock;
+#endif
 #endif
 
    struct retro_perf_counter *perf_counters_rarch[MAX_COUNTERS];
@@ -2143,6 +2334,14 @@ struct rarch_state
 #endif
 #ifdef HAVE_BSV_MOVIE
    bsv_movie_t     *bsv_movie_state_handle;              /* ptr alignment */
+#endif
+   intfstream_t    *input_trace_file;                    /* ptr alignment */
+   int16_t         *input_trace_table;                   /* ptr alignment */
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+   frame_export_header_t *frame_export_header;           /* ptr alignment */
+#ifdef _WIN32
+   HANDLE           frame_export_handle;                 /* ptr alignment */
+#endif
 #endif
    gfx_display_t              dispgfx;                   /* ptr alignment */
    input_keyboard_press_t keyboard_press_cb;             /* ptr alignment */
@@ -2196,6 +2395,9 @@ struct rarch_state
    size_t recording_gpu_height;
 
    size_t frame_cache_pitch;
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+   size_t frame_export_buffer_size;
+#endif
 
    size_t audio_driver_chunk_size;
    size_t audio_driver_chunk_nonblock_size;
@@ -2216,6 +2418,17 @@ struct rarch_state
                                                put it right before long */
 
    turbo_buttons_t input_driver_turbo_btns; /* int32_t alignment */
+
+   /* Per-frame input snapshot: the first joypad/analog query after a
+    * poll runs the full bind and remap translation once, every later
+    * one is a table lookup. Run-ahead replays do not re-poll, so they
+    * are served entirely from here. */
+   int16_t  input_snapshot_analog[MAX_USERS][4];
+   uint16_t input_snapshot_mask[MAX_USERS];
+   int16_t input_trace_next_value;
+   uint8_t  input_snapshot_analog_valid[MAX_USERS];
+   bool     input_snapshot_mask_valid[MAX_USERS];
+
    int osk_ptr;
 #if defined(HAVE_COMMAND)
 #ifdef HAVE_NETWORK_CMD
@@ -2248,9 +2461,14 @@ struct rarch_state
 #ifdef HAVE_THREAD_STORAGE
    sthread_tls_t rarch_tls;               /* unsigned alignment */
 #endif
+   struct midi_out_ring midi_drv_out_ring;
+                                          /* uint32_t alignment */
    unsigned runloop_pending_windowed_scale;
    unsigned runloop_max_frames;
    unsigned fastforward_after_frames;
+   uint32_t input_trace_frame;
+   uint32_t input_trace_next_frame;
+   uint32_t input_trace_next_key;
 
 #ifdef HAVE_MENU
    unsigned menu_input_dialog_keyboard_type;
@@ -2282,9 +2500,26 @@ struct rarch_state
 
    unsigned audio_driver_free_samples_buf[
       AUDIO_BUFFER_FREE_SAMPLES_COUNT];
+   /* Load-adaptive resampler quality: consecutive starved /
+    * healthy flushes seen so far. */
+   unsigned audio_driver_overload_counter;
+   unsigned audio_driver_headroom_counter;
+   /* Device hot-migration: frames left in the fade-in ramp that
+    * masks the start-up transient of a freshly opened device. */
+   unsigned audio_migrate_fade_frames;
+   unsigned audio_migrate_fade_total;
    unsigned perf_ptr_rarch;
    unsigned perf_ptr_libretro;
 
+   /* Self-tuning frame delay: the configured value is a
+    * ceiling, the effective value is recalibrated once per
+    * second from an EWMA of core frame time and variance. */
+   unsigned frame_delay_target;
+   unsigned frame_delay_effective;
+   float frame_time_avg;
+   float frame_time_var;
+   retro_time_t frame_delay_next_tune;
+
    float audio_driver_input_data[AUDIO_CHUNK_SIZE_NONBLOCKING * 2];
    float video_driver_core_hz;
    float video_driver_aspect_ratio;
@@ -2300,6 +2535,7 @@ struct rarch_state
    float input_driver_axis_threshold;
 
    enum osk_type osk_idx;
+   enum resampler_quality audio_driver_adaptive_quality;
    enum rarch_core_type current_core_type;
    enum rarch_core_type explicit_current_core_type;
    enum rotation initial_screen_orientation;
@@ -2371,6 +2607,8 @@ struct rarch_state
 #ifdef HAVE_SCREENSHOTS
    char runloop_max_frames_screenshot_path[PATH_MAX_LENGTH];
 #endif
+   char bench_report_path[PATH_MAX_LENGTH];
+   char input_trace_path[PATH_MAX_LENGTH];
    char runtime_content_path[PATH_MAX_LENGTH];
    char runtime_core_path[PATH_MAX_LENGTH];
    char subsystem_path[PATH_MAX_LENGTH];
@@ -2417,6 +2655,7 @@ struct rarch_state
    bool qt_is_inited;
 #endif
    bool has_set_log_to_file;
+   bool core_info_task_pending;
    bool rarch_is_inited;
    bool rarch_is_switching_display_mode;
    bool rarch_is_sram_load_disabled;
@@ -2491,6 +2730,14 @@ struct rarch_state
 #ifdef HAVE_SCREENSHOTS
    bool runloop_max_frames_screenshot;
 #endif
+   bool bench_active;
+   bool input_trace_record;
+   bool input_trace_playback;
+   bool input_trace_started;
+   bool input_trace_have_next;
+   bool fast_boot_active;
+   bool fast_boot_pending;
+   bool resume_session;
 #if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
    bool cli_shader_disable;
 #endif
@@ -2503,6 +2750,7 @@ struct rarch_state
    bool camera_driver_active;
 #ifdef HAVE_VIDEO_FILTER
    bool video_driver_state_out_rgb32;
+   bool video_driver_core_sw_framebuffer;
 #endif
    bool video_driver_crt_switching_active;
    bool video_driver_crt_dynamic_super_width;
@@ -2566,6 +2814,11 @@ struct rarch_state
    bool runahead_available;
    bool runahead_secondary_core_available;
    bool runahead_force_input_dirty;
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   bool runahead_thread_run_requested;
+   bool runahead_thread_exit;
+   bool runahead_thread_failed;
+#endif
 #endif
 
 #ifdef HAVE_AUDIOMIXER
@@ -2774,6 +3027,9 @@ static void deinit_netplay(struct rarch_state *p_rarch);
 static void retroarch_deinit_drivers(struct rarch_state *p_rarch);
 
 static bool command_set_shader(const char *arg);
+#if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
+static void retroarch_shader_preset_prewarm(struct rarch_state *p_rarch);
+#endif
 
 static bool midi_driver_read(uint8_t *byte);
 static bool midi_driver_write(uint8_t byte, uint32_t delta_time);
@@ -2781,6 +3037,7 @@ static bool midi_driver_output_enabled(void);
 static bool midi_driver_input_enabled(void);
 static bool midi_driver_set_all_sounds_off(struct rarch_state *p_rarch);
 static const void *midi_driver_find_handle(int index);
+static bool midi_driver_output_ring_drain(struct rarch_state *p_rarch);
 static bool midi_driver_flush(void);
 
 static void retroarch_deinit_core_options(struct rarch_state *p_rarch);
@@ -2799,6 +3056,12 @@ static int16_t input_state_get_last(unsigned port,
 #endif
 static int16_t input_state(unsigned port, unsigned device,
       unsigned idx, unsigned id);
+static void input_trace_tick(struct rarch_state *p_rarch);
+static void input_trace_end(struct rarch_state *p_rarch);
+static bool audio_driver_migrate_device(struct rarch_state *p_rarch);
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+static void frame_export_deinit(struct rarch_state *p_rarch);
+#endif
 static void video_driver_frame(const void *data, unsigned width,
       unsigned height, size_t pitch);
 static void retro_frame_null(const void *data, unsigned width,
@@ -4402,6 +4665,90 @@ static void get_current_menu_sublabel(struct rarch_state *p_rarch,
 }
 #endif
 
+/* The selection must dwell on a playlist entry for this
+ * long before its content is speculatively prewarmed;
+ * filters out ordinary scrolling */
+#define MENU_CONTENT_PREWARM_HOLDOFF_US 500000
+
+/**
+ * menu_driver_content_prewarm:
+ * @entry                    : currently highlighted menu entry
+ * @current_time             : frame timestamp in microseconds
+ *
+ * Once the highlight has rested on a playlist entry for
+ * MENU_CONTENT_PREWARM_HOLDOFF_US, pushes a background task
+ * that reads the entry's content file (and core) into the
+ * OS page cache, so the disk I/O of an anticipated load
+ * overlaps with user think-time.
+ **/
+static void menu_driver_content_prewarm(menu_entry_t *entry,
+      retro_time_t current_time)
+{
+   static playlist_t *last_playlist = NULL;
+   static size_t last_entry_idx     = 0;
+   static retro_time_t stable_since = 0;
+   static bool warmed               = false;
+   const struct playlist_entry *pe  = NULL;
+   playlist_t *playlist             = NULL;
+
+   if (entry->type != FILE_TYPE_RPL_ENTRY)
+   {
+      last_playlist = NULL;
+      return;
+   }
+
+   if (!(playlist = playlist_get_cached()))
+      return;
+
+   if (   (playlist != last_playlist)
+       || (entry->entry_idx != last_entry_idx))
+   {
+      last_playlist  = playlist;
+      last_entry_idx = entry->entry_idx;
+      stable_since   = current_time;
+      warmed         = false;
+      return;
+   }
+
+   if (   warmed
+       || ((current_time - stable_since) <
+             MENU_CONTENT_PREWARM_HOLDOFF_US))
+      return;
+
+   /* One prewarm per dwell - repeats would only churn
+    * the task queue */
+   warmed = true;
+
+   playlist_get_index(playlist, entry->entry_idx, &pe);
+
+   if (pe && !string_is_empty(pe->path))
+   {
+      char content_path[PATH_MAX_LENGTH];
+      char core_path[PATH_MAX_LENGTH];
+
+      core_path[0] = '\0';
+
+      strlcpy(content_path, pe->path, sizeof(content_path));
+      playlist_resolve_path(PLAYLIST_LOAD, false,
+            content_path, sizeof(content_path));
+
+      if (!string_is_empty(pe->core_path))
+      {
+         strlcpy(core_path, pe->core_path, sizeof(core_path));
+         playlist_resolve_path(PLAYLIST_LOAD, true,
+               core_path, sizeof(core_path));
+      }
+
+      task_push_content_prewarm(content_path, core_path);
+
+      /* Warming the core's dylib handle goes one step further
+       * than the page-cache read: the load path then skips the
+       * relocation/constructor cost entirely */
+      if (!string_is_empty(core_path))
+         task_push_core_preload(core_path);
+   }
+}
+
 /**
  * menu_iterate:
  * @input                    : input sample for this frame
@@ -4698,6 +5045,9 @@ static int generic_menu_iterate(
             entry.value_enabled      = false;
             entry.sublabel_enabled   = false;
             menu_entry_get(&entry, 0, selection, NULL, false);
+
+            menu_driver_content_prewarm(&entry, current_time);
+
             ret                      = menu_entry_action(&entry,
                   selection, (enum menu_action)action);
             if (ret)
@@ -5303,18 +5653,14 @@ static menu_list_t *menu_list_new(struct rarch_state *p_rarch)
    {
       list->menu_stack[i]           = (file_list_t*)
          malloc(sizeof(*list->menu_stack[i]));
-      list->menu_stack[i]->list     = NULL;
-      list->menu_stack[i]->capacity = 0;
-      list->menu_stack[i]->size     = 0;
+      file_list_initialize(list->menu_stack[i]);
    }
 
    for (i = 0; i < list->selection_buf_size; i++)
    {
       list->selection_buf[i]           = (file_list_t*)
          malloc(sizeof(*list->selection_buf[i]));
-      list->selection_buf[i]->list     = NULL;
-      list->selection_buf[i]->capacity = 0;
-      list->selection_buf[i]->size     = 0;
+      file_list_initialize(list->selection_buf[i]);
    }
 
    return list;
@@ -5711,31 +6057,25 @@ void menu_entries_append(
 
    idx                = list->size - 1;
 
-   list_info.list     = list;
-   list_info.path     = path;
-   list_info.fullpath = NULL;
-
-   if (!string_is_empty(menu_path))
-      list_info.fullpath = strdup(menu_path);
-
+   list_info.list        = list;
+   list_info.path        = path;
    list_info.label       = label;
    list_info.idx         = idx;
    list_info.entry_type  = type;
 
-   if (  p_rarch->menu_driver_ctx && 
+   /* Menu drivers copy the stack path themselves,
+    * so it can be passed through without duplication */
+   if (  p_rarch->menu_driver_ctx &&
          p_rarch->menu_driver_ctx->list_insert)
       p_rarch->menu_driver_ctx->list_insert(
             p_rarch->menu_userdata,
             list_info.list,
             list_info.path,
-            list_info.fullpath,
+            menu_path,
             list_info.label,
             list_info.idx,
             list_info.entry_type);
 
-   if (list_info.fullpath)
-      free(list_info.fullpath);
-
    file_list_free_actiondata(list, idx);
    cbs                             = (menu_file_list_cbs_t*)
       malloc(sizeof(menu_file_list_cbs_t));
@@ -5798,30 +6138,25 @@ bool menu_entries_append_enum(
 
    idx                   = list->size - 1;
 
-   list_info.fullpath    = NULL;
-
-   if (!string_is_empty(menu_path))
-      list_info.fullpath = strdup(menu_path);
    list_info.list        = list;
    list_info.path        = path;
    list_info.label       = label;
    list_info.idx         = idx;
    list_info.entry_type  = type;
 
-   if (  p_rarch->menu_driver_ctx && 
+   /* Menu drivers copy the stack path themselves,
+    * so it can be passed through without duplication */
+   if (  p_rarch->menu_driver_ctx &&
          p_rarch->menu_driver_ctx->list_insert)
       p_rarch->menu_driver_ctx->list_insert(
             p_rarch->menu_userdata,
             list_info.list,
             list_info.path,
-            list_info.fullpath,
+            menu_path,
             list_info.label,
             list_info.idx,
             list_info.entry_type);
 
-   if (list_info.fullpath)
-      free(list_info.fullpath);
-
    file_list_free_actiondata(list, idx);
    cbs                             = (menu_file_list_cbs_t*)
       malloc(sizeof(menu_file_list_cbs_t));
@@ -5887,30 +6222,25 @@ void menu_entries_prepend(file_list_t *list,
 
    idx              = 0;
 
-   list_info.fullpath    = NULL;
-
-   if (!string_is_empty(menu_path))
-      list_info.fullpath = strdup(menu_path);
    list_info.list        = list;
    list_info.path        = path;
    list_info.label       = label;
    list_info.idx         = idx;
    list_info.entry_type  = type;
 
-   if (  p_rarch->menu_driver_ctx && 
+   /* Menu drivers copy the stack path themselves,
+    * so it can be passed through without duplication */
+   if (  p_rarch->menu_driver_ctx &&
          p_rarch->menu_driver_ctx->list_insert)
       p_rarch->menu_driver_ctx->list_insert(
             p_rarch->menu_userdata,
             list_info.list,
             list_info.path,
-            list_info.fullpath,
+            menu_path,
             list_info.label,
             list_info.idx,
             list_info.entry_type);
 
-   if (list_info.fullpath)
-      free(list_info.fullpath);
-
    file_list_free_actiondata(list, idx);
    cbs                             = (menu_file_list_cbs_t*)
       malloc(sizeof(menu_file_list_cbs_t));
@@ -7802,12 +8132,93 @@ struct video_shader *menu_shader_get(void)
    return NULL;
 }
 
+/* Undo ring for shader parameter edits. Each entry is the value a
+ * parameter had before an edit; 64 entries of 8 bytes keep a long
+ * tuning session's history in half a kilobyte. */
+#define MENU_SHADER_PARAM_UNDO_SIZE 64
+
+struct menu_shader_param_undo
+{
+   uint16_t index;
+   float value;
+};
+
+/* TODO/FIXME - static globals */
+static struct menu_shader_param_undo
+      menu_shader_param_undo_ring[MENU_SHADER_PARAM_UNDO_SIZE];
+static unsigned menu_shader_param_undo_head = 0; /* next write slot */
+static unsigned menu_shader_param_undo_len  = 0;
+
+void menu_shader_param_undo_record(unsigned index, float value)
+{
+   /* Coalesce consecutive edits of the same parameter, so one
+    * undo reverts a whole slider drag and the ring holds edits
+    * of distinct parameters instead of individual ticks */
+   if (menu_shader_param_undo_len)
+   {
+      struct menu_shader_param_undo *last =
+         &menu_shader_param_undo_ring[
+         (menu_shader_param_undo_head + MENU_SHADER_PARAM_UNDO_SIZE - 1)
+         % MENU_SHADER_PARAM_UNDO_SIZE];
+      if (last->index == index)
+         return;
+   }
+
+   menu_shader_param_undo_ring[menu_shader_param_undo_head].index =
+      (uint16_t)index;
+   menu_shader_param_undo_ring[menu_shader_param_undo_head].value = value;
+   menu_shader_param_undo_head =
+      (menu_shader_param_undo_head + 1) % MENU_SHADER_PARAM_UNDO_SIZE;
+   if (menu_shader_param_undo_len < MENU_SHADER_PARAM_UNDO_SIZE)
+      menu_shader_param_undo_len++;
+}
+
+bool menu_shader_param_undo_pop(void)
+{
+   struct menu_shader_param_undo *entry = NULL;
+   struct video_shader *menu_shader     = menu_shader_get();
+   video_shader_ctx_t shader_info;
+
+   if (!menu_shader_param_undo_len)
+      return false;
+
+   menu_shader_param_undo_head =
+      (menu_shader_param_undo_head + MENU_SHADER_PARAM_UNDO_SIZE - 1)
+      % MENU_SHADER_PARAM_UNDO_SIZE;
+   menu_shader_param_undo_len--;
+   entry = &menu_shader_param_undo_ring[menu_shader_param_undo_head];
+
+   /* Patch the live chain the same way a slider tick does - the
+    * drivers re-read parameter values every frame, so no chain
+    * rebuild is involved */
+   video_shader_driver_get_current_shader(&shader_info);
+   if (     shader_info.data
+         && entry->index < shader_info.data->num_parameters)
+      shader_info.data->parameters[entry->index].current = entry->value;
+
+   if (menu_shader && entry->index < menu_shader->num_parameters)
+   {
+      menu_shader->parameters[entry->index].current = entry->value;
+      menu_shader->modified                         = true;
+   }
+
+   return true;
+}
+
+void menu_shader_param_undo_clear(void)
+{
+   menu_shader_param_undo_head = 0;
+   menu_shader_param_undo_len  = 0;
+}
+
 void menu_shader_manager_free(void *data)
 {
    struct rarch_state *p_rarch = (struct rarch_state*)data;
    if (p_rarch->menu_driver_shader)
       free(p_rarch->menu_driver_shader);
    p_rarch->menu_driver_shader = NULL;
+   /* Edit history belongs to the preset being dropped */
+   menu_shader_param_undo_clear();
 }
 
 /**
@@ -9242,6 +9653,21 @@ static bool netplay_poll(
       int input_latency_frames_min = settings->uints.netplay_input_latency_frames_min -
             (settings->bools.run_ahead_enabled ? settings->uints.run_ahead_frames : 0);
       int input_latency_frames_max = input_latency_frames_min + settings->uints.netplay_input_latency_frames_range;
+      bool mispredicting           = false;
+
+      /* Frequent input mispredictions mean visible rollback
+       * corrections; bias toward more input latency until they
+       * subside. */
+      if (netplay->predict_window_hit + netplay->predict_window_miss
+            >= 512)
+      {
+         mispredicting = netplay->predict_window_miss * 8 >
+               netplay->predict_window_hit;
+         /* Age the window so the decision tracks current
+          * conditions */
+         netplay->predict_window_hit  >>= 1;
+         netplay->predict_window_miss >>= 1;
+      }
 
       /* Assume we need a couple frames worth of time to actually run the
        * current frame */
@@ -9265,7 +9691,7 @@ static bool netplay_poll(
             netplay->input_latency_frames--;
       }
       else if (netplay->input_latency_frames < input_latency_frames_min ||
-               (frames_per_frame < frames_ahead &&
+               ((frames_per_frame < frames_ahead || mispredicting) &&
                 netplay->input_latency_frames < input_latency_frames_max))
       {
          /* We can't hide this much network latency with replay, so hide some
@@ -9273,7 +9699,7 @@ static bool netplay_poll(
          netplay->input_latency_frames++;
       }
       else if (netplay->input_latency_frames > input_latency_frames_max ||
-               (frames_per_frame > frames_ahead + 2 &&
+               (frames_per_frame > frames_ahead + 2 && !mispredicting &&
                 netplay->input_latency_frames > input_latency_frames_min))
       {
          /* We don't need this much latency (any more) */
@@ -10135,7 +10561,9 @@ void netplay_load_savestate(netplay_t *netplay,
    if (save || !serial_info)
    {
       if (netplay_delta_frame_ready(netplay,
-               &netplay->buffer[netplay->run_ptr], netplay->run_frame_count))
+               &netplay->buffer[netplay->run_ptr], netplay->run_frame_count) &&
+          netplay_delta_frame_attach(netplay,
+               &netplay->buffer[netplay->run_ptr]))
       {
          if (!serial_info)
          {
@@ -10621,6 +11049,548 @@ void performance_counters_clear(void)
          sizeof(p_rarch->perf_counters_libretro));
 }
 
+/* Frame timeline recorder.
+ *
+ * Unlike the opt-in perf counters above, this is always on:
+ * begin/end bracket one runloop_iterate pass, and the hot paths
+ * report how long they spent running the core, presenting video,
+ * blocking on audio writes and iterating the menu. The per-frame
+ * cost is a few timer reads and array stores, cheap enough to
+ * keep enabled in shipping builds so stutter reports from the
+ * field can be attributed after the fact. */
+
+static void frame_timeline_begin(struct rarch_state *p_rarch)
+{
+   unsigned i;
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+
+   tl->begin = cpu_features_get_time_usec();
+   for (i = 0; i < FRAME_TIMELINE_SLOT_LAST; i++)
+      tl->accum[i] = 0;
+   tl->open  = true;
+}
+
+static void frame_timeline_add(struct rarch_state *p_rarch,
+      enum frame_timeline_slot slot, retro_time_t usec)
+{
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+   if (tl->open)
+      tl->accum[slot] += usec;
+}
+
+/* Closes the current frame. @target_usec is the refresh budget;
+ * a frame more than 1.5x over budget counts as a hitch. Frames
+ * abandoned without an end (quit, pause) are simply overwritten
+ * by the next begin. */
+static void frame_timeline_end(struct rarch_state *p_rarch,
+      retro_time_t target_usec)
+{
+   unsigned i;
+   size_t bucket;
+   struct frame_timeline_record *rec;
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+   retro_time_t total              = 0;
+
+   if (!tl->open)
+      return;
+
+   tl->open   = false;
+   total      = cpu_features_get_time_usec() - tl->begin;
+   if (total < 0)
+      total   = 0;
+
+   rec        = &tl->ring[tl->frame_count
+         & (FRAME_TIMELINE_RING_SIZE - 1)];
+   rec->begin = tl->begin;
+   rec->total = (uint32_t)total;
+   for (i = 0; i < FRAME_TIMELINE_SLOT_LAST; i++)
+   {
+      rec->slots[i] = (tl->accum[i] > 0)
+            ? (uint32_t)tl->accum[i] : 0;
+      tl->slot_total[i] += rec->slots[i];
+   }
+   tl->total_usec += total;
+
+   bucket     = (size_t)(total / FRAME_TIMELINE_BUCKET_USEC);
+   if (bucket >= FRAME_TIMELINE_BUCKETS)
+      bucket  = FRAME_TIMELINE_BUCKETS - 1;
+   tl->histogram[bucket]++;
+
+   if ((target_usec > 0) && (total > target_usec + (target_usec >> 1)))
+      tl->hitch_count++;
+
+   tl->frame_count++;
+}
+
+/* Percentiles come from the running histogram, so the cost is a
+ * walk over 64 buckets regardless of how many frames were seen.
+ * Values are bucket upper edges, i.e. accurate to 0.5 ms. */
+static bool frame_timeline_stats(struct rarch_state *p_rarch,
+      float *p50, float *p95, float *p99,
+      uint64_t *hitches, uint64_t *frames)
+{
+   unsigned i;
+   uint64_t seen                   = 0;
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+
+   if (!tl->frame_count)
+      return false;
+
+   *p50     = *p95 = *p99 = 0.0f;
+   *hitches = tl->hitch_count;
+   *frames  = tl->frame_count;
+
+   for (i = 0; i < FRAME_TIMELINE_BUCKETS; i++)
+   {
+      float edge = (float)(i + 1)
+            * (float)FRAME_TIMELINE_BUCKET_USEC / 1000.0f;
+
+      seen      += tl->histogram[i];
+
+      if (!*p50 && (seen * 100 >= tl->frame_count * 50))
+         *p50    = edge;
+      if (!*p95 && (seen * 100 >= tl->frame_count * 95))
+         *p95    = edge;
+      if (!*p99 && (seen * 100 >= tl->frame_count * 99))
+      {
+         *p99    = edge;
+         break;
+      }
+   }
+
+   return true;
+}
+
+#if defined(HAVE_TRACE)
+/* Trace event ring backing the RARCH_TRACE_* macros in
+ * performance_counters.h. Shared by all threads - task workers,
+ * the video/audio thread wrappers - so which background work
+ * overlapped a dropped frame can be read straight off the dump.
+ * Recording is a timestamp, a thread id and a bounded string
+ * copy under a lock; events are rare (task slices, thread
+ * frames), not per-sample. */
+#define RARCH_TRACE_RING_SIZE 8192
+#define RARCH_TRACE_NAME_LEN  32
+
+struct rarch_trace_event
+{
+   retro_time_t ts;
+   uintptr_t tid;
+   int32_t value;    /* Only meaningful for counter samples */
+   char name[RARCH_TRACE_NAME_LEN];
+   char ph;          /* 'B'egin, 'E'nd, 'M' thread name, 'C'ounter */
+};
+
+static struct rarch_trace_event rarch_trace_ring[RARCH_TRACE_RING_SIZE];
+static uint64_t rarch_trace_count = 0;
+static slock_t *rarch_trace_lock  = NULL;
+
+static void rarch_trace_record(const char *name, char ph)
+{
+   struct rarch_trace_event *ev;
+
+   if (!rarch_trace_lock)
+      return;
+
+   slock_lock(rarch_trace_lock);
+   ev      = &rarch_trace_ring[rarch_trace_count++
+         & (RARCH_TRACE_RING_SIZE - 1)];
+   ev->ts  = cpu_features_get_time_usec();
+   ev->tid = sthread_get_current_thread_id();
+   ev->ph  = ph;
+   strlcpy(ev->name, name ? name : "", sizeof(ev->name));
+   slock_unlock(rarch_trace_lock);
+}
+
+void rarch_trace_begin(const char *name)
+{
+   rarch_trace_record(name, 'B');
+}
+
+void rarch_trace_end(void)
+{
+   rarch_trace_record(NULL, 'E');
+}
+
+void rarch_trace_name_thread(const char *name)
+{
+   rarch_trace_record(name, 'M');
+}
+
+void rarch_trace_counter(const char *name, int32_t value)
+{
+   struct rarch_trace_event *ev;
+
+   if (!rarch_trace_lock)
+      return;
+
+   slock_lock(rarch_trace_lock);
+   ev        = &rarch_trace_ring[rarch_trace_count++
+         & (RARCH_TRACE_RING_SIZE - 1)];
+   ev->ts    = cpu_features_get_time_usec();
+   ev->tid   = sthread_get_current_thread_id();
+   ev->ph    = 'C';
+   ev->value = value;
+   strlcpy(ev->name, name ? name : "", sizeof(ev->name));
+   slock_unlock(rarch_trace_lock);
+}
+
+/* The lock is created once and never freed - events may fire
+ * from worker threads up to process exit. */
+static void rarch_trace_init(void)
+{
+   if (!rarch_trace_lock)
+      rarch_trace_lock = slock_new();
+   RARCH_TRACE_NAME_THREAD("main thread");
+}
+
+static void rarch_task_queue_trace_cb(retro_task_t *task, bool begin)
+{
+   if (begin)
+      rarch_trace_begin((task && !string_is_empty(task->title))
+            ? task->title : "task");
+   else
+      rarch_trace_end();
+}
+
+/* Task titles are free-form - keep them from breaking the
+ * JSON string they are quoted into */
+static void rarch_trace_json_name(const char *in,
+      char *s, size_t len)
+{
+   size_t i;
+   strlcpy(s, in, len);
+   for (i = 0; s[i]; i++)
+      if ((s[i] == '"') || (s[i] == '\\') || ((unsigned char)s[i] < 0x20))
+         s[i] = '\'';
+}
+#endif
+
+/* Input-to-display latency probe.
+ *
+ * Input drivers stamp state-changing events as they are decoded
+ * (input_latency_probe_event); input_driver_poll hands the earliest
+ * unconsumed stamp to the frame being built, and video_driver_frame
+ * closes the sample once that frame has been handed to the swap
+ * chain. With vsync enabled the post-swap timestamp tracks the
+ * present closely; true present feedback (VK_GOOGLE_display_timing,
+ * GLX_OML_sync_control) is not plumbed through the context drivers,
+ * and with threaded video the sample ends at the submit. All
+ * updates happen on the main thread, so plain statics suffice.
+ *
+ * TODO/FIXME - static globals */
+static int64_t  input_latency_pending_us  = 0;
+static int64_t  input_latency_inflight_us = 0;
+static int64_t  input_latency_last_us     = 0;
+static int64_t  input_latency_min_us      = 0;
+static int64_t  input_latency_max_us      = 0;
+static uint64_t input_latency_total_us    = 0;
+static uint64_t input_latency_samples     = 0;
+
+/* Called by input drivers for every state-changing event.
+ * @event_time_us is the event's kernel timestamp on the monotonic
+ * clock; pass 0 when the driver has no event timestamps and the
+ * decode time will be used instead. */
+void input_latency_probe_event(int64_t event_time_us)
+{
+   if (event_time_us <= 0)
+      event_time_us = cpu_features_get_time_usec();
+
+   if (     !input_latency_pending_us
+         || (event_time_us < input_latency_pending_us))
+      input_latency_pending_us = event_time_us;
+}
+
+/* The frame built after a poll is the one that sees the event. */
+static void input_latency_probe_consume(void)
+{
+   if (!input_latency_pending_us)
+      return;
+
+   if (     !input_latency_inflight_us
+         || (input_latency_pending_us < input_latency_inflight_us))
+      input_latency_inflight_us = input_latency_pending_us;
+
+   input_latency_pending_us = 0;
+}
+
+static void input_latency_probe_present(void)
+{
+   int64_t age;
+
+   if (!input_latency_inflight_us)
+      return;
+
+   age                       = cpu_features_get_time_usec()
+         - input_latency_inflight_us;
+   input_latency_inflight_us = 0;
+
+   /* Guard against clock domain mixups from exotic drivers. */
+   if (age < 0)
+      return;
+
+   input_latency_last_us   = age;
+   input_latency_total_us += (uint64_t)age;
+   input_latency_samples++;
+
+   if (!input_latency_min_us || (age < input_latency_min_us))
+      input_latency_min_us = age;
+   if (age > input_latency_max_us)
+      input_latency_max_us = age;
+
+   RARCH_TRACE_COUNTER("input_age_us", (int32_t)age);
+}
+
+/* Precision pacing for the exact-content-framerate (VRR) runloop.
+ *
+ * With vrr_runloop_enable the display follows whenever we present,
+ * so present-to-present spacing is decided entirely by the frame
+ * limiter - and a relative retro_sleep() with millisecond
+ * granularity turns 48 Hz content into up to a millisecond of
+ * cadence error per frame. The governor below sleeps towards an
+ * absolute deadline instead, finishing the last stretch on the
+ * clock, and keeps the schedule anchored so errors don't
+ * accumulate. Wake error is recorded per frame; all updates happen
+ * on the main thread, so plain statics suffice.
+ *
+ * TODO/FIXME - static globals */
+static int64_t  vrr_pace_error_last_us  = 0;
+static int64_t  vrr_pace_error_max_us   = 0;
+static uint64_t vrr_pace_error_total_us = 0;
+static uint64_t vrr_pace_samples        = 0;
+static uint64_t vrr_pace_overruns       = 0;
+
+/* Sleeps until an absolute time on the monotonic clock. OS sleeps
+ * have millisecond granularity and may overshoot by a scheduling
+ * quantum, so the bulk of the wait is slept coarsely and the final
+ * stretch is finished by yielding against the clock. */
+static void vrr_pace_wait_until(retro_time_t deadline)
+{
+   retro_time_t now = cpu_features_get_time_usec();
+
+   while (now < deadline - 2000)
+   {
+      retro_sleep((unsigned)((deadline - 2000 - now) / 1000));
+      now = cpu_features_get_time_usec();
+   }
+
+   while (now < deadline)
+   {
+      retro_sleep(0);
+      now = cpu_features_get_time_usec();
+   }
+}
+
+#if defined(HAVE_COMMAND)
+/* Writes the ring buffer as Chrome trace-format JSON
+ * (chrome://tracing, Perfetto). Slot slices are emitted
+ * back to back from the frame start - we record durations,
+ * not offsets - so their placement within the frame is an
+ * approximation, their lengths are not. */
+static bool frame_timeline_dump(struct rarch_state *p_rarch,
+      const char *path)
+{
+   static const char *slot_names[FRAME_TIMELINE_SLOT_LAST] = {
+      "core", "video", "audio", "menu"
+   };
+   uint64_t start, i;
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+   uint64_t count                  = tl->frame_count;
+   bool first                      = true;
+   RFILE *file                     = NULL;
+
+   if (!count)
+      return false;
+   if (count > FRAME_TIMELINE_RING_SIZE)
+      count = FRAME_TIMELINE_RING_SIZE;
+
+   file = filestream_open(path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return false;
+
+   filestream_printf(file, "[\n");
+
+   start = tl->frame_count - count;
+
+   for (i = start; i < tl->frame_count; i++)
+   {
+      unsigned s;
+      struct frame_timeline_record *rec =
+            &tl->ring[i & (FRAME_TIMELINE_RING_SIZE - 1)];
+      int64_t offset                    = rec->begin;
+
+      filestream_printf(file,
+            "%s{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\","
+            "\"ts\":%" PRId64 ",\"dur\":%u,\"pid\":1,\"tid\":1}",
+            first ? "" : ",\n", rec->begin, rec->total);
+      first = false;
+
+      for (s = 0; s < FRAME_TIMELINE_SLOT_LAST; s++)
+      {
+         if (!rec->slots[s])
+            continue;
+         filestream_printf(file,
+               ",\n{\"name\":\"%s\",\"cat\":\"frame\",\"ph\":\"X\","
+               "\"ts\":%" PRId64 ",\"dur\":%u,\"pid\":1,\"tid\":2}",
+               slot_names[s], offset, rec->slots[s]);
+         offset += rec->slots[s];
+      }
+   }
+
+#if defined(HAVE_TRACE)
+   /* Append the task/thread trace events to the same stream
+    * so Perfetto lines them up with the frame slices */
+   if (rarch_trace_lock)
+   {
+      uint64_t ev_count, j;
+
+      slock_lock(rarch_trace_lock);
+
+      ev_count = rarch_trace_count;
+      if (ev_count > RARCH_TRACE_RING_SIZE)
+         ev_count = RARCH_TRACE_RING_SIZE;
+
+      for (j = rarch_trace_count - ev_count; j < rarch_trace_count; j++)
+      {
+         char name[RARCH_TRACE_NAME_LEN];
+         struct rarch_trace_event *ev =
+               &rarch_trace_ring[j & (RARCH_TRACE_RING_SIZE - 1)];
+         uint64_t tid                 = (uint64_t)ev->tid;
+
+         switch (ev->ph)
+         {
+            case 'B':
+               rarch_trace_json_name(ev->name, name, sizeof(name));
+               filestream_printf(file,
+                     ",\n{\"name\":\"%s\",\"cat\":\"task\",\"ph\":\"B\","
+                     "\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%" PRIu64 "}",
+                     name, ev->ts, tid);
+               break;
+            case 'E':
+               filestream_printf(file,
+                     ",\n{\"ph\":\"E\",\"ts\":%" PRId64
+                     ",\"pid\":1,\"tid\":%" PRIu64 "}",
+                     ev->ts, tid);
+               break;
+            case 'M':
+               rarch_trace_json_name(ev->name, name, sizeof(name));
+               filestream_printf(file,
+                     ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                     "\"tid\":%" PRIu64 ",\"args\":{\"name\":\"%s\"}}",
+                     tid, name);
+               break;
+            case 'C':
+               rarch_trace_json_name(ev->name, name, sizeof(name));
+               filestream_printf(file,
+                     ",\n{\"name\":\"%s\",\"cat\":\"probe\",\"ph\":\"C\","
+                     "\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%" PRIu64
+                     ",\"args\":{\"value\":%d}}",
+                     name, ev->ts, tid, ev->value);
+               break;
+            default:
+               break;
+         }
+      }
+
+      slock_unlock(rarch_trace_lock);
+   }
+#endif
+
+   filestream_printf(file, "\n]\n");
+   filestream_close(file);
+
+   RARCH_LOG("[Trace]: Wrote %" PRIu64 " frames to \"%s\".\n",
+         count, path);
+   return true;
+}
+#endif
+
+/* Peak resident set size of this process in KiB,
+ * 0 where the platform offers no way to ask */
+static long retroarch_bench_peak_rss_kb(void)
+{
+#if defined(__unix__) || defined(__APPLE__)
+   struct rusage usage;
+
+   if (getrusage(RUSAGE_SELF, &usage) == 0)
+#if defined(__APPLE__)
+      return (long)(usage.ru_maxrss / 1024); /* bytes on Darwin */
+#else
+      return (long)usage.ru_maxrss;
+#endif
+#endif
+   return 0;
+}
+
+/* Benchmark mode (--bench) summary. One flat JSON object so
+ * the CI gate can diff runs without parsing log output. The
+ * per-slot totals cover the whole session; everything a frame
+ * spent outside the instrumented slots shows up as "other". */
+static bool retroarch_bench_write_report(struct rarch_state *p_rarch)
+{
+   static const char *slot_names[FRAME_TIMELINE_SLOT_LAST] = {
+      "core", "video", "audio", "menu"
+   };
+   unsigned i;
+   float p50, p95, p99;
+   uint64_t hitches, frames;
+   struct frame_timeline_state *tl = &p_rarch->frame_timeline;
+   retro_time_t other              = tl->total_usec;
+   double fps                      = 0.0;
+   RFILE *file                     = NULL;
+
+   if (!frame_timeline_stats(p_rarch, &p50, &p95, &p99,
+         &hitches, &frames))
+   {
+      RARCH_ERR("[Bench]: No frames were run - not writing \"%s\".\n",
+            p_rarch->bench_report_path);
+      return false;
+   }
+
+   file = filestream_open(p_rarch->bench_report_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+   {
+      RARCH_ERR("[Bench]: Could not open \"%s\" for writing.\n",
+            p_rarch->bench_report_path);
+      return false;
+   }
+
+   if (tl->total_usec > 0)
+      fps = (double)frames * 1000000.0 / (double)tl->total_usec;
+
+   filestream_printf(file, "{\n");
+   filestream_printf(file, "  \"frames\": %" PRIu64 ",\n", frames);
+   filestream_printf(file, "  \"run_time_usec\": %" PRId64 ",\n",
+         (int64_t)tl->total_usec);
+   filestream_printf(file, "  \"fps\": %.3f,\n", fps);
+   filestream_printf(file,
+         "  \"frame_time_ms\": { \"p50\": %.1f, \"p95\": %.1f, \"p99\": %.1f },\n",
+         p50, p95, p99);
+   filestream_printf(file, "  \"hitches\": %" PRIu64 ",\n", hitches);
+   filestream_printf(file, "  \"breakdown_usec\": { ");
+   for (i = 0; i < FRAME_TIMELINE_SLOT_LAST; i++)
+   {
+      filestream_printf(file, "\"%s\": %" PRId64 ", ",
+            slot_names[i], (int64_t)tl->slot_total[i]);
+      other -= tl->slot_total[i];
+   }
+   filestream_printf(file, "\"other\": %" PRId64 " },\n",
+         (int64_t)((other > 0) ? other : 0));
+   filestream_printf(file, "  \"peak_rss_kb\": %ld\n",
+         retroarch_bench_peak_rss_kb());
+   filestream_printf(file, "}\n");
+
+   filestream_close(file);
+
+   RARCH_LOG("[Bench]: %" PRIu64 " frames, %.3f fps - report written to \"%s\".\n",
+         frames, fps, p_rarch->bench_report_path);
+   return true;
+}
+
 struct string_list *dir_list_new_special(const char *input_dir,
       enum dir_list_type type, const char *filter,
       bool show_hidden_files)
@@ -12615,6 +13585,37 @@ static bool command_show_osd_msg(const char* arg)
     return true;
 }
 
+static bool command_frame_trace(const char *arg)
+{
+   char path[PATH_MAX_LENGTH];
+   struct rarch_state *p_rarch = &rarch_st;
+
+   path[0] = '\0';
+
+   if (!string_is_empty(arg))
+      strlcpy(path, arg, sizeof(path));
+   else
+   {
+      settings_t *settings = p_rarch->configuration_settings;
+      const char *log_dir  = settings->paths.log_dir;
+
+      if (!string_is_empty(log_dir))
+         fill_pathname_join(path, log_dir,
+               "retroarch_trace.json", sizeof(path));
+      else
+         strlcpy(path, "retroarch_trace.json", sizeof(path));
+   }
+
+   if (!frame_timeline_dump(p_rarch, path))
+   {
+      RARCH_ERR("[Trace]: Failed to write frame trace to \"%s\".\n",
+            path);
+      return false;
+   }
+
+   return true;
+}
+
 
 static bool command_get_config_param(const char* arg)
 {
@@ -12668,6 +13669,7 @@ static const struct cmd_action_map action_map[] = {
    { "GET_STATUS",       command_get_status,       "No argument" },
    { "GET_CONFIG_PARAM", command_get_config_param, "<param name>" },
    { "SHOW_MSG",         command_show_osd_msg,     "No argument" },
+   { "FRAME_TRACE",      command_frame_trace,      "<output path (optional)>" },
 #if defined(HAVE_CHEEVOS)
    { "READ_CORE_RAM",   command_read_ram,    "<address> <number of bytes>" },
    { "WRITE_CORE_RAM",  command_write_ram,   "<address> <byte1> <byte2> ..." },
@@ -13135,6 +14137,372 @@ static void command_network_poll(
 }
 #endif
 
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static void command_service_socket_path(char *buf, size_t len)
+{
+   const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+
+   if (!string_is_empty(runtime_dir))
+      fill_pathname_join(buf, runtime_dir, "retroarch-cmd.sock", len);
+   else
+      strlcpy(buf, "/tmp/retroarch-cmd.sock", len);
+}
+
+static void command_service_drop_client(struct rarch_svc_client *client)
+{
+   if (client->fd >= 0)
+      socket_close(client->fd);
+   client->fd       = -1;
+   client->rx_len   = 0;
+   client->sub_mask = 0;
+}
+
+static int64_t command_service_value(
+      struct rarch_state *p_rarch, unsigned id)
+{
+   settings_t *settings = p_rarch->configuration_settings;
+
+   switch (id)
+   {
+      case RARCH_SVC_VAL_FRAME_COUNT:
+         return (int64_t)p_rarch->video_driver_frame_count;
+      case RARCH_SVC_VAL_FPS_MILLI:
+         {
+            /* Measured over a short window here rather than
+             * borrowed from the on-screen counter, which only
+             * runs while the FPS display is enabled.
+             * TODO/FIXME - static globals */
+            static retro_time_t fps_window_start;
+            static uint64_t fps_window_frames;
+            static int64_t fps_milli;
+            retro_time_t now   = cpu_features_get_time_usec();
+            uint64_t frames    = p_rarch->video_driver_frame_count;
+            retro_time_t delta = now - fps_window_start;
+
+            if (!fps_window_start || frames < fps_window_frames)
+            {
+               fps_window_start  = now;
+               fps_window_frames = frames;
+            }
+            else if (delta >= 250000)
+            {
+               fps_milli         = (int64_t)
+                     ((frames - fps_window_frames)
+                      * 1000000000LL / delta);
+               fps_window_start  = now;
+               fps_window_frames = frames;
+            }
+            return fps_milli;
+         }
+      case RARCH_SVC_VAL_PAUSED:
+         return p_rarch->runloop_paused ? 1 : 0;
+      case RARCH_SVC_VAL_MENU_ALIVE:
+#ifdef HAVE_MENU
+         return p_rarch->menu_driver_alive ? 1 : 0;
+#else
+         return 0;
+#endif
+      case RARCH_SVC_VAL_CONTENT_LOADED:
+         {
+            bool contentless = false;
+            bool is_inited   = false;
+            content_get_status(&contentless, &is_inited);
+            return is_inited ? 1 : 0;
+         }
+      case RARCH_SVC_VAL_CONTENT_CRC32:
+         return (int64_t)(uint32_t)content_get_crc();
+      case RARCH_SVC_VAL_STATE_SLOT:
+         return settings->ints.state_slot;
+      case RARCH_SVC_VAL_FAST_FORWARD:
+         return p_rarch->runloop_fastmotion ? 1 : 0;
+      case RARCH_SVC_VAL_SLOWMOTION:
+         return p_rarch->runloop_slowmotion ? 1 : 0;
+      case RARCH_SVC_VAL_AUDIO_MUTED:
+         return p_rarch->audio_driver_mute_enable ? 1 : 0;
+      case RARCH_SVC_VAL_FULLSCREEN:
+         return settings->bools.video_fullscreen ? 1 : 0;
+      default:
+         break;
+   }
+
+   return 0;
+}
+
+static bool command_service_send_values(
+      struct rarch_state *p_rarch,
+      struct rarch_svc_client *client, uint32_t mask)
+{
+   /* Worst case: length + opcode + mask + every value */
+   uint8_t frame[4 + 1 + 4 + 8 * RARCH_SVC_VAL_END];
+   unsigned id;
+   uint32_t payload_len;
+   size_t off = 4 + 1 + 4;
+
+   mask &= (1u << RARCH_SVC_VAL_END) - 1;
+
+   for (id = 0; id < RARCH_SVC_VAL_END; id++)
+   {
+      int64_t value;
+
+      if (!(mask & (1u << id)))
+         continue;
+
+      value = command_service_value(p_rarch, id);
+      memcpy(frame + off, &value, sizeof(value));
+      off += sizeof(value);
+   }
+
+   payload_len = (uint32_t)(off - 4);
+   memcpy(frame, &payload_len, sizeof(payload_len));
+   frame[4]    = RARCH_SVC_OP_VALUES;
+   memcpy(frame + 5, &mask, sizeof(mask));
+
+   /* A supervisor that cannot drain a ~100 byte frame is gone
+    * or wedged - treat a short write as a dead client rather
+    * than buffering */
+   return send(client->fd, frame, off, MSG_NOSIGNAL) == (ssize_t)off;
+}
+
+/* Returns false when the client should be dropped */
+static bool command_service_handle_request(
+      struct rarch_state *p_rarch,
+      struct rarch_svc_client *client,
+      const uint8_t *payload, size_t len)
+{
+   uint32_t mask     = 0;
+   uint16_t interval = 0;
+
+   switch (payload[0])
+   {
+      case RARCH_SVC_OP_GET:
+         if (len < 5)
+            return false;
+         memcpy(&mask, payload + 1, sizeof(mask));
+         return command_service_send_values(p_rarch, client, mask);
+      case RARCH_SVC_OP_SUBSCRIBE:
+         if (len < 7)
+            return false;
+         memcpy(&mask,     payload + 1, sizeof(mask));
+         memcpy(&interval, payload + 5, sizeof(interval));
+         client->sub_mask      = mask;
+         client->sub_interval  = interval ? interval : 1;
+         /* First push goes out on the next poll */
+         client->sub_countdown = 1;
+         return true;
+      case RARCH_SVC_OP_UNSUBSCRIBE:
+         client->sub_mask = 0;
+         return true;
+      default:
+         /* Unknown opcodes are skipped, not fatal - lets a
+          * newer supervisor talk to an older build */
+         return true;
+   }
+}
+
+static bool command_service_init(command_t *handle)
+{
+   struct sockaddr_un addr;
+   char path[PATH_MAX_LENGTH];
+   unsigned i;
+   int fd;
+
+   command_service_socket_path(path, sizeof(path));
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strlcpy(addr.sun_path, path, sizeof(addr.sun_path));
+
+   if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+      return false;
+
+   /* A stale socket file from an unclean shutdown blocks bind */
+   unlink(path);
+
+   if (   bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+       || listen(fd, RARCH_SVC_MAX_CLIENTS) < 0
+       || !socket_nonblock(fd))
+   {
+      RARCH_ERR("Failed to bring up service socket at \"%s\".\n",
+            path);
+      socket_close(fd);
+      unlink(path);
+      return false;
+   }
+
+   handle->svc_fd         = fd;
+   handle->svc_prev_state = 0;
+   for (i = 0; i < RARCH_SVC_MAX_CLIENTS; i++)
+      handle->svc_clients[i].fd = -1;
+
+   RARCH_LOG("Service socket listening at \"%s\".\n", path);
+   return true;
+}
+
+static void command_service_free(command_t *handle)
+{
+   char path[PATH_MAX_LENGTH];
+   unsigned i;
+
+   if (handle->svc_fd < 0)
+      return;
+
+   for (i = 0; i < RARCH_SVC_MAX_CLIENTS; i++)
+      command_service_drop_client(&handle->svc_clients[i]);
+
+   socket_close(handle->svc_fd);
+   handle->svc_fd = -1;
+
+   command_service_socket_path(path, sizeof(path));
+   unlink(path);
+}
+
+static void command_service_poll(
+      struct rarch_state *p_rarch,
+      command_t *handle)
+{
+   unsigned i;
+   unsigned id;
+   uint32_t state_word = 0;
+   uint32_t state_diff;
+
+   if (handle->svc_fd < 0)
+      return;
+
+   /* Accept new supervisors */
+   for (;;)
+   {
+      int fd = accept(handle->svc_fd, NULL, NULL);
+
+      if (fd < 0)
+         break;
+
+      if (!socket_nonblock(fd))
+      {
+         socket_close(fd);
+         continue;
+      }
+
+      for (i = 0; i < RARCH_SVC_MAX_CLIENTS; i++)
+         if (handle->svc_clients[i].fd < 0)
+            break;
+
+      if (i == RARCH_SVC_MAX_CLIENTS)
+      {
+         socket_close(fd);
+         continue;
+      }
+
+      handle->svc_clients[i].fd       = fd;
+      handle->svc_clients[i].rx_len   = 0;
+      handle->svc_clients[i].sub_mask = 0;
+   }
+
+   /* Snapshot the pushable state bits once per frame */
+   for (id = 0; id < RARCH_SVC_VAL_END; id++)
+      if (     (RARCH_SVC_STATE_MASK & (1u << id))
+            && command_service_value(p_rarch, id))
+         state_word |= 1u << id;
+   state_diff = state_word ^ handle->svc_prev_state;
+
+   for (i = 0; i < RARCH_SVC_MAX_CLIENTS; i++)
+   {
+      struct rarch_svc_client *client = &handle->svc_clients[i];
+      bool drop                       = false;
+
+      if (client->fd < 0)
+         continue;
+
+      for (;;)
+      {
+         ssize_t ret = recv(client->fd,
+               client->rx + client->rx_len,
+               sizeof(client->rx) - client->rx_len, 0);
+
+         if (ret == 0)
+         {
+            /* Peer closed */
+            drop = true;
+            break;
+         }
+         if (ret < 0)
+         {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+               drop = true;
+            break;
+         }
+
+         client->rx_len += ret;
+
+         /* Dispatch every complete frame in the buffer */
+         for (;;)
+         {
+            uint32_t frame_len;
+
+            if (client->rx_len < 4)
+               break;
+
+            memcpy(&frame_len, client->rx, sizeof(frame_len));
+
+            if (   frame_len < 1
+                || frame_len > sizeof(client->rx) - 4)
+            {
+               /* Malformed or oversized - resynchronising a
+                * byte stream is not worth the code */
+               drop = true;
+               break;
+            }
+
+            if (client->rx_len < 4 + frame_len)
+               break;
+
+            if (!command_service_handle_request(p_rarch, client,
+                  client->rx + 4, frame_len))
+            {
+               drop = true;
+               break;
+            }
+
+            memmove(client->rx, client->rx + 4 + frame_len,
+                  client->rx_len - 4 - frame_len);
+            client->rx_len -= 4 + frame_len;
+         }
+
+         if (drop)
+            break;
+      }
+
+      if (!drop && client->sub_mask)
+      {
+         bool push = false;
+
+         if (client->sub_mask & RARCH_SVC_STATE_MASK & state_diff)
+            push = true;
+
+         if (client->sub_countdown)
+            client->sub_countdown--;
+         if (!client->sub_countdown)
+         {
+            push                  = true;
+            client->sub_countdown = client->sub_interval;
+         }
+
+         if (push && !command_service_send_values(p_rarch,
+               client, client->sub_mask))
+            drop = true;
+      }
+
+      if (drop)
+         command_service_drop_client(client);
+   }
+
+   handle->svc_prev_state = state_word;
+}
+#endif
+
 static bool command_free(command_t *handle)
 {
 #ifdef HAVE_NETWORK_CMD
@@ -13142,6 +14510,11 @@ static bool command_free(command_t *handle)
       socket_close(handle->net_fd);
 #endif
 
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+   if (handle)
+      command_service_free(handle);
+#endif
+
    free(handle);
 
    return true;
@@ -13219,6 +14592,15 @@ static bool command_network_new(
       goto error;
 #endif
 
+#if defined(HAVE_COMMAND) && defined(HAVE_NETWORK_CMD) && !defined(_WIN32)
+   /* The binary service socket rides on the same enable
+    * setting as the UDP text protocol; losing it is not
+    * fatal to the rest of the command interface */
+   handle->svc_fd = -1;
+   if (network_enable)
+      command_service_init(handle);
+#endif
+
 #ifdef HAVE_STDIN_CMD
    handle->stdin_enable = stdin_enable;
    if (stdin_enable && !command_stdin_init(handle))
@@ -14892,6 +16274,12 @@ static bool event_init_content(
    if (!contentless)
       path_fill_names(p_rarch);
 
+#if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
+   /* Pull the auto-shader preset chain into the page cache
+    * while content loading does its own I/O */
+   retroarch_shader_preset_prewarm(p_rarch);
+#endif
+
    if (!content_init())
    {
       p_rarch->runloop_core_running = false;
@@ -15050,6 +16438,92 @@ static void retroarch_set_frame_limit(
          / (av_info->timing.fps * fastforward_ratio));
 }
 
+/**
+ * retroarch_core_info_task_handler:
+ *
+ * Builds the core info list on the task queue. Parsing all
+ * .info files is the single largest chunk of serialized I/O
+ * during startup, and nothing reads the list until the menu
+ * (or drivers_init) issues CMD_EVENT_CORE_INFO_INIT - so the
+ * scan can overlap with driver initialisation.
+ **/
+static void retroarch_core_info_task_handler(retro_task_t *task)
+{
+   char ext_name[255];
+   struct rarch_state *p_rarch    = &rarch_st;
+   settings_t *settings           = p_rarch->configuration_settings;
+   const char *dir_libretro       = settings->paths.directory_libretro;
+   const char *path_libretro_info = settings->paths.path_libretro_info;
+   bool show_hidden_files         = settings->bools.show_hidden_files;
+
+   ext_name[0]                    = '\0';
+
+   if (      frontend_driver_get_core_extension(ext_name, sizeof(ext_name))
+         && !string_is_empty(dir_libretro))
+   {
+      core_info_init_list(path_libretro_info,
+            dir_libretro,
+            ext_name,
+            show_hidden_files
+            );
+      core_info_update_missing_firmware_prefetch(
+            settings->paths.directory_system);
+   }
+
+   task_set_finished(task, true);
+}
+
+static bool retroarch_core_info_task_finder(retro_task_t *task,
+      void *user_data)
+{
+   if (!task)
+      return false;
+
+   return task->handler == retroarch_core_info_task_handler;
+}
+
+static bool retroarch_core_info_task_in_progress(void *data)
+{
+   task_finder_data_t find_data;
+
+   find_data.func     = retroarch_core_info_task_finder;
+   find_data.userdata = NULL;
+
+   if (task_queue_find(&find_data))
+      return true;
+
+   return false;
+}
+
+/* Blocks until the startup core info scan - if one was
+ * pushed - has run to completion. Must be called before
+ * anything touches the core info list. */
+static void retroarch_core_info_task_wait(struct rarch_state *p_rarch)
+{
+   if (!p_rarch->core_info_task_pending)
+      return;
+
+   task_queue_wait(retroarch_core_info_task_in_progress, NULL);
+   p_rarch->core_info_task_pending = false;
+}
+
+static void retroarch_core_info_task_push(struct rarch_state *p_rarch)
+{
+   settings_t *settings = p_rarch->configuration_settings;
+   retro_task_t *task   = NULL;
+
+   if (!settings || string_is_empty(settings->paths.directory_libretro))
+      return;
+
+   if (!(task = task_init()))
+      return;
+
+   task->handler                   = retroarch_core_info_task_handler;
+   task->mute                      = true;
+
+   p_rarch->core_info_task_pending = task_queue_push(task);
+}
+
 static bool command_event_init_core(
       settings_t *settings,
       struct rarch_state *p_rarch,
@@ -15148,6 +16622,102 @@ static bool command_event_init_core(
    return true;
 }
 
+#ifdef HAVE_CONFIGFILE
+static void retroarch_session_bundle_path(char *s, size_t len)
+{
+   char config_dir[PATH_MAX_LENGTH];
+
+   config_dir[0] = '\0';
+
+   fill_pathname_basedir(config_dir, path_get(RARCH_PATH_CONFIG),
+         sizeof(config_dir));
+   fill_pathname_join(s, config_dir, "resume_session.cfg", len);
+}
+
+/**
+ * retroarch_session_save:
+ *
+ * Records the running core and content next to the main config so a
+ * later --resume run can bring the session back without re-selecting
+ * either. The core state itself travels through the auto-savestate
+ * path, which --resume forces on for the whole run.
+ **/
+static void retroarch_session_save(struct rarch_state *p_rarch)
+{
+   char bundle_path[PATH_MAX_LENGTH];
+   config_file_t *conf      = NULL;
+   const char *core_path    = path_get(RARCH_PATH_CORE);
+   const char *content_path = path_get(RARCH_PATH_CONTENT);
+
+   if (!p_rarch->resume_session)
+      return;
+   if (p_rarch->current_core_type == CORE_TYPE_DUMMY)
+      return;
+   if (string_is_empty(core_path) || string_is_empty(content_path))
+      return;
+   if (!(conf = config_file_new_alloc()))
+      return;
+
+   bundle_path[0] = '\0';
+   retroarch_session_bundle_path(bundle_path, sizeof(bundle_path));
+
+   config_set_path(conf, "resume_core_path",    core_path);
+   config_set_path(conf, "resume_content_path", content_path);
+
+   if (config_file_write(conf, bundle_path, false))
+      RARCH_LOG("[Resume]: Session saved to \"%s\".\n", bundle_path);
+   else
+      RARCH_WARN("[Resume]: Failed to save session to \"%s\".\n",
+            bundle_path);
+   config_file_free(conf);
+}
+
+/**
+ * retroarch_session_restore:
+ *
+ * Feeds the core and content recorded by retroarch_session_save()
+ * back into the startup path, as if both had been given on the
+ * command line.
+ **/
+static void retroarch_session_restore(struct rarch_state *p_rarch)
+{
+   char bundle_path[PATH_MAX_LENGTH];
+   char core_path[PATH_MAX_LENGTH];
+   char content_path[PATH_MAX_LENGTH];
+   config_file_t *conf = NULL;
+
+   bundle_path[0] = core_path[0] = content_path[0] = '\0';
+   retroarch_session_bundle_path(bundle_path, sizeof(bundle_path));
+
+   if (!(conf = config_file_new_from_path_to_string(bundle_path)))
+   {
+      RARCH_WARN("[Resume]: No session bundle at \"%s\".\n", bundle_path);
+      return;
+   }
+
+   config_get_path(conf, "resume_core_path",
+         core_path, sizeof(core_path));
+   config_get_path(conf, "resume_content_path",
+         content_path, sizeof(content_path));
+   config_file_free(conf);
+
+   if (!path_is_valid(core_path) || !path_is_valid(content_path))
+   {
+      RARCH_WARN("[Resume]: Session bundle \"%s\" points at missing files.\n",
+            bundle_path);
+      return;
+   }
+
+   path_set(RARCH_PATH_CORE, core_path);
+   retroarch_override_setting_set(RARCH_OVERRIDE_SETTING_LIBRETRO, NULL);
+   retroarch_set_current_core_type(CORE_TYPE_PLAIN, false);
+   path_set(RARCH_PATH_NAMES, content_path);
+
+   RARCH_LOG("[Resume]: Resuming \"%s\" with core \"%s\".\n",
+         content_path, core_path);
+}
+#endif
+
 static bool command_event_save_auto_state(
       settings_t *settings,
       global_t *global,
@@ -16007,9 +17577,16 @@ bool command_event(enum event_command cmd, void *data)
                disk_control_save_image_index(&sys_info->disk_control);
 
             command_event_runtime_log_deinit(p_rarch);
-            command_event_save_auto_state(settings, 
+            command_event_save_auto_state(settings,
                   global, p_rarch);
 
+#ifdef HAVE_CONFIGFILE
+            /* Keep the resume bundle pointing at the last content
+             * that actually ran, even if the user then quits from
+             * the menu with nothing loaded. */
+            retroarch_session_save(p_rarch);
+#endif
+
 #ifdef HAVE_CONFIGFILE
             if (p_rarch->runloop_overrides_active)
                command_event_disable_overrides(p_rarch);
@@ -16284,6 +17861,10 @@ bool command_event(enum event_command cmd, void *data)
 #endif
          break;
       case CMD_EVENT_HISTORY_INIT:
+         /* --load-fast: runs again from fast_boot_complete()
+          * once the first core frame is out. */
+         if (p_rarch->fast_boot_pending)
+            return true;
          {
             playlist_config_t playlist_config;
             bool history_list_enable               = settings->bools.history_list_enable;
@@ -16347,6 +17928,7 @@ bool command_event(enum event_command cmd, void *data)
          }
          break;
       case CMD_EVENT_CORE_INFO_DEINIT:
+         retroarch_core_info_task_wait(p_rarch);
          core_info_deinit_list();
          core_info_free_current_core(&p_rarch->core_info_st);
          break;
@@ -16359,17 +17941,30 @@ bool command_event(enum event_command cmd, void *data)
 
             ext_name[0]                    = '\0';
 
+            /* Startup pushes the initial scan onto the task
+             * queue so it overlaps with driver init - adopt
+             * its result instead of scanning a second time */
+            if (p_rarch->core_info_task_pending)
+            {
+               retroarch_core_info_task_wait(p_rarch);
+               break;
+            }
+
             command_event(CMD_EVENT_CORE_INFO_DEINIT, NULL);
 
             if (!frontend_driver_get_core_extension(ext_name, sizeof(ext_name)))
                return false;
 
             if (!string_is_empty(dir_libretro))
+            {
                core_info_init_list(path_libretro_info,
                      dir_libretro,
                      ext_name,
                      show_hidden_files
                      );
+               core_info_update_missing_firmware_prefetch(
+                     settings->paths.directory_system);
+            }
          }
          break;
       case CMD_EVENT_CORE_DEINIT:
@@ -16381,6 +17976,13 @@ bool command_event(enum event_command cmd, void *data)
             if (sys_info)
                disk_control_save_image_index(&sys_info->disk_control);
 
+#ifdef HAVE_SCREENSHOTS
+            /* Capture a fallback playlist thumbnail while the
+             * core and the cached frame are still valid */
+            if (settings->bools.auto_capture_thumbnails)
+               take_content_thumbnail();
+#endif
+
             command_event_runtime_log_deinit(p_rarch);
             content_reset_savestate_backups();
             hwr = VIDEO_DRIVER_GET_HW_CONTEXT_INTERNAL();
@@ -16477,6 +18079,14 @@ bool command_event(enum event_command cmd, void *data)
          driver_uninit(p_rarch, DRIVER_AUDIO_MASK);
          drivers_init(p_rarch, DRIVER_AUDIO_MASK);
          break;
+      case CMD_EVENT_AUDIO_DEVICE_MIGRATE:
+         if (!audio_driver_migrate_device(p_rarch))
+         {
+            /* Migration is best-effort - a full reinit always works */
+            driver_uninit(p_rarch, DRIVER_AUDIO_MASK);
+            drivers_init(p_rarch, DRIVER_AUDIO_MASK);
+         }
+         break;
       case CMD_EVENT_SHUTDOWN:
 #if defined(__linux__) && !defined(ANDROID)
          runloop_msg_queue_push(msg_hash_to_str(MSG_VALUE_SHUTTING_DOWN), 1, 180, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
@@ -17463,6 +19073,15 @@ void main_exit(void *args)
    if (p_rarch->runloop_perfcnt_enable)
       rarch_perf_log(p_rarch);
 
+   if (p_rarch->bench_active)
+      retroarch_bench_write_report(p_rarch);
+
+   input_trace_end(p_rarch);
+
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+   frame_export_deinit(p_rarch);
+#endif
+
 #if defined(HAVE_LOGGER) && !defined(ANDROID)
    logger_shutdown();
 #endif
@@ -17486,6 +19105,10 @@ void main_exit(void *args)
 
    rarch_ctl(RARCH_CTL_STATE_FREE,  NULL);
    global_free(p_rarch);
+   /* Deinitializing the task queue drops any tasks still
+    * waiting for a worker - make sure a pending SRAM flush
+    * has hit the disk first. */
+   content_wait_for_save_ram_task();
    task_queue_deinit();
 
    if (p_rarch->configuration_settings)
@@ -17972,10 +19595,79 @@ static void core_option_manager_free(core_option_manager_t *opt)
 
    if (opt->conf)
       config_file_free(opt->conf);
+   if (opt->hash_map)
+      free(opt->hash_map);
    free(opt->opts);
    free(opt);
 }
 
+/* Builds the key hash -> option index map consulted by
+ * GET_VARIABLE. Runs once after all options are parsed;
+ * on allocation failure lookups degrade to a linear scan. */
+static void core_option_manager_build_index(core_option_manager_t *opt)
+{
+   size_t i;
+   size_t cap = 2;
+
+   while (cap < (opt->size * 2))
+      cap <<= 1;
+
+   if (!(opt->hash_map = (size_t*)calloc(cap, sizeof(size_t))))
+      return;
+
+   opt->hash_map_mask = cap - 1;
+
+   for (i = 0; i < opt->size; i++)
+   {
+      size_t pos;
+
+      if (string_is_empty(opt->opts[i].key))
+         continue;
+
+      opt->opts[i].key_hash = msg_hash_calculate(opt->opts[i].key);
+
+      pos = opt->opts[i].key_hash & opt->hash_map_mask;
+      while (opt->hash_map[pos])
+         pos = (pos + 1) & opt->hash_map_mask;
+      opt->hash_map[pos] = i + 1;
+   }
+}
+
+static struct core_option *core_option_manager_find(
+      core_option_manager_t *opt, const char *key)
+{
+   size_t i;
+
+   if (string_is_empty(key))
+      return NULL;
+
+   if (opt->hash_map)
+   {
+      uint32_t hash = msg_hash_calculate(key);
+      size_t pos    = hash & opt->hash_map_mask;
+
+      while (opt->hash_map[pos])
+      {
+         struct core_option *option = &opt->opts[opt->hash_map[pos] - 1];
+
+         /* Hash mismatches skip the string comparison;
+          * at most one candidate ever gets compared */
+         if (     (option->key_hash == hash)
+               && string_is_equal(option->key, key))
+            return option;
+         pos = (pos + 1) & opt->hash_map_mask;
+      }
+      return NULL;
+   }
+
+   for (i = 0; i < opt->size; i++)
+      if (  !string_is_empty(opt->opts[i].key)
+         && string_is_equal(opt->opts[i].key, key))
+         return &opt->opts[i];
+
+   return NULL;
+}
+
 /**
  * core_option_manager_new_vars:
  * @conf_path        : Filesystem path to write core option config file to.
@@ -18005,6 +19697,11 @@ static core_option_manager_t *core_option_manager_new_vars(
    opt->opts                         = NULL;
    opt->size                         = 0;
    opt->updated                      = false;
+   opt->hash_map                     = NULL;
+   opt->hash_map_mask                = 0;
+   opt->version                      = 0;
+   opt->query_cache_pos              = 0;
+   memset(opt->query_cache, 0, sizeof(opt->query_cache));
 
    if (!string_is_empty(conf_path))
       if (!(opt->conf = config_file_new_from_path_to_string(conf_path)))
@@ -18039,6 +19736,8 @@ static core_option_manager_t *core_option_manager_new_vars(
    if (config_src)
       config_file_free(config_src);
 
+   core_option_manager_build_index(opt);
+
    return opt;
 
 error:
@@ -18076,6 +19775,11 @@ static core_option_manager_t *core_option_manager_new(
    opt->opts                         = NULL;
    opt->size                         = 0;
    opt->updated                      = false;
+   opt->hash_map                     = NULL;
+   opt->hash_map_mask                = 0;
+   opt->version                      = 0;
+   opt->query_cache_pos              = 0;
+   memset(opt->query_cache, 0, sizeof(opt->query_cache));
 
    if (!string_is_empty(conf_path))
       if (!(opt->conf = config_file_new_from_path_to_string(conf_path)))
@@ -18114,6 +19818,8 @@ static core_option_manager_t *core_option_manager_new(
    if (config_src)
       config_file_free(config_src);
 
+   core_option_manager_build_index(opt);
+
    return opt;
 
 error:
@@ -18257,6 +19963,7 @@ void core_option_manager_set_val(core_option_manager_t *opt,
    option->index = val_idx % option->vals->size;
 
    opt->updated  = true;
+   opt->version++;
 }
 
 /**
@@ -18275,6 +19982,7 @@ void core_option_manager_set_default(core_option_manager_t *opt, size_t idx)
 
    opt->opts[idx].index = opt->opts[idx].default_index;
    opt->updated         = true;
+   opt->version++;
 }
 
 static struct retro_core_option_definition *core_option_manager_get_definitions(
@@ -19002,25 +20710,60 @@ static bool rarch_environment_cb(unsigned cmd, void *data)
             }
 
             {
-               size_t i;
+               size_t c;
+               core_option_manager_t *coreopts = p_rarch->runloop_core_options;
+               struct core_option *option      = NULL;
 
 #ifdef HAVE_RUNAHEAD
-               if (p_rarch->runloop_core_options->updated)
+               if (coreopts->updated)
                   p_rarch->has_variable_update = true;
 #endif
 
-               p_rarch->runloop_core_options->updated   = false;
+               coreopts->updated = false;
 
-               for (i = 0; i < p_rarch->runloop_core_options->size; i++)
+               /* Fast path - cores poll with the same static key
+                * strings every frame, so a pointer match narrows
+                * the query to one entry without probing the hash
+                * map. The API doesn't promise stable key pointers
+                * though (a core may snprintf keys into one reused
+                * buffer), so the match is confirmed against the
+                * option's own key string before it is trusted */
+               for (c = 0; c < CORE_OPTION_QUERY_CACHE_SIZE; c++)
                {
-                  if (!string_is_empty(p_rarch->runloop_core_options->opts[i].key))
-                     if (string_is_equal(
-                              p_rarch->runloop_core_options->opts[i].key, var->key))
+                  if (coreopts->query_cache[c].key != var->key)
+                     continue;
+                  if (!string_is_equal(
+                           coreopts->opts[coreopts->query_cache[c].idx].key,
+                           var->key))
+                     continue;
+                  if (coreopts->query_cache[c].version == coreopts->version)
+                     var->value = coreopts->query_cache[c].value;
+                  else
+                     option     = &coreopts->opts[coreopts->query_cache[c].idx];
+                  break;
+               }
+
+               if (!var->value)
+               {
+                  if (!option)
+                     option = core_option_manager_find(coreopts, var->key);
+
+                  if (option)
+                  {
+                     var->value = option->vals->elems[option->index].data;
+
+                     if (c >= CORE_OPTION_QUERY_CACHE_SIZE)
                      {
-                        var->value = p_rarch->runloop_core_options->opts[i].vals->elems[
-                           p_rarch->runloop_core_options->opts[i].index].data;
-                        break;
+                        c                          = coreopts->query_cache_pos;
+                        coreopts->query_cache_pos  =
+                              (c + 1) % CORE_OPTION_QUERY_CACHE_SIZE;
+                        coreopts->query_cache[c].key = var->key;
+                        coreopts->query_cache[c].idx =
+                              (size_t)(option - coreopts->opts);
                      }
+                     coreopts->query_cache[c].value   = var->value;
+                     coreopts->query_cache[c].version = coreopts->version;
+                  }
                }
             }
 
@@ -19993,7 +21736,14 @@ static bool rarch_environment_cb(unsigned cmd, void *data)
                && p_rarch->video_driver_poke->get_current_software_framebuffer
                && p_rarch->video_driver_poke->get_current_software_framebuffer(
                   p_rarch->video_driver_data, fb))
+         {
+#ifdef HAVE_VIDEO_FILTER
+            /* The driver framebuffer now tracks the core's frame size;
+             * the softfilter must not also resize it for its output. */
+            p_rarch->video_driver_core_sw_framebuffer = true;
+#endif
             return true;
+         }
 
          return false;
       }
@@ -22921,6 +24671,21 @@ static bool input_overlay_is_hidden(
           == OVERLAY_VISIBILITY_HIDDEN);
 }
 
+/* Forwards an alpha change to the video driver only when it differs
+ * from the value last sent for that image - the bulk of these calls
+ * happen every frame with nothing changing. */
+static void input_overlay_set_image_alpha(input_overlay_t *ol,
+      unsigned image, float mod)
+{
+   if (image < ol->image_alpha_size)
+   {
+      if (ol->image_alpha[image] == mod)
+         return;
+      ol->image_alpha[image] = mod;
+   }
+   ol->iface->set_alpha(ol->iface_data, image, mod);
+}
+
 /**
  * input_overlay_set_alpha_mod:
  * @ol                    : Overlay handle.
@@ -22941,9 +24706,9 @@ static void input_overlay_set_alpha_mod(
    for (i = 0; i < ol->active->load_images_size; i++)
    {
       if (input_overlay_is_hidden(p_rarch, i))
-          ol->iface->set_alpha(ol->iface_data, i, 0.0);
+          input_overlay_set_image_alpha(ol, i, 0.0);
       else
-          ol->iface->set_alpha(ol->iface_data, i, mod);
+          input_overlay_set_image_alpha(ol, i, mod);
    }
 }
 
@@ -22952,10 +24717,27 @@ static void input_overlay_load_active(
       struct rarch_state *p_rarch,
       input_overlay_t *ol, float opacity)
 {
+   unsigned i;
+
    if (ol->iface->load)
       ol->iface->load(ol->iface_data, ol->active->load_images,
             ol->active->load_images_size);
 
+   /* (Re)build the per-image alpha cache for the new active
+    * overlay; -1 guarantees the first update goes through. */
+   if (ol->image_alpha_size < ol->active->load_images_size)
+   {
+      float *image_alpha = (float*)realloc(ol->image_alpha,
+            ol->active->load_images_size * sizeof(float));
+      if (image_alpha)
+      {
+         ol->image_alpha      = image_alpha;
+         ol->image_alpha_size = ol->active->load_images_size;
+      }
+   }
+   for (i = 0; i < ol->image_alpha_size; i++)
+      ol->image_alpha[i] = -1.0f;
+
    input_overlay_set_alpha_mod(p_rarch, ol, opacity);
    input_overlay_set_vertex_geom(ol);
 
@@ -23225,7 +25007,7 @@ static void input_overlay_post_poll(
          if (desc->image.pixels)
          {
             if (ol->iface->set_alpha)
-               ol->iface->set_alpha(ol->iface_data, desc->image_index,
+               input_overlay_set_image_alpha(ol, desc->image_index,
                      desc->alpha_mod * opacity);
          }
       }
@@ -23283,6 +25065,8 @@ static void input_overlay_free(input_overlay_t *ol)
    if (ol->iface->enable)
       ol->iface->enable(ol->iface_data, false);
 
+   if (ol->image_alpha)
+      free(ol->image_alpha);
    free(ol);
 }
 
@@ -23398,7 +25182,7 @@ void input_overlay_set_visibility(int overlay_idx,
    if (!ol)
       return;
    if (vis == OVERLAY_VISIBILITY_HIDDEN)
-      ol->iface->set_alpha(ol->iface_data, overlay_idx, 0.0);
+      input_overlay_set_image_alpha(ol, overlay_idx, 0.0);
 }
 
 
@@ -23940,6 +25724,16 @@ static void input_driver_poll(void)
          && p_rarch->current_input->poll)
       p_rarch->current_input->poll(p_rarch->current_input_data);
 
+   input_latency_probe_consume();
+
+   input_trace_tick(p_rarch);
+
+   /* A fresh poll invalidates the per-frame input snapshot. */
+   memset(p_rarch->input_snapshot_mask_valid, 0,
+         sizeof(p_rarch->input_snapshot_mask_valid));
+   memset(p_rarch->input_snapshot_analog_valid, 0,
+         sizeof(p_rarch->input_snapshot_analog_valid));
+
    p_rarch->input_driver_turbo_btns.count++;
 
    for (i = 0; i < max_users; i++)
@@ -24240,6 +26034,10 @@ static void input_driver_poll(void)
 #if defined(HAVE_NETWORK_CMD) && defined(HAVE_COMMAND)
       command_network_poll(p_rarch,
             p_rarch->input_driver_command);
+#if !defined(_WIN32)
+      command_service_poll(p_rarch,
+            p_rarch->input_driver_command);
+#endif
 #endif
 
 #ifdef HAVE_STDIN_CMD
@@ -24662,6 +26460,155 @@ static int16_t input_state_device(
    return res;
 }
 
+/**
+ * input_state_joypad_batch:
+ *
+ * Resolves all sixteen joypad buttons of @port in one pass over
+ * the packed state word @ret. Mirrors bit-for-bit what
+ * input_state_device() computes per button for RETRO_DEVICE_JOYPAD:
+ * remap diversion and bind validity become masks, turbo handling
+ * works on whole words, and the mode-1 toggle bookkeeping only
+ * loops over bits that actually changed. Exact parity with the
+ * scalar path matters more than brevity here, since both mutate
+ * the same turbo state.
+ **/
+static int16_t input_state_joypad_batch(
+      struct rarch_state *p_rarch,
+      int16_t ret, unsigned port)
+{
+   unsigned i;
+   uint16_t res;
+   uint16_t remote_mask          = 0;
+   uint16_t valid_mask           = 0;
+   uint16_t keep_mask            = 0xffff;
+   uint16_t overlay_mask         = 0;
+   uint16_t mapper_mask          = 0;
+   /* Turbo never applies to the D-pad */
+   const uint16_t turbo_eligible = (uint16_t)
+      ~((1 << RETRO_DEVICE_ID_JOYPAD_UP)
+      | (1 << RETRO_DEVICE_ID_JOYPAD_DOWN)
+      | (1 << RETRO_DEVICE_ID_JOYPAD_LEFT)
+      | (1 << RETRO_DEVICE_ID_JOYPAD_RIGHT));
+   settings_t *settings          = p_rarch->configuration_settings;
+   bool input_remap_binds_enable = settings->bools.input_remap_binds_enable;
+   turbo_buttons_t *turbo        = &p_rarch->input_driver_turbo_btns;
+
+#ifdef HAVE_NETWORKGAMEPAD
+   /* Remote RetroPad input bypasses bind processing; with the
+    * word OR'd in up front the remaining masks cannot clear it */
+   if (p_rarch->input_driver_remote)
+      remote_mask = (uint16_t)p_rarch->remote_st_ptr.buttons[port];
+#endif
+
+   if (p_rarch->libretro_input_binds[port])
+      for (i = 0; i < RARCH_FIRST_CUSTOM_BIND; i++)
+         if (p_rarch->libretro_input_binds[port][i].valid)
+            valid_mask |= (1 << i);
+
+   if (input_remap_binds_enable)
+   {
+      keep_mask = 0;
+      for (i = 0; i < RARCH_FIRST_CUSTOM_BIND; i++)
+         if (settings->uints.input_remap_ids[port][i] == i)
+            keep_mask |= (1 << i);
+   }
+
+#ifdef HAVE_OVERLAY
+   if (     p_rarch->overlay_ptr
+         && port == 0
+         && p_rarch->overlay_ptr->alive)
+      overlay_mask = (uint16_t)
+         p_rarch->overlay_ptr->overlay_state.buttons.data[0];
+#endif
+
+   if (input_remap_binds_enable && p_rarch->input_driver_mapper)
+      mapper_mask = (uint16_t)
+         p_rarch->input_driver_mapper->buttons[port].data[0];
+
+   res = remote_mask
+      | (((uint16_t)ret | overlay_mask) & valid_mask & keep_mask)
+      | mapper_mask;
+
+   {
+      uint16_t pulse_mask =
+         ((turbo->count % settings->uints.input_turbo_period)
+          < settings->uints.input_turbo_duty_cycle) ? 0xffff : 0;
+
+      if (settings->uints.input_turbo_mode == 1)
+      {
+         /* Toggle mode: the turbo hotkey arms/disarms, and a
+          * button pressed while armed toggles turbo on it */
+         if (!turbo->frame_enable[port])
+            turbo->turbo_pressed[port] &= ~(1 << 31);
+         else if (turbo->turbo_pressed[port] >= 0)
+         {
+            turbo->turbo_pressed[port] |= (1 << 31);
+            if (!turbo->enable[port])
+            {
+               static const int button_map[]={
+                  RETRO_DEVICE_ID_JOYPAD_B,
+                  RETRO_DEVICE_ID_JOYPAD_Y,
+                  RETRO_DEVICE_ID_JOYPAD_A,
+                  RETRO_DEVICE_ID_JOYPAD_X,
+                  RETRO_DEVICE_ID_JOYPAD_L,
+                  RETRO_DEVICE_ID_JOYPAD_R,
+                  RETRO_DEVICE_ID_JOYPAD_L2,
+                  RETRO_DEVICE_ID_JOYPAD_R2,
+                  RETRO_DEVICE_ID_JOYPAD_L3,
+                  RETRO_DEVICE_ID_JOYPAD_R3};
+               turbo->enable[port] = 1 << button_map[
+                  MIN(
+                        sizeof(button_map)/sizeof(button_map[0])-1,
+                        settings->uints.input_turbo_default_button)];
+            }
+            turbo->mode1_enable[port] ^= 1;
+         }
+
+         if (turbo->turbo_pressed[port] & (1 << 31))
+         {
+            uint16_t newly = res & turbo_eligible
+               & (uint16_t)~turbo->turbo_pressed[port];
+
+            /* Releases drop out of the held latch */
+            turbo->turbo_pressed[port] &=
+               ~(int32_t)(uint16_t)(~res & turbo_eligible);
+
+            /* Toggle turbo for newly pressed buttons, lowest id
+             * first as the scalar loop did, but make sure at
+             * least one button keeps turbo */
+            while (newly)
+            {
+               uint16_t bit        = newly & (uint16_t)-newly;
+               uint16_t enable_new = turbo->enable[port] ^ bit;
+
+               newly              &= (uint16_t)~bit;
+               turbo->turbo_pressed[port] |= bit;
+               if (enable_new)
+                  turbo->enable[port] = enable_new;
+            }
+         }
+
+         /* Unpressed buttons with turbo pulse; held buttons
+          * pass through unmodulated in this mode */
+         if (turbo->mode1_enable[port])
+            res |= pulse_mask & turbo->enable[port] & turbo_eligible;
+      }
+      else
+      {
+         /* Classic mode: buttons held together with the turbo
+          * button latch, releases unlatch */
+         if (turbo->frame_enable[port])
+            turbo->enable[port] |= res & turbo_eligible;
+         turbo->enable[port] &= (uint16_t)(res | ~turbo_eligible);
+
+         res &= (uint16_t)~(turbo->enable[port]
+               & turbo_eligible & (uint16_t)~pulse_mask);
+      }
+   }
+
+   return (int16_t)res;
+}
+
 /**
  * input_state:
  * @port                 : user number.
@@ -24674,7 +26621,10 @@ static int16_t input_state_device(
  * Returns: Non-zero if the given key (identified by @id)
  * was pressed by the user (assigned to @port).
  **/
-static int16_t input_state(unsigned port, unsigned device,
+/* Runs the full bind lookup and remap translation for one query.
+ * Only ever called to (re)fill the per-frame snapshot in
+ * input_state, or for the devices the snapshot does not cover. */
+static int16_t input_state_internal(unsigned port, unsigned device,
       unsigned idx, unsigned id)
 {
    rarch_joypad_info_t joypad_info;
@@ -24683,10 +26633,10 @@ static int16_t input_state(unsigned port, unsigned device,
    int16_t result              = 0;
    int16_t ret                 = 0;
 #ifdef HAVE_MFI
-   const input_device_driver_t 
+   const input_device_driver_t
       *sec_joypad              = p_rarch->sec_joypad;
 #else
-   const input_device_driver_t 
+   const input_device_driver_t
       *sec_joypad              = NULL;
 #endif
 
@@ -24694,22 +26644,6 @@ static int16_t input_state(unsigned port, unsigned device,
    joypad_info.joy_idx         = settings->uints.input_joypad_map[port];
    joypad_info.auto_binds      = input_autoconf_binds[joypad_info.joy_idx];
 
-#ifdef HAVE_BSV_MOVIE
-   if (BSV_MOVIE_IS_PLAYBACK_ON())
-   {
-      int16_t bsv_result;
-      if (intfstream_read(p_rarch->bsv_movie_state_handle->file, &bsv_result, 2) == 2)
-      {
-#ifdef HAVE_CHEEVOS
-         rcheevos_pause_hardcore();
-#endif
-         return swap_if_big16(bsv_result);
-      }
-
-      p_rarch->bsv_movie_state.movie_end = true;
-   }
-#endif
-
    device &= RETRO_DEVICE_MASK;
    ret     = input_state_wrap(
          p_rarch,
@@ -24767,18 +26701,280 @@ static int16_t input_state(unsigned port, unsigned device,
    {
       if (  (device == RETRO_DEVICE_JOYPAD) &&
             (id == RETRO_DEVICE_ID_JOYPAD_MASK))
-      {
-         unsigned i;
+         result = input_state_joypad_batch(p_rarch, ret, port);
+      else
+         result = input_state_device(p_rarch, ret, port, device, idx, id, false);
+   }
+
+   return result;
+}
+
+/* INPUT TRACE
+ *
+ * Record/replay of everything the core sees through its input
+ * callback, for reproducing field performance reports in the lab
+ * (--bench). Unlike bsv movies there is no savestate coupling and
+ * no dependence on query order: state is keyed by
+ * (port, device, index, id) and only changes are written, tagged
+ * with the poll counter, so replay applies each frame's deltas at
+ * poll time and answers queries from the table. Keys outside the
+ * packable range fall through to live input. */
+
+#define INPUT_TRACE_MAGIC    0x54494152 /* 'RAIT' */
+#define INPUT_TRACE_VERSION  1
+
+/* port(4) | device(3) | index(3) | id(9); id covers the
+ * joypad button mask (256) and the RETROK_* keyboard range */
+#define INPUT_TRACE_KEYS     (1 << (4 + 3 + 3 + 9))
+
+static int32_t input_trace_key(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   if ((port >= 16) || (device >= 8) || (idx >= 8) || (id >= 512))
+      return -1;
+   return (int32_t)((((((port << 3) | device) << 3) | idx) << 9) | id);
+}
+
+static void input_trace_begin(struct rarch_state *p_rarch)
+{
+   uint32_t header[2];
+   unsigned mode             = p_rarch->input_trace_record
+         ? RETRO_VFS_FILE_ACCESS_WRITE
+         : RETRO_VFS_FILE_ACCESS_READ;
 
+   p_rarch->input_trace_table = (int16_t*)calloc(
+         INPUT_TRACE_KEYS, sizeof(int16_t));
+   if (p_rarch->input_trace_table)
+      p_rarch->input_trace_file = intfstream_open_file(
+            p_rarch->input_trace_path, mode,
+            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (p_rarch->input_trace_file)
+   {
+      if (p_rarch->input_trace_record)
+      {
+         header[0] = swap_if_big32(INPUT_TRACE_MAGIC);
+         header[1] = swap_if_big32(INPUT_TRACE_VERSION);
+         if (intfstream_write(p_rarch->input_trace_file,
+               header, sizeof(header)) == (int64_t)sizeof(header))
          {
-            for (i = 0; i < RARCH_FIRST_CUSTOM_BIND; i++)
-               if (input_state_device(p_rarch, ret, port, device, idx, i, true))
-                  result |= (1 << i);
+            RARCH_LOG("[InputTrace]: Recording to \"%s\".\n",
+                  p_rarch->input_trace_path);
+            return;
          }
       }
+      else if (  (intfstream_read(p_rarch->input_trace_file,
+                     header, sizeof(header)) == (int64_t)sizeof(header))
+              && (swap_if_big32(header[0]) == INPUT_TRACE_MAGIC)
+              && (swap_if_big32(header[1]) == INPUT_TRACE_VERSION))
+      {
+         RARCH_LOG("[InputTrace]: Replaying \"%s\".\n",
+               p_rarch->input_trace_path);
+         return;
+      }
+   }
+
+   RARCH_ERR("[InputTrace]: Could not %s \"%s\" - tracing disabled.\n",
+         p_rarch->input_trace_record ? "create" : "read",
+         p_rarch->input_trace_path);
+
+   if (p_rarch->input_trace_file)
+   {
+      intfstream_close(p_rarch->input_trace_file);
+      free(p_rarch->input_trace_file);
+      p_rarch->input_trace_file = NULL;
+   }
+   if (p_rarch->input_trace_table)
+   {
+      free(p_rarch->input_trace_table);
+      p_rarch->input_trace_table = NULL;
+   }
+   p_rarch->input_trace_record   = false;
+   p_rarch->input_trace_playback = false;
+}
+
+static void input_trace_end(struct rarch_state *p_rarch)
+{
+   if (p_rarch->input_trace_file)
+   {
+      if (p_rarch->input_trace_record)
+         RARCH_LOG("[InputTrace]: Recorded %u polls to \"%s\".\n",
+               p_rarch->input_trace_frame, p_rarch->input_trace_path);
+      intfstream_close(p_rarch->input_trace_file);
+      free(p_rarch->input_trace_file);
+      p_rarch->input_trace_file = NULL;
+   }
+   if (p_rarch->input_trace_table)
+   {
+      free(p_rarch->input_trace_table);
+      p_rarch->input_trace_table = NULL;
+   }
+   p_rarch->input_trace_record   = false;
+   p_rarch->input_trace_playback = false;
+}
+
+static void input_trace_write(struct rarch_state *p_rarch,
+      unsigned port, unsigned device, unsigned idx, unsigned id,
+      int16_t value)
+{
+   uint32_t rec[2];
+   int16_t le_value;
+   int32_t key = input_trace_key(port, device, idx, id);
+
+   if ((key < 0) || (p_rarch->input_trace_table[key] == value))
+      return;
+
+   p_rarch->input_trace_table[key] = value;
+
+   rec[0]   = swap_if_big32(p_rarch->input_trace_frame);
+   rec[1]   = swap_if_big32((uint32_t)key);
+   le_value = swap_if_big16(value);
+
+   if (  (intfstream_write(p_rarch->input_trace_file,
+               rec, sizeof(rec)) != (int64_t)sizeof(rec))
+      || (intfstream_write(p_rarch->input_trace_file,
+               &le_value, sizeof(le_value)) != (int64_t)sizeof(le_value)))
+   {
+      RARCH_ERR("[InputTrace]: Write failed - recording stopped.\n");
+      input_trace_end(p_rarch);
+   }
+}
+
+/* Advances the poll counter and, on replay, applies every state
+ * delta recorded for polls up to and including this one. Runs in
+ * the same place recording ticks, so the two stay frame-exact. */
+static void input_trace_tick(struct rarch_state *p_rarch)
+{
+   if (!p_rarch->input_trace_record && !p_rarch->input_trace_playback)
+      return;
+
+   if (!p_rarch->input_trace_started)
+   {
+      p_rarch->input_trace_started = true;
+      input_trace_begin(p_rarch);
+      if (!p_rarch->input_trace_file)
+         return;
+   }
+
+   p_rarch->input_trace_frame++;
+
+   if (!p_rarch->input_trace_playback || !p_rarch->input_trace_file)
+      return;
+
+   for (;;)
+   {
+      uint32_t rec[2];
+      int16_t le_value;
+
+      if (p_rarch->input_trace_have_next)
+      {
+         if (p_rarch->input_trace_next_frame > p_rarch->input_trace_frame)
+            break;
+         p_rarch->input_trace_table[p_rarch->input_trace_next_key] =
+               p_rarch->input_trace_next_value;
+         p_rarch->input_trace_have_next = false;
+      }
+
+      if (  (intfstream_read(p_rarch->input_trace_file,
+                  rec, sizeof(rec)) != (int64_t)sizeof(rec))
+         || (intfstream_read(p_rarch->input_trace_file,
+                  &le_value, sizeof(le_value)) != (int64_t)sizeof(le_value)))
+      {
+         /* End of trace - leave the final state in place so a
+          * run longer than the recording stays on its last input */
+         RARCH_LOG("[InputTrace]: Replay finished after %u polls.\n",
+               p_rarch->input_trace_frame - 1);
+         intfstream_close(p_rarch->input_trace_file);
+         free(p_rarch->input_trace_file);
+         p_rarch->input_trace_file = NULL;
+         break;
+      }
+
+      p_rarch->input_trace_next_frame = swap_if_big32(rec[0]);
+      p_rarch->input_trace_next_key   = swap_if_big32(rec[1]);
+      p_rarch->input_trace_next_value = swap_if_big16(le_value);
+
+      if (p_rarch->input_trace_next_key >= INPUT_TRACE_KEYS)
+      {
+         RARCH_ERR("[InputTrace]: Corrupt record - replay stopped.\n");
+         input_trace_end(p_rarch);
+         break;
+      }
+
+      p_rarch->input_trace_have_next  = true;
+   }
+}
+
+static int16_t input_state(unsigned port, unsigned device,
+      unsigned idx, unsigned id)
+{
+   struct rarch_state *p_rarch = &rarch_st;
+   int16_t result              = 0;
+
+#ifdef HAVE_BSV_MOVIE
+   if (BSV_MOVIE_IS_PLAYBACK_ON())
+   {
+      int16_t bsv_result;
+      if (intfstream_read(p_rarch->bsv_movie_state_handle->file, &bsv_result, 2) == 2)
+      {
+#ifdef HAVE_CHEEVOS
+         rcheevos_pause_hardcore();
+#endif
+         return swap_if_big16(bsv_result);
+      }
+
+      p_rarch->bsv_movie_state.movie_end = true;
+   }
+#endif
+
+   device &= RETRO_DEVICE_MASK;
+
+   if (p_rarch->input_trace_playback && p_rarch->input_trace_table)
+   {
+      int32_t trace_key = input_trace_key(port, device, idx, id);
+      if (trace_key >= 0)
+         return p_rarch->input_trace_table[trace_key];
+   }
+
+   if (     (device == RETRO_DEVICE_JOYPAD)
+         && (port < MAX_USERS)
+         && (     id < RARCH_FIRST_CUSTOM_BIND
+               || id == RETRO_DEVICE_ID_JOYPAD_MASK))
+   {
+      /* All sixteen buttons resolve in one pass - a core walking
+       * every button of every port hits the translation once per
+       * port instead of once per button. */
+      if (!p_rarch->input_snapshot_mask_valid[port])
+      {
+         p_rarch->input_snapshot_mask[port]       =
+            (uint16_t)input_state_internal(port, RETRO_DEVICE_JOYPAD,
+                  0, RETRO_DEVICE_ID_JOYPAD_MASK);
+         p_rarch->input_snapshot_mask_valid[port] = true;
+      }
+
+      if (id == RETRO_DEVICE_ID_JOYPAD_MASK)
+         result = (int16_t)p_rarch->input_snapshot_mask[port];
       else
-         result = input_state_device(p_rarch, ret, port, device, idx, id, false);
+         result = (p_rarch->input_snapshot_mask[port] >> id) & 1;
+   }
+   else if ((device == RETRO_DEVICE_ANALOG)
+         && (port < MAX_USERS)
+         && (idx <= RETRO_DEVICE_INDEX_ANALOG_RIGHT)
+         && (id <= RETRO_DEVICE_ID_ANALOG_Y))
+   {
+      unsigned slot = (idx << 1) | id;
+
+      if (!(p_rarch->input_snapshot_analog_valid[port] & (1 << slot)))
+      {
+         p_rarch->input_snapshot_analog[port][slot]  =
+            input_state_internal(port, device, idx, id);
+         p_rarch->input_snapshot_analog_valid[port] |= (1 << slot);
+      }
+
+      result = p_rarch->input_snapshot_analog[port][slot];
    }
+   else
+      result = input_state_internal(port, device, idx, id);
 
 #ifdef HAVE_BSV_MOVIE
    if (BSV_MOVIE_IS_PLAYBACK_OFF())
@@ -24788,6 +26984,9 @@ static int16_t input_state(unsigned port, unsigned device,
    }
 #endif
 
+   if (p_rarch->input_trace_record && p_rarch->input_trace_file)
+      input_trace_write(p_rarch, port, device, idx, id, result);
+
    return result;
 }
 
@@ -28810,6 +31009,10 @@ static bool midi_driver_set_all_sounds_off(struct rarch_state *p_rarch)
    if (!p_rarch->midi_drv_data || !p_rarch->midi_drv_output_enabled)
       return false;
 
+   /* Hand any staged events to the backend first
+    * so they are silenced in order */
+   midi_driver_output_ring_drain(p_rarch);
+
    event.data       = data;
    event.data_size  = sizeof(data);
    event.delta_time = 0;
@@ -28852,6 +31055,9 @@ bool midi_driver_set_volume(unsigned volume)
    event.data_size  = sizeof(data);
    event.delta_time = 0;
 
+   /* Keep ordering with any staged events */
+   midi_driver_output_ring_drain(p_rarch);
+
    if (!midi_drv->write(p_rarch->midi_drv_data, &event))
    {
       RARCH_ERR("[MIDI]: Volume change failed.\n");
@@ -28919,6 +31125,10 @@ static void midi_driver_free(struct rarch_state *p_rarch)
       p_rarch->midi_drv_output_buffer = NULL;
    }
 
+   /* Drop any events still staged for the old device */
+   p_rarch->midi_drv_out_ring.rd_idx = 0;
+   p_rarch->midi_drv_out_ring.wr_idx = 0;
+
    p_rarch->midi_drv_input_enabled  = false;
    p_rarch->midi_drv_output_enabled = false;
 }
@@ -29116,6 +31326,72 @@ static bool midi_driver_output_enabled(void)
    return p_rarch->midi_drv_output_enabled;
 }
 
+static bool midi_driver_output_ring_push(struct rarch_state *p_rarch,
+      const midi_event_t *event)
+{
+   struct midi_out_ring *ring = &p_rarch->midi_drv_out_ring;
+   unsigned wr_idx            = ring->wr_idx;
+   unsigned next              = (wr_idx + 1) & (MIDI_DRIVER_RING_LEN - 1);
+
+   if (next == ring->rd_idx || event->data_size > MIDI_DRIVER_RING_EV_SIZE)
+      return false;
+
+   memcpy(ring->data[wr_idx], event->data, event->data_size);
+   ring->data_size[wr_idx]  = (uint8_t)event->data_size;
+   ring->delta_time[wr_idx] = event->delta_time;
+   ring->wr_idx             = next;
+
+   return true;
+}
+
+/* Hands all staged events to the backend in one batch. On a backend
+ * write error the remaining events stay in the ring for the next
+ * attempt (same contract as the driver 'flush' function). */
+static bool midi_driver_output_ring_drain(struct rarch_state *p_rarch)
+{
+   midi_event_t event;
+   struct midi_out_ring *ring = &p_rarch->midi_drv_out_ring;
+   unsigned rd_idx            = ring->rd_idx;
+
+   while (rd_idx != ring->wr_idx)
+   {
+      event.data       = ring->data[rd_idx];
+      event.data_size  = ring->data_size[rd_idx];
+      event.delta_time = ring->delta_time[rd_idx];
+
+      if (!midi_drv->write(p_rarch->midi_drv_data, &event))
+         return false;
+
+      rd_idx       = (rd_idx + 1) & (MIDI_DRIVER_RING_LEN - 1);
+      ring->rd_idx = rd_idx;
+   }
+
+   return true;
+}
+
+/* Queues a completed output event for the next flush. Events that
+ * don't fit a ring slot (SysEx) or hit a full ring drain the ring
+ * first and go to the backend directly, so ordering is preserved. */
+static bool midi_driver_output_event_done(struct rarch_state *p_rarch)
+{
+   if (!midi_driver_output_ring_push(p_rarch,
+            &p_rarch->midi_drv_output_event))
+   {
+      if (!midi_driver_output_ring_drain(p_rarch))
+         return false;
+
+      if (  !midi_driver_output_ring_push(p_rarch,
+               &p_rarch->midi_drv_output_event) &&
+            !midi_drv->write(p_rarch->midi_drv_data,
+               &p_rarch->midi_drv_output_event))
+         return false;
+   }
+
+   p_rarch->midi_drv_output_pending = true;
+
+   return true;
+}
+
 static bool midi_driver_read(uint8_t *byte)
 {
    static int i;
@@ -29196,8 +31472,7 @@ static bool midi_driver_write(uint8_t byte, uint32_t delta_time)
             event_size = (int)p_rarch->midi_drv_output_event.data_size + 1;
          else
          {
-            if (!midi_drv->write(p_rarch->midi_drv_data,
-                     &p_rarch->midi_drv_output_event))
+            if (!midi_driver_output_event_done(p_rarch))
                return false;
 
 #ifdef DEBUG
@@ -29226,7 +31501,6 @@ static bool midi_driver_write(uint8_t byte, uint32_t delta_time)
             }
 #endif
 
-            p_rarch->midi_drv_output_pending          = true;
             event_size                                = (int)midi_driver_get_event_size(byte);
             p_rarch->midi_drv_output_event.data_size  = 0;
             p_rarch->midi_drv_output_event.delta_time = 0;
@@ -29256,8 +31530,7 @@ static bool midi_driver_write(uint8_t byte, uint32_t delta_time)
 
    if (p_rarch->midi_drv_output_event.data_size == event_size)
    {
-      if (!midi_drv->write(p_rarch->midi_drv_data,
-               &p_rarch->midi_drv_output_event))
+      if (!midi_driver_output_event_done(p_rarch))
          return false;
 
 #ifdef DEBUG
@@ -29286,7 +31559,6 @@ static bool midi_driver_write(uint8_t byte, uint32_t delta_time)
       }
 #endif
 
-      p_rarch->midi_drv_output_pending             = true;
       p_rarch->midi_drv_output_event.data_size     = 0;
       p_rarch->midi_drv_output_event.delta_time    = 0;
    }
@@ -29300,6 +31572,9 @@ static bool midi_driver_flush(void)
    if (!p_rarch->midi_drv_data)
       return false;
 
+   if (!midi_driver_output_ring_drain(p_rarch))
+      return false;
+
    if (p_rarch->midi_drv_output_pending)
       p_rarch->midi_drv_output_pending =
          !midi_drv->flush(p_rarch->midi_drv_data);
@@ -29345,6 +31620,97 @@ static enum resampler_quality audio_driver_get_resampler_quality(
    return (enum resampler_quality)settings->uints.audio_resampler_quality;
 }
 
+/* How many consecutive starved / healthy flushes it takes before
+ * the adaptive resampler steps down or back up. At 60 fps the drop
+ * kicks in after about a second, the restore after five. */
+#define AUDIO_ADAPT_OVERLOAD_FLUSHES 60
+#define AUDIO_ADAPT_RECOVER_FLUSHES  300
+
+static bool audio_driver_realloc_resampler(struct rarch_state *p_rarch,
+      enum resampler_quality quality)
+{
+   settings_t *settings = p_rarch->configuration_settings;
+
+   if (p_rarch->audio_driver_resampler && p_rarch->audio_driver_resampler_data)
+      p_rarch->audio_driver_resampler->free(
+            p_rarch->audio_driver_resampler_data);
+   p_rarch->audio_driver_resampler      = NULL;
+   p_rarch->audio_driver_resampler_data = NULL;
+
+   if (!retro_resampler_realloc(
+            &p_rarch->audio_driver_resampler_data,
+            &p_rarch->audio_driver_resampler,
+            settings->arrays.audio_resampler,
+            quality,
+            p_rarch->audio_source_ratio_original))
+      return false;
+
+   p_rarch->audio_driver_adaptive_quality = quality;
+   return true;
+}
+
+/* Steps the resampler quality down one level while the driver buffer
+ * sits nearly empty - the cheaper kernel claws back CPU time during
+ * fast-forward and heavy scenes - and back towards the configured
+ * quality once the buffer refills and stays full. Swapping kernels
+ * loses a few samples of filter history, which is inaudible next to
+ * the underruns it avoids. */
+static void audio_driver_adapt_resampler_quality(
+      struct rarch_state *p_rarch, int avail)
+{
+   enum resampler_quality configured =
+      audio_driver_get_resampler_quality(p_rarch);
+   enum resampler_quality active     =
+      p_rarch->audio_driver_adaptive_quality;
+   int buffer_size                   =
+      (int)p_rarch->audio_driver_buffer_size;
+
+   /* DONTCARE gives the implementation free rein already -
+    * there is no ladder to walk. */
+   if (configured == RESAMPLER_QUALITY_DONTCARE)
+      return;
+
+   if (avail > (buffer_size * 3) / 4)
+   {
+      /* Buffer mostly free: the core is not keeping up. */
+      p_rarch->audio_driver_headroom_counter = 0;
+
+      if (     active > RESAMPLER_QUALITY_LOWEST
+            && ++p_rarch->audio_driver_overload_counter >=
+                  AUDIO_ADAPT_OVERLOAD_FLUSHES)
+      {
+         p_rarch->audio_driver_overload_counter = 0;
+
+         if (audio_driver_realloc_resampler(p_rarch,
+                  (enum resampler_quality)(active - 1)))
+            RARCH_LOG("[Audio]: Sustained overload, "
+                  "dropping resampler quality to %d.\n",
+                  (int)(active - 1));
+         else
+            p_rarch->audio_driver_active = false;
+      }
+   }
+   else if (avail < buffer_size / 2)
+   {
+      p_rarch->audio_driver_overload_counter = 0;
+
+      if (     active < configured
+            && ++p_rarch->audio_driver_headroom_counter >=
+                  AUDIO_ADAPT_RECOVER_FLUSHES)
+      {
+         p_rarch->audio_driver_headroom_counter = 0;
+
+         if (audio_driver_realloc_resampler(p_rarch,
+                  (enum resampler_quality)(active + 1)))
+            RARCH_LOG("[Audio]: Headroom returned, "
+                  "restoring resampler quality to %d.\n",
+                  (int)(active + 1));
+         else
+            p_rarch->audio_driver_active = false;
+      }
+   }
+}
+
 #ifdef HAVE_AUDIOMIXER
 audio_mixer_stream_t *audio_driver_mixer_get_stream(unsigned i)
 {
@@ -29749,6 +32115,10 @@ static bool audio_driver_init_internal(
       p_rarch->audio_source_ratio_current =
       (double)settings->uints.audio_out_rate / p_rarch->audio_driver_input;
 
+   p_rarch->audio_ratio_drift             = 1.0;
+   p_rarch->audio_flush_interval_avg      = 0.0;
+   p_rarch->audio_last_flush_time         = 0;
+
    if (!retro_resampler_realloc(
             &p_rarch->audio_driver_resampler_data,
             &p_rarch->audio_driver_resampler,
@@ -29761,6 +32131,11 @@ static bool audio_driver_init_internal(
       p_rarch->audio_driver_active = false;
    }
 
+   p_rarch->audio_driver_adaptive_quality  =
+      audio_driver_get_resampler_quality(p_rarch);
+   p_rarch->audio_driver_overload_counter  = 0;
+   p_rarch->audio_driver_headroom_counter  = 0;
+
    p_rarch->audio_driver_data_ptr   = 0;
 
    retro_assert(settings->uints.audio_out_rate <
@@ -29817,6 +32192,120 @@ error:
    return audio_driver_deinit(p_rarch);
 }
 
+/**
+ * audio_driver_migrate_device:
+ *
+ * Re-opens the audio output on the currently configured device
+ * without tearing down the rest of the audio stack. The resampler,
+ * conversion buffers, DSP filter and rewind buffer all survive,
+ * so switching between e.g. HDMI and USB audio costs one device
+ * open instead of a full reinit and its second-long dropout.
+ *
+ * Returns: true on success. On failure the old device context is
+ * left playing and the caller should fall back to a full
+ * audio reinit.
+ **/
+static bool audio_driver_migrate_device(struct rarch_state *p_rarch)
+{
+   unsigned new_rate        = 0;
+   void *new_context        = NULL;
+   void *old_context        = NULL;
+   settings_t *settings     = p_rarch->configuration_settings;
+   bool audio_sync          = settings->bools.audio_sync;
+   bool audio_rate_control  = settings->bools.audio_rate_control;
+
+   /* The threaded driver owns the device context from its own
+    * thread - swapping it out from under it would race. */
+   if (p_rarch->audio_callback.callback)
+      return false;
+
+   if (     !p_rarch->audio_driver_active
+         || !p_rarch->current_audio
+         || !p_rarch->current_audio->init
+         || !p_rarch->audio_driver_context_audio_data)
+      return false;
+
+   /* Open the new device while the old one keeps playing;
+    * nothing is torn down until the replacement is known good. */
+   new_context = p_rarch->current_audio->init(
+         *settings->arrays.audio_device
+         ? settings->arrays.audio_device : NULL,
+         settings->uints.audio_out_rate,
+         settings->uints.audio_latency,
+         settings->uints.audio_block_frames,
+         &new_rate);
+
+   if (!new_context)
+      return false;
+
+   /* The cached device list holds pointers into the old context */
+   audio_driver_free_devices_list(p_rarch);
+
+   old_context = p_rarch->audio_driver_context_audio_data;
+   p_rarch->audio_driver_context_audio_data = new_context;
+
+   if (p_rarch->current_audio->free)
+      p_rarch->current_audio->free(old_context);
+
+   if (new_rate != 0 && new_rate != settings->uints.audio_out_rate)
+      configuration_set_int(settings,
+            settings->uints.audio_out_rate, new_rate);
+
+   /* Per-device properties have to be re-queried. */
+   p_rarch->audio_driver_use_float =
+      p_rarch->current_audio->use_float(
+            p_rarch->audio_driver_context_audio_data);
+
+   if (!audio_sync)
+   {
+      p_rarch->current_audio->set_nonblock_state(
+            p_rarch->audio_driver_context_audio_data, true);
+      p_rarch->audio_driver_chunk_size =
+         p_rarch->audio_driver_chunk_nonblock_size;
+   }
+   else
+      p_rarch->audio_driver_chunk_size =
+         p_rarch->audio_driver_chunk_block_size;
+
+   /* The resampler instance carries on - only the target ratio
+    * moves if the new device negotiated a different rate. */
+   p_rarch->audio_source_ratio_original   =
+      p_rarch->audio_source_ratio_current =
+      (double)settings->uints.audio_out_rate /
+      p_rarch->audio_driver_input;
+
+   p_rarch->audio_driver_control = false;
+   if (audio_rate_control && p_rarch->current_audio->buffer_size)
+   {
+      p_rarch->audio_driver_buffer_size =
+         p_rarch->current_audio->buffer_size(
+               p_rarch->audio_driver_context_audio_data);
+      p_rarch->audio_driver_control = true;
+   }
+
+   /* Rate-control history measured against the old device's
+    * buffer is meaningless for the new one. */
+   p_rarch->audio_ratio_drift               = 1.0;
+   p_rarch->audio_flush_interval_avg        = 0.0;
+   p_rarch->audio_last_flush_time           = 0;
+   p_rarch->audio_driver_free_samples_count = 0;
+
+   /* A true crossfade is not possible here - the two devices run
+    * off independent clocks - so mask the start-up transient of
+    * the new stream with a short fade-in instead. */
+   p_rarch->audio_migrate_fade_total  =
+      settings->uints.audio_out_rate / 20; /* 50 ms */
+   p_rarch->audio_migrate_fade_frames =
+      p_rarch->audio_migrate_fade_total;
+
+   RARCH_LOG("[Audio]: Migrated to device \"%s\" without"
+         " a full reinit.\n",
+         *settings->arrays.audio_device
+         ? settings->arrays.audio_device : "default");
+
+   return true;
+}
+
 /**
  * audio_driver_flush:
  * @data                 : pointer to audio buffer.
@@ -29883,14 +32372,61 @@ static void audio_driver_flush(
       double   direction           = (double)delta_mid / half_size;
       double   adjust              = 1.0 +
          p_rarch->audio_driver_rate_control_delta * direction;
+      retro_time_t now             = cpu_features_get_time_usec();
       unsigned write_idx           =
          p_rarch->audio_driver_free_samples_count++ &
          (AUDIO_BUFFER_FREE_SAMPLES_COUNT - 1);
 
       p_rarch->audio_driver_free_samples_buf
          [write_idx]                        = avail;
+
+      /* Feed-forward: when the runloop paces faster or slower than
+       * the core's nominal rate - a VRR display tracking the content
+       * fps, or a host that cannot quite keep up - audio production
+       * drifts by the same factor. Folding the measured pacing in up
+       * front leaves the buffer-feedback term only the noise to
+       * clean up, so the slew limit below can be kept tight without
+       * risking dropouts. */
+      if (samples && p_rarch->audio_last_flush_time)
+      {
+         double interval = (double)(now - p_rarch->audio_last_flush_time);
+         double nominal  = 1000000.0 * (double)(samples >> 1)
+            / p_rarch->audio_driver_input;
+
+         /* Ignore pauses, fast-forward and menu stalls. */
+         if (interval > nominal * 0.5 && interval < nominal * 2.0)
+         {
+            if (p_rarch->audio_flush_interval_avg == 0.0)
+               p_rarch->audio_flush_interval_avg  = interval;
+            else
+               p_rarch->audio_flush_interval_avg +=
+                  (interval - p_rarch->audio_flush_interval_avg) / 32.0;
+
+            adjust *= p_rarch->audio_flush_interval_avg / nominal;
+         }
+      }
+      p_rarch->audio_last_flush_time = now;
+
+      if (adjust > 1.0 + AUDIO_RATIO_ADJUST_MAX)
+         adjust = 1.0 + AUDIO_RATIO_ADJUST_MAX;
+      else if (adjust < 1.0 - AUDIO_RATIO_ADJUST_MAX)
+         adjust = 1.0 - AUDIO_RATIO_ADJUST_MAX;
+
+      /* Slew-limit the applied factor: the block-to-block pitch step
+       * stays inaudible and large deviations are ramped out over a
+       * few hundred milliseconds instead of jumping per block. */
+      if (adjust > p_rarch->audio_ratio_drift + AUDIO_RATIO_SLEW_STEP)
+         p_rarch->audio_ratio_drift += AUDIO_RATIO_SLEW_STEP;
+      else if (adjust < p_rarch->audio_ratio_drift - AUDIO_RATIO_SLEW_STEP)
+         p_rarch->audio_ratio_drift -= AUDIO_RATIO_SLEW_STEP;
+      else
+         p_rarch->audio_ratio_drift  = adjust;
+
       p_rarch->audio_source_ratio_current   =
-         p_rarch->audio_source_ratio_original * adjust;
+         p_rarch->audio_source_ratio_original *
+         p_rarch->audio_ratio_drift;
+
+      audio_driver_adapt_resampler_quality(p_rarch, avail);
 
 #if 0
       if (verbosity_is_enabled())
@@ -29951,9 +32487,33 @@ static void audio_driver_flush(
    }
 #endif
 
+   if (p_rarch->audio_migrate_fade_frames)
    {
-      const void *output_data = p_rarch->audio_driver_output_samples_buf;
-      unsigned output_frames  = (unsigned)src_data.output_frames;
+      /* Ramp the first blocks written to a freshly migrated
+       * device up from silence (see audio_driver_migrate_device) */
+      float   *out_buf    = p_rarch->audio_driver_output_samples_buf;
+      unsigned fade_total = p_rarch->audio_migrate_fade_total;
+      unsigned fade_done  = fade_total -
+         p_rarch->audio_migrate_fade_frames;
+      size_t i;
+
+      for (i = 0;
+            i < src_data.output_frames &&
+            p_rarch->audio_migrate_fade_frames;
+            i++)
+      {
+         float gain          = (float)(fade_done + i)
+            / (float)fade_total;
+         out_buf[2 * i]     *= gain;
+         out_buf[2 * i + 1] *= gain;
+         p_rarch->audio_migrate_fade_frames--;
+      }
+   }
+
+   {
+      const void *output_data    = p_rarch->audio_driver_output_samples_buf;
+      unsigned output_frames     = (unsigned)src_data.output_frames;
+      retro_time_t write_start   = 0;
 
       if (p_rarch->audio_driver_use_float)
          output_frames       *= sizeof(float);
@@ -29966,10 +32526,17 @@ static void audio_driver_flush(
          output_frames       *= sizeof(int16_t);
       }
 
+      /* The write blocks when the device buffer is full -
+       * that wait is what the audio slot is meant to catch */
+      write_start             = cpu_features_get_time_usec();
+
       if (p_rarch->current_audio->write(
                p_rarch->audio_driver_context_audio_data,
                output_data, output_frames * 2) < 0)
          p_rarch->audio_driver_active = false;
+
+      frame_timeline_add(p_rarch, FRAME_TIMELINE_AUDIO,
+            cpu_features_get_time_usec() - write_start);
    }
 }
 
@@ -30898,6 +33465,9 @@ static void audio_driver_monitor_set_rate(struct rarch_state *p_rarch)
 
    p_rarch->audio_source_ratio_original = new_src_ratio;
    p_rarch->audio_source_ratio_current  = new_src_ratio;
+   p_rarch->audio_ratio_drift           = 1.0;
+   p_rarch->audio_flush_interval_avg    = 0.0;
+   p_rarch->audio_last_flush_time       = 0;
 }
 
 bool audio_driver_callback(void)
@@ -31444,10 +34014,12 @@ static void video_driver_filter_free(void)
 #ifdef _3DS
       linearFree(p_rarch->video_driver_state_buffer);
 #else
-      free(p_rarch->video_driver_state_buffer);
+      memalign_free_big(p_rarch->video_driver_state_buffer,
+            p_rarch->video_driver_state_buffer_size);
 #endif
    }
-   p_rarch->video_driver_state_buffer    = NULL;
+   p_rarch->video_driver_state_buffer      = NULL;
+   p_rarch->video_driver_state_buffer_size = 0;
 
    p_rarch->video_driver_state_scale     = 0;
    p_rarch->video_driver_state_out_bpp   = 0;
@@ -31517,12 +34089,13 @@ static void video_driver_init_filter(enum retro_pixel_format colfmt_int)
       sizeof(uint32_t)             :
       sizeof(uint16_t);
 
-   /* TODO: Aligned output. */
 #ifdef _3DS
    buf = linearMemAlign(
          width * height * p_rarch->video_driver_state_out_bpp, 0x80);
 #else
-   buf = malloc(
+   /* The filter output is rewritten every frame - back it
+    * with huge pages where available to cut TLB pressure */
+   buf = memalign_alloc_big(
          width * height * p_rarch->video_driver_state_out_bpp);
 #endif
    if (!buf)
@@ -31532,7 +34105,9 @@ static void video_driver_init_filter(enum retro_pixel_format colfmt_int)
       return;
    }
 
-   p_rarch->video_driver_state_buffer    = buf;
+   p_rarch->video_driver_state_buffer      = buf;
+   p_rarch->video_driver_state_buffer_size =
+         width * height * p_rarch->video_driver_state_out_bpp;
 }
 #endif
 
@@ -31603,10 +34178,12 @@ static void video_driver_pixel_converter_free(
       free(p_rarch->video_driver_scaler_ptr->scaler);
    }
    if (p_rarch->video_driver_scaler_ptr->scaler_out)
-      free(p_rarch->video_driver_scaler_ptr->scaler_out);
+      memalign_free_big(p_rarch->video_driver_scaler_ptr->scaler_out,
+            p_rarch->video_driver_scaler_ptr->scaler_out_size);
 
-   p_rarch->video_driver_scaler_ptr->scaler     = NULL;
-   p_rarch->video_driver_scaler_ptr->scaler_out = NULL;
+   p_rarch->video_driver_scaler_ptr->scaler          = NULL;
+   p_rarch->video_driver_scaler_ptr->scaler_out      = NULL;
+   p_rarch->video_driver_scaler_ptr->scaler_out_size = 0;
 
    free(p_rarch->video_driver_scaler_ptr);
 
@@ -31712,6 +34289,7 @@ static bool video_driver_pixel_converter_init(
 
    scalr->scaler                            = NULL;
    scalr->scaler_out                        = NULL;
+   scalr->scaler_out_size                   = 0;
 
    p_rarch->video_driver_scaler_ptr         = scalr;
 
@@ -31730,12 +34308,16 @@ static bool video_driver_pixel_converter_init(
    if (!scaler_ctx_gen_filter(scalr_ctx))
       goto error;
 
-   scalr_out = calloc(sizeof(uint16_t), size * size);
+   scalr_out = memalign_alloc_big(sizeof(uint16_t) * size * size);
 
    if (!scalr_out)
       goto error;
 
+   memset(scalr_out, 0, sizeof(uint16_t) * size * size);
+
    p_rarch->video_driver_scaler_ptr->scaler_out          = scalr_out;
+   p_rarch->video_driver_scaler_ptr->scaler_out_size     =
+         sizeof(uint16_t) * size * size;
 
    return true;
 
@@ -31999,6 +34581,10 @@ static bool video_driver_init_internal(bool *video_is_threaded)
       p_rarch->current_video->poke_interface(
             p_rarch->video_driver_data, &p_rarch->video_driver_poke);
 
+#ifdef HAVE_VIDEO_FILTER
+   p_rarch->video_driver_core_sw_framebuffer = false;
+#endif
+
    if (p_rarch->current_video->viewport_info &&
          (!custom_vp->width  ||
           !custom_vp->height))
@@ -33032,6 +35618,127 @@ unsigned video_pixel_get_alignment(unsigned pitch)
  *
  * Video frame render callback function.
  **/
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+static void frame_export_deinit(struct rarch_state *p_rarch)
+{
+   if (p_rarch->frame_export_header)
+   {
+#ifdef _WIN32
+      UnmapViewOfFile(p_rarch->frame_export_header);
+      CloseHandle(p_rarch->frame_export_handle);
+      p_rarch->frame_export_handle = NULL;
+#else
+      munmap(p_rarch->frame_export_header,
+            sizeof(frame_export_header_t) +
+            2 * p_rarch->frame_export_buffer_size);
+      shm_unlink(FRAME_EXPORT_SHM_NAME);
+#endif
+   }
+   p_rarch->frame_export_header      = NULL;
+   p_rarch->frame_export_buffer_size = 0;
+}
+
+static bool frame_export_init(struct rarch_state *p_rarch,
+      size_t buffer_size)
+{
+   size_t total                  =
+      sizeof(frame_export_header_t) + 2 * buffer_size;
+   frame_export_header_t *header = NULL;
+#ifdef _WIN32
+   HANDLE handle                 = CreateFileMappingA(
+         INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+         0, (DWORD)total, FRAME_EXPORT_SHM_NAME);
+   if (!handle)
+      return false;
+
+   header = (frame_export_header_t*)MapViewOfFile(handle,
+         FILE_MAP_ALL_ACCESS, 0, 0, total);
+   if (!header)
+   {
+      CloseHandle(handle);
+      return false;
+   }
+   p_rarch->frame_export_handle = handle;
+#else
+   int fd = shm_open(FRAME_EXPORT_SHM_NAME, O_CREAT | O_RDWR, 0644);
+   if (fd < 0)
+      return false;
+
+   if (ftruncate(fd, (off_t)total) < 0)
+   {
+      close(fd);
+      shm_unlink(FRAME_EXPORT_SHM_NAME);
+      return false;
+   }
+
+   header = (frame_export_header_t*)mmap(NULL, total,
+         PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   /* The mapping keeps the object alive; the fd is not needed */
+   close(fd);
+   if (header == MAP_FAILED)
+   {
+      shm_unlink(FRAME_EXPORT_SHM_NAME);
+      return false;
+   }
+#endif
+
+   memset(header, 0, sizeof(*header));
+   header->buffer_size = (uint32_t)buffer_size;
+   header->version     = FRAME_EXPORT_VERSION;
+   /* Written last so readers never see a half-built region */
+   header->magic       = FRAME_EXPORT_MAGIC;
+
+   p_rarch->frame_export_header      = header;
+   p_rarch->frame_export_buffer_size = buffer_size;
+
+   RARCH_LOG("[Frame export]: Publishing frames to \"%s\" (2x%u bytes).\n",
+         FRAME_EXPORT_SHM_NAME, (unsigned)buffer_size);
+
+   return true;
+}
+
+/**
+ * frame_export_publish:
+ *
+ * Copies the frame into the back buffer of the shared-memory
+ * region (see frame_export.h for the layout and reader protocol)
+ * and flips it to the front. The region is created lazily on the
+ * first frame and resized when a frame outgrows it.
+ **/
+static void frame_export_publish(struct rarch_state *p_rarch,
+      const void *data, unsigned width, unsigned height, size_t pitch,
+      enum retro_pixel_format format)
+{
+   frame_export_header_t *header = p_rarch->frame_export_header;
+   size_t size                   = pitch * height;
+   uint32_t next;
+   uint8_t *dest;
+
+   if (!header || size > p_rarch->frame_export_buffer_size)
+   {
+      frame_export_deinit(p_rarch);
+      /* Pad the allocation so moderate geometry changes do not
+       * force readers to remap every time */
+      if (!frame_export_init(p_rarch, size + (size >> 2)))
+         return;
+      header = p_rarch->frame_export_header;
+   }
+
+   next = header->buffer_index ? 0 : 1;
+   dest = (uint8_t*)(header + 1) +
+      (size_t)next * p_rarch->frame_export_buffer_size;
+
+   memcpy(dest, data, size);
+
+   header->format       = (uint32_t)format;
+   header->width        = width;
+   header->height       = height;
+   header->pitch        = (uint32_t)pitch;
+   header->buffer_index = next;
+   header->frame_count++;
+}
+#endif
+
 static void video_driver_frame(const void *data, unsigned width,
       unsigned height, size_t pitch)
 {
@@ -33039,6 +35746,7 @@ static void video_driver_frame(const void *data, unsigned width,
    static char video_driver_msg[256];
    static retro_time_t curr_time;
    static retro_time_t fps_time;
+   static retro_time_t last_ui_render_time;
    static float last_fps, frame_time;
    static uint64_t last_used_memory, last_total_memory;
    retro_time_t new_time;
@@ -33046,6 +35754,7 @@ static void video_driver_frame(const void *data, unsigned width,
    struct rarch_state *p_rarch  = &rarch_st;
    const enum retro_pixel_format
       video_driver_pix_fmt      = p_rarch->video_driver_pix_fmt;
+   bool ui_throttled            = false;
    bool runloop_idle            = p_rarch->runloop_idle;
    bool video_driver_active     = p_rarch->video_driver_active;
    settings_t *settings         = p_rarch->configuration_settings;
@@ -33067,6 +35776,70 @@ static void video_driver_frame(const void *data, unsigned width,
    p_rarch->frame_cache_height  = height;
    p_rarch->frame_cache_pitch   = pitch;
 
+   /* Duplicate-frame elision: cores running below the display rate
+    * and paused/static screens resubmit an unchanged buffer over and
+    * over. Hashing the software framebuffer is much cheaper than
+    * converting, filtering and re-uploading it, so when the content
+    * has not changed the frame is forwarded as a dupe (data == NULL)
+    * and the driver re-presents its cached image - the same path
+    * cores use when they signal dupes themselves. Temporal
+    * softfilters consequently see static content freeze, which
+    * matches what the explicit dupe signal already does. Opt-in,
+    * since the hash costs CPU on every frame; also disabled while
+    * recording or exporting frames (those consume every submission)
+    * and for buffers large enough that the hash itself would eat a
+    * noticeable slice of the frame budget. */
+   if (      settings->bools.video_frame_dupe_elision
+         &&  data
+         && (data != RETRO_HW_FRAME_BUFFER_VALID)
+         && !p_rarch->recording_data
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+         && !settings->bools.video_frame_export
+#endif
+         && ((size_t)height * pitch) <= (2 * 1024 * 1024))
+   {
+      static uint64_t last_frame_hash        = 0;
+      static unsigned last_frame_hash_width  = 0;
+      static unsigned last_frame_hash_height = 0;
+      static size_t   last_frame_hash_pitch  = 0;
+      uint64_t hash                          = 0xcbf29ce484222325ULL;
+      const uint8_t *src                     = (const uint8_t*)data;
+      size_t row_len                         = (size_t)width *
+         ((video_driver_pix_fmt == RETRO_PIXEL_FORMAT_XRGB8888) ? 4 : 2);
+      unsigned y;
+
+      if (row_len > pitch)
+         row_len = pitch;
+
+      /* FNV-1a folded over 8-byte chunks - a few hundred
+       * microseconds at worst for the sizes admitted above */
+      for (y = 0; y < height; y++, src += pitch)
+      {
+         size_t x;
+         for (x = 0; x + 8 <= row_len; x += 8)
+         {
+            uint64_t chunk;
+            memcpy(&chunk, src + x, sizeof(chunk));
+            hash = (hash ^ chunk) * 0x100000001b3ULL;
+         }
+         for (; x < row_len; x++)
+            hash = (hash ^ src[x]) * 0x100000001b3ULL;
+      }
+
+      if (      hash   == last_frame_hash
+            &&  width  == last_frame_hash_width
+            &&  height == last_frame_hash_height
+            &&  pitch  == last_frame_hash_pitch)
+         data = NULL;
+      else
+      {
+         last_frame_hash        = hash;
+         last_frame_hash_width  = width;
+         last_frame_hash_height = height;
+         last_frame_hash_pitch  = pitch;
+      }
+   }
+
    if (
             p_rarch->video_driver_scaler_ptr
          && data
@@ -33239,17 +36012,45 @@ static void video_driver_frame(const void *data, unsigned width,
 #ifdef HAVE_VIDEO_FILTER
    if (data && p_rarch->video_driver_state_filter)
    {
+      struct retro_framebuffer fb;
       unsigned output_width                             = 0;
       unsigned output_height                            = 0;
       unsigned output_pitch                             = 0;
+      void *output_data                                 =
+         p_rarch->video_driver_state_buffer;
 
       rarch_softfilter_get_output_size(p_rarch->video_driver_state_filter,
             &output_width, &output_height, width, height);
 
       output_pitch = (output_width) * p_rarch->video_driver_state_out_bpp;
 
+      /* If the driver exposes a persistently mapped software
+       * framebuffer (and the core is not using it itself), render the
+       * filter directly into it - the driver then skips copying the
+       * filtered frame into staging memory. Skipped while recording
+       * filtered output: mapped memory is usually write-combined and
+       * slow to read back. */
+      if (      !p_rarch->video_driver_core_sw_framebuffer
+            && !(video_info.post_filter_record && p_rarch->recording_data)
+            &&  p_rarch->video_driver_poke
+            &&  p_rarch->video_driver_poke->get_current_software_framebuffer)
+      {
+         fb.width        = output_width;
+         fb.height       = output_height;
+         fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+
+         if (p_rarch->video_driver_poke->get_current_software_framebuffer(
+                  p_rarch->video_driver_data, &fb)
+               && fb.format == (p_rarch->video_driver_state_out_rgb32
+                  ? RETRO_PIXEL_FORMAT_XRGB8888 : RETRO_PIXEL_FORMAT_RGB565))
+         {
+            output_data  = fb.data;
+            output_pitch = (unsigned)fb.pitch;
+         }
+      }
+
       rarch_softfilter_process(p_rarch->video_driver_state_filter,
-            p_rarch->video_driver_state_buffer, output_pitch,
+            output_data, output_pitch,
             data, width, height, pitch);
 
       if (video_info.post_filter_record
@@ -33257,17 +36058,69 @@ static void video_driver_frame(const void *data, unsigned width,
             && p_rarch->recording_driver
             && p_rarch->recording_driver->push_video)
          recording_dump_frame(p_rarch,
-               p_rarch->video_driver_state_buffer,
+               output_data,
                output_width, output_height, output_pitch,
                runloop_idle);
 
-      data   = p_rarch->video_driver_state_buffer;
+      data   = output_data;
       width  = output_width;
       height = output_height;
       pitch  = output_pitch;
    }
 #endif
 
+#if defined(_WIN32) || defined(__unix__) || defined(__APPLE__)
+   if (      settings->bools.video_frame_export
+         &&  data
+         && (data != RETRO_HW_FRAME_BUFFER_VALID))
+   {
+      enum retro_pixel_format export_fmt = video_driver_pix_fmt;
+
+#ifdef HAVE_VIDEO_FILTER
+      if (p_rarch->video_driver_state_filter)
+         export_fmt = p_rarch->video_driver_state_out_rgb32
+            ? RETRO_PIXEL_FORMAT_XRGB8888 : RETRO_PIXEL_FORMAT_RGB565;
+      else
+#endif
+      if (     p_rarch->video_driver_scaler_ptr
+            && (export_fmt == RETRO_PIXEL_FORMAT_0RGB1555))
+         export_fmt = RETRO_PIXEL_FORMAT_RGB565; /* scaled above */
+
+      frame_export_publish(p_rarch, data, width, height, pitch,
+            export_fmt);
+   }
+   else if (p_rarch->frame_export_header)
+      frame_export_deinit(p_rarch);
+#endif
+
+   /* During fast-forward the core pushes frames far above the
+    * display rate, and rendering widgets and OSD text for every
+    * one of them throttles CPU-bound cores noticeably. Keep the
+    * UI on its own clock instead: render it at (roughly) display
+    * rate and skip the UI pass for the frames in between. */
+   if (p_rarch->runloop_fastmotion)
+   {
+      float refresh_hz           = video_info.refresh_rate;
+      retro_time_t ui_interval;
+
+      if (refresh_hz <= 0.0f)
+         refresh_hz              = 60.0f;
+      ui_interval                = (retro_time_t)(1000000.0f / refresh_hz);
+
+      if (new_time - last_ui_render_time < ui_interval)
+      {
+         ui_throttled                  = true;
+         video_info.statistics_show    = false;
+#if defined(HAVE_GFX_WIDGETS)
+         video_info.widgets_active     = false;
+#endif
+      }
+      else
+         last_ui_render_time           = new_time;
+   }
+   else
+      last_ui_render_time              = new_time;
+
    if (p_rarch->runloop_msg_queue_size > 0)
    {
       /* If widgets are currently enabled, then
@@ -33308,10 +36161,12 @@ static void video_driver_frame(const void *data, unsigned width,
             );
       }
       /* ...otherwise, just output message via
-       * regular OSD notification text (if enabled) */
-      else if (video_info.font_enable)
+       * regular OSD notification text (if enabled).
+       * On UI-throttled frames the message stays queued
+       * for the next rendered UI pass. */
+      else if (video_info.font_enable && !ui_throttled)
 #else
-      if (video_info.font_enable)
+      if (video_info.font_enable && !ui_throttled)
 #endif
       {
          const char *msg                 = NULL;
@@ -33381,15 +36236,143 @@ static void video_driver_frame(const void *data, unsigned width,
             av_info->timing.fps,
             av_info->timing.sample_rate);
 
+      if (     p_rarch->current_audio
+            && p_rarch->current_audio->device_latency
+            && p_rarch->audio_driver_context_audio_data)
+      {
+         size_t latency_frames = p_rarch->current_audio->device_latency(
+               p_rarch->audio_driver_context_audio_data);
+         unsigned out_rate     =
+            p_rarch->configuration_settings->uints.audio_out_rate;
+
+         if (latency_frames && out_rate)
+         {
+            size_t written = strlen(video_info.stat_text);
+            snprintf(video_info.stat_text + written,
+                  sizeof(video_info.stat_text) - written,
+                  " -Measured device latency: %.1f ms\n",
+                  (double)latency_frames * 1000.0 / out_rate);
+         }
+      }
+
+      {
+         float ft_p50        = 0.0f;
+         float ft_p95        = 0.0f;
+         float ft_p99        = 0.0f;
+         uint64_t ft_hitches = 0;
+         uint64_t ft_frames  = 0;
+
+         if (frame_timeline_stats(p_rarch,
+                  &ft_p50, &ft_p95, &ft_p99, &ft_hitches, &ft_frames))
+         {
+            size_t written = strlen(video_info.stat_text);
+            snprintf(video_info.stat_text + written,
+                  sizeof(video_info.stat_text) - written,
+                  "Frame Timeline:\n -p50/p95/p99: %.1f / %.1f / %.1f ms\n"
+                  " -Hitches: %" PRIu64 " of %" PRIu64 " frames\n",
+                  ft_p50, ft_p95, ft_p99,
+                  ft_hitches, ft_frames);
+         }
+      }
+
+      if (input_latency_samples)
+      {
+         size_t written = strlen(video_info.stat_text);
+         snprintf(video_info.stat_text + written,
+               sizeof(video_info.stat_text) - written,
+               "Input Latency:\n -Last: %.1f ms\n -Avg: %.1f ms\n"
+               " -Min/Max: %.1f / %.1f ms\n -Samples: %" PRIu64 "\n",
+               input_latency_last_us / 1000.0f,
+               (float)(input_latency_total_us
+                     / (double)input_latency_samples / 1000.0),
+               input_latency_min_us / 1000.0f,
+               input_latency_max_us / 1000.0f,
+               input_latency_samples);
+      }
+
+      if (vrr_pace_samples)
+      {
+         size_t written = strlen(video_info.stat_text);
+         snprintf(video_info.stat_text + written,
+               sizeof(video_info.stat_text) - written,
+               "VRR Pacing:\n -Wake error last/avg/max: %.2f / %.2f / %.2f ms\n"
+               " -Overruns: %" PRIu64 " of %" PRIu64 " frames\n",
+               vrr_pace_error_last_us / 1000.0f,
+               (float)(vrr_pace_error_total_us
+                     / (double)vrr_pace_samples / 1000.0),
+               vrr_pace_error_max_us / 1000.0f,
+               vrr_pace_overruns,
+               vrr_pace_samples);
+      }
+
+#ifdef HAVE_THREADS
+      if (VIDEO_DRIVER_IS_THREADED_INTERNAL())
+      {
+         unsigned frames_pushed   = 0;
+         unsigned frames_replaced = 0;
+
+         if (video_thread_frame_stats(&frames_pushed, &frames_replaced))
+         {
+            size_t written = strlen(video_info.stat_text);
+            snprintf(video_info.stat_text + written,
+                  sizeof(video_info.stat_text) - written,
+                  "Threaded Video:\n -Frames pushed: %u\n -Frames replaced: %u\n",
+                  frames_pushed, frames_replaced);
+         }
+      }
+#endif
+
+      if (     p_rarch->video_driver_poke
+            && p_rarch->video_driver_poke->get_shader_pass_profile)
+      {
+         size_t written = strlen(video_info.stat_text);
+         if (!p_rarch->video_driver_poke->get_shader_pass_profile(
+                  p_rarch->video_driver_data,
+                  video_info.stat_text + written,
+                  sizeof(video_info.stat_text) - written))
+            video_info.stat_text[written] = '\0';
+      }
+
       /* TODO/FIXME - add OSD chat text here */
    }
 
+   /* Pacing gate for inserted refreshes (black frame insertion /
+    * frame duplication): when the core overran its frame budget,
+    * the extra present would block on the next vblank and push the
+    * already-late frame a full refresh further out. Skip the
+    * insertion for this frame and let the cadence resynchronise. */
+   if (video_info.black_frame_insertion || video_info.frame_duplication)
+   {
+      if (     p_rarch->video_driver_core_hz > 0.0f
+            && p_rarch->video_driver_frame_count
+            && frame_time >
+               (1000000.0f / p_rarch->video_driver_core_hz) * 1.5f)
+      {
+         video_info.black_frame_insertion = false;
+         video_info.frame_duplication     = false;
+      }
+      else if (video_info.frame_duplication)
+         /* Duplication takes priority - never do both. */
+         video_info.black_frame_insertion = false;
+   }
+
    if (p_rarch->current_video && p_rarch->current_video->frame)
+   {
+      /* With threaded video this measures the submit to the
+       * video thread rather than the present itself */
+      retro_time_t present_start   = cpu_features_get_time_usec();
+
       p_rarch->video_driver_active = p_rarch->current_video->frame(
             p_rarch->video_driver_data, data, width, height,
             p_rarch->video_driver_frame_count,
             (unsigned)pitch, video_driver_msg, &video_info);
 
+      frame_timeline_add(p_rarch, FRAME_TIMELINE_VIDEO,
+            cpu_features_get_time_usec() - present_start);
+
+      input_latency_probe_present();
+   }
+
    p_rarch->video_driver_frame_count++;
 
    /* Display the status text, with a higher priority. */
@@ -33555,6 +36538,7 @@ void video_driver_build_info(video_frame_info_t *video_info)
    video_info->crt_switch_center_adjust    = settings->ints.crt_switch_center_adjust;
    video_info->crt_switch_porch_adjust    = settings->ints.crt_switch_porch_adjust;
    video_info->black_frame_insertion       = settings->bools.video_black_frame_insertion;
+   video_info->frame_duplication           = settings->bools.video_frame_duplication;
    video_info->hard_sync                   = settings->bools.video_hard_sync;
    video_info->hard_sync_frames            = settings->uints.video_hard_sync_frames;
    video_info->fps_show                    = settings->bools.video_fps_show;
@@ -35003,6 +37987,7 @@ static void drivers_init(struct rarch_state *p_rarch, int flags)
  **/
 static void driver_uninit(struct rarch_state *p_rarch, int flags)
 {
+   retroarch_core_info_task_wait(p_rarch);
    core_info_deinit_list();
    core_info_free_current_core(&p_rarch->core_info_st);
 
@@ -35022,6 +38007,8 @@ static void driver_uninit(struct rarch_state *p_rarch, int flags)
 #endif
 
       menu_driver_ctl(RARCH_MENU_CTL_DEINIT, NULL);
+
+      gfx_thumbnail_cache_purge();
    }
 #endif
 
@@ -35360,9 +38347,15 @@ static void input_state_set_last(unsigned port, unsigned device,
       unsigned index, unsigned id, int16_t value)
 {
    unsigned i;
+   bool found                  = false;
    input_list_element *element = NULL;
    struct rarch_state *p_rarch = &rarch_st;
 
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   if (p_rarch->runahead_input_lock)
+      slock_lock(p_rarch->runahead_input_lock);
+#endif
+
    if (!p_rarch->input_state_list)
       mylist_create(&p_rarch->input_state_list, 16,
             input_list_element_constructor,
@@ -35380,45 +38373,65 @@ static void input_state_set_last(unsigned port, unsigned device,
          if (id >= element->state_size)
             input_list_element_expand(element, id);
          element->state[id] = value;
-         return;
+         found              = true;
+         break;
       }
    }
 
-   element            = (input_list_element*)
-      mylist_add_element(p_rarch->input_state_list);
-   element->port      = port;
-   element->device    = device;
-   element->index     = index;
-   if (id >= element->state_size)
-      input_list_element_expand(element, id);
-   element->state[id] = value;
+   if (!found)
+   {
+      element            = (input_list_element*)
+         mylist_add_element(p_rarch->input_state_list);
+      element->port      = port;
+      element->device    = device;
+      element->index     = index;
+      if (id >= element->state_size)
+         input_list_element_expand(element, id);
+      element->state[id] = value;
+   }
+
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   if (p_rarch->runahead_input_lock)
+      slock_unlock(p_rarch->runahead_input_lock);
+#endif
 }
 
 static int16_t input_state_get_last(unsigned port,
       unsigned device, unsigned index, unsigned id)
 {
    unsigned i;
+   int16_t res                      = 0;
    struct rarch_state      *p_rarch = &rarch_st;
 
-   if (!p_rarch->input_state_list)
-      return 0;
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   if (p_rarch->runahead_input_lock)
+      slock_lock(p_rarch->runahead_input_lock);
+#endif
 
-   /* find list item */
-   for (i = 0; i < (unsigned)p_rarch->input_state_list->size; i++)
+   if (p_rarch->input_state_list)
    {
-      input_list_element *element =
-         (input_list_element*)p_rarch->input_state_list->data[i];
-
-      if (  (element->port   == port)   &&
-            (element->device == device) &&
-            (element->index  == index))
+      /* find list item */
+      for (i = 0; i < (unsigned)p_rarch->input_state_list->size; i++)
       {
-         if (id < element->state_size)
-            return element->state[id];
-         return 0;
+         input_list_element *element =
+            (input_list_element*)p_rarch->input_state_list->data[i];
+
+         if (  (element->port   == port)   &&
+               (element->device == device) &&
+               (element->index  == index))
+         {
+            if (id < element->state_size)
+               res = element->state[id];
+            break;
+         }
       }
    }
-   return 0;
+
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   if (p_rarch->runahead_input_lock)
+      slock_unlock(p_rarch->runahead_input_lock);
+#endif
+   return res;
 }
 
 static int16_t input_state_with_logging(unsigned port,
@@ -35533,7 +38546,10 @@ static void *runahead_save_state_alloc(void)
    if (  (p_rarch->runahead_save_state_size > 0) &&
          p_rarch->runahead_save_state_size_known)
    {
-      savestate->data       = malloc(p_rarch->runahead_save_state_size);
+      /* Rewritten every frame by core_serialize - worth
+       * hugepage backing on platforms that offer it. */
+      savestate->data       = memalign_alloc_big(
+            p_rarch->runahead_save_state_size);
       savestate->data_const = savestate->data;
       savestate->size       = p_rarch->runahead_save_state_size;
    }
@@ -35546,7 +38562,7 @@ static void runahead_save_state_free(void *data)
    retro_ctx_serialize_info_t *savestate = (retro_ctx_serialize_info_t*)data;
    if (!savestate)
       return;
-   free(savestate->data);
+   memalign_free_big(savestate->data, savestate->size);
    free(savestate);
 }
 
@@ -35561,6 +38577,10 @@ static void runahead_save_state_list_init(
          runahead_save_state_alloc, runahead_save_state_free);
 }
 
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+static void runahead_thread_deinit(struct rarch_state *p_rarch);
+#endif
+
 /* Hooks - Hooks to cleanup, and add dirty input hooks */
 static void runahead_remove_hooks(struct rarch_state *p_rarch)
 {
@@ -35580,6 +38600,10 @@ static void runahead_remove_hooks(struct rarch_state *p_rarch)
 
 static void runahead_destroy(struct rarch_state *p_rarch)
 {
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+   runahead_thread_deinit(p_rarch);
+   p_rarch->runahead_thread_failed = false;
+#endif
    mylist_destroy(&p_rarch->runahead_save_state_list);
    runahead_remove_hooks(p_rarch);
    runahead_clear_variables(p_rarch);
@@ -35753,6 +38777,145 @@ static bool runahead_core_run_use_last_input(struct rarch_state *p_rarch)
    return true;
 }
 
+#if HAVE_DYNAMIC && defined(HAVE_THREADS)
+static void runahead_video_frame_null(const void *data,
+      unsigned width, unsigned height, size_t pitch) { }
+static void runahead_audio_sample_null(int16_t left, int16_t right) { }
+static size_t runahead_audio_sample_batch_null(
+      const int16_t *data, size_t frames) { return frames; }
+
+/* Runs the primary core whenever the main thread requests
+ * it. Video is suppressed through the core's own refresh
+ * callback rather than video_driver_active, since the
+ * secondary instance on the main thread needs that flag
+ * for the presented frame. */
+static void runahead_worker_thread(void *data)
+{
+   struct rarch_state *p_rarch = (struct rarch_state*)data;
+
+   slock_lock(p_rarch->runahead_thread_lock);
+
+   while (!p_rarch->runahead_thread_exit)
+   {
+      if (!p_rarch->runahead_thread_run_requested)
+      {
+         scond_wait(p_rarch->runahead_thread_cond,
+               p_rarch->runahead_thread_lock);
+         continue;
+      }
+      slock_unlock(p_rarch->runahead_thread_lock);
+
+      p_rarch->current_core.retro_set_video_refresh(
+            runahead_video_frame_null);
+      core_run();
+      p_rarch->current_core.retro_set_video_refresh(
+            p_rarch->retro_ctx.frame_cb);
+
+      slock_lock(p_rarch->runahead_thread_lock);
+      p_rarch->runahead_thread_run_requested = false;
+      scond_signal(p_rarch->runahead_thread_cond);
+   }
+
+   slock_unlock(p_rarch->runahead_thread_lock);
+}
+
+static void runahead_thread_deinit(struct rarch_state *p_rarch)
+{
+   if (p_rarch->runahead_thread)
+   {
+      slock_lock(p_rarch->runahead_thread_lock);
+      p_rarch->runahead_thread_exit = true;
+      scond_signal(p_rarch->runahead_thread_cond);
+      slock_unlock(p_rarch->runahead_thread_lock);
+      sthread_join(p_rarch->runahead_thread);
+      p_rarch->runahead_thread      = NULL;
+   }
+   if (p_rarch->runahead_thread_lock)
+      slock_free(p_rarch->runahead_thread_lock);
+   if (p_rarch->runahead_thread_cond)
+      scond_free(p_rarch->runahead_thread_cond);
+   if (p_rarch->runahead_input_lock)
+      slock_free(p_rarch->runahead_input_lock);
+   p_rarch->runahead_thread_lock          = NULL;
+   p_rarch->runahead_thread_cond          = NULL;
+   p_rarch->runahead_input_lock           = NULL;
+   p_rarch->runahead_thread_run_requested = false;
+   p_rarch->runahead_thread_exit          = false;
+}
+
+static bool runahead_thread_init(struct rarch_state *p_rarch)
+{
+   if (p_rarch->runahead_thread)
+      return true;
+   if (p_rarch->runahead_thread_failed)
+      return false;
+
+   p_rarch->runahead_thread_lock = slock_new();
+   p_rarch->runahead_thread_cond = scond_new();
+   p_rarch->runahead_input_lock  = slock_new();
+
+   if (     p_rarch->runahead_thread_lock
+         && p_rarch->runahead_thread_cond
+         && p_rarch->runahead_input_lock)
+      p_rarch->runahead_thread   = sthread_create(
+            runahead_worker_thread, p_rarch);
+
+   if (!p_rarch->runahead_thread)
+   {
+      /* Don't retry every frame; run-ahead falls back to
+       * the serial path. */
+      runahead_thread_deinit(p_rarch);
+      p_rarch->runahead_thread_failed = true;
+      return false;
+   }
+
+   return true;
+}
+
+static void runahead_thread_kick(struct rarch_state *p_rarch)
+{
+   slock_lock(p_rarch->runahead_thread_lock);
+   p_rarch->runahead_thread_run_requested = true;
+   scond_signal(p_rarch->runahead_thread_cond);
+   slock_unlock(p_rarch->runahead_thread_lock);
+}
+
+static void runahead_thread_wait(struct rarch_state *p_rarch)
+{
+   slock_lock(p_rarch->runahead_thread_lock);
+   while (p_rarch->runahead_thread_run_requested)
+      scond_wait(p_rarch->runahead_thread_cond,
+            p_rarch->runahead_thread_lock);
+   slock_unlock(p_rarch->runahead_thread_lock);
+}
+
+/* Like RUNAHEAD_RUN_SECONDARY(), but suppresses audio by
+ * swapping the secondary instance's own callbacks instead of
+ * the global suspension flags - those belong to the primary
+ * core, which may be running concurrently on the worker. */
+static bool secondary_core_run_pipelined(struct rarch_state *p_rarch)
+{
+   bool ok;
+
+   p_rarch->secondary_core.retro_set_audio_sample(
+         runahead_audio_sample_null);
+   p_rarch->secondary_core.retro_set_audio_sample_batch(
+         runahead_audio_sample_batch_null);
+
+   ok = secondary_core_run_use_last_input(p_rarch);
+
+   if (ok)
+   {
+      p_rarch->secondary_core.retro_set_audio_sample(
+            p_rarch->secondary_callbacks.sample_cb);
+      p_rarch->secondary_core.retro_set_audio_sample_batch(
+            p_rarch->secondary_callbacks.sample_batch_cb);
+   }
+
+   return ok;
+}
+#endif
+
 static void do_runahead(
       struct rarch_state *p_rarch,
       int runahead_count, bool use_secondary)
@@ -35840,6 +39003,18 @@ static void do_runahead(
    else
    {
 #if HAVE_DYNAMIC
+#ifdef HAVE_THREADS
+      settings_t *settings = p_rarch->configuration_settings;
+      bool pipelined       = false;
+      /* Pipelined mode is opt-in: both instances issue environment
+       * calls into shared frontend state, so it is only safe with
+       * cores known to tolerate the overlap. It is also refused
+       * outright for hardware-rendered cores - nulling the video
+       * callback doesn't stop a HW core from doing GPU work inside
+       * retro_run, and that work must stay on the context thread. */
+      bool allow_pipelined = settings->bools.run_ahead_pipelined
+            && !video_driver_is_hw_context();
+#endif
       if (!secondary_core_ensure_exists(p_rarch))
       {
          secondary_core_destroy(p_rarch);
@@ -35848,12 +39023,37 @@ static void do_runahead(
          goto force_input_dirty;
       }
 
-      /* run main core with video suspended */
-      p_rarch->video_driver_active     = false;
-      core_run();
-      RUNAHEAD_RESUME_VIDEO();
+#ifdef HAVE_THREADS
+      if (allow_pipelined && runahead_thread_init(p_rarch))
+      {
+         /* Pipelined mode: the primary core advances on the
+          * worker thread while the secondary instance runs
+          * the presented frame speculatively with last
+          * frame's input. If polling turns up new input, the
+          * frame is redone below from the fresh savestate,
+          * which is no worse than the serial path. */
+         pipelined = true;
+         runahead_thread_kick(p_rarch);
+         if (!secondary_core_run_pipelined(p_rarch))
+            p_rarch->runahead_secondary_core_available = false;
+         runahead_thread_wait(p_rarch);
+      }
+      else
+#endif
+      {
+#ifdef HAVE_THREADS
+         /* Pipelining disabled (or no longer allowed) with a
+          * worker left over from earlier - drop it */
+         if (p_rarch->runahead_thread)
+            runahead_thread_deinit(p_rarch);
+#endif
+         /* run main core with video suspended */
+         p_rarch->video_driver_active     = false;
+         core_run();
+         RUNAHEAD_RESUME_VIDEO();
+      }
 
-      if (     p_rarch->input_is_dirty 
+      if (     p_rarch->input_is_dirty
             || p_rarch->runahead_force_input_dirty)
       {
          p_rarch->input_is_dirty       = false;
@@ -35881,6 +39081,15 @@ static void do_runahead(
             RUNAHEAD_RESUME_VIDEO();
          }
       }
+#ifdef HAVE_THREADS
+      else if (pipelined)
+      {
+         /* Clean input - the speculative frame above was
+          * correct and has already been presented. */
+         p_rarch->runahead_force_input_dirty = false;
+         return;
+      }
+#endif
       p_rarch->audio_suspended           = true;
       p_rarch->hard_disable_audio        = true;
       RUNAHEAD_RUN_SECONDARY();
@@ -36114,7 +39323,7 @@ static void retroarch_print_help(const char *arg0)
           "the device (1 to %d).\n", MAX_USERS);
 
    {
-      char buf[2560];
+      char buf[3600];
       buf[0] = '\0';
       strlcpy(buf, "                        Format is PORT:ID, where ID is a number "
             "corresponding to the particular device.\n", sizeof(buf));
@@ -36180,6 +39389,21 @@ static void retroarch_print_help(const char *arg0)
 #endif
       strlcat(buf, "      --load-menu-on-error\n"
             "                        Open menu instead of quitting if specified core or content fails to load.\n", sizeof(buf));
+      strlcat(buf, "      --bench=FILE\n"
+            "                        Benchmark mode: forces the null video/audio drivers, runs \n"
+            "                        unthrottled and writes a JSON performance report to FILE on \n"
+            "                        exit. Combine with --max-frames for a fixed-length run.\n", sizeof(buf));
+      strlcat(buf, "      --input-trace-record=FILE, --input-trace-play=FILE\n"
+            "                        Record core-visible input to FILE, or replay it with \n"
+            "                        frame-exact timing (e.g. under --bench).\n", sizeof(buf));
+      strlcat(buf, "      --load-fast\n"
+            "                        Defer menu driver, playlist loading and presence \n"
+            "                        services until after the first core frame renders. \n"
+            "                        For kiosk setups that boot straight into content.\n", sizeof(buf));
+      strlcat(buf, "      --resume\n"
+            "                        Save the session (core, content, state) on exit and \n"
+            "                        restore it at the next --resume launch when no core \n"
+            "                        or content is given on the command line.\n", sizeof(buf));
       puts(buf);
    }
 }
@@ -36260,6 +39484,11 @@ static void retroarch_parse_input_and_config(
       { "log-file",           1, NULL, RA_OPT_LOG_FILE },
       { "accessibility",      0, NULL, RA_OPT_ACCESSIBILITY},
       { "load-menu-on-error", 0, NULL, RA_OPT_LOAD_MENU_ON_ERROR },
+      { "bench",              1, NULL, RA_OPT_BENCH },
+      { "input-trace-record", 1, NULL, RA_OPT_INPUT_TRACE_RECORD },
+      { "input-trace-play",   1, NULL, RA_OPT_INPUT_TRACE_PLAY },
+      { "load-fast",          0, NULL, RA_OPT_LOAD_FAST },
+      { "resume",             0, NULL, RA_OPT_RESUME },
       { NULL, 0, NULL, 0 }
    };
 
@@ -36763,6 +39992,57 @@ static void retroarch_parse_input_and_config(
                p_rarch->runloop_max_frames  = (unsigned)strtoul(optarg, NULL, 10);
                break;
 
+            case RA_OPT_BENCH:
+               p_rarch->bench_active = true;
+               strlcpy(p_rarch->bench_report_path, optarg,
+                     sizeof(p_rarch->bench_report_path));
+               /* A benchmark run measures the core and the frontend
+                * around it, not the host's display or audio stack -
+                * force the null drivers and drop every pacing source
+                * so the run completes as fast as the CPU allows */
+               configuration_set_string(p_rarch->configuration_settings,
+                     p_rarch->configuration_settings->arrays.video_driver,
+                     "null");
+               configuration_set_string(p_rarch->configuration_settings,
+                     p_rarch->configuration_settings->arrays.audio_driver,
+                     "null");
+               configuration_set_bool(p_rarch->configuration_settings,
+                     p_rarch->configuration_settings->bools.video_vsync,
+                     false);
+               configuration_set_bool(p_rarch->configuration_settings,
+                     p_rarch->configuration_settings->bools.audio_sync,
+                     false);
+               configuration_set_float(p_rarch->configuration_settings,
+                     p_rarch->configuration_settings->floats.fastforward_ratio,
+                     0.0f);
+               break;
+
+            case RA_OPT_INPUT_TRACE_RECORD:
+               p_rarch->input_trace_record   = true;
+               p_rarch->input_trace_playback = false;
+               strlcpy(p_rarch->input_trace_path, optarg,
+                     sizeof(p_rarch->input_trace_path));
+               break;
+
+            case RA_OPT_INPUT_TRACE_PLAY:
+               p_rarch->input_trace_playback = true;
+               p_rarch->input_trace_record   = false;
+               strlcpy(p_rarch->input_trace_path, optarg,
+                     sizeof(p_rarch->input_trace_path));
+               break;
+
+            case RA_OPT_LOAD_FAST:
+               p_rarch->fast_boot_active = true;
+               break;
+
+            case RA_OPT_RESUME:
+#ifdef HAVE_CONFIGFILE
+               p_rarch->resume_session = true;
+#else
+               RARCH_WARN("--resume requires config file support. Ignoring.\n");
+#endif
+               break;
+
             case RA_OPT_MAX_FRAMES_SCREENSHOT:
 #ifdef HAVE_SCREENSHOTS
                p_rarch->runloop_max_frames_screenshot = true;
@@ -36865,6 +40145,27 @@ static void retroarch_parse_input_and_config(
 #endif
    }
 
+#ifdef HAVE_CONFIGFILE
+   if (p_rarch->resume_session)
+   {
+      settings_t *settings = p_rarch->configuration_settings;
+
+      /* The session state rides on the auto-savestate machinery -
+       * force it on for this run regardless of the user setting. */
+      configuration_set_bool(settings,
+            settings->bools.savestate_auto_save, true);
+      configuration_set_bool(settings,
+            settings->bools.savestate_auto_load, true);
+
+      /* Only restore when neither core nor content was given
+       * explicitly - command-line arguments win over the bundle. */
+      if (     !explicit_menu
+            && optind >= argc
+            && p_rarch->current_core_type == CORE_TYPE_DUMMY)
+         retroarch_session_restore(p_rarch);
+   }
+#endif
+
    if (optind < argc)
    {
       bool subsystem_path_is_empty = path_is_empty(RARCH_PATH_SUBSYSTEM);
@@ -36970,6 +40271,46 @@ static void retroarch_validate_cpu_features(void)
 #endif
 }
 
+/**
+ * fast_boot_complete:
+ *
+ * Runs the startup work that --load-fast pushed off the boot critical
+ * path: menu driver, history/favorites playlists and presence services.
+ * Called once, either after the core has produced its first frame or
+ * immediately if the menu is entered before that (e.g. content failed
+ * to load).
+ **/
+static void fast_boot_complete(struct rarch_state *p_rarch)
+{
+   retro_time_t begin_time = cpu_features_get_time_usec();
+
+   /* Clear first - the history/favorites paths below check
+    * this flag to know whether they should defer. */
+   p_rarch->fast_boot_pending = false;
+
+#ifdef HAVE_MENU
+   if (!menu_driver_init(VIDEO_DRIVER_IS_THREADED_INTERNAL()))
+      RARCH_ERR("Unable to init menu driver.\n");
+
+#ifdef HAVE_LIBRETRODB
+   menu_explore_context_init();
+#endif
+#endif
+
+   command_event(CMD_EVENT_HISTORY_INIT, NULL);
+   rarch_favorites_init();
+
+#ifdef HAVE_DISCORD
+   if (command_event(CMD_EVENT_DISCORD_INIT, NULL))
+      discord_is_inited = true;
+#endif
+
+   if (verbosity_is_enabled())
+      RARCH_LOG("[Startup]: Deferred init finished in %d ms (frame %u).\n",
+            (int)((cpu_features_get_time_usec() - begin_time) / 1000),
+            (unsigned)p_rarch->video_driver_frame_count);
+}
+
 /**
  * retroarch_main_init:
  * @argc                 : Count of (commandline) arguments.
@@ -36987,6 +40328,10 @@ bool retroarch_main_init(int argc, char *argv[])
    bool           init_failed   = false;
    struct rarch_state *p_rarch  = &rarch_st;
    global_t            *global  = &p_rarch->g_extern;
+   retro_time_t init_begin_time = cpu_features_get_time_usec();
+   retro_time_t init_config_time= 0;
+   retro_time_t init_core_time  = 0;
+   retro_time_t init_driver_time= 0;
 
    p_rarch->osk_idx             = OSK_LOWERCASE_LATIN;
    p_rarch->video_driver_active = true;
@@ -37006,6 +40351,8 @@ bool retroarch_main_init(int argc, char *argv[])
 
    retroarch_parse_input_and_config(p_rarch, argc, argv);
 
+   init_config_time = cpu_features_get_time_usec();
+
 #ifdef HAVE_ACCESSIBILITY
    if (is_accessibility_enabled(p_rarch))
       accessibility_startup_message(p_rarch);
@@ -37067,6 +40414,11 @@ bool retroarch_main_init(int argc, char *argv[])
    retroarch_validate_cpu_features();
    retroarch_init_task_queue();
 
+   /* Kick off the core info scan early so that - with a
+    * threaded task queue - it runs while the video context
+    * and remaining drivers come up */
+   retroarch_core_info_task_push(p_rarch);
+
    {
       const char    *fullpath  = path_get(RARCH_PATH_CONTENT);
 
@@ -37164,11 +40516,23 @@ bool retroarch_main_init(int argc, char *argv[])
          goto error;
    }
 
+   init_core_time = cpu_features_get_time_usec();
+
 #ifdef HAVE_CHEATS
    cheat_manager_state_free();
    command_event_init_cheats(p_rarch->configuration_settings, p_rarch);
 #endif
-   drivers_init(p_rarch, DRIVERS_CMD_ALL);
+   /* With --load-fast the menu driver comes up after the first core
+    * frame instead of on the boot critical path. */
+   if (p_rarch->fast_boot_active)
+   {
+      p_rarch->fast_boot_pending = true;
+      drivers_init(p_rarch, DRIVERS_CMD_ALL_BUT_MENU);
+   }
+   else
+      drivers_init(p_rarch, DRIVERS_CMD_ALL);
+
+   init_driver_time = cpu_features_get_time_usec();
    input_driver_deinit_command(p_rarch);
    input_driver_init_command(p_rarch);
    input_driver_deinit_remote(p_rarch);
@@ -37195,15 +40559,18 @@ bool retroarch_main_init(int argc, char *argv[])
    p_rarch->rarch_is_inited         = true;
 
 #ifdef HAVE_DISCORD
-   if (command_event(CMD_EVENT_DISCORD_INIT, NULL))
-      discord_is_inited = true;
-
-   if (discord_is_inited)
+   if (!p_rarch->fast_boot_pending)
    {
-      discord_userdata_t userdata;
-      userdata.status = DISCORD_PRESENCE_MENU;
+      if (command_event(CMD_EVENT_DISCORD_INIT, NULL))
+         discord_is_inited = true;
 
-      command_event(CMD_EVENT_DISCORD_UPDATE, &userdata);
+      if (discord_is_inited)
+      {
+         discord_userdata_t userdata;
+         userdata.status = DISCORD_PRESENCE_MENU;
+
+         command_event(CMD_EVENT_DISCORD_UPDATE, &userdata);
+      }
    }
 #endif
 
@@ -37211,6 +40578,17 @@ bool retroarch_main_init(int argc, char *argv[])
    audio_driver_load_system_sounds();
 #endif
 
+   if (verbosity_is_enabled())
+   {
+      retro_time_t init_end_time = cpu_features_get_time_usec();
+      RARCH_LOG("[Startup]: config: %d ms, core: %d ms, drivers: %d ms, rest: %d ms, total: %d ms.\n",
+            (int)((init_config_time - init_begin_time)  / 1000),
+            (int)((init_core_time   - init_config_time) / 1000),
+            (int)((init_driver_time - init_core_time)   / 1000),
+            (int)((init_end_time    - init_driver_time) / 1000),
+            (int)((init_end_time    - init_begin_time)  / 1000));
+   }
+
    return true;
 
 error:
@@ -37376,7 +40754,15 @@ void retroarch_menu_running(void)
 #endif
 
 #ifdef HAVE_MENU
-   menu_handle_t *menu             = p_rarch->menu_driver_data;
+   menu_handle_t *menu;
+
+   /* If --load-fast deferred the menu driver and we end up here
+    * before the first core frame (e.g. content failed to load),
+    * catch up now so there is a menu to show. */
+   if (p_rarch->fast_boot_pending)
+      fast_boot_complete(p_rarch);
+
+   menu = p_rarch->menu_driver_data;
    if (menu)
       menu_driver_toggle(p_rarch, menu, true);
 
@@ -37627,6 +41013,10 @@ void retroarch_init_task_queue(void)
 
    task_queue_deinit();
    task_queue_init(threaded_enable, runloop_task_msg_queue_push);
+#if defined(HAVE_TRACE)
+   rarch_trace_init();
+   task_queue_set_trace(rarch_task_queue_trace_cb);
+#endif
 }
 
 static void retroarch_core_options_intl_init(
@@ -37897,6 +41287,7 @@ bool rarch_ctl(enum rarch_ctl_state state, void *data)
                   (option->index + option->vals->size - 1) %
                   option->vals->size;
                p_rarch->runloop_core_options->updated  = true;
+               p_rarch->runloop_core_options->version++;
             }
          }
          break;
@@ -37920,6 +41311,7 @@ bool rarch_ctl(enum rarch_ctl_state state, void *data)
                option->index                          =
                   (option->index + 1) % option->vals->size;
                p_rarch->runloop_core_options->updated = true;
+               p_rarch->runloop_core_options->version++;
             }
          }
          break;
@@ -38018,13 +41410,12 @@ bool retroarch_is_switching_display_mode(void)
 
 #if defined(HAVE_CG) || defined(HAVE_GLSL) || defined(HAVE_SLANG) || defined(HAVE_HLSL)
 static bool retroarch_load_shader_preset_internal(
-      struct rarch_state *p_rarch,
+      char *s, size_t len,
       const char *shader_directory,
       const char *core_name,
       const char *special_name)
 {
    unsigned i;
-   char shader_path[PATH_MAX_LENGTH];
 
    static enum rarch_shader_type types[] =
    {
@@ -38040,30 +41431,27 @@ static bool retroarch_load_shader_preset_internal(
 
       /* Concatenate strings into full paths */
       if (!string_is_empty(core_name))
-         fill_pathname_join_special_ext(shader_path,
+         fill_pathname_join_special_ext(s,
                shader_directory, core_name,
                special_name,
                video_shader_get_preset_extension(types[i]),
-               sizeof(shader_path));
+               len);
       else
       {
          if (string_is_empty(special_name))
             break;
 
-         fill_pathname_join(shader_path, shader_directory,
-               special_name, sizeof(shader_path));
-         strlcat(shader_path,
+         fill_pathname_join(s, shader_directory,
+               special_name, len);
+         strlcat(s,
                video_shader_get_preset_extension(types[i]),
-               sizeof(shader_path));
+               len);
       }
 
-      if (!path_is_valid(shader_path))
+      if (!path_is_valid(s))
          continue;
 
-      /* Shader preset exists, load it. */
-      RARCH_LOG("[Shaders]: Specific shader preset found at %s.\n",
-            shader_path);
-      retroarch_set_runtime_shader_preset(p_rarch, shader_path);
+      /* Shader preset exists. */
       return true;
    }
 
@@ -38092,7 +41480,8 @@ static bool retroarch_load_shader_preset_internal(
  *
  * Returns: false if there was an error or no action was performed.
  */
-static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
+static bool retroarch_resolve_shader_preset(struct rarch_state *p_rarch,
+      char *s, size_t len)
 {
    settings_t *settings               = p_rarch->configuration_settings;
    const char *video_shader_directory = settings->paths.directory_video_shader;
@@ -38143,7 +41532,7 @@ static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
       RARCH_LOG("[Shaders]: preset directory: %s\n", dirs[i]);
 #endif
 
-      ret = retroarch_load_shader_preset_internal(p_rarch,
+      ret = retroarch_load_shader_preset_internal(s, len,
             dirs[i], core_name,
             game_name);
 
@@ -38155,7 +41544,7 @@ static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
          break;
       }
 
-      ret = retroarch_load_shader_preset_internal(p_rarch,
+      ret = retroarch_load_shader_preset_internal(s, len,
             dirs[i], core_name,
             content_dir_name);
 
@@ -38167,7 +41556,7 @@ static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
          break;
       }
 
-      ret = retroarch_load_shader_preset_internal(p_rarch,
+      ret = retroarch_load_shader_preset_internal(s, len,
             dirs[i], core_name,
             core_name);
 
@@ -38179,7 +41568,7 @@ static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
          break;
       }
 
-      ret = retroarch_load_shader_preset_internal(p_rarch,
+      ret = retroarch_load_shader_preset_internal(s, len,
             dirs[i], NULL,
             "global");
 
@@ -38194,6 +41583,129 @@ static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
 
    return ret;
 }
+
+static bool retroarch_load_shader_preset(struct rarch_state *p_rarch)
+{
+   char shader_path[PATH_MAX_LENGTH];
+
+   shader_path[0] = '\0';
+
+   if (!retroarch_resolve_shader_preset(p_rarch,
+            shader_path, sizeof(shader_path)))
+      return false;
+
+   RARCH_LOG("[Shaders]: Specific shader preset found at %s.\n",
+         shader_path);
+   retroarch_set_runtime_shader_preset(p_rarch, shader_path);
+   return true;
+}
+
+/**
+ * task_shader_preset_prewarm_handler:
+ *
+ * Reads the shader preset named by the task state and every file
+ * it references (pass sources, textures) on the task thread, so
+ * that the chain comes out of the page cache instead of disk when
+ * the video driver compiles it after content load.
+ **/
+static void task_shader_preset_prewarm_handler(retro_task_t *task)
+{
+   char *preset_path   = (char*)task->state;
+   config_file_t *conf = video_shader_read_preset(preset_path);
+
+   if (conf)
+   {
+      struct video_shader *shader = (struct video_shader*)
+         calloc(1, sizeof(*shader));
+
+      if (shader && video_shader_read_conf_preset(conf, shader))
+      {
+         unsigned i;
+
+         for (i = 0; i < shader->passes; i++)
+         {
+            int64_t len = 0;
+            void *buf   = NULL;
+            if (!string_is_empty(shader->pass[i].source.path)
+                  && filestream_read_file(
+                     shader->pass[i].source.path, &buf, &len))
+               free(buf);
+         }
+
+         for (i = 0; i < shader->luts; i++)
+         {
+            int64_t len = 0;
+            void *buf   = NULL;
+            if (!string_is_empty(shader->lut[i].path)
+                  && filestream_read_file(
+                     shader->lut[i].path, &buf, &len))
+               free(buf);
+         }
+      }
+
+      if (shader)
+         free(shader);
+      config_file_free(conf);
+   }
+
+   free(preset_path);
+   task->state = NULL;
+   task_set_finished(task, true);
+}
+
+/**
+ * retroarch_shader_preset_prewarm:
+ *
+ * Resolves the shader preset that will apply to the content being
+ * loaded - the same search retroarch_get_shader_preset() performs
+ * lazily - and hands it to the task thread for pre-warming, so the
+ * preset I/O overlaps with content loading instead of stalling the
+ * first rendered frames.
+ **/
+static void retroarch_shader_preset_prewarm(struct rarch_state *p_rarch)
+{
+   char preset_path[PATH_MAX_LENGTH];
+   retro_task_t *task   = NULL;
+   settings_t *settings = p_rarch->configuration_settings;
+
+   preset_path[0] = '\0';
+
+   if (!settings->bools.video_shader_enable)
+      return;
+
+   if (!string_is_empty(p_rarch->runtime_shader_preset))
+      strlcpy(preset_path, p_rarch->runtime_shader_preset,
+            sizeof(preset_path));
+   else if (!p_rarch->cli_shader_disable
+         && !string_is_empty(p_rarch->cli_shader)
+         && video_shader_is_supported(
+            video_shader_parse_type(p_rarch->cli_shader)))
+      strlcpy(preset_path, p_rarch->cli_shader, sizeof(preset_path));
+   else if (settings->bools.auto_shaders_enable)
+   {
+      if (!retroarch_resolve_shader_preset(p_rarch,
+               preset_path, sizeof(preset_path)))
+         return;
+   }
+
+   if (string_is_empty(preset_path))
+      return;
+
+   if (!(task = task_init()))
+      return;
+
+   task->handler = task_shader_preset_prewarm_handler;
+   task->state   = strdup(preset_path);
+   task->mute    = true;
+
+   if (!task->state)
+   {
+      free(task);
+      return;
+   }
+
+   task_queue_push(task);
+}
 #endif
 
 /* get the name of the current shader preset */
@@ -38446,6 +41958,10 @@ bool retroarch_main_quit(void)
             global,
             p_rarch);
 
+#ifdef HAVE_CONFIGFILE
+      retroarch_session_save(p_rarch);
+#endif
+
       /* If any save states are in progress, wait
        * until all tasks are complete (otherwise
        * save state file may be truncated) */
@@ -38486,11 +42002,13 @@ void runloop_msg_queue_push(const char *msg,
    bool widgets_active         = p_rarch->widgets_active;
 #endif
 
-   RUNLOOP_MSG_QUEUE_LOCK();
 #ifdef HAVE_ACCESSIBILITY
+   /* Text-to-speech can spawn a process - keep it outside
+    * the queue lock */
    if (is_accessibility_enabled(p_rarch))
       accessibility_speak_priority(p_rarch, (char*) msg, 0);
 #endif
+   RUNLOOP_MSG_QUEUE_LOCK();
 #if defined(HAVE_GFX_WIDGETS)
    if (widgets_active)
    {
@@ -38720,12 +42238,14 @@ static bool menu_display_libretro(
 static void update_savestate_slot(int state_slot)
 {
    char msg[128];
+   size_t _len;
 
    msg[0] = '\0';
 
-   snprintf(msg, sizeof(msg), "%s: %d",
-         msg_hash_to_str(MSG_STATE_SLOT),
-         state_slot);
+   _len = string_append(msg, sizeof(msg), 0,
+         msg_hash_to_str(MSG_STATE_SLOT));
+   _len = string_append(msg, sizeof(msg), _len, ": ");
+   string_append_signed(msg, sizeof(msg), _len, state_slot);
 
    runloop_msg_queue_push(msg, 2, 180, true, NULL,
          MESSAGE_QUEUE_ICON_DEFAULT, MESSAGE_QUEUE_CATEGORY_INFO);
@@ -38783,6 +42303,16 @@ static enum runloop_state runloop_check_state(
       return RUNLOOP_STATE_QUIT;
 #endif
 
+#ifdef HAVE_CONFIGFILE
+   /* Batches settings changes into debounced saves,
+    * written while nothing latency-sensitive runs. */
+#ifdef HAVE_MENU
+   config_autosave_poll(!runloop_paused
+         && (!menu_is_alive || !settings->bools.menu_pause_libretro));
+#else
+   config_autosave_poll(!runloop_paused);
+#endif
+#endif
 
    BIT256_CLEAR_ALL_PTR(&current_bits);
 
@@ -39213,6 +42743,7 @@ static enum runloop_state runloop_check_state(
       static enum menu_action
          old_action                 = MENU_ACTION_CANCEL;
       bool focused                  = false;
+      bool menu_idle_skip           = false;
       input_bits_t trigger_input    = current_bits;
       global_t *global              = &p_rarch->g_extern;
 
@@ -39270,11 +42801,24 @@ static enum runloop_state runloop_check_state(
          }
       }
 
-      if (!menu_driver_iterate(&iter, current_time))
-         retroarch_menu_running_finished(false);
+      {
+         retro_time_t menu_start = cpu_features_get_time_usec();
+
+         if (!menu_driver_iterate(&iter, current_time))
+            retroarch_menu_running_finished(false);
+
+         frame_timeline_add(p_rarch, FRAME_TIMELINE_MENU,
+               cpu_features_get_time_usec() - menu_start);
+      }
 
       if (focused || !p_rarch->runloop_idle)
       {
+         retro_time_t menu_start     = cpu_features_get_time_usec();
+         /* Video/audio work triggered while rendering the menu
+          * (cached frames, menu audio) books into its own slot */
+         retro_time_t menu_nested    =
+                 p_rarch->frame_timeline.accum[FRAME_TIMELINE_VIDEO]
+               + p_rarch->frame_timeline.accum[FRAME_TIMELINE_AUDIO];
          bool rarch_is_inited        = p_rarch->rarch_is_inited;
          bool menu_pause_libretro    = settings->bools.menu_pause_libretro;
          bool libretro_running       = !menu_pause_libretro
@@ -39283,6 +42827,17 @@ static enum runloop_state runloop_check_state(
 
          if (menu)
          {
+            /* Presentation is event-driven while only the menu
+             * runs: with no input, no running animation and no
+             * pending message, nothing on screen can change, so
+             * the per-frame rebuild and present are replaced by
+             * a low-rate re-present of the last frame. The first
+             * sign of activity returns to per-frame rendering. */
+            static retro_time_t menu_last_activity = 0;
+            static retro_time_t menu_last_present  = 0;
+            bool menu_idle                         = false;
+            bool menu_idle_present                 = false;
+
             if (BIT64_GET(menu->state, MENU_STATE_RENDER_FRAMEBUFFER)
                   != BIT64_GET(menu->state, MENU_STATE_RENDER_MESSAGEBOX))
                BIT64_SET(menu->state, MENU_STATE_RENDER_FRAMEBUFFER);
@@ -39290,6 +42845,30 @@ static enum runloop_state runloop_check_state(
             if (BIT64_GET(menu->state, MENU_STATE_RENDER_FRAMEBUFFER))
                gfx_display_set_framebuffer_dirty_flag();
 
+            if (     !libretro_running
+                  && !p_rarch->recording_data
+                  && !settings->bools.audio_enable_menu
+                  && !display_kb
+                  && (action == MENU_ACTION_NOOP)
+                  && !bits_any_set(current_bits.data,
+                     ARRAY_SIZE(current_bits.data))
+                  && !p_rarch->menu_input_pointer_hw_state.active
+                  && !ANIM_IS_ACTIVE(&p_rarch->anim)
+                  && !BIT64_GET(menu->state, MENU_STATE_RENDER_FRAMEBUFFER)
+                  && !BIT64_GET(menu->state, MENU_STATE_RENDER_MESSAGEBOX)
+                  && !BIT64_GET(menu->state, MENU_STATE_POP_STACK)
+                  && (p_rarch->runloop_msg_queue_size == 0))
+            {
+               menu_idle         =
+                     (current_time - menu_last_activity)
+                   > MENU_IDLE_DELAY_USEC;
+               menu_idle_present = menu_idle &&
+                     (current_time - menu_last_present)
+                  >= MENU_IDLE_PRESENT_USEC;
+            }
+            else
+               menu_last_activity = current_time;
+
             if (BIT64_GET(menu->state, MENU_STATE_RENDER_MESSAGEBOX)
                   && !string_is_empty(menu->menu_state_msg))
             {
@@ -39306,7 +42885,7 @@ static enum runloop_state runloop_check_state(
                }
             }
 
-            if (BIT64_GET(menu->state, MENU_STATE_BLIT))
+            if (BIT64_GET(menu->state, MENU_STATE_BLIT) && !menu_idle)
             {
                if (menu->driver_ctx->render)
                   menu->driver_ctx->render(
@@ -39316,12 +42895,18 @@ static enum runloop_state runloop_check_state(
                         p_rarch->runloop_idle);
             }
 
-            if (p_rarch->menu_driver_alive && !p_rarch->runloop_idle)
+            if (p_rarch->menu_driver_alive && !p_rarch->runloop_idle
+                  && (!menu_idle || menu_idle_present))
+            {
                if (menu_display_libretro(p_rarch,
                         libretro_running, current_time))
                   video_driver_cached_frame();
+               menu_last_present = current_time;
+            }
+            else if (menu_idle)
+               menu_idle_skip = true;
 
-            if (menu->driver_ctx->set_texture)
+            if (menu->driver_ctx->set_texture && !menu_idle)
                menu->driver_ctx->set_texture();
 
             menu->state               = 0;
@@ -39330,6 +42915,13 @@ static enum runloop_state runloop_check_state(
          if (settings->bools.audio_enable_menu &&
                !libretro_running)
             audio_driver_menu_sample();
+
+         menu_nested =
+                 p_rarch->frame_timeline.accum[FRAME_TIMELINE_VIDEO]
+               + p_rarch->frame_timeline.accum[FRAME_TIMELINE_AUDIO]
+               - menu_nested;
+         frame_timeline_add(p_rarch, FRAME_TIMELINE_MENU,
+               cpu_features_get_time_usec() - menu_start - menu_nested);
       }
 
       old_input                 = current_bits;
@@ -39337,6 +42929,12 @@ static enum runloop_state runloop_check_state(
 
       if (!focused || p_rarch->runloop_idle)
          return RUNLOOP_STATE_POLLED_AND_SLEEP;
+
+      /* Nothing was rendered or presented this iteration, so
+       * vsync cannot pace the loop - sleep instead of spinning.
+       * Any input wakes the next iteration back up in full. */
+      if (menu_idle_skip)
+         return RUNLOOP_STATE_POLLED_AND_SLEEP;
    }
    else
 #endif
@@ -39825,6 +43423,11 @@ int runloop_iterate(void)
       Discord_RunCallbacks();
 #endif
 
+   if (p_rarch->fast_boot_pending && p_rarch->video_driver_frame_count)
+      fast_boot_complete(p_rarch);
+
+   frame_timeline_begin(p_rarch);
+
    if (p_rarch->runloop_frame_time.callback)
    {
       /* Updates frame timing if frame timing callback is in use by the core.
@@ -39886,6 +43489,7 @@ int runloop_iterate(void)
          /* FIXME: This is an ugly way to tell Netplay this... */
          netplay_driver_ctl(RARCH_NETPLAY_CTL_PAUSE, NULL);
 #endif
+         frame_timeline_end(p_rarch, 16667);
          return 0;
       case RUNLOOP_STATE_ITERATE:
          p_rarch->runloop_core_running = true;
@@ -39962,9 +43566,32 @@ int runloop_iterate(void)
    }
 
    if ((video_frame_delay > 0) && !p_rarch->input_driver_nonblock_state)
-      retro_sleep(video_frame_delay);
+   {
+      /* Treat the configured frame delay as a ceiling and
+       * self-tune below it: a delayed frame start shrinks
+       * input-to-photon latency, but only if the core still
+       * finishes inside the refresh budget. */
+      if (video_frame_delay != p_rarch->frame_delay_target)
+      {
+         p_rarch->frame_delay_target    = video_frame_delay;
+         p_rarch->frame_delay_effective = video_frame_delay;
+         p_rarch->frame_time_avg        = 0.0f;
+         p_rarch->frame_time_var        = 0.0f;
+         p_rarch->frame_delay_next_tune = current_time + 1000000;
+      }
+
+      if (p_rarch->frame_delay_effective > 0)
+         retro_sleep(p_rarch->frame_delay_effective);
+   }
 
    {
+      /* Audio writes and video presents triggered from inside
+       * retro_run are accumulated into their own slots - keep
+       * the core slot to the time the core itself spent */
+      retro_time_t core_start       = cpu_features_get_time_usec();
+      retro_time_t nested           =
+              p_rarch->frame_timeline.accum[FRAME_TIMELINE_VIDEO]
+            + p_rarch->frame_timeline.accum[FRAME_TIMELINE_AUDIO];
 #ifdef HAVE_RUNAHEAD
       unsigned run_ahead_num_frames = settings->uints.run_ahead_frames;
       /* Run Ahead Feature replaces the call to core_run in this loop */
@@ -39981,6 +43608,12 @@ int runloop_iterate(void)
       else
 #endif
          core_run();
+
+      nested = p_rarch->frame_timeline.accum[FRAME_TIMELINE_VIDEO]
+            + p_rarch->frame_timeline.accum[FRAME_TIMELINE_AUDIO]
+            - nested;
+      frame_timeline_add(p_rarch, FRAME_TIMELINE_CORE,
+            cpu_features_get_time_usec() - core_start - nested);
    }
 
    /* Increment runtime tick counter after each call to
@@ -39988,6 +43621,54 @@ int runloop_iterate(void)
    p_rarch->libretro_core_runtime_usec += rarch_core_runtime_tick(
          p_rarch, current_time);
 
+   if (     (p_rarch->frame_delay_target > 0)
+         && !p_rarch->input_driver_nonblock_state
+         && (p_rarch->video_driver_core_hz > 0.0f))
+   {
+      retro_time_t now          = cpu_features_get_time_usec();
+      retro_time_t frame_budget = (retro_time_t)
+         (1000000.0f / p_rarch->video_driver_core_hz);
+      /* Core frame time without the commanded sleep. */
+      float frame_time          = (float)(now - current_time)
+         - (float)p_rarch->frame_delay_effective * 1000.0f;
+      float delta               = frame_time - p_rarch->frame_time_avg;
+
+      /* EWMA of core frame time and its variance - roughly
+       * half a second of history at 60 Hz. */
+      p_rarch->frame_time_avg  += delta / 32.0f;
+      p_rarch->frame_time_var  +=
+         (delta * delta - p_rarch->frame_time_var) / 32.0f;
+
+      if (now - current_time > frame_budget)
+      {
+         /* Overran the refresh budget - back off at once,
+          * a missed frame hurts more than a little extra
+          * latency. */
+         p_rarch->frame_delay_effective /= 2;
+         p_rarch->frame_delay_next_tune  = now + 1000000;
+      }
+      else if (now >= p_rarch->frame_delay_next_tune)
+      {
+         /* Recalibrate once per second: sleep + expected
+          * core time + two sigmas + headroom must fit in
+          * the refresh budget. */
+         float headroom  = (float)settings->uints.video_frame_delay_headroom
+            * 1000.0f;
+         float slack     = (float)frame_budget
+            - p_rarch->frame_time_avg
+            - 2.0f * sqrtf(p_rarch->frame_time_var)
+            - headroom;
+         unsigned delay  = (slack <= 0.0f)
+            ? 0 : (unsigned)(slack / 1000.0f);
+
+         if (delay > p_rarch->frame_delay_target)
+            delay = p_rarch->frame_delay_target;
+
+         p_rarch->frame_delay_effective = delay;
+         p_rarch->frame_delay_next_tune = now + 1000000;
+      }
+   }
+
 #ifdef HAVE_CHEEVOS
    if (settings->bools.cheevos_enable)
       rcheevos_test();
@@ -40038,6 +43719,13 @@ int runloop_iterate(void)
       autosave_unlock();
 #endif
 
+   /* Close the frame before the limiter below - deliberate
+    * pacing sleep is not frame time */
+   frame_timeline_end(p_rarch,
+         (p_rarch->video_driver_core_hz > 0.0f)
+         ? (retro_time_t)(1000000.0f / p_rarch->video_driver_core_hz)
+         : 16667);
+
    /* Condition for max speed x0.0 when vrr_runloop is off to skip that part */
    if (!(fastforward_ratio || vrr_runloop_enable))
       return 0;
@@ -40089,6 +43777,49 @@ end:
                    ? fastforward_ratio : 1.0f)));
    }
 
+   /* VRR pacing: every present is released on an absolute deadline
+    * at exact core cadence. The deadline advances by exactly one
+    * core period per frame - a late frame borrows from the next
+    * period instead of rescheduling, so the cadence doesn't drift -
+    * and only a stall longer than a whole period re-anchors the
+    * schedule. */
+   if (vrr_runloop_enable && !p_rarch->runloop_fastmotion)
+   {
+      retro_time_t deadline = p_rarch->frame_limit_last_time
+            + p_rarch->frame_limit_minimum_time;
+      retro_time_t now      = cpu_features_get_time_usec();
+      int64_t error;
+      bool slept            = false;
+
+      if (now < deadline)
+      {
+#if defined(HAVE_COCOATOUCH)
+         if (!p_rarch->main_ui_companion_is_on_foreground)
+#endif
+            vrr_pace_wait_until(deadline);
+         now   = cpu_features_get_time_usec();
+         slept = true;
+      }
+      else
+         vrr_pace_overruns++;
+
+      error                    = now - deadline;
+      if (error < 0)
+         error                 = 0;
+      vrr_pace_error_last_us   = error;
+      vrr_pace_error_total_us += (uint64_t)error;
+      vrr_pace_samples++;
+      if (error > vrr_pace_error_max_us)
+         vrr_pace_error_max_us = error;
+
+      if (error > p_rarch->frame_limit_minimum_time)
+         p_rarch->frame_limit_last_time = now;
+      else
+         p_rarch->frame_limit_last_time = deadline;
+
+      return slept ? 1 : 0;
+   }
+
    {
       retro_time_t to_sleep_ms  = (
             (p_rarch->frame_limit_last_time + p_rarch->frame_limit_minimum_time)
@@ -40230,6 +43961,10 @@ void rarch_favorites_init(void)
    playlist_config_t playlist_config;
    enum playlist_sort_mode current_sort_mode;
 
+   /* --load-fast: deferred to fast_boot_complete(). */
+   if (p_rarch->fast_boot_pending)
+      return;
+
    playlist_config.capacity            = COLLECTION_SIZE;
    playlist_config.old_format          = settings ? settings->bools.playlist_use_old_format : false;
    playlist_config.compress            = settings ? settings->bools.playlist_compression : false;
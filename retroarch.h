@@ -510,6 +510,11 @@ typedef struct audio_driver
    size_t (*write_avail)(void *data);
 
    size_t (*buffer_size)(void *data);
+
+   /* Optional. Measured output latency of the device in frames:
+    * samples already handed to the driver but not yet audible.
+    * Shown in the statistics overlay when implemented. */
+   size_t (*device_latency)(void *data);
 } audio_driver_t;
 
 bool audio_driver_enable_callback(void);
@@ -1169,7 +1174,7 @@ typedef struct video_frame_info
       bool full_screen;
    } osd_stat_params;
 
-   char stat_text[512];
+   char stat_text[1024];
 
    bool widgets_active;
    bool menu_mouse_enable;
@@ -1179,6 +1184,7 @@ typedef struct video_frame_info
    bool input_menu_swap_ok_cancel_buttons;
    bool input_driver_nonblock_state;
    bool black_frame_insertion;
+   bool frame_duplication;
    bool hard_sync;
    bool fps_show;
    bool memory_show;
@@ -1406,6 +1412,10 @@ typedef struct video_poke_interface
          struct retro_framebuffer *framebuffer);
    bool (*get_hw_render_interface)(void *data,
          const struct retro_hw_render_interface **iface);
+
+   /* Writes per-pass GPU timing for the active shader into s.
+    * Optional - only drivers that collect GPU timestamps set it. */
+   bool (*get_shader_pass_profile)(void *data, char *s, size_t len);
 } video_poke_interface_t;
 
 /* msg is for showing a message on the screen
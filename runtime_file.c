@@ -144,6 +144,334 @@ static void RtlJSONLogError(RtlJSONContext *p_ctx)
    }
 }
 
+/* Runtime journal
+ *
+ * A single append-only binary file holding the runtime data of
+ * every piece of content, with an in-memory index built the first
+ * time it is touched. Updating runtime on content close is then one
+ * record append, and showing play times for a whole playlist needs
+ * no per-entry file I/O. Legacy per-content JSON log files are
+ * still read as a fallback and folded into the journal on the
+ * next save. */
+
+#define RUNTIME_JOURNAL_FILE_NAME   "runtime_journal.bin"
+#define RUNTIME_JOURNAL_MAGIC_SIZE  8
+#define RUNTIME_JOURNAL_RECORD_SIZE (10 * sizeof(uint32_t))
+
+static const uint8_t runtime_journal_magic[RUNTIME_JOURNAL_MAGIC_SIZE] = {
+   'R', 'T', 'J', 'R', 'N', 'L', 1, 0
+};
+
+typedef struct
+{
+   char *path;                      /* Per-content log file path (key) */
+   rtl_runtime_t runtime;           /* unsigned alignment */
+   rtl_last_played_t last_played;   /* unsigned alignment */
+} runtime_journal_entry_t;
+
+/* TODO/FIXME - static globals */
+static runtime_journal_entry_t *runtime_journal_entries = NULL;
+static size_t runtime_journal_entries_size              = 0;
+static size_t runtime_journal_file_records              = 0;
+static char *runtime_journal_loaded_path                = NULL;
+
+static void runtime_journal_u32_write(uint8_t *buf, uint32_t val)
+{
+   buf[0] = (uint8_t)(val >>  0);
+   buf[1] = (uint8_t)(val >>  8);
+   buf[2] = (uint8_t)(val >> 16);
+   buf[3] = (uint8_t)(val >> 24);
+}
+
+static uint32_t runtime_journal_u32_read(const uint8_t *buf)
+{
+   return ((uint32_t)buf[0] <<  0) |
+          ((uint32_t)buf[1] <<  8) |
+          ((uint32_t)buf[2] << 16) |
+          ((uint32_t)buf[3] << 24);
+}
+
+static runtime_journal_entry_t *runtime_journal_find(const char *path)
+{
+   size_t i;
+
+   for (i = 0; i < runtime_journal_entries_size; i++)
+   {
+      if (string_is_equal(runtime_journal_entries[i].path, path))
+         return &runtime_journal_entries[i];
+   }
+
+   return NULL;
+}
+
+/* Updates the index entry for 'path', creating it if required.
+ * Returns NULL only on allocation failure. */
+static runtime_journal_entry_t *runtime_journal_store(const char *path,
+      const rtl_runtime_t *runtime, const rtl_last_played_t *last_played)
+{
+   runtime_journal_entry_t *entry = runtime_journal_find(path);
+
+   if (!entry)
+   {
+      entry = (runtime_journal_entry_t*)realloc(runtime_journal_entries,
+            (runtime_journal_entries_size + 1) * sizeof(*entry));
+      if (!entry)
+         return NULL;
+
+      runtime_journal_entries        = entry;
+      entry                          =
+         &runtime_journal_entries[runtime_journal_entries_size];
+      entry->path                    = strdup(path);
+      if (!entry->path)
+         return NULL;
+
+      runtime_journal_entries_size++;
+   }
+
+   entry->runtime     = *runtime;
+   entry->last_played = *last_played;
+   return entry;
+}
+
+static bool runtime_journal_write_record(RFILE *file,
+      const runtime_journal_entry_t *entry)
+{
+   uint8_t record[RUNTIME_JOURNAL_RECORD_SIZE];
+   size_t path_len = strlen(entry->path);
+
+   runtime_journal_u32_write(record +  0, (uint32_t)path_len);
+   runtime_journal_u32_write(record +  4, entry->runtime.hours);
+   runtime_journal_u32_write(record +  8, entry->runtime.minutes);
+   runtime_journal_u32_write(record + 12, entry->runtime.seconds);
+   runtime_journal_u32_write(record + 16, entry->last_played.year);
+   runtime_journal_u32_write(record + 20, entry->last_played.month);
+   runtime_journal_u32_write(record + 24, entry->last_played.day);
+   runtime_journal_u32_write(record + 28, entry->last_played.hour);
+   runtime_journal_u32_write(record + 32, entry->last_played.minute);
+   runtime_journal_u32_write(record + 36, entry->last_played.second);
+
+   if (filestream_write(file, record, sizeof(record)) !=
+         (int64_t)sizeof(record))
+      return false;
+
+   return filestream_write(file, entry->path, path_len) ==
+         (int64_t)path_len;
+}
+
+static void runtime_journal_unload(void)
+{
+   size_t i;
+
+   for (i = 0; i < runtime_journal_entries_size; i++)
+      free(runtime_journal_entries[i].path);
+   if (runtime_journal_entries)
+      free(runtime_journal_entries);
+   if (runtime_journal_loaded_path)
+      free(runtime_journal_loaded_path);
+
+   runtime_journal_entries      = NULL;
+   runtime_journal_entries_size = 0;
+   runtime_journal_file_records = 0;
+   runtime_journal_loaded_path  = NULL;
+}
+
+/* Builds the in-memory index from the journal file. Does nothing
+ * if the journal at 'journal_path' is already indexed. A missing
+ * file simply leaves the index empty - the journal is created on
+ * the first append. */
+static void runtime_journal_load(const char *journal_path)
+{
+   uint8_t magic[RUNTIME_JOURNAL_MAGIC_SIZE];
+   RFILE *file = NULL;
+
+   if (runtime_journal_loaded_path &&
+         string_is_equal(runtime_journal_loaded_path, journal_path))
+      return;
+
+   runtime_journal_unload();
+
+   runtime_journal_loaded_path = strdup(journal_path);
+   if (!runtime_journal_loaded_path)
+      return;
+
+   file = filestream_open(journal_path,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return;
+
+   if ((filestream_read(file, magic, sizeof(magic)) !=
+            (int64_t)sizeof(magic)) ||
+         (memcmp(magic, runtime_journal_magic, sizeof(magic)) != 0))
+   {
+      RARCH_WARN("[runtime] invalid runtime journal: %s\n", journal_path);
+      filestream_close(file);
+      return;
+   }
+
+   for (;;)
+   {
+      uint8_t record[RUNTIME_JOURNAL_RECORD_SIZE];
+      rtl_runtime_t runtime;
+      rtl_last_played_t last_played;
+      char *path       = NULL;
+      uint32_t path_len;
+
+      if (filestream_read(file, record, sizeof(record)) !=
+            (int64_t)sizeof(record))
+         break;
+
+      path_len = runtime_journal_u32_read(record);
+      if ((path_len == 0) || (path_len >= PATH_MAX_LENGTH))
+      {
+         RARCH_WARN("[runtime] truncated runtime journal: %s\n",
+               journal_path);
+         break;
+      }
+
+      path = (char*)malloc(path_len + 1);
+      if (!path)
+         break;
+
+      if (filestream_read(file, path, path_len) != (int64_t)path_len)
+      {
+         free(path);
+         break;
+      }
+      path[path_len]      = '\0';
+
+      runtime.hours       = runtime_journal_u32_read(record +  4);
+      runtime.minutes     = runtime_journal_u32_read(record +  8);
+      runtime.seconds     = runtime_journal_u32_read(record + 12);
+      last_played.year    = runtime_journal_u32_read(record + 16);
+      last_played.month   = runtime_journal_u32_read(record + 20);
+      last_played.day     = runtime_journal_u32_read(record + 24);
+      last_played.hour    = runtime_journal_u32_read(record + 28);
+      last_played.minute  = runtime_journal_u32_read(record + 32);
+      last_played.second  = runtime_journal_u32_read(record + 36);
+
+      /* Later records win - that is what makes the file a journal */
+      runtime_journal_store(path, &runtime, &last_played);
+      runtime_journal_file_records++;
+
+      free(path);
+   }
+
+   filestream_close(file);
+}
+
+/* Rewrites the journal with one record per indexed entry, dropping
+ * superseded appends. */
+static void runtime_journal_compact(void)
+{
+   size_t i;
+   RFILE *file = NULL;
+
+   if (!runtime_journal_loaded_path)
+      return;
+
+   file = filestream_open(runtime_journal_loaded_path,
+         RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return;
+
+   if (filestream_write(file, runtime_journal_magic,
+            sizeof(runtime_journal_magic)) !=
+         (int64_t)sizeof(runtime_journal_magic))
+   {
+      filestream_close(file);
+      return;
+   }
+
+   for (i = 0; i < runtime_journal_entries_size; i++)
+   {
+      if (!runtime_journal_write_record(file,
+               &runtime_journal_entries[i]))
+         break;
+   }
+
+   filestream_close(file);
+   runtime_journal_file_records = runtime_journal_entries_size;
+
+   RARCH_LOG("[runtime] compacted runtime journal: %s\n",
+         runtime_journal_loaded_path);
+}
+
+/* Fetches runtime values for runtime_log->path from the journal
+ * index. Returns false if the content has no journal entry yet. */
+static bool runtime_journal_get(runtime_log_t *runtime_log)
+{
+   runtime_journal_entry_t *entry = NULL;
+
+   if (string_is_empty(runtime_log->journal_path))
+      return false;
+
+   runtime_journal_load(runtime_log->journal_path);
+
+   entry = runtime_journal_find(runtime_log->path);
+   if (!entry)
+      return false;
+
+   runtime_log->runtime     = entry->runtime;
+   runtime_log->last_played = entry->last_played;
+   return true;
+}
+
+/* Appends the current values of 'runtime_log' to the journal and
+ * updates the index. Returns false on any failure, in which case
+ * the caller should fall back to the legacy log file. */
+static bool runtime_journal_append(runtime_log_t *runtime_log)
+{
+   runtime_journal_entry_t *entry = NULL;
+   RFILE *file                    = NULL;
+   bool ok                        = false;
+   bool exists                    = false;
+
+   if (string_is_empty(runtime_log->journal_path))
+      return false;
+
+   runtime_journal_load(runtime_log->journal_path);
+
+   entry = runtime_journal_store(runtime_log->path,
+         &runtime_log->runtime, &runtime_log->last_played);
+   if (!entry)
+      return false;
+
+   exists = path_is_valid(runtime_log->journal_path);
+   file   = filestream_open(runtime_log->journal_path,
+         exists
+            ? (RETRO_VFS_FILE_ACCESS_READ_WRITE |
+               RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING)
+            : RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   if (!file)
+      return false;
+
+   if (exists)
+      ok = (filestream_seek(file, 0, RETRO_VFS_SEEK_POSITION_END) == 0);
+   else
+      ok = (filestream_write(file, runtime_journal_magic,
+               sizeof(runtime_journal_magic)) ==
+            (int64_t)sizeof(runtime_journal_magic));
+
+   if (ok)
+      ok = runtime_journal_write_record(file, entry);
+
+   filestream_close(file);
+
+   if (!ok)
+      return false;
+
+   runtime_journal_file_records++;
+
+   /* Once the dead weight of superseded records dominates,
+    * rewrite the file from the index. */
+   if (runtime_journal_file_records >
+         (2 * runtime_journal_entries_size) + 64)
+      runtime_journal_compact();
+
+   return true;
+}
+
 /* Initialisation */
 
 /* Parses log file referenced by runtime_log->path.
@@ -301,6 +629,7 @@ runtime_log_t *runtime_log_init(
    char core_name[PATH_MAX_LENGTH];
    char log_file_dir[PATH_MAX_LENGTH];
    char log_file_path[PATH_MAX_LENGTH];
+   char journal_file_path[PATH_MAX_LENGTH];
    char tmp_buf[PATH_MAX_LENGTH];
    core_info_ctx_find_t core_info;
    runtime_log_t *runtime_log = NULL;
@@ -309,6 +638,7 @@ runtime_log_t *runtime_log_init(
    core_name[0]               = '\0';
    log_file_dir[0]            = '\0';
    log_file_path[0]           = '\0';
+   journal_file_path[0]       = '\0';
    tmp_buf[0]                 = '\0';
 
    if (  string_is_empty(dir_runtime_log) &&
@@ -357,6 +687,11 @@ runtime_log_t *runtime_log_init(
    if (string_is_empty(tmp_buf))
       return NULL;
 
+   /* The shared runtime journal lives at the root of the
+    * runtime log directory, covering all cores */
+   fill_pathname_join(journal_file_path, tmp_buf,
+         RUNTIME_JOURNAL_FILE_NAME, sizeof(journal_file_path));
+
    if (log_per_core)
       fill_pathname_join(
             log_file_dir,
@@ -446,10 +781,18 @@ runtime_log_t *runtime_log_init(
    runtime_log->last_played.second = 0;
 
    runtime_log->path[0]            = '\0';
+   runtime_log->journal_path[0]    = '\0';
 
    strlcpy(runtime_log->path, log_file_path, sizeof(runtime_log->path));
+   strlcpy(runtime_log->journal_path, journal_file_path,
+         sizeof(runtime_log->journal_path));
 
-   /* Load existing log file, if it exists */
+   /* Prefer the runtime journal - a pure in-memory lookup
+    * once its index has been built */
+   if (runtime_journal_get(runtime_log))
+      return runtime_log;
+
+   /* Load legacy log file, if it exists */
    if (path_is_valid(runtime_log->path))
       runtime_log_read_file(runtime_log);
 
@@ -1223,6 +1566,13 @@ void runtime_log_save(runtime_log_t *runtime_log)
    if (!runtime_log)
       return;
 
+   /* One record append to the shared journal is all a
+    * runtime update normally needs */
+   if (runtime_journal_append(runtime_log))
+      return;
+
+   /* Journal unavailable - fall back to the legacy
+    * per-content log file */
    RARCH_LOG("Saving runtime log file: %s\n", runtime_log->path);
 
    /* Attempt to open log file */
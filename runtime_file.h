@@ -104,6 +104,9 @@ typedef struct
    rtl_runtime_t runtime;           /* unsigned alignment */
    rtl_last_played_t last_played;   /* unsigned alignment */
    char path[PATH_MAX_LENGTH];
+   /* Path of the shared runtime journal covering all content.
+    * Empty if journalling is unavailable. */
+   char journal_path[PATH_MAX_LENGTH];
 } runtime_log_t;
 
 /* Initialisation */
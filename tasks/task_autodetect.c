@@ -47,6 +47,24 @@ typedef struct
    bool suppress_notifcations;
 } autoconfig_handle_t;
 
+/* Indexed cache of the external autoconfig directory: VID/PID and
+ * device name of every cfg, parsed once. A reconnect (or a storm of
+ * them from a flaky hub) then resolves against these few bytes per
+ * file instead of re-parsing hundreds of config files. */
+typedef struct
+{
+   char *path;
+   char *device_name;
+   uint16_t vid;
+   uint16_t pid;
+} autoconfig_index_entry_t;
+
+/* TODO/FIXME - static globals */
+static autoconfig_index_entry_t *autoconfig_index = NULL;
+static size_t autoconfig_index_size               = 0;
+static char *autoconfig_index_dir                 = NULL;
+static uint32_t autoconfig_index_list_hash        = 0;
+
 /*********************/
 /* Utility functions */
 /*********************/
@@ -152,6 +170,147 @@ static unsigned input_autoconfigure_get_config_file_affinity(
    return affinity;
 }
 
+/* Affinity of the connected device against one index entry -
+ * same scoring as input_autoconfigure_get_config_file_affinity,
+ * but on the cached metadata instead of a parsed file */
+static unsigned input_autoconfigure_get_index_entry_affinity(
+      autoconfig_handle_t *autoconfig_handle,
+      autoconfig_index_entry_t *entry)
+{
+   uint16_t config_vid = entry->vid;
+   uint16_t config_pid = entry->pid;
+   bool pid_match      = false;
+   unsigned affinity   = 0;
+
+   /* > Bliss-Box shenanigans... */
+#ifdef HAVE_BLISSBOX
+   if (autoconfig_handle->device_info.vid == BLISSBOX_VID)
+      config_pid = BLISSBOX_PID;
+#endif
+
+   /* Check for matching VID+PID */
+   pid_match = (autoconfig_handle->device_info.vid == config_vid) &&
+               (autoconfig_handle->device_info.pid == config_pid) &&
+               (autoconfig_handle->device_info.vid != 0)          &&
+               (autoconfig_handle->device_info.pid != 0);
+
+   /* > More Bliss-Box shenanigans... */
+#ifdef HAVE_BLISSBOX
+   pid_match = pid_match &&
+               (autoconfig_handle->device_info.vid != BLISSBOX_VID) &&
+               (autoconfig_handle->device_info.pid != BLISSBOX_PID);
+#endif
+
+   if (pid_match)
+      affinity += 3;
+
+   /* Check for matching device name */
+   if (      !string_is_empty(entry->device_name)
+         &&  string_is_equal(entry->device_name,
+             autoconfig_handle->device_info.name))
+      affinity += 2;
+
+   return affinity;
+}
+
+static void input_autoconfigure_free_index(void)
+{
+   size_t i;
+
+   for (i = 0; i < autoconfig_index_size; i++)
+   {
+      if (autoconfig_index[i].path)
+         free(autoconfig_index[i].path);
+      if (autoconfig_index[i].device_name)
+         free(autoconfig_index[i].device_name);
+   }
+
+   if (autoconfig_index)
+      free(autoconfig_index);
+   autoconfig_index      = NULL;
+   autoconfig_index_size = 0;
+
+   if (autoconfig_index_dir)
+      free(autoconfig_index_dir);
+   autoconfig_index_dir  = NULL;
+}
+
+/* The portable path layer has no mtime accessor, so staleness is
+ * detected from the directory listing itself: any added, removed or
+ * renamed cfg changes the hash and rebuilds the index. An in-place
+ * edit of an existing file goes unnoticed until the next listing
+ * change - acceptable for autoconfig profiles, which are written
+ * once per device. */
+static uint32_t input_autoconfigure_hash_file_list(
+      struct string_list *list)
+{
+   size_t i;
+   uint32_t hash = 5381;
+
+   for (i = 0; i < list->size; i++)
+   {
+      const char *path = list->elems[i].data;
+
+      if (string_is_empty(path))
+         continue;
+
+      while (*path)
+         hash = ((hash << 5) + hash) ^ (uint32_t)(uint8_t)*path++;
+   }
+
+   return hash;
+}
+
+static void input_autoconfigure_build_index(const char *dir,
+      struct string_list *config_file_list, uint32_t list_hash)
+{
+   size_t i;
+
+   input_autoconfigure_free_index();
+
+   autoconfig_index = (autoconfig_index_entry_t*)calloc(
+         config_file_list->size, sizeof(*autoconfig_index));
+
+   if (!autoconfig_index)
+      return;
+
+   for (i = 0; i < config_file_list->size; i++)
+   {
+      int tmp_int                        = 0;
+      const char *config_file_path       = config_file_list->elems[i].data;
+      config_file_t *config              = NULL;
+      struct config_entry_list *entry    = NULL;
+      autoconfig_index_entry_t *idx      =
+         &autoconfig_index[autoconfig_index_size];
+
+      if (string_is_empty(config_file_path))
+         continue;
+
+      config = config_file_new_from_path_to_string(config_file_path);
+
+      if (!config)
+         continue;
+
+      if (config_get_int(config, "input_vendor_id", &tmp_int))
+         idx->vid = (uint16_t)tmp_int;
+
+      if (config_get_int(config, "input_product_id", &tmp_int))
+         idx->pid = (uint16_t)tmp_int;
+
+      if (  (entry = config_get_entry(config, "input_device"))
+            && !string_is_empty(entry->value))
+         idx->device_name = strdup(entry->value);
+
+      idx->path = strdup(config_file_path);
+      autoconfig_index_size++;
+
+      config_file_free(config);
+   }
+
+   autoconfig_index_dir       = strdup(dir);
+   autoconfig_index_list_hash = list_hash;
+}
+
 /* 'Attaches' specified autoconfig file to autoconfig
  * handle, parsing required device info metadata */
 static void input_autoconfigure_set_config_file(
@@ -197,20 +356,25 @@ static bool input_autoconfigure_scan_config_files_external(
       autoconfig_handle_t *autoconfig_handle)
 {
    size_t i;
-   const char *dir_autoconfig           = autoconfig_handle->dir_autoconfig;
-   const char *dir_driver_autoconfig    = autoconfig_handle->dir_driver_autoconfig;
-   struct string_list *config_file_list = NULL;
-   config_file_t *best_config           = NULL;
-   unsigned max_affinity                = 0;
-   bool match_found                     = false;
+   const char *dir_autoconfig            = autoconfig_handle->dir_autoconfig;
+   const char *dir_driver_autoconfig     = autoconfig_handle->dir_driver_autoconfig;
+   const char *dir_used                  = NULL;
+   struct string_list *config_file_list  = NULL;
+   autoconfig_index_entry_t *best_entry  = NULL;
+   uint32_t list_hash                    = 0;
+   unsigned max_affinity                 = 0;
+   bool match_found                      = false;
 
    /* Attempt to fetch file listing from driver-specific
     * autoconfig directory */
    if (!string_is_empty(dir_driver_autoconfig) &&
        path_is_directory(dir_driver_autoconfig))
+   {
       config_file_list = dir_list_new_special(
             dir_driver_autoconfig, DIR_LIST_AUTOCONFIG,
             "cfg", false);
+      dir_used         = dir_driver_autoconfig;
+   }
 
    if (!config_file_list || (config_file_list->size < 1))
    {
@@ -224,46 +388,37 @@ static bool input_autoconfigure_scan_config_files_external(
 
       if (!string_is_empty(dir_autoconfig) &&
           path_is_directory(dir_autoconfig))
+      {
          config_file_list = dir_list_new_special(
                dir_autoconfig, DIR_LIST_AUTOCONFIG,
                "cfg", false);
+         dir_used         = dir_autoconfig;
+      }
    }
 
    if (!config_file_list || (config_file_list->size < 1))
       goto end;
 
-   /* Loop through external config files */
-   for (i = 0; i < config_file_list->size; i++)
-   {
-      const char *config_file_path = config_file_list->elems[i].data;
-      config_file_t *config        = NULL;
-      unsigned affinity            = 0;
-
-      if (string_is_empty(config_file_path))
-         continue;
-
-      /* Load autoconfig file */
-      config = config_file_new_from_path_to_string(config_file_path);
+   /* (Re)build the index when the directory or its
+    * listing changed */
+   list_hash = input_autoconfigure_hash_file_list(config_file_list);
 
-      if (!config)
-         continue;
+   if (    !autoconfig_index
+       ||   string_is_empty(autoconfig_index_dir)
+       ||  !string_is_equal(autoconfig_index_dir, dir_used)
+       ||  (autoconfig_index_list_hash != list_hash))
+      input_autoconfigure_build_index(dir_used,
+            config_file_list, list_hash);
 
-      /* Check for a match */
-      if (autoconfig_handle && config)
-         affinity = input_autoconfigure_get_config_file_affinity(
-               autoconfig_handle, config);
+   /* Find the best match in the index */
+   for (i = 0; i < autoconfig_index_size; i++)
+   {
+      unsigned affinity = input_autoconfigure_get_index_entry_affinity(
+            autoconfig_handle, &autoconfig_index[i]);
 
       if (affinity > max_affinity)
       {
-         if (best_config)
-         {
-            config_file_free(best_config);
-            best_config = NULL;
-         }
-
-         /* 'Cache' config file for later processing */
-         best_config  = config;
-         config       = NULL;
+         best_entry   = &autoconfig_index[i];
          max_affinity = affinity;
 
          /* An affinity of 5 is a 'perfect' match,
@@ -271,22 +426,20 @@ static bool input_autoconfigure_scan_config_files_external(
          if (affinity == 5)
             break;
       }
-      /* No match - just clean up config file */
-      else
-      {
-         config_file_free(config);
-         config = NULL;
-      }
    }
 
-   /* If we reach this point and a config file has
-    * been cached, then we have a match */
-   if (best_config)
+   /* Only the winning file gets parsed again */
+   if (best_entry && !string_is_empty(best_entry->path))
    {
-      if (autoconfig_handle && best_config)
+      config_file_t *config =
+         config_file_new_from_path_to_string(best_entry->path);
+
+      if (config)
+      {
          input_autoconfigure_set_config_file(
-               autoconfig_handle, best_config);
-      match_found = true;
+               autoconfig_handle, config);
+         match_found = true;
+      }
    }
 
 end:
@@ -66,6 +66,15 @@
 #include <retro_miscellaneous.h>
 #include <streams/file_stream.h>
 #include <retro_assert.h>
+#include <dynamic/dylib.h>
+#include <features/features_cpu.h>
+
+#ifdef HAVE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <memmap.h>
+#endif
 
 #include <lists/string_list.h>
 #include <string/stdstring.h>
@@ -188,6 +197,191 @@ struct content_information_ctx
    bool check_firmware_before_loading;
 };
 
+#ifdef HAVE_MMAP
+/* Describes a content buffer that is backed by a
+ * file mapping rather than the heap, so that it
+ * can be released with munmap() instead of free() */
+typedef struct
+{
+   void *map;
+   uint64_t size;
+} content_file_map_t;
+#endif
+
+/* Content load profiler
+ * > Each stage of a content load (extraction, file
+ *   reads, patching, core_load_game, achievements)
+ *   records its wall time and the bytes it handled;
+ *   a per-stage summary with throughput is logged
+ *   once the load finishes
+ * > The raw samples are also written as a Chrome
+ *   trace (open via chrome://tracing) into the cache
+ *   directory, when one is set */
+enum content_load_stage
+{
+   CONTENT_LOAD_STAGE_EXTRACT = 0,
+   CONTENT_LOAD_STAGE_READ,
+   CONTENT_LOAD_STAGE_PATCH,
+   CONTENT_LOAD_STAGE_CORE_LOAD,
+   CONTENT_LOAD_STAGE_CHEEVOS,
+   CONTENT_LOAD_STAGE_LAST
+};
+
+static const char *content_load_stage_names[CONTENT_LOAD_STAGE_LAST] = {
+   "extract",
+   "read",
+   "patch",
+   "core_load_game",
+   "cheevos_load"
+};
+
+struct content_load_event
+{
+   retro_time_t start;    /* retro_time_t alignment */
+   retro_time_t duration;
+   uint64_t bytes;
+   enum content_load_stage stage;
+};
+
+#define CONTENT_LOAD_PROFILE_MAX_EVENTS 64
+
+/* TODO/FIXME - static global variables */
+static struct content_load_event
+      content_load_events[CONTENT_LOAD_PROFILE_MAX_EVENTS];
+static size_t content_load_event_count    = 0;
+static retro_time_t content_load_t0       = 0;
+static bool content_load_profile_active   = false;
+
+static void content_load_profile_begin(void)
+{
+   content_load_event_count   = 0;
+   content_load_t0            = cpu_features_get_time_usec();
+   content_load_profile_active = true;
+}
+
+/* Records one stage sample running from start_usec until
+ * now. Samples past the (generous) event limit still count
+ * towards the totals of their stage. */
+static void content_load_profile_record(
+      enum content_load_stage stage,
+      retro_time_t start_usec, uint64_t bytes)
+{
+   struct content_load_event *evt;
+
+   if (!content_load_profile_active)
+      return;
+   if (content_load_event_count >= CONTENT_LOAD_PROFILE_MAX_EVENTS)
+      return;
+
+   evt           = &content_load_events[content_load_event_count++];
+   evt->stage    = stage;
+   evt->start    = start_usec;
+   evt->duration = cpu_features_get_time_usec() - start_usec;
+   evt->bytes    = bytes;
+}
+
+static void content_load_profile_write_trace(const char *directory_cache)
+{
+   size_t i;
+   char trace_path[PATH_MAX_LENGTH];
+   RFILE *file = NULL;
+
+   if (string_is_empty(directory_cache))
+      return;
+
+   trace_path[0] = '\0';
+   fill_pathname_join(trace_path, directory_cache,
+         "content_load_trace.json", sizeof(trace_path));
+
+   if (!(file = filestream_open(trace_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return;
+
+   filestream_printf(file, "{\"traceEvents\":[");
+
+   for (i = 0; i < content_load_event_count; i++)
+   {
+      const struct content_load_event *evt = &content_load_events[i];
+
+      filestream_printf(file,
+            "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+            "\"ts\":%" PRId64 ",\"dur\":%" PRId64 ","
+            "\"args\":{\"bytes\":%" PRIu64 "}}",
+            (i > 0) ? "," : "",
+            content_load_stage_names[evt->stage],
+            (int64_t)(evt->start - content_load_t0),
+            (int64_t)evt->duration,
+            evt->bytes);
+   }
+
+   filestream_printf(file, "]}\n");
+   filestream_close(file);
+
+   RARCH_LOG("[CONTENT LOAD]: Wrote load trace to %s.\n", trace_path);
+}
+
+static void content_load_profile_end(const char *directory_cache)
+{
+   size_t i;
+   retro_time_t stage_time[CONTENT_LOAD_STAGE_LAST];
+   uint64_t stage_bytes[CONTENT_LOAD_STAGE_LAST];
+   unsigned stage_calls[CONTENT_LOAD_STAGE_LAST];
+   retro_time_t accounted = 0;
+   retro_time_t total     = 0;
+
+   if (!content_load_profile_active)
+      return;
+
+   content_load_profile_active = false;
+   total                       = cpu_features_get_time_usec()
+         - content_load_t0;
+
+   memset(stage_time,  0, sizeof(stage_time));
+   memset(stage_bytes, 0, sizeof(stage_bytes));
+   memset(stage_calls, 0, sizeof(stage_calls));
+
+   for (i = 0; i < content_load_event_count; i++)
+   {
+      const struct content_load_event *evt = &content_load_events[i];
+
+      stage_time [evt->stage] += evt->duration;
+      stage_bytes[evt->stage] += evt->bytes;
+      stage_calls[evt->stage]++;
+      accounted               += evt->duration;
+   }
+
+   RARCH_LOG("[CONTENT LOAD]: Load completed in %.1f ms:\n",
+         (double)total / 1000.0);
+
+   for (i = 0; i < CONTENT_LOAD_STAGE_LAST; i++)
+   {
+      double ms;
+      double mb;
+
+      if (!stage_calls[i])
+         continue;
+
+      ms = (double)stage_time[i] / 1000.0;
+      mb = (double)stage_bytes[i] / (1024.0 * 1024.0);
+
+      if (stage_bytes[i] && stage_time[i])
+         RARCH_LOG("[CONTENT LOAD]:   %-14s %8.1f ms  %8.2f MB  %7.1f MB/s  (%u calls)\n",
+               content_load_stage_names[i], ms, mb,
+               mb / ((double)stage_time[i] / 1000000.0),
+               stage_calls[i]);
+      else
+         RARCH_LOG("[CONTENT LOAD]:   %-14s %8.1f ms  (%u calls)\n",
+               content_load_stage_names[i], ms, stage_calls[i]);
+   }
+
+   if (total > accounted)
+      RARCH_LOG("[CONTENT LOAD]:   %-14s %8.1f ms\n",
+            "(other)", (double)(total - accounted) / 1000.0);
+
+   content_load_profile_write_trace(directory_cache);
+}
+
 #ifdef HAVE_CDROM
 static void task_cdrom_dump_handler(retro_task_t *task)
 {
@@ -256,6 +450,19 @@ static void task_cdrom_dump_handler(retro_task_t *task)
 
             filestream_close(state->file);
 
+            /* Key the output name to the disc itself, so
+             * that dumping the same disc again resumes into
+             * the existing files instead of starting a new
+             * dated set from scratch. */
+            {
+               uint32_t disc_hash = encoding_crc32(0,
+                     (const uint8_t*)state->toc->track,
+                     sizeof(state->toc->track[0]) * state->toc->num_tracks);
+
+               snprintf(state->title, sizeof(state->title),
+                     "cdrom-%08x", (unsigned)disc_hash);
+            }
+
             snprintf(cue_filename, sizeof(cue_filename), "%s.cue", state->title);
 
             fill_pathname_join(output_file,
@@ -359,6 +566,48 @@ static void task_cdrom_dump_handler(retro_task_t *task)
                fill_pathname_join(output_path,
                      directory_core_assets, track_filename, sizeof(output_path));
 
+               /* Resume: data already on disk from an earlier
+                * (aborted) dump of this disc does not need to
+                * be read from the drive again. */
+               if (path_is_valid(output_path))
+               {
+                  int64_t written = path_get_size(output_path);
+
+                  if (written >= state->cur_track_bytes)
+                  {
+                     RARCH_LOG("[CDROM]: Track %d already dumped, skipping...\n", state->cur_track);
+
+                     state->disc_read_bytes += state->cur_track_bytes;
+                     filestream_close(state->file);
+                     state->file = NULL;
+
+                     task_set_progress(task, (state->disc_read_bytes / (double)state->disc_total_bytes) * 100.0);
+                     break;
+                  }
+
+                  if (written > 0)
+                  {
+                     state->output_file = filestream_open(output_path,
+                           RETRO_VFS_FILE_ACCESS_WRITE | RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING, 0);
+
+                     if (state->output_file)
+                     {
+                        RARCH_LOG("[CDROM]: Resuming track %d at byte %" PRId64 "...\n", state->cur_track, written);
+
+                        filestream_seek(state->output_file, written,
+                              RETRO_VFS_SEEK_POSITION_START);
+                        filestream_seek(state->file, written,
+                              RETRO_VFS_SEEK_POSITION_START);
+
+                        state->track_written_bytes = written;
+                        state->disc_read_bytes    += written;
+
+                        state->state = DUMP_STATE_READ_TRACK;
+                        break;
+                     }
+                  }
+               }
+
                state->output_file = filestream_open(output_path, RETRO_VFS_FILE_ACCESS_WRITE, 0);
 
                if (!state->output_file)
@@ -418,7 +667,6 @@ static void task_cdrom_dump_handler(retro_task_t *task)
          }
          else if (state->cur_track_bytes == state->track_written_bytes)
          {
-            /* TODO: FIXME: this stops after only the first track */
             if (state->file)
             {
                filestream_close(state->file);
@@ -427,7 +675,7 @@ static void task_cdrom_dump_handler(retro_task_t *task)
             if (state->output_file)
             {
                filestream_close(state->output_file);
-               state->file = NULL;
+               state->output_file = NULL;
             }
 
             state->state = DUMP_STATE_NEXT_TRACK;
@@ -469,6 +717,366 @@ void task_push_cdrom_dump(const char *drive)
 }
 #endif
 
+/* Content prewarm
+ *
+ * Speculatively reads the highlighted content file (and its
+ * core) through the VFS so that the OS page cache is warm by
+ * the time the user actually starts the entry. The data is
+ * discarded - only the read side effect matters, which is
+ * what hides cold storage (NAS, HDD, SD card) latency behind
+ * menu think-time. */
+
+#define CONTENT_PREWARM_CHUNK_SIZE (512 * 1024)
+/* Do not drag arbitrarily large disc images through the
+ * page cache - past this point the eviction churn costs
+ * more than the head start is worth */
+#define CONTENT_PREWARM_MAX_BYTES  (64 * 1024 * 1024)
+
+typedef struct
+{
+   RFILE *file;
+   void *chunk;
+   char *paths[2];
+   int64_t remaining;
+   size_t next_path;
+} content_prewarm_state_t;
+
+static void task_content_prewarm_handler(retro_task_t *task)
+{
+   int64_t bytes_read             = 0;
+   content_prewarm_state_t *state = (content_prewarm_state_t*)task->state;
+
+   if (!state)
+   {
+      task_set_finished(task, true);
+      return;
+   }
+
+   if (task_get_cancelled(task))
+      goto task_finished;
+
+   /* Open the next file to be warmed */
+   if (!state->file)
+   {
+      while (state->next_path < ARRAY_SIZE(state->paths))
+      {
+         const char *path = state->paths[state->next_path++];
+
+         if (string_is_empty(path))
+            continue;
+
+         if ((state->file = filestream_open(path,
+               RETRO_VFS_FILE_ACCESS_READ,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+            break;
+      }
+
+      if (!state->file)
+         goto task_finished;
+
+      state->remaining = CONTENT_PREWARM_MAX_BYTES;
+      return;
+   }
+
+   /* Pull the next chunk into the page cache; the buffer
+    * contents are thrown away */
+   bytes_read        = filestream_read(state->file,
+         state->chunk, CONTENT_PREWARM_CHUNK_SIZE);
+   state->remaining -= bytes_read;
+
+   if (   (bytes_read < CONTENT_PREWARM_CHUNK_SIZE)
+       || (state->remaining <= 0))
+   {
+      filestream_close(state->file);
+      state->file = NULL;
+   }
+
+   return;
+
+task_finished:
+   if (state->file)
+   {
+      filestream_close(state->file);
+      state->file = NULL;
+   }
+
+   task_set_finished(task, true);
+}
+
+static void task_content_prewarm_callback(retro_task_t *task,
+      void *task_data,
+      void *user_data, const char *error)
+{
+   content_prewarm_state_t *state = (content_prewarm_state_t*)task->state;
+
+   if (!state)
+      return;
+
+   if (state->paths[0])
+      free(state->paths[0]);
+   if (state->paths[1])
+      free(state->paths[1]);
+   if (state->chunk)
+      free(state->chunk);
+   free(state);
+}
+
+static bool task_content_prewarm_finder(retro_task_t *task, void *user_data)
+{
+   content_prewarm_state_t *state = NULL;
+
+   if (!task || (task->handler != task_content_prewarm_handler))
+      return false;
+
+   state = (content_prewarm_state_t*)task->state;
+
+   return state && string_is_equal(state->paths[0],
+         (const char*)user_data);
+}
+
+bool task_push_content_prewarm(const char *content_path,
+      const char *core_path)
+{
+   task_finder_data_t find_data;
+   char archive_path[PATH_MAX_LENGTH];
+   char *delim                    = NULL;
+   retro_task_t *task             = NULL;
+   content_prewarm_state_t *state = NULL;
+
+   if (string_is_empty(content_path))
+      return false;
+
+   /* Content inside an archive warms the archive
+    * file itself */
+   strlcpy(archive_path, content_path, sizeof(archive_path));
+   if ((delim = (char*)path_get_archive_delim(archive_path)))
+      *delim = '\0';
+
+   /* A prewarm of this file may already be queued */
+   find_data.func     = task_content_prewarm_finder;
+   find_data.userdata = (void*)archive_path;
+
+   if (task_queue_find(&find_data))
+      return true;
+
+   if (!(state = (content_prewarm_state_t*)
+         calloc(1, sizeof(*state))))
+      return false;
+
+   state->paths[0] = strdup(archive_path);
+   state->chunk    = malloc(CONTENT_PREWARM_CHUNK_SIZE);
+
+   /* 'Built-in' cores (imageviewer, etc.) have no file
+    * on disk to warm */
+   if (  !string_is_empty(core_path)
+       && !string_ends_with_size(core_path, "builtin",
+            strlen(core_path), STRLEN_CONST("builtin")))
+      state->paths[1] = strdup(core_path);
+
+   task = task_init();
+
+   if (!state->paths[0] || !state->chunk || !task)
+      goto error;
+
+   task->state    = state;
+   task->handler  = task_content_prewarm_handler;
+   task->callback = task_content_prewarm_callback;
+   task->mute     = true;
+
+   task_queue_push(task);
+
+   return true;
+
+error:
+   if (task)
+      free(task);
+   if (state->paths[0])
+      free(state->paths[0]);
+   if (state->paths[1])
+      free(state->paths[1]);
+   if (state->chunk)
+      free(state->chunk);
+   free(state);
+
+   return false;
+}
+
+#ifdef HAVE_DYNAMIC
+/* Core preload
+ *
+ * dlopening a core at content-load time costs 50-200ms of mapping,
+ * relocation and constructor work. Opening the highlighted entry's
+ * core from a background task does that work behind menu think-time
+ * and keeps the handle warm in a small LRU, so the dylib_load on the
+ * actual load path collapses into a reference-count bump on the
+ * already-resident object.
+ *
+ * The cache holds its own reference only - evicting or closing an
+ * entry never unmaps a core that is in use elsewhere.
+ *
+ * TODO/FIXME - static global variable */
+#define CORE_PRELOAD_CACHE_SIZE 3
+
+static struct
+{
+   char *path;
+   dylib_t lib;
+   retro_time_t used;
+} core_preload_cache[CORE_PRELOAD_CACHE_SIZE];
+
+/* Entry points resolved after the open so that lazily-bound
+ * symbols are already looked up when the core is started.
+ * Mirrors the SYMBOL() list in retroarch.c. */
+static const char *core_preload_symbols[] = {
+   "retro_init",
+   "retro_deinit",
+   "retro_api_version",
+   "retro_get_system_info",
+   "retro_get_system_av_info",
+   "retro_set_environment",
+   "retro_set_video_refresh",
+   "retro_set_audio_sample",
+   "retro_set_audio_sample_batch",
+   "retro_set_input_poll",
+   "retro_set_input_state",
+   "retro_set_controller_port_device",
+   "retro_reset",
+   "retro_run",
+   "retro_serialize_size",
+   "retro_serialize",
+   "retro_unserialize",
+   "retro_cheat_reset",
+   "retro_cheat_set",
+   "retro_load_game",
+   "retro_load_game_special",
+   "retro_unload_game",
+   "retro_get_region",
+   "retro_get_memory_data",
+   "retro_get_memory_size"
+};
+
+static void task_core_preload_handler(retro_task_t *task)
+{
+   size_t i;
+   dylib_t lib;
+   size_t slot = 0;
+   char *path  = (char*)task->state;
+
+   if (!path || task_get_cancelled(task))
+      goto task_finished;
+
+   /* Already warm? Just refresh its LRU stamp. */
+   for (i = 0; i < CORE_PRELOAD_CACHE_SIZE; i++)
+   {
+      if (     core_preload_cache[i].path
+            && string_is_equal(core_preload_cache[i].path, path))
+      {
+         core_preload_cache[i].used = cpu_features_get_time_usec();
+         goto task_finished;
+      }
+   }
+
+   if (!(lib = dylib_load(path)))
+      goto task_finished;
+
+   for (i = 0; i < ARRAY_SIZE(core_preload_symbols); i++)
+      dylib_proc(lib, core_preload_symbols[i]);
+
+   /* Take a free slot, or evict the least recently used core */
+   for (i = 1; i < CORE_PRELOAD_CACHE_SIZE; i++)
+   {
+      if (!core_preload_cache[i].path)
+      {
+         slot = i;
+         break;
+      }
+      if (     core_preload_cache[slot].path
+            && core_preload_cache[i].used < core_preload_cache[slot].used)
+         slot = i;
+   }
+
+   if (core_preload_cache[slot].path)
+   {
+      dylib_close(core_preload_cache[slot].lib);
+      free(core_preload_cache[slot].path);
+   }
+
+   core_preload_cache[slot].path = path;
+   core_preload_cache[slot].lib  = lib;
+   core_preload_cache[slot].used = cpu_features_get_time_usec();
+
+   /* Ownership of the path string moved into the cache */
+   task->state = NULL;
+
+task_finished:
+   task_set_finished(task, true);
+}
+
+static void task_core_preload_callback(retro_task_t *task,
+      void *task_data,
+      void *user_data, const char *error)
+{
+   if (task->state)
+      free(task->state);
+}
+
+static bool task_core_preload_finder(retro_task_t *task, void *user_data)
+{
+   if (!task || (task->handler != task_core_preload_handler))
+      return false;
+
+   return task->state && string_is_equal((const char*)task->state,
+         (const char*)user_data);
+}
+#endif
+
+bool task_push_core_preload(const char *core_path)
+{
+#ifdef HAVE_DYNAMIC
+   task_finder_data_t find_data;
+   retro_task_t *task = NULL;
+   char *path         = NULL;
+
+   if (string_is_empty(core_path))
+      return false;
+
+   /* 'Built-in' cores have no library to open */
+   if (string_ends_with_size(core_path, "builtin",
+            strlen(core_path), STRLEN_CONST("builtin")))
+      return false;
+
+   /* A preload of this core may already be queued */
+   find_data.func     = task_core_preload_finder;
+   find_data.userdata = (void*)core_path;
+
+   if (task_queue_find(&find_data))
+      return true;
+
+   path = strdup(core_path);
+   task = task_init();
+
+   if (!path || !task)
+   {
+      if (path)
+         free(path);
+      if (task)
+         free(task);
+      return false;
+   }
+
+   task->state    = path;
+   task->handler  = task_core_preload_handler;
+   task->callback = task_core_preload_callback;
+   task->mute     = true;
+
+   task_queue_push(task);
+
+   return true;
+#else
+   return false;
+#endif
+}
+
 static int64_t content_file_read(const char *path, void **buf, int64_t *length)
 {
 #ifdef HAVE_COMPRESSION
@@ -675,6 +1283,7 @@ static bool load_content_into_memory(
       int64_t *length)
 {
    uint8_t *ret_buf           = NULL;
+   retro_time_t t_read        = cpu_features_get_time_usec();
 
    RARCH_LOG("[CONTENT LOAD]: %s: %s.\n",
          msg_hash_to_str(MSG_LOADING_CONTENT_FILE), path);
@@ -685,6 +1294,9 @@ static bool load_content_into_memory(
    if (*length < 0)
       return false;
 
+   content_load_profile_record(CONTENT_LOAD_STAGE_READ,
+         t_read, (uint64_t)*length);
+
    if (i == 0)
    {
       enum rarch_content_type type = path_is_media_type(path);
@@ -693,13 +1305,15 @@ static bool load_content_into_memory(
       if (type == RARCH_CONTENT_NONE)
       {
 #ifdef HAVE_PATCH
-         bool has_patch = false;
+         bool has_patch       = false;
+         retro_time_t t_patch = cpu_features_get_time_usec();
 
          /* First content file is significant, attempt to do patching,
           * CRC checking, etc. */
 
          /* Attempt to apply a patch. */
          if (!content_ctx->patch_is_blocked)
+         {
             has_patch = patch_content(
                   content_ctx->is_ips_pref,
                   content_ctx->is_bps_pref,
@@ -710,6 +1324,11 @@ static bool load_content_into_memory(
                   (uint8_t**)&ret_buf,
                   (void*)length);
 
+            if (has_patch)
+               content_load_profile_record(CONTENT_LOAD_STAGE_PATCH,
+                     t_patch, (uint64_t)*length);
+         }
+
          if (has_patch)
          {
             p_content->rom_crc = encoding_crc32(0, ret_buf, (size_t)*length);
@@ -732,6 +1351,58 @@ static bool load_content_into_memory(
    return true;
 }
 
+#ifdef HAVE_MMAP
+/**
+ * load_content_map_file:
+ * @path         : path of the content file.
+ * @buf          : receives pointer to the mapped view.
+ * @length       : receives size of the content file.
+ *
+ * Maps the content file into memory instead of reading
+ * it into a heap buffer, avoiding a full copy and
+ * hundreds of ms of read latency for large images.
+ * The mapping is private (copy-on-write), so cores
+ * that patch content in place get their own pages
+ * while read-only cores share the page cache.
+ *
+ * Returns: true if successful, false on error.
+ **/
+static bool load_content_map_file(const char *path,
+      void **buf, int64_t *length)
+{
+   void *map;
+   struct stat st;
+   int fd = open(path, O_RDONLY);
+
+   if (fd < 0)
+      return false;
+
+   if ((fstat(fd, &st) < 0) || (st.st_size <= 0))
+   {
+      close(fd);
+      return false;
+   }
+
+   map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+         MAP_PRIVATE, fd, 0);
+
+   /* Mapping keeps the file referenced - descriptor
+    * is no longer needed */
+   close(fd);
+
+   if (map == MAP_FAILED)
+      return false;
+
+   RARCH_LOG("[CONTENT LOAD]: %s (mmap): %s.\n",
+         msg_hash_to_str(MSG_LOADING_CONTENT_FILE), path);
+
+   *buf    = map;
+   *length = (int64_t)st.st_size;
+
+   return true;
+}
+#endif
+
 #ifdef HAVE_COMPRESSION
 static bool load_content_from_compressed_archive(
       content_information_ctx_t *content_ctx,
@@ -745,6 +1416,7 @@ static bool load_content_from_compressed_archive(
 {
    union string_list_elem_attr attr;
    int64_t new_path_len              = 0;
+   retro_time_t t_extract            = cpu_features_get_time_usec();
    char new_basedir[PATH_MAX_LENGTH];
    char new_path[PATH_MAX_LENGTH];
 
@@ -784,6 +1456,9 @@ static bool load_content_from_compressed_archive(
       return false;
    }
 
+   content_load_profile_record(CONTENT_LOAD_STAGE_EXTRACT,
+         t_extract, (uint64_t)new_path_len);
+
    string_list_append(additional_path_allocs, new_path, attr);
    info[i].path =
       additional_path_allocs->elems[additional_path_allocs->size - 1].data;
@@ -804,6 +1479,7 @@ static bool content_file_init_extract(
       )
 {
    unsigned i;
+   rarch_system_info_t *sys_info = runloop_get_system_info();
 
    for (i = 0; i < content->size; i++)
    {
@@ -819,12 +1495,20 @@ static bool content_file_init_extract(
       if (!contains_compressed && !path_is_compressed_file(path))
          continue;
 
+      /* A core that reads through the libretro VFS can open an
+       * explicit archive member ("file.zip#member") in place -
+       * the frontend VFS exposes it as a seekable read-only
+       * file - so no temporary extraction is needed */
+      if (contains_compressed && sys_info && sys_info->supports_vfs)
+         continue;
+
       {
          char temp_content[PATH_MAX_LENGTH];
          char new_path    [PATH_MAX_LENGTH];
          const char *valid_ext    = special ?
             special->roms[i].valid_extensions :
             content_ctx->valid_extensions;
+         retro_time_t t_extract   = cpu_features_get_time_usec();
 
          temp_content[0]          = new_path[0] = '\0';
 
@@ -853,6 +1537,9 @@ static bool content_file_init_extract(
             return false;
          }
 
+         content_load_profile_record(CONTENT_LOAD_STAGE_EXTRACT,
+               t_extract, (uint64_t)path_get_size(new_path));
+
          string_list_set(content, i, new_path);
 
          if (!string_list_append(
@@ -877,6 +1564,9 @@ static bool content_file_init_extract(
  **/
 static bool content_file_load(
       struct retro_game_info *info,
+#ifdef HAVE_MMAP
+      content_file_map_t *maps,
+#endif
       content_state_t *p_content,
       const struct string_list *content,
       content_information_ctx_t *content_ctx,
@@ -888,6 +1578,7 @@ static bool content_file_load(
 {
    unsigned i;
    retro_ctx_load_content_info_t load_info;
+   retro_time_t t_stage;
    bool used_vfs_fallback_copy = false;
 #ifdef __WINRT__
    rarch_system_info_t *system = runloop_get_system_info();
@@ -916,9 +1607,50 @@ static bool content_file_load(
       {
          /* Load the content into memory. */
 
-         int64_t len = 0;
+         int64_t len     = 0;
+         bool     loaded = false;
+
+         t_stage         = cpu_features_get_time_usec();
+
+#ifdef HAVE_MMAP
+         /* Prefer a zero-copy mapped view when possible.
+          * The mmap path cannot be used when:
+          * - content resides inside an archive
+          * - content may be soft-patched (patch_content()
+          *   reallocates the buffer on the heap) */
+         if (maps
+               && !path_contains_compressed_file(path)
+#ifdef HAVE_PATCH
+               && ((i != 0) || content_ctx->patch_is_blocked)
+#endif
+               && load_content_map_file(path,
+                     (void**)&info[i].data, &len))
+         {
+            maps[i].map  = (void*)info[i].data;
+            maps[i].size = len;
+            loaded       = true;
+
+            content_load_profile_record(CONTENT_LOAD_STAGE_READ,
+                  t_stage, (uint64_t)len);
+
+            /* First content file still determines the
+             * content CRC (calculated in the background
+             * from the file itself) */
+            if (i == 0)
+            {
+               if (path_is_media_type(path) == RARCH_CONTENT_NONE)
+               {
+                  strlcpy(p_content->pending_rom_crc_path,
+                        path, sizeof(p_content->pending_rom_crc_path));
+                  p_content->pending_rom_crc = true;
+               }
+               else
+                  p_content->rom_crc         = 0;
+            }
+         }
+#endif
 
-         if (!load_content_into_memory(
+         if (!loaded && !load_content_into_memory(
                   content_ctx, p_content,
                   i, path, (void**)&info[i].data, &len))
          {
@@ -940,14 +1672,23 @@ static bool content_file_load(
 #ifdef HAVE_COMPRESSION
          if (     !content_ctx->block_extract
                && need_fullpath
-               && path_contains_compressed_file(path)
-               && !load_content_from_compressed_archive(
-                  content_ctx,
-                  &info[i], i,
-                  additional_path_allocs, need_fullpath, path,
-                  error_enum,
-                  error_string))
-            return false;
+               && path_contains_compressed_file(path))
+         {
+            /* VFS-capable cores receive the archive-member path
+             * as-is and read the entry in place through the
+             * frontend VFS; everything else falls back to a
+             * temporary extraction into the cache directory */
+            rarch_system_info_t *sys_info = runloop_get_system_info();
+
+            if (  !(sys_info && sys_info->supports_vfs)
+                  && !load_content_from_compressed_archive(
+                     content_ctx,
+                     &info[i], i,
+                     additional_path_allocs, need_fullpath, path,
+                     error_enum,
+                     error_string))
+               return false;
+         }
 #endif
 
 #ifdef __WINRT__
@@ -1040,6 +1781,8 @@ static bool content_file_load(
    load_info.special = special;
    load_info.info    = info;
 
+   t_stage           = cpu_features_get_time_usec();
+
    if (!core_load_game(&load_info))
    {
       /* This is probably going to fail on multifile ROMs etc.
@@ -1052,6 +1795,8 @@ static bool content_file_load(
       return false;
    }
 
+   content_load_profile_record(CONTENT_LOAD_STAGE_CORE_LOAD, t_stage, 0);
+
 #ifdef HAVE_CHEEVOS
    if (!special)
    {
@@ -1059,7 +1804,12 @@ static bool content_file_load(
       enum rarch_content_type type = path_is_media_type(content_path);
 
       if (type == RARCH_CONTENT_NONE && !string_is_empty(content_path))
+      {
+         t_stage = cpu_features_get_time_usec();
          rcheevos_load(info);
+         content_load_profile_record(CONTENT_LOAD_STAGE_CHEEVOS,
+               t_stage, 0);
+      }
       else
          rcheevos_pause_hardcore();
    }
@@ -1223,10 +1973,20 @@ static bool content_file_init(
    {
       unsigned i;
       struct string_list additional_path_allocs;
-      
+#ifdef HAVE_MMAP
+      /* Failure to allocate the mapping records simply
+       * disables the mmap fast path */
+      content_file_map_t *maps = (content_file_map_t*)
+            calloc(content->size, sizeof(*maps));
+#endif
+
       if (string_list_initialize(&additional_path_allocs))
       {
-         ret = content_file_load(info, p_content,
+         ret = content_file_load(info,
+#ifdef HAVE_MMAP
+               maps,
+#endif
+               p_content,
                content, content_ctx, error_enum,
                error_string,
                special, &additional_path_allocs);
@@ -1234,8 +1994,21 @@ static bool content_file_init(
       }
 
       for (i = 0; i < content->size; i++)
+      {
+#ifdef HAVE_MMAP
+         if (maps && maps[i].map)
+         {
+            munmap(maps[i].map, (size_t)maps[i].size);
+            continue;
+         }
+#endif
          free((void*)info[i].data);
+      }
 
+#ifdef HAVE_MMAP
+      if (maps)
+         free(maps);
+#endif
       free(info);
    }
    else if (!special)
@@ -2491,6 +3264,8 @@ bool content_init(void)
    const char *path_dir_system                = settings->paths.directory_system;
    const char *path_dir_cache                 = settings->paths.directory_cache;
 
+   content_load_profile_begin();
+
    p_content->temporary_content               = string_list_new();
 
    content_ctx.check_firmware_before_loading  = check_firmware_before_loading;
@@ -2559,6 +3334,11 @@ bool content_init(void)
       string_list_deinitialize(&content);
    }
 
+   if (ret)
+      content_load_profile_end(content_ctx.directory_cache);
+   else
+      content_load_profile_active = false;
+
    if (content_ctx.name_ips)
       free(content_ctx.name_ips);
    if (content_ctx.name_bps)
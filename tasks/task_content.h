@@ -115,6 +115,18 @@ bool task_push_load_subsystem_with_core_from_menu(
       retro_task_callback_t cb,
       void *user_data);
 
+/* Speculatively reads @content_path (and, if set,
+ * @core_path) to pull both into the OS page cache ahead of
+ * an anticipated load. The task is silent and best-effort. */
+bool task_push_content_prewarm(const char *content_path,
+      const char *core_path);
+
+/* Opens @core_path in the background with its libretro entry
+ * points resolved and keeps the handle warm in a small LRU, so
+ * a subsequent core load skips the dynamic linking cost. No-op
+ * on static (non-HAVE_DYNAMIC) builds. */
+bool task_push_core_preload(const char *core_path);
+
 RETRO_END_DECLS
 
 #endif
@@ -24,12 +24,16 @@
 
 #include <string/stdstring.h>
 #include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <lists/string_list.h>
+#include <rhash.h>
 #include <streams/interface_stream.h>
 #include <streams/file_stream.h>
 #include <streams/rzip_stream.h>
 
 #include "../retroarch.h"
 #include "../paths.h"
+#include "../file_path_special.h"
 #include "../command.h"
 #include "../msg_hash.h"
 #include "../verbosity.h"
@@ -42,6 +46,33 @@
 
 #define CORE_BACKUP_CHUNK_SIZE 4096
 
+/* Automatic backups are stored in a 'chunked' format:
+ * the backup file itself is a manifest listing
+ * content-defined chunks of the core file, while the
+ * chunk data lives in a store shared between all
+ * backups of the core. Chunks unchanged between core
+ * versions are stored only once, so each new backup
+ * generation costs only its changed blocks */
+#define CORE_BACKUP_CDC_MIN_SIZE  (64 * 1024)
+#define CORE_BACKUP_CDC_MAX_SIZE  (1024 * 1024)
+/* Boundary mask - 18 zero bits gives an average
+ * chunk size of ~256 KiB */
+#define CORE_BACKUP_CDC_MASK      0x3FFFF
+
+/* Chunks are identified by the first 32 hex digits
+ * (128 bits) of the sha256 of their content */
+#define CORE_BACKUP_CHUNK_HASH_LEN 32
+
+#define CORE_BACKUP_MANIFEST_MAGIC_SIZE 8
+#define CORE_BACKUP_MANIFEST_HEADER_SIZE \
+      (CORE_BACKUP_MANIFEST_MAGIC_SIZE + 8)
+
+/* Chosen to be distinct from the '#RZIPv1#' magic
+ * of regular (non-chunked) backup files */
+static const uint8_t core_backup_manifest_magic[CORE_BACKUP_MANIFEST_MAGIC_SIZE] = {
+      '#', 'L', 'C', 'B', 'K', 'v', '1', '#'
+};
+
 enum core_backup_status
 {
    CORE_BACKUP_BEGIN = 0,
@@ -50,6 +81,7 @@ enum core_backup_status
    CORE_BACKUP_ITERATE,
    CORE_BACKUP_CHECK_HISTORY,
    CORE_BACKUP_PRUNE_HISTORY,
+   CORE_BACKUP_PRUNE_CHUNK_STORE,
    CORE_BACKUP_END,
    CORE_RESTORE_GET_CORE_CRC,
    CORE_RESTORE_GET_BACKUP_CRC,
@@ -80,6 +112,14 @@ typedef struct core_backup_handle
    intfstream_t *core_file;
    intfstream_t *backup_file;
    core_backup_list_t *backup_list;
+   /* Chunked (differential) backup state */
+   char *chunk_dir;
+   uint8_t *chunk_buf;
+   size_t chunk_buf_occupancy;
+   uint32_t num_chunks;
+   uint32_t num_chunks_reused;
+   bool chunked_format;
+   bool core_file_eof;
    enum core_backup_status status;
 } core_backup_handle_t;
 
@@ -136,10 +176,379 @@ static void free_core_backup_handle(core_backup_handle_t *backup_handle)
       backup_handle->backup_list = NULL;
    }
 
+   if (backup_handle->chunk_dir)
+   {
+      free(backup_handle->chunk_dir);
+      backup_handle->chunk_dir = NULL;
+   }
+
+   if (backup_handle->chunk_buf)
+   {
+      free(backup_handle->chunk_buf);
+      backup_handle->chunk_buf = NULL;
+   }
+
    free(backup_handle);
    backup_handle = NULL;
 }
 
+/*************************/
+/* Chunked backup format */
+/*************************/
+
+/* Gear table used by the content-defined chunking
+ * rolling hash. Filled deterministically on first
+ * use (values only have to 'look' random) */
+static uint32_t core_backup_cdc_table[256];
+static bool core_backup_cdc_table_ready = false;
+
+static void core_backup_cdc_table_init(void)
+{
+   unsigned i;
+
+   if (core_backup_cdc_table_ready)
+      return;
+
+   for (i = 0; i < 256; i++)
+   {
+      uint32_t x = (i * 2654435761u) + 0x9E3779B9u;
+
+      x ^= x >> 16;
+      x *= 0x85EBCA6Bu;
+      x ^= x >> 13;
+      x *= 0xC2B2AE35u;
+      x ^= x >> 16;
+
+      core_backup_cdc_table[i] = x;
+   }
+
+   core_backup_cdc_table_ready = true;
+}
+
+/* Returns length of the next content-defined chunk
+ * at the start of 'data'. Boundaries depend only on
+ * the data itself, so an insertion/deletion in the
+ * core file only shifts the chunks it touches */
+static size_t core_backup_find_chunk_boundary(
+      const uint8_t *data, size_t size)
+{
+   size_t i;
+   uint32_t hash = 0;
+
+   if (size <= CORE_BACKUP_CDC_MIN_SIZE)
+      return size;
+
+   core_backup_cdc_table_init();
+
+   /* The rolling hash has an implicit window of 32
+    * bytes - start just before the minimum chunk
+    * size so the window is warm when boundary
+    * checks begin */
+   for (i = CORE_BACKUP_CDC_MIN_SIZE - 32; i < size; i++)
+   {
+      hash = (hash << 1) + core_backup_cdc_table[data[i]];
+
+      if ((i >= CORE_BACKUP_CDC_MIN_SIZE) &&
+          ((hash & CORE_BACKUP_CDC_MASK) == 0))
+         return i + 1;
+   }
+
+   return size;
+}
+
+/* Writes specified chunk to the shared chunk store,
+ * unless a chunk with the same content hash already
+ * exists. Returns the chunk content hash in
+ * 'hash_str' (CORE_BACKUP_CHUNK_HASH_LEN + 1 bytes).
+ * Returns false in the event of an error */
+static bool core_backup_store_chunk(
+      core_backup_handle_t *backup_handle,
+      const uint8_t *data, size_t size,
+      char *hash_str, bool *reused)
+{
+   intfstream_t *chunk_file = NULL;
+   char sha256_str[65];
+   char chunk_path[PATH_MAX_LENGTH];
+
+   sha256_str[0] = '\0';
+   chunk_path[0] = '\0';
+
+   sha256_hash(sha256_str, data, size);
+
+   strlcpy(hash_str, sha256_str, CORE_BACKUP_CHUNK_HASH_LEN + 1);
+
+   /* Build chunk file path */
+   fill_pathname_join(chunk_path, backup_handle->chunk_dir,
+         hash_str, sizeof(chunk_path));
+   strlcat(chunk_path, FILE_PATH_CORE_BACKUP_CHUNK_EXTENSION,
+         sizeof(chunk_path));
+
+   /* If chunk is already present in the store
+    * (same content in a previous backup), there
+    * is nothing to write */
+   if (path_is_valid(chunk_path))
+   {
+      *reused = true;
+      return true;
+   }
+
+   *reused = false;
+
+   /* Write chunk file */
+#if defined(HAVE_ZLIB)
+   chunk_file = intfstream_open_rzip_file(
+         chunk_path, RETRO_VFS_FILE_ACCESS_WRITE);
+#else
+   chunk_file = intfstream_open_file(
+         chunk_path, RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+#endif
+   if (!chunk_file)
+      return false;
+
+   if (intfstream_write(chunk_file, data, size) != (int64_t)size)
+   {
+      intfstream_close(chunk_file);
+      free(chunk_file);
+
+      /* Remove partial chunk file - a truncated
+       * chunk must never be reused by a later
+       * backup */
+      filestream_delete(chunk_path);
+      return false;
+   }
+
+   intfstream_flush(chunk_file);
+   intfstream_close(chunk_file);
+   free(chunk_file);
+
+   return true;
+}
+
+/* Writes chunked backup manifest header.
+ * Returns false in the event of an error */
+static bool core_backup_write_manifest_header(
+      intfstream_t *backup_file, int64_t core_file_size)
+{
+   unsigned i;
+   uint8_t header_bytes[CORE_BACKUP_MANIFEST_HEADER_SIZE];
+
+   memcpy(header_bytes, core_backup_manifest_magic,
+         CORE_BACKUP_MANIFEST_MAGIC_SIZE);
+
+   /* > Total uncompressed core file size,
+    *   little endian */
+   for (i = 0; i < 8; i++)
+      header_bytes[CORE_BACKUP_MANIFEST_MAGIC_SIZE + i] =
+            (uint8_t)((uint64_t)core_file_size >> (i * 8));
+
+   return (intfstream_write(backup_file, header_bytes,
+         sizeof(header_bytes)) == (int64_t)sizeof(header_bytes));
+}
+
+/* Reads chunked backup manifest header, validating
+ * the 'magic numbers'. Returns false if file is not
+ * a chunked backup manifest */
+static bool core_backup_read_manifest_header(
+      intfstream_t *backup_file, int64_t *core_file_size)
+{
+   unsigned i;
+   uint64_t size = 0;
+   uint8_t header_bytes[CORE_BACKUP_MANIFEST_HEADER_SIZE];
+
+   if (intfstream_read(backup_file, header_bytes,
+         sizeof(header_bytes)) != (int64_t)sizeof(header_bytes))
+      return false;
+
+   if (memcmp(header_bytes, core_backup_manifest_magic,
+         CORE_BACKUP_MANIFEST_MAGIC_SIZE) != 0)
+      return false;
+
+   for (i = 0; i < 8; i++)
+      size |= (uint64_t)header_bytes[CORE_BACKUP_MANIFEST_MAGIC_SIZE + i]
+            << (i * 8);
+
+   *core_file_size = (int64_t)size;
+
+   return true;
+}
+
+/* Writes a single chunk reference record to a
+ * backup manifest. Returns false in the event
+ * of an error */
+static bool core_backup_write_manifest_record(
+      intfstream_t *backup_file, const char *hash_str,
+      uint32_t chunk_len)
+{
+   unsigned i;
+   uint8_t record_bytes[4 + CORE_BACKUP_CHUNK_HASH_LEN];
+
+   for (i = 0; i < 4; i++)
+      record_bytes[i] = (uint8_t)(chunk_len >> (i * 8));
+
+   memcpy(record_bytes + 4, hash_str, CORE_BACKUP_CHUNK_HASH_LEN);
+
+   return (intfstream_write(backup_file, record_bytes,
+         sizeof(record_bytes)) == (int64_t)sizeof(record_bytes));
+}
+
+/* Reads the next chunk reference record from a
+ * backup manifest.
+ * Returns 1 if a record was read, 0 if the end
+ * of the manifest was reached cleanly, and -1 in
+ * the event of an error */
+static int core_backup_read_manifest_record(
+      intfstream_t *backup_file, char *hash_str,
+      uint32_t *chunk_len)
+{
+   unsigned i;
+   int64_t length;
+   uint8_t record_bytes[4 + CORE_BACKUP_CHUNK_HASH_LEN];
+
+   length = intfstream_read(backup_file, record_bytes,
+         sizeof(record_bytes));
+
+   if (length == 0)
+      return 0;
+
+   if (length != (int64_t)sizeof(record_bytes))
+      return -1;
+
+   *chunk_len = 0;
+   for (i = 0; i < 4; i++)
+      *chunk_len |= (uint32_t)record_bytes[i] << (i * 8);
+
+   memcpy(hash_str, record_bytes + 4, CORE_BACKUP_CHUNK_HASH_LEN);
+   hash_str[CORE_BACKUP_CHUNK_HASH_LEN] = '\0';
+
+   return 1;
+}
+
+/* Deletes all chunks in the store that are no
+ * longer referenced by any backup manifest
+ * (manifests may be removed by history pruning,
+ * or directly via the menu) */
+static void core_backup_prune_chunk_store(
+      core_backup_handle_t *backup_handle)
+{
+   size_t i;
+   struct string_list *manifest_list   = NULL;
+   struct string_list *chunk_list      = NULL;
+   struct string_list *referenced_list = NULL;
+   union string_list_elem_attr attr;
+   char backup_dir[PATH_MAX_LENGTH];
+
+   attr.i        = 0;
+   backup_dir[0] = '\0';
+
+   if (string_is_empty(backup_handle->backup_path) ||
+       string_is_empty(backup_handle->chunk_dir))
+      return;
+
+   fill_pathname_parent_dir(backup_dir,
+         backup_handle->backup_path, sizeof(backup_dir));
+
+   if (string_is_empty(backup_dir))
+      return;
+
+   /* Get current chunk file list */
+   chunk_list = dir_list_new(
+         backup_handle->chunk_dir,
+         FILE_PATH_CORE_BACKUP_CHUNK_EXTENSION,
+         false, /* include_dirs */
+         false, /* include_hidden */
+         false, /* include_compressed */
+         false  /* recursive */
+   );
+
+   if (!chunk_list || (chunk_list->size < 1))
+      goto end;
+
+   /* Build list of chunk hashes referenced by the
+    * remaining backup manifests */
+   referenced_list = string_list_new();
+
+   if (!referenced_list)
+      goto end;
+
+   manifest_list = dir_list_new(
+         backup_dir,
+         FILE_PATH_CORE_BACKUP_EXTENSION,
+         false, /* include_dirs */
+         false, /* include_hidden */
+         false, /* include_compressed */
+         false  /* recursive */
+   );
+
+   if (manifest_list)
+   {
+      for (i = 0; i < manifest_list->size; i++)
+      {
+         int64_t core_file_size     = 0;
+         uint32_t chunk_len         = 0;
+         intfstream_t *manifest     = NULL;
+         char hash_str[CORE_BACKUP_CHUNK_HASH_LEN + 1];
+
+         manifest = intfstream_open_file(
+               manifest_list->elems[i].data,
+               RETRO_VFS_FILE_ACCESS_READ,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+         if (!manifest)
+            continue;
+
+         /* Regular (non-chunked) backup files are
+          * simply skipped here */
+         if (core_backup_read_manifest_header(manifest, &core_file_size))
+         {
+            while (core_backup_read_manifest_record(
+                  manifest, hash_str, &chunk_len) == 1)
+               string_list_append(referenced_list, hash_str, attr);
+         }
+
+         intfstream_close(manifest);
+         free(manifest);
+      }
+   }
+
+   /* Delete all chunk files whose hash is not
+    * referenced by any manifest */
+   for (i = 0; i < chunk_list->size; i++)
+   {
+      const char *chunk_path = chunk_list->elems[i].data;
+      char chunk_hash[PATH_MAX_LENGTH];
+
+      chunk_hash[0] = '\0';
+
+      if (string_is_empty(chunk_path))
+         continue;
+
+      strlcpy(chunk_hash, path_basename(chunk_path),
+            sizeof(chunk_hash));
+      path_remove_extension(chunk_hash);
+
+      if (string_is_empty(chunk_hash))
+         continue;
+
+      if (!string_list_find_elem(referenced_list, chunk_hash))
+      {
+         RARCH_LOG("[core backup] Pruning unreferenced chunk: %s\n",
+               chunk_path);
+         filestream_delete(chunk_path);
+      }
+   }
+
+end:
+   if (manifest_list)
+      string_list_free(manifest_list);
+
+   if (chunk_list)
+      string_list_free(chunk_list);
+
+   if (referenced_list)
+      string_list_free(referenced_list);
+}
+
 /* Forward declarations, required for task_core_backup_finder() */
 static void task_core_backup_handler(retro_task_t *task);
 
@@ -296,15 +705,65 @@ static void task_core_backup_handler(retro_task_t *task)
 
             backup_handle->backup_path = strdup(backup_path);
 
+            /* Automatic backups use the chunked format,
+             * so repeated backups of successive core
+             * versions cost only their changed blocks.
+             * Manual backups remain regular standalone
+             * files (users may copy/share these) */
+            if (backup_handle->backup_mode == CORE_BACKUP_MODE_AUTO)
+            {
+               char chunk_dir[PATH_MAX_LENGTH];
+
+               chunk_dir[0] = '\0';
+
+               if (core_backup_get_chunk_dir(
+                     backup_handle->backup_path, true,
+                     chunk_dir, sizeof(chunk_dir)))
+               {
+                  backup_handle->chunk_buf = (uint8_t*)malloc(
+                        CORE_BACKUP_CDC_MAX_SIZE);
+
+                  if (backup_handle->chunk_buf)
+                  {
+                     backup_handle->chunk_dir      = strdup(chunk_dir);
+                     backup_handle->chunked_format = true;
+                  }
+               }
+
+               /* If the chunk store is unavailable, fall
+                * back to a regular full backup */
+            }
+
             /* Open backup file */
+            if (backup_handle->chunked_format)
+            {
+               backup_handle->backup_file = intfstream_open_file(
+                     backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_WRITE,
+                     RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+               if (backup_handle->backup_file &&
+                   !core_backup_write_manifest_header(
+                        backup_handle->backup_file,
+                        backup_handle->core_file_size))
+               {
+                  RARCH_ERR("[core backup] Failed to write core backup manifest header: %s\n",
+                        backup_handle->backup_path);
+                  backup_handle->status = CORE_BACKUP_END;
+                  break;
+               }
+            }
+            else
+            {
 #if defined(HAVE_ZLIB)
-            backup_handle->backup_file = intfstream_open_rzip_file(
-                  backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_WRITE);
+               backup_handle->backup_file = intfstream_open_rzip_file(
+                     backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_WRITE);
 #else
-            backup_handle->backup_file = intfstream_open_file(
-                  backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_WRITE,
-                  RETRO_VFS_FILE_ACCESS_HINT_NONE);
+               backup_handle->backup_file = intfstream_open_file(
+                     backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_WRITE,
+                     RETRO_VFS_FILE_ACCESS_HINT_NONE);
 #endif
+            }
+
             if (!backup_handle->backup_file)
             {
                RARCH_ERR("[core backup] Failed to open core backup file: %s\n",
@@ -325,6 +784,112 @@ static void task_core_backup_handler(retro_task_t *task)
          }
          break;
       case CORE_BACKUP_ITERATE:
+         if (backup_handle->chunked_format)
+         {
+            /* Top up the chunk buffer */
+            if (!backup_handle->core_file_eof)
+            {
+               int64_t data_read = intfstream_read(
+                     backup_handle->core_file,
+                     backup_handle->chunk_buf + backup_handle->chunk_buf_occupancy,
+                     CORE_BACKUP_CDC_MAX_SIZE - backup_handle->chunk_buf_occupancy);
+
+               if (data_read < 0)
+               {
+                  RARCH_ERR("[core backup] Failed to read from core file: %s\n",
+                        backup_handle->core_path);
+                  backup_handle->status = CORE_BACKUP_END;
+                  break;
+               }
+
+               if (data_read == 0)
+                  backup_handle->core_file_eof = true;
+
+               backup_handle->chunk_buf_occupancy += (size_t)data_read;
+               backup_handle->file_data_read      += data_read;
+            }
+
+            /* Check whether the entire core file has
+             * been consumed */
+            if (backup_handle->core_file_eof &&
+                (backup_handle->chunk_buf_occupancy == 0))
+            {
+               /* Close core file */
+               intfstream_close(backup_handle->core_file);
+               free(backup_handle->core_file);
+               backup_handle->core_file   = NULL;
+
+               /* Close backup (manifest) file */
+               intfstream_flush(backup_handle->backup_file);
+               intfstream_close(backup_handle->backup_file);
+               free(backup_handle->backup_file);
+               backup_handle->backup_file = NULL;
+
+               RARCH_LOG("[core backup] Chunked backup complete: %u chunks, %u shared with previous backups\n",
+                     backup_handle->num_chunks,
+                     backup_handle->num_chunks_reused);
+
+               backup_handle->success = true;
+
+               /* Chunked backups are always automatic -
+                * check whether any old backup files
+                * should be deleted */
+               backup_handle->status  = CORE_BACKUP_CHECK_HISTORY;
+               break;
+            }
+
+            /* Emit one chunk per iteration (boundary
+             * detection requires either a full buffer
+             * or end of file) */
+            if (backup_handle->core_file_eof ||
+                (backup_handle->chunk_buf_occupancy == CORE_BACKUP_CDC_MAX_SIZE))
+            {
+               bool chunk_reused = false;
+               size_t chunk_len  = core_backup_find_chunk_boundary(
+                     backup_handle->chunk_buf,
+                     backup_handle->chunk_buf_occupancy);
+               char hash_str[CORE_BACKUP_CHUNK_HASH_LEN + 1];
+
+               hash_str[0] = '\0';
+
+               if (!core_backup_store_chunk(
+                     backup_handle, backup_handle->chunk_buf,
+                     chunk_len, hash_str, &chunk_reused))
+               {
+                  RARCH_ERR("[core backup] Failed to write chunk to core backup chunk store: %s\n",
+                        backup_handle->chunk_dir);
+                  backup_handle->status = CORE_BACKUP_END;
+                  break;
+               }
+
+               if (!core_backup_write_manifest_record(
+                     backup_handle->backup_file, hash_str,
+                     (uint32_t)chunk_len))
+               {
+                  RARCH_ERR("[core backup] Failed to write to core backup file: %s\n",
+                        backup_handle->backup_path);
+                  backup_handle->status = CORE_BACKUP_END;
+                  break;
+               }
+
+               backup_handle->num_chunks++;
+               if (chunk_reused)
+                  backup_handle->num_chunks_reused++;
+
+               /* Shift any remaining data to the start
+                * of the buffer */
+               backup_handle->chunk_buf_occupancy -= chunk_len;
+               if (backup_handle->chunk_buf_occupancy > 0)
+                  memmove(backup_handle->chunk_buf,
+                        backup_handle->chunk_buf + chunk_len,
+                        backup_handle->chunk_buf_occupancy);
+            }
+
+            /* Update progress display */
+            task_set_progress(task,
+                  (int8_t)((backup_handle->file_data_read * 100) / backup_handle->core_file_size));
+         }
+         else
          {
             int64_t data_written = 0;
             uint8_t buffer[CORE_BACKUP_CHUNK_SIZE];
@@ -431,9 +996,11 @@ static void task_core_backup_handler(retro_task_t *task)
                /* Go to history clean-up phase */
                backup_handle->status = CORE_BACKUP_PRUNE_HISTORY;
             }
-            /* No backups to remove - task is complete */
+            /* No backups to remove - check whether the
+             * chunk store needs pruning */
             else
-               backup_handle->status = CORE_BACKUP_END;
+               backup_handle->status = backup_handle->chunked_format ?
+                     CORE_BACKUP_PRUNE_CHUNK_STORE : CORE_BACKUP_END;
          }
          break;
       case CORE_BACKUP_PRUNE_HISTORY:
@@ -477,7 +1044,19 @@ static void task_core_backup_handler(retro_task_t *task)
              * reached...) */
             if ((backup_handle->num_auto_backups_to_remove < 1) ||
                 (backup_handle->backup_index >= list_size))
-               backup_handle->status = CORE_BACKUP_END;
+               backup_handle->status = backup_handle->chunked_format ?
+                     CORE_BACKUP_PRUNE_CHUNK_STORE : CORE_BACKUP_END;
+         }
+         break;
+      case CORE_BACKUP_PRUNE_CHUNK_STORE:
+         {
+            /* Deleting backup manifests (either during
+             * history pruning, or directly via the menu)
+             * may leave chunks in the store that no
+             * backup references any more - remove them */
+            core_backup_prune_chunk_store(backup_handle);
+
+            backup_handle->status = CORE_BACKUP_END;
          }
          break;
       case CORE_BACKUP_END:
@@ -604,6 +1183,13 @@ void *task_push_core_backup(
    backup_handle->core_file                  = NULL;
    backup_handle->backup_file                = NULL;
    backup_handle->backup_list                = NULL;
+   backup_handle->chunk_dir                  = NULL;
+   backup_handle->chunk_buf                  = NULL;
+   backup_handle->chunk_buf_occupancy        = 0;
+   backup_handle->num_chunks                 = 0;
+   backup_handle->num_chunks_reused          = 0;
+   backup_handle->chunked_format             = false;
+   backup_handle->core_file_eof              = false;
    backup_handle->status                     = CORE_BACKUP_BEGIN;
 
    /* Create task */
@@ -754,15 +1340,74 @@ static void task_core_restore_handler(retro_task_t *task)
 
             task_title[0] = '\0';
 
-            /* Open backup file */
-#if defined(HAVE_ZLIB)
-            backup_handle->backup_file = intfstream_open_rzip_file(
-                  backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_READ);
-#else
+            /* Open backup file
+             * > Check first whether this is a chunked
+             *   (manifest) backup, as written by
+             *   automatic backups */
             backup_handle->backup_file = intfstream_open_file(
                   backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_READ,
                   RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+            if (backup_handle->backup_file)
+            {
+               int64_t core_file_size = 0;
+
+               if (core_backup_read_manifest_header(
+                     backup_handle->backup_file, &core_file_size))
+               {
+                  char chunk_dir[PATH_MAX_LENGTH];
+
+                  chunk_dir[0] = '\0';
+
+                  /* This is a chunked backup - cache
+                   * chunk store location and allocate
+                   * chunk read buffer */
+                  backup_handle->chunk_buf = (uint8_t*)malloc(
+                        CORE_BACKUP_CDC_MAX_SIZE);
+
+                  if (!backup_handle->chunk_buf ||
+                      !core_backup_get_chunk_dir(
+                           backup_handle->backup_path, false,
+                           chunk_dir, sizeof(chunk_dir)))
+                  {
+                     RARCH_ERR("[core restore] Failed to locate chunk store of core backup file: %s\n",
+                           backup_handle->backup_path);
+                     backup_handle->status = CORE_RESTORE_END;
+                     break;
+                  }
+
+                  backup_handle->chunk_dir        = strdup(chunk_dir);
+                  backup_handle->chunked_format   = true;
+
+                  /* For chunked backups, 'backup file size'
+                   * is the total *reconstructed* core size
+                   * (used for progress display) */
+                  backup_handle->backup_file_size = core_file_size;
+               }
+               else
+               {
+                  /* Regular backup - reopen via the
+                   * standard (compressed) stream
+                   * interface */
+                  intfstream_close(backup_handle->backup_file);
+                  free(backup_handle->backup_file);
+                  backup_handle->backup_file = NULL;
+               }
+            }
+
+            if (!backup_handle->chunked_format &&
+                !backup_handle->backup_file)
+            {
+#if defined(HAVE_ZLIB)
+               backup_handle->backup_file = intfstream_open_rzip_file(
+                     backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_READ);
+#else
+               backup_handle->backup_file = intfstream_open_file(
+                     backup_handle->backup_path, RETRO_VFS_FILE_ACCESS_READ,
+                     RETRO_VFS_FILE_ACCESS_HINT_NONE);
 #endif
+            }
+
             if (!backup_handle->backup_file)
             {
                RARCH_ERR("[core restore] Failed to open core backup file: %s\n",
@@ -772,7 +1417,8 @@ static void task_core_restore_handler(retro_task_t *task)
             }
 
             /* Get backup file size */
-            backup_handle->backup_file_size = intfstream_get_size(backup_handle->backup_file);
+            if (!backup_handle->chunked_format)
+               backup_handle->backup_file_size = intfstream_get_size(backup_handle->backup_file);
 
             if (backup_handle->backup_file_size <= 0)
             {
@@ -830,6 +1476,121 @@ static void task_core_restore_handler(retro_task_t *task)
          }
          break;
       case CORE_RESTORE_ITERATE:
+         if (backup_handle->chunked_format)
+         {
+            uint32_t chunk_len       = 0;
+            int64_t data_written     = 0;
+            int64_t chunk_data_read  = 0;
+            intfstream_t *chunk_file = NULL;
+            int record_status;
+            char hash_str[CORE_BACKUP_CHUNK_HASH_LEN + 1];
+            char chunk_path[PATH_MAX_LENGTH];
+
+            hash_str[0]   = '\0';
+            chunk_path[0] = '\0';
+
+            /* Read next chunk reference from the manifest */
+            record_status = core_backup_read_manifest_record(
+                  backup_handle->backup_file, hash_str, &chunk_len);
+
+            if ((record_status < 0) ||
+                ((record_status == 1) &&
+                     ((chunk_len == 0) ||
+                      (chunk_len > CORE_BACKUP_CDC_MAX_SIZE))))
+            {
+               RARCH_ERR("[core restore] Core backup file is corrupt: %s\n",
+                     backup_handle->backup_path);
+               backup_handle->status = CORE_RESTORE_END;
+               break;
+            }
+
+            /* Check whether we have reached the end
+             * of the manifest */
+            if (record_status == 0)
+            {
+               /* Ensure the reconstructed file has the
+                * expected size */
+               if (backup_handle->file_data_read !=
+                     backup_handle->backup_file_size)
+               {
+                  RARCH_ERR("[core restore] Core backup file is incomplete: %s\n",
+                        backup_handle->backup_path);
+                  backup_handle->status = CORE_RESTORE_END;
+                  break;
+               }
+
+               /* Close backup file */
+               intfstream_close(backup_handle->backup_file);
+               free(backup_handle->backup_file);
+               backup_handle->backup_file = NULL;
+
+               /* Close core file */
+               intfstream_flush(backup_handle->core_file);
+               intfstream_close(backup_handle->core_file);
+               free(backup_handle->core_file);
+               backup_handle->core_file   = NULL;
+
+               backup_handle->success = true;
+               backup_handle->status  = CORE_RESTORE_END;
+               break;
+            }
+
+            /* Read chunk data from the shared store */
+            fill_pathname_join(chunk_path, backup_handle->chunk_dir,
+                  hash_str, sizeof(chunk_path));
+            strlcat(chunk_path, FILE_PATH_CORE_BACKUP_CHUNK_EXTENSION,
+                  sizeof(chunk_path));
+
+#if defined(HAVE_ZLIB)
+            chunk_file = intfstream_open_rzip_file(
+                  chunk_path, RETRO_VFS_FILE_ACCESS_READ);
+#else
+            chunk_file = intfstream_open_file(
+                  chunk_path, RETRO_VFS_FILE_ACCESS_READ,
+                  RETRO_VFS_FILE_ACCESS_HINT_NONE);
+#endif
+            if (!chunk_file)
+            {
+               RARCH_ERR("[core restore] Failed to open core backup chunk file: %s\n",
+                     chunk_path);
+               backup_handle->status = CORE_RESTORE_END;
+               break;
+            }
+
+            chunk_data_read = intfstream_read(
+                  chunk_file, backup_handle->chunk_buf, chunk_len);
+
+            intfstream_close(chunk_file);
+            free(chunk_file);
+            chunk_file = NULL;
+
+            if (chunk_data_read != (int64_t)chunk_len)
+            {
+               RARCH_ERR("[core restore] Core backup chunk file is corrupt: %s\n",
+                     chunk_path);
+               backup_handle->status = CORE_RESTORE_END;
+               break;
+            }
+
+            /* Write chunk to core file */
+            data_written = intfstream_write(backup_handle->core_file,
+                  backup_handle->chunk_buf, chunk_len);
+
+            if (data_written != (int64_t)chunk_len)
+            {
+               RARCH_ERR("[core restore] Failed to write to core file: %s\n",
+                     backup_handle->core_path);
+               backup_handle->status = CORE_RESTORE_END;
+               break;
+            }
+
+            backup_handle->file_data_read += chunk_len;
+
+            /* Update progress display */
+            task_set_progress(task,
+                  (int8_t)((backup_handle->file_data_read * 100) / backup_handle->backup_file_size));
+         }
+         else
          {
             int64_t data_read    = 0;
             int64_t data_written = 0;
@@ -1052,6 +1813,13 @@ bool task_push_core_restore(const char *backup_path, const char *dir_libretro,
    backup_handle->core_file                  = NULL;
    backup_handle->backup_file                = NULL;
    backup_handle->backup_list                = NULL;
+   backup_handle->chunk_dir                  = NULL;
+   backup_handle->chunk_buf                  = NULL;
+   backup_handle->chunk_buf_occupancy        = 0;
+   backup_handle->num_chunks                 = 0;
+   backup_handle->num_chunks_reused          = 0;
+   backup_handle->chunked_format             = false;
+   backup_handle->core_file_eof              = false;
    backup_handle->status                     = CORE_RESTORE_GET_CORE_CRC;
 
    /* Create task */
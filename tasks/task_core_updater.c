@@ -334,8 +334,10 @@ static void task_core_updater_get_list_handler(retro_task_t *task)
 
             transf->user_data = (void*)list_handle;
 
-            /* Push HTTP transfer task */
-            list_handle->http_task = (retro_task_t*)task_push_http_transfer_file(
+            /* Push HTTP transfer task. The core list rarely
+             * changes between sessions, so revalidate a cached
+             * copy instead of re-downloading it every time */
+            list_handle->http_task = (retro_task_t*)task_push_http_transfer_file_cached(
                   buildbot_url, true, NULL,
                   cb_http_task_core_updater_get_list, transf);
 
@@ -481,6 +483,7 @@ void *task_push_get_core_updater_list(
    /* Configure task */
    task->handler          = task_core_updater_get_list_handler;
    task->state            = list_handle;
+   task->priority         = TASK_PRIORITY_BULK;
    task->mute             = mute;
    task->title            = strdup(msg_hash_to_str(MSG_FETCHING_CORE_LIST));
    task->alternative_look = true;
@@ -826,8 +829,11 @@ static void task_core_updater_download_handler(retro_task_t *task)
 
             transf->user_data = (void*)download_handle;
 
-            /* Push HTTP transfer task */
-            download_handle->http_task = (retro_task_t*)task_push_http_transfer_file(
+            /* Push HTTP transfer task. Cores are large enough to
+             * benefit from fetching several ranges in parallel;
+             * servers without range support fall back to a
+             * regular single-connection download */
+            download_handle->http_task = (retro_task_t*)task_push_http_transfer_file_segmented(
                   download_handle->remote_core_path, true, NULL,
                   cb_http_task_core_updater_download, transf);
 
@@ -1112,6 +1118,7 @@ void *task_push_core_updater_download(
 
    task->handler          = task_core_updater_download_handler;
    task->state            = download_handle;
+   task->priority         = TASK_PRIORITY_BULK;
    task->mute             = mute;
    task->title            = strdup(task_title);
    task->alternative_look = true;
@@ -1520,6 +1527,7 @@ void task_push_update_installed_cores(
    /* Configure task */
    task->handler          = task_update_installed_cores_handler;
    task->state            = update_installed_handle;
+   task->priority         = TASK_PRIORITY_BULK;
    task->title            = strdup(msg_hash_to_str(MSG_FETCHING_CORE_LIST));
    task->alternative_look = true;
    task->progress         = 0;
@@ -1847,6 +1855,7 @@ void *task_push_play_feature_delivery_core_install(
 
    task->handler          = task_play_feature_delivery_core_install_handler;
    task->state            = pfd_install_handle;
+   task->priority         = TASK_PRIORITY_BULK;
    task->mute             = mute;
    task->title            = strdup(task_title);
    task->alternative_look = true;
@@ -2222,6 +2231,7 @@ void task_push_play_feature_delivery_switch_installed_cores(
    /* Configure task */
    task->handler          = task_play_feature_delivery_switch_cores_handler;
    task->state            = pfd_switch_cores_handle;
+   task->priority         = TASK_PRIORITY_BULK;
    task->title            = strdup(msg_hash_to_str(MSG_SCANNING_CORES));
    task->alternative_look = true;
    task->progress         = 0;
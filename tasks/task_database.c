@@ -27,10 +27,16 @@
 #include <streams/file_stream.h>
 #include <streams/chd_stream.h>
 #include <streams/interface_stream.h>
+#ifdef HAVE_THREADS
+#include <features/features_cpu.h>
+#include <rthreads/rthreads.h>
+#include <rthreads/tpool.h>
+#endif
 #include "tasks_internal.h"
 
 #include "../core_info.h"
 #include "../database_info.h"
+#include "../libretro-db/libretrodb.h"
 
 #include "../file_path_special.h"
 #include "../msg_hash.h"
@@ -56,6 +62,77 @@ typedef struct database_state_handle
    char serial[4096];
 } database_state_handle_t;
 
+#ifdef HAVE_THREADS
+/* CRC prehash pipeline
+ * > While the scan task processes one file, a small
+ *   worker pool reads and hashes the files that come
+ *   next in the directory listing, so I/O and hashing
+ *   overlap instead of being serialised on the task
+ *   thread
+ * > The queue is bounded: at most DB_PREHASH_SLOTS
+ *   files are read ahead, capping memory and I/O
+ *   pressure */
+#define DB_PREHASH_SLOTS       8
+#define DB_PREHASH_MAX_THREADS 4
+
+enum db_prehash_status
+{
+   DB_PREHASH_EMPTY = 0,
+   DB_PREHASH_PENDING,
+   DB_PREHASH_READY
+};
+
+typedef struct db_prehash db_prehash_t;
+
+typedef struct db_prehash_slot
+{
+   db_prehash_t *owner;
+   char *path;
+   size_t list_idx;
+   uint32_t crc;
+   int rv;
+   enum db_prehash_status status;
+} db_prehash_slot_t;
+
+struct db_prehash
+{
+   tpool_t *pool;
+   slock_t *lock;
+   scond_t *ready_cond;
+   db_prehash_slot_t slots[DB_PREHASH_SLOTS];
+   /* Next directory listing index to consider
+    * for submission */
+   size_t next_idx;
+};
+#endif
+
+/* Merged CRC index
+ * > Built once per scan from every selected .rdb:
+ *   maps each crc value found in any database to a
+ *   bitmask of the databases that contain it
+ * > The per-file match loop probes the index and only
+ *   runs the (expensive) rdb query against databases
+ *   whose bit is set, so matching costs one hash probe
+ *   per file instead of one query per selected database */
+#define DB_CRC_INDEX_MAX_DBS  64
+#define DB_CRC_INDEX_MIN_CAP  4096
+
+typedef struct db_crc_index_entry
+{
+   uint64_t mask;
+   uint32_t crc;
+} db_crc_index_entry_t;
+
+typedef struct db_crc_index
+{
+   db_crc_index_entry_t *entries;
+   size_t cap; /* Power of two */
+   size_t len;
+   /* Databases that could not be scanned while building;
+    * these are always probed the old way */
+   uint64_t unknown_mask;
+} db_crc_index_t;
+
 typedef struct db_handle
 {
    char *playlist_directory;
@@ -69,6 +146,11 @@ typedef struct db_handle
    bool scan_started;
    bool scan_without_core_match;
    bool show_hidden_files;
+#ifdef HAVE_THREADS
+   db_prehash_t *prehash;
+#endif
+   db_crc_index_t *crc_index;
+   bool crc_index_tried;
 } db_handle_t;
 
 /* Forward declarations */
@@ -557,7 +639,478 @@ static enum msg_file_type extension_to_file_type(const char *ext)
    return FILE_TYPE_NONE;
 }
 
+#ifdef RARCH_INTERNAL
+/* Disc metadata cache
+ * > Extracting a serial means reading raw sectors and a
+ *   missing serial falls back to CRC'ing the whole data
+ *   track, so rescanning a large disc library repeats a
+ *   lot of expensive I/O for files that have not changed
+ * > Cache the serial/CRC per disc image in a small text
+ *   file in the cache directory, validated against the
+ *   size of the image and the summed sizes of any files
+ *   its cue/gdi sheet references (the VFS exposes no
+ *   modification time, so size is the change signal) */
+#define DISC_CACHE_FILE_EXTENSION "disccache"
+#define DISC_CACHE_MAGIC          "#DCACHEv1#"
+
+static void task_database_disc_cache_trim(char *s)
+{
+   size_t len = strlen(s);
+   while (len > 0 && (s[len - 1] == '\n' || s[len - 1] == '\r'))
+      s[--len] = '\0';
+}
+
+static int64_t task_database_disc_file_size(const char *path)
+{
+   int64_t file_size = -1;
+   intfstream_t *fd  = intfstream_open_file(path,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!fd)
+      return -1;
+
+   if (intfstream_seek(fd, 0, SEEK_END) != -1)
+      file_size = intfstream_tell(fd);
+
+   intfstream_close(fd);
+   free(fd);
+   return file_size;
+}
+
+/* Sums the sizes of every file referenced by a cue/gdi
+ * sheet, so edits to a .bin that leave the sheet alone
+ * still invalidate the cache entry */
+static int64_t task_database_disc_tracks_size(const char *name,
+      bool is_gdi)
+{
+   char path[PATH_MAX_LENGTH];
+   int64_t total    = 0;
+   intfstream_t *fd = intfstream_open_file(name,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!fd)
+      return -1;
+
+   path[0] = '\0';
+
+   for (;;)
+   {
+      int64_t track_size;
+
+      if (is_gdi)
+      {
+         if (!gdi_next_file(fd, name, path, sizeof(path)))
+            break;
+      }
+      else if (!cue_next_file(fd, name, path, sizeof(path)))
+         break;
+
+      if ((track_size = task_database_disc_file_size(path)) < 0)
+      {
+         total = -1;
+         break;
+      }
+      total += track_size;
+   }
+
+   intfstream_close(fd);
+   free(fd);
+   return total;
+}
+
+static bool task_database_disc_cache_entry_path(const char *name,
+      char *path, size_t len)
+{
+   char fname[64];
+   settings_t *settings = config_get_ptr();
+   const char *dir      = settings ? settings->paths.directory_cache : NULL;
+   uint32_t hash_a      = 5381;
+   uint32_t hash_b      = 0;
+   const char *str      = NULL;
+
+   if (string_is_empty(dir))
+      return false;
+
+   /* The entry records the full content path, so a hash
+    * collision only costs a cache miss */
+   for (str = name; *str; str++)
+   {
+      hash_a = ((hash_a << 5) + hash_a) ^ (uint32_t)*str;
+      hash_b = (uint32_t)*str + (hash_b << 6) + (hash_b << 16) - hash_b;
+   }
+
+   fname[0] = '\0';
+   snprintf(fname, sizeof(fname), "%08lx%08lx.%s",
+         (unsigned long)hash_a, (unsigned long)hash_b,
+         DISC_CACHE_FILE_EXTENSION);
+
+   fill_pathname_join(path, dir, fname, len);
+   return true;
+}
+
+/* On a hit, fills in the cached serial or CRC, sets
+ * db->type accordingly and returns true; any mismatch
+ * (path, sizes, format) is a miss and the caller takes
+ * the slow path */
+static bool task_database_disc_cache_load(const char *name,
+      database_info_handle_t *db, char *serial, size_t serial_len,
+      uint32_t *crc)
+{
+   char entry_path[PATH_MAX_LENGTH];
+   char line[PATH_MAX_LENGTH];
+   int64_t cached_content_size = -1;
+   int64_t cached_tracks_size  = -1;
+   int64_t tracks_size         = 0;
+   enum msg_file_type type     =
+         extension_to_file_type(path_get_extension(name));
+   RFILE *file                 = NULL;
+
+   entry_path[0] = '\0';
+
+   if (!task_database_disc_cache_entry_path(name,
+         entry_path, sizeof(entry_path)))
+      return false;
+
+   if (!(file = filestream_open(entry_path,
+         RETRO_VFS_FILE_ACCESS_READ, RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return false;
+
+   line[0] = '\0';
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto miss;
+   task_database_disc_cache_trim(line);
+   if (!string_is_equal(line, DISC_CACHE_MAGIC))
+      goto miss;
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto miss;
+   task_database_disc_cache_trim(line);
+   if (!string_is_equal(line, name))
+      goto miss;
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto miss;
+   if (sscanf(line, "%" PRId64 " %" PRId64,
+         &cached_content_size, &cached_tracks_size) != 2)
+      goto miss;
+
+   if (cached_content_size <= 0 ||
+         cached_content_size != task_database_disc_file_size(name))
+      goto miss;
+
+   if (type == FILE_TYPE_CUE || type == FILE_TYPE_GDI)
+      tracks_size = task_database_disc_tracks_size(name,
+            type == FILE_TYPE_GDI);
+   if (cached_tracks_size != tracks_size)
+      goto miss;
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto miss;
+   task_database_disc_cache_trim(line);
+
+   if (!string_is_empty(line))
+   {
+      strlcpy(serial, line, serial_len);
+      db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+   }
+   else
+   {
+      if (!filestream_gets(file, line, sizeof(line)))
+         goto miss;
+      task_database_disc_cache_trim(line);
+      if (string_is_empty(line) || line[0] == '-')
+         goto miss;
+      *crc     = (uint32_t)strtoul(line, NULL, 16);
+      db->type = DATABASE_TYPE_CRC_LOOKUP;
+   }
+
+   filestream_close(file);
+   RARCH_LOG("[DiscCache]: Using cached metadata for: %s\n", name);
+   return true;
+
+miss:
+   filestream_close(file);
+   return false;
+}
+
+static void task_database_disc_cache_save(const char *name,
+      const char *serial, const uint32_t *crc)
+{
+   char entry_path[PATH_MAX_LENGTH];
+   int64_t content_size    = -1;
+   int64_t tracks_size     = 0;
+   enum msg_file_type type =
+         extension_to_file_type(path_get_extension(name));
+   RFILE *file             = NULL;
+
+   /* Nothing worth remembering */
+   if (string_is_empty(serial) && !crc)
+      return;
+
+   entry_path[0] = '\0';
+
+   if (!task_database_disc_cache_entry_path(name,
+         entry_path, sizeof(entry_path)))
+      return;
+
+   if ((content_size = task_database_disc_file_size(name)) <= 0)
+      return;
+
+   if (type == FILE_TYPE_CUE || type == FILE_TYPE_GDI)
+   {
+      if ((tracks_size = task_database_disc_tracks_size(name,
+            type == FILE_TYPE_GDI)) < 0)
+         return;
+   }
+
+   if (!(file = filestream_open(entry_path,
+         RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return;
+
+   filestream_printf(file, "%s\n", DISC_CACHE_MAGIC);
+   filestream_printf(file, "%s\n", name);
+   filestream_printf(file, "%" PRId64 " %" PRId64 "\n",
+         content_size, tracks_size);
+   filestream_printf(file, "%s\n", serial ? serial : "");
+   if (crc)
+      filestream_printf(file, "%08lx\n", (unsigned long)*crc);
+   else
+      filestream_printf(file, "-\n");
+
+   filestream_close(file);
+}
+#endif
+
+#ifdef HAVE_THREADS
+/* CRC prehash pipeline implementation */
+
+/* Only file types whose scan CRC is a straight
+ * whole-file hash can be computed ahead of time */
+static bool db_prehash_eligible(const char *path)
+{
+   switch (extension_to_file_type(path_get_extension(path)))
+   {
+      case FILE_TYPE_COMPRESSED:
+      case FILE_TYPE_NONE:
+         return !path_contains_compressed_file(path);
+      default:
+         break;
+   }
+   return false;
+}
+
+static void db_prehash_worker(void *data)
+{
+   db_prehash_slot_t *slot = (db_prehash_slot_t*)data;
+   db_prehash_t *ph        = slot->owner;
+   uint32_t crc            = 0;
+   int rv                  = intfstream_file_get_crc(
+         slot->path, 0, SIZE_MAX, &crc);
+
+   slock_lock(ph->lock);
+   slot->crc    = crc;
+   slot->rv     = rv;
+   slot->status = DB_PREHASH_READY;
+   scond_signal(ph->ready_cond);
+   slock_unlock(ph->lock);
+}
+
+static db_prehash_t *db_prehash_new(void)
+{
+   unsigned threads;
+   db_prehash_t *ph = (db_prehash_t*)calloc(1, sizeof(*ph));
+
+   if (!ph)
+      return NULL;
+
+   threads = cpu_features_get_core_amount();
+   if (threads > DB_PREHASH_MAX_THREADS)
+      threads = DB_PREHASH_MAX_THREADS;
+   if (threads < 2)
+      threads = 2;
+
+   ph->lock       = slock_new();
+   ph->ready_cond = scond_new();
+   ph->pool       = tpool_create(threads);
+
+   if (!ph->lock || !ph->ready_cond || !ph->pool)
+   {
+      if (ph->pool)
+         tpool_destroy(ph->pool);
+      if (ph->ready_cond)
+         scond_free(ph->ready_cond);
+      if (ph->lock)
+         slock_free(ph->lock);
+      free(ph);
+      return NULL;
+   }
+
+   return ph;
+}
+
+static void db_prehash_free(db_prehash_t *ph)
+{
+   size_t i;
+
+   if (!ph)
+      return;
+
+   /* Workers reference slot memory - must drain
+    * the pool before freeing anything */
+   tpool_wait(ph->pool);
+   tpool_destroy(ph->pool);
+
+   for (i = 0; i < DB_PREHASH_SLOTS; i++)
+      if (ph->slots[i].path)
+         free(ph->slots[i].path);
+
+   scond_free(ph->ready_cond);
+   slock_free(ph->lock);
+   free(ph);
+}
+
+/* Submits hash jobs for upcoming directory listing
+ * entries, keeping at most DB_PREHASH_SLOTS files
+ * in flight. Called from the task thread. */
+static void db_prehash_pump(db_prehash_t *ph,
+      database_info_handle_t *dbinfo)
+{
+   size_t i;
+
+   if (!ph || !dbinfo || !dbinfo->list)
+      return;
+
+   if (ph->next_idx < dbinfo->list_ptr)
+      ph->next_idx = dbinfo->list_ptr;
+
+   slock_lock(ph->lock);
+
+   /* Reclaim results the scan skipped past
+    * (e.g. entries pruned by cue/gdi handling
+    *  after submission) */
+   for (i = 0; i < DB_PREHASH_SLOTS; i++)
+   {
+      db_prehash_slot_t *slot = &ph->slots[i];
+      if ((slot->status == DB_PREHASH_READY) &&
+          (slot->list_idx < dbinfo->list_ptr))
+      {
+         free(slot->path);
+         slot->path   = NULL;
+         slot->status = DB_PREHASH_EMPTY;
+      }
+   }
+
+   while (ph->next_idx < dbinfo->list->size)
+   {
+      const char *path        = dbinfo->list->elems[ph->next_idx].data;
+      db_prehash_slot_t *slot = NULL;
+
+      /* Skip pruned/ineligible entries */
+      if (!path || !db_prehash_eligible(path))
+      {
+         ph->next_idx++;
+         continue;
+      }
+
+      /* Find a free slot - if there is none,
+       * the bounded queue is full */
+      for (i = 0; i < DB_PREHASH_SLOTS; i++)
+      {
+         if (ph->slots[i].status == DB_PREHASH_EMPTY)
+         {
+            slot = &ph->slots[i];
+            break;
+         }
+      }
+
+      if (!slot)
+         break;
+
+      slot->owner    = ph;
+      slot->path     = strdup(path);
+      slot->list_idx = ph->next_idx;
+      slot->crc      = 0;
+      slot->rv       = 0;
+      slot->status   = DB_PREHASH_PENDING;
+
+      if (!tpool_add_work(ph->pool, db_prehash_worker, slot))
+      {
+         free(slot->path);
+         slot->path   = NULL;
+         slot->status = DB_PREHASH_EMPTY;
+         break;
+      }
+
+      ph->next_idx++;
+   }
+
+   slock_unlock(ph->lock);
+}
+
+/* Fetches the prehashed CRC for 'path', waiting for
+ * the worker if the job is still in flight.
+ * Returns true if the pipeline owned this path (in
+ * which case 'rv'/'crc' are valid), false if the
+ * caller must hash synchronously. */
+static bool db_prehash_get(db_prehash_t *ph,
+      const char *path, uint32_t *crc, int *rv)
+{
+   size_t i;
+   db_prehash_slot_t *slot = NULL;
+
+   if (!ph)
+      return false;
+
+   slock_lock(ph->lock);
+
+   for (i = 0; i < DB_PREHASH_SLOTS; i++)
+   {
+      if ((ph->slots[i].status != DB_PREHASH_EMPTY) &&
+          ph->slots[i].path &&
+          string_is_equal(ph->slots[i].path, path))
+      {
+         slot = &ph->slots[i];
+         break;
+      }
+   }
+
+   if (!slot)
+   {
+      slock_unlock(ph->lock);
+      return false;
+   }
+
+   while (slot->status != DB_PREHASH_READY)
+      scond_wait(ph->ready_cond, ph->lock);
+
+   *crc         = slot->crc;
+   *rv          = slot->rv;
+
+   free(slot->path);
+   slot->path   = NULL;
+   slot->status = DB_PREHASH_EMPTY;
+
+   slock_unlock(ph->lock);
+   return true;
+}
+#endif
+
+/* Computes the scan CRC of a content file, preferring
+ * a result already produced by the prehash pipeline */
+static int task_database_file_get_crc(db_handle_t *_db,
+      const char *name, uint32_t *crc)
+{
+#ifdef HAVE_THREADS
+   int rv = 0;
+   if (_db && _db->prehash &&
+       db_prehash_get(_db->prehash, name, crc, &rv))
+      return rv;
+#endif
+   return intfstream_file_get_crc(name, 0, SIZE_MAX, crc);
+}
+
 static int task_database_iterate_playlist(
+      db_handle_t *_db,
       database_state_handle_t *db_state,
       database_info_handle_t *db, const char *name)
 {
@@ -567,50 +1120,106 @@ static int task_database_iterate_playlist(
 #ifdef HAVE_COMPRESSION
          db->type = DATABASE_TYPE_CRC_LOOKUP;
          /* first check crc of archive itself */
-         return intfstream_file_get_crc(name,
-               0, SIZE_MAX, &db_state->archive_crc);
+         return task_database_file_get_crc(_db,
+               name, &db_state->archive_crc);
 #else
          break;
 #endif
       case FILE_TYPE_CUE:
          task_database_cue_prune(db, name);
          db_state->serial[0] = '\0';
+#ifdef RARCH_INTERNAL
+         if (task_database_disc_cache_load(name, db,
+               db_state->serial, sizeof(db_state->serial),
+               &db_state->crc))
+            return 1;
+#endif
          if (task_database_cue_get_serial(name, db_state->serial))
+         {
             db->type = DATABASE_TYPE_SERIAL_LOOKUP;
+#ifdef RARCH_INTERNAL
+            task_database_disc_cache_save(name, db_state->serial, NULL);
+#endif
+         }
          else
          {
+            int rv   = 0;
             db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_cue_get_crc(name, &db_state->crc);
+            rv       = task_database_cue_get_crc(name, &db_state->crc);
+#ifdef RARCH_INTERNAL
+            if (rv == 1)
+               task_database_disc_cache_save(name, NULL, &db_state->crc);
+#endif
+            return rv;
          }
          break;
       case FILE_TYPE_GDI:
          gdi_prune(db, name);
          db_state->serial[0] = '\0';
+#ifdef RARCH_INTERNAL
+         if (task_database_disc_cache_load(name, db,
+               db_state->serial, sizeof(db_state->serial),
+               &db_state->crc))
+            return 1;
+#endif
          /* There are no serial databases, so don't bother with
             serials at the moment */
          if (0 && task_database_gdi_get_serial(name, db_state->serial))
             db->type = DATABASE_TYPE_SERIAL_LOOKUP;
          else
          {
+            int rv   = 0;
             db->type = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_gdi_get_crc(name, &db_state->crc);
+            rv       = task_database_gdi_get_crc(name, &db_state->crc);
+#ifdef RARCH_INTERNAL
+            if (rv == 1)
+               task_database_disc_cache_save(name, NULL, &db_state->crc);
+#endif
+            return rv;
          }
          break;
       /* Consider Wii WBFS files similar to ISO files. */
       case FILE_TYPE_WBFS:
       case FILE_TYPE_ISO:
          db_state->serial[0] = '\0';
+#ifdef RARCH_INTERNAL
+         if (task_database_disc_cache_load(name, db,
+               db_state->serial, sizeof(db_state->serial),
+               &db_state->crc))
+            return 1;
+#endif
          intfstream_file_get_serial(name, 0, SIZE_MAX, db_state->serial);
          db->type            =  DATABASE_TYPE_SERIAL_LOOKUP;
+#ifdef RARCH_INTERNAL
+         if (!string_is_empty(db_state->serial))
+            task_database_disc_cache_save(name, db_state->serial, NULL);
+#endif
          break;
       case FILE_TYPE_CHD:
          db_state->serial[0] = '\0';
+#ifdef RARCH_INTERNAL
+         if (task_database_disc_cache_load(name, db,
+               db_state->serial, sizeof(db_state->serial),
+               &db_state->crc))
+            return 1;
+#endif
          if (task_database_chd_get_serial(name, db_state->serial))
+         {
             db->type         = DATABASE_TYPE_SERIAL_LOOKUP;
+#ifdef RARCH_INTERNAL
+            task_database_disc_cache_save(name, db_state->serial, NULL);
+#endif
+         }
          else
          {
+            bool rv          = false;
             db->type         = DATABASE_TYPE_CRC_LOOKUP;
-            return task_database_chd_get_crc(name, &db_state->crc);
+            rv               = task_database_chd_get_crc(name, &db_state->crc);
+#ifdef RARCH_INTERNAL
+            if (rv)
+               task_database_disc_cache_save(name, NULL, &db_state->crc);
+#endif
+            return rv;
          }
          break;
       case FILE_TYPE_LUTRO:
@@ -618,7 +1227,7 @@ static int task_database_iterate_playlist(
          break;
       default:
          db->type            = DATABASE_TYPE_CRC_LOOKUP;
-         return intfstream_file_get_crc(name, 0, SIZE_MAX, &db_state->crc);
+         return task_database_file_get_crc(_db, name, &db_state->crc);
    }
 
    return 1;
@@ -815,8 +1424,10 @@ static int database_info_list_iterate_found_match(
    db_state->archive_crc = 0;
 
    /* Move database to start since we are likely to match against it
-      again */
-   if (db_state->list_index != 0)
+      again. Not while the merged crc index is active - its bitmasks
+      are keyed by list position, and the index already makes the
+      next match cheap regardless of order. */
+   if (db_state->list_index != 0 && !_db->crc_index)
    {
       struct string_list_elem entry = 
          db_state->list->elems[db_state->list_index];
@@ -845,6 +1456,194 @@ static int database_info_list_iterate_next(
    return 1;
 }
 
+static uint64_t db_crc_index_bit(size_t db_index)
+{
+   /* Databases past the last bit share it, so a set bit
+    * there means 'maybe' rather than 'definitely' - the
+    * probe stays conservative and never skips a real match */
+   if (db_index >= DB_CRC_INDEX_MAX_DBS - 1)
+      return UINT64_C(1) << (DB_CRC_INDEX_MAX_DBS - 1);
+   return UINT64_C(1) << db_index;
+}
+
+static void db_crc_index_free(db_crc_index_t *idx)
+{
+   if (!idx)
+      return;
+   if (idx->entries)
+      free(idx->entries);
+   free(idx);
+}
+
+static bool db_crc_index_insert(db_crc_index_t *idx,
+      uint32_t crc, uint64_t bit)
+{
+   size_t pos;
+
+   /* Grow at 75% load */
+   if ((idx->len * 4) >= (idx->cap * 3))
+   {
+      size_t i;
+      size_t new_cap                    = idx->cap << 1;
+      db_crc_index_entry_t *new_entries = (db_crc_index_entry_t*)
+         calloc(new_cap, sizeof(*new_entries));
+
+      if (!new_entries)
+         return false;
+
+      for (i = 0; i < idx->cap; i++)
+      {
+         db_crc_index_entry_t *entry = &idx->entries[i];
+         size_t new_pos;
+
+         if (!entry->crc)
+            continue;
+
+         new_pos = entry->crc & (new_cap - 1);
+         while (new_entries[new_pos].crc)
+            new_pos = (new_pos + 1) & (new_cap - 1);
+         new_entries[new_pos] = *entry;
+      }
+
+      free(idx->entries);
+      idx->entries = new_entries;
+      idx->cap     = new_cap;
+   }
+
+   pos = crc & (idx->cap - 1);
+   while (idx->entries[pos].crc && idx->entries[pos].crc != crc)
+      pos = (pos + 1) & (idx->cap - 1);
+
+   if (!idx->entries[pos].crc)
+   {
+      idx->entries[pos].crc = crc;
+      idx->len++;
+   }
+   idx->entries[pos].mask |= bit;
+
+   return true;
+}
+
+static uint64_t db_crc_index_mask(const db_crc_index_t *idx, uint32_t crc)
+{
+   size_t pos;
+
+   if (!crc)
+      return idx->unknown_mask;
+
+   pos = crc & (idx->cap - 1);
+   while (idx->entries[pos].crc)
+   {
+      if (idx->entries[pos].crc == crc)
+         return idx->entries[pos].mask | idx->unknown_mask;
+      pos = (pos + 1) & (idx->cap - 1);
+   }
+
+   return idx->unknown_mask;
+}
+
+static db_crc_index_t *db_crc_index_build(const struct string_list *list)
+{
+   size_t i;
+   bool failed         = false;
+   db_crc_index_t *idx = (db_crc_index_t*)calloc(1, sizeof(*idx));
+
+   if (!idx)
+      return NULL;
+
+   idx->cap     = DB_CRC_INDEX_MIN_CAP;
+   idx->entries = (db_crc_index_entry_t*)
+      calloc(idx->cap, sizeof(*idx->entries));
+
+   if (!idx->entries)
+   {
+      free(idx);
+      return NULL;
+   }
+
+   for (i = 0; i < list->size && !failed; i++)
+   {
+      const char *rdb_path     = list->elems[i].data;
+      uint64_t bit             = db_crc_index_bit(i);
+      libretrodb_t *rdb        = libretrodb_new();
+      libretrodb_cursor_t *cur = libretrodb_cursor_new();
+      bool scanned             = false;
+
+      if (rdb && cur && (libretrodb_open(rdb_path, rdb) == 0))
+      {
+         if (libretrodb_cursor_open(rdb, cur, NULL) == 0)
+         {
+            struct rmsgpack_dom_value item;
+
+            scanned = true;
+
+            while (!failed &&
+                  libretrodb_cursor_read_item_view(cur, &item) == 0)
+            {
+               unsigned j;
+
+               if (item.type != RDT_MAP)
+               {
+                  rmsgpack_dom_view_free(&item);
+                  continue;
+               }
+
+               for (j = 0; j < item.val.map.len; j++)
+               {
+                  struct rmsgpack_dom_value *key =
+                     &item.val.map.items[j].key;
+                  struct rmsgpack_dom_value *val =
+                     &item.val.map.items[j].value;
+                  uint32_t crc                   = 0;
+
+                  if (  key->type != RDT_STRING ||
+                        key->val.string.len != STRLEN_CONST("crc"))
+                     continue;
+                  if (memcmp(key->val.string.buff, "crc",
+                           STRLEN_CONST("crc")) != 0)
+                     continue;
+                  if (  val->type != RDT_BINARY ||
+                        val->val.binary.len != sizeof(uint32_t))
+                     break;
+
+                  /* View buffers are not aligned */
+                  memcpy(&crc, val->val.binary.buff, sizeof(crc));
+                  crc = swap_if_little32(crc);
+
+                  if (crc && !db_crc_index_insert(idx, crc, bit))
+                     failed = true;
+                  break;
+               }
+
+               rmsgpack_dom_view_free(&item);
+            }
+
+            libretrodb_cursor_close(cur);
+         }
+         libretrodb_close(rdb);
+      }
+
+      if (!scanned)
+         idx->unknown_mask |= bit;
+
+      if (cur)
+         libretrodb_cursor_free(cur);
+      if (rdb)
+         libretrodb_free(rdb);
+   }
+
+   if (failed)
+   {
+      db_crc_index_free(idx);
+      return NULL;
+   }
+
+   RARCH_LOG("[Scanner]: Indexed %u crc values across %u databases.\n",
+         (unsigned)idx->len, (unsigned)list->size);
+
+   return idx;
+}
+
 static int task_database_iterate_crc_lookup(
       db_handle_t *_db,
       database_state_handle_t *db_state,
@@ -866,12 +1665,33 @@ static int task_database_iterate_crc_lookup(
          return database_info_list_iterate_next(db_state);
    }
 
+   /* Build the merged index the first time a crc is
+    * looked up; by then the database list is final */
+   if (!_db->crc_index_tried)
+   {
+      _db->crc_index_tried = true;
+      if (db_state->list->size > 1)
+         _db->crc_index    = db_crc_index_build(db_state->list);
+   }
+
    if (db_state->entry_index == 0)
    {
       char query[50];
 
       query[0] = '\0';
 
+      /* One probe answers which databases can contain
+       * this file - skip the rest without querying them */
+      if (_db->crc_index)
+      {
+         uint64_t mask =
+               db_crc_index_mask(_db->crc_index, db_state->crc)
+             | db_crc_index_mask(_db->crc_index, db_state->archive_crc);
+
+         if (!(mask & db_crc_index_bit(db_state->list_index)))
+            return database_info_list_iterate_next(db_state);
+      }
+
       if (!_db->scan_without_core_match)
       {
          /* don't scan files that can't be in this database.
@@ -1074,7 +1894,7 @@ static int task_database_iterate(
    switch (db->type)
    {
       case DATABASE_TYPE_ITERATE:
-         return task_database_iterate_playlist(db_state, db, name);
+         return task_database_iterate_playlist(_db, db_state, db, name);
       case DATABASE_TYPE_ITERATE_ARCHIVE:
 #ifdef HAVE_COMPRESSION
          return task_database_iterate_crc_lookup(
@@ -1140,6 +1960,14 @@ static void task_database_handler(retro_task_t *task)
 
       if (db->handle)
          db->handle->status = DATABASE_STATUS_ITERATE_BEGIN;
+
+#ifdef HAVE_THREADS
+      /* Spin up the CRC prehash pipeline - only
+       * worthwhile when scanning multiple files */
+      if (db->handle && db->handle->list &&
+          (db->handle->list->size > 1))
+         db->prehash = db_prehash_new();
+#endif
    }
 
    dbinfo  = db->handle;
@@ -1207,6 +2035,11 @@ static void task_database_handler(retro_task_t *task)
          task_database_cleanup_state(dbstate);
          dbstate->list_index  = 0;
          dbstate->entry_index = 0;
+#ifdef HAVE_THREADS
+         /* Keep the hash workers fed with the files
+          * that come after the current one */
+         db_prehash_pump(db->prehash, dbinfo);
+#endif
          task_database_iterate_start(task, dbinfo, name);
          break;
       case DATABASE_STATUS_ITERATE:
@@ -1272,6 +2105,14 @@ task_finished:
 
    if (db)
    {
+#ifdef HAVE_THREADS
+      if (db->prehash)
+         db_prehash_free(db->prehash);
+      db->prehash = NULL;
+#endif
+      if (db->crc_index)
+         db_crc_index_free(db->crc_index);
+      db->crc_index = NULL;
       if (!string_is_empty(db->playlist_directory))
          free(db->playlist_directory);
       if (!string_is_empty(db->content_database_path))
@@ -1318,6 +2159,7 @@ bool task_push_dbscan(
 
    t->handler                              = task_database_handler;
    t->state                                = db;
+   t->priority                             = TASK_PRIORITY_BULK;
    t->callback                             = cb;
    t->title                                = strdup(msg_hash_to_str(
             MSG_PREPARING_FOR_CONTENT_SCAN));
@@ -20,6 +20,7 @@
 #include <file/archive_file.h>
 #include <retro_miscellaneous.h>
 #include <compat/strl.h>
+#include <features/features_cpu.h>
 
 #include "tasks_internal.h"
 #include "../file_path_special.h"
@@ -27,6 +28,14 @@
 
 #define CALLBACK_ERROR_SIZE 4200
 
+/* Maximum time spent inflating archive entries per handler
+ * invocation. Handlers used to extract a single entry per call,
+ * which caps extraction at one file per frame when the task queue
+ * is not threaded - far below disk speed for large archives.
+ * Batching entries up to a time budget keeps the menu responsive
+ * while letting extraction run at I/O speed */
+#define DECOMPRESS_TIME_SLICE_USEC 8000
+
 static int file_decompressed_target_file(const char *name,
       const char *valid_exts,
       const uint8_t *cdata,
@@ -155,14 +164,24 @@ static void task_decompress_handler(retro_task_t *task)
    decompress_state_t *dec                  = (decompress_state_t*)
       task->state;
 
+   retro_time_t start_time                  =
+      cpu_features_get_time_usec();
+
    dec->userdata->dec            = dec;
    strlcpy(dec->userdata->archive_path,
          dec->source_file, sizeof(dec->userdata->archive_path));
 
-   ret                     = file_archive_parse_file_iterate(
-         &dec->archive,
-         &retdec, dec->source_file,
-         dec->valid_ext, file_decompressed, dec->userdata);
+   do
+   {
+      ret                  = file_archive_parse_file_iterate(
+            &dec->archive,
+            &retdec, dec->source_file,
+            dec->valid_ext, file_decompressed, dec->userdata);
+
+      if (ret != 0 || task_get_cancelled(task))
+         break;
+   }while (cpu_features_get_time_usec() - start_time
+         < DECOMPRESS_TIME_SLICE_USEC);
 
    task_set_progress(task,
          file_archive_parse_file_progress(&dec->archive));
@@ -183,12 +202,22 @@ static void task_decompress_handler_target_file(retro_task_t *task)
    decompress_state_t *dec                  = (decompress_state_t*)
       task->state;
 
+   retro_time_t start_time                  =
+      cpu_features_get_time_usec();
+
    strlcpy(dec->userdata->archive_path,
          dec->source_file, sizeof(dec->userdata->archive_path));
 
-   ret = file_archive_parse_file_iterate(&dec->archive,
-         &retdec, dec->source_file,
-         dec->valid_ext, file_decompressed_target_file, dec->userdata);
+   do
+   {
+      ret = file_archive_parse_file_iterate(&dec->archive,
+            &retdec, dec->source_file,
+            dec->valid_ext, file_decompressed_target_file, dec->userdata);
+
+      if (ret != 0 || task_get_cancelled(task))
+         break;
+   }while (cpu_features_get_time_usec() - start_time
+         < DECOMPRESS_TIME_SLICE_USEC);
 
    task_set_progress(task,
          file_archive_parse_file_progress(&dec->archive));
@@ -208,15 +237,25 @@ static void task_decompress_handler_subdir(retro_task_t *task)
    bool retdec;
    decompress_state_t *dec = (decompress_state_t*)task->state;
 
+   retro_time_t start_time =
+      cpu_features_get_time_usec();
+
    dec->userdata->dec            = dec;
    strlcpy(dec->userdata->archive_path,
          dec->source_file,
          sizeof(dec->userdata->archive_path));
 
-   ret                     = file_archive_parse_file_iterate(
-         &dec->archive,
-         &retdec, dec->source_file,
-         dec->valid_ext, file_decompressed_subdir, dec->userdata);
+   do
+   {
+      ret                  = file_archive_parse_file_iterate(
+            &dec->archive,
+            &retdec, dec->source_file,
+            dec->valid_ext, file_decompressed_subdir, dec->userdata);
+
+      if (ret != 0 || task_get_cancelled(task))
+         break;
+   }while (cpu_features_get_time_usec() - start_time
+         < DECOMPRESS_TIME_SLICE_USEC);
 
    task_set_progress(task,
          file_archive_parse_file_progress(&dec->archive));
@@ -81,6 +81,18 @@ typedef struct
 void* task_push_http_transfer_file(const char* url, bool mute, const char* type,
       retro_task_callback_t cb, file_transfer_t* transfer_data);
 
+/* As task_push_http_transfer_file(), but fetches the file over
+ * several parallel HTTP range requests when the server supports
+ * them, falling back to a single connection when it does not */
+void* task_push_http_transfer_file_segmented(const char* url, bool mute, const char* type,
+      retro_task_callback_t cb, file_transfer_t* transfer_data);
+
+/* As task_push_http_transfer_file(), but keeps a disk-backed copy
+ * of the response and revalidates it with If-None-Match /
+ * If-Modified-Since, so an unchanged file costs only a 304 */
+void* task_push_http_transfer_file_cached(const char* url, bool mute, const char* type,
+      retro_task_callback_t cb, file_transfer_t* transfer_data);
+
 RETRO_END_DECLS
 
 #endif
@@ -13,28 +13,55 @@
  *  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include <net/net_http.h>
 #include <string/stdstring.h>
 #include <compat/strl.h>
 #include <file/file_path.h>
+#include <lists/dir_list.h>
+#include <lists/string_list.h>
 #include <net/net_compat.h>
+#include <streams/file_stream.h>
 #include <retro_timers.h>
 
 #ifdef RARCH_INTERNAL
+#include "../configuration.h"
 #include "../gfx/video_display_server.h"
 #endif
 #include "task_file_transfer.h"
 #include "tasks_internal.h"
 
+/* Maximum number of parallel range requests for a
+ * segmented transfer */
+#define HTTP_SEGMENT_COUNT 4
+
+/* Size of the initial ranged request; doubles as the minimum
+ * amount of work per extra connection */
+#define HTTP_SEGMENT_PROBE_SIZE (1024 * 1024)
+
+/* How often a dropped segment connection is re-established
+ * before the whole transfer is abandoned */
+#define HTTP_SEGMENT_RETRY_MAX 3
+
+/* Disk-backed response cache for conditional transfers. Each
+ * entry is one file in the cache directory: a magic line, the
+ * URL, the ETag, the Last-Modified date, then the raw body */
+#define HTTP_CACHE_FILE_EXTENSION "httpcache"
+#define HTTP_CACHE_MAGIC "#HCACHEv1#"
+#define HTTP_CACHE_FIELD_LEN 256
+#define HTTP_CACHE_SIZE_MAX (16 * 1024 * 1024)
+
 enum http_status_enum
 {
    HTTP_STATUS_CONNECTION_TRANSFER = 0,
    HTTP_STATUS_CONNECTION_TRANSFER_PARSE,
    HTTP_STATUS_TRANSFER,
    HTTP_STATUS_TRANSFER_PARSE,
-   HTTP_STATUS_TRANSFER_PARSE_FREE
+   HTTP_STATUS_TRANSFER_PARSE_FREE,
+   HTTP_STATUS_SEGMENT_PROBE,
+   HTTP_STATUS_SEGMENT_TRANSFER
 };
 
 struct http_transfer_info
@@ -43,6 +70,18 @@ struct http_transfer_info
    char url[255];
 };
 
+struct http_segment
+{
+   struct http_t *handle;
+   size_t start;      /* first byte of the assigned range */
+   size_t end;        /* one past the last byte of the range */
+   size_t received;   /* bytes already merged into the output buffer */
+   size_t progress;   /* body bytes seen on the current connection */
+   int status;        /* first HTTP status seen on the current connection */
+   unsigned retries;
+   bool done;
+};
+
 struct http_handle
 {
    struct http_t *handle;
@@ -52,8 +91,19 @@ struct http_handle
       struct http_connection_t *handle;
       transfer_cb_t  cb;
    } connection;
+   /* Segmented (ranged) download state; only used
+    * while 'segmented' is set */
+   struct http_segment segments[HTTP_SEGMENT_COUNT];
+   uint8_t *seg_buffer;
+   size_t seg_total;
+   unsigned num_segments;
    unsigned status;
+   bool segmented;
+   /* When set, a 304 reply is answered from the disk cache and
+    * fresh responses carrying validators are written back to it */
+   bool cached;
    bool error;
+   char cache_path[PATH_MAX_LENGTH];
    char connection_elem[255];
    char connection_url[255];
 };
@@ -61,6 +111,212 @@ struct http_handle
 typedef struct http_transfer_info http_transfer_info_t;
 typedef struct http_handle http_handle_t;
 
+#ifdef RARCH_INTERNAL
+/* Builds the cache entry path for a URL. Returns false when no
+ * cache directory is configured. */
+static bool task_http_cache_entry_path(const char *url,
+      char *path, size_t len)
+{
+   char name[64];
+   settings_t *settings = config_get_ptr();
+   const char *dir      = settings
+         ? settings->paths.directory_cache : NULL;
+   uint32_t hash_a      = 5381;
+   uint32_t hash_b      = 0;
+   const char *str      = NULL;
+
+   if (string_is_empty(dir))
+      return false;
+
+   /* Two independent string hashes; the entry stores the full
+    * URL, so a collision merely evicts the other entry */
+   for (str = url; *str; str++)
+   {
+      hash_a = ((hash_a << 5) + hash_a) ^ (uint32_t)*str;
+      hash_b = (uint32_t)*str + (hash_b << 6)
+            + (hash_b << 16) - hash_b;
+   }
+
+   name[0] = '\0';
+   snprintf(name, sizeof(name), "%08lx%08lx.%s",
+         (unsigned long)hash_a, (unsigned long)hash_b,
+         HTTP_CACHE_FILE_EXTENSION);
+
+   fill_pathname_join(path, dir, name, len);
+
+   return true;
+}
+
+static void task_http_cache_trim_line(char *line)
+{
+   size_t len = strlen(line);
+
+   while (len > 0 &&
+         (line[len - 1] == '\n' || line[len - 1] == '\r'))
+      line[--len] = '\0';
+}
+
+/* Reads the header of a cache entry, leaving the stream
+ * positioned at the start of the body. Returns NULL when the
+ * entry is missing, malformed or belongs to a different URL. */
+static RFILE *task_http_cache_open_entry(const char *entry_path,
+      const char *url, char *etag, size_t etag_len,
+      char *last_modified, size_t last_modified_len)
+{
+   char line[512];
+   RFILE *file = filestream_open(entry_path,
+         RETRO_VFS_FILE_ACCESS_READ,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!file)
+      return NULL;
+
+   line[0] = '\0';
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto error;
+   task_http_cache_trim_line(line);
+   if (!string_is_equal(line, HTTP_CACHE_MAGIC))
+      goto error;
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto error;
+   task_http_cache_trim_line(line);
+   if (!string_is_equal(line, url))
+      goto error;
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto error;
+   task_http_cache_trim_line(line);
+   strlcpy(etag, line, etag_len);
+
+   if (!filestream_gets(file, line, sizeof(line)))
+      goto error;
+   task_http_cache_trim_line(line);
+   strlcpy(last_modified, line, last_modified_len);
+
+   return file;
+
+error:
+   filestream_close(file);
+   return NULL;
+}
+
+/* Loads the body of a cache entry into a malloc'd buffer */
+static char *task_http_cache_read_body(const char *entry_path,
+      const char *url, size_t *len)
+{
+   char etag[HTTP_CACHE_FIELD_LEN];
+   char last_modified[HTTP_CACHE_FIELD_LEN];
+   char *body       = NULL;
+   int64_t body_len = 0;
+   RFILE *file      = task_http_cache_open_entry(
+         entry_path, url, etag, sizeof(etag),
+         last_modified, sizeof(last_modified));
+
+   if (!file)
+      return NULL;
+
+   body_len = filestream_get_size(file) - filestream_tell(file);
+
+   if ((body_len < 0) ||
+       !(body = (char*)malloc((size_t)body_len + 1)))
+   {
+      filestream_close(file);
+      return NULL;
+   }
+
+   if (filestream_read(file, body, body_len) != body_len)
+   {
+      free(body);
+      filestream_close(file);
+      return NULL;
+   }
+
+   /* NUL-terminate so text consumers (e.g. the core updater's
+    * index parser) can treat the body as a string */
+   body[body_len] = '\0';
+   *len           = (size_t)body_len;
+
+   filestream_close(file);
+   return body;
+}
+
+/* Keeps the total size of the cache directory below
+ * HTTP_CACHE_SIZE_MAX. Entries are dropped in listing order;
+ * with hashed file names that amounts to random eviction,
+ * which is good enough here. */
+static void task_http_cache_trim_store(void)
+{
+   size_t i;
+   size_t total             = 0;
+   struct string_list *list = NULL;
+   settings_t *settings     = config_get_ptr();
+   const char *dir          = settings
+         ? settings->paths.directory_cache : NULL;
+
+   if (string_is_empty(dir))
+      return;
+
+   if (!(list = dir_list_new(dir, HTTP_CACHE_FILE_EXTENSION,
+         false, false, false, false)))
+      return;
+
+   for (i = 0; i < list->size; i++)
+   {
+      int32_t entry_size = path_get_size(list->elems[i].data);
+
+      if (entry_size > 0)
+         total += (size_t)entry_size;
+   }
+
+   for (i = 0; (i < list->size) && (total > HTTP_CACHE_SIZE_MAX); i++)
+   {
+      int32_t entry_size = path_get_size(list->elems[i].data);
+
+      filestream_delete(list->elems[i].data);
+
+      if (entry_size > 0)
+         total -= (size_t)entry_size;
+   }
+
+   string_list_free(list);
+}
+
+/* Writes a fresh response to the cache; responses without
+ * validators are not worth keeping */
+static void task_http_cache_store(const char *entry_path,
+      const char *url, const char *etag, const char *last_modified,
+      const char *body, size_t len)
+{
+   RFILE *file = NULL;
+
+   if (string_is_empty(etag) && string_is_empty(last_modified))
+      return;
+
+   if (!(file = filestream_open(entry_path,
+         RETRO_VFS_FILE_ACCESS_WRITE,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE)))
+      return;
+
+   filestream_printf(file, "%s\n%s\n%s\n%s\n",
+         HTTP_CACHE_MAGIC, url,
+         etag          ? etag          : "",
+         last_modified ? last_modified : "");
+
+   if (filestream_write(file, body, len) != (int64_t)len)
+   {
+      /* Short write - do not leave a truncated entry behind */
+      filestream_close(file);
+      filestream_delete(entry_path);
+      return;
+   }
+
+   filestream_close(file);
+
+   task_http_cache_trim_store();
+}
+#endif
+
 static int task_http_con_iterate_transfer(http_handle_t *http)
 {
    if (!net_http_connection_iterate(http->connection.handle))
@@ -140,6 +396,242 @@ static int task_http_iterate_transfer(retro_task_t *task)
    return 0;
 }
 
+/* Opens a ranged connection for the byte range [start, end).
+ * Returns NULL on failure; the caller is expected to retry. */
+static struct http_t *task_http_segment_connect(
+      const char *url, size_t start, size_t end)
+{
+   char range[64];
+   struct http_t *handle          = NULL;
+   struct http_connection_t *conn = net_http_connection_new(
+         url, "GET", NULL);
+
+   if (!conn)
+      return NULL;
+
+   range[0] = '\0';
+   snprintf(range, sizeof(range), "%lu-%lu",
+         (unsigned long)start, (unsigned long)(end - 1));
+   net_http_connection_set_range(conn, range);
+
+   if (net_http_connection_iterate(conn) &&
+       net_http_connection_done(conn))
+      handle = net_http_new(conn);
+
+   net_http_connection_free(conn);
+
+   return handle;
+}
+
+/**
+ * task_http_iterate_transfer_segmented_probe:
+ *
+ * Waits for the response headers of the initial ranged request.
+ * A 206 reply with a known total size larger than the probe range
+ * hands the connection over to the segment list and spawns extra
+ * range connections for the remainder; anything else (most notably
+ * a 200 from a server that ignores Range) demotes the task to a
+ * plain single-connection transfer.
+ *
+ * Returns: 0 when the task should finish, -1 otherwise.
+ **/
+static int task_http_iterate_transfer_segmented_probe(retro_task_t *task)
+{
+   http_handle_t *http = (http_handle_t*)task->state;
+   size_t pos          = 0;
+   size_t tot          = 0;
+   size_t total        = 0;
+   bool done           = false;
+   int status          = -1;
+
+   if (task_queue_is_threaded())
+      retro_sleep(1);
+
+   done   = net_http_update(http->handle, &pos, &tot);
+   status = net_http_status(http->handle);
+
+   if (status < 0)
+   {
+      /* Headers not parsed yet; 'done' here means the
+       * connection broke before they arrived */
+      if (done)
+         return 0;
+      return -1;
+   }
+
+   total = net_http_content_range_total(http->handle);
+
+   if (status != 206 || tot == 0 || total <= tot)
+   {
+      /* Range not honored, or the probe already covers the
+       * whole file - carry on over this one connection */
+      http->segmented = false;
+      http->status    = HTTP_STATUS_TRANSFER;
+      return done ? 0 : -1;
+   }
+
+   if (!(http->seg_buffer = (uint8_t*)malloc(total)))
+   {
+      http->error = true;
+      return 0;
+   }
+
+   {
+      size_t offset           = tot;
+      size_t remaining        = total - tot;
+      unsigned extra          = (unsigned)
+            (remaining / HTTP_SEGMENT_PROBE_SIZE) + 1;
+      struct http_segment *seg = &http->segments[0];
+      unsigned i;
+
+      if (extra > HTTP_SEGMENT_COUNT - 1)
+         extra = HTTP_SEGMENT_COUNT - 1;
+
+      /* The probe connection becomes segment 0 */
+      seg->handle      = http->handle;
+      seg->start       = 0;
+      seg->end         = tot;
+      seg->received    = 0;
+      seg->progress    = pos;
+      seg->status      = status;
+      seg->retries     = 0;
+      seg->done        = false;
+      http->handle     = NULL;
+
+      http->seg_total    = total;
+      http->num_segments = extra + 1;
+
+      for (i = 1; i <= extra; i++)
+      {
+         size_t chunk  = remaining / extra;
+
+         seg           = &http->segments[i];
+         seg->start    = offset;
+         seg->end      = (i == extra) ? total : (offset + chunk);
+         seg->received = 0;
+         seg->progress = 0;
+         seg->status   = 0;
+         seg->retries  = 0;
+         seg->done     = false;
+         /* A failed connect here is retried by the transfer loop */
+         seg->handle   = task_http_segment_connect(
+               http->connection_url, seg->start, seg->end);
+
+         offset        = seg->end;
+      }
+   }
+
+   http->status = HTTP_STATUS_SEGMENT_TRANSFER;
+   return -1;
+}
+
+/**
+ * task_http_iterate_transfer_segmented:
+ *
+ * Polls every segment connection, merging completed ranges into
+ * the preallocated output buffer. Dropped connections keep the
+ * body bytes that did arrive and re-request only the remainder
+ * of their range.
+ *
+ * Returns: 0 when finished (all segments merged, or a segment
+ * exhausted its retries), -1 otherwise.
+ **/
+static int task_http_iterate_transfer_segmented(retro_task_t *task)
+{
+   http_handle_t *http = (http_handle_t*)task->state;
+   size_t merged       = 0;
+   bool all_done       = true;
+   unsigned i;
+
+   if (task_queue_is_threaded())
+      retro_sleep(1);
+
+   for (i = 0; i < http->num_segments; i++)
+   {
+      struct http_segment *seg = &http->segments[i];
+      size_t pos               = 0;
+      size_t tot               = 0;
+
+      if (seg->done)
+      {
+         merged += seg->received;
+         continue;
+      }
+
+      all_done = false;
+
+      if (!seg->handle)
+      {
+         /* (Re)establish the connection, asking only for
+          * the part of the range we do not have yet */
+         if (seg->retries++ >= HTTP_SEGMENT_RETRY_MAX)
+         {
+            http->error = true;
+            return 0;
+         }
+
+         seg->progress = 0;
+         seg->status   = 0;
+         seg->handle   = task_http_segment_connect(
+               http->connection_url,
+               seg->start + seg->received, seg->end);
+
+         merged += seg->received;
+         continue;
+      }
+
+      if (net_http_update(seg->handle, &pos, &tot))
+      {
+         size_t len    = 0;
+         uint8_t *data = net_http_data(seg->handle, &len, true);
+         size_t want   = seg->end - seg->start - seg->received;
+
+         if (    !net_http_error(seg->handle)
+              && (net_http_status(seg->handle) == 206)
+              && data && (len == want))
+         {
+            memcpy(http->seg_buffer + seg->start + seg->received,
+                  data, len);
+            seg->received += len;
+            seg->done      = true;
+         }
+         else if ((seg->status == 206) && data && (seg->progress > 0))
+         {
+            /* Connection dropped mid-range; keep what made it
+             * through so the retry fetches less */
+            size_t salvage = MIN(seg->progress, want);
+
+            memcpy(http->seg_buffer + seg->start + seg->received,
+                  data, salvage);
+            seg->received += salvage;
+         }
+
+         if (data)
+            free(data);
+         net_http_delete(seg->handle);
+         seg->handle = NULL;
+
+         merged += seg->received;
+      }
+      else
+      {
+         if (seg->status <= 0)
+            seg->status = net_http_status(seg->handle);
+         seg->progress  = pos;
+
+         merged        += seg->received + pos;
+      }
+   }
+
+   if (merged < (((size_t)-1) / 100))
+      task_set_progress(task, (signed)(merged * 100 / http->seg_total));
+   else
+      task_set_progress(task,
+            MAX((signed)merged / (http->seg_total / 100), 100));
+
+   return all_done ? 0 : -1;
+}
+
 static void task_http_transfer_handler(retro_task_t *task)
 {
    http_transfer_data_t *data = NULL;
@@ -152,7 +644,9 @@ static void task_http_transfer_handler(retro_task_t *task)
    {
       case HTTP_STATUS_CONNECTION_TRANSFER_PARSE:
          task_http_conn_iterate_transfer_parse(http);
-         http->status = HTTP_STATUS_TRANSFER;
+         http->status = http->segmented
+               ? HTTP_STATUS_SEGMENT_PROBE
+               : HTTP_STATUS_TRANSFER;
          break;
       case HTTP_STATUS_CONNECTION_TRANSFER:
          if (!task_http_con_iterate_transfer(http))
@@ -162,6 +656,14 @@ static void task_http_transfer_handler(retro_task_t *task)
          if (!task_http_iterate_transfer(task))
             goto task_finished;
          break;
+      case HTTP_STATUS_SEGMENT_PROBE:
+         if (!task_http_iterate_transfer_segmented_probe(task))
+            goto task_finished;
+         break;
+      case HTTP_STATUS_SEGMENT_TRANSFER:
+         if (!task_http_iterate_transfer_segmented(task))
+            goto task_finished;
+         break;
       case HTTP_STATUS_TRANSFER_PARSE:
          goto task_finished;
       default:
@@ -175,7 +677,55 @@ static void task_http_transfer_handler(retro_task_t *task)
 task_finished:
    task_set_finished(task, true);
 
-   if (http->handle)
+   if (http->segmented)
+   {
+      unsigned i;
+
+      /* The probe connection, if it was never handed
+       * over to the segment list */
+      if (http->handle)
+      {
+         uint8_t *tmp = net_http_data(http->handle, NULL, true);
+
+         if (tmp)
+            free(tmp);
+         net_http_delete(http->handle);
+      }
+
+      for (i = 0; i < http->num_segments; i++)
+      {
+         struct http_segment *seg = &http->segments[i];
+
+         if (seg->handle)
+         {
+            uint8_t *tmp = net_http_data(seg->handle, NULL, true);
+
+            if (tmp)
+               free(tmp);
+            net_http_delete(seg->handle);
+         }
+      }
+
+      if (http->error || task_get_cancelled(task))
+      {
+         if (http->seg_buffer)
+            free(http->seg_buffer);
+
+         if (task_get_cancelled(task))
+            task_set_error(task, strdup("Task cancelled."));
+         else if (!task->mute)
+            task_set_error(task, strdup("Download failed."));
+      }
+      else
+      {
+         data       = (http_transfer_data_t*)malloc(sizeof(*data));
+         data->data = (char*)http->seg_buffer;
+         data->len  = http->seg_total;
+
+         task_set_data(task, data);
+      }
+   }
+   else if (http->handle)
    {
       size_t len = 0;
       char  *tmp = (char*)net_http_data(http->handle, &len, false);
@@ -183,6 +733,28 @@ task_finished:
       if (tmp && http->cb)
          http->cb(tmp, len);
 
+#ifdef RARCH_INTERNAL
+      if (     http->cached
+            && (net_http_status(http->handle) == 304)
+            && !task_get_cancelled(task)
+            && (tmp = task_http_cache_read_body(
+                  http->cache_path, http->connection_url, &len)))
+      {
+         /* Not modified - serve the cached copy and drop the
+          * empty 304 body */
+         char *body = (char*)net_http_data(http->handle, NULL, true);
+
+         if (body)
+            free(body);
+
+         data       = (http_transfer_data_t*)malloc(sizeof(*data));
+         data->data = tmp;
+         data->len  = len;
+
+         task_set_data(task, data);
+      }
+      else
+#endif
       if (net_http_error(http->handle) || task_get_cancelled(task))
       {
          tmp = (char*)net_http_data(http->handle, &len, true);
@@ -202,6 +774,15 @@ task_finished:
          data->len  = len;
 
          task_set_data(task, data);
+
+#ifdef RARCH_INTERNAL
+         if (http->cached)
+            task_http_cache_store(
+                  http->cache_path, http->connection_url,
+                  net_http_etag(http->handle),
+                  net_http_last_modified(http->handle),
+                  tmp, len);
+#endif
       }
 
       net_http_delete(http->handle);
@@ -254,6 +835,7 @@ static void http_transfer_progress_cb(retro_task_t *task)
 static void* task_push_http_transfer_generic(
       struct http_connection_t *conn,
       const char *url, bool mute, const char *type,
+      bool segmented, bool cached,
       retro_task_callback_t cb, void *user_data)
 {
    task_finder_data_t find_data;
@@ -287,8 +869,39 @@ static void* task_push_http_transfer_generic(
    http->handle              = NULL;
    http->cb                  = NULL;
    http->status              = 0;
+   http->segmented           = segmented;
+   http->num_segments        = 0;
+   http->seg_buffer          = NULL;
+   http->seg_total           = 0;
+   http->cached              = false;
+   http->cache_path[0]       = '\0';
    http->error               = false;
 
+#ifdef RARCH_INTERNAL
+   if (cached && task_http_cache_entry_path(url,
+         http->cache_path, sizeof(http->cache_path)))
+   {
+      char etag[HTTP_CACHE_FIELD_LEN];
+      char last_modified[HTTP_CACHE_FIELD_LEN];
+      RFILE *entry  = task_http_cache_open_entry(
+            http->cache_path, url, etag, sizeof(etag),
+            last_modified, sizeof(last_modified));
+
+      http->cached  = true;
+
+      if (entry)
+      {
+         if (!string_is_empty(etag))
+            net_http_connection_set_if_none_match(conn, etag);
+         if (!string_is_empty(last_modified))
+            net_http_connection_set_if_modified_since(
+                  conn, last_modified);
+
+         filestream_close(entry);
+      }
+   }
+#endif
+
    if (type)
       strlcpy(http->connection_elem, type, sizeof(http->connection_elem));
 
@@ -330,23 +943,33 @@ void* task_push_http_transfer(const char *url, bool mute,
 
    return task_push_http_transfer_generic(
          net_http_connection_new(url, "GET", NULL),
-         url, mute, type, cb, user_data);
+         url, mute, type, false, false, cb, user_data);
 }
 
-void* task_push_http_transfer_file(const char* url, bool mute,
-      const char* type,
+void* task_push_http_transfer_cached(const char *url, bool mute,
+      const char *type,
+      retro_task_callback_t cb, void *user_data)
+{
+   if (string_is_empty(url))
+      return NULL;
+
+   return task_push_http_transfer_generic(
+         net_http_connection_new(url, "GET", NULL),
+         url, mute, type, false, true, cb, user_data);
+}
+
+static void* task_push_http_transfer_file_generic(
+      struct http_connection_t *conn,
+      const char* url, bool mute, const char* type,
+      bool segmented, bool cached,
       retro_task_callback_t cb, file_transfer_t* transfer_data)
 {
    const char *s   = NULL;
    char tmp[255]   = "";
    retro_task_t *t = NULL;
 
-   if (string_is_empty(url))
-      return NULL;
-
    t = (retro_task_t*)task_push_http_transfer_generic(
-         net_http_connection_new(url, "GET", NULL),
-         url, mute, type, cb, transfer_data);
+         conn, url, mute, type, segmented, cached, cb, transfer_data);
 
    if (!t)
       return NULL;
@@ -369,6 +992,56 @@ void* task_push_http_transfer_file(const char* url, bool mute,
    return t;
 }
 
+void* task_push_http_transfer_file(const char* url, bool mute,
+      const char* type,
+      retro_task_callback_t cb, file_transfer_t* transfer_data)
+{
+   if (string_is_empty(url))
+      return NULL;
+
+   return task_push_http_transfer_file_generic(
+         net_http_connection_new(url, "GET", NULL),
+         url, mute, type, false, false, cb, transfer_data);
+}
+
+void* task_push_http_transfer_file_cached(const char* url, bool mute,
+      const char* type,
+      retro_task_callback_t cb, file_transfer_t* transfer_data)
+{
+   if (string_is_empty(url))
+      return NULL;
+
+   return task_push_http_transfer_file_generic(
+         net_http_connection_new(url, "GET", NULL),
+         url, mute, type, false, true, cb, transfer_data);
+}
+
+void* task_push_http_transfer_file_segmented(const char* url, bool mute,
+      const char* type,
+      retro_task_callback_t cb, file_transfer_t* transfer_data)
+{
+   char range[64];
+   struct http_connection_t *conn = NULL;
+
+   if (string_is_empty(url))
+      return NULL;
+
+   if (!(conn = net_http_connection_new(url, "GET", NULL)))
+      return NULL;
+
+   /* The first request doubles as a probe: a 206 reply tells
+    * us the server honors ranges (and, via Content-Range, how
+    * large the file is), a 200 reply carries the whole file
+    * over this single connection */
+   range[0] = '\0';
+   snprintf(range, sizeof(range), "0-%lu",
+         (unsigned long)(HTTP_SEGMENT_PROBE_SIZE - 1));
+   net_http_connection_set_range(conn, range);
+
+   return task_push_http_transfer_file_generic(
+         conn, url, mute, type, true, false, cb, transfer_data);
+}
+
 void* task_push_http_transfer_with_user_agent(const char *url, bool mute,
    const char *type, const char* user_agent,
    retro_task_callback_t cb, void *user_data)
@@ -386,7 +1059,7 @@ void* task_push_http_transfer_with_user_agent(const char *url, bool mute,
       net_http_connection_set_user_agent(conn, user_agent);
 
    /* assert: task_push_http_transfer_generic will free conn on failure */
-   return task_push_http_transfer_generic(conn, url, mute, type, cb, user_data);
+   return task_push_http_transfer_generic(conn, url, mute, type, false, false, cb, user_data);
 }
 
 void* task_push_http_post_transfer(const char *url,
@@ -397,7 +1070,7 @@ void* task_push_http_post_transfer(const char *url,
       return NULL;
    return task_push_http_transfer_generic(
          net_http_connection_new(url, "POST", post_data),
-         url, mute, type, cb, user_data);
+         url, mute, type, false, false, cb, user_data);
 }
 
 void* task_push_http_post_transfer_with_user_agent(const char *url,
@@ -418,7 +1091,7 @@ void* task_push_http_post_transfer_with_user_agent(const char *url,
       net_http_connection_set_user_agent(conn, user_agent);
 
    /* assert: task_push_http_transfer_generic will free conn on failure */
-   return task_push_http_transfer_generic(conn, url, mute, type, cb, user_data);
+   return task_push_http_transfer_generic(conn, url, mute, type, false, false, cb, user_data);
 }
 
 task_retriever_info_t *http_task_get_transfer_list(void)
@@ -464,6 +464,9 @@ bool task_push_image_load(const char *fullpath,
    t->cleanup         = task_image_load_free;
    t->callback        = cb;
    t->user_data       = user_data;
+   /* Image loads are requested in direct response to menu
+    * navigation - don't let them queue behind bulk work */
+   t->priority        = TASK_PRIORITY_LATENCY_CRITICAL;
 
    task_queue_push(t);
 
@@ -55,6 +55,17 @@ struct overlay_loader
    bool overlay_enable;
    bool overlay_hide_in_menu;
    bool overlay_hide_when_gamepad_connected;
+
+   /* Decode cache - controls frequently reuse the same image
+    * file, so each distinct path is only decoded once per load.
+    * The cached pixels are owned by whichever descriptor loaded
+    * them first; entries are only valid while loading. */
+   struct overlay_image_cache_entry
+   {
+      char *path;
+      struct texture_image image;
+   } *image_cache;
+   size_t image_cache_size;
 };
 
 static void task_overlay_image_done(struct overlay *overlay)
@@ -65,6 +76,55 @@ static void task_overlay_image_done(struct overlay *overlay)
    overlay->pos_increment = (overlay->size / 2) ? ((unsigned)(overlay->size / 2)) : 8;
 }
 
+static bool task_overlay_load_image_cached(
+      overlay_loader_t *loader,
+      struct texture_image *image_tex, const char *path)
+{
+   size_t i;
+   struct overlay_image_cache_entry *entry = NULL;
+
+   for (i = 0; i < loader->image_cache_size; i++)
+   {
+      const struct texture_image *src = &loader->image_cache[i].image;
+      uint32_t *pixels                = NULL;
+      size_t len                      = 0;
+
+      if (!string_is_equal(loader->image_cache[i].path, path))
+         continue;
+
+      /* Copy the pixels so that every descriptor still owns its
+       * own buffer - the free path stays as it is. */
+      len    = (size_t)src->width * src->height * sizeof(uint32_t);
+      pixels = (uint32_t*)malloc(len);
+      if (!pixels)
+         return false;
+
+      memcpy(pixels, src->pixels, len);
+      *image_tex        = *src;
+      image_tex->pixels = pixels;
+      return true;
+   }
+
+   if (!image_texture_load(image_tex, path))
+      return false;
+
+   entry = (struct overlay_image_cache_entry*)realloc(
+         loader->image_cache,
+         (loader->image_cache_size + 1) * sizeof(*loader->image_cache));
+   if (entry)
+   {
+      loader->image_cache                                 = entry;
+      entry                                               =
+         &loader->image_cache[loader->image_cache_size];
+      entry->path                                         = strdup(path);
+      entry->image                                        = *image_tex;
+      if (entry->path)
+         loader->image_cache_size++;
+   }
+
+   return true;
+}
+
 static void task_overlay_load_desc_image(
       overlay_loader_t *loader,
       struct overlay_desc *desc,
@@ -94,7 +154,7 @@ static void task_overlay_load_desc_image(
 
       image_tex.supports_rgba = loader->driver_rgba_support;
 
-      if (image_texture_load(&image_tex, path))
+      if (task_overlay_load_image_cached(loader, &image_tex, path))
       {
          input_overlay->load_images[input_overlay->load_images_size++] = image_tex;
          desc->image       = image_tex;
@@ -672,6 +732,11 @@ static void task_overlay_free(retro_task_t *task)
    if (loader->conf)
       config_file_free(loader->conf);
 
+   for (i = 0; i < loader->image_cache_size; i++)
+      free(loader->image_cache[i].path);
+   if (loader->image_cache)
+      free(loader->image_cache);
+
    free(loader);
 }
 
@@ -58,15 +58,126 @@ enum patch_error
    PATCH_PATCH_CHECKSUM_INVALID
 };
 
+/* All three patch formats read their patch file
+ * strictly sequentially, so patch data is streamed
+ * through a small window buffer rather than loaded
+ * into memory in full (patches for large content
+ * can themselves be very large) */
+#define PATCH_STREAM_CHUNK_SIZE 4096
+
+struct patch_stream
+{
+   RFILE *file;
+   uint64_t length;
+   uint64_t offset; /* File offset of next byte to be returned */
+   size_t buf_fill;
+   size_t buf_pos;
+   uint8_t buffer[PATCH_STREAM_CHUNK_SIZE];
+};
+
+static bool patch_stream_open(struct patch_stream *ps, const char *path)
+{
+   int64_t length;
+
+   ps->file = filestream_open(path,
+         RETRO_VFS_FILE_ACCESS_READ,
+         RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!ps->file)
+      return false;
+
+   length = filestream_get_size(ps->file);
+
+   if (length < 0)
+   {
+      filestream_close(ps->file);
+      ps->file = NULL;
+      return false;
+   }
+
+   ps->length   = (uint64_t)length;
+   ps->offset   = 0;
+   ps->buf_fill = 0;
+   ps->buf_pos  = 0;
+
+   return true;
+}
+
+static void patch_stream_close(struct patch_stream *ps)
+{
+   if (ps->file)
+   {
+      filestream_close(ps->file);
+      ps->file = NULL;
+   }
+}
+
+/* Re-winds stream to the start of the patch
+ * (required by the two-pass IPS parser) */
+static bool patch_stream_rewind(struct patch_stream *ps)
+{
+   if (filestream_seek(ps->file, 0,
+         RETRO_VFS_SEEK_POSITION_START) < 0)
+      return false;
+
+   ps->offset   = 0;
+   ps->buf_fill = 0;
+   ps->buf_pos  = 0;
+
+   return true;
+}
+
+/* Returns next patch byte, or 0x00 once the
+ * end of the file has been reached */
+static uint8_t patch_stream_read_byte(struct patch_stream *ps)
+{
+   if (ps->buf_pos >= ps->buf_fill)
+   {
+      int64_t length = filestream_read(ps->file,
+            ps->buffer, sizeof(ps->buffer));
+
+      if (length <= 0)
+         return 0x00;
+
+      ps->buf_fill = (size_t)length;
+      ps->buf_pos  = 0;
+   }
+
+   ps->offset++;
+   return ps->buffer[ps->buf_pos++];
+}
+
+/* Skips 'count' bytes of patch data */
+static void patch_stream_skip(struct patch_stream *ps, uint64_t count)
+{
+   size_t in_buffer = ps->buf_fill - ps->buf_pos;
+
+   if (count <= (uint64_t)in_buffer)
+   {
+      ps->buf_pos += (size_t)count;
+      ps->offset  += count;
+      return;
+   }
+
+   /* Skip beyond the window - discard the buffer
+    * and seek over the remainder */
+   count        -= (uint64_t)in_buffer;
+   ps->offset   += (uint64_t)in_buffer;
+   ps->buf_fill  = 0;
+   ps->buf_pos   = 0;
+
+   filestream_seek(ps->file, (int64_t)count,
+         RETRO_VFS_SEEK_POSITION_CURRENT);
+   ps->offset   += count;
+}
+
 struct bps_data
 {
-   const uint8_t *modify_data;
+   struct patch_stream *modify;
    const uint8_t *source_data;
    uint8_t *target_data;
-   size_t modify_length;
    size_t source_length;
    size_t target_length;
-   size_t modify_offset;
    size_t source_offset;
    size_t target_offset;
    size_t source_relative_offset;
@@ -79,13 +190,11 @@ struct bps_data
 
 struct ups_data
 {
-   const uint8_t *patch_data;
+   struct patch_stream *patch;
    const uint8_t *source_data;
    uint8_t *target_data;
-   unsigned patch_length;
    unsigned source_length;
    unsigned target_length;
-   unsigned patch_offset;
    unsigned source_offset;
    unsigned target_offset;
    unsigned patch_checksum;
@@ -93,12 +202,12 @@ struct ups_data
    unsigned target_checksum;
 };
 
-typedef enum patch_error (*patch_func_t)(const uint8_t*, uint64_t,
-      const uint8_t*, uint64_t, uint8_t**, uint64_t*);
+typedef enum patch_error (*patch_func_t)(struct patch_stream*,
+      uint8_t**, uint64_t, uint8_t**, uint64_t*);
 
 static uint8_t bps_read(struct bps_data *bps)
 {
-   uint8_t data         = bps->modify_data[bps->modify_offset++];
+   uint8_t data         = patch_stream_read_byte(bps->modify);
    bps->modify_checksum = ~(encoding_crc32(
          ~bps->modify_checksum, &data, 1));
    return data;
@@ -128,8 +237,8 @@ static void bps_write(struct bps_data *bps, uint8_t data)
 }
 
 static enum patch_error bps_apply_patch(
-      const uint8_t *modify_data, uint64_t modify_length,
-      const uint8_t *source_data, uint64_t source_length,
+      struct patch_stream *modify,
+      uint8_t **source_data, uint64_t source_length,
       uint8_t **target_data, uint64_t *target_length)
 {
    size_t i;
@@ -142,16 +251,14 @@ static enum patch_error bps_apply_patch(
    uint32_t modify_target_checksum = 0;
    uint32_t modify_modify_checksum = 0;
 
-   if (modify_length < 19)
+   if (modify->length < 19)
       return PATCH_PATCH_TOO_SMALL;
 
-   bps.modify_data            = modify_data;
-   bps.source_data            = source_data;
+   bps.modify                 = modify;
+   bps.source_data            = *source_data;
    bps.target_data            = *target_data;
-   bps.modify_length          = modify_length;
    bps.source_length          = source_length;
    bps.target_length          = *target_length;
-   bps.modify_offset          = 0;
    bps.source_offset          = 0;
    bps.target_offset          = 0;
    bps.modify_checksum        = ~0;
@@ -190,7 +297,7 @@ static enum patch_error bps_apply_patch(
       bps.target_length = modify_target_size;
    }
 
-   while (bps.modify_offset < bps.modify_length - 12)
+   while (modify->offset < modify->length - 12)
    {
       size_t length = bps_decode(&bps);
       unsigned mode = length & 3;
@@ -267,9 +374,9 @@ static enum patch_error bps_apply_patch(
 
 static uint8_t ups_patch_read(struct ups_data *data)
 {
-   if (data && data->patch_offset < data->patch_length)
+   if (data && data->patch->offset < data->patch->length)
    {
-      uint8_t n = data->patch_data[data->patch_offset++];
+      uint8_t n = patch_stream_read_byte(data->patch);
       data->patch_checksum =
          ~(encoding_crc32(~data->patch_checksum, &n, 1));
       return n;
@@ -321,8 +428,8 @@ static uint64_t ups_decode(struct ups_data *data)
 }
 
 static enum patch_error ups_apply_patch(
-      const uint8_t *patchdata, uint64_t patchlength,
-      const uint8_t *sourcedata, uint64_t sourcelength,
+      struct patch_stream *patch,
+      uint8_t **sourcedata, uint64_t sourcelength,
       uint8_t **targetdata, uint64_t *targetlength)
 {
    size_t i;
@@ -334,20 +441,18 @@ static enum patch_error ups_apply_patch(
    uint32_t source_read_checksum  = 0;
    uint32_t target_read_checksum  = 0;
 
-   data.patch_data      = patchdata;
-   data.source_data     = sourcedata;
+   data.patch           = patch;
+   data.source_data     = *sourcedata;
    data.target_data     = *targetdata;
-   data.patch_length    = (unsigned)patchlength;
    data.source_length   = (unsigned)sourcelength;
    data.target_length   = (unsigned)*targetlength;
-   data.patch_offset    = 0;
    data.source_offset   = 0;
    data.target_offset   = 0;
    data.patch_checksum  = ~0;
    data.source_checksum = ~0;
    data.target_checksum = ~0;
 
-   if (data.patch_length < 18)
+   if (patch->length < 18)
       return PATCH_PATCH_INVALID;
 
    if (
@@ -380,7 +485,7 @@ static enum patch_error ups_apply_patch(
 
    data.target_length = (unsigned)*targetlength;
    
-   while (data.patch_offset < data.patch_length - 12)
+   while (patch->offset < patch->length - 12)
    {
       unsigned length = (unsigned)ups_decode(&data);
       while (length--)
@@ -435,13 +540,19 @@ static enum patch_error ups_apply_patch(
    return PATCH_SOURCE_INVALID;
 }
 
+/* First IPS pass: validates the patch structure and
+ * determines the target size, then resizes the source
+ * buffer in place. IPS patches are applied on top of
+ * the source data, so a second full-size copy of the
+ * content is not required */
 static enum patch_error ips_alloc_targetdata(
-      const uint8_t *patchdata, uint64_t patchlen,
+      struct patch_stream *patch,
       uint64_t sourcelength,
+      uint8_t **sourcedata,
       uint8_t **targetdata, uint64_t *targetlength)
 {
    uint8_t *prov_alloc;
-   uint32_t offset = 5;
+   bool size_known = false;
    *targetlength   = sourcelength;
 
    for (;;)
@@ -449,72 +560,69 @@ static enum patch_error ips_alloc_targetdata(
       uint32_t address;
       unsigned length;
 
-      if (offset > patchlen - 3)
+      if (patch->offset > patch->length - 3)
          break;
 
-      address  = patchdata[offset++] << 16;
-      address |= patchdata[offset++] << 8;
-      address |= patchdata[offset++] << 0;
+      address  = patch_stream_read_byte(patch) << 16;
+      address |= patch_stream_read_byte(patch) << 8;
+      address |= patch_stream_read_byte(patch) << 0;
 
       if (address == 0x454f46) /* EOF */
       {
-         if (offset == patchlen)
-         {
-            prov_alloc     = (uint8_t*)malloc((size_t)*targetlength);
-            if (!prov_alloc)
-               return PATCH_TARGET_ALLOC_FAILED;
-            free(*targetdata);
-            *targetdata    = prov_alloc;
-            return PATCH_SUCCESS;
-         }
-         else if (offset == patchlen - 3)
+         if (patch->offset == patch->length)
+            size_known = true;
+         else if (patch->offset == patch->length - 3)
          {
-            uint32_t size  = patchdata[offset++] << 16;
-            size          |= patchdata[offset++] << 8;
-            size          |= patchdata[offset++] << 0;
+            uint32_t size  = patch_stream_read_byte(patch) << 16;
+            size          |= patch_stream_read_byte(patch) << 8;
+            size          |= patch_stream_read_byte(patch) << 0;
             *targetlength  = size;
-            prov_alloc     = (uint8_t*)malloc((size_t)*targetlength);
+            size_known     = true;
+         }
 
+         if (size_known)
+         {
+            /* Grow (or truncate) the source buffer
+             * in place - ownership transfers to the
+             * target pointer */
+            prov_alloc  = (uint8_t*)realloc(*sourcedata,
+                  (size_t)(*targetlength > 0 ? *targetlength : 1));
             if (!prov_alloc)
                return PATCH_TARGET_ALLOC_FAILED;
-            free(*targetdata);
-            *targetdata    = prov_alloc;
+            *sourcedata = NULL;
+            *targetdata = prov_alloc;
             return PATCH_SUCCESS;
          }
       }
 
-      if (offset > patchlen - 2)
+      if (patch->offset > patch->length - 2)
          break;
 
-      length  = patchdata[offset++] << 8;
-      length |= patchdata[offset++] << 0;
+      length  = patch_stream_read_byte(patch) << 8;
+      length |= patch_stream_read_byte(patch) << 0;
 
       if (length) /* Copy */
       {
-         if (offset > patchlen - length)
+         if (patch->offset > patch->length - length)
             break;
 
-         while (length--)
-         {
-            address++;
-            offset++;
-         }
+         patch_stream_skip(patch, length);
+         address += length;
       }
       else /* RLE */
       {
-         if (offset > patchlen - 3)
+         if (patch->offset > patch->length - 3)
             break;
 
-         length  = patchdata[offset++] << 8;
-         length |= patchdata[offset++] << 0;
+         length  = patch_stream_read_byte(patch) << 8;
+         length |= patch_stream_read_byte(patch) << 0;
 
          if (length == 0) /* Illegal */
             break;
 
-         while (length--)
-            address++;
+         address += length;
 
-         offset++;
+         patch_stream_skip(patch, 1);
       }
 
       if (address > *targetlength)
@@ -525,82 +633,89 @@ static enum patch_error ips_alloc_targetdata(
 }
 
 static enum patch_error ips_apply_patch(
-      const uint8_t *patchdata, uint64_t patchlen,
-      const uint8_t *sourcedata, uint64_t sourcelength,
+      struct patch_stream *patch,
+      uint8_t **sourcedata, uint64_t sourcelength,
       uint8_t **targetdata, uint64_t *targetlength)
 {
-   uint32_t offset = 5;
    enum patch_error error_patch = PATCH_UNKNOWN;
-   if (  patchlen      < 8   ||
-         patchdata[0] != 'P' ||
-         patchdata[1] != 'A' ||
-         patchdata[2] != 'T' ||
-         patchdata[3] != 'C' ||
-         patchdata[4] != 'H')
+   if (  patch->length < 8 ||
+         patch_stream_read_byte(patch) != 'P' ||
+         patch_stream_read_byte(patch) != 'A' ||
+         patch_stream_read_byte(patch) != 'T' ||
+         patch_stream_read_byte(patch) != 'C' ||
+         patch_stream_read_byte(patch) != 'H')
       return PATCH_PATCH_INVALID;
-   
+
    if ((error_patch = ips_alloc_targetdata(
-               patchdata, patchlen, sourcelength,
-               targetdata, targetlength)) != PATCH_SUCCESS)
+               patch, sourcelength,
+               sourcedata, targetdata, targetlength)) != PATCH_SUCCESS)
       return error_patch;
 
-   memcpy(*targetdata, sourcedata, (size_t)sourcelength);
+   /* The validation pass consumed the patch -
+    * rewind for the apply pass. Note that the
+    * source buffer has already been handed over
+    * to the target at this point, so any failure
+    * below must not be treated as recoverable */
+   if (!patch_stream_rewind(patch))
+      return PATCH_PATCH_INVALID;
+
+   patch_stream_skip(patch, 5);
 
    for (;;)
    {
       uint32_t address;
       unsigned length;
 
-      if (offset > patchlen - 3)
+      if (patch->offset > patch->length - 3)
          break;
 
-      address  = patchdata[offset++] << 16;
-      address |= patchdata[offset++] << 8;
-      address |= patchdata[offset++] << 0;
+      address  = patch_stream_read_byte(patch) << 16;
+      address |= patch_stream_read_byte(patch) << 8;
+      address |= patch_stream_read_byte(patch) << 0;
 
       if (address == 0x454f46) /* EOF */
       {
-         if (offset == patchlen)
+         if (patch->offset == patch->length)
             return PATCH_SUCCESS;
 
-         if (offset == patchlen - 3)
+         if (patch->offset == patch->length - 3)
          {
-            uint32_t size  = patchdata[offset++] << 16;
-            size          |= patchdata[offset++] << 8;
-            size          |= patchdata[offset++] << 0;
+            patch_stream_skip(patch, 3);
             return PATCH_SUCCESS;
          }
       }
 
-      if (offset > patchlen - 2)
+      if (patch->offset > patch->length - 2)
          break;
 
-      length  = patchdata[offset++] << 8;
-      length |= patchdata[offset++] << 0;
+      length  = patch_stream_read_byte(patch) << 8;
+      length |= patch_stream_read_byte(patch) << 0;
 
       if (length) /* Copy */
       {
-         if (offset > patchlen - length)
+         if (patch->offset > patch->length - length)
             break;
 
          while (length--)
-            (*targetdata)[address++] = patchdata[offset++];
+            (*targetdata)[address++] = patch_stream_read_byte(patch);
       }
       else /* RLE */
       {
-         if (offset > patchlen - 3)
+         uint8_t fill;
+
+         if (patch->offset > patch->length - 3)
             break;
 
-         length  = patchdata[offset++] << 8;
-         length |= patchdata[offset++] << 0;
+         length  = patch_stream_read_byte(patch) << 8;
+         length |= patch_stream_read_byte(patch) << 0;
 
          if (length == 0) /* Illegal */
             break;
 
-         while (length--)
-            (*targetdata)[address++] = patchdata[offset];
+         fill = patch_stream_read_byte(patch);
 
-         offset++;
+         while (length--)
+            (*targetdata)[address++] = fill;
       }
    }
 
@@ -609,7 +724,7 @@ static enum patch_error ips_apply_patch(
 
 static bool apply_patch_content(uint8_t **buf,
       ssize_t *size, const char *patch_desc, const char *patch_path,
-      patch_func_t func, void *patch_data, int64_t patch_size)
+      patch_func_t func, struct patch_stream *patch)
 {
    enum patch_error err     = PATCH_UNKNOWN;
    ssize_t ret_size         = *size;
@@ -620,44 +735,58 @@ static bool apply_patch_content(uint8_t **buf,
    RARCH_LOG("Found %s file in \"%s\", attempting to patch ...\n",
          patch_desc, patch_path);
 
-   if ((err = func((const uint8_t*)patch_data, patch_size, ret_buf,
+   if ((err = func(patch, &ret_buf,
          ret_size, &patched_content, &target_size)) == PATCH_SUCCESS)
    {
-      free(ret_buf);
+      /* ret_buf is NULL if the source buffer was
+       * patched in place */
+      if (ret_buf)
+         free(ret_buf);
       *buf  = patched_content;
       *size = target_size;
    }
    else
+   {
       RARCH_ERR("%s %s: %s #%u\n",
             msg_hash_to_str(MSG_FAILED_TO_PATCH),
             patch_desc,
             msg_hash_to_str(MSG_ERROR),
             (unsigned)err);
 
+      if (!ret_buf)
+      {
+         /* Source buffer was consumed by an in-place
+          * patch attempt - hand the (partially
+          * modified) buffer back to the caller rather
+          * than leave a dangling pointer */
+         *buf  = patched_content;
+         *size = target_size;
+      }
+      else if (patched_content)
+         free(patched_content);
+   }
+
    return true;
 }
 
 static bool try_bps_patch(bool allow_bps, const char *name_bps,
       uint8_t **buf, ssize_t *size)
 {
-   if (     allow_bps 
+   if (     allow_bps
          && !string_is_empty(name_bps)
          && path_is_valid(name_bps)
       )
    {
-      int64_t patch_size;
-      bool ret                 = false;
-      void *patch_data         = NULL;
+      struct patch_stream patch;
+      bool ret = false;
 
-      if (!filestream_read_file(name_bps, &patch_data, &patch_size))
+      if (!patch_stream_open(&patch, name_bps))
          return false;
 
-      if (patch_size >= 0)
-         ret = apply_patch_content(buf, size, "BPS", name_bps,
-               bps_apply_patch, patch_data, patch_size);
+      ret = apply_patch_content(buf, size, "BPS", name_bps,
+            bps_apply_patch, &patch);
 
-      if (patch_data)
-         free(patch_data);
+      patch_stream_close(&patch);
       return ret;
    }
 
@@ -672,19 +801,16 @@ static bool try_ups_patch(bool allow_ups, const char *name_ups,
          && path_is_valid(name_ups)
       )
    {
-      int64_t patch_size;
-      bool ret                 = false;
-      void *patch_data         = NULL;
+      struct patch_stream patch;
+      bool ret = false;
 
-      if (!filestream_read_file(name_ups, &patch_data, &patch_size))
+      if (!patch_stream_open(&patch, name_ups))
          return false;
 
-      if (patch_size >= 0)
-         ret = apply_patch_content(buf, size, "UPS", name_ups,
-               ups_apply_patch, patch_data, patch_size);
+      ret = apply_patch_content(buf, size, "UPS", name_ups,
+            ups_apply_patch, &patch);
 
-      if (patch_data)
-         free(patch_data);
+      patch_stream_close(&patch);
       return ret;
    }
    return false;
@@ -693,24 +819,21 @@ static bool try_ups_patch(bool allow_ups, const char *name_ups,
 static bool try_ips_patch(bool allow_ips,
       const char *name_ips, uint8_t **buf, ssize_t *size)
 {
-   if (     allow_ips 
+   if (     allow_ips
          && !string_is_empty(name_ips)
          && path_is_valid(name_ips)
       )
    {
-      int64_t patch_size;
-      bool ret                 = false;
-      void *patch_data         = NULL;
+      struct patch_stream patch;
+      bool ret = false;
 
-      if (!filestream_read_file(name_ips, &patch_data, &patch_size))
+      if (!patch_stream_open(&patch, name_ips))
          return false;
 
-      if (patch_size >= 0)
-         ret = apply_patch_content(buf, size, "IPS", name_ips,
-               ips_apply_patch, patch_data, patch_size);
+      ret = apply_patch_content(buf, size, "IPS", name_ips,
+            ips_apply_patch, &patch);
 
-      if (patch_data)
-         free(patch_data);
+      patch_stream_close(&patch);
       return ret;
    }
    return false;
@@ -20,9 +20,15 @@
 #include <stdio.h>
 #include <ctype.h>
 
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
 #include <string/stdstring.h>
 #include <file/file_path.h>
 #include <net/net_http.h>
+#include <rhash.h>
 #include <streams/file_stream.h>
 
 #include "tasks_internal.h"
@@ -41,6 +47,12 @@
 #endif
 #endif
 
+/* Maximum number of thumbnail transfers in flight at
+ * any one time. The pool is shared across playlist
+ * entries, so the batch downloader keeps the link
+ * saturated instead of draining between entries */
+#define PL_THUMB_MAX_INFLIGHT 6
+
 enum pl_thumb_status
 {
    PL_THUMB_BEGIN = 0,
@@ -56,20 +68,21 @@ typedef struct pl_thumb_handle
    char *dir_thumbnails;
    playlist_t *playlist;
    gfx_thumbnail_path_data_t *thumbnail_path_data;
-   retro_task_t *http_task;
 
    playlist_config_t playlist_config; /* size_t alignment */
 
    size_t list_size;
    size_t list_index;
    unsigned type_idx;
+   /* Number of http transfers issued whose callbacks
+    * have not yet fired */
+   unsigned http_inflight;
 
    enum pl_thumb_status status;
 
    bool overwrite;
    bool right_thumbnail_exists;
    bool left_thumbnail_exists;
-   bool http_task_complete;
 } pl_thumb_handle_t;
 
 typedef struct pl_entry_id
@@ -82,6 +95,95 @@ typedef struct pl_entry_id
 /* Utility Functions */
 /*********************/
 
+/* Content-addressed thumbnail store.
+ *
+ * The server publishes identical art under every regional variant
+ * of a game, so storing each download under its playlist path keeps
+ * the same bytes on disk many times over. Instead each blob lives
+ * once, named by its sha256, in a shared directory next to the
+ * per-system folders, and the per-playlist path is created as a
+ * hard link to it. Readers keep resolving the per-playlist paths
+ * they have always used, while identical art shares one inode: one
+ * copy on disk and one copy in the page cache no matter how many
+ * playlists reference it. On filesystems without hard links (and
+ * on Windows) the file is simply written in place, same as before. */
+#define PL_THUMB_STORE_DIR ".by-hash"
+
+static bool pl_thumb_store_write(const char *dir_thumbnails,
+      const char *path, const void *data, size_t len)
+{
+#if !defined(_WIN32)
+   char blob_dir[PATH_MAX_LENGTH];
+   char blob_path[PATH_MAX_LENGTH];
+   char blob_name[80];
+   char hash[65];
+
+   blob_dir[0] = blob_path[0] = blob_name[0] = hash[0] = '\0';
+
+   if (string_is_empty(dir_thumbnails))
+      return filestream_write_file(path, data, len);
+
+   fill_pathname_join(blob_dir, dir_thumbnails,
+         PL_THUMB_STORE_DIR, sizeof(blob_dir));
+
+   if (!path_is_directory(blob_dir) && !path_mkdir(blob_dir))
+      return filestream_write_file(path, data, len);
+
+   sha256_hash(hash, (const uint8_t*)data, len);
+   strlcpy(blob_name, hash, sizeof(blob_name));
+   strlcat(blob_name, FILE_PATH_PNG_EXTENSION, sizeof(blob_name));
+   fill_pathname_join(blob_path, blob_dir,
+         blob_name, sizeof(blob_path));
+
+   /* First sighting of this content - store the blob */
+   if (!path_is_valid(blob_path) &&
+       !filestream_write_file(blob_path, data, len))
+      return filestream_write_file(path, data, len);
+
+   /* link() refuses to replace an existing name, so clear
+    * any art being overwritten first */
+   if (path_is_valid(path))
+      filestream_delete(path);
+
+   if (link(blob_path, path) == 0)
+      return true;
+
+   /* Cross-device store or a filesystem without hard links */
+   return filestream_write_file(path, data, len);
+#else
+   return filestream_write_file(path, data, len);
+#endif
+}
+
+/* Folds an already-downloaded thumbnail into the store. Called when
+ * a download job walks over art that predates the store, so old
+ * collections deduplicate gradually without a separate migration
+ * pass. */
+static void pl_thumb_store_migrate(const char *dir_thumbnails,
+      const char *path)
+{
+#if !defined(_WIN32)
+   struct stat st;
+   int64_t len   = 0;
+   void *data    = NULL;
+
+   /* More than one name on the inode means this file
+    * already lives in the store */
+   if (stat(path, &st) != 0 || st.st_nlink > 1)
+      return;
+
+   if (!filestream_read_file(path, &data, &len))
+      return;
+
+   if (data)
+   {
+      if (len > 0)
+         pl_thumb_store_write(dir_thumbnails, path, data, (size_t)len);
+      free(data);
+   }
+#endif
+}
+
 /* Fetches local and remote paths for current thumbnail
  * of current type */
 static bool get_thumbnail_paths(
@@ -192,7 +294,8 @@ void cb_http_task_download_pl_thumbnail(
    if (!pl_thumb)
       goto finish;
 
-   pl_thumb->http_task_complete = true;
+   if (pl_thumb->http_inflight > 0)
+      pl_thumb->http_inflight--;
 
    /* Remaining sanity checks... */
    if (!data)
@@ -201,6 +304,15 @@ void cb_http_task_download_pl_thumbnail(
    if (!data->data || string_is_empty(transf->path))
       goto finish;
 
+   /* Discard responses that are not actually PNG data
+    * (e.g. server error pages) before they hit the disk */
+   if ((data->len < 8) ||
+       (memcmp(data->data, "\x89PNG\r\n\x1a\n", 8) != 0))
+   {
+      err = "Not a PNG file.";
+      goto finish;
+   }
+
    /* Create output directory, if required */
    strlcpy(output_dir, transf->path, sizeof(output_dir));
    path_basedir_wrapper(output_dir);
@@ -211,8 +323,10 @@ void cb_http_task_download_pl_thumbnail(
       goto finish;
    }
 
-   /* Write thumbnail file to disk */
-   if (!filestream_write_file(transf->path, data->data, data->len))
+   /* Write thumbnail file to disk (deduplicated through the
+    * content-addressed store) */
+   if (!pl_thumb_store_write(pl_thumb->dir_thumbnails,
+         transf->path, data->data, data->len))
    {
       err = "Write failed.";
       goto finish;
@@ -262,9 +376,6 @@ static void download_pl_thumbnail(pl_thumb_handle_t *pl_thumb)
          if (!transf)
             return; /* If this happens then everything is broken anyway... */
 
-         /* Initialise http task status */
-         pl_thumb->http_task_complete = false;
-
          transf->enum_idx             = MSG_UNKNOWN;
          transf->path[0]              = '\0';
          /* Initialise file transfer */
@@ -274,14 +385,14 @@ static void download_pl_thumbnail(pl_thumb_handle_t *pl_thumb)
          /* Note: We don't actually care if this fails since that
           * just means the file is missing from the server, so it's
           * not something we can handle here... */
-         pl_thumb->http_task = (retro_task_t*)task_push_http_transfer_file(
-               url, true, NULL, cb_http_task_download_pl_thumbnail, transf);
-
-         /* ...if it does fail, however, we can immediately
-          * signal that the task is 'complete' */
-         if (!pl_thumb->http_task)
-            pl_thumb->http_task_complete = true;
+         if (task_push_http_transfer_file_cached(
+               url, true, NULL, cb_http_task_download_pl_thumbnail, transf))
+            pl_thumb->http_inflight++;
       }
+      else
+         /* Nothing to download, but fold pre-store art into
+          * the content-addressed store while we are here */
+         pl_thumb_store_migrate(pl_thumb->dir_thumbnails, path);
    }
 }
 
@@ -339,10 +450,17 @@ static void task_pl_thumbnail_download_handler(retro_task_t *task)
    
    if (!pl_thumb)
       goto task_finished;
-   
+
    if (task_get_cancelled(task))
+   {
+      /* Let any outstanding transfers drain first -
+       * their callbacks poke the handle we are about
+       * to free */
+      if (pl_thumb->http_inflight > 0)
+         return;
       goto task_finished;
-   
+   }
+
    switch (pl_thumb->status)
    {
       case PL_THUMB_BEGIN:
@@ -403,42 +521,38 @@ static void task_pl_thumbnail_download_handler(retro_task_t *task)
          }
          break;
       case PL_THUMB_ITERATE_TYPE:
-         /* Ensure that we only enqueue one transfer
-          * at a time... */
-
-         /* > If HTTP task is NULL, then it either finished
-          *   or an error occurred - in either case,
-          *   current task is 'complete' */
-         if (!pl_thumb->http_task)
-            pl_thumb->http_task_complete = true;
-
-         /* > Wait for task_push_http_transfer_file()
-          *   callback to trigger */
-         if (!pl_thumb->http_task_complete)
-            break;
-
-         pl_thumb->http_task = NULL;
-
-         /* Check whether all thumbnail types have been processed */
-         if (pl_thumb->type_idx > 3)
+         /* Issue transfers while the download pool has
+          * free slots - local paths and urls are captured
+          * at enqueue time, so the next entry can start
+          * before this one has drained */
+         while ((pl_thumb->type_idx <= 3) &&
+                (pl_thumb->http_inflight < PL_THUMB_MAX_INFLIGHT))
          {
-            /* Time to move on to the next entry */
-            pl_thumb->list_index++;
-            if (pl_thumb->list_index < pl_thumb->list_size)
-               pl_thumb->status = PL_THUMB_ITERATE_ENTRY;
-            else
-               pl_thumb->status = PL_THUMB_END;
-            break;
+            /* Download current thumbnail */
+            download_pl_thumbnail(pl_thumb);
+
+            /* Increment thumbnail type */
+            pl_thumb->type_idx++;
          }
 
-         /* Download current thumbnail */
-         download_pl_thumbnail(pl_thumb);
+         /* > Pool is full - wait for a slot to free up */
+         if (pl_thumb->type_idx <= 3)
+            break;
 
-         /* Increment thumbnail type */
-         pl_thumb->type_idx++;
+         /* Time to move on to the next entry */
+         pl_thumb->list_index++;
+         if (pl_thumb->list_index < pl_thumb->list_size)
+            pl_thumb->status = PL_THUMB_ITERATE_ENTRY;
+         else
+            pl_thumb->status = PL_THUMB_END;
          break;
       case PL_THUMB_END:
       default:
+         /* Wait for the last transfers to drain before
+          * tearing down the handle - their callbacks
+          * still poke it */
+         if (pl_thumb->http_inflight > 0)
+            break;
          task_set_progress(task, 100);
          goto task_finished;
    }
@@ -523,8 +637,7 @@ bool task_push_pl_thumbnail_download(
    pl_thumb->dir_thumbnails      = strdup(dir_thumbnails);
    pl_thumb->playlist            = NULL;
    pl_thumb->thumbnail_path_data = NULL;
-   pl_thumb->http_task           = NULL;
-   pl_thumb->http_task_complete  = false;
+   pl_thumb->http_inflight       = 0;
    pl_thumb->list_size           = 0;
    pl_thumb->list_index          = 0;
    pl_thumb->type_idx            = 1;
@@ -666,10 +779,17 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
    
    if (!pl_thumb)
       goto task_finished;
-   
+
    if (task_get_cancelled(task))
+   {
+      /* Let any outstanding transfers drain first -
+       * their callbacks poke the handle that gets
+       * freed on cleanup */
+      if (pl_thumb->http_inflight > 0)
+         return;
       goto task_finished;
-   
+   }
+
    switch (pl_thumb->status)
    {
       case PL_THUMB_BEGIN:
@@ -704,37 +824,27 @@ static void task_pl_entry_thumbnail_download_handler(retro_task_t *task)
          break;
       case PL_THUMB_ITERATE_TYPE:
          {
-            /* Ensure that we only enqueue one transfer
-             * at a time... */
-            
-            /* > If HTTP task is NULL, then it either finished
-             *   or an error occurred - in either case,
-             *   current task is 'complete' */
-            if (!pl_thumb->http_task)
-               pl_thumb->http_task_complete = true;
-            
-            /* > Wait for task_push_http_transfer_file()
-             *   callback to trigger */
-            if (pl_thumb->http_task_complete)
-               pl_thumb->http_task = NULL;
-            else
-               break;
-            
-            /* Check whether all thumbnail types have been processed */
-            if (pl_thumb->type_idx > 3)
+            /* Enqueue all thumbnail types for this entry -
+             * the transfers proceed concurrently on the
+             * task queue */
+            if (pl_thumb->type_idx <= 3)
             {
-               pl_thumb->status = PL_THUMB_END;
+               /* Update progress */
+               task_set_progress(task, ((pl_thumb->type_idx - 1) * 100) / 3);
+
+               /* Download current thumbnail */
+               download_pl_thumbnail(pl_thumb);
+
+               /* Increment thumbnail type */
+               pl_thumb->type_idx++;
                break;
             }
-            
-            /* Update progress */
-            task_set_progress(task, ((pl_thumb->type_idx - 1) * 100) / 3);
-            
-            /* Download current thumbnail */
-            download_pl_thumbnail(pl_thumb);
-            
-            /* Increment thumbnail type */
-            pl_thumb->type_idx++;
+
+            /* > Wait for the outstanding transfers to drain */
+            if (pl_thumb->http_inflight > 0)
+               break;
+
+            pl_thumb->status = PL_THUMB_END;
          }
          break;
       case PL_THUMB_END:
@@ -853,8 +963,7 @@ bool task_push_pl_entry_thumbnail_download(
    pl_thumb->dir_thumbnails      = strdup(dir_thumbnails);
    pl_thumb->playlist            = NULL;
    pl_thumb->thumbnail_path_data = thumbnail_path_data;
-   pl_thumb->http_task           = NULL;
-   pl_thumb->http_task_complete  = false;
+   pl_thumb->http_inflight       = 0;
    pl_thumb->list_size           = playlist_size(playlist);
    pl_thumb->list_index          = idx;
    pl_thumb->type_idx            = 1;
@@ -41,12 +41,17 @@ enum pl_manager_status
    PL_MANAGER_ITERATE_ENTRY_VALIDATE,
    PL_MANAGER_VALIDATE_END,
    PL_MANAGER_ITERATE_ENTRY_CHECK_DUPLICATE,
+   PL_MANAGER_ITERATE_ENTRY_DELETE_DUPLICATE,
    PL_MANAGER_CHECK_DUPLICATE_END,
    PL_MANAGER_ITERATE_FETCH_M3U,
    PL_MANAGER_ITERATE_CLEAN_M3U,
    PL_MANAGER_END
 };
 
+/* Number of entries processed per iteration during
+ * the duplicate check/delete phases */
+#define PL_MANAGER_DEDUPE_CHUNK_SIZE 256
+
 typedef struct pl_manager_handle
 {
    struct string_list *m3u_list;
@@ -55,6 +60,11 @@ typedef struct pl_manager_handle
    size_t list_size;
    size_t list_index;
    size_t m3u_index;
+   /* Duplicate check hash set (open addressing) */
+   size_t *dup_slots;      /* entry index + 1 per slot, 0 = empty */
+   uint32_t *dup_hashes;   /* hash of each occupied slot */
+   size_t dup_table_size;  /* power of two */
+   uint8_t *dup_flags;     /* one bit per entry: flagged as duplicate */
    playlist_config_t playlist_config; /* size_t alignment */
    enum pl_manager_status status;
 } pl_manager_handle_t;
@@ -63,11 +73,28 @@ typedef struct pl_manager_handle
 /* Utility Functions */
 /*********************/
 
+static void pl_manager_free_dedupe_buffers(pl_manager_handle_t *pl_manager)
+{
+   if (pl_manager->dup_slots)
+      free(pl_manager->dup_slots);
+   if (pl_manager->dup_hashes)
+      free(pl_manager->dup_hashes);
+   if (pl_manager->dup_flags)
+      free(pl_manager->dup_flags);
+
+   pl_manager->dup_slots      = NULL;
+   pl_manager->dup_hashes     = NULL;
+   pl_manager->dup_flags      = NULL;
+   pl_manager->dup_table_size = 0;
+}
+
 static void free_pl_manager_handle(pl_manager_handle_t *pl_manager)
 {
    if (!pl_manager)
       return;
-   
+
+   pl_manager_free_dedupe_buffers(pl_manager);
+
    if (pl_manager->m3u_list)
    {
       string_list_free(pl_manager->m3u_list);
@@ -366,6 +393,42 @@ error:
 /* Clean Playlist */
 /******************/
 
+/* Hashes the part of an entry that playlist_entries_are_equal()
+ * compares first: the resolved content path, truncated at any
+ * archive delimiter so fuzzy archive matches land in the same
+ * bucket. Entries that merely share a hash are still verified
+ * with playlist_entries_are_equal() before being treated as
+ * duplicates. */
+static uint32_t pl_manager_entry_dedupe_hash(
+      const struct playlist_entry *entry)
+{
+   char real_path[PATH_MAX_LENGTH];
+   const char *delim = NULL;
+   const char *str   = real_path;
+   uint32_t hash     = 5381;
+
+   real_path[0]      = '\0';
+
+   if (!string_is_empty(entry->path))
+   {
+      strlcpy(real_path, entry->path, sizeof(real_path));
+      path_resolve_realpath(real_path, sizeof(real_path), true);
+
+      delim = path_get_archive_delim(real_path);
+   }
+
+   for (; *str && (!delim || str < delim); str++)
+#ifdef _WIN32
+      /* Handle case-insensitive operating systems */
+      hash = ((hash << 5) + hash) ^
+            (uint32_t)tolower((unsigned char)*str);
+#else
+      hash = ((hash << 5) + hash) ^ (uint32_t)*str;
+#endif
+
+   return hash;
+}
+
 static bool pl_manager_content_exists(const char *path)
 {
    /* Sanity check */
@@ -600,66 +663,148 @@ static void task_pl_manager_clean_playlist_handler(retro_task_t *task)
                break;
             }
             
-            /* ...otherwise, reset index counter and
-             * start the duplicates check */
-            pl_manager->list_index = 0;
+            /* ...otherwise, build the hash set used by the
+             * duplicates check. Sized at twice the entry count
+             * (rounded up to a power of two), so the load factor
+             * never exceeds 0.5 */
+            pl_manager->dup_table_size = 2;
+            while (pl_manager->dup_table_size < (2 * pl_manager->list_size))
+               pl_manager->dup_table_size <<= 1;
+
+            pl_manager->dup_slots  = (size_t*)calloc(
+                  pl_manager->dup_table_size, sizeof(size_t));
+            pl_manager->dup_hashes = (uint32_t*)calloc(
+                  pl_manager->dup_table_size, sizeof(uint32_t));
+            pl_manager->dup_flags  = (uint8_t*)calloc(
+                  (pl_manager->list_size + 7) >> 3, sizeof(uint8_t));
+
+            if (!pl_manager->dup_slots ||
+                !pl_manager->dup_hashes ||
+                !pl_manager->dup_flags)
+            {
+               /* Out of memory - skip the duplicates check
+                * rather than failing the whole task */
+               pl_manager_free_dedupe_buffers(pl_manager);
+               pl_manager->status = PL_MANAGER_CHECK_DUPLICATE_END;
+               break;
+            }
+
+            /* Start the duplicates check. Both the check and
+             * the delete phases walk the playlist *backwards*,
+             * which preserves the existing 'keep the last
+             * occurrence' behaviour and keeps entry indices
+             * stable while deleting */
+            pl_manager->list_index = pl_manager->list_size;
             pl_manager->status = PL_MANAGER_ITERATE_ENTRY_CHECK_DUPLICATE;
          }
          break;
       case PL_MANAGER_ITERATE_ENTRY_CHECK_DUPLICATE:
          {
-            const struct playlist_entry *entry = NULL;
-            bool entry_deleted                 = false;
-            
+            size_t mask    = pl_manager->dup_table_size - 1;
+            size_t i;
+
             /* Update progress display */
-            task_set_progress(task, (pl_manager->list_index * 100) / pl_manager->list_size);
-            
-            /* Get current entry */
-            playlist_get_index(
-                  pl_manager->playlist, pl_manager->list_index, &entry);
-            
-            if (entry)
+            task_set_progress(task,
+                  (unsigned)(((pl_manager->list_size - pl_manager->list_index) * 100) /
+                        pl_manager->list_size));
+
+            /* Process entries in fixed-size chunks, so the
+             * task remains responsive on large playlists */
+            for (i = 0; (i < PL_MANAGER_DEDUPE_CHUNK_SIZE) &&
+                  (pl_manager->list_index > 0); i++)
             {
-               size_t i;
-               
-               /* Loop over all subsequent entries, and check
-                * whether content + core paths are the same */
-               for (i = pl_manager->list_index + 1; i < pl_manager->list_size; i++)
+               const struct playlist_entry *entry = NULL;
+               size_t idx                         = pl_manager->list_index - 1;
+
+               pl_manager->list_index--;
+
+               /* Get current entry */
+               playlist_get_index(pl_manager->playlist, idx, &entry);
+
+               if (entry)
                {
-                  const struct playlist_entry *next_entry = NULL;
-                  
-                  /* Get next entry */
-                  playlist_get_index(pl_manager->playlist, i, &next_entry);
-                  
-                  if (!next_entry)
-                     continue;
-                  
-                  if (playlist_entries_are_equal(
-                        entry, next_entry, &pl_manager->playlist_config))
+                  uint32_t hash = pl_manager_entry_dedupe_hash(entry);
+                  size_t slot   = (size_t)hash & mask;
+
+                  /* Probe the hash set for a *later* entry with
+                   * the same content path (later, because we are
+                   * iterating backwards). The table can never
+                   * fill up, so this always terminates */
+                  for (;; slot = (slot + 1) & mask)
                   {
-                     /* Duplicate found - delete entry */
-                     playlist_delete_index(pl_manager->playlist, pl_manager->list_index);
-                     entry_deleted = true;
-                     
-                     /* Update list_size */
-                     pl_manager->list_size = playlist_size(pl_manager->playlist);
-                     break;
+                     const struct playlist_entry *other = NULL;
+
+                     if (pl_manager->dup_slots[slot] == 0)
+                     {
+                        /* Empty slot - first occurrence of this
+                         * hash, record it */
+                        pl_manager->dup_slots[slot]  = idx + 1;
+                        pl_manager->dup_hashes[slot] = hash;
+                        break;
+                     }
+
+                     if (pl_manager->dup_hashes[slot] != hash)
+                        continue;
+
+                     /* Hash match - verify with the real
+                      * comparison before flagging, since
+                      * distinct paths may collide */
+                     playlist_get_index(pl_manager->playlist,
+                           pl_manager->dup_slots[slot] - 1, &other);
+
+                     if (other &&
+                         playlist_entries_are_equal(
+                              entry, other, &pl_manager->playlist_config))
+                     {
+                        /* Duplicate found - flag this (earlier)
+                         * entry for deletion */
+                        pl_manager->dup_flags[idx >> 3] |=
+                              (uint8_t)(1 << (idx & 7));
+                        break;
+                     }
                   }
                }
             }
-            
-            /* Increment entry index *if* current entry still
-             * exists (i.e. if entry was deleted, current index
-             * will already point to the *next* entry) */
-            if (!entry_deleted)
-               pl_manager->list_index++;
-            
-            if (pl_manager->list_index + 1 >= pl_manager->list_size)
+
+            if (pl_manager->list_index == 0)
+            {
+               /* Check phase done - delete the flagged entries */
+               pl_manager->list_index = pl_manager->list_size;
+               pl_manager->status = PL_MANAGER_ITERATE_ENTRY_DELETE_DUPLICATE;
+            }
+         }
+         break;
+      case PL_MANAGER_ITERATE_ENTRY_DELETE_DUPLICATE:
+         {
+            size_t i;
+
+            /* Delete flagged entries in fixed-size chunks.
+             * Deleting backwards means the original indices of
+             * entries not yet processed remain valid */
+            for (i = 0; (i < PL_MANAGER_DEDUPE_CHUNK_SIZE) &&
+                  (pl_manager->list_index > 0); i++)
+            {
+               size_t idx = pl_manager->list_index - 1;
+
+               pl_manager->list_index--;
+
+               if (pl_manager->dup_flags[idx >> 3] & (1 << (idx & 7)))
+                  playlist_delete_index(pl_manager->playlist, idx);
+            }
+
+            if (pl_manager->list_index == 0)
+            {
+               /* Update list_size */
+               pl_manager->list_size = playlist_size(pl_manager->playlist);
                pl_manager->status = PL_MANAGER_CHECK_DUPLICATE_END;
+            }
          }
          break;
       case PL_MANAGER_CHECK_DUPLICATE_END:
          {
+            /* Hash set is no longer required */
+            pl_manager_free_dedupe_buffers(pl_manager);
+
             /* Sanity check - if all (or all but one)
              * playlist entries were removed during the
              * 'check duplicate' phase, we can stop now */
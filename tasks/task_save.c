@@ -28,7 +28,9 @@
 
 #include <compat/strl.h>
 #include <retro_assert.h>
+#include <encodings/crc32.h>
 #include <lists/string_list.h>
+#include <memalign.h>
 #include <streams/interface_stream.h>
 #include <streams/file_stream.h>
 #include <streams/rzip_stream.h>
@@ -105,6 +107,21 @@ typedef struct
    bool compress_files;
 } save_task_state_t;
 
+/* Save journal format
+ * > In journal mode, each autosave interval appends the
+ *   changed byte ranges as self-validating records instead
+ *   of rewriting the whole save file; the full file is only
+ *   materialized when the autosave session ends
+ * > File header: magic, version, SRAM size
+ * > Record: generation, offset, length, payload CRC,
+ *   then the payload itself. Replay applies records in
+ *   order and stops at the first record that fails
+ *   validation, so a write interrupted mid-record simply
+ *   loses that record and nothing else */
+#define AUTOSAVE_JOURNAL_MAGIC     0x4C4A5352 /* 'RSJL' */
+#define AUTOSAVE_JOURNAL_VERSION   1
+#define AUTOSAVE_JOURNAL_SUFFIX    ".journal"
+
 #ifdef HAVE_THREADS
 typedef struct autosave autosave_t;
 
@@ -115,6 +132,9 @@ struct autosave_st
    unsigned num;
 };
 
+/* Granularity of SRAM change tracking. */
+#define AUTOSAVE_PAGE_SIZE 4096
+
 struct autosave
 {
    void *buffer;
@@ -124,10 +144,20 @@ struct autosave
    slock_t *cond_lock;
    scond_t *cond;
    sthread_t *thread;
+   /* One flag per AUTOSAVE_PAGE_SIZE page, set when the page
+    * changed since the last write. */
+   uint8_t *dirty;
+   /* Journal mode state - the stream stays open across
+    * intervals so each flush is a cheap append. */
+   intfstream_t *journal;
+   char journal_path[PATH_MAX_LENGTH];
+   uint32_t generation;
+   size_t num_pages;
    size_t bufsize;
    unsigned interval;
    volatile bool quit;
    bool compress_files;
+   bool journal_mode;
 };
 #endif
 
@@ -151,7 +181,203 @@ static struct autosave_st autosave_state;
 static bool save_state_in_background       = false;
 static struct string_list *task_save_files = NULL;
 
+/* Serialization arena: one buffer reused across save states,
+ * so each save doesn't pay for a fresh allocation (and the
+ * accompanying page faults) of retro_serialize_size() bytes. */
+static void *save_state_arena_buf          = NULL;
+static size_t save_state_arena_size        = 0;
+static bool save_state_arena_in_use        = false;
+#ifdef HAVE_THREADS
+static slock_t *save_state_arena_lock      = NULL;
+#endif
+
+/* RAM-resident savestate cache. Saving keeps a copy of the
+ * serialized state in one of these slots (keyed by target path,
+ * LRU eviction) while the disk write proceeds in the background;
+ * loading a state that was saved this session is then served
+ * straight from RAM, skipping the file read and decompression.
+ * Entries are dropped whenever the file on disk is changed
+ * behind the cache's back (rename, undo-save) and when content
+ * is closed. */
+#define RAM_STATE_CACHE_SLOTS 4
+
+struct ram_state_slot
+{
+   void *data;
+   size_t size;
+   unsigned used; /* LRU tick of the last store/hit. */
+   char path[PATH_MAX_LENGTH];
+};
+
+static struct ram_state_slot ram_state_cache[RAM_STATE_CACHE_SLOTS];
+static unsigned ram_state_cache_tick       = 0;
+#ifdef HAVE_THREADS
+static slock_t *ram_state_cache_lock       = NULL;
+#endif
+
+static void save_state_arena_release(void *data);
+
 #ifdef HAVE_THREADS
+/**
+ * autosave_file_is_rzip:
+ * @file            : open stream positioned anywhere
+ *
+ * An existing save written while compression was enabled
+ * (or synced in from another machine) must not be patched
+ * in place as if it were raw SRAM - sniff the RZIP magic
+ * before trusting a size match. Leaves the stream rewound.
+ **/
+static bool autosave_file_is_rzip(intfstream_t *file)
+{
+   uint8_t header[8];
+   bool is_rzip =
+         (intfstream_seek(file, 0, SEEK_SET) == 0)
+      && (intfstream_read(file, header, sizeof(header))
+            == (int64_t)sizeof(header))
+      && (header[0] == '#')
+      && (header[1] == 'R')
+      && (header[2] == 'Z')
+      && (header[3] == 'I')
+      && (header[4] == 'P')
+      && (header[5] == 'v')
+      && (header[7] == '#');
+
+   intfstream_seek(file, 0, SEEK_SET);
+
+   return is_rzip;
+}
+
+/**
+ * autosave_journal_open:
+ * @save            : pointer to autosave object
+ *
+ * Creates a fresh journal file (truncating any stale one)
+ * and writes its header.
+ *
+ * Returns: open journal stream, or NULL on failure.
+ **/
+static intfstream_t *autosave_journal_open(autosave_t *save)
+{
+   uint32_t header[3];
+   intfstream_t *journal = intfstream_open_file(save->journal_path,
+         RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+   if (!journal)
+      return NULL;
+
+   header[0] = AUTOSAVE_JOURNAL_MAGIC;
+   header[1] = AUTOSAVE_JOURNAL_VERSION;
+   header[2] = (uint32_t)save->bufsize;
+
+   if (intfstream_write(journal, header, sizeof(header))
+         != (int64_t)sizeof(header))
+   {
+      intfstream_close(journal);
+      free(journal);
+      return NULL;
+   }
+
+   save->generation = 0;
+
+   return journal;
+}
+
+/**
+ * autosave_journal_discard:
+ * @save            : pointer to autosave object
+ *
+ * Closes and deletes the journal. Called whenever a full
+ * copy of the save has been written, at which point replaying
+ * the journal's deltas would be stale.
+ **/
+static void autosave_journal_discard(autosave_t *save)
+{
+   if (save->journal)
+   {
+      intfstream_close(save->journal);
+      free(save->journal);
+      save->journal = NULL;
+   }
+
+   if (path_is_valid(save->journal_path))
+      filestream_delete(save->journal_path);
+
+   save->generation = 0;
+}
+
+/**
+ * autosave_journal_append:
+ * @save            : pointer to autosave object
+ *
+ * Appends one record per run of dirty pages to the journal
+ * and flushes it, which costs the size of the changed data
+ * rather than the whole save region.
+ *
+ * Returns: true if all records were written, otherwise false
+ * (the caller is expected to fall back to a full rewrite).
+ **/
+static bool autosave_journal_append(autosave_t *save)
+{
+   size_t i;
+   bool ok = true;
+
+   if (!save->journal)
+      save->journal = autosave_journal_open(save);
+
+   if (!save->journal)
+      return false;
+
+   for (i = 0; i < save->num_pages && ok; )
+   {
+      size_t start, offset, len;
+      uint32_t header[4];
+
+      if (!save->dirty[i])
+      {
+         i++;
+         continue;
+      }
+
+      /* Coalesce runs of dirty pages into one record. */
+      start  = i;
+      while (i < save->num_pages && save->dirty[i])
+         i++;
+
+      offset = start * AUTOSAVE_PAGE_SIZE;
+      len    = MIN((i - start) * AUTOSAVE_PAGE_SIZE,
+            save->bufsize - offset);
+
+      header[0] = save->generation;
+      header[1] = (uint32_t)offset;
+      header[2] = (uint32_t)len;
+      header[3] = encoding_crc32(0,
+            (uint8_t*)save->buffer + offset, len);
+
+      if (     (intfstream_write(save->journal, header,
+                  sizeof(header)) != (int64_t)sizeof(header))
+            || (intfstream_write(save->journal,
+                  (uint8_t*)save->buffer + offset, len)
+                  != (int64_t)len))
+         ok = false;
+   }
+
+   if (ok)
+   {
+      intfstream_flush(save->journal);
+      save->generation++;
+   }
+   else
+   {
+      /* A half-appended record is skipped by replay, and the
+       * caller's full rewrite supersedes the journal anyway. */
+      intfstream_close(save->journal);
+      free(save->journal);
+      save->journal = NULL;
+   }
+
+   return ok;
+}
+
 /**
  * autosave_thread:
  * @data            : pointer to autosave object
@@ -164,33 +390,123 @@ static void autosave_thread(void *data)
 
    while (!save->quit)
    {
-      bool differ;
+      size_t i;
+      bool differ = false;
 
+      /* Compare page-wise against the last written snapshot so an
+       * unchanged save costs one pass over the buffer, and a
+       * changed one knows exactly which pages moved. */
       slock_lock(save->lock);
-      differ = string_is_not_equal_fast(save->buffer, save->retro_buffer,
-            save->bufsize);
-      if (differ)
-         memcpy(save->buffer, save->retro_buffer, save->bufsize);
+      for (i = 0; i < save->num_pages; i++)
+      {
+         size_t offset = i * AUTOSAVE_PAGE_SIZE;
+         size_t len    = MIN(AUTOSAVE_PAGE_SIZE, save->bufsize - offset);
+
+         if (string_is_not_equal_fast(
+                  (uint8_t*)save->buffer + offset,
+                  (const uint8_t*)save->retro_buffer + offset, len))
+         {
+            memcpy((uint8_t*)save->buffer + offset,
+                  (const uint8_t*)save->retro_buffer + offset, len);
+            save->dirty[i] = 1;
+            differ         = true;
+         }
+         else
+            save->dirty[i] = 0;
+      }
       slock_unlock(save->lock);
 
       if (differ)
       {
          intfstream_t *file = NULL;
-
-         /* Should probably deal with this more elegantly. */
-         if (save->compress_files)
-            file = intfstream_open_rzip_file(save->path,
-                  RETRO_VFS_FILE_ACCESS_WRITE);
-         else
+         bool written       = false;
+
+         /* Journal mode appends just the changed ranges - the
+          * full file is only materialized when the session
+          * ends, or below if the append fails. */
+         if (save->journal_mode)
+            written = autosave_journal_append(save);
+
+         /* Uncompressed saves can be patched in place: once the
+          * file exists with the right size, only the dirty pages
+          * have to be rewritten. Compressed saves have no stable
+          * page offsets and always take the full rewrite below. */
+         if (!written && !save->compress_files && !save->journal_mode)
+         {
             file = intfstream_open_file(save->path,
-                  RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+                  RETRO_VFS_FILE_ACCESS_READ_WRITE |
+                  RETRO_VFS_FILE_ACCESS_UPDATE_EXISTING,
+                  RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+            if (file)
+            {
+               if (  (intfstream_get_size(file) == (int64_t)save->bufsize)
+                  && !autosave_file_is_rzip(file))
+               {
+                  written = true;
+
+                  for (i = 0; i < save->num_pages && written; )
+                  {
+                     size_t start, offset, len;
+
+                     if (!save->dirty[i])
+                     {
+                        i++;
+                        continue;
+                     }
+
+                     /* Coalesce runs of dirty pages into one
+                      * seek + write. */
+                     start  = i;
+                     while (i < save->num_pages && save->dirty[i])
+                        i++;
+
+                     offset = start * AUTOSAVE_PAGE_SIZE;
+                     len    = MIN((i - start) * AUTOSAVE_PAGE_SIZE,
+                           save->bufsize - offset);
+
+                     if (     intfstream_seek(file,
+                              (int64_t)offset, SEEK_SET) == -1
+                           || intfstream_write(file,
+                              (uint8_t*)save->buffer + offset, len)
+                              != (int64_t)len)
+                        written = false;
+                  }
+
+                  intfstream_flush(file);
+               }
+
+               intfstream_close(file);
+               free(file);
+               file = NULL;
+            }
+         }
 
-         if (file)
+         if (!written)
          {
-            intfstream_write(file, save->buffer, save->bufsize);
-            intfstream_flush(file);
-            intfstream_close(file);
-            free(file);
+            /* Should probably deal with this more elegantly. */
+            if (save->compress_files)
+               file = intfstream_open_rzip_file(save->path,
+                     RETRO_VFS_FILE_ACCESS_WRITE);
+            else
+               file = intfstream_open_file(save->path,
+                     RETRO_VFS_FILE_ACCESS_WRITE, RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+            if (file)
+            {
+               int64_t wrote = intfstream_write(file,
+                     save->buffer, save->bufsize);
+               intfstream_flush(file);
+               intfstream_close(file);
+               free(file);
+
+               /* A full rewrite makes any journal stale - drop
+                * it rather than risk replaying old deltas over
+                * the new base after a crash. */
+               if (     save->journal_mode
+                     && (wrote == (int64_t)save->bufsize))
+                  autosave_journal_discard(save);
+            }
          }
       }
 
@@ -225,7 +541,7 @@ static void autosave_thread(void *data)
  **/
 static autosave_t *autosave_new(const char *path,
       const void *data, size_t size,
-      unsigned interval, bool compress)
+      unsigned interval, bool compress, bool journal)
 {
    void       *buf               = NULL;
    autosave_t *handle            = (autosave_t*)malloc(sizeof(*handle));
@@ -236,10 +552,25 @@ static autosave_t *autosave_new(const char *path,
    handle->bufsize               = size;
    handle->interval              = interval;
    handle->compress_files        = compress;
+   handle->journal_mode          = journal;
+   handle->journal               = NULL;
+   handle->generation            = 0;
    handle->retro_buffer          = data;
    handle->path                  = path;
+   handle->journal_path[0]       = '\0';
 
-   buf                           = malloc(size);
+   if (journal)
+   {
+      strlcpy(handle->journal_path, path,
+            sizeof(handle->journal_path));
+      strlcat(handle->journal_path, AUTOSAVE_JOURNAL_SUFFIX,
+            sizeof(handle->journal_path));
+   }
+
+   /* The SRAM shadow copy is compared and re-copied page by
+    * page on every interval - hugepage backing keeps those
+    * passes off the TLB for large save RAM */
+   buf                           = memalign_alloc_big(size);
 
    if (!buf)
    {
@@ -251,6 +582,18 @@ static autosave_t *autosave_new(const char *path,
 
    memcpy(handle->buffer, handle->retro_buffer, handle->bufsize);
 
+   handle->num_pages             = (size + AUTOSAVE_PAGE_SIZE - 1)
+      / AUTOSAVE_PAGE_SIZE;
+   handle->dirty                 = (uint8_t*)calloc(
+         handle->num_pages, sizeof(uint8_t));
+
+   if (!handle->dirty)
+   {
+      memalign_free_big(handle->buffer, handle->bufsize);
+      free(handle);
+      return NULL;
+   }
+
    handle->lock                  = slock_new();
    handle->cond_lock             = slock_new();
    handle->cond                  = scond_new();
@@ -277,9 +620,52 @@ static void autosave_free(autosave_t *handle)
    slock_free(handle->cond_lock);
    scond_free(handle->cond);
 
+   /* Journal mode defers the full file - materialize it from
+    * the final snapshot now, so the save at rest goes back to
+    * being a plain (optionally compressed) file with no
+    * journal alongside it. */
+   if (handle->journal_mode)
+   {
+      if (handle->journal)
+      {
+         intfstream_close(handle->journal);
+         free(handle->journal);
+         handle->journal = NULL;
+      }
+
+      if (path_is_valid(handle->journal_path))
+      {
+         intfstream_t *file = NULL;
+
+         if (handle->compress_files)
+            file = intfstream_open_rzip_file(handle->path,
+                  RETRO_VFS_FILE_ACCESS_WRITE);
+         else
+            file = intfstream_open_file(handle->path,
+                  RETRO_VFS_FILE_ACCESS_WRITE,
+                  RETRO_VFS_FILE_ACCESS_HINT_NONE);
+
+         if (file)
+         {
+            int64_t wrote = intfstream_write(file,
+                  handle->buffer, handle->bufsize);
+            intfstream_flush(file);
+            intfstream_close(file);
+            free(file);
+
+            if (wrote == (int64_t)handle->bufsize)
+               filestream_delete(handle->journal_path);
+         }
+      }
+   }
+
    if (handle->buffer)
-      free(handle->buffer);
+      memalign_free_big(handle->buffer, handle->bufsize);
    handle->buffer = NULL;
+
+   if (handle->dirty)
+      free(handle->dirty);
+   handle->dirty  = NULL;
 }
 
 bool autosave_init(void)
@@ -293,6 +679,7 @@ bool autosave_init(void)
 #else
    bool compress_files        = false;
 #endif
+   bool journal_mode          = settings->bools.save_file_journaling;
 
    if (autosave_interval < 1 || !task_save_files)
       return false;
@@ -325,7 +712,8 @@ bool autosave_init(void)
             mem_info.data,
             mem_info.size,
             autosave_interval,
-            compress_files);
+            compress_files,
+            journal_mode);
 
       if (!auto_st)
       {
@@ -571,13 +959,243 @@ static void task_save_handler_finished(retro_task_t *task,
    {
       if (state->undo_save && state->data == undo_save_buf.data)
          undo_save_buf.data = NULL;
-      free(state->data);
+      save_state_arena_release(state->data);
       state->data = NULL;
    }
 
    free(state);
 }
 
+/**
+ * save_state_arena_acquire:
+ * @size : number of bytes the caller needs
+ *
+ * Hands out the shared serialization buffer, growing it if
+ * needed. If it is still owned by an in-flight save task, a
+ * one-shot buffer is returned instead. Either way the result
+ * is zero-initialised and must be returned through
+ * save_state_arena_release().
+ **/
+static void *save_state_arena_acquire(size_t size)
+{
+   void *data = NULL;
+
+#ifdef HAVE_THREADS
+   /* First acquire always happens before the first release,
+    * so the lock exists by the time anyone else needs it. */
+   if (!save_state_arena_lock)
+      save_state_arena_lock = slock_new();
+   if (save_state_arena_lock)
+      slock_lock(save_state_arena_lock);
+#endif
+
+   if (!save_state_arena_in_use)
+   {
+      if (save_state_arena_size < size)
+      {
+         free(save_state_arena_buf);
+         save_state_arena_buf  = malloc(size);
+         save_state_arena_size = save_state_arena_buf ? size : 0;
+      }
+
+      if (save_state_arena_buf)
+      {
+         save_state_arena_in_use = true;
+         data                    = save_state_arena_buf;
+      }
+   }
+
+#ifdef HAVE_THREADS
+   if (save_state_arena_lock)
+      slock_unlock(save_state_arena_lock);
+#endif
+
+   if (!data)
+      data = malloc(size);
+
+   /* Ensure buffer is initialised to zero
+    * > Prevents inconsistent compressed state file
+    *   sizes when core requests a larger buffer
+    *   than it needs (and leaves the excess
+    *   as uninitialised garbage) */
+   if (data)
+      memset(data, 0, size);
+
+   return data;
+}
+
+/**
+ * save_state_arena_release:
+ * @data : buffer obtained from save_state_arena_acquire()
+ *
+ * Returns the shared buffer to the arena; one-shot fallback
+ * buffers are simply freed.
+ **/
+static void save_state_arena_release(void *data)
+{
+   if (!data)
+      return;
+
+#ifdef HAVE_THREADS
+   if (save_state_arena_lock)
+      slock_lock(save_state_arena_lock);
+#endif
+
+   if (data == save_state_arena_buf)
+      save_state_arena_in_use = false;
+   else
+      free(data);
+
+#ifdef HAVE_THREADS
+   if (save_state_arena_lock)
+      slock_unlock(save_state_arena_lock);
+#endif
+}
+
+/**
+ * ram_state_cache_store:
+ * @path : target path of the save state
+ * @data : serialized state
+ * @size : size of the serialized state
+ *
+ * Keeps a RAM copy of a state that is being written to @path.
+ * Reuses the slot already holding @path if there is one,
+ * otherwise evicts the least recently used slot.
+ **/
+static void ram_state_cache_store(const char *path,
+      const void *data, size_t size)
+{
+   unsigned i;
+   struct ram_state_slot *slot = NULL;
+
+#ifdef HAVE_THREADS
+   /* The first store always happens on the main thread before
+    * any load task can look for it, so the lock exists by the
+    * time anyone else needs it. */
+   if (!ram_state_cache_lock)
+      ram_state_cache_lock = slock_new();
+   if (ram_state_cache_lock)
+      slock_lock(ram_state_cache_lock);
+#endif
+
+   for (i = 0; i < RAM_STATE_CACHE_SLOTS; i++)
+   {
+      if (string_is_equal(ram_state_cache[i].path, path))
+      {
+         slot = &ram_state_cache[i];
+         break;
+      }
+      if (!slot || ram_state_cache[i].used < slot->used)
+         slot = &ram_state_cache[i];
+   }
+
+   if (slot->size != size)
+   {
+      free(slot->data);
+      slot->data = malloc(size);
+      slot->size = slot->data ? size : 0;
+   }
+
+   if (slot->data)
+   {
+      memcpy(slot->data, data, size);
+      slot->used = ++ram_state_cache_tick;
+      strlcpy(slot->path, path, sizeof(slot->path));
+   }
+   else
+      slot->path[0] = '\0';
+
+#ifdef HAVE_THREADS
+   if (ram_state_cache_lock)
+      slock_unlock(ram_state_cache_lock);
+#endif
+}
+
+/**
+ * ram_state_cache_take:
+ * @path : path the state would be loaded from
+ * @data : set to a malloc'd copy of the cached state
+ * @size : set to the size of the cached state
+ *
+ * Looks @path up in the RAM savestate cache. On a hit, hands
+ * out a copy sized like task_load_handler's read buffer
+ * (size + 1) so it can be used interchangeably.
+ *
+ * Returns: true on a cache hit.
+ **/
+static bool ram_state_cache_take(const char *path,
+      void **data, size_t *size)
+{
+   unsigned i;
+   bool hit = false;
+
+#ifdef HAVE_THREADS
+   if (ram_state_cache_lock)
+      slock_lock(ram_state_cache_lock);
+#endif
+
+   for (i = 0; i < RAM_STATE_CACHE_SLOTS; i++)
+   {
+      struct ram_state_slot *slot = &ram_state_cache[i];
+
+      if (!slot->data || !string_is_equal(slot->path, path))
+         continue;
+
+      *data = malloc(slot->size + 1);
+      if (*data)
+      {
+         memcpy(*data, slot->data, slot->size);
+         *size      = slot->size;
+         slot->used = ++ram_state_cache_tick;
+         hit        = true;
+      }
+      break;
+   }
+
+#ifdef HAVE_THREADS
+   if (ram_state_cache_lock)
+      slock_unlock(ram_state_cache_lock);
+#endif
+
+   return hit;
+}
+
+/**
+ * ram_state_cache_invalidate:
+ * @path : path whose entry should be dropped,
+ *         NULL drops every entry.
+ *
+ * Forgets cached states whose file on disk no longer matches.
+ **/
+static void ram_state_cache_invalidate(const char *path)
+{
+   unsigned i;
+
+#ifdef HAVE_THREADS
+   if (ram_state_cache_lock)
+      slock_lock(ram_state_cache_lock);
+#endif
+
+   for (i = 0; i < RAM_STATE_CACHE_SLOTS; i++)
+   {
+      struct ram_state_slot *slot = &ram_state_cache[i];
+
+      if (path && !string_is_equal(slot->path, path))
+         continue;
+
+      free(slot->data);
+      slot->data    = NULL;
+      slot->size    = 0;
+      slot->used    = 0;
+      slot->path[0] = '\0';
+   }
+
+#ifdef HAVE_THREADS
+   if (ram_state_cache_lock)
+      slock_unlock(ram_state_cache_lock);
+#endif
+}
+
 static void *get_serialized_data(const char *path, size_t serial_size)
 {
    retro_ctx_serialize_info_t serial_info;
@@ -587,12 +1205,7 @@ static void *get_serialized_data(const char *path, size_t serial_size)
    if (!serial_size)
       return NULL;
 
-   /* Ensure buffer is initialised to zero
-    * > Prevents inconsistent compressed state file
-    *   sizes when core requests a larger buffer
-    *   than it needs (and leaves the excess
-    *   as uninitialised garbage) */
-   data = calloc(serial_size, 1);
+   data = save_state_arena_acquire(serial_size);
 
    if (!data)
       return NULL;
@@ -608,7 +1221,7 @@ static void *get_serialized_data(const char *path, size_t serial_size)
 
    if (!ret)
    {
-      free(data);
+      save_state_arena_release(data);
       return NULL;
    }
 
@@ -743,6 +1356,10 @@ static bool task_push_undo_save_state(const char *path, void *data, size_t size)
    state->data                   = data;
    state->size                   = size;
    state->undo_save              = true;
+
+   /* The file is about to be rewritten with the old state -
+    * keep the cache in step with it. */
+   ram_state_cache_store(path, data, size);
    state->state_slot             = settings->ints.state_slot;
    state->has_valid_framebuffer  = video_driver_cached_frame_has_valid_framebuffer();
    state->compress_files         = compress_files;
@@ -827,65 +1444,86 @@ static void task_load_handler(retro_task_t *task)
    ssize_t remaining, bytes_read;
    save_task_state_t *state = (save_task_state_t*)task->state;
 
-   if (!state->file)
+   /* States saved this session are still resident in the RAM
+    * cache - serve those without touching the file system. */
+   if (!state->file && !state->data)
    {
+      void *cached_data  = NULL;
+      size_t cached_size = 0;
+
+      if (ram_state_cache_take(state->path, &cached_data, &cached_size))
+      {
+         state->data       = cached_data;
+         state->size       = (ssize_t)cached_size;
+         state->bytes_read = (ssize_t)cached_size;
+         task_set_progress(task, 100);
+      }
+   }
+
+   /* Cache hits arrive here fully read and
+    * skip the file entirely. */
+   if (state->file || !state->data || state->bytes_read != state->size)
+   {
+      if (!state->file)
+      {
 #if defined(HAVE_ZLIB)
-      /* Always use RZIP interface when reading state
-       * files - this will automatically handle uncompressed
-       * data */
-      state->file = intfstream_open_rzip_file(state->path,
-            RETRO_VFS_FILE_ACCESS_READ);
+         /* Always use RZIP interface when reading state
+          * files - this will automatically handle uncompressed
+          * data */
+         state->file = intfstream_open_rzip_file(state->path,
+               RETRO_VFS_FILE_ACCESS_READ);
 #else
-      state->file = intfstream_open_file(state->path,
-            RETRO_VFS_FILE_ACCESS_READ,
-            RETRO_VFS_FILE_ACCESS_HINT_NONE);
+         state->file = intfstream_open_file(state->path,
+               RETRO_VFS_FILE_ACCESS_READ,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE);
 #endif
 
-      if (!state->file)
-         goto error;
+         if (!state->file)
+            goto error;
 
-      state->size = intfstream_get_size(state->file);
+         state->size = intfstream_get_size(state->file);
 
-      if (state->size < 0)
-         goto error;
+         if (state->size < 0)
+            goto error;
 
-      state->data = malloc(state->size + 1);
+         state->data = malloc(state->size + 1);
 
-      if (!state->data)
-         goto error;
-   }
+         if (!state->data)
+            goto error;
+      }
 
-   remaining          = MIN(state->size - state->bytes_read, SAVE_STATE_CHUNK);
-   bytes_read         = intfstream_read(state->file,
-         (uint8_t*)state->data + state->bytes_read, remaining);
-   state->bytes_read += bytes_read;
+      remaining          = MIN(state->size - state->bytes_read, SAVE_STATE_CHUNK);
+      bytes_read         = intfstream_read(state->file,
+            (uint8_t*)state->data + state->bytes_read, remaining);
+      state->bytes_read += bytes_read;
 
-   if (state->size > 0)
-      task_set_progress(task, (state->bytes_read / (float)state->size) * 100);
+      if (state->size > 0)
+         task_set_progress(task, (state->bytes_read / (float)state->size) * 100);
 
-   if (task_get_cancelled(task) || bytes_read != remaining)
-   {
-      if (state->autoload)
+      if (task_get_cancelled(task) || bytes_read != remaining)
       {
-         char msg[8192];
+         if (state->autoload)
+         {
+            char msg[8192];
 
-         msg[0] = '\0';
+            msg[0] = '\0';
 
-         snprintf(msg,
-               8192 * sizeof(char),
-               "%s \"%s\" %s.",
-               msg_hash_to_str(MSG_AUTOLOADING_SAVESTATE_FROM),
-               state->path,
-               msg_hash_to_str(MSG_FAILED));
-         task_set_error(task, strdup(msg));
-      }
-      else
-         task_set_error(task, strdup(msg_hash_to_str(MSG_FAILED_TO_LOAD_STATE)));
+            snprintf(msg,
+                  8192 * sizeof(char),
+                  "%s \"%s\" %s.",
+                  msg_hash_to_str(MSG_AUTOLOADING_SAVESTATE_FROM),
+                  state->path,
+                  msg_hash_to_str(MSG_FAILED));
+            task_set_error(task, strdup(msg));
+         }
+         else
+            task_set_error(task, strdup(msg_hash_to_str(MSG_FAILED_TO_LOAD_STATE)));
 
-      free(state->data);
-      state->data = NULL;
-      task_load_handler_finished(task, state);
-      return;
+         free(state->data);
+         state->data = NULL;
+         task_load_handler_finished(task, state);
+         return;
+      }
    }
 
    if (state->bytes_read == state->size)
@@ -1149,8 +1787,7 @@ static void task_push_save_state(const char *path, void *data, size_t size, bool
    if (!task_queue_push(task))
    {
       /* Another blocking task is already active. */
-      if (data)
-         free(data);
+      save_state_arena_release(data);
       if (task->title)
          task_free_title(task);
       free(task);
@@ -1160,8 +1797,7 @@ static void task_push_save_state(const char *path, void *data, size_t size, bool
    return;
 
 error:
-   if (data)
-      free(data);
+   save_state_arena_release(data);
    if (state)
       free(state);
    if (task)
@@ -1255,8 +1891,7 @@ static void task_push_load_and_save_state(const char *path, void *data,
    if (!task_queue_push(task))
    {
       /* Another blocking task is already active. */
-      if (data)
-         free(data);
+      save_state_arena_release(data);
       if (task->title)
          task_free_title(task);
       free(task);
@@ -1306,6 +1941,13 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
 
    if (save_to_disk)
    {
+      /* Keep a RAM copy so an immediate load doesn't have to wait
+       * for (or read back) the disk write. Background saves
+       * serialize inside the task, so there is no data to keep
+       * yet - those still load through the file. */
+      if (data && !autosave)
+         ram_state_cache_store(path, data, info.size);
+
       if (path_is_valid(path) && !autosave)
       {
          /* Before overwriting the savestate file, load it into a buffer
@@ -1344,12 +1986,12 @@ bool content_save_state(const char *path, bool save_to_disk, bool autosave)
       undo_load_buf.data = malloc(info.size);
       if (!undo_load_buf.data)
       {
-         free(data);
+         save_state_arena_release(data);
          return false;
       }
 
       memcpy(undo_load_buf.data, data, info.size);
-      free(data);
+      save_state_arena_release(data);
       undo_load_buf.size = info.size;
       strlcpy(undo_load_buf.path, path, sizeof(undo_load_buf.path));
    }
@@ -1443,6 +2085,10 @@ error:
 bool content_rename_state(const char *origin, const char *dest)
 {
    int ret = 0;
+
+   ram_state_cache_invalidate(origin);
+   ram_state_cache_invalidate(dest);
+
    if (filestream_exists(dest))
       filestream_delete(dest);
 
@@ -1480,6 +2126,25 @@ bool content_reset_savestate_backups(void)
    undo_load_buf.path[0] = '\0';
    undo_load_buf.size    = 0;
 
+   ram_state_cache_invalidate(NULL);
+
+#ifdef HAVE_THREADS
+   if (save_state_arena_lock)
+      slock_lock(save_state_arena_lock);
+#endif
+   /* Trim the serialization arena as well, unless a save
+    * task still owns it. */
+   if (!save_state_arena_in_use && save_state_arena_buf)
+   {
+      free(save_state_arena_buf);
+      save_state_arena_buf  = NULL;
+      save_state_arena_size = 0;
+   }
+#ifdef HAVE_THREADS
+   if (save_state_arena_lock)
+      slock_unlock(save_state_arena_lock);
+#endif
+
    return true;
 }
 
@@ -1509,6 +2174,135 @@ static bool content_get_memory(retro_ctx_memory_info_t *mem_info,
    return true;
 }
 
+/**
+ * content_replay_save_journal:
+ * @save_path        : path of the base save file.
+ * @data             : SRAM buffer to apply deltas to.
+ * @size             : size of @data.
+ *
+ * Applies any valid records from a leftover save journal
+ * (an autosave session that did not get to materialize the
+ * full file) on top of the loaded SRAM image. Replay stops
+ * at the first record that fails validation, which discards
+ * exactly the record an interrupted write was appending.
+ *
+ * Returns: true if at least one record was applied.
+ **/
+static bool content_replay_save_journal(const char *save_path,
+      uint8_t *data, size_t size)
+{
+   char journal_path[PATH_MAX_LENGTH];
+   uint32_t header[3];
+   uint8_t *buf     = NULL;
+   int64_t len      = 0;
+   int64_t pos      = 0;
+   unsigned applied = 0;
+
+   journal_path[0]  = '\0';
+   strlcpy(journal_path, save_path, sizeof(journal_path));
+   strlcat(journal_path, AUTOSAVE_JOURNAL_SUFFIX,
+         sizeof(journal_path));
+
+   if (!path_is_valid(journal_path))
+      return false;
+
+   if (!filestream_read_file(journal_path, (void**)&buf, &len))
+      return false;
+
+   if (len < (int64_t)sizeof(header))
+   {
+      free(buf);
+      return false;
+   }
+
+   memcpy(header, buf, sizeof(header));
+
+   if (  (header[0] != AUTOSAVE_JOURNAL_MAGIC)
+      || (header[1] != AUTOSAVE_JOURNAL_VERSION)
+      || (header[2] != (uint32_t)size))
+   {
+      RARCH_WARN("[SRAM]: Ignoring unusable save journal: \"%s\".\n",
+            journal_path);
+      free(buf);
+      return false;
+   }
+
+   pos = (int64_t)sizeof(header);
+
+   for (;;)
+   {
+      uint32_t record[4];
+      uint32_t offset, length;
+
+      if (pos + (int64_t)sizeof(record) > len)
+         break;
+
+      /* Records are not aligned within the file - copy out. */
+      memcpy(record, buf + pos, sizeof(record));
+
+      offset = record[1];
+      length = record[2];
+
+      if (  (length == 0)
+         || ((uint64_t)offset + length > (uint64_t)size)
+         || (pos + (int64_t)sizeof(record) + length > len))
+         break;
+
+      if (encoding_crc32(0, buf + pos + sizeof(record), length)
+            != record[3])
+         break;
+
+      memcpy(data + offset, buf + pos + sizeof(record), length);
+      applied++;
+      pos += (int64_t)sizeof(record) + length;
+   }
+
+   free(buf);
+
+   if (applied)
+      RARCH_WARN("[SRAM]: Recovered %u journaled delta(s)"
+            " for \"%s\".\n", applied, save_path);
+
+   return applied > 0;
+}
+
+/**
+ * content_materialize_save_journal:
+ * @save_path        : path of the base save file.
+ * @data             : recovered SRAM contents.
+ * @size             : size of @data.
+ *
+ * Rewrites the full save file from recovered contents, then
+ * deletes the journal. Replay is idempotent over the
+ * rewritten base, so a crash between the write and the
+ * delete loses nothing.
+ **/
+static void content_materialize_save_journal(const char *save_path,
+      const void *data, size_t size)
+{
+   char journal_path[PATH_MAX_LENGTH];
+   bool write_success;
+#if defined(HAVE_ZLIB)
+   settings_t *settings = config_get_ptr();
+   bool compress        = settings->bools.save_file_compression;
+#endif
+
+   journal_path[0]      = '\0';
+   strlcpy(journal_path, save_path, sizeof(journal_path));
+   strlcat(journal_path, AUTOSAVE_JOURNAL_SUFFIX,
+         sizeof(journal_path));
+
+#if defined(HAVE_ZLIB)
+   if (compress)
+      write_success = rzipstream_write_file(save_path, data, size);
+   else
+#endif
+      write_success = filestream_write_file(save_path, data, size);
+
+   if (write_success)
+      filestream_delete(journal_path);
+}
+
 /**
  * content_load_ram_file:
  * @path             : path of RAM state that will be loaded from.
@@ -1526,13 +2320,28 @@ bool content_load_ram_file(unsigned slot)
    if (!content_get_memory(&mem_info, &ram, slot))
       return false;
 
+   if (string_is_empty(ram.path))
+      return false;
+
    /* On first run of content, SRAM file will
     * not exist. This is a common enough occurrence
     * that we should check before attempting to
     * invoke the relevant read_file() function */
-   if (string_is_empty(ram.path) ||
-       !path_is_valid(ram.path))
+   if (!path_is_valid(ram.path))
+   {
+      /* A journal can still exist without a base file if the
+       * very first autosave session was interrupted - its
+       * deltas then apply on top of the core's freshly
+       * initialized SRAM. */
+      if (content_replay_save_journal(ram.path,
+               (uint8_t*)mem_info.data, mem_info.size))
+      {
+         content_materialize_save_journal(ram.path,
+               mem_info.data, mem_info.size);
+         return true;
+      }
       return false;
+   }
 
 #if defined(HAVE_ZLIB)
    /* Always use RZIP interface when reading SRAM
@@ -1562,6 +2371,14 @@ bool content_load_ram_file(unsigned slot)
    if (buf)
       free(buf);
 
+   /* Crash recovery: fold any journaled deltas the previous
+    * session did not get to materialize into the loaded image,
+    * then bring the file on disk back up to date. */
+   if (content_replay_save_journal(ram.path,
+            (uint8_t*)mem_info.data, mem_info.size))
+      content_materialize_save_journal(ram.path,
+            mem_info.data, mem_info.size);
+
    return true;
 }
 
@@ -1675,6 +2492,180 @@ bool content_save_ram_file(unsigned slot, bool compress)
    return true;
 }
 
+typedef struct save_ram_task_state
+{
+   intfstream_t *file;
+   void *data;
+   size_t size;
+   size_t written;
+   unsigned type;
+   char path[PATH_MAX_LENGTH];
+   bool compress_files;
+} save_ram_task_state_t;
+
+/**
+ * task_save_ram_handler:
+ * @task : the task being worked on
+ *
+ * Write a chunk of the snapshotted SRAM data to disk.
+ **/
+static void task_save_ram_handler(retro_task_t *task)
+{
+   int written;
+   ssize_t remaining;
+   save_ram_task_state_t *state = (save_ram_task_state_t*)task->state;
+
+   if (!state->file)
+   {
+#if defined(HAVE_ZLIB)
+      if (state->compress_files)
+         state->file = intfstream_open_rzip_file(
+               state->path, RETRO_VFS_FILE_ACCESS_WRITE);
+      else
+#endif
+         state->file = intfstream_open_file(
+               state->path, RETRO_VFS_FILE_ACCESS_WRITE,
+               RETRO_VFS_FILE_ACCESS_HINT_NONE);
+   }
+
+   remaining       = MIN(state->size - state->written, SAVE_STATE_CHUNK);
+
+   if (state->file)
+      written      = (int)intfstream_write(state->file,
+            (uint8_t*)state->data + state->written, remaining);
+   else
+      written      = 0;
+
+   state->written += written;
+
+   task_set_progress(task, (state->written / (float)state->size) * 100);
+
+   if (!state->file || written != remaining)
+   {
+      RARCH_ERR("[SRAM]: %s.\n",
+            msg_hash_to_str(MSG_FAILED_TO_SAVE_SRAM));
+      RARCH_WARN("[SRAM]: Attempting to recover ...\n");
+
+      /* In case the file could not be written to,
+       * the fallback function 'dump_to_file_desperate'
+       * will be called. */
+      if (!dump_to_file_desperate(
+               state->data, state->size, state->type))
+      {
+         RARCH_WARN("[SRAM]: Failed ... Cannot recover save file.\n");
+      }
+   }
+   else if (state->written < state->size)
+      return;
+
+   task_set_finished(task, true);
+
+   if (state->file)
+   {
+      intfstream_close(state->file);
+      free(state->file);
+   }
+
+   free(state->data);
+   free(state);
+}
+
+/**
+ * task_push_save_ram_file:
+ * @slot             : index into task_save_files.
+ * @compress         : whether to write a compressed save.
+ *
+ * Snapshot a RAM state and queue a task that writes it to disk.
+ * The snapshot is taken immediately, so the core may be
+ * deinitialized while the write is still in flight.
+ */
+static bool task_push_save_ram_file(unsigned slot, bool compress)
+{
+   struct ram_type ram;
+   retro_ctx_memory_info_t mem_info;
+   retro_task_t *task           = NULL;
+   save_ram_task_state_t *state = NULL;
+
+   if (!content_get_memory(&mem_info, &ram, slot))
+      return false;
+
+   task  = task_init();
+   state = (save_ram_task_state_t*)calloc(1, sizeof(*state));
+
+   if (!task || !state)
+      goto error;
+
+   state->data = malloc(mem_info.size);
+
+   if (!state->data)
+      goto error;
+
+   RARCH_LOG("[SRAM]: %s #%u %s \"%s\".\n",
+         msg_hash_to_str(MSG_SAVING_RAM_TYPE),
+         ram.type,
+         msg_hash_to_str(MSG_TO),
+         ram.path);
+
+   memcpy(state->data, mem_info.data, mem_info.size);
+   state->size           = mem_info.size;
+   state->type           = ram.type;
+   state->compress_files = compress;
+   strlcpy(state->path, ram.path, sizeof(state->path));
+
+   task->type            = TASK_TYPE_BLOCKING;
+   task->state           = state;
+   task->handler         = task_save_ram_handler;
+   task->mute            = true;
+
+   task_queue_push(task);
+
+   return true;
+
+error:
+   if (state)
+   {
+      if (state->data)
+         free(state->data);
+      free(state);
+   }
+   if (task)
+      free(task);
+
+   /* Out of memory for the snapshot - fall back to
+    * writing synchronously from the live buffer. */
+   return content_save_ram_file(slot, compress);
+}
+
+static bool task_save_ram_finder(retro_task_t *task, void *user_data)
+{
+   if (!task)
+      return false;
+
+   if (task->handler == task_save_ram_handler)
+      return true;
+
+   return false;
+}
+
+/* Returns true if a save RAM flush task is in progress */
+static bool content_save_ram_in_progress(void *data)
+{
+   task_finder_data_t find_data;
+
+   find_data.func     = task_save_ram_finder;
+   find_data.userdata = NULL;
+
+   if (task_queue_find(&find_data))
+      return true;
+
+   return false;
+}
+
+void content_wait_for_save_ram_task(void)
+{
+   task_queue_wait(content_save_ram_in_progress, NULL);
+}
+
 bool event_save_files(bool is_sram_used)
 {
    unsigned i;
@@ -1695,8 +2686,12 @@ bool event_save_files(bool is_sram_used)
    if (!task_save_files || !is_sram_used)
       return false;
 
+   /* The writes run as background tasks against a snapshot
+    * taken here, so closing content no longer stalls on
+    * large flash saves. content_wait_for_save_ram_task()
+    * covers anyone who needs the files on disk. */
    for (i = 0; i < task_save_files->size; i++)
-      content_save_ram_file(i, compress_files);
+      task_push_save_ram_file(i, compress_files);
 
    return true;
 }
@@ -1708,6 +2703,11 @@ bool event_load_save_files(bool is_sram_load_disabled)
    if (!task_save_files || is_sram_load_disabled)
       return false;
 
+   /* A flush from a previous session of the same content
+    * may still be in flight - make sure it has landed
+    * before reading the files back. */
+   content_wait_for_save_ram_task();
+
    for (i = 0; i < task_save_files->size; i++)
       content_load_ram_file(i);
 
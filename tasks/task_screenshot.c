@@ -612,3 +612,86 @@ bool take_screenshot(
 
    return ret;
 }
+
+/**
+ * take_content_thumbnail:
+ *
+ * Captures the current content frame as a playlist thumbnail
+ * for entries that have no scraped art. The image lands in
+ * <thumbnails>/<core name>/Named_Snaps/<content name>.png -
+ * the same location and scrubbing rules the menu thumbnail
+ * lookup uses - so unscraped entries show the last thing that
+ * was on screen. Entries that already have art in any category
+ * are left untouched.
+ *
+ * Meant to be called at content close, while the core and the
+ * cached frame are still valid; the dump runs synchronously
+ * for that reason (the frame pointer may reference core-owned
+ * memory that unloading frees).
+ *
+ * Returns: true (1) if a thumbnail was written or already
+ * existed, otherwise false (0).
+ **/
+bool take_content_thumbnail(void)
+{
+   static const char *categories[] = {
+      "Named_Boxarts", "Named_Titles", "Named_Snaps"
+   };
+   char content_img[256];
+   char thumbnail_dir[PATH_MAX_LENGTH];
+   char thumbnail_path[PATH_MAX_LENGTH];
+   size_t i;
+   struct retro_system_info system_info;
+   char *scrub_char_pointer   = NULL;
+   settings_t *settings       = config_get_ptr();
+   const char *dir_thumbnails = settings->paths.directory_thumbnails;
+   const char *content_path   = path_get(RARCH_PATH_BASENAME);
+
+   content_img[0]     = '\0';
+   thumbnail_dir[0]   = '\0';
+   thumbnail_path[0]  = '\0';
+
+   if (  string_is_empty(dir_thumbnails)
+      || string_is_empty(content_path))
+      return false;
+
+   if (  !core_get_system_info(&system_info)
+      || string_is_empty(system_info.library_name))
+      return false;
+
+   /* Thumbnail image name is the content name with the same
+    * character scrubbing gfx_thumbnail_path.c applies when
+    * looking the image up */
+   strlcpy(content_img, path_basename(content_path),
+         sizeof(content_img));
+   path_remove_extension(content_img);
+   if (string_is_empty(content_img))
+      return false;
+   while ((scrub_char_pointer =
+            strpbrk(content_img, "&*/:`\"<>?\\|")))
+      *scrub_char_pointer = '_';
+   strlcat(content_img, ".png", sizeof(content_img));
+
+   /* Skip entries that already have art in any category */
+   for (i = 0; i < ARRAY_SIZE(categories); i++)
+   {
+      fill_pathname_join(thumbnail_dir, dir_thumbnails,
+            system_info.library_name, sizeof(thumbnail_dir));
+      fill_pathname_join(thumbnail_dir, thumbnail_dir,
+            categories[i], sizeof(thumbnail_dir));
+      fill_pathname_join(thumbnail_path, thumbnail_dir,
+            content_img, sizeof(thumbnail_path));
+
+      if (path_is_valid(thumbnail_path))
+         return true;
+   }
+
+   /* Loop above leaves the Named_Snaps paths in place */
+   if (!path_is_directory(thumbnail_dir))
+      if (!path_mkdir(thumbnail_dir))
+         return false;
+
+   return take_screenshot(NULL, thumbnail_path,
+         true, video_driver_cached_frame_has_valid_framebuffer(),
+         true, false);
+}
@@ -0,0 +1,166 @@
+/*  RetroArch - A frontend for libretro.
+ *  Copyright (C) 2011-2017 - Daniel De Matteis
+ *
+ *  RetroArch is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  RetroArch is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with RetroArch.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <compat/strl.h>
+#include <string/stdstring.h>
+#include <file/file_path.h>
+#include <file/config_file.h>
+#include <queues/task_queue.h>
+#include <retro_miscellaneous.h>
+
+#ifdef HAVE_CONFIG_H
+#include "../config.h"
+#endif
+
+#include "tasks_internal.h"
+
+#include "../gfx/video_shader_parse.h"
+#include "../gfx/drivers_shader/glslang_util.h"
+#include "../menu/menu_shader.h"
+#include "../verbosity.h"
+
+/* Loading a heavy multi-pass slang preset blocks the
+ * render thread for the duration of SPIR-V generation.
+ * This task performs the expensive compilation on a
+ * worker (warming the on-disk SPIR-V blob cache) while
+ * the current filter chain keeps presenting frames; the
+ * preset is then applied on the main thread, where the
+ * warm cache makes the chain rebuild near-instant. */
+
+typedef struct shader_preset_load
+{
+   struct video_shader *shader;
+   enum rarch_shader_type type;
+   unsigned pass;
+   char preset_path[PATH_MAX_LENGTH];
+} shader_preset_load_t;
+
+static void task_shader_preset_load_cb(retro_task_t *task,
+      void *task_data,
+      void *user_data, const char *error)
+{
+   shader_preset_load_t *state = (shader_preset_load_t*)task_data;
+
+   if (!state)
+      return;
+
+   /* Runs on the main thread - the compilation above
+    * only warmed caches, the actual chain swap happens
+    * here and is atomic from the frontend's view. */
+   menu_shader_manager_set_preset(menu_shader_get(),
+         state->type, state->preset_path, true);
+
+   if (state->shader)
+      free(state->shader);
+   free(state);
+}
+
+static void task_shader_preset_load_handler(retro_task_t *task)
+{
+   shader_preset_load_t *state = (shader_preset_load_t*)task->state;
+
+   /* First invocation - parse the preset to
+    * discover the per-pass shader paths */
+   if (!state->shader)
+   {
+      config_file_t *conf = video_shader_read_preset(state->preset_path);
+
+      state->shader       = (struct video_shader*)
+         calloc(1, sizeof(*state->shader));
+
+      if (!state->shader ||
+          !conf           ||
+          !video_shader_read_conf_preset(conf, state->shader))
+      {
+         /* Invalid preset - the synchronous apply in the
+          * callback will report the error as usual */
+         if (state->shader)
+            state->shader->passes = 0;
+      }
+
+      if (conf)
+         config_file_free(conf);
+
+      if (!state->shader)
+      {
+         task_set_data(task, state);
+         task_set_finished(task, true);
+      }
+      return;
+   }
+
+   /* One pass per iteration, so progress updates
+    * and task cancellation stay responsive */
+   if (state->pass < state->shader->passes)
+   {
+      char title[256];
+      struct video_shader_pass *pass = &state->shader->pass[state->pass];
+
+      snprintf(title, sizeof(title), "%s (%u/%u)",
+            path_basename(pass->source.path),
+            state->pass + 1, state->shader->passes);
+
+      task_set_title(task, strdup(title));
+      task_set_progress(task,
+            (state->pass * 100) / state->shader->passes);
+
+      glslang_precompile_shader(pass->source.path);
+
+      state->pass++;
+      return;
+   }
+
+   task_set_progress(task, 100);
+   task_set_data(task, state);
+   task_set_finished(task, true);
+}
+
+bool task_push_shader_preset_load(enum rarch_shader_type type,
+      const char *preset_path)
+{
+   retro_task_t *task          = NULL;
+   shader_preset_load_t *state = NULL;
+
+   /* Only slang presets go through a compiler pass
+    * expensive enough to warrant a worker; other
+    * backends should be applied synchronously */
+   if (type != RARCH_SHADER_SLANG || string_is_empty(preset_path))
+      return false;
+
+   if (!(task = task_init()))
+      return false;
+
+   if (!(state = (shader_preset_load_t*)calloc(1, sizeof(*state))))
+   {
+      free(task);
+      return false;
+   }
+
+   state->type    = type;
+   strlcpy(state->preset_path, preset_path, sizeof(state->preset_path));
+
+   task->type     = TASK_TYPE_NONE;
+   task->state    = state;
+   task->handler  = task_shader_preset_load_handler;
+   task->callback = task_shader_preset_load_cb;
+   task->title    = strdup(path_basename(preset_path));
+
+   task_queue_push(task);
+
+   return true;
+}
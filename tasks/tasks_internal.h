@@ -34,6 +34,10 @@
 
 #include "../playlist.h"
 
+#ifdef HAVE_SLANG
+#include "../gfx/video_shader_parse.h"
+#endif
+
 /* Required for task_push_core_backup() */
 #include "../core_backup.h"
 
@@ -60,6 +64,12 @@ typedef struct
 void *task_push_http_transfer(const char *url, bool mute, const char *type,
       retro_task_callback_t cb, void *userdata);
 
+/* As task_push_http_transfer(), but keeps a disk-backed copy of
+ * the response and revalidates it with If-None-Match /
+ * If-Modified-Since, so an unchanged resource costs only a 304 */
+void *task_push_http_transfer_cached(const char *url, bool mute, const char *type,
+      retro_task_callback_t cb, void *userdata);
+
 void *task_push_http_transfer_with_user_agent(const char *url, bool mute, const char *type,
       const char* user_agent, retro_task_callback_t cb, void *userdata);
 
@@ -166,6 +176,15 @@ bool task_push_manual_content_scan(
       const playlist_config_t *playlist_config,
       const char *playlist_directory);
 
+#ifdef HAVE_SLANG
+/* Compiles a slang preset on a worker thread (warming
+ * the on-disk SPIR-V cache) and applies it on the main
+ * thread once ready. Returns false if the preset must
+ * be applied synchronously by the caller instead. */
+bool task_push_shader_preset_load(enum rarch_shader_type type,
+      const char *preset_path);
+#endif
+
 #ifdef HAVE_OVERLAY
 bool task_push_overlay_load_default(
       retro_task_callback_t cb,
@@ -208,6 +227,8 @@ bool take_screenshot(
       const char *path, bool silence,
       bool has_valid_framebuffer, bool fullpath, bool use_thread);
 
+bool take_content_thumbnail(void);
+
 bool event_load_save_files(bool is_sram_load_disabled);
 
 bool event_save_files(bool sram_used);
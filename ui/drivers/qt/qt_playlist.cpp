@@ -129,6 +129,20 @@ void PlaylistModel::setThumbnailCacheLimit(int limit)
    m_cache.setMaxCost(limit * 1024);
 }
 
+void PlaylistModel::setThumbnailMaxSize(const int maxSize)
+{
+   if (maxSize == m_thumbnailMaxSize)
+      return;
+
+   /* Thumbnails are decoded at (at most) this size, so
+    * anything cached at the old, smaller size would be
+    * upscaled on screen - drop it and decode again */
+   if (maxSize > m_thumbnailMaxSize)
+      m_cache.clear();
+
+   m_thumbnailMaxSize = maxSize;
+}
+
 QString PlaylistModel::getThumbnailPath(const QModelIndex &index,
       QString type) const
 {
@@ -248,7 +262,24 @@ void PlaylistModel::loadThumbnail(const QModelIndex &index)
 
 void PlaylistModel::loadImage(const QModelIndex &index, const QString &path)
 {
-   const QImage image = QImage(path);
+   QImageReader reader(path);
+
+   /* Decode directly at (or near) display size instead of
+    * loading the full-resolution image and keeping it around;
+    * scaled decoding is much cheaper for JPEG and bounds the
+    * per-thumbnail memory cost for large source images */
+   if (m_thumbnailMaxSize > 0)
+   {
+      const QSize size = reader.size();
+      if (size.isValid() &&
+            (size.width()  > m_thumbnailMaxSize ||
+             size.height() > m_thumbnailMaxSize))
+         reader.setScaledSize(size.scaled(
+               m_thumbnailMaxSize, m_thumbnailMaxSize,
+               Qt::KeepAspectRatio));
+   }
+
+   const QImage image = reader.read();
    if (!image.isNull())
       emit imageLoaded(image, index, path);
 }
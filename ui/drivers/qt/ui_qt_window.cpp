@@ -891,6 +891,7 @@ void MainWindow::onZoomValueChanged(int zoomValue)
       newSize                = expScale(zoomValue / 100.0, 256, 1024);
 
    m_gridView->setGridSize(newSize);
+   m_playlistModel->setThumbnailMaxSize(newSize);
 
    m_lastZoomSliderValue     = zoomValue;
 }
@@ -1426,7 +1427,7 @@ QVector<QHash<QString, QString> > MainWindow::getCoreInfo()
 
    if (     currentCore["core_path"].isEmpty() 
          || !core_info 
-         || !core_info->config_data)
+         || !core_info->has_info)
    {
       QHash<QString, QString> hash;
 
@@ -149,6 +149,7 @@ public:
    void reloadThumbnailPath(const QString path);
    void reloadSystemThumbnails(const QString system);
    void setThumbnailCacheLimit(int limit);
+   void setThumbnailMaxSize(const int maxSize);
    bool isSupportedImage(const QString path) const;
    QString getPlaylistThumbnailsDir(const QString playlistName) const;
    QString getSanitizedThumbnailName(QString label) const;
@@ -166,6 +167,7 @@ private:
    QVector<QByteArray> m_imageFormats;
    QRegularExpression m_fileSanitizerRegex;
    ThumbnailType m_thumbnailType = THUMBNAIL_TYPE_BOXART;
+   int m_thumbnailMaxSize = 512;
    QString getThumbnailPath(const QModelIndex &index, QString type) const;
    QString getThumbnailPath(const QHash<QString, QString> &hash, QString type) const;
    QString getCurrentTypeThumbnailPath(const QModelIndex &index) const;
@@ -29,8 +29,6 @@
 
 typedef struct
 {
-   bool connman_cache[256];
-   unsigned connman_counter;
    struct string_list* lines;
    char command[256];
    bool connmanctl_widgets_supported;
@@ -161,19 +159,41 @@ static void connmanctl_tether_toggle(
    }
 }
 
-static void connmanctl_scan(void *data)
+static void connmanctl_refresh_services(connman_t *connman)
 {
+   /* (Re)reads the connman service list into connman->lines.
+    * The flag columns at the start of each line carry the
+    * connection state ('R'eady / 'O'nline), so refreshing this
+    * list is also what refreshes the online status shown in
+    * the menu - it is re-run after every state-changing
+    * operation instead of being polled on a timer */
    char line[512];
    union string_list_elem_attr attr;
-   FILE *serv_file                  = NULL;
-   settings_t *settings             = config_get_ptr();
-   connman_t *connman               = (connman_t*)data;
+   FILE *serv_file = NULL;
 
    attr.i = RARCH_FILETYPE_UNSET;
+
    if (connman->lines)
-      free(connman->lines);
+      string_list_free(connman->lines);
    connman->lines = string_list_new();
 
+   serv_file = popen("connmanctl services", "r");
+   while (fgets(line, 512, serv_file))
+   {
+      size_t len = strlen(line);
+      if (len > 0 && line[len-1] == '\n')
+         line[--len] = '\0';
+
+      string_list_append(connman->lines, line, attr);
+   }
+   pclose(serv_file);
+}
+
+static void connmanctl_scan(void *data)
+{
+   settings_t *settings             = config_get_ptr();
+   connman_t *connman               = (connman_t*)data;
+
    if (connmanctl_tether_status(connman))
    {
       runloop_msg_queue_push(msg_hash_to_str(MSG_LOCALAP_SWITCHING_OFF),
@@ -192,16 +212,7 @@ static void connmanctl_scan(void *data)
          1, 180, true, NULL, MESSAGE_QUEUE_ICON_DEFAULT,
          MESSAGE_QUEUE_CATEGORY_INFO);
 
-   serv_file = popen("connmanctl services", "r");
-   while (fgets(line, 512, serv_file))
-   {
-      size_t len = strlen(line);
-      if (len > 0 && line[len-1] == '\n')
-         line[--len] = '\0';
-
-      string_list_append(connman->lines, line, attr);
-   }
-   pclose(serv_file);
+   connmanctl_refresh_services(connman);
 }
 
 static void connmanctl_get_ssids(void *data, struct string_list* ssids)
@@ -226,50 +237,20 @@ static void connmanctl_get_ssids(void *data, struct string_list* ssids)
 
 static bool connmanctl_ssid_is_online(void *data, unsigned i)
 {
-   char ln[512]       = {0};
-   char service[128]  = {0};
+   const char *line;
    connman_t *connman = (connman_t*)data;
-   const char *line   = connman->lines->elems[i].data;
-   FILE *command_file = NULL;
-
-   if (connman->connman_counter == 60)
-   {
-      static struct string_list* list = NULL;
-      connman->connman_counter = 0;
-      list            = string_split(line, " ");
-      if (!list)
-         return false;
-
-      if (list->size == 0)
-      {
-         string_list_free(list);
-         return false;
-      }
-
-      strlcpy(service, list->elems[list->size-1].data, sizeof(service));
-      string_list_free(list);
 
-      snprintf(connman->command, sizeof(connman->command), "\
-            connmanctl services %s | grep 'State = \\(online\\|ready\\)'",
-            service);
-
-      command_file = popen(connman->command, "r");
+   if (!connman->lines || i >= connman->lines->size)
+      return false;
 
-      while (fgets(ln, 512, command_file))
-      {
-         connman->connman_cache[i] = true;
-         return true;
-      }
-      pclose(command_file);
-      connman->connman_cache[i] = false;
-   }
-   else
-   {
-      connman->connman_counter++;
-      return connman->connman_cache[i];
-   }
+   /* The state flag is already in the cached service list
+    * (column 3: 'R'eady or 'O'nline), so this runs every
+    * frame for every visible row without spawning anything.
+    * The list is refreshed by scans and connect/disconnect
+    * operations, which are the only events that change it */
+   line = connman->lines->elems[i].data;
 
-   return false;
+   return (line[2] == 'R' || line[2] == 'O');
 }
 
 static bool connmanctl_connect_ssid(
@@ -367,6 +348,9 @@ static bool connmanctl_connect_ssid(
    }
    pclose(command_file);
 
+   /* Pick up the new connection state for the menu */
+   connmanctl_refresh_services(connman);
+
    return true;
 }
 
@@ -689,6 +673,8 @@ static void connmanctl_tether_start_stop(void *data, bool start, char* configfil
 
             pclose(command_file);
 
+            connmanctl_refresh_services(connman);
+
             RARCH_LOG("[CONNMANCTL] Tether start stop: disconnect end\n");
          }
       }